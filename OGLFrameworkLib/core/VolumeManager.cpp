@@ -37,4 +37,28 @@ namespace cgu {
 
     /** Default destructor. */
     VolumeManager::~VolumeManager() = default;
+
+    /**
+     *  Gets a volume and starts loading its texture data in the background.
+     *  Only the dat file is read on the calling thread, the volume is managed like the ones from GetResource.
+     *  @param resId the resources id.
+     *  @return the handle of the load, its Update method uploads the texture.
+     */
+    std::unique_ptr<AsyncVolumeLoad> VolumeManager::GetResourceAsync(const std::string& resId)
+    {
+        return std::make_unique<AsyncVolumeLoad>(GetResource(resId));
+    }
+
+    /**
+     *  Gets a volume and starts loading its texture data progressively in the background.
+     *  A coarse version of the volume is available after a fraction of the loading time, it is refined until the
+     *  full resolution is loaded.
+     *  @param resId the resources id.
+     *  @param maxCoarseSize the maximum size of the coarsest level in each dimension.
+     *  @return the handle of the load, its Update method uploads the newest level.
+     */
+    std::unique_ptr<ProgressiveVolumeLoad> VolumeManager::GetResourceProgressive(const std::string& resId, unsigned int maxCoarseSize)
+    {
+        return std::make_unique<ProgressiveVolumeLoad>(GetResource(resId), maxCoarseSize);
+    }
 }
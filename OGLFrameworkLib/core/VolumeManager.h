@@ -10,6 +10,8 @@
 #define VOLUMEMANAGER_H
 
 #include "gfx/volumes/Volume.h"
+#include "gfx/volumes/AsyncVolumeLoad.h"
+#include "gfx/volumes/ProgressiveVolumeLoad.h"
 
 namespace cgu {
 
@@ -28,6 +30,9 @@ namespace cgu {
         VolumeManager(VolumeManager&&);
         VolumeManager& operator=(VolumeManager&&);
         virtual ~VolumeManager();
+
+        std::unique_ptr<AsyncVolumeLoad> GetResourceAsync(const std::string& resId);
+        std::unique_ptr<ProgressiveVolumeLoad> GetResourceProgressive(const std::string& resId, unsigned int maxCoarseSize = 64);
     };
 }
 
@@ -0,0 +1,86 @@
+/**
+ * @file   parallel_helper.h
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Some helper methods for simple data parallel loops.
+ */
+
+#ifndef PARALLEL_HELPER_H
+#define PARALLEL_HELPER_H
+
+#include "main.h"
+#include <atomic>
+#include <thread>
+
+namespace cgu {
+
+    namespace parallel {
+
+        /** Returns the number of threads used for parallel loops. */
+        inline unsigned int GetNumThreads()
+        {
+            auto numThreads = std::thread::hardware_concurrency();
+            return numThreads == 0 ? 1 : numThreads;
+        }
+
+        /**
+         *  Calls a function for chunks of the range [0, count) on all available threads.
+         *  Chunks are handed out dynamically, the calling thread takes part in the work. The function is called as
+         *  fn(begin, end, threadIdx) with threadIdx in [0, numThreads) so it can write to per thread data.
+         *  The first exception thrown by a call is rethrown after all threads are finished.
+         *  @param count the number of elements.
+         *  @param chunkSize the number of elements processed by a single call.
+         *  @param fn the function to call.
+         *  @param numThreads the number of threads to use (0 to use all hardware threads).
+         */
+        template<class Fn> void ForChunks(uint64_t count, uint64_t chunkSize, Fn fn, unsigned int numThreads = 0)
+        {
+            if (count == 0) return;
+            if (chunkSize == 0) chunkSize = 1;
+            auto numChunks = (count + chunkSize - 1) / chunkSize;
+            if (numThreads == 0) numThreads = GetNumThreads();
+            numThreads = static_cast<unsigned int>(std::min<uint64_t>(numThreads, numChunks));
+
+            std::atomic<uint64_t> nextChunk(0);
+            std::exception_ptr firstException;
+            std::atomic_flag exceptionSet = ATOMIC_FLAG_INIT;
+
+            auto worker = [&](unsigned int threadIdx) {
+                try {
+                    for (auto chunk = nextChunk++; chunk < numChunks; chunk = nextChunk++) {
+                        auto begin = chunk * chunkSize;
+                        fn(begin, std::min(begin + chunkSize, count), threadIdx);
+                    }
+                }
+                catch (...) {
+                    if (!exceptionSet.test_and_set()) firstException = std::current_exception();
+                    nextChunk = numChunks;
+                }
+            };
+
+            std::vector<std::thread> threads;
+            threads.reserve(numThreads - 1);
+            for (auto i = 1U; i < numThreads; ++i) threads.emplace_back(worker, i);
+            worker(0);
+            for (auto& thread : threads) thread.join();
+
+            if (firstException) std::rethrow_exception(firstException);
+        }
+
+        /**
+         *  Calls a function for each element of the range [0, count) on all available threads.
+         *  @param count the number of elements.
+         *  @param fn the function to call as fn(idx).
+         *  @param chunkSize the number of elements handed to a thread at once.
+         */
+        template<class Fn> void For(uint64_t count, Fn fn, uint64_t chunkSize = 1024)
+        {
+            ForChunks(count, chunkSize, [&fn](uint64_t begin, uint64_t end, unsigned int) {
+                for (auto i = begin; i < end; ++i) fn(i);
+            });
+        }
+    }
+}
+
+#endif // PARALLEL_HELPER_H
@@ -79,10 +79,9 @@ namespace cgu {
         auto pickIdx = mesh.FindNearest(pos.xyz);
         auto pickIdxLocal = mesh.GetVertices()[pickIdx].locOnlyIdx;
         std::set<unsigned int> adjIdx;
-        for (const auto& tri : mesh.GetVertices()[pickIdxLocal].triangles) {
-            for (const auto idx : mesh.GetTriangle(tri).locOnlyVtxIds_) {
-                if (idx != pickIdx && idx != pickIdxLocal) adjIdx.insert(idx);
-            }
+        for (const auto adjVtx : mesh.GetOneRing(pickIdxLocal)) {
+            auto idx = mesh.GetVertices()[adjVtx].locOnlyIdx;
+            if (idx != pickIdx && idx != pickIdxLocal) adjIdx.insert(idx);
         }
 
         std::vector<unsigned int> iBufferData;
@@ -107,8 +107,12 @@ namespace cgu {
         OGL_CALL(glBindTexture, id.textureType, id.textureId);
         OGL_CALL(glTexStorage3D, id.textureType, mipMapLevels, descriptor.internalFormat, width, height, depth);
         if (data) {
+            GLint unpackAlignment;
+            OGL_CALL(glGetIntegerv, GL_UNPACK_ALIGNMENT, &unpackAlignment);
+            OGL_CALL(glPixelStorei, GL_UNPACK_ALIGNMENT, 1);
             OGL_CALL(glTexSubImage3D, id.textureType, 0, 0, 0, 0, width, height, depth,
                 descriptor.format, descriptor.type, data);
+            OGL_CALL(glPixelStorei, GL_UNPACK_ALIGNMENT, unpackAlignment);
         }
         OGL_CALL(glBindTexture, id.textureType, 0);
         InitSampling();
@@ -235,6 +239,53 @@ namespace cgu {
         OGL_CALL(glBindTexture, id.textureType, 0);
     }
 
+    /**
+     *  Sets the data of a single mip map level.
+     *  @param mipLevel the mip map level to set.
+     *  @param data the data to set.
+     */
+    void GLTexture::SetData(unsigned int mipLevel, const void* data) const
+    {
+        auto levelSize = glm::max(glm::uvec3(1), glm::uvec3(width, height, depth) / glm::uvec3(1 << mipLevel));
+        if (id.textureType == GL_TEXTURE_2D_ARRAY) levelSize.z = depth;
+        SetData(mipLevel, glm::uvec3(0), levelSize, data);
+    }
+
+    /**
+     *  Sets the data of a region of a mip map level.
+     *  The data is expected to be tightly packed (unpack alignment of 1).
+     *  @param mipLevel the mip map level to set.
+     *  @param offset the offset of the region.
+     *  @param size the size of the region.
+     *  @param data the data to set.
+     */
+    void GLTexture::SetData(unsigned int mipLevel, const glm::uvec3& offset, const glm::uvec3& size, const void* data) const
+    {
+        assert(mipLevel < mipMapLevels);
+        GLint unpackAlignment;
+        OGL_CALL(glGetIntegerv, GL_UNPACK_ALIGNMENT, &unpackAlignment);
+        OGL_CALL(glPixelStorei, GL_UNPACK_ALIGNMENT, 1);
+        OGL_CALL(glBindTexture, id.textureType, id.textureId);
+        switch (id.textureType)
+        {
+        case GL_TEXTURE_1D:
+            OGL_CALL(glTexSubImage1D, id.textureType, mipLevel, offset.x, size.x, descriptor.format, descriptor.type, data);
+            break;
+        case GL_TEXTURE_2D:
+            OGL_CALL(glTexSubImage2D, id.textureType, mipLevel, offset.x, offset.y, size.x, size.y, descriptor.format, descriptor.type, data);
+            break;
+        case GL_TEXTURE_3D:
+        case GL_TEXTURE_2D_ARRAY:
+            OGL_CALL(glTexSubImage3D, id.textureType, mipLevel, offset.x, offset.y, offset.z, size.x, size.y, size.z,
+                descriptor.format, descriptor.type, data);
+            break;
+        default:
+            throw std::runtime_error("Texture format not supported for upload.");
+        }
+        OGL_CALL(glBindTexture, id.textureType, 0);
+        OGL_CALL(glPixelStorei, GL_UNPACK_ALIGNMENT, unpackAlignment);
+    }
+
     /**
      *  Downloads the textures data to a vector.
      *  @param data the vector to contain the data.
@@ -73,6 +73,8 @@ namespace cgu {
         void ActivateImage(GLuint imageUnitIndex, GLint mipLevel, GLenum accessType) const;
         void AddTextureToArray(const std::string& file, unsigned int slice) const;
         void SetData(const void* data) const;
+        void SetData(unsigned int mipLevel, const void* data) const;
+        void SetData(unsigned int mipLevel, const glm::uvec3& offset, const glm::uvec3& size, const void* data) const;
         void DownloadData(std::vector<uint8_t>& data, size_t offset = 0, size_t size = 0) const;
         void DownloadData8Bit(std::vector<uint8_t>& data) const;
         void SaveTextureToFile(const std::string& filename) const;
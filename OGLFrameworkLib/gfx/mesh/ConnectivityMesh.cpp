@@ -18,9 +18,13 @@
 
 namespace cgu {
 
-    /** Default constructor. */
-    ConnectivityMesh::ConnectivityMesh(const Mesh* mesh) :
-        impl_(std::make_unique<impl::ConnectivityMeshImpl>(mesh))
+    /**
+     *  Constructor.
+     *  @param mesh the mesh to create the connectivity for.
+     *  @param welding the parameters for finding vertices at the same location (exact positions by default).
+     */
+    ConnectivityMesh::ConnectivityMesh(const Mesh* mesh, const VertexWeldingParameters& welding) :
+        impl_(std::make_unique<impl::ConnectivityMeshImpl>(mesh, welding))
     {
     }
 
@@ -73,6 +77,11 @@ namespace cgu {
         impl_->FindTrianglesWithinRadius(center, radius, result);
     }
 
+    /**
+     *  Find index of the triangle closest to the given point (by the exact point to triangle distance).
+     *  @param center the point to find the triangle for.
+     *  @return the triangle index or the number of triangles if the mesh is empty.
+     */
     unsigned ConnectivityMesh::FindNearestTriangle(const glm::vec3 center) const
     {
         return impl_->FindNearestTriangle(center);
@@ -87,6 +96,63 @@ namespace cgu {
         return impl_->FindContainingTriangle(pt);
     }
 
+    /**
+     *  Finds the first triangle hit by a ray (in the meshes local coordinates).
+     *  @param origin the rays origin.
+     *  @param direction the rays direction.
+     *  @param t the distance of the hit in multiples of the direction (optional).
+     *  @return the triangle index or the number of triangles if none was hit.
+     */
+    unsigned int ConnectivityMesh::FindFirstIntersectedTriangle(const glm::vec3& origin, const glm::vec3& direction, float* t) const
+    {
+        return impl_->FindFirstIntersectedTriangle(origin, direction, t);
+    }
+
+    /**
+     *  Checks if a ray hits any triangle (in the meshes local coordinates).
+     *  @param origin the rays origin.
+     *  @param direction the rays direction.
+     *  @param maxDistance the maximum distance of a hit in multiples of the direction.
+     */
+    bool ConnectivityMesh::IsOccluded(const glm::vec3& origin, const glm::vec3& direction, float maxDistance) const
+    {
+        return impl_->IsOccluded(origin, direction, maxDistance);
+    }
+
+    /**
+     *  Finds the closest point on the triangles to a query point (in the meshes local coordinates).
+     *  @param point the query point.
+     *  @param result the closest triangle, barycentric coordinates, point and distance.
+     *  @param maxDistance the maximum distance of the closest point.
+     *  @return whether a triangle was found within the maximum distance.
+     */
+    bool ConnectivityMesh::FindClosestPoint(const glm::vec3& point, BVHClosestPoint& result, float maxDistance) const
+    {
+        return impl_->FindClosestPoint(point, result, maxDistance);
+    }
+
+    /**
+     *  Finds the closest points on the triangles to a number of query points (in the meshes local coordinates)
+     *  in parallel.
+     *  @param points the query points.
+     *  @param results the closest points.
+     *  @param maxDistance the maximum distance of the closest points.
+     *  @param numThreads the number of threads to use (0 to use all hardware threads).
+     */
+    void ConnectivityMesh::FindClosestPoints(const std::vector<glm::vec3>& points, std::vector<BVHClosestPoint>& results,
+        float maxDistance, unsigned int numThreads) const
+    {
+        impl_->FindClosestPoints(points, results, maxDistance, numThreads);
+    }
+
+    /**
+     *  Returns the bounding volume hierarchy over all triangles for batched ray queries, it is built on first use.
+     */
+    const TriangleBVH& ConnectivityMesh::GetTriangleBVH() const
+    {
+        return impl_->GetTriangleBVH();
+    }
+
     const std::vector<std::unique_ptr<ConnectivitySubMesh>>& ConnectivityMesh::GetSubMeshes() const
     {
         return impl_->GetSubMeshes();
@@ -97,6 +163,93 @@ namespace cgu {
         return impl_->GetAdjacentVertices(vtxId);
     }
 
+    /**
+     *  Returns the vertices sharing a triangle with a vertex (or its location only vertex) in ascending order.
+     *  @param vtxId the vertex index.
+     */
+    MeshConnectRange ConnectivityMesh::GetOneRing(unsigned int vtxId) const
+    {
+        return impl_->GetOneRing(vtxId);
+    }
+
+    /**
+     *  Expands the k-rings around a vertex, ring 0 holds the vertex itself.
+     *  @param vtxId the vertex index.
+     *  @param k the number of rings to expand.
+     *  @param rings the buffer to write the rings to.
+     */
+    void ConnectivityMesh::ExpandRings(unsigned int vtxId, unsigned int k, MeshConnectRingBuffer& rings) const
+    {
+        impl_->ExpandRings(&vtxId, 1, k, rings);
+    }
+
+    /**
+     *  Expands the k-rings around a set of vertices, ring 0 holds the seed vertices.
+     *  @param seeds the seed vertices.
+     *  @param k the number of rings to expand.
+     *  @param rings the buffer to write the rings to.
+     */
+    void ConnectivityMesh::ExpandRings(const std::vector<unsigned int>& seeds, unsigned int k, MeshConnectRingBuffer& rings) const
+    {
+        impl_->ExpandRings(seeds.data(), seeds.size(), k, rings);
+    }
+
+    /**
+     *  Returns the triangles adjacent to a vertex (using the vertex or its location only vertex) in ascending order.
+     *  @param vtxId the vertex index.
+     */
+    MeshConnectRange ConnectivityMesh::GetVertexTriangles(unsigned int vtxId) const
+    {
+        return impl_->GetVertexTriangles(vtxId);
+    }
+
+    /** Returns the first triangle of each sub-mesh followed by the number of triangles. */
+    const std::vector<unsigned int>& ConnectivityMesh::GetSubMeshTriangleOffsets() const
+    {
+        return impl_->GetSubMeshTriangleOffsets();
+    }
+
+    /** Returns the undirected edges between location only vertices sorted by their vertices. */
+    const std::vector<MeshConnectEdge>& ConnectivityMesh::GetEdges() const
+    {
+        return impl_->GetEdges();
+    }
+
+    const MeshConnectEdge& ConnectivityMesh::GetEdge(unsigned int idx) const
+    {
+        return impl_->GetEdge(idx);
+    }
+
+    /**
+     *  Returns the half-edges of an edge in ascending order, half-edge h is the edge of triangle h / 3
+     *  opposite to its vertex h % 3.
+     *  @param edgeIdx the edge index.
+     */
+    MeshConnectRange ConnectivityMesh::GetEdgeHalfEdges(unsigned int edgeIdx) const
+    {
+        return impl_->GetEdgeHalfEdges(edgeIdx);
+    }
+
+    /**
+     *  Returns the edges of a triangle, edge i is opposite to the triangles vertex i.
+     *  @param triIdx the triangle index.
+     */
+    const std::array<unsigned int, 3>& ConnectivityMesh::GetTriangleEdges(unsigned int triIdx) const
+    {
+        return impl_->GetTriangleEdges(triIdx);
+    }
+
+    /**
+     *  Finds the edge between two location only vertices.
+     *  @param vtxId0 the first vertex.
+     *  @param vtxId1 the second vertex.
+     *  @return the edge index or NO_EDGE if the vertices are not connected.
+     */
+    unsigned int ConnectivityMesh::FindEdge(unsigned int vtxId0, unsigned int vtxId1) const
+    {
+        return impl_->FindEdge(vtxId0, vtxId1);
+    }
+
     const std::vector<MeshConnectVertex>& ConnectivityMesh::GetVertices() const
     {
         return impl_->GetVertices();
@@ -10,11 +10,14 @@
 #define CONNECTIVITYMESH_H
 
 #include "main.h"
+#include "VertexWelding.h"
 
 namespace cgu {
 
     class Mesh;
     class ConnectivitySubMesh;
+    class TriangleBVH;
+    struct BVHClosestPoint;
 
     namespace impl {
         class ConnectivityMeshImpl;
@@ -31,19 +34,61 @@ namespace cgu {
         unsigned int locOnlyIdx;
         /** Holds the vertices chunk id. */
         unsigned int chunkId;
-        /** Holds the vertexes triangles. */
-        std::vector<unsigned int> triangles;
 
         template<class Archive>
-        void serialize(Archive & ar, const unsigned int)
+        void serialize(Archive & ar, const unsigned int version)
         {
             ar & idx;
             ar & locOnlyIdx;
             ar & chunkId;
-            ar & triangles;
+            // the vertices triangles are stored in ConnectivityMesh::GetVertexTriangles since version 1.
+            if (version < 1) {
+                std::vector<unsigned int> triangles;
+                ar & triangles;
+            }
         }
     };
 
+    /** A range of indices stored consecutively (e.g. a row of an adjacency). */
+    struct MeshConnectRange
+    {
+        MeshConnectRange(const unsigned int* f, const unsigned int* l) : first{ f }, last{ l } {}
+
+        const unsigned int* begin() const { return first; }
+        const unsigned int* end() const { return last; }
+        std::size_t size() const { return static_cast<std::size_t>(last - first); }
+        bool empty() const { return first == last; }
+        unsigned int operator[](std::size_t i) const { return first[i]; }
+
+        /** Holds the first index. */
+        const unsigned int* first;
+        /** Holds the end of the indices. */
+        const unsigned int* last;
+    };
+
+    /**
+     *  Holds the result of a ring expansion and the buffers used for it. Reusing the same object for repeated
+     *  expansions avoids allocations once the buffers are large enough, each thread needs its own object.
+     */
+    struct MeshConnectRingBuffer
+    {
+        MeshConnectRingBuffer() : visitStamp_{ 0 } {}
+
+        /** Returns the number of rings expanded (including the seeds as ring 0). */
+        unsigned int GetNumRings() const { return ringOffsets_.empty() ? 0 : static_cast<unsigned int>(ringOffsets_.size() - 1); }
+        /** Returns the vertices of a ring in ascending order. */
+        MeshConnectRange GetRing(unsigned int ring) const { return MeshConnectRange(vertices_.data() + ringOffsets_[ring], vertices_.data() + ringOffsets_[ring + 1]); }
+
+        /** Holds the vertices of all rings, starting with the seeds. */
+        std::vector<unsigned int> vertices_;
+        /** Holds the offsets of each ring in the vertices (one more than rings). */
+        std::vector<unsigned int> ringOffsets_;
+        /** Holds the stamp of the last expansion each vertex was visited in. */
+        std::vector<unsigned int> visited_;
+        /** Holds the stamp of the current expansion. */
+        unsigned int visitStamp_;
+    };
+
     /** Contains indices for triangles vertices and connectivity. */
     struct MeshConnectTriangle
     {
@@ -71,6 +116,44 @@ namespace cgu {
         }
     };
 
+    /**
+     *  Contains an undirected edge between two location only vertices and the triangles sharing it.
+     *  The triangles are referenced by half-edges, half-edge h is the edge of triangle h / 3 opposite to its
+     *  vertex h % 3 (the same convention as MeshConnectTriangle::neighbors_). Edges of degenerate triangles
+     *  (loops or edges used twice by the same triangle) are non-manifold.
+     */
+    struct MeshConnectEdge
+    {
+        MeshConnectEdge() : vertex_({ { 0, 0 } }), firstHalfEdge_{ 0 }, numHalfEdges_{ 0 }, degenerate_{ false } {}
+        MeshConnectEdge(unsigned int v0, unsigned int v1, unsigned int firstHalfEdge, unsigned int numHalfEdges, bool degenerate) :
+            vertex_({ { v0, v1 } }), firstHalfEdge_{ firstHalfEdge }, numHalfEdges_{ numHalfEdges }, degenerate_{ degenerate } {}
+
+        /** Returns whether the edge is used by a single triangle only. */
+        bool IsBoundary() const { return numHalfEdges_ == 1 && !degenerate_; }
+        /** Returns whether the edge is shared by exactly two triangles. */
+        bool IsManifold() const { return numHalfEdges_ == 2 && !degenerate_; }
+        /** Returns whether the edge is shared by more than two triangles or belongs to a degenerate triangle. */
+        bool IsNonManifold() const { return numHalfEdges_ > 2 || degenerate_; }
+
+        /** Holds the edges location only vertices (the lower index first). */
+        std::array<unsigned int, 2> vertex_;
+        /** Holds the first of the edges half-edges in the half-edge list. */
+        unsigned int firstHalfEdge_;
+        /** Holds the number of the edges half-edges (a degenerate triangle may add two half-edges to an edge). */
+        unsigned int numHalfEdges_;
+        /** Holds whether the edge is a loop or used more than once by a triangle. */
+        bool degenerate_;
+
+        template<class Archive>
+        void serialize(Archive & ar, const unsigned int version)
+        {
+            ar & vertex_;
+            ar & firstHalfEdge_;
+            ar & numHalfEdges_;
+            if (version > 0) ar & degenerate_;
+        }
+    };
+
     /**
      * @brief  Collects connectivity information in meshes.
      *
@@ -80,7 +163,10 @@ namespace cgu {
     class ConnectivityMesh
     {
     public:
-        explicit ConnectivityMesh(const Mesh* mesh);
+        /** The edge index returned if no edge is found. */
+        static const unsigned int NO_EDGE = 0xFFFFFFFF;
+
+        explicit ConnectivityMesh(const Mesh* mesh, const VertexWeldingParameters& welding = VertexWeldingParameters());
         ConnectivityMesh(const ConnectivityMesh&);
         ConnectivityMesh& operator=(const ConnectivityMesh&);
         ConnectivityMesh(ConnectivityMesh&&);
@@ -93,9 +179,26 @@ namespace cgu {
         void FindTrianglesWithinRadius(const glm::vec3 center, float radius, std::vector<unsigned int>& result) const;
         unsigned int FindNearestTriangle(const glm::vec3 center) const;
         unsigned int FindContainingTriangle(const glm::vec3 point) const;
+        unsigned int FindFirstIntersectedTriangle(const glm::vec3& origin, const glm::vec3& direction, float* t = nullptr) const;
+        bool IsOccluded(const glm::vec3& origin, const glm::vec3& direction, float maxDistance = std::numeric_limits<float>::infinity()) const;
+        bool FindClosestPoint(const glm::vec3& point, BVHClosestPoint& result, float maxDistance = std::numeric_limits<float>::infinity()) const;
+        void FindClosestPoints(const std::vector<glm::vec3>& points, std::vector<BVHClosestPoint>& results,
+            float maxDistance = std::numeric_limits<float>::infinity(), unsigned int numThreads = 0) const;
+        const TriangleBVH& GetTriangleBVH() const;
         const std::vector<std::unique_ptr<ConnectivitySubMesh>>& GetSubMeshes() const;
 
         std::vector<size_t> GetAdjacentVertices(size_t vtxId) const;
+        MeshConnectRange GetOneRing(unsigned int vtxId) const;
+        void ExpandRings(unsigned int vtxId, unsigned int k, MeshConnectRingBuffer& rings) const;
+        void ExpandRings(const std::vector<unsigned int>& seeds, unsigned int k, MeshConnectRingBuffer& rings) const;
+        MeshConnectRange GetVertexTriangles(unsigned int vtxId) const;
+        const std::vector<unsigned int>& GetSubMeshTriangleOffsets() const;
+
+        const std::vector<MeshConnectEdge>& GetEdges() const;
+        const MeshConnectEdge& GetEdge(unsigned int idx) const;
+        MeshConnectRange GetEdgeHalfEdges(unsigned int edgeIdx) const;
+        const std::array<unsigned int, 3>& GetTriangleEdges(unsigned int triIdx) const;
+        unsigned int FindEdge(unsigned int vtxId0, unsigned int vtxId1) const;
 
         const std::vector<MeshConnectVertex>& GetVertices() const;
         const std::vector<MeshConnectTriangle>& GetTriangles() const;
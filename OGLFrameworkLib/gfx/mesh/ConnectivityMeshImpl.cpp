@@ -16,29 +16,75 @@
 #include "SubMesh.h"
 #include <boost/filesystem/operations.hpp>
 #include "ConnectivityMesh.h"
+#include "TriangleBVH.h"
+#include "MeshAdjacency.h"
+#include "core/parallel_helper.h"
+#include <cstring>
+#include <iomanip>
 #include <queue>
+#include <sstream>
 
-cgu::impl::ConnectivityMeshImpl::ConnectivityMeshImpl(const Mesh* mesh) :
-mesh_(mesh)
+/** The number of triangles processed by a single task when filling the triangle connectivity. */
+static const uint64_t TRIANGLE_CHUNK_SIZE = 1 << 16;
+
+/** Returns whether two sets of welding parameters weld the same vertices (the relative flag does not matter for 0). */
+static bool isSameWelding(const cgu::VertexWeldingParameters& lhs, const cgu::VertexWeldingParameters& rhs)
+{
+    return lhs.tolerance == rhs.tolerance && (lhs.tolerance == 0.0f || lhs.relativeTolerance == rhs.relativeTolerance);
+}
+
+cgu::impl::ConnectivityMeshImpl::ConnectivityMeshImpl(const Mesh* mesh, const VertexWeldingParameters& welding) :
+mesh_(mesh),
+welding_(welding)
 {
     auto meshFile = mesh->GetFullFilename();
     boost::filesystem::path origPath(meshFile);
-    auto connectFilePath = origPath.parent_path().string() + "/" + origPath.stem().string() + "_connectivity.myshbin";
-
-    if (!load(connectFilePath)) CreateNewConnectivity(connectFilePath, mesh);
+    auto connectFilePath = origPath.parent_path().string() + "/" + origPath.stem().string() + "_connectivity";
+    if (welding.tolerance != 0.0f) {
+        // the exact bits of the tolerance, decimal representations of small tolerances collide.
+        uint32_t toleranceBits;
+        std::memcpy(&toleranceBits, &welding.tolerance, sizeof(float));
+        std::ostringstream weldSuffix;
+        weldSuffix << "_weld" << std::hex << std::setw(8) << std::setfill('0') << toleranceBits << (welding.relativeTolerance ? "r" : "");
+        connectFilePath += weldSuffix.str();
+    }
+    connectFilePath += ".myshbin";
+
+    if (!load(connectFilePath)) CreateNewConnectivity(connectFilePath, mesh, welding);
+    else {
+        CalculateSubMeshTriangleOffsets();
+        CreateVertexTriangleAdjacency();
+        CreateOneRings();
+        // caches written before the edges were stored (or before degenerate edges were marked) get them added.
+        if (triangleEdges_.size() != triangleConnect_.size()) {
+            CreateEdgeAdjacency();
+            save(connectFilePath);
+        }
+    }
 }
 
 cgu::impl::ConnectivityMeshImpl::ConnectivityMeshImpl(const ConnectivityMeshImpl& rhs) :
 mesh_(rhs.mesh_),
 triangleConnect_(rhs.triangleConnect_),
 verticesConnect_(rhs.verticesConnect_),
+vertexTriangleOffsets_(rhs.vertexTriangleOffsets_),
+vertexTriangles_(rhs.vertexTriangles_),
+oneRingOffsets_(rhs.oneRingOffsets_),
+oneRings_(rhs.oneRings_),
+subMeshTriangleOffsets_(rhs.subMeshTriangleOffsets_),
+edgeConnect_(rhs.edgeConnect_),
+edgeHalfEdges_(rhs.edgeHalfEdges_),
+triangleEdges_(rhs.triangleEdges_),
 aabb_(rhs.aabb_),
+welding_(rhs.welding_),
 vertexFindTree_(rhs.vertexFindTree_),
 triangleFastFindTree_(rhs.triangleFastFindTree_)
 {
     for (unsigned int i = 0; i < mesh_->GetNumSubmeshes(); ++i) {
         subMeshConnectivity_.emplace_back(std::make_unique<ConnectivitySubMesh>(*rhs.GetSubMeshes()[i]));
     }
+    std::lock_guard<std::mutex> lock(rhs.triangleBVHMutex_);
+    if (rhs.triangleBVH_) triangleBVH_ = std::make_unique<TriangleBVH>(*rhs.triangleBVH_);
 }
 
 
@@ -57,10 +103,20 @@ cgu::impl::ConnectivityMeshImpl::ConnectivityMeshImpl(ConnectivityMeshImpl&& rhs
 mesh_(std::move(rhs.mesh_)),
 triangleConnect_(std::move(rhs.triangleConnect_)),
 verticesConnect_(std::move(rhs.verticesConnect_)),
+vertexTriangleOffsets_(std::move(rhs.vertexTriangleOffsets_)),
+vertexTriangles_(std::move(rhs.vertexTriangles_)),
+oneRingOffsets_(std::move(rhs.oneRingOffsets_)),
+oneRings_(std::move(rhs.oneRings_)),
+subMeshTriangleOffsets_(std::move(rhs.subMeshTriangleOffsets_)),
+edgeConnect_(std::move(rhs.edgeConnect_)),
+edgeHalfEdges_(std::move(rhs.edgeHalfEdges_)),
+triangleEdges_(std::move(rhs.triangleEdges_)),
 aabb_(std::move(rhs.aabb_)),
+welding_(rhs.welding_),
 subMeshConnectivity_(std::move(rhs.subMeshConnectivity_)),
 vertexFindTree_(std::move(rhs.vertexFindTree_)),
-triangleFastFindTree_(std::move(rhs.triangleFastFindTree_))
+triangleFastFindTree_(std::move(rhs.triangleFastFindTree_)),
+triangleBVH_(std::move(rhs.triangleBVH_))
 {
 }
 
@@ -68,15 +124,23 @@ triangleFastFindTree_(std::move(rhs.triangleFastFindTree_))
 cgu::impl::ConnectivityMeshImpl& cgu::impl::ConnectivityMeshImpl::operator=(ConnectivityMeshImpl&& rhs)
 {
     if (this != &rhs) {
-        this->~ConnectivityMeshImpl();
         mesh_ = std::move(rhs.mesh_);
         triangleConnect_ = std::move(rhs.triangleConnect_);
         verticesConnect_ = std::move(rhs.verticesConnect_);
+        vertexTriangleOffsets_ = std::move(rhs.vertexTriangleOffsets_);
+        vertexTriangles_ = std::move(rhs.vertexTriangles_);
+        oneRingOffsets_ = std::move(rhs.oneRingOffsets_);
+        oneRings_ = std::move(rhs.oneRings_);
+        subMeshTriangleOffsets_ = std::move(rhs.subMeshTriangleOffsets_);
+        edgeConnect_ = std::move(rhs.edgeConnect_);
+        edgeHalfEdges_ = std::move(rhs.edgeHalfEdges_);
+        triangleEdges_ = std::move(rhs.triangleEdges_);
         aabb_ = std::move(rhs.aabb_);
+        welding_ = rhs.welding_;
         subMeshConnectivity_ = std::move(rhs.subMeshConnectivity_);
         vertexFindTree_ = std::move(rhs.vertexFindTree_);
         triangleFastFindTree_ = std::move(rhs.triangleFastFindTree_);
-
+        triangleBVH_ = std::move(rhs.triangleBVH_);
     }
     return *this;
 }
@@ -85,33 +149,25 @@ cgu::impl::ConnectivityMeshImpl& cgu::impl::ConnectivityMeshImpl::operator=(Conn
 cgu::impl::ConnectivityMeshImpl::~ConnectivityMeshImpl() = default;
 
 
-void cgu::impl::ConnectivityMeshImpl::CreateNewConnectivity(const std::string& connectFilePath, const Mesh* mesh)
+void cgu::impl::ConnectivityMeshImpl::CreateNewConnectivity(const std::string& connectFilePath, const Mesh* mesh, const VertexWeldingParameters& welding)
 {
     CreateVertexRTree();
-    std::vector<unsigned int> reducedVertexMap(mesh->GetVertices().size(), static_cast<unsigned int>(mesh->GetVertices().size()));
-
-    cguMath::AABB3<float> meshAABB;
-    mesh->GetRootNode()->GetBoundingBox(meshAABB, glm::mat4(1.0f));
-    auto querySize = (meshAABB.minmax[1] - meshAABB.minmax[0]) / 20000.0f;
-
-    for (auto i = 0; i < mesh->GetVertices().size(); ++i) {
-        if (reducedVertexMap[i] != mesh->GetVertices().size()) continue;
-
-        typedef boost::geometry::model::box<point> box;
-        const auto& v = mesh->GetVertices()[i];
-        box queryBox(point(v.x - querySize.x, v.y - querySize.y, v.z - querySize.z), point(v.x + querySize.x, v.y + querySize.y, v.z + querySize.z));
-        namespace bgi = boost::geometry::index;
-        for (const auto& qr : vertexFindTree_ | bgi::adaptors::queried(bgi::within(queryBox))) {
-            if (mesh->GetVertices()[i] == mesh->GetVertices()[qr.second]) reducedVertexMap[qr.second] = i;
-        }
-    }
+    // maps each vertex to the lowest index of the vertices at the same location.
+    std::vector<unsigned int> reducedVertexMap;
+    vertexWelding::FindRepresentatives(mesh->GetVertices(), welding, reducedVertexMap);
 
     verticesConnect_.resize(mesh_->GetVertices().size());
+    for (unsigned int idx = 0; idx < verticesConnect_.size(); ++idx) {
+        verticesConnect_[idx].idx = idx;
+        verticesConnect_[idx].locOnlyIdx = reducedVertexMap[idx];
+    }
 
+    FillTriangleConnectivity(reducedVertexMap);
+    CreateVertexTriangleAdjacency();
+    CreateOneRings();
+    CreateEdgeAdjacency();
     for (unsigned int smI = 0; smI < mesh_->GetNumSubmeshes(); ++smI) {
-        auto firstIdx = FillSubmeshConnectivity(smI, reducedVertexMap);
-
-        subMeshConnectivity_.emplace_back(std::make_unique<ConnectivitySubMesh>(mesh_, this, smI, firstIdx));
+        subMeshConnectivity_.emplace_back(std::make_unique<ConnectivitySubMesh>(mesh_, this, smI, subMeshTriangleOffsets_[smI]));
     }
 
     CalculateChunkIds();
@@ -152,69 +208,52 @@ void cgu::impl::ConnectivityMeshImpl::FindTrianglesWithinRadius(const glm::vec3
 
 unsigned cgu::impl::ConnectivityMeshImpl::FindNearestTriangle(const glm::vec3 center) const
 {
-    namespace bgi = boost::geometry::index;
-    point pcenter(center.x, center.y, center.z);
-    for (const auto& qr : triangleFastFindTree_ | bgi::adaptors::queried(bgi::nearest(pcenter, 1))) return static_cast<unsigned>(qr.second);
+    // the rtree only knows the triangles bounding boxes, so use the exact distances from the hierarchy.
+    BVHClosestPoint closest;
+    if (FindClosestPoint(center, closest, std::numeric_limits<float>::infinity())) return closest.triangle;
     return static_cast<unsigned int>(triangleConnect_.size());
 }
 
-unsigned int cgu::impl::ConnectivityMeshImpl::FillSubmeshConnectivity(unsigned int smI, const std::vector<unsigned int>& reducedVertexMap)
+/**
+ *  Calculates the first triangle of each sub-mesh, the triangles of a sub-mesh are
+ *  [subMeshTriangleOffsets_[smI], subMeshTriangleOffsets_[smI + 1]).
+ */
+void cgu::impl::ConnectivityMeshImpl::CalculateSubMeshTriangleOffsets()
 {
-    const auto& subMesh = mesh_->GetSubMesh(smI);
-    auto firstIndex = static_cast<unsigned int>(triangleConnect_.size());
-    auto lastIndex = subMesh->GetIndexOffset() + subMesh->GetNumberOfIndices();
-
-    for (auto i = subMesh->GetIndexOffset(); i < lastIndex; i += 3) {
-        std::array<unsigned int, 3> indices = { mesh_->GetIndices()[i], mesh_->GetIndices()[i + 1], mesh_->GetIndices()[i + 2] };
-        std::array<unsigned int, 3> localIndices = { reducedVertexMap[indices[0]], reducedVertexMap[indices[1]], reducedVertexMap[indices[2]] };
-        triangleConnect_.emplace_back(indices, localIndices);
-    }
-
-    unsigned int cid = 0;
-    for (unsigned int idx = 0; idx < verticesConnect_.size(); ++idx) {
-        verticesConnect_[cid].idx = idx;
-        verticesConnect_[cid++].locOnlyIdx = reducedVertexMap[idx];
+    subMeshTriangleOffsets_.resize(mesh_->GetNumSubmeshes() + 1);
+    subMeshTriangleOffsets_[0] = 0;
+    for (unsigned int smI = 0; smI < mesh_->GetNumSubmeshes(); ++smI) {
+        subMeshTriangleOffsets_[smI + 1] = subMeshTriangleOffsets_[smI] + mesh_->GetSubMesh(smI)->GetNumberOfTriangles();
     }
+}
 
-    // set vertex connectivity
-    for (auto i = 0; i < triangleConnect_.size(); ++i) {
-        auto& tri = triangleConnect_[i];
-
-        for (auto j = 0; j < 3; ++j) {
-            auto& vl = verticesConnect_[tri.locOnlyVtxIds_[j]].triangles;
-            if (std::find(vl.begin(), vl.end(), i) == vl.end()) vl.push_back(i);
-
-            auto& vg = verticesConnect_[tri.vertex_[j]].triangles;
-            if (std::find(vg.begin(), vg.end(), i) == vg.end()) vg.push_back(i);
+/**
+ *  Fills the triangle connectivity of all sub-meshes in parallel.
+ *  @param reducedVertexMap the location only index of each vertex.
+ */
+void cgu::impl::ConnectivityMeshImpl::FillTriangleConnectivity(const std::vector<unsigned int>& reducedVertexMap)
+{
+    CalculateSubMeshTriangleOffsets();
+    triangleConnect_.resize(subMeshTriangleOffsets_.back());
+    const auto& meshIndices = mesh_->GetIndices();
+    parallel::ForChunks(triangleConnect_.size(), TRIANGLE_CHUNK_SIZE, [this, &meshIndices, &reducedVertexMap](uint64_t begin, uint64_t end, unsigned int)
+    {
+        // empty sub-meshes share their offset with the next one, so take the last sub-mesh starting at or before begin.
+        auto smI = static_cast<unsigned int>(std::upper_bound(subMeshTriangleOffsets_.begin(), subMeshTriangleOffsets_.end(), begin) - subMeshTriangleOffsets_.begin()) - 1;
+        for (auto t = begin; t < end; ++t) {
+            while (t >= subMeshTriangleOffsets_[smI + 1]) ++smI;
+            auto i = mesh_->GetSubMesh(smI)->GetIndexOffset() + 3 * static_cast<unsigned int>(t - subMeshTriangleOffsets_[smI]);
+            std::array<unsigned int, 3> indices = { meshIndices[i], meshIndices[i + 1], meshIndices[i + 2] };
+            std::array<unsigned int, 3> localIndices = { reducedVertexMap[indices[0]], reducedVertexMap[indices[1]], reducedVertexMap[indices[2]] };
+            triangleConnect_[t] = MeshConnectTriangle(indices, localIndices);
         }
-    }
+    });
+}
 
-    // set triangle neighbors
-    // TODO: find a suitable solution for meshes with more than two neighbors along one edge. [9/20/2016 Sebastian Maisch]
-    /*for (auto i = 0; i < triangleConnect_.size(); ++i) {
-        auto& tri = triangleConnect_[i];
-        for (unsigned int ni = 0; ni < 3; ++ni) {
-            auto vi0 = tri.locOnlyVtxIds_[(ni + 1) % 3];
-            auto vi1 = tri.locOnlyVtxIds_[(ni + 2) % 3];
-
-            if (vi0 == vi1) {
-                vi0 = tri.vertex_[(ni + 1) % 3];
-                vi1 = tri.vertex_[(ni + 2) % 3];
-            }
-            std::vector<unsigned int> isect;
-            std::set_intersection(verticesConnect_[vi0].triangles.begin(), verticesConnect_[vi0].triangles.end(),
-                verticesConnect_[vi1].triangles.begin(), verticesConnect_[vi1].triangles.end(), std::back_inserter(isect));
-            // if the mesh is planar and has borders only ONE triangle may be found!!!
-            // this triangle is the triangle itself not its neighbor
-            assert(isect.size() <= 2); // both this triangle and the neighbor should be found
-            if (isect.size() == 2) {
-                tri.neighbors_[ni] = isect[0] == i ? isect[1] : isect[0];
-            } else {
-                tri.neighbors_[ni] = -1;
-            }
-        }
-    }*/
-    return firstIndex;
+/** Creates the vertex to triangle adjacency in compressed sparse row form (see meshAdjacency::CreateVertexTriangles). */
+void cgu::impl::ConnectivityMeshImpl::CreateVertexTriangleAdjacency()
+{
+    meshAdjacency::CreateVertexTriangles(triangleConnect_, verticesConnect_.size(), vertexTriangleOffsets_, vertexTriangles_);
 }
 
 /**
@@ -246,26 +285,148 @@ unsigned int cgu::impl::ConnectivityMeshImpl::FindContainingTriangle(const glm::
 }
 
 
+/**
+ *  Returns the bounding volume hierarchy for ray queries, it is built on the first call.
+ */
+const cgu::TriangleBVH& cgu::impl::ConnectivityMeshImpl::GetTriangleBVH() const
+{
+    std::lock_guard<std::mutex> lock(triangleBVHMutex_);
+    if (!triangleBVH_) {
+        const auto& vertices = mesh_->GetVertices();
+        triangleBVH_ = std::make_unique<TriangleBVH>(static_cast<unsigned int>(triangleConnect_.size()), [this, &vertices](unsigned int i) {
+            const auto& tri = triangleConnect_[i];
+            return cguMath::Tri3<float>{ { vertices[tri.vertex_[0]], vertices[tri.vertex_[1]], vertices[tri.vertex_[2]] } };
+        });
+    }
+    return *triangleBVH_;
+}
 
-std::vector<size_t> cgu::impl::ConnectivityMeshImpl::GetAdjacentVertices(size_t vtxId) const
+/**
+ *  Finds the first triangle hit by a ray.
+ *  @param origin the rays origin.
+ *  @param direction the rays direction.
+ *  @param t the distance of the hit in multiples of the direction (optional).
+ *  @return the triangle index or the number of triangles if none was hit.
+ */
+unsigned int cgu::impl::ConnectivityMeshImpl::FindFirstIntersectedTriangle(const glm::vec3& origin, const glm::vec3& direction, float* t) const
 {
-    const auto& cvtx = GetVertices()[vtxId];
-    std::vector<size_t> connectedIndices;
+    BVHHit hit;
+    if (!GetTriangleBVH().Intersect(BVHRay(origin, direction), hit)) return static_cast<unsigned int>(triangleConnect_.size());
+    if (t != nullptr) *t = hit.t;
+    return hit.triangle;
+}
 
-    for (auto tIdx : cvtx.triangles) {
-        for (auto tVIdx : GetTriangle(tIdx).vertex_) {
-            if (tVIdx == cvtx.idx) continue;
+/**
+ *  Checks if a ray hits any triangle.
+ *  @param origin the rays origin.
+ *  @param direction the rays direction.
+ *  @param maxDistance the maximum distance of a hit in multiples of the direction.
+ */
+bool cgu::impl::ConnectivityMeshImpl::IsOccluded(const glm::vec3& origin, const glm::vec3& direction, float maxDistance) const
+{
+    return GetTriangleBVH().Occluded(BVHRay(origin, direction, 0.0f, maxDistance));
+}
 
-            auto insert = true;
-            for (auto i = 0U; i < connectedIndices.size(); ++i) {
-                if (connectedIndices[i] == tVIdx) insert = false;
-            }
+/**
+ *  Finds the closest point on the triangles to a query point.
+ *  @param point the query point.
+ *  @param result the closest point.
+ *  @param maxDistance the maximum distance of the closest point.
+ *  @return whether a triangle was found within the maximum distance.
+ */
+bool cgu::impl::ConnectivityMeshImpl::FindClosestPoint(const glm::vec3& point, BVHClosestPoint& result, float maxDistance) const
+{
+    return GetTriangleBVH().FindClosestPoint(point, result, maxDistance);
+}
 
-            if (insert) connectedIndices.push_back(tVIdx);
-        }
-    }
+/**
+ *  Finds the closest points on the triangles to a number of query points in parallel.
+ *  @param points the query points.
+ *  @param results the closest points.
+ *  @param maxDistance the maximum distance of the closest points.
+ *  @param numThreads the number of threads to use (0 to use all hardware threads).
+ */
+void cgu::impl::ConnectivityMeshImpl::FindClosestPoints(const std::vector<glm::vec3>& points, std::vector<BVHClosestPoint>& results,
+    float maxDistance, unsigned int numThreads) const
+{
+    GetTriangleBVH().FindClosestPoints(points, results, maxDistance, numThreads);
+}
+
+/** Creates the one-rings of all vertices in compressed sparse row form (see meshAdjacency::CreateOneRings). */
+void cgu::impl::ConnectivityMeshImpl::CreateOneRings()
+{
+    meshAdjacency::CreateOneRings(triangleConnect_, vertexTriangleOffsets_, vertexTriangles_, oneRingOffsets_, oneRings_);
+}
+
+/** Creates the undirected edges of all triangles and sets the triangle neighbors (see meshAdjacency::CreateEdges). */
+void cgu::impl::ConnectivityMeshImpl::CreateEdgeAdjacency()
+{
+    meshAdjacency::CreateEdges(triangleConnect_, verticesConnect_.size(), edgeConnect_, edgeHalfEdges_, triangleEdges_);
+}
+
+/**
+ *  Returns the half-edges of an edge in ascending order.
+ *  @param edgeIdx the edge index.
+ */
+cgu::MeshConnectRange cgu::impl::ConnectivityMeshImpl::GetEdgeHalfEdges(unsigned int edgeIdx) const
+{
+    const auto& edge = edgeConnect_[edgeIdx];
+    return MeshConnectRange(edgeHalfEdges_.data() + edge.firstHalfEdge_, edgeHalfEdges_.data() + edge.firstHalfEdge_ + edge.numHalfEdges_);
+}
 
-    return connectedIndices;
+/**
+ *  Finds the edge between two location only vertices.
+ *  @param vtxId0 the first vertex.
+ *  @param vtxId1 the second vertex.
+ *  @return the edge index or ConnectivityMesh::NO_EDGE if the vertices are not connected.
+ */
+unsigned int cgu::impl::ConnectivityMeshImpl::FindEdge(unsigned int vtxId0, unsigned int vtxId1) const
+{
+    std::array<unsigned int, 2> edgeVertices = { { std::min(vtxId0, vtxId1), std::max(vtxId0, vtxId1) } };
+    auto it = std::lower_bound(edgeConnect_.begin(), edgeConnect_.end(), edgeVertices,
+        [](const MeshConnectEdge& edge, const std::array<unsigned int, 2>& vertices) { return edge.vertex_ < vertices; });
+    if (it == edgeConnect_.end() || it->vertex_ != edgeVertices) return ConnectivityMesh::NO_EDGE;
+    return static_cast<unsigned int>(it - edgeConnect_.begin());
+}
+
+/**
+ *  Returns the triangles adjacent to a vertex (using the vertex or its location only vertex) in ascending order.
+ *  @param vtxId the vertex index.
+ */
+cgu::MeshConnectRange cgu::impl::ConnectivityMeshImpl::GetVertexTriangles(unsigned int vtxId) const
+{
+    return MeshConnectRange(vertexTriangles_.data() + vertexTriangleOffsets_[vtxId], vertexTriangles_.data() + vertexTriangleOffsets_[vtxId + 1]);
+}
+
+/**
+ *  Returns the vertices sharing a triangle with a vertex (or its location only vertex) in ascending order.
+ *  @param vtxId the vertex index.
+ */
+std::vector<size_t> cgu::impl::ConnectivityMeshImpl::GetAdjacentVertices(size_t vtxId) const
+{
+    auto oneRing = GetOneRing(static_cast<unsigned int>(vtxId));
+    return std::vector<size_t>(oneRing.begin(), oneRing.end());
+}
+
+/**
+ *  Returns the vertices sharing a triangle with a vertex (or its location only vertex) in ascending order.
+ *  @param vtxId the vertex index.
+ */
+cgu::MeshConnectRange cgu::impl::ConnectivityMeshImpl::GetOneRing(unsigned int vtxId) const
+{
+    return MeshConnectRange(oneRings_.data() + oneRingOffsets_[vtxId], oneRings_.data() + oneRingOffsets_[vtxId + 1]);
+}
+
+/**
+ *  Expands the k-rings around a set of seed vertices (see meshAdjacency::ExpandRings).
+ *  @param seeds the seed vertices.
+ *  @param numSeeds the number of seed vertices.
+ *  @param k the number of rings to expand.
+ *  @param rings the buffer to write the rings to.
+ */
+void cgu::impl::ConnectivityMeshImpl::ExpandRings(const unsigned int* seeds, std::size_t numSeeds, unsigned int k, MeshConnectRingBuffer& rings) const
+{
+    meshAdjacency::ExpandRings(oneRingOffsets_, oneRings_, seeds, numSeeds, k, rings);
 }
 
 bool cgu::impl::ConnectivityMeshImpl::load(const std::string& meshFile)
@@ -285,9 +446,21 @@ bool cgu::impl::ConnectivityMeshImpl::load(const std::string& meshFile)
 
             inBinFile.close();
             inBinFile = std::ifstream(meshFile, std::ios::binary);
+            auto welding = welding_;
             serialization::iarchive ia(inBinFile, mesh_, this);
             ia >> *this;
-            return true;
+            if (isSameWelding(welding_, welding)) return true;
+
+            // the cache was written with other welding parameters, so it is rebuilt.
+            LOG(INFO) << "Connectivity cache " << meshFile << " was created with other welding parameters.";
+            triangleConnect_.clear();
+            verticesConnect_.clear();
+            subMeshConnectivity_.clear();
+            edgeConnect_.clear();
+            edgeHalfEdges_.clear();
+            triangleEdges_.clear();
+            welding_ = welding;
+            return false;
         }
     }
     return false;
@@ -320,7 +493,9 @@ bool cgu::impl::ConnectivityMeshImpl::loadV1(std::ifstream& inBinFile)
         serializeHelper::read(inBinFile, vtx.idx);
         serializeHelper::read(inBinFile, vtx.locOnlyIdx);
         serializeHelper::read(inBinFile, vtx.chunkId);
-        serializeHelper::readV(inBinFile, vtx.triangles);
+        // the vertices triangles are created from the triangles after loading.
+        std::vector<unsigned int> vertexTriangles;
+        serializeHelper::readV(inBinFile, vertexTriangles);
     }
 
     unsigned int numSubmeshes;
@@ -364,7 +539,6 @@ void cgu::impl::ConnectivityMeshImpl::save(const std::string& meshFile)
     serializeHelper::write(ofs, vtx.idx);
     serializeHelper::write(ofs, vtx.locOnlyIdx);
     serializeHelper::write(ofs, vtx.chunkId);
-    serializeHelper::writeV(ofs, vtx.triangles);
     }
 
     serializeHelper::write(ofs, static_cast<unsigned int>(subMeshConnectivity_.size()));
@@ -442,7 +616,7 @@ void cgu::impl::ConnectivityMeshImpl::MarkVertexForChunk(MeshConnectVertex& vtx,
         if (verticesConnect_[vId].chunkId == chunkId) continue;
 
         verticesConnect_[vId].chunkId = chunkId;
-        for (auto tId : verticesConnect_[vId].triangles) {
+        for (auto tId : GetVertexTriangles(vId)) {
             for (auto vIdNext : triangleConnect_[tId].locOnlyVtxIds_) {
                 workingChunkQueue.push(vIdNext);
             }
@@ -12,6 +12,7 @@
 #define BOOST_GEOMETRY_INDEX_DETAIL_EXPERIMENTAL
 
 #include "main.h"
+#include "VertexWelding.h"
 #include <core/math/math.h>
 #include <boost/geometry/geometries/point.hpp>
 #include <boost/geometry/index/rtree.hpp>
@@ -24,20 +25,26 @@
 #include <boost/archive/binary_oarchive.hpp>
 #include <boost/archive/binary_iarchive.hpp>
 // ReSharper restore CppUnusedIncludeDirective
+#include <mutex>
 
 namespace cgu {
 
     class Mesh;
     class ConnectivitySubMesh;
+    class TriangleBVH;
+    struct BVHClosestPoint;
     struct MeshConnectVertex;
     struct MeshConnectTriangle;
+    struct MeshConnectRange;
+    struct MeshConnectEdge;
+    struct MeshConnectRingBuffer;
 
     namespace impl {
 
         class ConnectivityMeshImpl
         {
         public:
-            explicit ConnectivityMeshImpl(const Mesh* mesh);
+            ConnectivityMeshImpl(const Mesh* mesh, const VertexWeldingParameters& welding);
             ConnectivityMeshImpl(const ConnectivityMeshImpl&);
             ConnectivityMeshImpl& operator=(const ConnectivityMeshImpl&);
             ConnectivityMeshImpl(ConnectivityMeshImpl&&);
@@ -50,9 +57,23 @@ namespace cgu {
             void FindTrianglesWithinRadius(const glm::vec3 center, float radius, std::vector<unsigned int>& result) const;
             unsigned int FindNearestTriangle(const glm::vec3 center) const;
             unsigned int FindContainingTriangle(const glm::vec3 point);
+            unsigned int FindFirstIntersectedTriangle(const glm::vec3& origin, const glm::vec3& direction, float* t) const;
+            bool IsOccluded(const glm::vec3& origin, const glm::vec3& direction, float maxDistance) const;
+            bool FindClosestPoint(const glm::vec3& point, BVHClosestPoint& result, float maxDistance) const;
+            void FindClosestPoints(const std::vector<glm::vec3>& points, std::vector<BVHClosestPoint>& results, float maxDistance, unsigned int numThreads) const;
+            const TriangleBVH& GetTriangleBVH() const;
             const std::vector<std::unique_ptr<ConnectivitySubMesh>>& GetSubMeshes() const { return subMeshConnectivity_; }
 
             std::vector<size_t> GetAdjacentVertices(size_t vtxId) const;
+            MeshConnectRange GetOneRing(unsigned int vtxId) const;
+            void ExpandRings(const unsigned int* seeds, std::size_t numSeeds, unsigned int k, MeshConnectRingBuffer& rings) const;
+            MeshConnectRange GetVertexTriangles(unsigned int vtxId) const;
+            const std::vector<unsigned int>& GetSubMeshTriangleOffsets() const { return subMeshTriangleOffsets_; }
+            const std::vector<MeshConnectEdge>& GetEdges() const { return edgeConnect_; }
+            const MeshConnectEdge& GetEdge(unsigned int idx) const { return edgeConnect_[idx]; }
+            MeshConnectRange GetEdgeHalfEdges(unsigned int edgeIdx) const;
+            const std::array<unsigned int, 3>& GetTriangleEdges(unsigned int triIdx) const { return triangleEdges_[triIdx]; }
+            unsigned int FindEdge(unsigned int vtxId0, unsigned int vtxId1) const;
 
             const std::vector<MeshConnectVertex>& GetVertices() const { return verticesConnect_; }
             const std::vector<MeshConnectTriangle>& GetTriangles() const { return triangleConnect_; }
@@ -72,17 +93,32 @@ namespace cgu {
                 ar & subMeshConnectivity_;
                 ar & triangleFastFindTree_;
 
-                if (version > 1) {} // do things here...
+                if (version > 1) {
+                    ar & edgeConnect_;
+                    ar & edgeHalfEdges_;
+                    ar & triangleEdges_;
+                }
+                if (version > 2) {
+                    ar & welding_.tolerance;
+                    ar & welding_.relativeTolerance;
+                } else welding_ = VertexWeldingParameters();
+                // edges written before degenerate edges were marked are created again after loading.
+                if (version < 4) triangleEdges_.clear();
+                if (version > 4) {} // do things here...
             }
 
             bool load(const std::string& meshFile);
             bool loadV1(std::ifstream& inBinFile);
             void save(const std::string& meshFile);
 
-            void CreateNewConnectivity(const std::string& connectFilePath, const Mesh* mesh);
+            void CreateNewConnectivity(const std::string& connectFilePath, const Mesh* mesh, const VertexWeldingParameters& welding);
             void CreateVertexRTree();
             void CreateTriangleRTree();
-            unsigned int FillSubmeshConnectivity(unsigned int smI, const std::vector<unsigned int>& reducedVertexMap);
+            void CalculateSubMeshTriangleOffsets();
+            void FillTriangleConnectivity(const std::vector<unsigned int>& reducedVertexMap);
+            void CreateVertexTriangleAdjacency();
+            void CreateEdgeAdjacency();
+            void CreateOneRings();
             void CalculateChunkIds();
             void MarkVertexForChunk(MeshConnectVertex& vtx, unsigned int chunkId);
 
@@ -92,8 +128,26 @@ namespace cgu {
             std::vector<MeshConnectTriangle> triangleConnect_;
             /** Holds a list of vertex connectivity information. */
             std::vector<MeshConnectVertex> verticesConnect_;
+            /** Holds the offsets of each vertices triangles in vertexTriangles_ (one more than vertices). */
+            std::vector<unsigned int> vertexTriangleOffsets_;
+            /** Holds the triangles of all vertices in ascending order per vertex. */
+            std::vector<unsigned int> vertexTriangles_;
+            /** Holds the offsets of each vertices one-ring in oneRings_ (one more than vertices). */
+            std::vector<unsigned int> oneRingOffsets_;
+            /** Holds the adjacent vertices of all vertices in ascending order per vertex. */
+            std::vector<unsigned int> oneRings_;
+            /** Holds the first triangle of each sub-mesh (one more than sub-meshes). */
+            std::vector<unsigned int> subMeshTriangleOffsets_;
+            /** Holds the undirected edges sorted by their vertices. */
+            std::vector<MeshConnectEdge> edgeConnect_;
+            /** Holds the half-edges of all edges, each edge references a consecutive ascending range. */
+            std::vector<unsigned int> edgeHalfEdges_;
+            /** Holds the edges of each triangle (edge i is opposite to vertex i). */
+            std::vector<std::array<unsigned int, 3>> triangleEdges_;
             /** Contains a bounding box containing all sub-meshes. */
             cguMath::AABB3<float> aabb_;
+            /** Holds the parameters the vertices were welded with. */
+            VertexWeldingParameters welding_;
             /** Connectivity information for the sub-meshes. */
             std::vector<std::unique_ptr<ConnectivitySubMesh>> subMeshConnectivity_;
 
@@ -112,6 +166,10 @@ namespace cgu {
             VertexRTreeType vertexFindTree_;
             /** Holds the tree for fast finding points in triangles. */
             TriangleRTreeType triangleFastFindTree_;
+            /** Holds the bounding volume hierarchy for ray queries (built on first use). */
+            mutable std::unique_ptr<TriangleBVH> triangleBVH_;
+            /** Holds the mutex for building the bounding volume hierarchy. */
+            mutable std::mutex triangleBVHMutex_;
         };
 
         namespace serialization {
@@ -147,6 +205,8 @@ namespace boost {
     }
 }
 
-BOOST_CLASS_VERSION(cgu::impl::ConnectivityMeshImpl, 1)
+BOOST_CLASS_VERSION(cgu::MeshConnectVertex, 1)
+BOOST_CLASS_VERSION(cgu::MeshConnectEdge, 1)
+BOOST_CLASS_VERSION(cgu::impl::ConnectivityMeshImpl, 4)
 
 #endif // CONNECTIVITYMESHIMPL_H
@@ -154,8 +154,8 @@ namespace cgu {
         auto& vertices = mesh_->GetVertices();
         if (numTriangles_ == 0) return;
         aabb_.minmax[0] = aabb_.minmax[1] = vertices[cMesh_->GetTriangle(triangleRangeStart_).vertex_[0]].xyz();
-        for (const auto& tri : cMesh_->GetTriangles()) {
-            for (auto vi : tri.locOnlyVtxIds_) {
+        for (auto ti = triangleRangeStart_; ti < triangleRangeStart_ + numTriangles_; ++ti) {
+            for (auto vi : cMesh_->GetTriangle(ti).locOnlyVtxIds_) {
                 aabb_.minmax[0] = glm::min(aabb_.minmax[0], vertices[vi].xyz());
                 aabb_.minmax[1] = glm::max(aabb_.minmax[1], vertices[vi].xyz());
             }
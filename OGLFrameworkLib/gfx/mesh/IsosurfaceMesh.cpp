@@ -0,0 +1,49 @@
+/**
+ * @file   IsosurfaceMesh.cpp
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Implementation of a mesh generated from an isosurface.
+ */
+
+#include "IsosurfaceMesh.h"
+#include "gfx/Material.h"
+
+namespace cgu {
+
+    /**
+     *  Constructor.
+     *  @param positions the vertex positions.
+     *  @param normals the vertex normals.
+     *  @param indices the triangle indices.
+     */
+    IsosurfaceMesh::IsosurfaceMesh(const std::vector<glm::vec3>& positions, const std::vector<glm::vec3>& normals,
+        const std::vector<unsigned int>& indices)
+    {
+        assert(positions.size() == normals.size());
+        ReserveMesh(0, 0, static_cast<unsigned int>(positions.size()), static_cast<unsigned int>(indices.size()), 1);
+        std::copy(positions.begin(), positions.end(), GetVertices().begin());
+        std::copy(normals.begin(), normals.end(), GetNormals().begin());
+        std::copy(indices.begin(), indices.end(), GetIndices().begin());
+
+        AddSubMesh("isosurface", 0, static_cast<unsigned int>(indices.size()), GetMaterial(0));
+        CreateSceneNodes("isosurface");
+        CreateIndexBuffer();
+    }
+
+    /** Default copy constructor. */
+    IsosurfaceMesh::IsosurfaceMesh(const IsosurfaceMesh&) = default;
+    /** Default copy assignment operator. */
+    IsosurfaceMesh& IsosurfaceMesh::operator=(const IsosurfaceMesh&) = default;
+    /** Default move constructor. */
+    IsosurfaceMesh::IsosurfaceMesh(IsosurfaceMesh&& rhs) : Mesh(std::move(rhs)) {}
+    /** Default move assignment operator. */
+    IsosurfaceMesh& IsosurfaceMesh::operator=(IsosurfaceMesh&& rhs)
+    {
+        Mesh::operator=(std::move(rhs));
+        return *this;
+    }
+
+    /** Default destructor. */
+    IsosurfaceMesh::~IsosurfaceMesh() = default;
+}
@@ -0,0 +1,41 @@
+/**
+ * @file   IsosurfaceMesh.h
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Contains the definition of a mesh generated from an isosurface.
+ */
+
+#ifndef ISOSURFACEMESH_H
+#define ISOSURFACEMESH_H
+
+#include "main.h"
+#include "Mesh.h"
+
+namespace cgu {
+
+    /**
+     * @brief  Mesh with a single sub-mesh built from generated triangles (e.g. an extracted isosurface).
+     * The mesh uses a single default material. The index buffer is created on construction, so it has to be
+     * constructed on a thread with an active OpenGL context.
+     *
+     * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+     * @date   2026.10.16
+     */
+    class IsosurfaceMesh : public Mesh
+    {
+    public:
+        IsosurfaceMesh(const std::vector<glm::vec3>& positions, const std::vector<glm::vec3>& normals,
+            const std::vector<unsigned int>& indices);
+        IsosurfaceMesh(const IsosurfaceMesh&);
+        IsosurfaceMesh& operator=(const IsosurfaceMesh&);
+        IsosurfaceMesh(IsosurfaceMesh&&);
+        IsosurfaceMesh& operator=(IsosurfaceMesh&&);
+        virtual ~IsosurfaceMesh();
+
+        /** Returns the number of triangles. */
+        unsigned int GetNumTriangles() const { return static_cast<unsigned int>(GetIndices().size() / 3); }
+    };
+}
+
+#endif // ISOSURFACEMESH_H
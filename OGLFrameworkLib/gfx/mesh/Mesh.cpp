@@ -152,6 +152,11 @@ namespace cgu {
         rootNode_ = std::make_unique<SceneMeshNode>(rootNode, nullptr, subMeshes_);
     }
 
+    void Mesh::CreateSceneNodes(const std::string& nodeName)
+    {
+        rootNode_ = std::make_unique<SceneMeshNode>(nodeName, subMeshes_);
+    }
+
     void Mesh::write(std::ofstream& ofs) const
     {
         VersionableSerializerType::writeHeader(ofs);
@@ -84,6 +84,7 @@ namespace cgu {
         void CreateIndexBuffer();
 
         void CreateSceneNodes(aiNode* rootNode);
+        void CreateSceneNodes(const std::string& nodeName);
 
     private:
         using VersionableSerializerType = serializeHelper::VersionableSerializer<'M', 'E', 'S', 'H', 1001>;
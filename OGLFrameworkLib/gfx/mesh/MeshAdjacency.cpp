@@ -0,0 +1,283 @@
+/**
+ * @file   MeshAdjacency.cpp
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Implementation of the functions to create the adjacency information of connectivity meshes.
+ */
+
+#include "MeshAdjacency.h"
+#include "core/parallel_helper.h"
+#include <algorithm>
+#include <atomic>
+
+namespace cgu {
+
+    namespace meshAdjacency {
+
+        /** The number of triangles or vertices processed by a single task. */
+        static const uint64_t ADJACENCY_CHUNK_SIZE = 1 << 16;
+
+        /**
+         *  Collects the distinct vertices and location only vertices of a triangle.
+         *  @param tri the triangle.
+         *  @param vertices the vertices (output).
+         *  @return the number of distinct vertices.
+         */
+        static unsigned int getTriangleVertices(const MeshConnectTriangle& tri, std::array<unsigned int, 6>& vertices)
+        {
+            auto numVertices = 0U;
+            for (auto v : { tri.vertex_[0], tri.vertex_[1], tri.vertex_[2], tri.locOnlyVtxIds_[0], tri.locOnlyVtxIds_[1], tri.locOnlyVtxIds_[2] }) {
+                if (std::find(vertices.begin(), vertices.begin() + numVertices, v) == vertices.begin() + numVertices) vertices[numVertices++] = v;
+            }
+            return numVertices;
+        }
+
+        /**
+         *  Creates the vertex to triangle adjacency. Each vertex is adjacent to the triangles using it or its location
+         *  only vertex, each row is sorted ascending. The rows are filled by a counting sort over all triangles
+         *  (atomic counters, a prefix sum and a scatter) and sorted afterwards.
+         *  @param triangles the triangles.
+         *  @param numVertices the number of vertices.
+         *  @param offsets the offsets of each vertices row (output, one more than vertices).
+         *  @param vertexTriangles the triangles of all vertices (output).
+         *  @param numThreads the number of threads to use (0 for all).
+         */
+        void CreateVertexTriangles(const std::vector<MeshConnectTriangle>& triangles, std::size_t numVertices,
+            std::vector<unsigned int>& offsets, std::vector<unsigned int>& vertexTriangles, unsigned int numThreads)
+        {
+            std::unique_ptr<std::atomic<unsigned int>[]> counters(new std::atomic<unsigned int>[numVertices]);
+            for (std::size_t i = 0; i < numVertices; ++i) counters[i].store(0, std::memory_order_relaxed);
+            parallel::ForChunks(triangles.size(), ADJACENCY_CHUNK_SIZE, [&triangles, &counters](uint64_t begin, uint64_t end, unsigned int)
+            {
+                std::array<unsigned int, 6> vertices;
+                for (auto t = begin; t < end; ++t) {
+                    auto numTriVertices = getTriangleVertices(triangles[t], vertices);
+                    for (auto i = 0U; i < numTriVertices; ++i) counters[vertices[i]].fetch_add(1, std::memory_order_relaxed);
+                }
+            }, numThreads);
+
+            offsets.resize(numVertices + 1);
+            offsets[0] = 0;
+            for (std::size_t i = 0; i < numVertices; ++i) {
+                offsets[i + 1] = offsets[i] + counters[i].load(std::memory_order_relaxed);
+                counters[i].store(offsets[i], std::memory_order_relaxed);
+            }
+
+            vertexTriangles.resize(offsets.back());
+            parallel::ForChunks(triangles.size(), ADJACENCY_CHUNK_SIZE, [&triangles, &counters, &vertexTriangles](uint64_t begin, uint64_t end, unsigned int)
+            {
+                std::array<unsigned int, 6> vertices;
+                for (auto t = begin; t < end; ++t) {
+                    auto numTriVertices = getTriangleVertices(triangles[t], vertices);
+                    for (auto i = 0U; i < numTriVertices; ++i) vertexTriangles[counters[vertices[i]].fetch_add(1, std::memory_order_relaxed)] = static_cast<unsigned int>(t);
+                }
+            }, numThreads);
+
+            parallel::ForChunks(numVertices, ADJACENCY_CHUNK_SIZE, [&offsets, &vertexTriangles](uint64_t begin, uint64_t end, unsigned int)
+            {
+                for (auto v = begin; v < end; ++v) std::sort(vertexTriangles.begin() + offsets[v], vertexTriangles.begin() + offsets[v + 1]);
+            }, numThreads);
+        }
+
+        /**
+         *  Creates the undirected edges of all triangles and sets the triangle neighbors. Edges are defined by
+         *  location only vertices, so triangles are connected across texture or normal seams. The half-edges are
+         *  sorted into buckets by the lower vertex of their edge (a counting sort), each bucket is sorted by the
+         *  higher vertex and the half-edge itself. This gives edges sorted by their vertices with ascending
+         *  half-edges. Edges shared by more than two triangles and edges of degenerate triangles are kept as
+         *  non-manifold edges, triangles only get neighbors along manifold edges.
+         *  @param triangles the triangles, their neighbors are set.
+         *  @param numVertices the number of vertices.
+         *  @param edges the edges (output).
+         *  @param edgeHalfEdges the half-edges of all edges (output).
+         *  @param triangleEdges the edge opposite to each vertex of each triangle (output).
+         *  @param numThreads the number of threads to use (0 for all).
+         */
+        void CreateEdges(std::vector<MeshConnectTriangle>& triangles, std::size_t numVertices, std::vector<MeshConnectEdge>& edges,
+            std::vector<unsigned int>& edgeHalfEdges, std::vector<std::array<unsigned int, 3>>& triangleEdges, unsigned int numThreads)
+        {
+            auto numHalfEdges = 3 * triangles.size();
+            auto getEdgeVertices = [&triangles](uint64_t he)
+            {
+                const auto& tri = triangles[he / 3];
+                auto v0 = tri.locOnlyVtxIds_[(he + 1) % 3];
+                auto v1 = tri.locOnlyVtxIds_[(he + 2) % 3];
+                return std::make_pair(std::min(v0, v1), std::max(v0, v1));
+            };
+
+            std::unique_ptr<std::atomic<unsigned int>[]> counters(new std::atomic<unsigned int>[numVertices]);
+            for (std::size_t i = 0; i < numVertices; ++i) counters[i].store(0, std::memory_order_relaxed);
+            parallel::ForChunks(numHalfEdges, ADJACENCY_CHUNK_SIZE, [&getEdgeVertices, &counters](uint64_t begin, uint64_t end, unsigned int)
+            {
+                for (auto he = begin; he < end; ++he) counters[getEdgeVertices(he).first].fetch_add(1, std::memory_order_relaxed);
+            }, numThreads);
+
+            std::vector<unsigned int> bucketOffsets(numVertices + 1);
+            bucketOffsets[0] = 0;
+            for (std::size_t i = 0; i < numVertices; ++i) {
+                bucketOffsets[i + 1] = bucketOffsets[i] + counters[i].load(std::memory_order_relaxed);
+                counters[i].store(bucketOffsets[i], std::memory_order_relaxed);
+            }
+
+            edgeHalfEdges.resize(numHalfEdges);
+            parallel::ForChunks(numHalfEdges, ADJACENCY_CHUNK_SIZE, [&getEdgeVertices, &counters, &edgeHalfEdges](uint64_t begin, uint64_t end, unsigned int)
+            {
+                for (auto he = begin; he < end; ++he) edgeHalfEdges[counters[getEdgeVertices(he).first].fetch_add(1, std::memory_order_relaxed)] = static_cast<unsigned int>(he);
+            }, numThreads);
+            counters.reset();
+
+            // sort the buckets and count their edges.
+            std::vector<unsigned int> bucketEdgeOffsets(numVertices + 1, 0);
+            parallel::ForChunks(numVertices, ADJACENCY_CHUNK_SIZE, [&getEdgeVertices, &edgeHalfEdges, &bucketOffsets, &bucketEdgeOffsets](uint64_t begin, uint64_t end, unsigned int)
+            {
+                for (auto v = begin; v < end; ++v) {
+                    auto bucketBegin = edgeHalfEdges.begin() + bucketOffsets[v];
+                    auto bucketEnd = edgeHalfEdges.begin() + bucketOffsets[v + 1];
+                    std::sort(bucketBegin, bucketEnd, [&getEdgeVertices](unsigned int he0, unsigned int he1)
+                    {
+                        auto v0 = getEdgeVertices(he0).second;
+                        auto v1 = getEdgeVertices(he1).second;
+                        return v0 < v1 || (v0 == v1 && he0 < he1);
+                    });
+                    for (auto it = bucketBegin; it != bucketEnd; ++it) {
+                        if (it == bucketBegin || getEdgeVertices(*it).second != getEdgeVertices(*(it - 1)).second) ++bucketEdgeOffsets[v + 1];
+                    }
+                }
+            }, numThreads);
+            for (std::size_t i = 0; i < numVertices; ++i) bucketEdgeOffsets[i + 1] += bucketEdgeOffsets[i];
+
+            edges.resize(bucketEdgeOffsets.back());
+            triangleEdges.resize(triangles.size());
+            parallel::ForChunks(numVertices, ADJACENCY_CHUNK_SIZE, [&](uint64_t begin, uint64_t end, unsigned int)
+            {
+                for (auto v = begin; v < end; ++v) {
+                    auto edgeIdx = bucketEdgeOffsets[v];
+                    for (auto i = bucketOffsets[v]; i < bucketOffsets[v + 1]; ++edgeIdx) {
+                        auto edgeVertices = getEdgeVertices(edgeHalfEdges[i]);
+                        auto first = i;
+                        // half-edges of the same triangle are consecutive, as they are sorted.
+                        auto degenerate = edgeVertices.first == edgeVertices.second;
+                        for (; i < bucketOffsets[v + 1] && getEdgeVertices(edgeHalfEdges[i]) == edgeVertices; ++i) {
+                            if (i > first && edgeHalfEdges[i] / 3 == edgeHalfEdges[i - 1] / 3) degenerate = true;
+                            triangleEdges[edgeHalfEdges[i] / 3][edgeHalfEdges[i] % 3] = edgeIdx;
+                        }
+                        edges[edgeIdx] = MeshConnectEdge(edgeVertices.first, edgeVertices.second, first, i - first, degenerate);
+                    }
+                }
+            }, numThreads);
+
+            parallel::ForChunks(triangles.size(), ADJACENCY_CHUNK_SIZE, [&triangles, &edges, &edgeHalfEdges, &triangleEdges](uint64_t begin, uint64_t end, unsigned int)
+            {
+                for (auto t = begin; t < end; ++t) {
+                    for (unsigned int ni = 0; ni < 3; ++ni) {
+                        const auto& edge = edges[triangleEdges[t][ni]];
+                        auto& neighbor = triangles[t].neighbors_[ni];
+                        neighbor = -1;
+                        if (!edge.IsManifold()) continue;
+                        auto otherHalfEdge = edgeHalfEdges[edge.firstHalfEdge_] / 3 == t ? edgeHalfEdges[edge.firstHalfEdge_ + 1] : edgeHalfEdges[edge.firstHalfEdge_];
+                        neighbor = static_cast<int>(otherHalfEdge / 3);
+                    }
+                }
+            }, numThreads);
+        }
+
+        /**
+         *  Creates the one-rings of all vertices. The one-ring of a vertex contains the vertices of all triangles
+         *  adjacent to it (see CreateVertexTriangles) except the vertex itself, each row is sorted ascending.
+         *  @param triangles the triangles.
+         *  @param vertexTriangleOffsets the offsets of each vertices triangles.
+         *  @param vertexTriangles the triangles of all vertices.
+         *  @param offsets the offsets of each vertices one-ring (output, one more than vertices).
+         *  @param oneRings the one-rings of all vertices (output).
+         *  @param numThreads the number of threads to use (0 for all).
+         */
+        void CreateOneRings(const std::vector<MeshConnectTriangle>& triangles, const std::vector<unsigned int>& vertexTriangleOffsets,
+            const std::vector<unsigned int>& vertexTriangles, std::vector<unsigned int>& offsets, std::vector<unsigned int>& oneRings,
+            unsigned int numThreads)
+        {
+            auto numVertices = vertexTriangleOffsets.size() - 1;
+            if (numThreads == 0) numThreads = parallel::GetNumThreads();
+            std::vector<std::vector<unsigned int>> threadRings(numThreads);
+            auto collectOneRing = [&triangles, &vertexTriangleOffsets, &vertexTriangles](uint64_t v, std::vector<unsigned int>& oneRing)
+            {
+                oneRing.clear();
+                for (auto i = vertexTriangleOffsets[v]; i < vertexTriangleOffsets[v + 1]; ++i) {
+                    for (auto tVIdx : triangles[vertexTriangles[i]].vertex_) if (tVIdx != v) oneRing.push_back(tVIdx);
+                }
+                std::sort(oneRing.begin(), oneRing.end());
+                oneRing.erase(std::unique(oneRing.begin(), oneRing.end()), oneRing.end());
+            };
+
+            offsets.resize(numVertices + 1);
+            offsets[0] = 0;
+            parallel::ForChunks(numVertices, ADJACENCY_CHUNK_SIZE, [&offsets, &threadRings, &collectOneRing](uint64_t begin, uint64_t end, unsigned int threadIdx)
+            {
+                for (auto v = begin; v < end; ++v) {
+                    collectOneRing(v, threadRings[threadIdx]);
+                    offsets[v + 1] = static_cast<unsigned int>(threadRings[threadIdx].size());
+                }
+            }, numThreads);
+            for (std::size_t i = 0; i < numVertices; ++i) offsets[i + 1] += offsets[i];
+
+            oneRings.resize(offsets.back());
+            parallel::ForChunks(numVertices, ADJACENCY_CHUNK_SIZE, [&offsets, &oneRings, &threadRings, &collectOneRing](uint64_t begin, uint64_t end, unsigned int threadIdx)
+            {
+                for (auto v = begin; v < end; ++v) {
+                    collectOneRing(v, threadRings[threadIdx]);
+                    std::copy(threadRings[threadIdx].begin(), threadRings[threadIdx].end(), oneRings.begin() + offsets[v]);
+                }
+            }, numThreads);
+        }
+
+        /**
+         *  Expands the k-rings around a set of seed vertices in breadth first order. Ring 0 holds the seeds, ring i
+         *  the vertices in the one-ring of ring i - 1 not contained in any previous ring. Each ring is sorted
+         *  ascending. The buffer only allocates if it is too small for the result.
+         *  @param oneRingOffsets the offsets of each vertices one-ring.
+         *  @param oneRings the one-rings of all vertices.
+         *  @param seeds the seed vertices.
+         *  @param numSeeds the number of seed vertices.
+         *  @param k the number of rings to expand.
+         *  @param rings the buffer to write the rings to.
+         */
+        void ExpandRings(const std::vector<unsigned int>& oneRingOffsets, const std::vector<unsigned int>& oneRings,
+            const unsigned int* seeds, std::size_t numSeeds, unsigned int k, MeshConnectRingBuffer& rings)
+        {
+            auto numVertices = oneRingOffsets.size() - 1;
+            rings.vertices_.clear();
+            rings.ringOffsets_.clear();
+            if (rings.visited_.size() != numVertices) {
+                rings.visited_.assign(numVertices, 0);
+                rings.visitStamp_ = 0;
+            }
+            if (++rings.visitStamp_ == 0) {
+                std::fill(rings.visited_.begin(), rings.visited_.end(), 0);
+                rings.visitStamp_ = 1;
+            }
+
+            auto stamp = rings.visitStamp_;
+            auto addVertex = [&rings, stamp](unsigned int vtxId)
+            {
+                if (rings.visited_[vtxId] == stamp) return;
+                rings.visited_[vtxId] = stamp;
+                rings.vertices_.push_back(vtxId);
+            };
+
+            rings.ringOffsets_.push_back(0);
+            for (std::size_t i = 0; i < numSeeds; ++i) addVertex(seeds[i]);
+            std::sort(rings.vertices_.begin(), rings.vertices_.end());
+            for (auto ring = 1U; ring <= k; ++ring) {
+                auto ringBegin = rings.ringOffsets_.back();
+                auto ringEnd = static_cast<unsigned int>(rings.vertices_.size());
+                rings.ringOffsets_.push_back(ringEnd);
+                for (auto i = ringBegin; i < ringEnd; ++i) {
+                    auto vtxId = rings.vertices_[i];
+                    for (auto j = oneRingOffsets[vtxId]; j < oneRingOffsets[vtxId + 1]; ++j) addVertex(oneRings[j]);
+                }
+                std::sort(rings.vertices_.begin() + ringEnd, rings.vertices_.end());
+            }
+            rings.ringOffsets_.push_back(static_cast<unsigned int>(rings.vertices_.size()));
+        }
+    }
+}
@@ -0,0 +1,36 @@
+/**
+ * @file   MeshAdjacency.h
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Contains functions to create the adjacency information of connectivity meshes.
+ */
+
+#ifndef MESHADJACENCY_H
+#define MESHADJACENCY_H
+
+#include "main.h"
+#include "ConnectivityMesh.h"
+
+namespace cgu {
+
+    /**
+     *  The adjacencies are stored in compressed sparse row form: the entries of row i are
+     *  [entries[offsets[i]], entries[offsets[i + 1]]). They only depend on the triangles, not on the mesh they
+     *  were created from, and are built on multiple threads with results independent of the number of threads.
+     */
+    namespace meshAdjacency {
+
+        void CreateVertexTriangles(const std::vector<MeshConnectTriangle>& triangles, std::size_t numVertices,
+            std::vector<unsigned int>& offsets, std::vector<unsigned int>& vertexTriangles, unsigned int numThreads = 0);
+        void CreateEdges(std::vector<MeshConnectTriangle>& triangles, std::size_t numVertices, std::vector<MeshConnectEdge>& edges,
+            std::vector<unsigned int>& edgeHalfEdges, std::vector<std::array<unsigned int, 3>>& triangleEdges, unsigned int numThreads = 0);
+        void CreateOneRings(const std::vector<MeshConnectTriangle>& triangles, const std::vector<unsigned int>& vertexTriangleOffsets,
+            const std::vector<unsigned int>& vertexTriangles, std::vector<unsigned int>& offsets, std::vector<unsigned int>& oneRings,
+            unsigned int numThreads = 0);
+        void ExpandRings(const std::vector<unsigned int>& oneRingOffsets, const std::vector<unsigned int>& oneRings,
+            const unsigned int* seeds, std::size_t numSeeds, unsigned int k, MeshConnectRingBuffer& rings);
+    }
+}
+
+#endif // MESHADJACENCY_H
@@ -51,6 +51,19 @@ namespace cgu {
         }
     }
 
+    /** Constructor for a single node without children that contains all meshes (e.g. for generated meshes). */
+    SceneMeshNode::SceneMeshNode(const std::string& nodeName, const std::vector<std::unique_ptr<SubMesh>>& meshes) :
+        nodeName_(nodeName),
+        parent_(nullptr)
+    {
+        aabb_.minmax[0] = glm::vec3(std::numeric_limits<float>::infinity()); aabb_.minmax[1] = glm::vec3(-std::numeric_limits<float>::infinity());
+        for (const auto& mesh : meshes) {
+            meshes_.push_back(mesh.get());
+            aabb_.minmax[0] = glm::min(aabb_.minmax[0], mesh->GetLocalAABB().minmax[0]);
+            aabb_.minmax[1] = glm::max(aabb_.minmax[1], mesh->GetLocalAABB().minmax[1]);
+        }
+    }
+
     SceneMeshNode::SceneMeshNode(const SceneMeshNode& rhs) :
         nodeName_(rhs.nodeName_),
         meshes_(rhs.meshes_),
@@ -24,6 +24,7 @@ namespace cgu {
     public:
         SceneMeshNode() : nodeName_(""), parent_(nullptr) { aabb_.minmax[0] = glm::vec3(std::numeric_limits<float>::infinity()); aabb_.minmax[1] = glm::vec3(-std::numeric_limits<float>::infinity()); }
         SceneMeshNode(aiNode* node, const SceneMeshNode* parent, const std::vector<std::unique_ptr<SubMesh>>& meshes);
+        SceneMeshNode(const std::string& nodeName, const std::vector<std::unique_ptr<SubMesh>>& meshes);
         SceneMeshNode(const SceneMeshNode& rhs);
         SceneMeshNode& operator=(const SceneMeshNode& rhs);
         SceneMeshNode(SceneMeshNode&& rhs);
@@ -0,0 +1,1044 @@
+/**
+ * @file   TriangleBVH.cpp
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Implementation of the bounding volume hierarchy for ray queries on triangles.
+ */
+
+#include "TriangleBVH.h"
+#include "core/parallel_helper.h"
+#include <algorithm>
+#include <emmintrin.h>
+
+namespace cgu {
+
+    /** Flags a reference to a leaf. */
+    static const uint32_t LEAF_FLAG = 0x80000000;
+    /** Flags a reference to a subtree that is not built yet. */
+    static const uint32_t TASK_FLAG = 0x40000000;
+    /** Marks an unused child. */
+    static const uint32_t EMPTY_REF = 0xFFFFFFFF;
+    /** The number of bins used for evaluating the surface area heuristic. */
+    static const unsigned int NUM_BINS = 16;
+    /** The maximum number of triangles in a leaf. */
+    static const unsigned int MAX_LEAF_SIZE = 4;
+    /** The depth from which on nodes are split at the object median to bound the depth of the tree. */
+    static const unsigned int MAX_SAH_DEPTH = 48;
+    /** The minimum number of triangles for binning on multiple threads. */
+    static const uint32_t PARALLEL_BINNING_SIZE = 1 << 16;
+    /** The number of triangles binned by a single thread at once. */
+    static const uint32_t BINNING_CHUNK_SIZE = 1 << 14;
+    /** The minimum number of triangles in a subtree built as a single task. */
+    static const uint32_t MIN_TASK_SIZE = 4096;
+    /**
+     *  The size of the traversal stacks. Each node pushes at most four children after popping itself, so a tree of
+     *  depth d needs 3d + 1 entries. SAH splits are limited to MAX_SAH_DEPTH and median splits halve the ranges, so
+     *  the depth stays below 80 even for 2^32 triangles.
+     */
+    static const unsigned int STACK_SIZE = 256;
+    /** Enlarges the far distance of box tests so rounding errors do not cull boxes containing hits. */
+    static const float BOX_FAR_SCALE = 1.0000004f;
+    /** Reduces the distances to boxes so rounding errors do not cull boxes containing the closest point. */
+    static const float BOX_DISTANCE_SCALE = 0.99999f;
+
+    /** Returns an empty bounding box. */
+    static cguMath::AABB3<float> emptyBox()
+    {
+        cguMath::AABB3<float> box;
+        box.minmax[0] = glm::vec3(std::numeric_limits<float>::infinity());
+        box.minmax[1] = glm::vec3(-std::numeric_limits<float>::infinity());
+        return box;
+    }
+
+    /** Extends a bounding box by another one. */
+    static void extendBox(cguMath::AABB3<float>& box, const glm::vec3& boxMin, const glm::vec3& boxMax)
+    {
+        box.minmax[0] = glm::min(box.minmax[0], boxMin);
+        box.minmax[1] = glm::max(box.minmax[1], boxMax);
+    }
+
+    /** Returns whether a ray can hit anything (rays with NaN or infinite origins or directions or NaN distances cannot). */
+    static bool isValidRay(const BVHRay& ray)
+    {
+        for (auto a = 0; a < 3; ++a) if (!std::isfinite(ray.origin[a]) || !std::isfinite(ray.direction[a])) return false;
+        return !std::isnan(ray.tMin) && !std::isnan(ray.tMax);
+    }
+
+    /** Returns whether closest points to a point can be found (NaN or infinite points and NaN distances cannot). */
+    static bool isValidQuery(const glm::vec3& point, float maxDistance)
+    {
+        return std::isfinite(point.x) && std::isfinite(point.y) && std::isfinite(point.z) && !std::isnan(maxDistance);
+    }
+
+    /** Returns half of the surface area of a bounding box (0 for empty boxes). */
+    static float halfArea(const cguMath::AABB3<float>& box)
+    {
+        auto extent = glm::max(box.minmax[1] - box.minmax[0], glm::vec3(0.0f));
+        return extent.x * extent.y + extent.y * extent.z + extent.z * extent.x;
+    }
+
+    /** The bounding box of a triangle used during building. */
+    struct TriangleBVH::PrimRef
+    {
+        /** Holds the minimum of the bounding box. */
+        glm::vec3 boxMin;
+        /** Holds the index of the triangle. */
+        uint32_t triangle;
+        /** Holds the maximum of the bounding box. */
+        glm::vec3 boxMax;
+
+        /** Returns the center of the bounding box. */
+        glm::vec3 GetCentroid() const { return (boxMin + boxMax) * 0.5f; }
+    };
+
+    /** A range of triangles during building. */
+    struct TriangleBVH::BuildRange
+    {
+        /** Holds the first triangle of the range. */
+        uint32_t begin;
+        /** Holds the end of the range. */
+        uint32_t end;
+        /** Holds the number of splits above the range. */
+        unsigned int depth;
+        /** Holds the bounding box of the triangles. */
+        cguMath::AABB3<float> bounds;
+        /** Holds the bounding box of the triangle centroids. */
+        cguMath::AABB3<float> centroidBounds;
+
+        /** Returns the number of triangles. */
+        uint32_t GetCount() const { return end - begin; }
+    };
+
+    /** The nodes and leaves of a subtree with references relative to the subtree. */
+    struct TriangleBVH::Subtree
+    {
+        /** Holds the inner nodes. */
+        std::vector<Node> nodes;
+        /** Holds the leaves. */
+        std::vector<Leaf> leaves;
+    };
+
+    /** A ray prepared for SIMD tests. */
+    struct TriangleBVH::RayData
+    {
+        /** Holds the ray. */
+        BVHRay ray;
+        /** Holds the origin in all lanes. */
+        __m128 origin[3];
+        /** Holds the direction in all lanes. */
+        __m128 direction[3];
+        /** Holds the inverse direction in all lanes. */
+        __m128 invDirection[3];
+        /** Holds the minimum distance in all lanes. */
+        __m128 tMin;
+        /** Holds for each axis whether the direction is negative. */
+        bool negative[3];
+    };
+
+    /** A bin of the surface area heuristic. */
+    struct SAHBin
+    {
+        SAHBin() : bounds(emptyBox()), centroidBounds(emptyBox()), count(0) {}
+
+        /** Adds the bin to another one. */
+        void Merge(const SAHBin& rhs)
+        {
+            extendBox(bounds, rhs.bounds.minmax[0], rhs.bounds.minmax[1]);
+            extendBox(centroidBounds, rhs.centroidBounds.minmax[0], rhs.centroidBounds.minmax[1]);
+            count += rhs.count;
+        }
+
+        /** Holds the bounding box of the triangles. */
+        cguMath::AABB3<float> bounds;
+        /** Holds the bounding box of the triangle centroids. */
+        cguMath::AABB3<float> centroidBounds;
+        /** Holds the number of triangles. */
+        uint32_t count;
+    };
+
+    /**
+     *  Constructor.
+     *  @param numTriangles the number of triangles.
+     *  @param getTriangle the function returning the vertices of a triangle.
+     *  @param numThreads the number of threads to use for building (0 to use all hardware threads).
+     */
+    TriangleBVH::TriangleBVH(unsigned int numTriangles, const TriangleFunction& getTriangle, unsigned int numThreads) :
+        numTriangles_(numTriangles),
+        bounds_(emptyBox()),
+        root_(EMPTY_REF)
+    {
+        Build(getTriangle, numThreads);
+    }
+
+    /**
+     *  Constructor for indexed triangles.
+     *  @param vertices the vertex positions.
+     *  @param indices three vertex indices per triangle.
+     *  @param numThreads the number of threads to use for building (0 to use all hardware threads).
+     */
+    TriangleBVH::TriangleBVH(const std::vector<glm::vec3>& vertices, const std::vector<unsigned int>& indices, unsigned int numThreads) :
+        numTriangles_(static_cast<unsigned int>(indices.size() / 3)),
+        bounds_(emptyBox()),
+        root_(EMPTY_REF)
+    {
+        Build([&vertices, &indices](unsigned int i) {
+            return cguMath::Tri3<float>{ { vertices[indices[3 * i]], vertices[indices[3 * i + 1]], vertices[indices[3 * i + 2]] } };
+        }, numThreads);
+    }
+
+    /** Default copy constructor. */
+    TriangleBVH::TriangleBVH(const TriangleBVH&) = default;
+    /** Default copy assignment operator. */
+    TriangleBVH& TriangleBVH::operator=(const TriangleBVH&) = default;
+
+    /** Default move constructor. */
+    TriangleBVH::TriangleBVH(TriangleBVH&& rhs) :
+        numTriangles_(rhs.numTriangles_),
+        bounds_(rhs.bounds_),
+        root_(rhs.root_),
+        nodes_(std::move(rhs.nodes_)),
+        leaves_(std::move(rhs.leaves_))
+    {
+        rhs.numTriangles_ = 0;
+        rhs.root_ = EMPTY_REF;
+    }
+
+    /** Default move assignment operator. */
+    TriangleBVH& TriangleBVH::operator=(TriangleBVH&& rhs)
+    {
+        if (this != &rhs) {
+            numTriangles_ = rhs.numTriangles_;
+            bounds_ = rhs.bounds_;
+            root_ = rhs.root_;
+            nodes_ = std::move(rhs.nodes_);
+            leaves_ = std::move(rhs.leaves_);
+            rhs.numTriangles_ = 0;
+            rhs.root_ = EMPTY_REF;
+        }
+        return *this;
+    }
+
+    /** Default destructor. */
+    TriangleBVH::~TriangleBVH() = default;
+
+    /**
+     *  Builds the hierarchy.
+     *  The top levels are built until the ranges are small enough to be handed to the threads as separate tasks.
+     *  @param getTriangle the function returning the vertices of a triangle.
+     *  @param numThreads the number of threads to use.
+     */
+    void TriangleBVH::Build(const TriangleFunction& getTriangle, unsigned int numThreads)
+    {
+        if (numTriangles_ == 0) return;
+        if (numThreads == 0) numThreads = parallel::GetNumThreads();
+
+        std::vector<PrimRef> prims(numTriangles_);
+        auto numChunks = (numTriangles_ + BINNING_CHUNK_SIZE - 1) / BINNING_CHUNK_SIZE;
+        std::vector<SAHBin> chunkBounds(numChunks);
+        parallel::ForChunks(numTriangles_, BINNING_CHUNK_SIZE, [&prims, &chunkBounds, &getTriangle](uint64_t begin, uint64_t end, unsigned int)
+        {
+            auto& chunk = chunkBounds[begin / BINNING_CHUNK_SIZE];
+            for (auto i = begin; i < end; ++i) {
+                auto tri = getTriangle(static_cast<unsigned int>(i));
+                auto& prim = prims[i];
+                prim.boxMin = glm::min(tri[0], glm::min(tri[1], tri[2]));
+                prim.boxMax = glm::max(tri[0], glm::max(tri[1], tri[2]));
+                prim.triangle = static_cast<uint32_t>(i);
+                auto centroid = prim.GetCentroid();
+                extendBox(chunk.bounds, prim.boxMin, prim.boxMax);
+                extendBox(chunk.centroidBounds, centroid, centroid);
+            }
+        }, numThreads);
+
+        SAHBin all;
+        for (const auto& chunk : chunkBounds) all.Merge(chunk);
+        bounds_ = all.bounds;
+
+        BuildRange rootRange{ 0, numTriangles_, 0, all.bounds, all.centroidBounds };
+        auto taskThreshold = glm::max(numTriangles_ / (numThreads * 8), MIN_TASK_SIZE);
+        std::vector<BuildRange> tasks;
+        Subtree top;
+        root_ = BuildNode(prims, rootRange, getTriangle, top, &tasks, taskThreshold, numThreads);
+
+        std::vector<Subtree> subtrees(tasks.size());
+        std::vector<uint32_t> subtreeRoots(tasks.size());
+        parallel::ForChunks(tasks.size(), 1, [&](uint64_t begin, uint64_t end, unsigned int)
+        {
+            for (auto i = begin; i < end; ++i) subtreeRoots[i] = BuildNode(prims, tasks[i], getTriangle, subtrees[i], nullptr, 0, 1);
+        }, numThreads);
+
+        // append the subtrees in task order and resolve the references to them.
+        nodes_ = std::move(top.nodes);
+        leaves_ = std::move(top.leaves);
+        std::vector<uint32_t> taskRefs(tasks.size());
+        for (std::size_t i = 0; i < subtrees.size(); ++i) {
+            auto nodeOffset = static_cast<uint32_t>(nodes_.size());
+            auto leafOffset = static_cast<uint32_t>(leaves_.size());
+            auto relocate = [nodeOffset, leafOffset](uint32_t ref)
+            {
+                if (ref == EMPTY_REF) return ref;
+                if ((ref & LEAF_FLAG) != 0) return LEAF_FLAG | ((ref & ~LEAF_FLAG) + leafOffset);
+                return ref + nodeOffset;
+            };
+            for (auto node : subtrees[i].nodes) {
+                for (auto& child : node.children) child = relocate(child);
+                nodes_.push_back(node);
+            }
+            leaves_.insert(leaves_.end(), subtrees[i].leaves.begin(), subtrees[i].leaves.end());
+            taskRefs[i] = relocate(subtreeRoots[i]);
+            subtrees[i] = Subtree();
+        }
+
+        auto resolve = [&taskRefs](uint32_t& ref) { if (ref != EMPTY_REF && (ref & LEAF_FLAG) == 0 && (ref & TASK_FLAG) != 0) ref = taskRefs[ref & ~TASK_FLAG]; };
+        resolve(root_);
+        for (auto& node : nodes_) for (auto& child : node.children) resolve(child);
+    }
+
+    /**
+     *  Builds a node and its children.
+     *  The range is split repeatedly, always splitting the child with the largest surface area, until there are
+     *  four children or all children are small enough for leaves.
+     *  @param prims the triangle bounding boxes.
+     *  @param range the range of triangles to build the node for.
+     *  @param getTriangle the function returning the vertices of a triangle.
+     *  @param subtree the subtree to add the nodes and leaves to.
+     *  @param tasks the ranges left for building in parallel (nullptr to build the whole subtree).
+     *  @param taskThreshold the number of triangles from which on ranges are left as tasks.
+     *  @param numThreads the number of threads to use for binning.
+     *  @return the reference to the node.
+     */
+    uint32_t TriangleBVH::BuildNode(std::vector<PrimRef>& prims, const BuildRange& range, const TriangleFunction& getTriangle,
+        Subtree& subtree, std::vector<BuildRange>* tasks, uint32_t taskThreshold, unsigned int numThreads)
+    {
+        if (tasks != nullptr && range.GetCount() <= taskThreshold) {
+            tasks->push_back(range);
+            return TASK_FLAG | static_cast<uint32_t>(tasks->size() - 1);
+        }
+        if (range.GetCount() <= MAX_LEAF_SIZE) return BuildLeaf(prims, range, getTriangle, subtree);
+
+        BuildRange children[4];
+        children[0] = range;
+        auto numChildren = 1U;
+        while (numChildren < 4) {
+            auto bestChild = numChildren;
+            auto bestArea = -1.0f;
+            for (auto i = 0U; i < numChildren; ++i) {
+                auto area = halfArea(children[i].bounds);
+                if (children[i].GetCount() > MAX_LEAF_SIZE && area > bestArea) {
+                    bestChild = i;
+                    bestArea = area;
+                }
+            }
+            if (bestChild == numChildren) break;
+
+            BuildRange left, right;
+            SplitRange(prims, children[bestChild], left, right, numThreads);
+            children[bestChild] = left;
+            children[numChildren++] = right;
+        }
+
+        auto nodeIdx = static_cast<uint32_t>(subtree.nodes.size());
+        subtree.nodes.emplace_back();
+        Node node;
+        for (auto i = 0U; i < 4; ++i) {
+            auto childBounds = i < numChildren ? children[i].bounds : emptyBox();
+            node.minX[i] = childBounds.minmax[0].x;
+            node.minY[i] = childBounds.minmax[0].y;
+            node.minZ[i] = childBounds.minmax[0].z;
+            node.maxX[i] = childBounds.minmax[1].x;
+            node.maxY[i] = childBounds.minmax[1].y;
+            node.maxZ[i] = childBounds.minmax[1].z;
+            node.children[i] = i < numChildren ? BuildNode(prims, children[i], getTriangle, subtree, tasks, taskThreshold, numThreads) : EMPTY_REF;
+        }
+        subtree.nodes[nodeIdx] = node;
+        return nodeIdx;
+    }
+
+    /**
+     *  Builds a leaf.
+     *  @param prims the triangle bounding boxes.
+     *  @param range the range of (up to four) triangles.
+     *  @param getTriangle the function returning the vertices of a triangle.
+     *  @param subtree the subtree to add the leaf to.
+     *  @return the reference to the leaf.
+     */
+    uint32_t TriangleBVH::BuildLeaf(const std::vector<PrimRef>& prims, const BuildRange& range, const TriangleFunction& getTriangle, Subtree& subtree)
+    {
+        Leaf leaf;
+        for (auto i = 0U; i < 4; ++i) {
+            cguMath::Tri3<float> tri{ { glm::vec3(0.0f), glm::vec3(0.0f), glm::vec3(0.0f) } };
+            leaf.triangles[i] = NO_HIT;
+            if (range.begin + i < range.end) {
+                leaf.triangles[i] = prims[range.begin + i].triangle;
+                tri = getTriangle(leaf.triangles[i]);
+            }
+            for (auto c = 0; c < 3; ++c) {
+                leaf.v0[c][i] = tri[0][c];
+                leaf.e1[c][i] = tri[1][c] - tri[0][c];
+                leaf.e2[c][i] = tri[2][c] - tri[0][c];
+            }
+        }
+        subtree.leaves.push_back(leaf);
+        return LEAF_FLAG | static_cast<uint32_t>(subtree.leaves.size() - 1);
+    }
+
+    /**
+     *  Splits a range of triangles with the binned surface area heuristic. Below MAX_SAH_DEPTH or if no split
+     *  separates the centroids the range is split at the object median of the largest centroid extent.
+     *  @param prims the triangle bounding boxes, the range gets partitioned.
+     *  @param range the range to split.
+     *  @param left the left part of the range.
+     *  @param right the right part of the range.
+     *  @param numThreads the number of threads to use for binning.
+     */
+    void TriangleBVH::SplitRange(std::vector<PrimRef>& prims, const BuildRange& range, BuildRange& left, BuildRange& right, unsigned int numThreads)
+    {
+        const auto& cmin = range.centroidBounds.minmax[0];
+        auto extent = range.centroidBounds.minmax[1] - cmin;
+        left.depth = right.depth = range.depth + 1;
+
+        glm::vec3 binScale(0.0f);
+        for (auto a = 0; a < 3; ++a) if (extent[a] > 0.0f) binScale[a] = static_cast<float>(NUM_BINS) * 0.9999f / extent[a];
+        auto binIndex = [&cmin, &binScale](const PrimRef& prim, int axis)
+        {
+            auto bin = static_cast<int>((prim.GetCentroid()[axis] - cmin[axis]) * binScale[axis]);
+            return glm::clamp(bin, 0, static_cast<int>(NUM_BINS) - 1);
+        };
+
+        auto bestAxis = -1;
+        auto bestBin = 0;
+        std::array<std::array<SAHBin, NUM_BINS>, 3> bins;
+        if (range.depth < MAX_SAH_DEPTH && binScale != glm::vec3(0.0f)) {
+            auto binRange = [&prims, &binIndex](uint32_t begin, uint32_t end, std::array<std::array<SAHBin, NUM_BINS>, 3>& rangeBins)
+            {
+                for (auto i = begin; i < end; ++i) {
+                    const auto& prim = prims[i];
+                    auto centroid = prim.GetCentroid();
+                    for (auto a = 0; a < 3; ++a) {
+                        auto& bin = rangeBins[a][binIndex(prim, a)];
+                        extendBox(bin.bounds, prim.boxMin, prim.boxMax);
+                        extendBox(bin.centroidBounds, centroid, centroid);
+                        ++bin.count;
+                    }
+                }
+            };
+
+            if (numThreads > 1 && range.GetCount() > PARALLEL_BINNING_SIZE) {
+                // chunk results are merged in order so the bins do not depend on the number of threads.
+                std::vector<std::array<std::array<SAHBin, NUM_BINS>, 3>> chunkBins((range.GetCount() + BINNING_CHUNK_SIZE - 1) / BINNING_CHUNK_SIZE);
+                parallel::ForChunks(range.GetCount(), BINNING_CHUNK_SIZE, [&range, &chunkBins, &binRange](uint64_t begin, uint64_t end, unsigned int)
+                {
+                    binRange(range.begin + static_cast<uint32_t>(begin), range.begin + static_cast<uint32_t>(end), chunkBins[begin / BINNING_CHUNK_SIZE]);
+                }, numThreads);
+                for (const auto& chunk : chunkBins) for (auto a = 0; a < 3; ++a) for (auto b = 0U; b < NUM_BINS; ++b) bins[a][b].Merge(chunk[a][b]);
+            } else binRange(range.begin, range.end, bins);
+
+            auto bestCost = std::numeric_limits<float>::infinity();
+            for (auto a = 0; a < 3; ++a) {
+                if (binScale[a] == 0.0f) continue;
+                std::array<float, NUM_BINS> rightCost;
+                SAHBin accum;
+                for (auto b = NUM_BINS - 1; b > 0; --b) {
+                    accum.Merge(bins[a][b]);
+                    rightCost[b] = halfArea(accum.bounds) * static_cast<float>(accum.count);
+                }
+                accum = SAHBin();
+                for (auto b = 1U; b < NUM_BINS; ++b) {
+                    accum.Merge(bins[a][b - 1]);
+                    if (accum.count == 0 || accum.count == range.GetCount()) continue;
+                    auto cost = halfArea(accum.bounds) * static_cast<float>(accum.count) + rightCost[b];
+                    if (cost < bestCost) {
+                        bestCost = cost;
+                        bestAxis = a;
+                        bestBin = static_cast<int>(b);
+                    }
+                }
+            }
+        }
+
+        if (bestAxis >= 0) {
+            auto mid = std::partition(prims.begin() + range.begin, prims.begin() + range.end,
+                [bestAxis, bestBin, &binIndex](const PrimRef& prim) { return binIndex(prim, bestAxis) < bestBin; });
+            SAHBin leftBins, rightBins;
+            for (auto b = 0; b < static_cast<int>(NUM_BINS); ++b) (b < bestBin ? leftBins : rightBins).Merge(bins[bestAxis][b]);
+            left.begin = range.begin;
+            left.end = right.begin = static_cast<uint32_t>(mid - prims.begin());
+            right.end = range.end;
+            left.bounds = leftBins.bounds;
+            left.centroidBounds = leftBins.centroidBounds;
+            right.bounds = rightBins.bounds;
+            right.centroidBounds = rightBins.centroidBounds;
+            return;
+        }
+
+        auto axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : (extent.y >= extent.z ? 1 : 2);
+        left.begin = range.begin;
+        left.end = right.begin = range.begin + range.GetCount() / 2;
+        right.end = range.end;
+        std::nth_element(prims.begin() + range.begin, prims.begin() + left.end, prims.begin() + range.end, [axis](const PrimRef& p0, const PrimRef& p1)
+        {
+            auto c0 = p0.boxMin[axis] + p0.boxMax[axis];
+            auto c1 = p1.boxMin[axis] + p1.boxMax[axis];
+            return c0 < c1 || (c0 == c1 && p0.triangle < p1.triangle);
+        });
+        for (auto part : { &left, &right }) {
+            SAHBin partBounds;
+            for (auto i = part->begin; i < part->end; ++i) {
+                auto centroid = prims[i].GetCentroid();
+                extendBox(partBounds.bounds, prims[i].boxMin, prims[i].boxMax);
+                extendBox(partBounds.centroidBounds, centroid, centroid);
+            }
+            part->bounds = partBounds.bounds;
+            part->centroidBounds = partBounds.centroidBounds;
+        }
+    }
+
+    /**
+     *  Prepares a ray for the SIMD tests.
+     *  @param ray the ray.
+     *  @return the prepared ray.
+     */
+    TriangleBVH::RayData TriangleBVH::PrepareRay(const BVHRay& ray)
+    {
+        RayData result;
+        result.ray = ray;
+        for (auto a = 0; a < 3; ++a) {
+            // zero components give infinite inverse directions, the box tests ignore the resulting NaNs.
+            auto invDirection = 1.0f / ray.direction[a];
+            result.origin[a] = _mm_set1_ps(ray.origin[a]);
+            result.direction[a] = _mm_set1_ps(ray.direction[a]);
+            result.invDirection[a] = _mm_set1_ps(invDirection);
+            result.negative[a] = invDirection < 0.0f;
+        }
+        result.tMin = _mm_set1_ps(ray.tMin);
+        return result;
+    }
+
+    /**
+     *  Intersects a ray with the bounding boxes of the children of a node.
+     *  @param node the node.
+     *  @param ray the ray.
+     *  @param tMax the maximum distance.
+     *  @param tNear the entry distances of the children.
+     *  @return the mask of children hit.
+     */
+    int TriangleBVH::IntersectNode(const Node& node, const RayData& ray, float tMax, float* tNear)
+    {
+        const float* planes[3][2] = { { node.minX, node.maxX }, { node.minY, node.maxY }, { node.minZ, node.maxZ } };
+        auto t0 = ray.tMin;
+        auto t1 = _mm_set1_ps(tMax);
+        for (auto a = 0; a < 3; ++a) {
+            auto nearPlane = _mm_loadu_ps(planes[a][ray.negative[a] ? 1 : 0]);
+            auto farPlane = _mm_loadu_ps(planes[a][ray.negative[a] ? 0 : 1]);
+            // a NaN (ray parallel to and on a plane) in the first operand returns the second one.
+            t0 = _mm_max_ps(_mm_mul_ps(_mm_sub_ps(nearPlane, ray.origin[a]), ray.invDirection[a]), t0);
+            t1 = _mm_min_ps(_mm_mul_ps(_mm_sub_ps(farPlane, ray.origin[a]), ray.invDirection[a]), t1);
+        }
+        t1 = _mm_mul_ps(t1, _mm_set1_ps(BOX_FAR_SCALE));
+        _mm_storeu_ps(tNear, t0);
+        return _mm_movemask_ps(_mm_cmple_ps(t0, t1));
+    }
+
+    /**
+     *  Intersects a ray with the triangles of a leaf (Moeller-Trumbore).
+     *  @param leaf the leaf.
+     *  @param ray the ray.
+     *  @param tMax the maximum distance (inclusive).
+     *  @param t the distances of the hits.
+     *  @param u the barycentric coordinates of the second vertices.
+     *  @param v the barycentric coordinates of the third vertices.
+     *  @return the mask of triangles hit.
+     */
+    int TriangleBVH::IntersectLeaf(const Leaf& leaf, const RayData& ray, float tMax, float* t, float* u, float* v)
+    {
+        __m128 e1[3], e2[3], s[3];
+        for (auto a = 0; a < 3; ++a) {
+            e1[a] = _mm_loadu_ps(leaf.e1[a]);
+            e2[a] = _mm_loadu_ps(leaf.e2[a]);
+            s[a] = _mm_sub_ps(ray.origin[a], _mm_loadu_ps(leaf.v0[a]));
+        }
+        const auto* d = ray.direction;
+        auto px = _mm_sub_ps(_mm_mul_ps(d[1], e2[2]), _mm_mul_ps(d[2], e2[1]));
+        auto py = _mm_sub_ps(_mm_mul_ps(d[2], e2[0]), _mm_mul_ps(d[0], e2[2]));
+        auto pz = _mm_sub_ps(_mm_mul_ps(d[0], e2[1]), _mm_mul_ps(d[1], e2[0]));
+        auto det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1[0], px), _mm_mul_ps(e1[1], py)), _mm_mul_ps(e1[2], pz));
+        auto invDet = _mm_div_ps(_mm_set1_ps(1.0f), det);
+        auto uu = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(s[0], px), _mm_mul_ps(s[1], py)), _mm_mul_ps(s[2], pz)), invDet);
+
+        auto qx = _mm_sub_ps(_mm_mul_ps(s[1], e1[2]), _mm_mul_ps(s[2], e1[1]));
+        auto qy = _mm_sub_ps(_mm_mul_ps(s[2], e1[0]), _mm_mul_ps(s[0], e1[2]));
+        auto qz = _mm_sub_ps(_mm_mul_ps(s[0], e1[1]), _mm_mul_ps(s[1], e1[0]));
+        auto vv = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(d[0], qx), _mm_mul_ps(d[1], qy)), _mm_mul_ps(d[2], qz)), invDet);
+        auto tt = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e2[0], qx), _mm_mul_ps(e2[1], qy)), _mm_mul_ps(e2[2], qz)), invDet);
+
+        auto zero = _mm_setzero_ps();
+        auto valid = _mm_cmpneq_ps(det, zero);
+        valid = _mm_and_ps(valid, _mm_cmpge_ps(uu, zero));
+        valid = _mm_and_ps(valid, _mm_cmpge_ps(vv, zero));
+        valid = _mm_and_ps(valid, _mm_cmple_ps(_mm_add_ps(uu, vv), _mm_set1_ps(1.0f)));
+        valid = _mm_and_ps(valid, _mm_cmpgt_ps(tt, ray.tMin));
+        valid = _mm_and_ps(valid, _mm_cmple_ps(tt, _mm_set1_ps(tMax)));
+        _mm_storeu_ps(t, tt);
+        _mm_storeu_ps(u, uu);
+        _mm_storeu_ps(v, vv);
+        return _mm_movemask_ps(valid);
+    }
+
+    /**
+     *  Updates the closest hit with the triangles hit in a leaf, hits at the same distance are resolved to the
+     *  lower triangle index.
+     *  @param leaf the leaf.
+     *  @param mask the mask of triangles hit.
+     *  @param t the distances of the hits.
+     *  @param u the barycentric coordinates of the second vertices.
+     *  @param v the barycentric coordinates of the third vertices.
+     *  @param tMax the maximum distance of the ray (exclusive).
+     *  @param hit the closest hit.
+     */
+    void TriangleBVH::UpdateHit(const Leaf& leaf, int mask, const float* t, const float* u, const float* v, float tMax, BVHHit& hit)
+    {
+        for (auto i = 0; i < 4; ++i) {
+            if ((mask & (1 << i)) == 0 || t[i] >= tMax) continue;
+            if (t[i] < hit.t || (t[i] == hit.t && leaf.triangles[i] < hit.triangle)) {
+                hit.triangle = leaf.triangles[i];
+                hit.t = t[i];
+                hit.u = u[i];
+                hit.v = v[i];
+            }
+        }
+    }
+
+    /**
+     *  Checks if any triangle of a leaf is hit before the maximum distance.
+     *  @param mask the mask of triangles hit.
+     *  @param t the distances of the hits.
+     *  @param tMax the maximum distance of the ray (exclusive).
+     *  @return whether there is a hit.
+     */
+    bool TriangleBVH::IsAnyHit(int mask, const float* t, float tMax)
+    {
+        for (auto i = 0; i < 4; ++i) if ((mask & (1 << i)) != 0 && t[i] < tMax) return true;
+        return false;
+    }
+
+    /**
+     *  Calculates the squared distances of a point to the bounding boxes of the children of a node.
+     *  @param node the node.
+     *  @param point the point.
+     *  @param maxDistance2 the maximum squared distance.
+     *  @param distance2 the (slightly underestimated) squared distances, infinite for unused children.
+     *  @return the mask of children within the maximum distance (may include unused children).
+     */
+    int TriangleBVH::DistanceToNode(const Node& node, const glm::vec3& point, float maxDistance2, float* distance2)
+    {
+        const float* planes[3][2] = { { node.minX, node.maxX }, { node.minY, node.maxY }, { node.minZ, node.maxZ } };
+        auto zero = _mm_setzero_ps();
+        auto result = zero;
+        for (auto a = 0; a < 3; ++a) {
+            auto p = _mm_set1_ps(point[a]);
+            auto d = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(planes[a][0]), p), _mm_sub_ps(p, _mm_loadu_ps(planes[a][1]))), zero);
+            result = _mm_add_ps(result, _mm_mul_ps(d, d));
+        }
+        result = _mm_mul_ps(result, _mm_set1_ps(BOX_DISTANCE_SCALE));
+        _mm_storeu_ps(distance2, result);
+        return _mm_movemask_ps(_mm_cmple_ps(result, _mm_set1_ps(maxDistance2)));
+    }
+
+    /**
+     *  Updates the closest point with the triangles of a leaf, points at the same distance are resolved to the
+     *  lower triangle index.
+     *  The closest point on each triangle is found by checking the Voronoi regions of its vertices and edges.
+     *  @param leaf the leaf.
+     *  @param point the query point.
+     *  @param result the closest point.
+     *  @param bestDistance2 the squared distance of the closest point.
+     */
+    void TriangleBVH::UpdateClosestPoint(const Leaf& leaf, const glm::vec3& point, BVHClosestPoint& result, float& bestDistance2)
+    {
+        for (auto i = 0; i < 4; ++i) {
+            if (leaf.triangles[i] == NO_HIT) continue;
+            glm::vec3 a(leaf.v0[0][i], leaf.v0[1][i], leaf.v0[2][i]);
+            glm::vec3 ab(leaf.e1[0][i], leaf.e1[1][i], leaf.e1[2][i]);
+            glm::vec3 ac(leaf.e2[0][i], leaf.e2[1][i], leaf.e2[2][i]);
+
+            auto ap = point - a;
+            auto d1 = glm::dot(ab, ap);
+            auto d2 = glm::dot(ac, ap);
+            auto bp = ap - ab;
+            auto d3 = glm::dot(ab, bp);
+            auto d4 = glm::dot(ac, bp);
+            auto cp = ap - ac;
+            auto d5 = glm::dot(ab, cp);
+            auto d6 = glm::dot(ac, cp);
+            auto vc = d1 * d4 - d3 * d2;
+            auto vb = d5 * d2 - d1 * d6;
+            auto va = d3 * d6 - d5 * d4;
+
+            glm::vec2 uv;
+            if (d1 <= 0.0f && d2 <= 0.0f) uv = glm::vec2(0.0f, 0.0f);
+            else if (d3 >= 0.0f && d4 <= d3) uv = glm::vec2(1.0f, 0.0f);
+            else if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) uv = glm::vec2(d1 / (d1 - d3), 0.0f);
+            else if (d6 >= 0.0f && d5 <= d6) uv = glm::vec2(0.0f, 1.0f);
+            else if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) uv = glm::vec2(0.0f, d2 / (d2 - d6));
+            else if (va <= 0.0f && d4 - d3 >= 0.0f && d5 - d6 >= 0.0f) {
+                auto w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+                uv = glm::vec2(1.0f - w, w);
+            } else if (va + vb + vc != 0.0f) uv = glm::vec2(vb, vc) / (va + vb + vc);
+            else continue;
+
+            auto closest = a + ab * uv.x + ac * uv.y;
+            auto diff = point - closest;
+            auto distance2 = glm::dot(diff, diff);
+            if (distance2 < bestDistance2 || (distance2 == bestDistance2 && leaf.triangles[i] < result.triangle)) {
+                bestDistance2 = distance2;
+                result.triangle = leaf.triangles[i];
+                result.u = uv.x;
+                result.v = uv.y;
+                result.point = closest;
+            }
+        }
+    }
+
+    /**
+     *  Finds the closest triangle hit by a ray.
+     *  @param ray the ray.
+     *  @param hit the closest hit.
+     *  @return whether a triangle was hit.
+     */
+    bool TriangleBVH::Intersect(const BVHRay& ray, BVHHit& hit) const
+    {
+        hit = BVHHit{ NO_HIT, ray.tMax, 0.0f, 0.0f };
+        if (root_ == EMPTY_REF || !isValidRay(ray)) return false;
+
+        auto rayData = PrepareRay(ray);
+        std::pair<uint32_t, float> stack[STACK_SIZE];
+        auto stackSize = 0U;
+        stack[stackSize++] = std::make_pair(root_, ray.tMin);
+        float t[4], u[4], v[4];
+        while (stackSize > 0) {
+            auto entry = stack[--stackSize];
+            if (entry.second > hit.t) continue;
+
+            if ((entry.first & LEAF_FLAG) != 0) {
+                const auto& leaf = leaves_[entry.first & ~LEAF_FLAG];
+                auto mask = IntersectLeaf(leaf, rayData, hit.t, t, u, v);
+                if (mask != 0) UpdateHit(leaf, mask, t, u, v, ray.tMax, hit);
+                continue;
+            }
+
+            float tNear[4];
+            auto mask = IntersectNode(nodes_[entry.first], rayData, hit.t, tNear);
+            assert(stackSize + 4 <= STACK_SIZE);
+            // push the children far to near, so the nearest one is traversed first.
+            auto firstChild = stackSize;
+            for (auto i = 0; i < 4; ++i) {
+                if ((mask & (1 << i)) == 0) continue;
+                auto child = std::make_pair(nodes_[entry.first].children[i], tNear[i]);
+                auto pos = stackSize++;
+                for (; pos > firstChild && stack[pos - 1].second < child.second; --pos) stack[pos] = stack[pos - 1];
+                stack[pos] = child;
+            }
+        }
+        return hit.triangle != NO_HIT;
+    }
+
+    /**
+     *  Checks if a ray hits any triangle.
+     *  @param ray the ray.
+     *  @return whether a triangle was hit.
+     */
+    bool TriangleBVH::Occluded(const BVHRay& ray) const
+    {
+        if (root_ == EMPTY_REF || !isValidRay(ray)) return false;
+
+        auto rayData = PrepareRay(ray);
+        uint32_t stack[STACK_SIZE];
+        auto stackSize = 0U;
+        stack[stackSize++] = root_;
+        float t[4], u[4], v[4], tNear[4];
+        while (stackSize > 0) {
+            auto ref = stack[--stackSize];
+            if ((ref & LEAF_FLAG) != 0) {
+                auto mask = IntersectLeaf(leaves_[ref & ~LEAF_FLAG], rayData, ray.tMax, t, u, v);
+                if (IsAnyHit(mask, t, ray.tMax)) return true;
+                continue;
+            }
+
+            auto mask = IntersectNode(nodes_[ref], rayData, ray.tMax, tNear);
+            assert(stackSize + 4 <= STACK_SIZE);
+            for (auto i = 0; i < 4; ++i) if ((mask & (1 << i)) != 0) stack[stackSize++] = nodes_[ref].children[i];
+        }
+        return false;
+    }
+
+    /**
+     *  Finds the closest triangles hit by a packet of rays. The rays share the traversal, each node is only
+     *  tested for the rays that hit its parent.
+     *  @param rays the rays.
+     *  @param hits the closest hits.
+     *  @param numRays the number of rays (at most MAX_PACKET_SIZE).
+     */
+    void TriangleBVH::IntersectPacket(const BVHRay* rays, BVHHit* hits, unsigned int numRays) const
+    {
+        assert(numRays <= MAX_PACKET_SIZE);
+        RayData rayData[MAX_PACKET_SIZE];
+        auto validRays = 0U;
+        for (auto r = 0U; r < numRays; ++r) {
+            hits[r] = BVHHit{ NO_HIT, rays[r].tMax, 0.0f, 0.0f };
+            rayData[r] = PrepareRay(rays[r]);
+            if (isValidRay(rays[r])) validRays |= 1U << r;
+        }
+        if (root_ == EMPTY_REF || validRays == 0) return;
+
+        std::pair<uint32_t, uint32_t> stack[STACK_SIZE];
+        auto stackSize = 0U;
+        stack[stackSize++] = std::make_pair(root_, validRays);
+        float t[4], u[4], v[4];
+        while (stackSize > 0) {
+            auto entry = stack[--stackSize];
+            if ((entry.first & LEAF_FLAG) != 0) {
+                const auto& leaf = leaves_[entry.first & ~LEAF_FLAG];
+                for (auto r = 0U; r < numRays; ++r) {
+                    if ((entry.second & (1U << r)) == 0) continue;
+                    auto mask = IntersectLeaf(leaf, rayData[r], hits[r].t, t, u, v);
+                    if (mask != 0) UpdateHit(leaf, mask, t, u, v, rays[r].tMax, hits[r]);
+                }
+                continue;
+            }
+
+            const auto& node = nodes_[entry.first];
+            uint32_t childRays[4] = { 0, 0, 0, 0 };
+            float childNear[4];
+            for (auto i = 0; i < 4; ++i) childNear[i] = std::numeric_limits<float>::infinity();
+            float tNear[4];
+            for (auto r = 0U; r < numRays; ++r) {
+                if ((entry.second & (1U << r)) == 0) continue;
+                auto mask = IntersectNode(node, rayData[r], hits[r].t, tNear);
+                for (auto i = 0; i < 4; ++i) {
+                    if ((mask & (1 << i)) == 0) continue;
+                    childRays[i] |= 1U << r;
+                    childNear[i] = glm::min(childNear[i], tNear[i]);
+                }
+            }
+
+            assert(stackSize + 4 <= STACK_SIZE);
+            // push the children far to near (by the nearest entry of any ray).
+            int order[4];
+            auto numChildren = 0;
+            for (auto i = 0; i < 4; ++i) {
+                if (childRays[i] == 0) continue;
+                auto pos = numChildren++;
+                for (; pos > 0 && childNear[order[pos - 1]] < childNear[i]; --pos) order[pos] = order[pos - 1];
+                order[pos] = i;
+            }
+            for (auto i = 0; i < numChildren; ++i) stack[stackSize++] = std::make_pair(node.children[order[i]], childRays[order[i]]);
+        }
+    }
+
+    /**
+     *  Checks if the rays of a packet hit any triangle.
+     *  @param rays the rays.
+     *  @param occluded set to 1 for each ray hitting a triangle, 0 otherwise.
+     *  @param numRays the number of rays (at most MAX_PACKET_SIZE).
+     */
+    void TriangleBVH::OccludedPacket(const BVHRay* rays, uint8_t* occluded, unsigned int numRays) const
+    {
+        assert(numRays <= MAX_PACKET_SIZE);
+        RayData rayData[MAX_PACKET_SIZE];
+        auto activeRays = 0U;
+        for (auto r = 0U; r < numRays; ++r) {
+            occluded[r] = 0;
+            rayData[r] = PrepareRay(rays[r]);
+            if (isValidRay(rays[r])) activeRays |= 1U << r;
+        }
+        if (root_ == EMPTY_REF || activeRays == 0) return;
+
+        std::pair<uint32_t, uint32_t> stack[STACK_SIZE];
+        auto stackSize = 0U;
+        stack[stackSize++] = std::make_pair(root_, activeRays);
+        float t[4], u[4], v[4], tNear[4];
+        while (stackSize > 0 && activeRays != 0) {
+            auto entry = stack[--stackSize];
+            entry.second &= activeRays;
+            if (entry.second == 0) continue;
+
+            if ((entry.first & LEAF_FLAG) != 0) {
+                const auto& leaf = leaves_[entry.first & ~LEAF_FLAG];
+                for (auto r = 0U; r < numRays; ++r) {
+                    if ((entry.second & (1U << r)) == 0) continue;
+                    auto mask = IntersectLeaf(leaf, rayData[r], rays[r].tMax, t, u, v);
+                    if (IsAnyHit(mask, t, rays[r].tMax)) {
+                        occluded[r] = 1;
+                        activeRays &= ~(1U << r);
+                    }
+                }
+                continue;
+            }
+
+            const auto& node = nodes_[entry.first];
+            uint32_t childRays[4] = { 0, 0, 0, 0 };
+            for (auto r = 0U; r < numRays; ++r) {
+                if ((entry.second & (1U << r)) == 0) continue;
+                auto mask = IntersectNode(node, rayData[r], rays[r].tMax, tNear);
+                for (auto i = 0; i < 4; ++i) if ((mask & (1 << i)) != 0) childRays[i] |= 1U << r;
+            }
+            assert(stackSize + 4 <= STACK_SIZE);
+            for (auto i = 0; i < 4; ++i) if (childRays[i] != 0) stack[stackSize++] = std::make_pair(node.children[i], childRays[i]);
+        }
+    }
+
+    /**
+     *  Finds the closest triangles hit by a number of rays on multiple threads. Consecutive rays are traced as
+     *  packets, so rays should be ordered coherently (e.g. by pixel tiles).
+     *  @param rays the rays.
+     *  @param hits the closest hits.
+     *  @param numThreads the number of threads to use (0 to use all hardware threads).
+     */
+    void TriangleBVH::IntersectRays(const std::vector<BVHRay>& rays, std::vector<BVHHit>& hits, unsigned int numThreads) const
+    {
+        hits.resize(rays.size());
+        parallel::ForChunks(rays.size(), 1024, [this, &rays, &hits](uint64_t begin, uint64_t end, unsigned int)
+        {
+            for (auto i = begin; i < end; i += MAX_PACKET_SIZE) {
+                auto numRays = static_cast<unsigned int>(std::min<uint64_t>(MAX_PACKET_SIZE, end - i));
+                IntersectPacket(&rays[i], &hits[i], numRays);
+            }
+        }, numThreads);
+    }
+
+    /**
+     *  Checks if a number of rays hit any triangle on multiple threads.
+     *  @param rays the rays.
+     *  @param occluded set to 1 for each ray hitting a triangle, 0 otherwise.
+     *  @param numThreads the number of threads to use (0 to use all hardware threads).
+     */
+    void TriangleBVH::OccludedRays(const std::vector<BVHRay>& rays, std::vector<uint8_t>& occluded, unsigned int numThreads) const
+    {
+        occluded.resize(rays.size());
+        parallel::ForChunks(rays.size(), 1024, [this, &rays, &occluded](uint64_t begin, uint64_t end, unsigned int)
+        {
+            for (auto i = begin; i < end; i += MAX_PACKET_SIZE) {
+                auto numRays = static_cast<unsigned int>(std::min<uint64_t>(MAX_PACKET_SIZE, end - i));
+                OccludedPacket(&rays[i], &occluded[i], numRays);
+            }
+        }, numThreads);
+    }
+
+    /**
+     *  Finds the closest point on the triangles to a query point.
+     *  @param point the query point.
+     *  @param result the closest point.
+     *  @param maxDistance the maximum distance of the closest point (inclusive).
+     *  @return whether a triangle was found within the maximum distance.
+     */
+    bool TriangleBVH::FindClosestPoint(const glm::vec3& point, BVHClosestPoint& result, float maxDistance) const
+    {
+        result = BVHClosestPoint{ NO_HIT, maxDistance, 0.0f, 0.0f, glm::vec3(0.0f) };
+        if (root_ == EMPTY_REF || !isValidQuery(point, maxDistance)) return false;
+
+        auto bestDistance2 = maxDistance * maxDistance;
+        std::pair<uint32_t, float> stack[STACK_SIZE];
+        auto stackSize = 0U;
+        stack[stackSize++] = std::make_pair(root_, 0.0f);
+        while (stackSize > 0) {
+            auto entry = stack[--stackSize];
+            if (entry.second > bestDistance2) continue;
+
+            if ((entry.first & LEAF_FLAG) != 0) {
+                UpdateClosestPoint(leaves_[entry.first & ~LEAF_FLAG], point, result, bestDistance2);
+                continue;
+            }
+
+            float distance2[4];
+            auto mask = DistanceToNode(nodes_[entry.first], point, bestDistance2, distance2);
+            assert(stackSize + 4 <= STACK_SIZE);
+            // push the children far to near, so the nearest one is visited first. Unused children have infinite
+            // distances, which pass the test against an infinite maximum distance.
+            auto firstChild = stackSize;
+            for (auto i = 0; i < 4; ++i) {
+                if ((mask & (1 << i)) == 0 || nodes_[entry.first].children[i] == EMPTY_REF) continue;
+                auto child = std::make_pair(nodes_[entry.first].children[i], distance2[i]);
+                auto pos = stackSize++;
+                for (; pos > firstChild && stack[pos - 1].second < child.second; --pos) stack[pos] = stack[pos - 1];
+                stack[pos] = child;
+            }
+        }
+
+        if (result.triangle == NO_HIT) return false;
+        result.distance = std::sqrt(bestDistance2);
+        return true;
+    }
+
+    /**
+     *  Finds the closest points on the triangles to a number of query points on multiple threads. Each thread
+     *  uses its own traversal stack, points close to each other should be consecutive for better cache usage.
+     *  @param points the query points.
+     *  @param results the closest points.
+     *  @param maxDistance the maximum distance of the closest points (inclusive).
+     *  @param numThreads the number of threads to use (0 to use all hardware threads).
+     */
+    void TriangleBVH::FindClosestPoints(const std::vector<glm::vec3>& points, std::vector<BVHClosestPoint>& results, float maxDistance, unsigned int numThreads) const
+    {
+        results.resize(points.size());
+        parallel::ForChunks(points.size(), 1024, [this, &points, &results, maxDistance](uint64_t begin, uint64_t end, unsigned int)
+        {
+            for (auto i = begin; i < end; ++i) FindClosestPoint(points[i], results[i], maxDistance);
+        }, numThreads);
+    }
+
+    /**
+     *  Finds the closest triangle hit by a ray by testing all triangles (for validating the hierarchy).
+     *  @param ray the ray.
+     *  @param hit the closest hit.
+     *  @return whether a triangle was hit.
+     */
+    bool TriangleBVH::IntersectBruteForce(const BVHRay& ray, BVHHit& hit) const
+    {
+        hit = BVHHit{ NO_HIT, ray.tMax, 0.0f, 0.0f };
+        if (!isValidRay(ray)) return false;
+        auto rayData = PrepareRay(ray);
+        float t[4], u[4], v[4];
+        for (const auto& leaf : leaves_) {
+            auto mask = IntersectLeaf(leaf, rayData, hit.t, t, u, v);
+            if (mask != 0) UpdateHit(leaf, mask, t, u, v, ray.tMax, hit);
+        }
+        return hit.triangle != NO_HIT;
+    }
+
+    /**
+     *  Checks if a ray hits any triangle by testing all triangles (for validating the hierarchy).
+     *  @param ray the ray.
+     *  @return whether a triangle was hit.
+     */
+    bool TriangleBVH::OccludedBruteForce(const BVHRay& ray) const
+    {
+        if (!isValidRay(ray)) return false;
+        auto rayData = PrepareRay(ray);
+        float t[4], u[4], v[4];
+        for (const auto& leaf : leaves_) {
+            if (IsAnyHit(IntersectLeaf(leaf, rayData, ray.tMax, t, u, v), t, ray.tMax)) return true;
+        }
+        return false;
+    }
+
+    /**
+     *  Finds the closest point on the triangles to a query point by testing all triangles (for validating the
+     *  hierarchy).
+     *  @param point the query point.
+     *  @param result the closest point.
+     *  @param maxDistance the maximum distance of the closest point (inclusive).
+     *  @return whether a triangle was found within the maximum distance.
+     */
+    bool TriangleBVH::FindClosestPointBruteForce(const glm::vec3& point, BVHClosestPoint& result, float maxDistance) const
+    {
+        result = BVHClosestPoint{ NO_HIT, maxDistance, 0.0f, 0.0f, glm::vec3(0.0f) };
+        if (!isValidQuery(point, maxDistance)) return false;
+        auto bestDistance2 = maxDistance * maxDistance;
+        for (const auto& leaf : leaves_) UpdateClosestPoint(leaf, point, result, bestDistance2);
+
+        if (result.triangle == NO_HIT) return false;
+        result.distance = std::sqrt(bestDistance2);
+        return true;
+    }
+}
@@ -0,0 +1,188 @@
+/**
+ * @file   TriangleBVH.h
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Contains the definition of a bounding volume hierarchy for ray queries on triangles.
+ */
+
+#ifndef TRIANGLEBVH_H
+#define TRIANGLEBVH_H
+
+#include "main.h"
+#include <core/math/math.h>
+#include <functional>
+
+namespace cgu {
+
+    /** A ray for queries on a TriangleBVH, only hits with tMin < t < tMax are reported. */
+    struct BVHRay
+    {
+        BVHRay() : origin{ 0.0f }, tMin{ 0.0f }, direction{ 0.0f, 0.0f, 1.0f }, tMax{ std::numeric_limits<float>::infinity() } {}
+        BVHRay(const glm::vec3& o, const glm::vec3& d, float tmin = 0.0f, float tmax = std::numeric_limits<float>::infinity()) :
+            origin{ o }, tMin{ tmin }, direction{ d }, tMax{ tmax } {}
+
+        /** Holds the rays origin. */
+        glm::vec3 origin;
+        /** Holds the minimum distance of a hit (in multiples of the direction). */
+        float tMin;
+        /** Holds the rays direction (does not need to be normalized). */
+        glm::vec3 direction;
+        /** Holds the maximum distance of a hit (in multiples of the direction). */
+        float tMax;
+    };
+
+    /** The closest hit of a ray. */
+    struct BVHHit
+    {
+        /** Holds the index of the triangle hit (TriangleBVH::NO_HIT if there is none). */
+        unsigned int triangle;
+        /** Holds the distance of the hit (in multiples of the direction). */
+        float t;
+        /** Holds the barycentric coordinate of the triangles second vertex. */
+        float u;
+        /** Holds the barycentric coordinate of the triangles third vertex. */
+        float v;
+    };
+
+    /** The closest point on the triangles to a query point. */
+    struct BVHClosestPoint
+    {
+        /** Holds the index of the closest triangle (TriangleBVH::NO_HIT if there is none within the maximum distance). */
+        unsigned int triangle;
+        /** Holds the distance to the closest point. */
+        float distance;
+        /** Holds the barycentric coordinate of the triangles second vertex. */
+        float u;
+        /** Holds the barycentric coordinate of the triangles third vertex. */
+        float v;
+        /** Holds the closest point. */
+        glm::vec3 point;
+    };
+
+    /**
+     * @brief  Bounding volume hierarchy over triangles for closest hit and any hit ray queries.
+     * The hierarchy is built top down with the binned surface area heuristic, each split opens the child with the
+     * largest surface area until a node has four children. The top levels are built with parallel binning, the
+     * subtrees below them are built in parallel and appended in task order. The splits (and so all query results) do
+     * not depend on the number of threads, but the order of the nodes in memory does: the size of the subtrees left
+     * as tasks is derived from it. Each leaf holds up to four triangles. Rays with NaN components or infinite
+     * origins or directions never hit anything, closest point queries for NaN or infinite points find nothing.
+     * Traversal tests the four children of a node and the four triangles of a leaf at once with SSE. Ray packets
+     * share the traversal of the nodes, which pays off for coherent rays (e.g. camera or shadow rays of
+     * neighboring pixels). Closest point queries visit the children nearest to the query point first and skip
+     * all boxes farther away than the closest point found so far. Ties between hits (or closest points) at the
+     * same distance are resolved to the lower triangle index, so all queries return the same results as the brute
+     * force versions.
+     *
+     * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+     * @date   2026.10.16
+     */
+    class TriangleBVH
+    {
+    public:
+        /** The function returning the vertices of a triangle, has to be safe to call from multiple threads. */
+        using TriangleFunction = std::function<cguMath::Tri3<float>(unsigned int)>;
+        /** The triangle index for rays that do not hit any triangle. */
+        static const unsigned int NO_HIT = 0xFFFFFFFF;
+        /** The maximum number of rays in a packet. */
+        static const unsigned int MAX_PACKET_SIZE = 8;
+
+        TriangleBVH(unsigned int numTriangles, const TriangleFunction& getTriangle, unsigned int numThreads = 0);
+        TriangleBVH(const std::vector<glm::vec3>& vertices, const std::vector<unsigned int>& indices, unsigned int numThreads = 0);
+        TriangleBVH(const TriangleBVH&);
+        TriangleBVH& operator=(const TriangleBVH&);
+        TriangleBVH(TriangleBVH&&);
+        TriangleBVH& operator=(TriangleBVH&&);
+        ~TriangleBVH();
+
+        bool Intersect(const BVHRay& ray, BVHHit& hit) const;
+        bool Occluded(const BVHRay& ray) const;
+        void IntersectPacket(const BVHRay* rays, BVHHit* hits, unsigned int numRays) const;
+        void OccludedPacket(const BVHRay* rays, uint8_t* occluded, unsigned int numRays) const;
+        void IntersectRays(const std::vector<BVHRay>& rays, std::vector<BVHHit>& hits, unsigned int numThreads = 0) const;
+        void OccludedRays(const std::vector<BVHRay>& rays, std::vector<uint8_t>& occluded, unsigned int numThreads = 0) const;
+
+        bool FindClosestPoint(const glm::vec3& point, BVHClosestPoint& result, float maxDistance = std::numeric_limits<float>::infinity()) const;
+        void FindClosestPoints(const std::vector<glm::vec3>& points, std::vector<BVHClosestPoint>& results,
+            float maxDistance = std::numeric_limits<float>::infinity(), unsigned int numThreads = 0) const;
+
+        bool IntersectBruteForce(const BVHRay& ray, BVHHit& hit) const;
+        bool OccludedBruteForce(const BVHRay& ray) const;
+        bool FindClosestPointBruteForce(const glm::vec3& point, BVHClosestPoint& result, float maxDistance = std::numeric_limits<float>::infinity()) const;
+
+        /** Returns the number of triangles. */
+        unsigned int GetNumTriangles() const { return numTriangles_; }
+        /** Returns the number of inner nodes. */
+        std::size_t GetNumNodes() const { return nodes_.size(); }
+        /** Returns the number of leaves. */
+        std::size_t GetNumLeaves() const { return leaves_.size(); }
+        /** Returns the bounding box of all triangles. */
+        const cguMath::AABB3<float>& GetBoundingBox() const { return bounds_; }
+
+    private:
+        /** An inner node with the bounding boxes of its four children stored for SIMD tests. */
+        struct Node
+        {
+            /** Holds the minimum x coordinates of the children. */
+            float minX[4];
+            /** Holds the minimum y coordinates of the children. */
+            float minY[4];
+            /** Holds the minimum z coordinates of the children. */
+            float minZ[4];
+            /** Holds the maximum x coordinates of the children. */
+            float maxX[4];
+            /** Holds the maximum y coordinates of the children. */
+            float maxY[4];
+            /** Holds the maximum z coordinates of the children. */
+            float maxZ[4];
+            /** Holds the references to the children. */
+            uint32_t children[4];
+        };
+
+        /** A leaf with up to four triangles stored as first vertex and edges for SIMD tests. */
+        struct Leaf
+        {
+            /** Holds the first vertices. */
+            float v0[3][4];
+            /** Holds the edges from the first to the second vertices. */
+            float e1[3][4];
+            /** Holds the edges from the first to the third vertices. */
+            float e2[3][4];
+            /** Holds the triangle indices (NO_HIT for unused entries). */
+            uint32_t triangles[4];
+        };
+
+        struct PrimRef;
+        struct BuildRange;
+        struct Subtree;
+        struct RayData;
+
+        void Build(const TriangleFunction& getTriangle, unsigned int numThreads);
+        static uint32_t BuildNode(std::vector<PrimRef>& prims, const BuildRange& range, const TriangleFunction& getTriangle,
+            Subtree& subtree, std::vector<BuildRange>* tasks, uint32_t taskThreshold, unsigned int numThreads);
+        static uint32_t BuildLeaf(const std::vector<PrimRef>& prims, const BuildRange& range, const TriangleFunction& getTriangle, Subtree& subtree);
+        static void SplitRange(std::vector<PrimRef>& prims, const BuildRange& range, BuildRange& left, BuildRange& right, unsigned int numThreads);
+
+        static RayData PrepareRay(const BVHRay& ray);
+        static int IntersectNode(const Node& node, const RayData& ray, float tMax, float* tNear);
+        static int IntersectLeaf(const Leaf& leaf, const RayData& ray, float tMax, float* t, float* u, float* v);
+        static void UpdateHit(const Leaf& leaf, int mask, const float* t, const float* u, const float* v, float tMax, BVHHit& hit);
+        static bool IsAnyHit(int mask, const float* t, float tMax);
+        static int DistanceToNode(const Node& node, const glm::vec3& point, float maxDistance2, float* distance2);
+        static void UpdateClosestPoint(const Leaf& leaf, const glm::vec3& point, BVHClosestPoint& result, float& bestDistance2);
+
+        /** Holds the number of triangles. */
+        unsigned int numTriangles_;
+        /** Holds the bounding box of all triangles. */
+        cguMath::AABB3<float> bounds_;
+        /** Holds the reference to the root (a node, a leaf or empty). */
+        uint32_t root_;
+        /** Holds the inner nodes. */
+        std::vector<Node> nodes_;
+        /** Holds the leaves. */
+        std::vector<Leaf> leaves_;
+    };
+}
+
+#endif // TRIANGLEBVH_H
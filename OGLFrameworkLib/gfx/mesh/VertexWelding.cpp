@@ -0,0 +1,387 @@
+/**
+ * @file   VertexWelding.cpp
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Implementation of the functions to weld vertices.
+ */
+
+#include "VertexWelding.h"
+#include "core/parallel_helper.h"
+#include <core/math/math.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <limits>
+
+namespace cgu {
+
+    namespace vertexWelding {
+
+        /** The number of vertices processed by a single task. */
+        static const uint64_t WELDING_CHUNK_SIZE = 1 << 16;
+        /** The maximum number of grid cells along an axis (the cell size is increased for larger grids). */
+        static const float MAX_GRID_CELLS = static_cast<float>(1 << 30);
+        /** Enlarges the cells so rounding errors cannot put vertices within the tolerance into non-neighboring cells. */
+        static const float CELL_SIZE_SCALE = 1.0001f;
+
+        /** The key of a grid cell (or of an exact position). */
+        struct CellKey
+        {
+            /** Holds the key components. */
+            uint32_t x, y, z;
+
+            bool operator==(const CellKey& rhs) const { return x == rhs.x && y == rhs.y && z == rhs.z; }
+            bool operator<(const CellKey& rhs) const { return x < rhs.x || (x == rhs.x && (y < rhs.y || (y == rhs.y && z < rhs.z))); }
+            /** Returns the hash of the key. */
+            uint64_t GetHash() const
+            {
+                auto h = (static_cast<uint64_t>(x) * 0x9E3779B97F4A7C15ULL) ^ (static_cast<uint64_t>(y) * 0xC2B2AE3D27D4EB4FULL) ^ (static_cast<uint64_t>(z) * 0x165667B19E3779F9ULL);
+                return h ^ (h >> 29);
+            }
+        };
+
+        /** A vertex sorted into the grid. */
+        struct CellEntry
+        {
+            /** Holds the cells key. */
+            CellKey key;
+            /** Holds the vertex index. */
+            uint32_t vertex;
+
+            bool operator<(const CellEntry& rhs) const { return key < rhs.key || (key == rhs.key && vertex < rhs.vertex); }
+        };
+
+        /** A bucket of the spatial hash with the lookup table for its cells. */
+        struct HashBucket
+        {
+            /** Holds the first entry of the bucket. */
+            uint64_t begin;
+            /** Holds the end of the bucket. */
+            uint64_t end;
+            /** Holds the first entry of each cell (and the end of the bucket). */
+            std::vector<uint64_t> cellStarts;
+            /** Holds the open addressing table mapping cell hashes to cells. */
+            std::vector<uint32_t> table;
+        };
+
+        /** Returns whether all coordinates of a vertex are finite. */
+        static bool isFinite(const glm::vec3& v)
+        {
+            return std::isfinite(v.x) && std::isfinite(v.y) && std::isfinite(v.z);
+        }
+
+        /** Returns the bit pattern of a float with negative zero mapped to zero. */
+        static uint32_t exactKey(float val)
+        {
+            val += 0.0f;
+            uint32_t result;
+            std::memcpy(&result, &val, sizeof(float));
+            return result;
+        }
+
+        /**
+         *  Returns the root of a vertex in the union-find forest and halves the path to it. Parents only move towards
+         *  the root, so concurrent updates keep the forest valid.
+         *  @param parents the parent of each vertex.
+         *  @param vertex the vertex.
+         *  @return the root.
+         */
+        static uint32_t findRoot(std::vector<std::atomic<uint32_t>>& parents, uint32_t vertex)
+        {
+            while (true) {
+                auto parent = parents[vertex].load(std::memory_order_relaxed);
+                if (parent == vertex) return vertex;
+                auto grandParent = parents[parent].load(std::memory_order_relaxed);
+                if (grandParent != parent) parents[vertex].compare_exchange_weak(parent, grandParent, std::memory_order_relaxed);
+                vertex = grandParent;
+            }
+        }
+
+        /**
+         *  Joins the groups of two vertices. The root with the higher index is always linked to the one with the
+         *  lower index, so each group ends up rooted at its lowest index, independent of the order of the joins.
+         *  @param parents the parent of each vertex.
+         *  @param v0 the first vertex.
+         *  @param v1 the second vertex.
+         */
+        static void unite(std::vector<std::atomic<uint32_t>>& parents, uint32_t v0, uint32_t v1)
+        {
+            while (true) {
+                v0 = findRoot(parents, v0);
+                v1 = findRoot(parents, v1);
+                if (v0 == v1) return;
+                if (v0 < v1) std::swap(v0, v1);
+                // fails if another thread linked v0 in the meantime, then the new roots are joined.
+                auto expected = v0;
+                if (parents[v0].compare_exchange_strong(expected, v1, std::memory_order_relaxed)) return;
+            }
+        }
+
+        /**
+         *  Calculates the bounding box of all finite vertices.
+         *  @param vertices the vertices.
+         *  @param numThreads the number of threads to use.
+         *  @return the bounding box (empty if there are no finite vertices).
+         */
+        static cguMath::AABB3<float> calculateBounds(const std::vector<glm::vec3>& vertices, unsigned int numThreads)
+        {
+            auto numChunks = (vertices.size() + WELDING_CHUNK_SIZE - 1) / WELDING_CHUNK_SIZE;
+            cguMath::AABB3<float> emptyBox;
+            emptyBox.minmax[0] = glm::vec3(std::numeric_limits<float>::infinity());
+            emptyBox.minmax[1] = glm::vec3(-std::numeric_limits<float>::infinity());
+            std::vector<cguMath::AABB3<float>> chunkBounds(numChunks, emptyBox);
+            parallel::ForChunks(vertices.size(), WELDING_CHUNK_SIZE, [&vertices, &chunkBounds](uint64_t begin, uint64_t end, unsigned int)
+            {
+                auto& bounds = chunkBounds[begin / WELDING_CHUNK_SIZE];
+                for (auto i = begin; i < end; ++i) {
+                    if (!isFinite(vertices[i])) continue;
+                    bounds.minmax[0] = glm::min(bounds.minmax[0], vertices[i]);
+                    bounds.minmax[1] = glm::max(bounds.minmax[1], vertices[i]);
+                }
+            }, numThreads);
+
+            auto result = emptyBox;
+            for (const auto& bounds : chunkBounds) {
+                result.minmax[0] = glm::min(result.minmax[0], bounds.minmax[0]);
+                result.minmax[1] = glm::max(result.minmax[1], bounds.minmax[1]);
+            }
+            return result;
+        }
+
+        /**
+         *  Returns the absolute welding tolerance for vertices with the given bounding box.
+         *  @param params the welding parameters.
+         *  @param bounds the bounding box of the vertices.
+         */
+        static float absoluteTolerance(const VertexWeldingParameters& params, const cguMath::AABB3<float>& bounds)
+        {
+            if (params.tolerance < 0.0f || !std::isfinite(params.tolerance)) {
+                LOG(ERROR) << "Invalid vertex welding tolerance " << params.tolerance << ".";
+                throw std::runtime_error("Invalid vertex welding tolerance.");
+            }
+            if (!params.relativeTolerance || bounds.minmax[0].x > bounds.minmax[1].x) return params.tolerance;
+            return params.tolerance * glm::length(bounds.minmax[1] - bounds.minmax[0]);
+        }
+
+        /**
+         *  Returns the absolute welding tolerance.
+         *  @param vertices the vertices.
+         *  @param params the welding parameters.
+         *  @param numThreads the number of threads to use (0 to use all hardware threads).
+         */
+        float GetAbsoluteTolerance(const std::vector<glm::vec3>& vertices, const VertexWeldingParameters& params, unsigned int numThreads)
+        {
+            return absoluteTolerance(params, calculateBounds(vertices, numThreads));
+        }
+
+        /**
+         *  Finds the vertex each vertex is welded to.
+         *  The vertices are sorted into buckets by the hash of their cells, each bucket is sorted by cell on its
+         *  own, so all steps run in parallel. For a tolerance of 0 the representatives are the first vertices of
+         *  each cell. Otherwise vertices within the tolerance are joined in a concurrent union-find with path
+         *  halving in a single pass over the neighboring cells, the roots are the lowest indices of the groups.
+         *  @param vertices the vertices.
+         *  @param params the welding parameters.
+         *  @param representatives the lowest index of the vertices each vertex is welded to.
+         *  @param numThreads the number of threads to use (0 to use all hardware threads).
+         */
+        void FindRepresentatives(const std::vector<glm::vec3>& vertices, const VertexWeldingParameters& params,
+            std::vector<unsigned int>& representatives, unsigned int numThreads)
+        {
+            if (vertices.size() >= std::numeric_limits<uint32_t>::max()) {
+                LOG(ERROR) << "Too many vertices for welding (" << vertices.size() << ").";
+                throw std::runtime_error("Too many vertices for welding.");
+            }
+            if (numThreads == 0) numThreads = parallel::GetNumThreads();
+
+            auto numVertices = static_cast<uint64_t>(vertices.size());
+            representatives.resize(vertices.size());
+            for (auto i = 0U; i < representatives.size(); ++i) representatives[i] = i;
+            if (numVertices == 0) return;
+
+            auto bounds = calculateBounds(vertices, numThreads);
+            auto tolerance = absoluteTolerance(params, bounds);
+            if (bounds.minmax[0].x > bounds.minmax[1].x) return;
+
+            auto maxExtent = glm::max(bounds.minmax[1].x - bounds.minmax[0].x, glm::max(bounds.minmax[1].y - bounds.minmax[0].y, bounds.minmax[1].z - bounds.minmax[0].z));
+            auto cellSize = glm::max(tolerance * CELL_SIZE_SCALE, maxExtent / MAX_GRID_CELLS);
+            auto exact = tolerance == 0.0f;
+            auto invCellSize = exact ? 0.0f : 1.0f / cellSize;
+            auto gridMin = bounds.minmax[0];
+            auto getKey = [exact, invCellSize, &gridMin](const glm::vec3& v)
+            {
+                if (exact) return CellKey{ exactKey(v.x), exactKey(v.y), exactKey(v.z) };
+                auto cell = glm::floor((v - gridMin) * invCellSize);
+                return CellKey{ static_cast<uint32_t>(cell.x), static_cast<uint32_t>(cell.y), static_cast<uint32_t>(cell.z) };
+            };
+
+            // sort the vertices into buckets by their cells hash (stable per chunk to stay deterministic).
+            auto numBuckets = 1ULL;
+            while (numBuckets < 4096 && numBuckets * 1024 < numVertices) numBuckets <<= 1;
+            auto bucketMask = numBuckets - 1;
+            auto numChunks = (numVertices + WELDING_CHUNK_SIZE - 1) / WELDING_CHUNK_SIZE;
+            std::vector<uint64_t> chunkOffsets(numChunks * numBuckets, 0);
+            parallel::ForChunks(numVertices, WELDING_CHUNK_SIZE, [&](uint64_t begin, uint64_t end, unsigned int)
+            {
+                auto counts = &chunkOffsets[(begin / WELDING_CHUNK_SIZE) * numBuckets];
+                for (auto i = begin; i < end; ++i) if (isFinite(vertices[i])) ++counts[getKey(vertices[i]).GetHash() & bucketMask];
+            }, numThreads);
+
+            std::vector<HashBucket> buckets(numBuckets);
+            uint64_t numEntries = 0;
+            for (auto b = 0ULL; b < numBuckets; ++b) {
+                buckets[b].begin = numEntries;
+                for (auto c = 0ULL; c < numChunks; ++c) {
+                    auto count = chunkOffsets[c * numBuckets + b];
+                    chunkOffsets[c * numBuckets + b] = numEntries;
+                    numEntries += count;
+                }
+                buckets[b].end = numEntries;
+            }
+
+            std::vector<CellEntry> entries(numEntries);
+            parallel::ForChunks(numVertices, WELDING_CHUNK_SIZE, [&](uint64_t begin, uint64_t end, unsigned int)
+            {
+                auto offsets = &chunkOffsets[(begin / WELDING_CHUNK_SIZE) * numBuckets];
+                for (auto i = begin; i < end; ++i) {
+                    if (!isFinite(vertices[i])) continue;
+                    auto key = getKey(vertices[i]);
+                    entries[offsets[key.GetHash() & bucketMask]++] = CellEntry{ key, static_cast<uint32_t>(i) };
+                }
+            }, numThreads);
+            std::vector<uint64_t>().swap(chunkOffsets);
+
+            // sort the buckets and find their cells.
+            parallel::ForChunks(numBuckets, 1, [&](uint64_t bBegin, uint64_t bEnd, unsigned int)
+            {
+                for (auto b = bBegin; b < bEnd; ++b) {
+                    auto& bucket = buckets[b];
+                    std::sort(entries.begin() + bucket.begin, entries.begin() + bucket.end);
+                    for (auto i = bucket.begin; i < bucket.end; ++i) {
+                        if (i == bucket.begin || !(entries[i].key == entries[i - 1].key)) bucket.cellStarts.push_back(i);
+                        if (exact) representatives[entries[i].vertex] = entries[bucket.cellStarts.back()].vertex;
+                    }
+                    bucket.cellStarts.push_back(bucket.end);
+                }
+            }, numThreads);
+            if (exact) return;
+
+            // build the lookup tables of the buckets.
+            parallel::ForChunks(numBuckets, 1, [&](uint64_t bBegin, uint64_t bEnd, unsigned int)
+            {
+                for (auto b = bBegin; b < bEnd; ++b) {
+                    auto& bucket = buckets[b];
+                    auto numCells = bucket.cellStarts.size() - 1;
+                    auto tableSize = 1ULL;
+                    while (tableSize < 2 * numCells) tableSize <<= 1;
+                    bucket.table.assign(tableSize, std::numeric_limits<uint32_t>::max());
+                    for (auto c = 0U; c < numCells; ++c) {
+                        auto slot = (entries[bucket.cellStarts[c]].key.GetHash() >> 32) & (tableSize - 1);
+                        while (bucket.table[slot] != std::numeric_limits<uint32_t>::max()) slot = (slot + 1) & (tableSize - 1);
+                        bucket.table[slot] = c;
+                    }
+                }
+            }, numThreads);
+
+            auto findCell = [&buckets, &entries, bucketMask](const CellKey& key, uint64_t& cellBegin, uint64_t& cellEnd)
+            {
+                auto hash = key.GetHash();
+                const auto& bucket = buckets[hash & bucketMask];
+                auto tableMask = bucket.table.size() - 1;
+                for (auto slot = (hash >> 32) & tableMask; bucket.table[slot] != std::numeric_limits<uint32_t>::max(); slot = (slot + 1) & tableMask) {
+                    auto c = bucket.table[slot];
+                    if (entries[bucket.cellStarts[c]].key == key) {
+                        cellBegin = bucket.cellStarts[c];
+                        cellEnd = bucket.cellStarts[c + 1];
+                        return true;
+                    }
+                }
+                return false;
+            };
+
+            // join vertices within the tolerance, each pair is tested from the vertex with the higher index.
+            auto tolerance2 = tolerance * tolerance;
+            std::vector<std::atomic<uint32_t>> parents(numVertices);
+            for (auto i = 0U; i < numVertices; ++i) parents[i].store(i, std::memory_order_relaxed);
+            parallel::ForChunks(numBuckets, 1, [&](uint64_t bBegin, uint64_t bEnd, unsigned int)
+            {
+                std::vector<std::pair<uint64_t, uint64_t>> neighbors;
+                for (auto b = bBegin; b < bEnd; ++b) {
+                    const auto& bucket = buckets[b];
+                    for (auto c = 0U; c + 1 < bucket.cellStarts.size(); ++c) {
+                        auto key = entries[bucket.cellStarts[c]].key;
+                        neighbors.clear();
+                        for (auto dz = -1; dz <= 1; ++dz) for (auto dy = -1; dy <= 1; ++dy) for (auto dx = -1; dx <= 1; ++dx) {
+                            // cells wrap around at 2^32, which is far beyond the grid so no cell is found there.
+                            CellKey neighborKey{ key.x + dx, key.y + dy, key.z + dz };
+                            uint64_t cellBegin, cellEnd;
+                            if (findCell(neighborKey, cellBegin, cellEnd)) neighbors.emplace_back(cellBegin, cellEnd);
+                        }
+
+                        for (auto i = bucket.cellStarts[c]; i < bucket.cellStarts[c + 1]; ++i) {
+                            auto vertex = entries[i].vertex;
+                            const auto& pos = vertices[vertex];
+                            for (const auto& neighbor : neighbors) {
+                                for (auto j = neighbor.first; j < neighbor.second; ++j) {
+                                    auto other = entries[j].vertex;
+                                    if (other >= vertex) continue;
+                                    auto diff = pos - vertices[other];
+                                    if (glm::dot(diff, diff) <= tolerance2) unite(parents, vertex, other);
+                                }
+                            }
+                        }
+                    }
+                }
+            }, numThreads);
+
+            parallel::ForChunks(numVertices, WELDING_CHUNK_SIZE, [&parents, &representatives](uint64_t begin, uint64_t end, unsigned int)
+            {
+                for (auto i = begin; i < end; ++i) representatives[i] = findRoot(parents, static_cast<uint32_t>(i));
+            }, numThreads);
+        }
+
+        /**
+         *  Welds vertices.
+         *  @param vertices the vertices.
+         *  @param params the welding parameters.
+         *  @param weldedVertices the welded vertices (the position of the vertex with the lowest index of each group,
+         *      in the order of these vertices).
+         *  @param weldedIndices the index of the welded vertex for each original vertex.
+         *  @param numThreads the number of threads to use (0 to use all hardware threads).
+         *  @return the number of welded vertices.
+         */
+        unsigned int WeldVertices(const std::vector<glm::vec3>& vertices, const VertexWeldingParameters& params,
+            std::vector<glm::vec3>& weldedVertices, std::vector<unsigned int>& weldedIndices, unsigned int numThreads)
+        {
+            std::vector<unsigned int> representatives;
+            FindRepresentatives(vertices, params, representatives, numThreads);
+
+            auto numChunks = (vertices.size() + WELDING_CHUNK_SIZE - 1) / WELDING_CHUNK_SIZE;
+            std::vector<unsigned int> chunkOffsets(numChunks + 1, 0);
+            parallel::ForChunks(vertices.size(), WELDING_CHUNK_SIZE, [&representatives, &chunkOffsets](uint64_t begin, uint64_t end, unsigned int)
+            {
+                auto& count = chunkOffsets[begin / WELDING_CHUNK_SIZE + 1];
+                for (auto i = begin; i < end; ++i) if (representatives[i] == i) ++count;
+            }, numThreads);
+            for (auto c = 0U; c < numChunks; ++c) chunkOffsets[c + 1] += chunkOffsets[c];
+
+            weldedIndices.resize(vertices.size());
+            weldedVertices.resize(chunkOffsets.back());
+            parallel::ForChunks(vertices.size(), WELDING_CHUNK_SIZE, [&](uint64_t begin, uint64_t end, unsigned int)
+            {
+                auto idx = chunkOffsets[begin / WELDING_CHUNK_SIZE];
+                for (auto i = begin; i < end; ++i) {
+                    if (representatives[i] != i) continue;
+                    weldedVertices[idx] = vertices[i];
+                    weldedIndices[i] = idx++;
+                }
+            }, numThreads);
+            parallel::ForChunks(vertices.size(), WELDING_CHUNK_SIZE, [&representatives, &weldedIndices](uint64_t begin, uint64_t end, unsigned int)
+            {
+                for (auto i = begin; i < end; ++i) if (representatives[i] != i) weldedIndices[i] = weldedIndices[representatives[i]];
+            }, numThreads);
+            return chunkOffsets.back();
+        }
+    }
+}
@@ -0,0 +1,45 @@
+/**
+ * @file   VertexWelding.h
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Contains functions to weld vertices at (nearly) identical positions.
+ */
+
+#ifndef VERTEXWELDING_H
+#define VERTEXWELDING_H
+
+#include "main.h"
+
+namespace cgu {
+
+    /** Parameters for welding vertices. */
+    struct VertexWeldingParameters
+    {
+        VertexWeldingParameters() : tolerance{ 0.0f }, relativeTolerance{ false } {}
+        VertexWeldingParameters(float tol, bool relative) : tolerance{ tol }, relativeTolerance{ relative } {}
+
+        /** Holds the distance up to which vertices are welded (0 to weld only identical positions). */
+        float tolerance;
+        /** Holds whether the tolerance is relative to the diagonal of the vertices bounding box. */
+        bool relativeTolerance;
+    };
+
+    /**
+     *  Vertices are welded if they are within the tolerance of each other, welding is transitive. Each group of
+     *  welded vertices is represented by its vertex with the lowest index, so the results do not depend on the
+     *  number of threads. The vertices are sorted into a spatial hash grid with cells of the tolerances size
+     *  (or into exact positions for a tolerance of 0) and only neighboring cells are compared.
+     *  Vertices with non finite coordinates are never welded.
+     */
+    namespace vertexWelding {
+
+        float GetAbsoluteTolerance(const std::vector<glm::vec3>& vertices, const VertexWeldingParameters& params, unsigned int numThreads = 0);
+        void FindRepresentatives(const std::vector<glm::vec3>& vertices, const VertexWeldingParameters& params,
+            std::vector<unsigned int>& representatives, unsigned int numThreads = 0);
+        unsigned int WeldVertices(const std::vector<glm::vec3>& vertices, const VertexWeldingParameters& params,
+            std::vector<glm::vec3>& weldedVertices, std::vector<unsigned int>& weldedIndices, unsigned int numThreads = 0);
+    }
+}
+
+#endif // VERTEXWELDING_H
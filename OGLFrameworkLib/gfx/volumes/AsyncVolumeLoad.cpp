@@ -0,0 +1,230 @@
+/**
+ * @file   AsyncVolumeLoad.cpp
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Implementation of the asynchronous loading of volume textures.
+ */
+
+#include "AsyncVolumeLoad.h"
+#include "gfx/glrenderer/GLTexture.h"
+
+namespace cgu {
+
+    /**
+     *  Creates the texture the volume is uploaded to, the texture of a previous upload is reused if it matches.
+     *  @param data the volume data.
+     */
+    void GLTextureUploadSink::BeginUpload(const VolumeTextureData& data)
+    {
+        if (texture && texture->GetDimensions() == data.size && texture->GetDescriptor().internalFormat == data.descriptor.internalFormat
+            && texture->GetDescriptor().format == data.descriptor.format && texture->GetDescriptor().type == data.descriptor.type) return;
+        texture = std::make_unique<GLTexture>(data.size.x, data.size.y, data.size.z, mipLevels, data.descriptor, nullptr);
+    }
+
+    /**
+     *  Uploads a slab of z slices to level 0 of the texture.
+     *  @param data the volume data.
+     *  @param firstSlice the first slice to upload.
+     *  @param numSlices the number of slices to upload.
+     */
+    void GLTextureUploadSink::UploadSlices(const VolumeTextureData& data, unsigned int firstSlice, unsigned int numSlices)
+    {
+        texture->SetData(0, glm::uvec3(0, 0, firstSlice), glm::uvec3(data.size.x, data.size.y, numSlices),
+            data.data.data() + firstSlice * data.GetSliceSize());
+    }
+
+    /**
+     *  Constructor.
+     *  @param maxSlabSize the maximum number of bytes uploaded at once.
+     */
+    VolumeSlabUpload::VolumeSlabUpload(uint64_t maxSlabSize) :
+        maxSlabSize(maxSlabSize),
+        sink(nullptr),
+        data(nullptr),
+        nextSlice(0),
+        slicesPerSlab(1)
+    {
+    }
+
+    /**
+     *  Begins uploading data, an unfinished upload is abandoned.
+     *  @param uploadSink the sink to upload to.
+     *  @param uploadData the data to upload.
+     */
+    void VolumeSlabUpload::Begin(VolumeUploadSink& uploadSink, const VolumeTextureData& uploadData)
+    {
+        sink = &uploadSink;
+        data = &uploadData;
+        auto sliceSize = glm::max(data->GetSliceSize(), uint64_t(1));
+        slicesPerSlab = static_cast<unsigned int>(glm::clamp(maxSlabSize / sliceSize, uint64_t(1), static_cast<uint64_t>(glm::max(data->size.z, 1U))));
+        nextSlice = 0;
+        sink->BeginUpload(*data);
+    }
+
+    /**
+     *  Uploads slabs of slices until the time budget is used up, at least one slab is uploaded per call.
+     *  The sinks upload is ended after the last slab.
+     *  @param startTime the time the budget started.
+     *  @param timeBudget the time that may be spent uploading.
+     *  @return whether the upload is finished.
+     */
+    bool VolumeSlabUpload::Continue(std::chrono::steady_clock::time_point startTime, std::chrono::microseconds timeBudget)
+    {
+        if (!data) return true;
+        do {
+            auto numSlices = glm::min(slicesPerSlab, data->size.z - nextSlice);
+            sink->UploadSlices(*data, nextSlice, numSlices);
+            nextSlice += numSlices;
+        } while (nextSlice < data->size.z
+            && std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime) < timeBudget);
+
+        if (nextSlice < data->size.z) return false;
+        sink->EndUpload();
+        Abort();
+        return true;
+    }
+
+    /** Stops uploading without ending the sinks upload. */
+    void VolumeSlabUpload::Abort()
+    {
+        sink = nullptr;
+        data = nullptr;
+        nextSlice = 0;
+    }
+
+    /**
+     *  Constructor, starts loading a volume on a background thread.
+     *  @param volume the volume to load.
+     *  @param maxSlabSize the maximum number of bytes uploaded at once.
+     */
+    AsyncVolumeLoad::AsyncVolumeLoad(std::shared_ptr<const Volume> volume, uint64_t maxSlabSize) :
+        volume(std::move(volume)),
+        upload(maxSlabSize),
+        state(VolumeLoadState::LOADING),
+        progress(0.0f),
+        canceled(false)
+    {
+        auto loadedVolume = this->volume;
+        Start([loadedVolume](const ProgressFunction& reportProgress) { return loadedVolume->LoadTextureData(reportProgress); });
+    }
+
+    /**
+     *  Constructor, starts loading data with a custom function on a background thread.
+     *  @param loadFunction the function loading the data.
+     *  @param maxSlabSize the maximum number of bytes uploaded at once.
+     */
+    AsyncVolumeLoad::AsyncVolumeLoad(LoadFunction loadFunction, uint64_t maxSlabSize) :
+        upload(maxSlabSize),
+        state(VolumeLoadState::LOADING),
+        progress(0.0f),
+        canceled(false)
+    {
+        Start(std::move(loadFunction));
+    }
+
+    /** Destructor, cancels the load and waits for the background thread. */
+    AsyncVolumeLoad::~AsyncVolumeLoad()
+    {
+        Cancel();
+        if (loadResult.valid()) loadResult.wait();
+    }
+
+    /**
+     *  Starts the background thread.
+     *  @param loadFunction the function loading the data.
+     */
+    void AsyncVolumeLoad::Start(LoadFunction loadFunction)
+    {
+        loadResult = std::async(std::launch::async, [this, loadFunction]()
+        {
+            return loadFunction([this](float loadProgress)
+            {
+                progress = 0.5f * glm::clamp(loadProgress, 0.0f, 1.0f);
+                return !canceled;
+            });
+        });
+    }
+
+    /**
+     *  Cancels the load. The background thread stops at the next progress report, the state changes to canceled
+     *  with the next call to Update.
+     */
+    void AsyncVolumeLoad::Cancel()
+    {
+        canceled = true;
+    }
+
+    /**
+     *  Advances the load, has to be called from the thread the sink uploads on (e.g. once per frame).
+     *  Once the data is loaded slabs of slices are uploaded until the time budget is used up, at least one slab is
+     *  uploaded per call.
+     *  @param sink the sink to upload to.
+     *  @param timeBudget the time that may be spent uploading.
+     *  @return the state after the update.
+     */
+    VolumeLoadState AsyncVolumeLoad::Update(VolumeUploadSink& sink, std::chrono::microseconds timeBudget)
+    {
+        auto startTime = std::chrono::steady_clock::now();
+        if (state == VolumeLoadState::LOADING) {
+            if (loadResult.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return state;
+            if (!BeginUpload(sink)) return state;
+        }
+        if (state != VolumeLoadState::UPLOADING) return state;
+
+        if (canceled) {
+            upload.Abort();
+            textureData = VolumeTextureData();
+            state = VolumeLoadState::CANCELED;
+            return state;
+        }
+
+        auto finished = upload.Continue(startTime, timeBudget);
+        progress = 0.5f + 0.5f * upload.GetProgress();
+        if (finished) {
+            textureData = VolumeTextureData();
+            state = VolumeLoadState::FINISHED;
+        }
+        return state;
+    }
+
+    /**
+     *  Waits for the data and uploads it completely.
+     *  @param sink the sink to upload to.
+     *  @return the final state.
+     */
+    VolumeLoadState AsyncVolumeLoad::Wait(VolumeUploadSink& sink)
+    {
+        if (loadResult.valid()) loadResult.wait();
+        while (!IsDone()) Update(sink, std::chrono::microseconds::max());
+        return state;
+    }
+
+    /**
+     *  Takes the loaded data from the background thread and starts uploading.
+     *  @param sink the sink to upload to.
+     *  @return whether uploading started.
+     */
+    bool AsyncVolumeLoad::BeginUpload(VolumeUploadSink& sink)
+    {
+        try {
+            textureData = loadResult.get();
+        }
+        catch (const std::exception& e) {
+            errorMessage = e.what();
+            LOG(ERROR) << "Loading volume failed: " << errorMessage.c_str();
+            state = VolumeLoadState::FAILED;
+            return false;
+        }
+
+        if (canceled || textureData.data.empty()) {
+            textureData = VolumeTextureData();
+            state = VolumeLoadState::CANCELED;
+            return false;
+        }
+
+        upload.Begin(sink, textureData);
+        state = VolumeLoadState::UPLOADING;
+        return true;
+    }
+}
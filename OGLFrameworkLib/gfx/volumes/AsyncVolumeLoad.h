@@ -0,0 +1,167 @@
+/**
+ * @file   AsyncVolumeLoad.h
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Contains the asynchronous loading of volume textures.
+ */
+
+#ifndef ASYNCVOLUMELOAD_H
+#define ASYNCVOLUMELOAD_H
+
+#include "main.h"
+#include "gfx/volumes/Volume.h"
+#include <atomic>
+#include <chrono>
+#include <future>
+
+namespace cgu {
+
+    /** The states of an asynchronous volume load. */
+    enum class VolumeLoadState
+    {
+        /** The data is loaded and converted on a background thread. */
+        LOADING,
+        /** The data is uploaded by AsyncVolumeLoad::Update. */
+        UPLOADING,
+        /** The upload is finished. */
+        FINISHED,
+        /** The load was canceled. */
+        CANCELED,
+        /** Loading the data failed. */
+        FAILED
+    };
+
+    /**
+     *  @brief Receives the data of an asynchronously loaded volume on the thread calling AsyncVolumeLoad::Update.
+     */
+    class VolumeUploadSink
+    {
+    public:
+        virtual ~VolumeUploadSink() = default;
+
+        /** Called once before the first slices are uploaded. */
+        virtual void BeginUpload(const VolumeTextureData& data) = 0;
+        /** Uploads the z slices [firstSlice, firstSlice + numSlices). */
+        virtual void UploadSlices(const VolumeTextureData& data, unsigned int firstSlice, unsigned int numSlices) = 0;
+        /** Called once after the last slices were uploaded. */
+        virtual void EndUpload() = 0;
+    };
+
+    /**
+     *  @brief Uploads an asynchronously loaded volume to a 3D texture (needs the GL context).
+     */
+    class GLTextureUploadSink final : public VolumeUploadSink
+    {
+    public:
+        explicit GLTextureUploadSink(unsigned int mipLevels = 1) : mipLevels(mipLevels) {}
+
+        void BeginUpload(const VolumeTextureData& data) override;
+        void UploadSlices(const VolumeTextureData& data, unsigned int firstSlice, unsigned int numSlices) override;
+        void EndUpload() override {}
+
+        /** Returns the texture (only complete after the upload finished). */
+        GLTexture* GetTexture() const { return texture.get(); }
+        /** Releases the texture. */
+        std::unique_ptr<GLTexture> ReleaseTexture() { return std::move(texture); }
+
+    private:
+        /** Holds the number of mip levels of the texture. */
+        unsigned int mipLevels;
+        /** Holds the texture. */
+        std::unique_ptr<GLTexture> texture;
+    };
+
+    /**
+     *  @brief Uploads volume data to a sink in slabs of z slices, spread over several calls with a time budget each.
+     *  The data has to stay alive until the upload is finished.
+     */
+    class VolumeSlabUpload
+    {
+    public:
+        explicit VolumeSlabUpload(uint64_t maxSlabSize = 16 * 1024 * 1024);
+
+        void Begin(VolumeUploadSink& sink, const VolumeTextureData& data);
+        bool Continue(std::chrono::steady_clock::time_point startTime, std::chrono::microseconds timeBudget);
+        void Abort();
+
+        /** Returns whether an upload was begun and is not finished yet. */
+        bool IsUploading() const { return data != nullptr; }
+        /** Returns the fraction of slices uploaded. */
+        float GetProgress() const { return data ? static_cast<float>(nextSlice) / static_cast<float>(data->size.z) : 1.0f; }
+
+    private:
+        /** Holds the maximum number of bytes uploaded at once. */
+        uint64_t maxSlabSize;
+        /** Holds the sink uploaded to. */
+        VolumeUploadSink* sink;
+        /** Holds the data uploaded. */
+        const VolumeTextureData* data;
+        /** Holds the next slice to upload. */
+        unsigned int nextSlice;
+        /** Holds the number of slices uploaded at once. */
+        unsigned int slicesPerSlab;
+    };
+
+    /**
+     *  @brief Handle of a volume loaded asynchronously.
+     *  The file is read and converted on a background thread. The upload is split into slabs of z slices that are
+     *  handed to an upload sink by Update, which is meant to be called once per frame from the GL thread with a time
+     *  budget. Progress can be queried and the load canceled from any thread.
+     *
+     * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+     * @date   2026.10.16
+     */
+    class AsyncVolumeLoad
+    {
+    public:
+        /** The function reporting the loading progress in [0, 1], returns false if the load was canceled. */
+        using ProgressFunction = std::function<bool(float)>;
+        /** The function loading the data on the background thread (see Volume::LoadTextureData). */
+        using LoadFunction = std::function<VolumeTextureData(const ProgressFunction& reportProgress)>;
+
+        explicit AsyncVolumeLoad(std::shared_ptr<const Volume> volume, uint64_t maxSlabSize = 16 * 1024 * 1024);
+        explicit AsyncVolumeLoad(LoadFunction loadFunction, uint64_t maxSlabSize = 16 * 1024 * 1024);
+        AsyncVolumeLoad(const AsyncVolumeLoad&) = delete;
+        AsyncVolumeLoad& operator=(const AsyncVolumeLoad&) = delete;
+        ~AsyncVolumeLoad();
+
+        VolumeLoadState Update(VolumeUploadSink& sink, std::chrono::microseconds timeBudget);
+        VolumeLoadState Wait(VolumeUploadSink& sink);
+        void Cancel();
+
+        /** Returns the volume loaded (nullptr if loaded by a custom function). */
+        const std::shared_ptr<const Volume>& GetVolume() const { return volume; }
+        /** Returns the current state. */
+        VolumeLoadState GetState() const { return state; }
+        /** Returns the progress in [0, 1] (loading counts half, uploading the other half). */
+        float GetProgress() const { return progress; }
+        /** Returns whether the load is finished, canceled or failed. */
+        bool IsDone() const { auto s = GetState(); return s != VolumeLoadState::LOADING && s != VolumeLoadState::UPLOADING; }
+        /** Returns the error message if loading failed. */
+        const std::string& GetError() const { return errorMessage; }
+
+    private:
+        void Start(LoadFunction loadFunction);
+        bool BeginUpload(VolumeUploadSink& sink);
+
+        /** Holds the volume loaded. */
+        std::shared_ptr<const Volume> volume;
+        /** Holds the result of the background thread. */
+        std::future<VolumeTextureData> loadResult;
+        /** Holds the loaded data while uploading. */
+        VolumeTextureData textureData;
+        /** Holds the slab wise upload. */
+        VolumeSlabUpload upload;
+        /** Holds the current state. */
+        std::atomic<VolumeLoadState> state;
+        /** Holds the progress. */
+        std::atomic<float> progress;
+        /** Holds whether the load was canceled. */
+        std::atomic<bool> canceled;
+        /** Holds the error message. */
+        std::string errorMessage;
+    };
+}
+
+#endif // ASYNCVOLUMELOAD_H
@@ -0,0 +1,441 @@
+/**
+ * @file   BrickedVolume.cpp
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Implementation of the bricked on-disk volume format and its brick cache.
+ */
+
+#include "BrickedVolume.h"
+#include <boost/filesystem.hpp>
+#include <codecvt>
+#include <cstring>
+
+namespace cgu {
+
+    /**
+     *  Constructor, opens an existing bricked volume file and reads its page table.
+     *  @param bvolFilename the file name of the bricked volume.
+     */
+    BrickedVolume::BrickedVolume(const std::string& bvolFilename) :
+        filename(bvolFilename),
+        file(bvolFilename, std::ios::in | std::ios::binary),
+        brickDataStart(0),
+        sourceKey(0),
+        brickSize(0),
+        numBricks(0)
+    {
+        if (!file.is_open()) {
+            std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+            LOG(ERROR) << "Could not open file '" << converter.from_bytes(filename) << "'.";
+            throw std::runtime_error("Could not open file '" + filename + "'.");
+        }
+
+        bool correctHeader;
+        unsigned int actualVersion;
+        std::tie(correctHeader, actualVersion) = VersionableSerializerType::checkHeader(file);
+        if (!correctHeader) {
+            std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+            LOG(ERROR) << "File '" << converter.from_bytes(filename) << "' is no bricked volume or has the wrong version ("
+                << actualVersion << ").";
+            throw std::runtime_error("File '" + filename + "' is no bricked volume or has the wrong version.");
+        }
+
+        uint32_t type;
+        uint64_t numPageEntries = 0;
+        serializeHelper::read(file, sourceKey);
+        serializeHelper::read(file, layout.size);
+        serializeHelper::read(file, brickSize);
+        serializeHelper::read(file, layout.bytesPerVoxel);
+        serializeHelper::read(file, layout.numComponents);
+        serializeHelper::read(file, type);
+        serializeHelper::read(file, layout.scaleValue);
+        serializeHelper::read(file, numPageEntries);
+        layout.type = static_cast<GLenum>(type);
+        layout.voxelStride = layout.bytesPerVoxel;
+
+        auto fileSize = static_cast<uint64_t>(boost::filesystem::file_size(filename));
+        auto pageTableStart = static_cast<uint64_t>(file.tellg());
+        if (!file || glm::any(glm::equal(brickSize, glm::uvec3(0))) || layout.bytesPerVoxel == 0 || layout.numComponents == 0) {
+            std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+            LOG(ERROR) << "Could not read the header of bricked volume '" << converter.from_bytes(filename) << "'.";
+            throw std::runtime_error("Could not read the header of bricked volume '" + filename + "'.");
+        }
+
+        numBricks = (layout.size + brickSize - glm::uvec3(1)) / brickSize;
+        auto expectedNumBricks = static_cast<uint64_t>(numBricks.x) * numBricks.y * numBricks.z;
+        if (numPageEntries != expectedNumBricks || numPageEntries > (fileSize - pageTableStart) / sizeof(BrickPageEntry)) {
+            std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+            LOG(ERROR) << "The page table of bricked volume '" << converter.from_bytes(filename) << "' does not match the volume ("
+                << numPageEntries << " entries, " << expectedNumBricks << " bricks).";
+            throw std::runtime_error("The page table of bricked volume '" + filename + "' does not match the volume.");
+        }
+
+        pageTable.resize(static_cast<std::size_t>(numPageEntries));
+        file.read(reinterpret_cast<char*>(pageTable.data()), static_cast<std::streamsize>(numPageEntries * sizeof(BrickPageEntry)));
+        brickDataStart = static_cast<uint64_t>(file.tellg());
+        if (!file) {
+            std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+            LOG(ERROR) << "Could not read the page table of bricked volume '" << converter.from_bytes(filename) << "'.";
+            throw std::runtime_error("Could not read the page table of bricked volume '" + filename + "'.");
+        }
+
+        auto brickDataSize = fileSize - brickDataStart;
+        for (uint64_t i = 0; i < numPageEntries; ++i) {
+            const auto& entry = pageTable[static_cast<std::size_t>(i)];
+            auto extent = GetBrickExtent(GetBrickCoordinates(i));
+            auto expectedSize = static_cast<uint64_t>(extent.x) * extent.y * extent.z * layout.bytesPerVoxel;
+            if (entry.size != expectedSize || entry.offset > brickDataSize || entry.size > brickDataSize - entry.offset) {
+                std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+                LOG(ERROR) << "Page table entry " << i << " of bricked volume '" << converter.from_bytes(filename)
+                    << "' lies outside of the file or has the wrong size.";
+                throw std::runtime_error("The page table of bricked volume '" + filename + "' is invalid.");
+            }
+        }
+    }
+
+    /** Default move constructor. */
+    BrickedVolume::BrickedVolume(BrickedVolume&& rhs) :
+        filename(std::move(rhs.filename)),
+        file(std::move(rhs.file)),
+        brickDataStart(rhs.brickDataStart),
+        sourceKey(rhs.sourceKey),
+        layout(rhs.layout),
+        brickSize(rhs.brickSize),
+        numBricks(rhs.numBricks),
+        pageTable(std::move(rhs.pageTable))
+    {
+    }
+
+    /** Default move assignment operator. */
+    BrickedVolume& BrickedVolume::operator=(BrickedVolume&& rhs)
+    {
+        if (this != &rhs) {
+            filename = std::move(rhs.filename);
+            file = std::move(rhs.file);
+            brickDataStart = rhs.brickDataStart;
+            sourceKey = rhs.sourceKey;
+            layout = rhs.layout;
+            brickSize = rhs.brickSize;
+            numBricks = rhs.numBricks;
+            pageTable = std::move(rhs.pageTable);
+        }
+        return *this;
+    }
+
+    /** Destructor. */
+    BrickedVolume::~BrickedVolume() = default;
+
+    /**
+     *  Returns the page table entry of a brick.
+     *  @param brick the coordinates of the brick.
+     *  @return the page table entry.
+     */
+    const BrickPageEntry& BrickedVolume::GetPageEntry(const glm::uvec3& brick) const
+    {
+        return pageTable[static_cast<std::size_t>(GetBrickIndex(brick))];
+    }
+
+    /**
+     *  Returns the linear index of a brick.
+     *  @param brick the coordinates of the brick.
+     *  @return the linear index.
+     */
+    uint64_t BrickedVolume::GetBrickIndex(const glm::uvec3& brick) const
+    {
+        if (!glm::all(glm::lessThan(brick, numBricks))) {
+            LOG(ERROR) << "Brick (" << brick.x << ", " << brick.y << ", " << brick.z << ") is outside of the volume ("
+                << numBricks.x << ", " << numBricks.y << ", " << numBricks.z << " bricks).";
+            throw std::runtime_error("Brick is outside of the volume.");
+        }
+        return (static_cast<uint64_t>(brick.z) * numBricks.y + brick.y) * numBricks.x + brick.x;
+    }
+
+    /**
+     *  Writes a bricked volume file from volume data.
+     *  The source is read brick by brick, so memory mapped sources larger than the main memory can be converted.
+     *  The data is written to a temporary file first, which replaces the bricked volume when it is complete.
+     *  @param bvolFilename the file name of the bricked volume to create.
+     *  @param view the volume data.
+     *  @param brickSize the size of a single brick.
+     *  @param sourceKey the key identifying the source data (e.g. a content hash).
+     */
+    void BrickedVolume::CreateFromView(const std::string& bvolFilename, const VolumeDataView& view, const glm::uvec3& brickSize, uint64_t sourceKey)
+    {
+        if (glm::any(glm::equal(brickSize, glm::uvec3(0)))) {
+            LOG(ERROR) << "Bricks need a size of at least one voxel.";
+            throw std::runtime_error("Bricks need a size of at least one voxel.");
+        }
+
+        auto tmpFilename = bvolFilename + ".tmp";
+        std::ofstream ofs(tmpFilename, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!ofs.is_open()) {
+            std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+            LOG(ERROR) << "Could not open file '" << converter.from_bytes(tmpFilename) << "'.";
+            throw std::runtime_error("Could not open file '" + tmpFilename + "'.");
+        }
+
+        auto numBricks = (view.size + brickSize - glm::uvec3(1)) / brickSize;
+        std::vector<BrickPageEntry> pageTable(static_cast<std::size_t>(numBricks.x) * numBricks.y * numBricks.z);
+        auto bpv = static_cast<uint64_t>(view.bytesPerVoxel);
+        uint64_t currentOffset = 0;
+        for (std::size_t i = 0; i < pageTable.size(); ++i) {
+            glm::uvec3 brick(i % numBricks.x, (i / numBricks.x) % numBricks.y, i / (static_cast<std::size_t>(numBricks.x) * numBricks.y));
+            auto extent = glm::min(brickSize, view.size - brick * brickSize);
+            pageTable[i].offset = currentOffset;
+            pageTable[i].size = static_cast<uint64_t>(extent.x) * extent.y * extent.z * bpv;
+            currentOffset += pageTable[i].size;
+        }
+
+        VersionableSerializerType::writeHeader(ofs);
+        serializeHelper::write(ofs, sourceKey);
+        serializeHelper::write(ofs, view.size);
+        serializeHelper::write(ofs, brickSize);
+        serializeHelper::write(ofs, view.bytesPerVoxel);
+        serializeHelper::write(ofs, view.numComponents);
+        serializeHelper::write(ofs, static_cast<uint32_t>(view.type));
+        serializeHelper::write(ofs, view.scaleValue);
+        serializeHelper::writeV(ofs, pageTable);
+
+        std::vector<uint8_t> brickData(static_cast<std::size_t>(brickSize.x) * brickSize.y * brickSize.z * bpv);
+        for (std::size_t i = 0; i < pageTable.size(); ++i) {
+            glm::uvec3 brick(i % numBricks.x, (i / numBricks.x) % numBricks.y, i / (static_cast<std::size_t>(numBricks.x) * numBricks.y));
+            auto origin = brick * brickSize;
+            auto extent = glm::min(brickSize, view.size - origin);
+            auto rowSize = extent.x * bpv;
+
+            auto dst = brickData.data();
+            for (unsigned int z = 0; z < extent.z; ++z) {
+                for (unsigned int y = 0; y < extent.y; ++y) {
+                    auto src = view.GetVoxel(origin + glm::uvec3(0, y, z));
+                    if (view.IsContiguous()) std::memcpy(dst, src, rowSize);
+                    else for (unsigned int x = 0; x < extent.x; ++x) std::memcpy(dst + x * bpv, src + x * view.voxelStride, bpv);
+                    dst += rowSize;
+                }
+            }
+            ofs.write(reinterpret_cast<const char*>(brickData.data()), pageTable[i].size);
+        }
+
+        ofs.close();
+        if (!ofs) {
+            boost::system::error_code ec;
+            boost::filesystem::remove(tmpFilename, ec);
+            std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+            LOG(ERROR) << "Could not write bricked volume '" << converter.from_bytes(bvolFilename) << "'.";
+            throw std::runtime_error("Could not write bricked volume '" + bvolFilename + "'.");
+        }
+        boost::filesystem::rename(tmpFilename, bvolFilename);
+    }
+
+    /**
+     *  Reads a single brick from disk.
+     *  @param brick the coordinates of the brick.
+     *  @param data the tightly packed voxels of the brick (output).
+     */
+    void BrickedVolume::ReadBrick(const glm::uvec3& brick, std::vector<uint8_t>& data)
+    {
+        const auto& entry = GetPageEntry(brick);
+        data.resize(static_cast<std::size_t>(entry.size));
+        file.clear();
+        file.seekg(static_cast<std::streamoff>(brickDataStart + entry.offset), std::ios::beg);
+        file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(entry.size));
+        if (!file) {
+            std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+            LOG(ERROR) << "Could not read brick (" << brick.x << ", " << brick.y << ", " << brick.z << ") from '"
+                << converter.from_bytes(filename) << "'.";
+            throw std::runtime_error("Could not read brick from '" + filename + "'.");
+        }
+    }
+
+    /**
+     *  Returns a view on the data of a brick.
+     *  @param brick the coordinates of the brick.
+     *  @param data the bricks data as read by ReadBrick.
+     *  @return the view on the brick.
+     */
+    VolumeDataView BrickedVolume::GetBrickView(const glm::uvec3& brick, const std::vector<uint8_t>& data) const
+    {
+        auto view = layout;
+        view.size = GetBrickExtent(brick);
+        view.data = data.data();
+        if (data.size() < GetPageEntry(brick).size) {
+            LOG(ERROR) << "Brick data is too small for brick (" << brick.x << ", " << brick.y << ", " << brick.z << ").";
+            throw std::runtime_error("Brick data is too small.");
+        }
+        return view;
+    }
+
+    /**
+     *  Constructor.
+     *  @param volume the bricked volume to cache.
+     *  @param memoryBudget the maximum number of bytes the cached bricks may use.
+     */
+    BrickCache::BrickCache(BrickedVolume* volume, uint64_t memoryBudget) :
+        volume(volume),
+        memoryBudget(memoryBudget),
+        memoryUsage(0)
+    {
+    }
+
+    /** Default move constructor. */
+    BrickCache::BrickCache(BrickCache&& rhs) :
+        volume(rhs.volume),
+        memoryBudget(rhs.memoryBudget),
+        memoryUsage(rhs.memoryUsage),
+        lruList(std::move(rhs.lruList)),
+        entries(std::move(rhs.entries)),
+        stats(rhs.stats)
+    {
+        rhs.memoryUsage = 0;
+    }
+
+    /** Default move assignment operator. */
+    BrickCache& BrickCache::operator=(BrickCache&& rhs)
+    {
+        if (this != &rhs) {
+            volume = rhs.volume;
+            memoryBudget = rhs.memoryBudget;
+            memoryUsage = rhs.memoryUsage;
+            lruList = std::move(rhs.lruList);
+            entries = std::move(rhs.entries);
+            stats = rhs.stats;
+            rhs.memoryUsage = 0;
+        }
+        return *this;
+    }
+
+    /** Destructor. */
+    BrickCache::~BrickCache() = default;
+
+    /**
+     *  Returns a brick, loading it if it is not resident.
+     *  @param brick the coordinates of the brick.
+     *  @return the bricks data.
+     */
+    std::shared_ptr<const BrickCache::BrickData> BrickCache::GetBrick(const glm::uvec3& brick)
+    {
+        auto idx = volume->GetBrickIndex(brick);
+        auto it = entries.find(idx);
+        if (it != entries.end()) {
+            ++stats.hits;
+            Touch(it->second);
+            return it->second.data;
+        }
+
+        ++stats.misses;
+        return LoadBrick(idx);
+    }
+
+    /**
+     *  Returns a brick if it is resident without loading it or changing its LRU position.
+     *  @param brick the coordinates of the brick.
+     *  @return the bricks data or nullptr if it is not resident.
+     */
+    std::shared_ptr<const BrickCache::BrickData> BrickCache::FindBrick(const glm::uvec3& brick) const
+    {
+        auto it = entries.find(volume->GetBrickIndex(brick));
+        if (it == entries.end()) return nullptr;
+        return it->second.data;
+    }
+
+    /**
+     *  Loads a list of bricks in the given order (the first brick has the highest priority).
+     *  Resident bricks are only marked as used. Loading stops as soon as the next brick would evict a brick requested
+     *  by the same call.
+     *  @param bricks the coordinates of the bricks to load.
+     *  @return the number of bricks loaded from disk.
+     */
+    unsigned int BrickCache::Prefetch(const std::vector<glm::uvec3>& bricks)
+    {
+        unsigned int numLoaded = 0;
+        uint64_t requestedSize = 0;
+        for (const auto& brick : bricks) {
+            auto idx = volume->GetBrickIndex(brick);
+            auto it = entries.find(idx);
+            if (it != entries.end()) {
+                Touch(it->second);
+                requestedSize += it->second.data->size();
+                continue;
+            }
+
+            auto brickSize = volume->GetPageEntry(brick).size;
+            if (requestedSize + brickSize > memoryBudget) break;
+            LoadBrick(idx);
+            requestedSize += brickSize;
+            ++numLoaded;
+        }
+        return numLoaded;
+    }
+
+    /**
+     *  Checks if a brick is resident.
+     *  @param brick the coordinates of the brick.
+     *  @return whether the brick is in the cache.
+     */
+    bool BrickCache::IsResident(const glm::uvec3& brick) const
+    {
+        return entries.find(volume->GetBrickIndex(brick)) != entries.end();
+    }
+
+    /**
+     *  Sets a new memory budget and evicts bricks until it is met.
+     *  @param budget the new memory budget in bytes.
+     */
+    void BrickCache::SetMemoryBudget(uint64_t budget)
+    {
+        memoryBudget = budget;
+        EvictToFit(0);
+    }
+
+    /** Removes all bricks from the cache. */
+    void BrickCache::Clear()
+    {
+        entries.clear();
+        lruList.clear();
+        memoryUsage = 0;
+    }
+
+    /**
+     *  Marks a cache entry as most recently used.
+     *  @param entry the entry to mark.
+     */
+    void BrickCache::Touch(CacheEntry& entry)
+    {
+        lruList.splice(lruList.begin(), lruList, entry.lruPosition);
+    }
+
+    /**
+     *  Evicts least recently used bricks until a new brick fits into the budget.
+     *  @param size the size of the new brick.
+     */
+    void BrickCache::EvictToFit(uint64_t size)
+    {
+        while (!lruList.empty() && memoryUsage + size > memoryBudget) {
+            auto it = entries.find(lruList.back());
+            memoryUsage -= it->second.data->size();
+            entries.erase(it);
+            lruList.pop_back();
+            ++stats.evictions;
+        }
+    }
+
+    /**
+     *  Loads a brick from disk and inserts it into the cache.
+     *  @param idx the linear index of the brick.
+     *  @return the bricks data.
+     */
+    std::shared_ptr<BrickCache::BrickData> BrickCache::LoadBrick(uint64_t idx)
+    {
+        auto brick = volume->GetBrickCoordinates(idx);
+        EvictToFit(volume->GetPageEntry(brick).size);
+
+        auto data = std::make_shared<BrickData>();
+        volume->ReadBrick(brick, *data);
+        stats.bytesRead += data->size();
+
+        lruList.push_front(idx);
+        entries.emplace(idx, CacheEntry{ data, lruList.begin() });
+        memoryUsage += data->size();
+        return data;
+    }
+}
@@ -0,0 +1,186 @@
+/**
+ * @file   BrickedVolume.h
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Contains the bricked on-disk volume format and its brick cache.
+ */
+
+#ifndef BRICKEDVOLUME_H
+#define BRICKEDVOLUME_H
+
+#include "main.h"
+#include "gfx/volumes/RawVolumeSource.h"
+#include "core/serializationHelper.h"
+#include <fstream>
+
+namespace cgu {
+
+    /** Describes where a single brick is stored in a bricked volume file. */
+    struct BrickPageEntry
+    {
+        /** Holds the offset of the brick relative to the start of the brick data. */
+        uint64_t offset;
+        /** Holds the size of the brick in bytes. */
+        uint64_t size;
+    };
+
+    /**
+     *  @brief Volume stored as bricks on disk.
+     *  The file contains a header, a page table with one entry per brick (x runs fastest) and the bricks themselves.
+     *  Each brick is stored tightly packed, bricks at the upper borders of the volume are clipped to the volume.
+     *  The header holds a key of the source data, so files created from older data can be detected. Files are
+     *  written to a temporary file that is renamed when complete, the page table is checked against the file size.
+     *
+     * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+     * @date   2026.10.16
+     */
+    class BrickedVolume
+    {
+    public:
+        using VersionableSerializerType = serializeHelper::VersionableSerializer<'B', 'V', 'O', 'L', 1002>;
+
+        explicit BrickedVolume(const std::string& bvolFilename);
+        BrickedVolume(const BrickedVolume&) = delete;
+        BrickedVolume& operator=(const BrickedVolume&) = delete;
+        BrickedVolume(BrickedVolume&&);
+        BrickedVolume& operator=(BrickedVolume&&);
+        ~BrickedVolume();
+
+        static void CreateFromView(const std::string& bvolFilename, const VolumeDataView& view, const glm::uvec3& brickSize,
+            uint64_t sourceKey = 0);
+
+        void ReadBrick(const glm::uvec3& brick, std::vector<uint8_t>& data);
+        VolumeDataView GetBrickView(const glm::uvec3& brick, const std::vector<uint8_t>& data) const;
+
+        /** Returns the size of the whole volume. */
+        const glm::uvec3& GetVolumeSize() const { return layout.size; }
+        /** Returns the (maximum) size of a brick. */
+        const glm::uvec3& GetBrickSize() const { return brickSize; }
+        /** Returns the number of bricks in each dimension. */
+        const glm::uvec3& GetNumBricks() const { return numBricks; }
+        /** Returns the total number of bricks. */
+        uint64_t GetNumBricksTotal() const { return pageTable.size(); }
+        /** Returns the layout of the voxels (the data pointer is not set). */
+        const VolumeDataView& GetLayout() const { return layout; }
+        /** Returns the key of the data the file was created from. */
+        uint64_t GetSourceKey() const { return sourceKey; }
+        const BrickPageEntry& GetPageEntry(const glm::uvec3& brick) const;
+        uint64_t GetBrickIndex(const glm::uvec3& brick) const;
+        /** Returns the brick coordinates from a linear index. */
+        glm::uvec3 GetBrickCoordinates(uint64_t idx) const
+        {
+            return glm::uvec3(idx % numBricks.x, (idx / numBricks.x) % numBricks.y, idx / (static_cast<uint64_t>(numBricks.x) * numBricks.y));
+        }
+        /** Returns the position of a bricks first voxel in the volume. */
+        glm::uvec3 GetBrickOrigin(const glm::uvec3& brick) const { return brick * brickSize; }
+        /** Returns the actual size of a brick (clipped at the volume border). */
+        glm::uvec3 GetBrickExtent(const glm::uvec3& brick) const { return glm::min(brickSize, layout.size - GetBrickOrigin(brick)); }
+
+    private:
+        /** Holds the file name of the bricked volume. */
+        std::string filename;
+        /** Holds the file stream the bricks are read from. */
+        std::ifstream file;
+        /** Holds the position of the first brick in the file. */
+        uint64_t brickDataStart;
+        /** Holds the key of the data the file was created from. */
+        uint64_t sourceKey;
+        /** Holds the layout of the voxels. */
+        VolumeDataView layout;
+        /** Holds the size of a brick. */
+        glm::uvec3 brickSize;
+        /** Holds the number of bricks. */
+        glm::uvec3 numBricks;
+        /** Holds the page table. */
+        std::vector<BrickPageEntry> pageTable;
+    };
+
+    /** Statistics of a brick cache. */
+    struct BrickCacheStatistics
+    {
+        /** Holds the number of requests that were served from the cache. */
+        uint64_t hits = 0;
+        /** Holds the number of requests that needed to load a brick. */
+        uint64_t misses = 0;
+        /** Holds the number of bricks evicted from the cache. */
+        uint64_t evictions = 0;
+        /** Holds the number of bytes read from disk. */
+        uint64_t bytesRead = 0;
+    };
+
+    /**
+     *  @brief CPU side LRU cache for the bricks of a bricked volume.
+     *  The cache keeps bricks until their total size exceeds the memory budget, the least recently used bricks are
+     *  evicted first. Bricks handed out are shared, an evicted brick stays valid as long as it is referenced.
+     *  The cache is not thread safe.
+     *
+     * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+     * @date   2026.10.16
+     */
+    class BrickCache
+    {
+    public:
+        /** The type used for the data of a brick. */
+        using BrickData = std::vector<uint8_t>;
+
+        BrickCache(BrickedVolume* volume, uint64_t memoryBudget);
+        BrickCache(const BrickCache&) = delete;
+        BrickCache& operator=(const BrickCache&) = delete;
+        BrickCache(BrickCache&&);
+        BrickCache& operator=(BrickCache&&);
+        ~BrickCache();
+
+        std::shared_ptr<const BrickData> GetBrick(const glm::uvec3& brick);
+        std::shared_ptr<const BrickData> FindBrick(const glm::uvec3& brick) const;
+        unsigned int Prefetch(const std::vector<glm::uvec3>& bricks);
+        bool IsResident(const glm::uvec3& brick) const;
+        void SetMemoryBudget(uint64_t budget);
+        void Clear();
+
+        /** Returns the memory budget in bytes. */
+        uint64_t GetMemoryBudget() const { return memoryBudget; }
+        /** Returns the number of bytes used by the cached bricks. */
+        uint64_t GetMemoryUsage() const { return memoryUsage; }
+        /** Returns the number of cached bricks. */
+        std::size_t GetNumResidentBricks() const { return entries.size(); }
+        /** Returns the cache statistics. */
+        const BrickCacheStatistics& GetStatistics() const { return stats; }
+        /** Resets the cache statistics. */
+        void ResetStatistics() { stats = BrickCacheStatistics(); }
+        /** Returns the bricked volume. */
+        BrickedVolume* GetVolume() const { return volume; }
+
+    private:
+        /** The list of brick indices in least recently used order (most recent first). */
+        using LRUList = std::list<uint64_t>;
+
+        /** A cached brick. */
+        struct CacheEntry
+        {
+            /** Holds the bricks data. */
+            std::shared_ptr<BrickData> data;
+            /** Holds the position of the brick in the LRU list. */
+            LRUList::iterator lruPosition;
+        };
+
+        void Touch(CacheEntry& entry);
+        void EvictToFit(uint64_t size);
+        std::shared_ptr<BrickData> LoadBrick(uint64_t idx);
+
+        /** Holds the bricked volume. */
+        BrickedVolume* volume;
+        /** Holds the memory budget in bytes. */
+        uint64_t memoryBudget;
+        /** Holds the memory currently used. */
+        uint64_t memoryUsage;
+        /** Holds the LRU list. */
+        LRUList lruList;
+        /** Holds the cached bricks. */
+        std::unordered_map<uint64_t, CacheEntry> entries;
+        /** Holds the statistics. */
+        BrickCacheStatistics stats;
+    };
+}
+
+#endif // BRICKEDVOLUME_H
@@ -0,0 +1,294 @@
+/**
+ * @file   CPURayCaster.cpp
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Implementation of the CPU reference volume ray caster.
+ */
+
+#include "CPURayCaster.h"
+#include "gfx/volumes/Volume.h"
+#include "gfx/volumes/MinMaxPyramid.h"
+#include "volumeScene/TransferFunction.h"
+#include "core/parallel_helper.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <stb_image_write.h>
+
+namespace cgu {
+
+    /** The reference sampling interval opacities are corrected to (REF_SAMPLING_INTERVAL in renderVolume.fp). */
+    static const float refSamplingInterval = 150.0f;
+
+    /**
+     *  Constructor, loads the volume data and its mip levels.
+     *  @param volume the volume to render.
+     *  @param numThreads the number of threads to use (0 to use all hardware threads).
+     */
+    CPURayCaster::CPURayCaster(const std::shared_ptr<const Volume>& volume, unsigned int numThreads) :
+        format(VolumeStorageFormat::UNORM8),
+        numThreads(numThreads)
+    {
+        VolumeStorageFormat volumeFormat;
+        Initialize(volume->GetMinMaxPyramid(volumeFormat), volume->GetScaling());
+    }
+
+    /**
+     *  Constructor for volume data already in memory.
+     *  @param volumePyramid the average pyramid of the volume including its level 0 data (see MinMaxPyramid::SetLevel0Data).
+     *  @param scaling the size of a voxel.
+     *  @param numThreads the number of threads to use (0 to use all hardware threads).
+     */
+    CPURayCaster::CPURayCaster(std::unique_ptr<MinMaxPyramid> volumePyramid, const glm::vec3& scaling, unsigned int numThreads) :
+        format(VolumeStorageFormat::UNORM8),
+        numThreads(numThreads)
+    {
+        Initialize(std::move(volumePyramid), scaling);
+    }
+
+    /**
+     *  Takes the level 0 data and the mip levels from a pyramid.
+     *  @param volumePyramid the average pyramid of the volume including its level 0 data.
+     *  @param scaling the size of a voxel.
+     */
+    void CPURayCaster::Initialize(std::unique_ptr<MinMaxPyramid> volumePyramid, const glm::vec3& scaling)
+    {
+        pyramid = std::move(volumePyramid);
+        format = pyramid->GetFormat();
+        const auto& volumeSize = pyramid->GetLevelSize(0);
+        auto texMax = static_cast<float>(glm::max(glm::max(volumeSize.x, volumeSize.y), volumeSize.z));
+        voxelScale = scaling * glm::vec3(volumeSize) / texMax;
+
+        level0 = pyramid->ReleaseLevel0Data();
+        assert(level0.size() == static_cast<std::size_t>(volumeSize.x) * volumeSize.y * volumeSize.z * volumeStorage::GetElementSize(format));
+        for (unsigned int lvl = 0; lvl < pyramid->GetNumLevels(); ++lvl) levelSizes.push_back(pyramid->GetLevelSize(lvl));
+        stepSizes = pyramid->GetStepSizes();
+    }
+
+    /** Default move constructor. */
+    CPURayCaster::CPURayCaster(CPURayCaster&&) = default;
+    /** Default move assignment operator. */
+    CPURayCaster& CPURayCaster::operator=(CPURayCaster&&) = default;
+    /** Destructor. */
+    CPURayCaster::~CPURayCaster() = default;
+
+    /**
+     *  Sets the transfer function from a transfer function object.
+     *  @param transferFunction the transfer function.
+     *  @param resolution the resolution of the table (the transfer function texture has 512 entries).
+     */
+    void CPURayCaster::SetTransferFunction(const tf::TransferFunction& transferFunction, unsigned int resolution)
+    {
+        std::vector<glm::vec4> table(resolution);
+        transferFunction.CreateTextureData(table.data(), static_cast<int>(resolution));
+        SetTransferFunctionTable(table);
+    }
+
+    /**
+     *  Sets the transfer function table directly.
+     *  @param table the table as it would be uploaded to the transfer function texture.
+     */
+    void CPURayCaster::SetTransferFunctionTable(const std::vector<glm::vec4>& table)
+    {
+        assert(!table.empty());
+        tfTable = table;
+    }
+
+    /**
+     *  Returns the matrix transforming the unit cube to the volume in world space (see MinMaxVolume).
+     *  @param world the world matrix of the volume.
+     *  @return the local world matrix.
+     */
+    glm::mat4 CPURayCaster::GetLocalWorld(const glm::mat4& world) const
+    {
+        return glm::scale(glm::translate(world, -0.5f * voxelScale), voxelScale);
+    }
+
+    /**
+     *  Renders an image of the volume.
+     *  @param params the rendering parameters.
+     *  @param image the rendered image (bottom row first).
+     */
+    void CPURayCaster::Render(const CPURayCastParameters& params, std::vector<glm::vec4>& image) const
+    {
+        assert(!tfTable.empty());
+        const auto& imageSize = params.imageSize;
+        image.assign(static_cast<std::size_t>(imageSize.x) * imageSize.y, params.backgroundColor);
+
+        auto lodLevel = glm::clamp(params.lodLevel, 0.0f, static_cast<float>(GetNumLevels() - 1));
+        auto stepSize = params.stepSize > 0.0f ? params.stepSize : stepSizes[static_cast<unsigned int>(lodLevel)];
+        auto inverseMVP = glm::inverse(params.viewProjection * GetLocalWorld(params.world));
+
+        auto tileSize = glm::max(params.tileSize, 1U);
+        glm::uvec2 numTiles((imageSize + glm::uvec2(tileSize - 1)) / tileSize);
+        parallel::ForChunks(static_cast<uint64_t>(numTiles.x) * numTiles.y, 1, [&](uint64_t begin, uint64_t end, unsigned int)
+        {
+            for (auto tile = begin; tile < end; ++tile) {
+                glm::uvec2 tileStart(static_cast<unsigned int>(tile % numTiles.x) * tileSize, static_cast<unsigned int>(tile / numTiles.x) * tileSize);
+                auto tileEnd = glm::min(tileStart + glm::uvec2(tileSize), imageSize);
+                for (auto y = tileStart.y; y < tileEnd.y; ++y) {
+                    for (auto x = tileStart.x; x < tileEnd.x; ++x) {
+                        auto ndc = 2.0f * (glm::vec2(x, y) + glm::vec2(0.5f)) / glm::vec2(imageSize) - glm::vec2(1.0f);
+                        auto nearPos = inverseMVP * glm::vec4(ndc, -1.0f, 1.0f);
+                        auto farPos = inverseMVP * glm::vec4(ndc, 1.0f, 1.0f);
+                        auto origin = glm::vec3(nearPos) / nearPos.w;
+                        auto dir = glm::vec3(farPos) / farPos.w - origin;
+
+                        auto tNear = std::numeric_limits<float>::lowest();
+                        auto tFar = std::numeric_limits<float>::max();
+                        auto hit = true;
+                        for (int i = 0; i < 3 && hit; ++i) {
+                            if (dir[i] == 0.0f) {
+                                hit = origin[i] >= 0.0f && origin[i] <= 1.0f;
+                                continue;
+                            }
+                            auto t0 = -origin[i] / dir[i];
+                            auto t1 = (1.0f - origin[i]) / dir[i];
+                            if (t0 > t1) std::swap(t0, t1);
+                            tNear = glm::max(tNear, t0);
+                            tFar = glm::min(tFar, t1);
+                        }
+                        // front faces clipped by the near plane are not rasterized on the GPU either.
+                        tFar = glm::min(tFar, 1.0f);
+                        if (!hit || tNear < 0.0f || tNear >= tFar) continue;
+
+                        image[static_cast<std::size_t>(y) * imageSize.x + x] = CastRay(origin + dir * tNear, origin + dir * tFar, stepSize, lodLevel);
+                    }
+                }
+            }
+        }, numThreads);
+    }
+
+    /**
+     *  Casts a single ray through the volume like renderVolume.fp.
+     *  @param rayStart the start position of the ray in texture coordinates.
+     *  @param rayEnd the end position of the ray in texture coordinates.
+     *  @param stepSize the step size in texture coordinates.
+     *  @param lodLevel the mip level to sample.
+     *  @return the composited color (alpha is always 1 like in the shader).
+     */
+    glm::vec4 CPURayCaster::CastRay(const glm::vec3& rayStart, const glm::vec3& rayEnd, float stepSize, float lodLevel) const
+    {
+        return volumeStorage::WithStorage(format, [this, &rayStart, &rayEnd, stepSize, lodLevel](auto storage)
+        {
+            return this->CastRayStorage<decltype(storage)>(rayStart, rayEnd, stepSize, lodLevel);
+        });
+    }
+
+    template<typename S>
+    glm::vec4 CPURayCaster::CastRayStorage(const glm::vec3& rayStart, const glm::vec3& rayEnd, float stepSize, float lodLevel) const
+    {
+        auto rayDir = rayEnd - rayStart;
+        auto t1 = glm::min(glm::length(rayDir), glm::length(glm::vec3(1.0f)));
+        if (t1 <= 0.0f) return glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+        rayDir /= t1;
+
+        auto C = glm::vec3(0.0f);
+        auto A = 0.0f;
+        auto alphaExponent = stepSize * refSamplingInterval;
+        for (auto t = 0.0f; t < t1 && A < 1.0f; t += stepSize) {
+            auto s = SampleStorage<S>(rayStart + rayDir * t, lodLevel);
+            auto color = LookupTransferFunction(s);
+            color.w = 1.0f - glm::pow(1.0f - color.w, alphaExponent);
+
+            C += (1.0f - A) * color.w * glm::vec3(color);
+            A += (1.0f - A) * color.w;
+        }
+        return glm::vec4(C, 1.0f);
+    }
+
+    /**
+     *  Samples the volume with trilinear filtering and linear filtering between mip levels.
+     *  @param position the position in texture coordinates.
+     *  @param lodLevel the mip level.
+     *  @return the sampled value.
+     */
+    float CPURayCaster::Sample(const glm::vec3& position, float lodLevel) const
+    {
+        return volumeStorage::WithStorage(format, [this, &position, lodLevel](auto storage)
+        {
+            return this->SampleStorage<decltype(storage)>(position, lodLevel);
+        });
+    }
+
+    template<typename S>
+    float CPURayCaster::SampleStorage(const glm::vec3& position, float lodLevel) const
+    {
+        lodLevel = glm::clamp(lodLevel, 0.0f, static_cast<float>(GetNumLevels() - 1));
+        auto level = static_cast<unsigned int>(lodLevel);
+        auto levelFraction = lodLevel - static_cast<float>(level);
+        auto value = SampleLevel<S>(level, position);
+        if (levelFraction > 0.0f) value = glm::mix(value, SampleLevel<S>(level + 1, position), levelFraction);
+        return value;
+    }
+
+    template<typename S>
+    float CPURayCaster::SampleLevel(unsigned int level, const glm::vec3& position) const
+    {
+        using T = typename S::Type;
+        const auto& size = levelSizes[level];
+        auto data = reinterpret_cast<const T*>(level == 0 ? level0.data() : pyramid->GetLevelData(level).data());
+
+        auto coords = position * glm::vec3(size) - glm::vec3(0.5f);
+        auto base = glm::floor(coords);
+        auto f = coords - base;
+        auto maxPos = glm::ivec3(size) - glm::ivec3(1);
+        auto p0 = glm::clamp(glm::ivec3(base), glm::ivec3(0), maxPos);
+        auto p1 = glm::clamp(glm::ivec3(base) + glm::ivec3(1), glm::ivec3(0), maxPos);
+
+        auto load = [data, &size](int x, int y, int z)
+        {
+            return S::Load(data[(static_cast<std::size_t>(z) * size.y + y) * size.x + x]);
+        };
+        auto v00 = glm::mix(load(p0.x, p0.y, p0.z), load(p1.x, p0.y, p0.z), f.x);
+        auto v10 = glm::mix(load(p0.x, p1.y, p0.z), load(p1.x, p1.y, p0.z), f.x);
+        auto v01 = glm::mix(load(p0.x, p0.y, p1.z), load(p1.x, p0.y, p1.z), f.x);
+        auto v11 = glm::mix(load(p0.x, p1.y, p1.z), load(p1.x, p1.y, p1.z), f.x);
+        return glm::mix(glm::mix(v00, v10, f.y), glm::mix(v01, v11, f.y), f.z);
+    }
+
+    /**
+     *  Looks up a value in the transfer function table with linear filtering and clamp to edge.
+     *  @param value the value.
+     *  @return the color and opacity.
+     */
+    glm::vec4 CPURayCaster::LookupTransferFunction(float value) const
+    {
+        auto tableSize = static_cast<int>(tfTable.size());
+        auto coord = value * static_cast<float>(tableSize) - 0.5f;
+        auto base = glm::floor(coord);
+        auto f = coord - base;
+        auto i0 = glm::clamp(static_cast<int>(base), 0, tableSize - 1);
+        auto i1 = glm::clamp(static_cast<int>(base) + 1, 0, tableSize - 1);
+        return glm::mix(tfTable[i0], tfTable[i1], f);
+    }
+
+    /**
+     *  Converts an image to 8 bit RGBA the way OpenGL stores normalized values.
+     *  @param image the image.
+     *  @param rgba8 the converted image.
+     */
+    void CPURayCaster::ConvertToRGBA8(const std::vector<glm::vec4>& image, std::vector<uint8_t>& rgba8)
+    {
+        rgba8.resize(image.size() * 4);
+        for (std::size_t i = 0; i < image.size(); ++i) {
+            for (int c = 0; c < 4; ++c) rgba8[4 * i + c] = volumeStorage::Unorm8::Store(image[i][c]);
+        }
+    }
+
+    /**
+     *  Saves an image to a png file (top row first like GLTexture::SaveTextureToFile).
+     *  @param filename the file name.
+     *  @param image the image.
+     *  @param imageSize the size of the image.
+     */
+    void CPURayCaster::SaveToFile(const std::string& filename, const std::vector<glm::vec4>& image, const glm::uvec2& imageSize)
+    {
+        std::vector<uint8_t> rgba8;
+        ConvertToRGBA8(image, rgba8);
+        auto stride = imageSize.x * 4;
+        for (unsigned int i = 0; i < imageSize.y / 2; ++i) {
+            std::swap_ranges(rgba8.begin() + i * stride, rgba8.begin() + (i + 1) * stride, rgba8.begin() + (imageSize.y - i - 1) * stride);
+        }
+        stbi_write_png(filename.c_str(), imageSize.x, imageSize.y, 4, rgba8.data(), stride * sizeof(uint8_t));
+    }
+}
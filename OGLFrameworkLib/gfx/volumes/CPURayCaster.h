@@ -0,0 +1,105 @@
+/**
+ * @file   CPURayCaster.h
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Contains a CPU reference implementation of the volume ray caster.
+ */
+
+#ifndef CPURAYCASTER_H
+#define CPURAYCASTER_H
+
+#include "main.h"
+#include "gfx/volumes/VolumeStorage.h"
+
+namespace cgu {
+
+    class Volume;
+    class MinMaxPyramid;
+    namespace tf {
+        class TransferFunction;
+    }
+
+    /** Parameters of a single image rendered by the CPU ray caster. */
+    struct CPURayCastParameters
+    {
+        /** Holds the size of the image in pixels. */
+        glm::uvec2 imageSize = glm::uvec2(512);
+        /** Holds the view projection matrix of the camera. */
+        glm::mat4 viewProjection = glm::mat4(1.0f);
+        /** Holds the world matrix of the volume (the volume is centered and scaled like in MinMaxVolume). */
+        glm::mat4 world = glm::mat4(1.0f);
+        /** Holds the step size in texture coordinates (0 uses the step size of the mip level). */
+        float stepSize = 0.0f;
+        /** Holds the mip level sampled. */
+        float lodLevel = 0.0f;
+        /** Holds the color of pixels not covered by the volume. */
+        glm::vec4 backgroundColor = glm::vec4(0.0f);
+        /** Holds the size of the tiles handed to the threads. */
+        unsigned int tileSize = 16;
+    };
+
+    /**
+     *  @brief CPU reference implementation of the volume ray caster.
+     *  Rays are set up like VolumeCubeRenderable does on the GPU (front faces to back faces of the unit cube) and
+     *  sampled and composited by the rules of renderVolume.fp: trilinear filtering with clamp to edge and linear
+     *  filtering between mip levels, a linearly filtered transfer function table, opacity correction to the reference
+     *  sampling interval and front to back compositing until the ray leaves the volume or is opaque.
+     *  Images are stored bottom up like OpenGL textures, tiles are rendered in parallel.
+     *
+     * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+     * @date   2026.10.16
+     */
+    class CPURayCaster
+    {
+    public:
+        explicit CPURayCaster(const std::shared_ptr<const Volume>& volume, unsigned int numThreads = 0);
+        CPURayCaster(std::unique_ptr<MinMaxPyramid> volumePyramid, const glm::vec3& scaling, unsigned int numThreads = 0);
+        CPURayCaster(const CPURayCaster&) = delete;
+        CPURayCaster& operator=(const CPURayCaster&) = delete;
+        CPURayCaster(CPURayCaster&&);
+        CPURayCaster& operator=(CPURayCaster&&);
+        ~CPURayCaster();
+
+        void SetTransferFunction(const tf::TransferFunction& transferFunction, unsigned int resolution = 512);
+        void SetTransferFunctionTable(const std::vector<glm::vec4>& table);
+        void Render(const CPURayCastParameters& params, std::vector<glm::vec4>& image) const;
+        glm::vec4 CastRay(const glm::vec3& rayStart, const glm::vec3& rayEnd, float stepSize, float lodLevel) const;
+        float Sample(const glm::vec3& position, float lodLevel) const;
+        glm::vec4 LookupTransferFunction(float value) const;
+        glm::mat4 GetLocalWorld(const glm::mat4& world) const;
+
+        static void ConvertToRGBA8(const std::vector<glm::vec4>& image, std::vector<uint8_t>& rgba8);
+        static void SaveToFile(const std::string& filename, const std::vector<glm::vec4>& image, const glm::uvec2& imageSize);
+
+        /** Returns the step size MinMaxVolume uses for a mip level. */
+        float GetStepSize(unsigned int mipLevel) const { return stepSizes[mipLevel]; }
+        /** Returns the number of mip levels. */
+        unsigned int GetNumLevels() const { return static_cast<unsigned int>(levelSizes.size()); }
+
+    private:
+        void Initialize(std::unique_ptr<MinMaxPyramid> volumePyramid, const glm::vec3& scaling);
+        template<typename S> float SampleLevel(unsigned int level, const glm::vec3& position) const;
+        template<typename S> float SampleStorage(const glm::vec3& position, float lodLevel) const;
+        template<typename S> glm::vec4 CastRayStorage(const glm::vec3& rayStart, const glm::vec3& rayEnd, float stepSize, float lodLevel) const;
+
+        /** Holds the storage format of the volume data. */
+        VolumeStorageFormat format;
+        /** Holds the volume data of level 0. */
+        std::vector<uint8_t> level0;
+        /** Holds the average pyramid for the other levels. */
+        std::unique_ptr<MinMaxPyramid> pyramid;
+        /** Holds the sizes of all levels. */
+        std::vector<glm::uvec3> levelSizes;
+        /** Holds the step sizes for the mip levels. */
+        std::vector<float> stepSizes;
+        /** Holds the scaling of a voxel. */
+        glm::vec3 voxelScale;
+        /** Holds the transfer function table. */
+        std::vector<glm::vec4> tfTable;
+        /** Holds the number of threads to use. */
+        unsigned int numThreads;
+    };
+}
+
+#endif // CPURAYCASTER_H
@@ -0,0 +1,612 @@
+/**
+ * @file   CompressedVolume.cpp
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Implementation of the block compressed on-disk volume format.
+ */
+
+#include "CompressedVolume.h"
+#include "VolumeDatFile.h"
+#include "core/parallel_helper.h"
+#include <boost/filesystem.hpp>
+#include <codecvt>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace cgu {
+
+    namespace volumeCompression {
+
+        /** Block is stored uncompressed. */
+        static const uint8_t BLOCK_RAW = 0;
+        /** Block is prediction and Rice coded. */
+        static const uint8_t BLOCK_RICE = 1;
+        /** The number of residuals sharing a Rice parameter. */
+        static const unsigned int RICE_GROUP_SIZE = 64;
+        /** The length of unary codes from which on residuals are stored directly. */
+        static const unsigned int RICE_ESCAPE = 24;
+        /** The number of bits of a directly stored residual. */
+        static const unsigned int RESIDUAL_BITS = 33;
+
+        /** Writes a stream of bits (least significant bit first). */
+        class BitWriter
+        {
+        public:
+            explicit BitWriter(std::vector<uint8_t>& output) : output(output), bits(0), numBits(0) {}
+
+            /** Writes up to 56 bits. */
+            void Write(uint64_t value, unsigned int count)
+            {
+                bits |= value << numBits;
+                numBits += count;
+                while (numBits >= 8) {
+                    output.push_back(static_cast<uint8_t>(bits));
+                    bits >>= 8;
+                    numBits -= 8;
+                }
+            }
+
+            /** Writes the remaining bits. */
+            void Flush()
+            {
+                if (numBits > 0) output.push_back(static_cast<uint8_t>(bits));
+                bits = 0;
+                numBits = 0;
+            }
+
+        private:
+            /** Holds the output. */
+            std::vector<uint8_t>& output;
+            /** Holds the bits not written yet. */
+            uint64_t bits;
+            /** Holds the number of bits not written yet. */
+            unsigned int numBits;
+        };
+
+        /** Reads a stream of bits written by BitWriter. */
+        class BitReader
+        {
+        public:
+            BitReader(const uint8_t* data, uint64_t size) : data(data), size(size), position(0), bits(0), numBits(0) {}
+
+            /** Reads up to 56 bits. */
+            uint64_t Read(unsigned int count)
+            {
+                if (count == 0) return 0;
+                if (numBits < count) Refill();
+                auto result = bits & ((uint64_t(1) << count) - 1);
+                bits >>= count;
+                numBits -= count;
+                return result;
+            }
+
+            /** Reads a unary code (ones terminated by a zero) of at most maxLength ones. */
+            unsigned int ReadUnary(unsigned int maxLength)
+            {
+                if (numBits <= maxLength) Refill();
+                unsigned int length = 0;
+                while (length < maxLength && (bits & 1)) {
+                    bits >>= 1;
+                    ++length;
+                }
+                numBits -= length;
+                if (length < maxLength) {
+                    bits >>= 1;
+                    numBits -= 1;
+                }
+                return length;
+            }
+
+            /** Returns whether the reader read past the end of the data. */
+            bool IsOverrun() const { return position * 8 - numBits > size * 8; }
+
+        private:
+            /** Fills the bit buffer to at least 57 bits, reading zeros past the end of the data. */
+            void Refill()
+            {
+                while (numBits <= 56) {
+                    bits |= static_cast<uint64_t>(position < size ? data[position] : 0) << numBits;
+                    ++position;
+                    numBits += 8;
+                }
+            }
+
+            /** Holds the data. */
+            const uint8_t* data;
+            /** Holds the size of the data. */
+            uint64_t size;
+            /** Holds the position of the next byte to read. */
+            uint64_t position;
+            /** Holds the bits read but not consumed. */
+            uint64_t bits;
+            /** Holds the number of bits read but not consumed. */
+            unsigned int numBits;
+        };
+
+        /**
+         *  Predicts a value from its neighbors in the block.
+         *  Inside the xy-plane the median edge detector of LOCO-I is used, at the borders the direct neighbor.
+         */
+        static int64_t predict(const uint32_t* values, const glm::uvec3& extent, unsigned int x, unsigned int y, unsigned int z, uint64_t idx)
+        {
+            if (x > 0 && y > 0) {
+                int64_t a = values[idx - 1];
+                int64_t b = values[idx - extent.x];
+                int64_t c = values[idx - extent.x - 1];
+                if (c >= std::max(a, b)) return std::min(a, b);
+                if (c <= std::min(a, b)) return std::max(a, b);
+                return a + b - c;
+            }
+            if (x > 0) return values[idx - 1];
+            if (y > 0) return values[idx - extent.x];
+            if (z > 0) return values[idx - static_cast<uint64_t>(extent.x) * extent.y];
+            return 0;
+        }
+
+        /** Maps signed residuals to unsigned values (0, -1, 1, -2, ...). */
+        static uint64_t zigZag(int64_t value) { return value >= 0 ? static_cast<uint64_t>(value) << 1 : (static_cast<uint64_t>(-value) << 1) - 1; }
+        /** Inverse of zigZag. */
+        static int64_t unZigZag(uint64_t value) { return (value & 1) ? -static_cast<int64_t>((value + 1) >> 1) : static_cast<int64_t>(value >> 1); }
+
+        /**
+         *  Encodes a block.
+         *  @param view the source volume.
+         *  @param origin the first voxel of the block.
+         *  @param extent the size of the block.
+         *  @param quantizationBits the number of low bits to round away.
+         *  @param output the encoded block (output).
+         */
+        static void encodeBlock(const VolumeDataView& view, const glm::uvec3& origin, const glm::uvec3& extent,
+            unsigned int quantizationBits, std::vector<uint8_t>& output)
+        {
+            // rounding the bit pattern of a finite float must not carry into an all ones exponent (inf or NaN).
+            const uint64_t floatExponentMask = 0x7F800000;
+            auto isFloat = view.type == GL_FLOAT;
+            auto numVoxels = static_cast<uint64_t>(extent.x) * extent.y * extent.z;
+            auto componentSize = view.GetComponentSize();
+            auto maxValue = (uint64_t(1) << (8 * componentSize)) - 1;
+            auto maxQuantized = maxValue >> quantizationBits;
+            auto rounding = quantizationBits == 0 ? 0 : uint64_t(1) << (quantizationBits - 1);
+            std::vector<uint32_t> values(static_cast<std::size_t>(numVoxels));
+
+            output.clear();
+            output.push_back(BLOCK_RICE);
+            BitWriter writer(output);
+            for (unsigned int c = 0; c < view.numComponents; ++c) {
+                uint64_t idx = 0;
+                for (unsigned int z = 0; z < extent.z; ++z) {
+                    for (unsigned int y = 0; y < extent.y; ++y) {
+                        auto src = view.GetVoxel(origin + glm::uvec3(0, y, z)) + c * componentSize;
+                        for (unsigned int x = 0; x < extent.x; ++x, ++idx, src += view.voxelStride) {
+                            uint64_t value = 0;
+                            for (unsigned int b = 0; b < componentSize; ++b) value |= static_cast<uint64_t>(src[b]) << (8 * b);
+                            auto quantized = std::min((value + rounding) >> quantizationBits, maxQuantized);
+                            if (isFloat && ((quantized << quantizationBits) & floatExponentMask) == floatExponentMask
+                                && (value & floatExponentMask) != floatExponentMask) quantized = value >> quantizationBits;
+                            values[idx] = static_cast<uint32_t>(quantized);
+                        }
+                    }
+                }
+
+                uint64_t residuals[RICE_GROUP_SIZE];
+                idx = 0;
+                unsigned int groupSize = 0;
+                auto writeGroup = [&writer, &residuals, &groupSize]() {
+                    uint64_t sum = 0;
+                    for (unsigned int i = 0; i < groupSize; ++i) sum += residuals[i];
+                    unsigned int k = 0;
+                    while (k < RESIDUAL_BITS - 1 && (static_cast<uint64_t>(groupSize) << (k + 1)) <= sum) ++k;
+                    writer.Write(k, 6);
+                    for (unsigned int i = 0; i < groupSize; ++i) {
+                        auto q = residuals[i] >> k;
+                        if (q < RICE_ESCAPE) {
+                            writer.Write((uint64_t(1) << q) - 1, static_cast<unsigned int>(q) + 1);
+                            writer.Write(residuals[i] & ((uint64_t(1) << k) - 1), k);
+                        } else {
+                            writer.Write((uint64_t(1) << RICE_ESCAPE) - 1, RICE_ESCAPE);
+                            writer.Write(residuals[i], RESIDUAL_BITS);
+                        }
+                    }
+                    groupSize = 0;
+                };
+                for (unsigned int z = 0; z < extent.z; ++z) {
+                    for (unsigned int y = 0; y < extent.y; ++y) {
+                        for (unsigned int x = 0; x < extent.x; ++x, ++idx) {
+                            residuals[groupSize++] = zigZag(static_cast<int64_t>(values[idx]) - predict(values.data(), extent, x, y, z, idx));
+                            if (groupSize == RICE_GROUP_SIZE) writeGroup();
+                        }
+                    }
+                }
+                if (groupSize > 0) writeGroup();
+            }
+            writer.Flush();
+
+            auto rawSize = numVoxels * view.bytesPerVoxel;
+            if (output.size() > rawSize + 1) {
+                output.resize(static_cast<std::size_t>(rawSize + 1));
+                output[0] = BLOCK_RAW;
+                auto dst = output.data() + 1;
+                for (unsigned int z = 0; z < extent.z; ++z) {
+                    for (unsigned int y = 0; y < extent.y; ++y) {
+                        auto src = view.GetVoxel(origin + glm::uvec3(0, y, z));
+                        for (unsigned int x = 0; x < extent.x; ++x, dst += view.bytesPerVoxel, src += view.voxelStride) {
+                            std::memcpy(dst, src, view.bytesPerVoxel);
+                        }
+                    }
+                }
+            }
+        }
+
+        /**
+         *  Decodes a block.
+         *  @param layout the layout of the decoded voxels.
+         *  @param extent the size of the block.
+         *  @param quantizationBits the number of low bits rounded away.
+         *  @param encoded the encoded block.
+         *  @param encodedSize the size of the encoded block.
+         *  @param output the tightly packed voxels of the block (output).
+         *  @return whether the block could be decoded.
+         */
+        static bool decodeBlock(const VolumeDataView& layout, const glm::uvec3& extent, unsigned int quantizationBits,
+            const uint8_t* encoded, uint64_t encodedSize, uint8_t* output)
+        {
+            auto numVoxels = static_cast<uint64_t>(extent.x) * extent.y * extent.z;
+            if (encodedSize == 0) return false;
+            if (encoded[0] == BLOCK_RAW) {
+                if (encodedSize != numVoxels * layout.bytesPerVoxel + 1) return false;
+                std::memcpy(output, encoded + 1, static_cast<std::size_t>(encodedSize - 1));
+                return true;
+            }
+            if (encoded[0] != BLOCK_RICE) return false;
+
+            auto componentSize = layout.GetComponentSize();
+            thread_local std::vector<uint32_t> values;
+            values.resize(static_cast<std::size_t>(numVoxels));
+
+            BitReader reader(encoded + 1, encodedSize - 1);
+            for (unsigned int c = 0; c < layout.numComponents; ++c) {
+                uint64_t idx = 0;
+                unsigned int groupLeft = 0, k = 0;
+                for (unsigned int z = 0; z < extent.z; ++z) {
+                    for (unsigned int y = 0; y < extent.y; ++y) {
+                        for (unsigned int x = 0; x < extent.x; ++x, ++idx) {
+                            if (groupLeft == 0) {
+                                k = static_cast<unsigned int>(reader.Read(6));
+                                groupLeft = RICE_GROUP_SIZE;
+                            }
+                            --groupLeft;
+                            uint64_t residual;
+                            auto q = reader.ReadUnary(RICE_ESCAPE);
+                            if (q < RICE_ESCAPE) residual = (static_cast<uint64_t>(q) << k) | reader.Read(k);
+                            else residual = reader.Read(RESIDUAL_BITS);
+                            values[idx] = static_cast<uint32_t>(predict(values.data(), extent, x, y, z, idx) + unZigZag(residual));
+                        }
+                    }
+                }
+
+                auto dst = output + c * componentSize;
+                for (uint64_t i = 0; i < numVoxels; ++i, dst += layout.bytesPerVoxel) {
+                    auto value = static_cast<uint64_t>(values[static_cast<std::size_t>(i)]) << quantizationBits;
+                    for (unsigned int b = 0; b < componentSize; ++b) dst[b] = static_cast<uint8_t>(value >> (8 * b));
+                }
+            }
+            return !reader.IsOverrun();
+        }
+    }
+
+    /**
+     *  Constructor, maps an existing compressed volume file and reads its page table.
+     *  @param cvolFilename the file name of the compressed volume.
+     */
+    CompressedVolume::CompressedVolume(const std::string& cvolFilename) :
+        filename(cvolFilename),
+        blockDataStart(0),
+        blockDataSize(0),
+        blockSize(0),
+        numBlocks(0),
+        mode(VolumeCompressionMode::LOSSLESS),
+        quantizationBits(0)
+    {
+        std::ifstream ifs(filename, std::ios::in | std::ios::binary);
+        if (!ifs.is_open()) {
+            std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+            LOG(ERROR) << "Could not open file '" << converter.from_bytes(filename) << "'.";
+            throw std::runtime_error("Could not open file '" + filename + "'.");
+        }
+
+        bool correctHeader;
+        unsigned int actualVersion;
+        std::tie(correctHeader, actualVersion) = VersionableSerializerType::checkHeader(ifs);
+        if (!correctHeader) {
+            std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+            LOG(ERROR) << "File '" << converter.from_bytes(filename) << "' is no compressed volume or has the wrong version ("
+                << actualVersion << ").";
+            throw std::runtime_error("File '" + filename + "' is no compressed volume or has the wrong version.");
+        }
+
+        uint32_t type, modeValue;
+        serializeHelper::read(ifs, layout.size);
+        serializeHelper::read(ifs, blockSize);
+        serializeHelper::read(ifs, layout.bytesPerVoxel);
+        serializeHelper::read(ifs, layout.numComponents);
+        serializeHelper::read(ifs, type);
+        serializeHelper::read(ifs, layout.scaleValue);
+        serializeHelper::read(ifs, modeValue);
+        serializeHelper::read(ifs, quantizationBits);
+        serializeHelper::readV(ifs, pageTable);
+        layout.type = static_cast<GLenum>(type);
+        layout.voxelStride = layout.bytesPerVoxel;
+        mode = static_cast<VolumeCompressionMode>(modeValue);
+        blockDataStart = static_cast<uint64_t>(ifs.tellg());
+        for (const auto& entry : pageTable) blockDataSize = std::max(blockDataSize, entry.offset + entry.size);
+
+        if (!ifs || glm::any(glm::equal(blockSize, glm::uvec3(0))) || layout.numComponents == 0
+            || quantizationBits >= 8 * layout.GetComponentSize()) {
+            std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+            LOG(ERROR) << "Could not read the header of compressed volume '" << converter.from_bytes(filename) << "'.";
+            throw std::runtime_error("Could not read the header of compressed volume '" + filename + "'.");
+        }
+        ifs.close();
+        numBlocks = (layout.size + blockSize - glm::uvec3(1)) / blockSize;
+
+        try {
+            file.open(filename);
+        }
+        catch (const std::ios_base::failure&) {}
+
+        if (!file.is_open() || blockDataStart + blockDataSize > static_cast<uint64_t>(file.size())) {
+            std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+            LOG(ERROR) << "Could not map the blocks of compressed volume '" << converter.from_bytes(filename) << "'.";
+            throw std::runtime_error("Could not map the blocks of compressed volume '" + filename + "'.");
+        }
+    }
+
+    /** Default move constructor. */
+    CompressedVolume::CompressedVolume(CompressedVolume&& rhs) :
+        filename(std::move(rhs.filename)),
+        file(std::move(rhs.file)),
+        blockDataStart(rhs.blockDataStart),
+        blockDataSize(rhs.blockDataSize),
+        layout(rhs.layout),
+        blockSize(rhs.blockSize),
+        numBlocks(rhs.numBlocks),
+        mode(rhs.mode),
+        quantizationBits(rhs.quantizationBits),
+        pageTable(std::move(rhs.pageTable))
+    {
+    }
+
+    /** Default move assignment operator. */
+    CompressedVolume& CompressedVolume::operator=(CompressedVolume&& rhs)
+    {
+        if (this != &rhs) {
+            filename = std::move(rhs.filename);
+            file = std::move(rhs.file);
+            blockDataStart = rhs.blockDataStart;
+            blockDataSize = rhs.blockDataSize;
+            layout = rhs.layout;
+            blockSize = rhs.blockSize;
+            numBlocks = rhs.numBlocks;
+            mode = rhs.mode;
+            quantizationBits = rhs.quantizationBits;
+            pageTable = std::move(rhs.pageTable);
+        }
+        return *this;
+    }
+
+    /** Destructor. */
+    CompressedVolume::~CompressedVolume() = default;
+
+    /**
+     *  Writes a compressed volume file from volume data.
+     *  Blocks are encoded in parallel in batches, so memory mapped sources larger than the main memory can be
+     *  converted.
+     *  @param cvolFilename the file name of the compressed volume to create.
+     *  @param view the volume data.
+     *  @param parameters the compression parameters.
+     */
+    void CompressedVolume::CreateFromView(const std::string& cvolFilename, const VolumeDataView& view, const VolumeCompressionParameters& parameters)
+    {
+        assert(glm::all(glm::greaterThan(parameters.blockSize, glm::uvec3(0))));
+        auto quantizationBits = parameters.mode == VolumeCompressionMode::QUANTIZED ? parameters.quantizationBits : 0;
+        if (view.type != GL_UNSIGNED_BYTE && view.type != GL_UNSIGNED_SHORT && view.type != GL_UNSIGNED_INT && view.type != GL_FLOAT) {
+            LOG(ERROR) << "Volume type cannot be compressed.";
+            throw std::runtime_error("Volume type cannot be compressed.");
+        }
+        if (quantizationBits >= 8 * view.GetComponentSize()) {
+            LOG(ERROR) << "Cannot drop " << quantizationBits << " bits of " << 8 * view.GetComponentSize() << " bit data.";
+            throw std::runtime_error("Too many quantization bits.");
+        }
+
+        std::ofstream ofs(cvolFilename, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!ofs.is_open()) {
+            std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+            LOG(ERROR) << "Could not open file '" << converter.from_bytes(cvolFilename) << "'.";
+            throw std::runtime_error("Could not open file '" + cvolFilename + "'.");
+        }
+
+        const auto& blockSize = parameters.blockSize;
+        auto numBlocks = (view.size + blockSize - glm::uvec3(1)) / blockSize;
+        std::vector<BrickPageEntry> pageTable(static_cast<std::size_t>(numBlocks.x) * numBlocks.y * numBlocks.z, BrickPageEntry{ 0, 0 });
+
+        VersionableSerializerType::writeHeader(ofs);
+        serializeHelper::write(ofs, view.size);
+        serializeHelper::write(ofs, blockSize);
+        serializeHelper::write(ofs, view.bytesPerVoxel);
+        serializeHelper::write(ofs, view.numComponents);
+        serializeHelper::write(ofs, static_cast<uint32_t>(view.type));
+        serializeHelper::write(ofs, view.scaleValue);
+        serializeHelper::write(ofs, static_cast<uint32_t>(parameters.mode));
+        serializeHelper::write(ofs, quantizationBits);
+        auto pageTablePosition = ofs.tellp();
+        serializeHelper::writeV(ofs, pageTable);
+
+        auto numThreads = parameters.numThreads == 0 ? parallel::GetNumThreads() : parameters.numThreads;
+        std::vector<std::vector<uint8_t>> encodedBlocks(4 * numThreads);
+        uint64_t currentOffset = 0;
+        for (std::size_t batchStart = 0; batchStart < pageTable.size(); batchStart += encodedBlocks.size()) {
+            auto batchSize = std::min(encodedBlocks.size(), pageTable.size() - batchStart);
+            parallel::ForChunks(batchSize, 1, [&](uint64_t begin, uint64_t end, unsigned int)
+            {
+                for (auto i = begin; i < end; ++i) {
+                    auto idx = batchStart + static_cast<std::size_t>(i);
+                    glm::uvec3 block(idx % numBlocks.x, (idx / numBlocks.x) % numBlocks.y, idx / (static_cast<std::size_t>(numBlocks.x) * numBlocks.y));
+                    auto origin = block * blockSize;
+                    volumeCompression::encodeBlock(view, origin, glm::min(blockSize, view.size - origin), quantizationBits,
+                        encodedBlocks[static_cast<std::size_t>(i)]);
+                }
+            }, numThreads);
+
+            for (std::size_t i = 0; i < batchSize; ++i) {
+                const auto& encoded = encodedBlocks[i];
+                pageTable[batchStart + i].offset = currentOffset;
+                pageTable[batchStart + i].size = encoded.size();
+                ofs.write(reinterpret_cast<const char*>(encoded.data()), static_cast<std::streamsize>(encoded.size()));
+                currentOffset += encoded.size();
+            }
+        }
+
+        ofs.seekp(pageTablePosition);
+        serializeHelper::writeV(ofs, pageTable);
+
+        if (!ofs) {
+            std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+            LOG(ERROR) << "Could not write compressed volume '" << converter.from_bytes(cvolFilename) << "'.";
+            throw std::runtime_error("Could not write compressed volume '" + cvolFilename + "'.");
+        }
+        LOG(INFO) << "Compressed volume to " << currentOffset << " bytes (" << view.GetNumVoxels() * view.bytesPerVoxel << " bytes raw).";
+    }
+
+    /**
+     *  Converts a volume given by a dat file and its raw file to a compressed volume.
+     *  The compressed volume is written next to the new dat file (with the extension .cvol), the new dat file
+     *  is a copy of the old one referencing the compressed volume. Volumes load compressed data transparently.
+     *  @param datFilename the dat file of the volume to convert.
+     *  @param compressedDatFilename the dat file to create for the compressed volume.
+     *  @param parameters the compression parameters.
+     *  @return the file name of the compressed volume.
+     */
+    std::string CompressedVolume::ConvertDatFile(const std::string& datFilename, const std::string& compressedDatFilename,
+        const VolumeCompressionParameters& parameters)
+    {
+        VolumeDatFile datContent;
+        if (!datContent.Read(datFilename)) {
+            std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+            LOG(ERROR) << "Cannot open file '" << converter.from_bytes(datFilename) << "'.";
+            throw std::runtime_error("Cannot open file '" + datFilename + "'.");
+        }
+
+        VolumeDataView layout;
+        if (!datContent.GetLayout(layout)) {
+            std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+            LOG(ERROR) << "Could not find all required fields in dat file '" << converter.from_bytes(datFilename) << "'.";
+            throw std::runtime_error("Cannot find all required fields in dat file '" + datFilename + "'.");
+        }
+
+        boost::filesystem::path compressedDatPath{ compressedDatFilename };
+        auto cvolName = compressedDatPath.filename().stem().string() + ".cvol";
+        auto cvolFilename = compressedDatPath.parent_path().string() + "/" + cvolName;
+
+        {
+            RawVolumeSource rawData(datContent.GetRawFilePath(), datContent.dataOffset, layout);
+            CreateFromView(cvolFilename, rawData.GetView(), parameters);
+        }
+
+        // decoded data is tightly packed, so the offset and stride of the raw file are dropped.
+        std::vector<std::string> datLines;
+        for (const auto& line : datContent.lines) {
+            std::stringstream lineStream(line);
+            std::string field;
+            lineStream >> field;
+            if (field == "ObjectFileName:") datLines.push_back("ObjectFileName:\t" + cvolName);
+            else if (field != "DataOffset:" && field != "VoxelStride:") datLines.push_back(line);
+        }
+
+        std::ofstream datOut(compressedDatFilename, std::ofstream::out | std::ofstream::trunc);
+        if (!datOut.is_open()) {
+            std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+            LOG(ERROR) << "Could not open file '" << converter.from_bytes(compressedDatFilename) << "'.";
+            throw std::runtime_error("Could not open file '" + compressedDatFilename + "'.");
+        }
+        for (const auto& datLine : datLines) datOut << datLine << std::endl;
+        return cvolFilename;
+    }
+
+    /**
+     *  Decodes a single block.
+     *  Only the bytes of the block are accessed in the file.
+     *  @param block the coordinates of the block.
+     *  @param data the tightly packed voxels of the block (output).
+     */
+    void CompressedVolume::DecodeBlock(const glm::uvec3& block, std::vector<uint8_t>& data) const
+    {
+        assert(glm::all(glm::lessThan(block, numBlocks)));
+        const auto& entry = GetPageEntry(block);
+        auto extent = GetBlockExtent(block);
+        data.resize(static_cast<std::size_t>(static_cast<uint64_t>(extent.x) * extent.y * extent.z * layout.bytesPerVoxel));
+        auto encoded = reinterpret_cast<const uint8_t*>(file.data()) + blockDataStart + entry.offset;
+        if (!volumeCompression::decodeBlock(layout, extent, quantizationBits, encoded, entry.size, data.data())) {
+            std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+            LOG(ERROR) << "Could not decode block (" << block.x << ", " << block.y << ", " << block.z << ") of '"
+                << converter.from_bytes(filename) << "'.";
+            throw std::runtime_error("Could not decode block of '" + filename + "'.");
+        }
+    }
+
+    /**
+     *  Returns a view on the data of a block.
+     *  @param block the coordinates of the block.
+     *  @param data the blocks data as decoded by DecodeBlock.
+     *  @return the view on the block.
+     */
+    VolumeDataView CompressedVolume::GetBlockView(const glm::uvec3& block, const std::vector<uint8_t>& data) const
+    {
+        auto view = layout;
+        view.size = GetBlockExtent(block);
+        view.data = data.data();
+        assert(data.size() >= view.GetNumBytes());
+        return view;
+    }
+
+    /**
+     *  Decodes the whole volume in parallel.
+     *  @param data the tightly packed voxels of the volume (output, needs space for all voxels).
+     *  @param numThreads the number of threads to use (0 to use all hardware threads).
+     */
+    void CompressedVolume::Decode(uint8_t* data, unsigned int numThreads) const
+    {
+        auto bpv = static_cast<uint64_t>(layout.bytesPerVoxel);
+        parallel::ForChunks(pageTable.size(), 1, [this, data, bpv](uint64_t begin, uint64_t end, unsigned int)
+        {
+            thread_local std::vector<uint8_t> blockData;
+            for (auto i = begin; i < end; ++i) {
+                auto block = GetBlockCoordinates(i);
+                auto origin = GetBlockOrigin(block);
+                auto extent = GetBlockExtent(block);
+                DecodeBlock(block, blockData);
+
+                auto rowSize = extent.x * bpv;
+                auto src = blockData.data();
+                for (unsigned int z = 0; z < extent.z; ++z) {
+                    for (unsigned int y = 0; y < extent.y; ++y, src += rowSize) {
+                        std::memcpy(data + layout.GetIndex(origin + glm::uvec3(0, y, z)) * bpv, src, static_cast<std::size_t>(rowSize));
+                    }
+                }
+            }
+        }, numThreads);
+    }
+
+    /**
+     *  Decodes the whole volume in parallel.
+     *  @param numThreads the number of threads to use (0 to use all hardware threads).
+     *  @return the tightly packed voxels of the volume.
+     */
+    std::vector<uint8_t> CompressedVolume::Decode(unsigned int numThreads) const
+    {
+        std::vector<uint8_t> result(static_cast<std::size_t>(layout.GetNumVoxels() * layout.bytesPerVoxel));
+        Decode(result.data(), numThreads);
+        return result;
+    }
+}
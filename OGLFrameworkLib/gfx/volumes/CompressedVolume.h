@@ -0,0 +1,135 @@
+/**
+ * @file   CompressedVolume.h
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Contains the block compressed on-disk volume format.
+ */
+
+#ifndef COMPRESSEDVOLUME_H
+#define COMPRESSEDVOLUME_H
+
+#include "main.h"
+#include "gfx/volumes/RawVolumeSource.h"
+#include "gfx/volumes/BrickedVolume.h"
+#include "core/serializationHelper.h"
+
+namespace cgu {
+
+    /** The ways blocks of a compressed volume can be encoded. */
+    enum class VolumeCompressionMode
+    {
+        /** Voxels are reconstructed exactly. */
+        LOSSLESS,
+        /**
+         *  The lowest quantizationBits bits of each component are rounded away before encoding.
+         *  For FLOAT data this works on the bit patterns: the lowest mantissa bits are rounded away, which gives a
+         *  relative error of at most 2^(quantizationBits - 24) for normalized numbers. Rounding may carry into the
+         *  exponent, but never turns a finite value into infinity or NaN.
+         */
+        QUANTIZED
+    };
+
+    /** Parameters for creating a compressed volume. */
+    struct VolumeCompressionParameters
+    {
+        /** Holds the size of a single block. */
+        glm::uvec3 blockSize = glm::uvec3(32);
+        /** Holds the compression mode. */
+        VolumeCompressionMode mode = VolumeCompressionMode::LOSSLESS;
+        /** Holds the number of low bits dropped in quantized mode. */
+        unsigned int quantizationBits = 0;
+        /** Holds the number of threads used for encoding (0 to use all hardware threads). */
+        unsigned int numThreads = 0;
+    };
+
+    /**
+     *  @brief Volume stored as independently compressed blocks on disk.
+     *  The file contains a header, a page table with one entry per block (x runs fastest) and the compressed blocks.
+     *  Each component of a block is predicted from its already decoded neighbors (median edge detector in the
+     *  xy-plane) and the residuals are Rice coded with a parameter adapted to each group of 64 voxels. Blocks that
+     *  do not compress are stored uncompressed. Floats are compressed (and quantized) on their bit patterns.
+     *  The file is memory mapped, decoding a block only touches its own bytes and is thread safe.
+     *
+     * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+     * @date   2026.10.16
+     */
+    class CompressedVolume
+    {
+    public:
+        using VersionableSerializerType = serializeHelper::VersionableSerializer<'C', 'V', 'O', 'L', 1001>;
+
+        explicit CompressedVolume(const std::string& cvolFilename);
+        CompressedVolume(const CompressedVolume&) = delete;
+        CompressedVolume& operator=(const CompressedVolume&) = delete;
+        CompressedVolume(CompressedVolume&&);
+        CompressedVolume& operator=(CompressedVolume&&);
+        ~CompressedVolume();
+
+        static void CreateFromView(const std::string& cvolFilename, const VolumeDataView& view, const VolumeCompressionParameters& parameters);
+        static std::string ConvertDatFile(const std::string& datFilename, const std::string& compressedDatFilename,
+            const VolumeCompressionParameters& parameters);
+
+        void DecodeBlock(const glm::uvec3& block, std::vector<uint8_t>& data) const;
+        VolumeDataView GetBlockView(const glm::uvec3& block, const std::vector<uint8_t>& data) const;
+        void Decode(uint8_t* data, unsigned int numThreads = 0) const;
+        std::vector<uint8_t> Decode(unsigned int numThreads = 0) const;
+
+        /** Returns the size of the whole volume. */
+        const glm::uvec3& GetVolumeSize() const { return layout.size; }
+        /** Returns the (maximum) size of a block. */
+        const glm::uvec3& GetBlockSize() const { return blockSize; }
+        /** Returns the number of blocks in each dimension. */
+        const glm::uvec3& GetNumBlocks() const { return numBlocks; }
+        /** Returns the total number of blocks. */
+        uint64_t GetNumBlocksTotal() const { return pageTable.size(); }
+        /** Returns the layout of the decoded voxels (the data pointer is not set). */
+        const VolumeDataView& GetLayout() const { return layout; }
+        /** Returns the compression mode. */
+        VolumeCompressionMode GetMode() const { return mode; }
+        /** Returns the number of low bits dropped in quantized mode. */
+        unsigned int GetQuantizationBits() const { return quantizationBits; }
+        /** Returns the size of all compressed blocks in bytes. */
+        uint64_t GetCompressedSize() const { return blockDataSize; }
+        /** Returns the page table entry of a block. */
+        const BrickPageEntry& GetPageEntry(const glm::uvec3& block) const { return pageTable[GetBlockIndex(block)]; }
+        /** Returns the linear index of a block. */
+        uint64_t GetBlockIndex(const glm::uvec3& block) const
+        {
+            return (static_cast<uint64_t>(block.z) * numBlocks.y + block.y) * numBlocks.x + block.x;
+        }
+        /** Returns the block coordinates from a linear index. */
+        glm::uvec3 GetBlockCoordinates(uint64_t idx) const
+        {
+            return glm::uvec3(idx % numBlocks.x, (idx / numBlocks.x) % numBlocks.y, idx / (static_cast<uint64_t>(numBlocks.x) * numBlocks.y));
+        }
+        /** Returns the position of a blocks first voxel in the volume. */
+        glm::uvec3 GetBlockOrigin(const glm::uvec3& block) const { return block * blockSize; }
+        /** Returns the actual size of a block (clipped at the volume border). */
+        glm::uvec3 GetBlockExtent(const glm::uvec3& block) const { return glm::min(blockSize, layout.size - GetBlockOrigin(block)); }
+
+    private:
+        /** Holds the file name of the compressed volume. */
+        std::string filename;
+        /** Holds the memory mapped file. */
+        boost::iostreams::mapped_file_source file;
+        /** Holds the position of the first block in the file. */
+        uint64_t blockDataStart;
+        /** Holds the size of all blocks in bytes. */
+        uint64_t blockDataSize;
+        /** Holds the layout of the decoded voxels. */
+        VolumeDataView layout;
+        /** Holds the size of a block. */
+        glm::uvec3 blockSize;
+        /** Holds the number of blocks. */
+        glm::uvec3 numBlocks;
+        /** Holds the compression mode. */
+        VolumeCompressionMode mode;
+        /** Holds the number of low bits dropped in quantized mode. */
+        unsigned int quantizationBits;
+        /** Holds the page table. */
+        std::vector<BrickPageEntry> pageTable;
+    };
+}
+
+#endif // COMPRESSEDVOLUME_H
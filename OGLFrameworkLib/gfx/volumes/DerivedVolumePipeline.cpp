@@ -0,0 +1,115 @@
+/**
+ * @file   DerivedVolumePipeline.cpp
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Implementation of the pipeline computing derived volumes slab by slab.
+ */
+
+#include "DerivedVolumePipeline.h"
+#include "core/parallel_helper.h"
+#include <future>
+
+namespace cgu {
+
+    /** The output size a slab has if no slab depth is set. */
+    static const uint64_t DEFAULT_SLAB_OUTPUT_SIZE = 64 << 20;
+
+    /**
+     *  Constructor.
+     *  @param source the source volume.
+     *  @param firstSlice the first slice to compute.
+     *  @param endSlice the slice after the last slice to compute.
+     *  @param halo the number of slices around the slab that can be accessed.
+     */
+    VolumeSlab::VolumeSlab(const VolumeDataView& source, unsigned int firstSlice, unsigned int endSlice, unsigned int halo) :
+        source(source),
+        view(source),
+        viewFirstSlice(firstSlice > halo ? firstSlice - halo : 0),
+        firstSlice(firstSlice),
+        endSlice(endSlice)
+    {
+        auto viewEndSlice = glm::min(source.size.z, endSlice + halo);
+        view.size.z = viewEndSlice - viewFirstSlice;
+        if (source.data != nullptr) view.data = source.GetVoxel(glm::uvec3(0, 0, viewFirstSlice));
+    }
+
+    /**
+     *  Constructor.
+     *  @param source the source volume.
+     *  @param outputBytesPerVoxel the number of bytes of a voxel of the derived volume.
+     */
+    DerivedVolumePipeline::DerivedVolumePipeline(const VolumeDataView& source, unsigned int outputBytesPerVoxel) :
+        source(source),
+        outputBytesPerVoxel(outputBytesPerVoxel),
+        haloSize(0),
+        slabDepth(0),
+        numThreads(0)
+    {
+    }
+
+    /**
+     *  Constructor for generating volumes without a source.
+     *  The slabs passed to kernels have no data (VolumeSlab::HasData() is false), kernels may only use the positions.
+     *  @param size the size of the generated volume.
+     *  @param outputBytesPerVoxel the number of bytes of a voxel of the generated volume.
+     */
+    DerivedVolumePipeline::DerivedVolumePipeline(const glm::uvec3& size, unsigned int outputBytesPerVoxel) :
+        outputBytesPerVoxel(outputBytesPerVoxel),
+        haloSize(0),
+        slabDepth(0),
+        numThreads(0)
+    {
+        source.size = size;
+    }
+
+    /**
+     *  Computes the derived volume.
+     *  @param kernel the kernel computing the rows of the output.
+     *  @param sink the function receiving the output in order.
+     */
+    void DerivedVolumePipeline::Run(const RowKernel& kernel, const OutputSink& sink) const
+    {
+        auto rowSize = static_cast<uint64_t>(source.size.x) * outputBytesPerVoxel;
+        auto sliceSize = rowSize * source.size.y;
+        auto depth = slabDepth;
+        if (depth == 0) depth = static_cast<unsigned int>(glm::max<uint64_t>(1, DEFAULT_SLAB_OUTPUT_SIZE / glm::max<uint64_t>(1, sliceSize)));
+        depth = glm::max(1U, glm::min(depth, source.size.z));
+
+        std::vector<uint8_t> buffers[2];
+        std::future<void> pendingWrite;
+        for (unsigned int z0 = 0, slab = 0; z0 < source.size.z; z0 += depth, ++slab) {
+            auto z1 = glm::min(z0 + depth, source.size.z);
+            VolumeSlab volumeSlab(source, z0, z1, haloSize);
+            auto& buffer = buffers[slab % 2];
+            buffer.resize(static_cast<std::size_t>(sliceSize * (z1 - z0)));
+
+            auto numRows = static_cast<uint64_t>(z1 - z0) * source.size.y;
+            auto bufferPtr = buffer.data();
+            auto sizeY = source.size.y;
+            parallel::ForChunks(numRows, 16, [&kernel, &volumeSlab, bufferPtr, rowSize, sizeY, z0](uint64_t begin, uint64_t end, unsigned int)
+            {
+                for (auto row = begin; row < end; ++row) {
+                    kernel(volumeSlab, static_cast<unsigned int>(row % sizeY), z0 + static_cast<unsigned int>(row / sizeY), bufferPtr + row * rowSize);
+                }
+            }, numThreads);
+
+            if (pendingWrite.valid()) pendingWrite.get();
+            pendingWrite = std::async(std::launch::async, [&sink, &buffer]() { sink(buffer.data(), buffer.size()); });
+        }
+        if (pendingWrite.valid()) pendingWrite.get();
+    }
+
+    /**
+     *  Computes the derived volume and writes it to a stream.
+     *  @param kernel the kernel computing the rows of the output.
+     *  @param output the stream to write to.
+     */
+    void DerivedVolumePipeline::Run(const RowKernel& kernel, std::ostream& output) const
+    {
+        Run(kernel, [&output](const uint8_t* data, uint64_t size) {
+            output.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+            if (!output) throw std::runtime_error("Could not write derived volume.");
+        });
+    }
+}
@@ -0,0 +1,140 @@
+/**
+ * @file   DerivedVolumePipeline.h
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Contains a pipeline computing derived volumes slab by slab.
+ */
+
+#ifndef DERIVEDVOLUMEPIPELINE_H
+#define DERIVEDVOLUMEPIPELINE_H
+
+#include "main.h"
+#include "gfx/volumes/RawVolumeSource.h"
+#include <ostream>
+
+namespace cgu {
+
+    /**
+     *  @brief A slab of the source volume handed to the kernels of a DerivedVolumePipeline.
+     *  The slab contains the slices to compute and a halo of neighboring slices. Voxels are accessed with volume
+     *  coordinates, positions outside the volume are clamped to its border.
+     */
+    class VolumeSlab
+    {
+    public:
+        VolumeSlab(const VolumeDataView& source, unsigned int firstSlice, unsigned int endSlice, unsigned int halo);
+
+        /** Returns the first slice to compute. */
+        unsigned int GetFirstSlice() const { return firstSlice; }
+        /** Returns the slice after the last slice to compute. */
+        unsigned int GetEndSlice() const { return endSlice; }
+        /** Returns the size of the whole volume. */
+        const glm::uvec3& GetVolumeSize() const { return source.size; }
+        /** Returns a view on the slices of the slab including the halo. */
+        const VolumeDataView& GetView() const { return view; }
+        /** Returns the first slice of the view. */
+        unsigned int GetViewFirstSlice() const { return viewFirstSlice; }
+        /** Returns whether the slab has source data (slabs of generated volumes have none). */
+        bool HasData() const { return view.data != nullptr; }
+
+        /**
+         *  Returns a voxel, the position is clamped to the volume and has to lie inside the slab and its halo.
+         *  Slabs without source data return nullptr.
+         */
+        const uint8_t* GetVoxel(const glm::ivec3& pos) const
+        {
+            if (view.data == nullptr) return nullptr;
+            auto p = glm::clamp(pos, glm::ivec3(0), glm::ivec3(source.size) - glm::ivec3(1));
+            assert(static_cast<unsigned int>(p.z) >= viewFirstSlice && static_cast<unsigned int>(p.z) < viewFirstSlice + view.size.z);
+            return view.GetVoxel(glm::uvec3(p.x, p.y, p.z - viewFirstSlice));
+        }
+        /** Returns a voxel as a given type, the slab needs to have source data. */
+        template<typename T> const T& Get(const glm::ivec3& pos) const
+        {
+            assert(HasData());
+            return *reinterpret_cast<const T*>(GetVoxel(pos));
+        }
+
+    private:
+        /** Holds the view on the whole volume. */
+        VolumeDataView source;
+        /** Holds the view on the slab. */
+        VolumeDataView view;
+        /** Holds the first slice of the view. */
+        unsigned int viewFirstSlice;
+        /** Holds the first slice to compute. */
+        unsigned int firstSlice;
+        /** Holds the slice after the last slice to compute. */
+        unsigned int endSlice;
+    };
+
+    /**
+     *  @brief Computes a derived volume from a source volume in bounded memory.
+     *  The source is processed in slabs of slices with a configurable halo. The rows of each slab are computed by a
+     *  kernel on all hardware threads and the output is written sequentially while the next slab is computed. For
+     *  memory mapped sources the operating system only needs to page in the current slab.
+     *
+     * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+     * @date   2026.10.16
+     */
+    class DerivedVolumePipeline
+    {
+    public:
+        /** Computes one row of the output (all x for given y and z), the output row is tightly packed. */
+        using RowKernel = std::function<void(const VolumeSlab& slab, unsigned int y, unsigned int z, uint8_t* output)>;
+        /** Receives the output in order. */
+        using OutputSink = std::function<void(const uint8_t* data, uint64_t size)>;
+
+        DerivedVolumePipeline(const VolumeDataView& source, unsigned int outputBytesPerVoxel);
+        DerivedVolumePipeline(const glm::uvec3& size, unsigned int outputBytesPerVoxel);
+
+        /** Sets the number of slices around each slab kernels may access. */
+        void SetHalo(unsigned int halo) { haloSize = halo; }
+        /** Sets the number of slices computed at once (0 chooses a size of about 64MB output). */
+        void SetSlabDepth(unsigned int depth) { slabDepth = depth; }
+        /** Sets the number of threads used (0 to use all hardware threads). */
+        void SetNumThreads(unsigned int threads) { numThreads = threads; }
+
+        void Run(const RowKernel& kernel, const OutputSink& sink) const;
+        void Run(const RowKernel& kernel, std::ostream& output) const;
+
+        /**
+         *  Creates a kernel computing each output voxel from the same voxel of the source.
+         *  @param fn the function computing an output voxel as fn(const I& voxel) -> O.
+         */
+        template<typename I, typename O, typename Fn> static RowKernel VoxelKernel(Fn fn)
+        {
+            return [fn](const VolumeSlab& slab, unsigned int y, unsigned int z, uint8_t* output) {
+                auto out = reinterpret_cast<O*>(output);
+                for (unsigned int x = 0; x < slab.GetVolumeSize().x; ++x) out[x] = fn(slab.Get<I>(glm::ivec3(x, y, z)));
+            };
+        }
+
+        /**
+         *  Creates a kernel computing each output voxel from a neighborhood of the source.
+         *  @param fn the function computing an output voxel as fn(const VolumeSlab& slab, const glm::ivec3& pos) -> O.
+         */
+        template<typename O, typename Fn> static RowKernel StencilKernel(Fn fn)
+        {
+            return [fn](const VolumeSlab& slab, unsigned int y, unsigned int z, uint8_t* output) {
+                auto out = reinterpret_cast<O*>(output);
+                for (unsigned int x = 0; x < slab.GetVolumeSize().x; ++x) out[x] = fn(slab, glm::ivec3(x, y, z));
+            };
+        }
+
+    private:
+        /** Holds the source volume. */
+        VolumeDataView source;
+        /** Holds the number of bytes of an output voxel. */
+        unsigned int outputBytesPerVoxel;
+        /** Holds the halo size. */
+        unsigned int haloSize;
+        /** Holds the slab depth. */
+        unsigned int slabDepth;
+        /** Holds the number of threads to use. */
+        unsigned int numThreads;
+    };
+}
+
+#endif // DERIVEDVOLUMEPIPELINE_H
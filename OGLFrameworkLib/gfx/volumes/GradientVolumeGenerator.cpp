@@ -0,0 +1,348 @@
+/**
+ * @file   GradientVolumeGenerator.cpp
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Implementation of the CPU generator for precomputed gradient volumes.
+ */
+
+#include "GradientVolumeGenerator.h"
+#include "gfx/volumes/Volume.h"
+#include "gfx/volumes/VolumeDataConversion.h"
+#include "gfx/volumes/VolumeCache.h"
+#include "gfx/volumes/VolumeStorage.h"
+#include <cstring>
+#include <sstream>
+
+namespace cgu {
+
+    /** The smoothing weights of the Sobel operator. */
+    static const float sobelWeights[3] = { 1.0f, 2.0f, 1.0f };
+    /** The normalization of the Sobel operator to the range of central differences. */
+    static const float sobelScale = 1.0f / 32.0f;
+    /** The maximum length of a gradient. */
+    static const float maxGradientLength = 0.8660254f;
+
+    /** Stores a value in [0, 1] as a normalized integer with the given number of bits. */
+    static uint32_t storeUnorm(float value, float maxInt)
+    {
+        return static_cast<uint32_t>(glm::clamp(value, 0.0f, 1.0f) * maxInt + 0.5f);
+    }
+
+    /** Returns the octahedral encoding of a direction in [-1, 1]^2. */
+    static glm::vec2 encodeOctahedral(float x, float y, float z)
+    {
+        auto invL1 = 1.0f / (glm::abs(x) + glm::abs(y) + glm::abs(z));
+        glm::vec2 p(x * invL1, y * invL1);
+        if (z < 0.0f) {
+            p = glm::vec2((1.0f - glm::abs(p.y)) * (p.x >= 0.0f ? 1.0f : -1.0f),
+                (1.0f - glm::abs(p.x)) * (p.y >= 0.0f ? 1.0f : -1.0f));
+        }
+        return p;
+    }
+
+    /** Returns the direction of an octahedral encoding. */
+    static glm::vec3 decodeOctahedral(const glm::vec2& p)
+    {
+        glm::vec3 n(p.x, p.y, 1.0f - glm::abs(p.x) - glm::abs(p.y));
+        if (n.z < 0.0f) {
+            n.x = (1.0f - glm::abs(p.y)) * (p.x >= 0.0f ? 1.0f : -1.0f);
+            n.y = (1.0f - glm::abs(p.x)) * (p.y >= 0.0f ? 1.0f : -1.0f);
+        }
+        return glm::normalize(n);
+    }
+
+    /**
+     *  Constructor.
+     *  @param stencil the stencil to compute gradients with.
+     *  @param encoding the encoding of the gradient volume.
+     */
+    GradientVolumeGenerator::GradientVolumeGenerator(GradientStencil stencil, GradientEncoding encoding) :
+        stencil(stencil),
+        encoding(encoding)
+    {
+    }
+
+    /** Returns the size of a voxel of the gradient volume in bytes. */
+    unsigned int GradientVolumeGenerator::GetBytesPerVoxel() const
+    {
+        switch (encoding) {
+        case GradientEncoding::RGB8: return 3;
+        case GradientEncoding::RGB10A2: return 4;
+        default: return 6;
+        }
+    }
+
+    /** Returns the texture descriptor of a gradient texture. */
+    TextureDescriptor GradientVolumeGenerator::GetTextureDescriptor() const
+    {
+        switch (encoding) {
+        case GradientEncoding::RGB8: return TextureDescriptor(3, GL_RGB8, GL_RGB, GL_UNSIGNED_BYTE);
+        case GradientEncoding::RGB10A2: return TextureDescriptor(4, GL_RGB10_A2, GL_RGBA, GL_UNSIGNED_INT_2_10_10_10_REV);
+        default: return TextureDescriptor(6, GL_RGB16, GL_RGB, GL_UNSIGNED_SHORT);
+        }
+    }
+
+    /**
+     *  Encodes a row of gradients.
+     *  @param gx the x components of the gradients.
+     *  @param gy the y components of the gradients.
+     *  @param gz the z components of the gradients.
+     *  @param count the number of gradients.
+     *  @param output the encoded gradients (output).
+     */
+    void GradientVolumeGenerator::Encode(const float* gx, const float* gy, const float* gz, unsigned int count, uint8_t* output) const
+    {
+        if (encoding == GradientEncoding::RGB8) {
+            for (unsigned int x = 0; x < count; ++x) {
+                output[3 * x] = volumeStorage::Unorm8::Store(gx[x] + 0.5f);
+                output[3 * x + 1] = volumeStorage::Unorm8::Store(gy[x] + 0.5f);
+                output[3 * x + 2] = volumeStorage::Unorm8::Store(gz[x] + 0.5f);
+            }
+        } else if (encoding == GradientEncoding::RGB10A2) {
+            auto out = reinterpret_cast<uint32_t*>(output);
+            for (unsigned int x = 0; x < count; ++x) {
+                out[x] = storeUnorm(gx[x] + 0.5f, 1023.0f) | (storeUnorm(gy[x] + 0.5f, 1023.0f) << 10)
+                    | (storeUnorm(gz[x] + 0.5f, 1023.0f) << 20) | (3U << 30);
+            }
+        } else {
+            auto out = reinterpret_cast<uint16_t*>(output);
+            for (unsigned int x = 0; x < count; ++x) {
+                auto length = glm::sqrt(gx[x] * gx[x] + gy[x] * gy[x] + gz[x] * gz[x]);
+                auto oct = length > 0.0f ? encodeOctahedral(gx[x], gy[x], gz[x]) : glm::vec2(0.0f);
+                out[3 * x] = static_cast<uint16_t>(storeUnorm(oct.x * 0.5f + 0.5f, 65535.0f));
+                out[3 * x + 1] = static_cast<uint16_t>(storeUnorm(oct.y * 0.5f + 0.5f, 65535.0f));
+                out[3 * x + 2] = static_cast<uint16_t>(storeUnorm(length / maxGradientLength, 65535.0f));
+            }
+        }
+    }
+
+    /**
+     *  Decodes a single voxel of a gradient volume.
+     *  @param voxel the encoded voxel.
+     *  @return the gradient vector (xyz) and its length (w).
+     */
+    glm::vec4 GradientVolumeGenerator::Decode(const uint8_t* voxel) const
+    {
+        glm::vec3 gradient;
+        if (encoding == GradientEncoding::RGB8) {
+            gradient = glm::vec3(voxel[0], voxel[1], voxel[2]) / 255.0f - glm::vec3(0.5f);
+        } else if (encoding == GradientEncoding::RGB10A2) {
+            uint32_t packed;
+            std::memcpy(&packed, voxel, sizeof(packed));
+            gradient = glm::vec3(packed & 1023U, (packed >> 10) & 1023U, (packed >> 20) & 1023U) / 1023.0f - glm::vec3(0.5f);
+        } else {
+            uint16_t packed[3];
+            std::memcpy(packed, voxel, sizeof(packed));
+            auto length = static_cast<float>(packed[2]) / 65535.0f * maxGradientLength;
+            auto oct = glm::vec2(packed[0], packed[1]) / 65535.0f * 2.0f - glm::vec2(1.0f);
+            gradient = length > 0.0f ? decodeOctahedral(oct) * length : glm::vec3(0.0f);
+        }
+        return glm::vec4(gradient, glm::length(gradient));
+    }
+
+    /**
+     *  Creates the row kernel for the pipeline.
+     *  The kernel converts the rows of the stencil to float (with clamped borders) and computes all gradients of the
+     *  row with simple loops over these rows.
+     *  @param source the source volume.
+     *  @param maxValue the value the source is normalized with.
+     *  @return the row kernel.
+     */
+    DerivedVolumePipeline::RowKernel GradientVolumeGenerator::CreateKernel(const VolumeDataView& source, float maxValue) const
+    {
+        return [this, source, maxValue](const VolumeSlab& slab, unsigned int y, unsigned int z, uint8_t* output)
+        {
+            thread_local std::vector<float> rowBuffer;
+            thread_local std::vector<float> gradients;
+
+            auto sizeX = slab.GetVolumeSize().x;
+            auto rowLength = sizeX + 2;
+            rowBuffer.resize(9 * rowLength);
+            gradients.resize(3 * sizeX);
+
+            auto rows = rowBuffer.data();
+            auto getRow = [rows, rowLength](int dy, int dz) { return rows + ((dz + 1) * 3 + (dy + 1)) * rowLength; };
+            for (int dz = -1; dz <= 1; ++dz) {
+                for (int dy = -1; dy <= 1; ++dy) {
+                    if (stencil == GradientStencil::CENTRAL_DIFFERENCE && dy != 0 && dz != 0) continue;
+                    auto row = getRow(dy, dz);
+                    auto rowData = slab.GetVoxel(glm::ivec3(0, static_cast<int>(y) + dy, static_cast<int>(z) + dz));
+                    volumeConversion::ConvertVoxelsToNormalizedFloat(source, rowData, sizeX, maxValue, row + 1);
+                    row[0] = row[1];
+                    row[sizeX + 1] = row[sizeX];
+                }
+            }
+
+            auto gx = gradients.data();
+            auto gy = gx + sizeX;
+            auto gz = gy + sizeX;
+            if (stencil == GradientStencil::CENTRAL_DIFFERENCE) {
+                auto c = getRow(0, 0);
+                auto ym = getRow(-1, 0);
+                auto yp = getRow(1, 0);
+                auto zm = getRow(0, -1);
+                auto zp = getRow(0, 1);
+                for (unsigned int x = 0; x < sizeX; ++x) {
+                    gx[x] = (c[x + 2] - c[x]) * 0.5f;
+                    gy[x] = (yp[x + 1] - ym[x + 1]) * 0.5f;
+                    gz[x] = (zp[x + 1] - zm[x + 1]) * 0.5f;
+                }
+            } else {
+                for (unsigned int x = 0; x < sizeX; ++x) gx[x] = gy[x] = gz[x] = 0.0f;
+                for (int d1 = -1; d1 <= 1; ++d1) {
+                    for (int d0 = -1; d0 <= 1; ++d0) {
+                        auto w = sobelWeights[d0 + 1] * sobelWeights[d1 + 1];
+                        auto rx = getRow(d0, d1);
+                        auto rym = getRow(-1, d1);
+                        auto ryp = getRow(1, d1);
+                        auto rzm = getRow(d1, -1);
+                        auto rzp = getRow(d1, 1);
+                        for (unsigned int x = 0; x < sizeX; ++x) {
+                            gx[x] += w * (rx[x + 2] - rx[x]);
+                            gy[x] += w * (ryp[x + 1 + d0] - rym[x + 1 + d0]);
+                            gz[x] += w * (rzp[x + 1 + d0] - rzm[x + 1 + d0]);
+                        }
+                    }
+                }
+                for (unsigned int x = 0; x < sizeX; ++x) {
+                    gx[x] *= sobelScale;
+                    gy[x] *= sobelScale;
+                    gz[x] *= sobelScale;
+                }
+            }
+
+            Encode(gx, gy, gz, sizeX, output);
+        };
+    }
+
+    /**
+     *  Generates a gradient volume and writes it to a stream.
+     *  @param source the source volume (single channel).
+     *  @param output the stream to write the encoded gradients to.
+     *  @param numThreads the number of threads to use (0 to use all hardware threads).
+     */
+    void GradientVolumeGenerator::Generate(const VolumeDataView& source, std::ostream& output, unsigned int numThreads) const
+    {
+        if (source.numComponents != 1) throw std::runtime_error("Gradient volumes can only be generated for single channel volumes.");
+
+        DerivedVolumePipeline pipeline(source, GetBytesPerVoxel());
+        pipeline.SetHalo(1);
+        pipeline.SetNumThreads(numThreads);
+        pipeline.Run(CreateKernel(source, volumeConversion::FindMaximumValue(source, numThreads)), output);
+    }
+
+    /**
+     *  Generates a gradient volume in memory.
+     *  @param source the source volume (single channel).
+     *  @param output the encoded gradients (output).
+     *  @param numThreads the number of threads to use (0 to use all hardware threads).
+     */
+    void GradientVolumeGenerator::Generate(const VolumeDataView& source, std::vector<uint8_t>& output, unsigned int numThreads) const
+    {
+        if (source.numComponents != 1) throw std::runtime_error("Gradient volumes can only be generated for single channel volumes.");
+
+        output.clear();
+        output.reserve(static_cast<std::size_t>(source.GetNumVoxels() * GetBytesPerVoxel()));
+        DerivedVolumePipeline pipeline(source, GetBytesPerVoxel());
+        pipeline.SetHalo(1);
+        pipeline.SetNumThreads(numThreads);
+        pipeline.Run(CreateKernel(source, volumeConversion::FindMaximumValue(source, numThreads)),
+            [&output](const uint8_t* data, uint64_t size) { output.insert(output.end(), data, data + size); });
+    }
+
+    /**
+     *  Generates a gradient volume voxel by voxel on a single thread.
+     *  The result is identical to the one of Generate and can be used to verify it.
+     *  @param source the source volume (single channel).
+     *  @param output the encoded gradients (output).
+     */
+    void GradientVolumeGenerator::GenerateReference(const VolumeDataView& source, std::vector<uint8_t>& output) const
+    {
+        if (source.numComponents != 1) throw std::runtime_error("Gradient volumes can only be generated for single channel volumes.");
+
+        auto maxValue = volumeConversion::FindMaximumValue(source, 1);
+        auto value = [&source, maxValue](const glm::ivec3& pos) {
+            auto p = glm::clamp(pos, glm::ivec3(0), glm::ivec3(source.size) - glm::ivec3(1));
+            float result;
+            volumeConversion::ConvertVoxelsToNormalizedFloat(source, source.GetVoxel(glm::uvec3(p)), 1, maxValue, &result);
+            return result;
+        };
+
+        output.resize(static_cast<std::size_t>(source.GetNumVoxels() * GetBytesPerVoxel()));
+        auto out = output.data();
+        glm::ivec3 pos;
+        for (pos.z = 0; pos.z < static_cast<int>(source.size.z); ++pos.z) {
+            for (pos.y = 0; pos.y < static_cast<int>(source.size.y); ++pos.y) {
+                for (pos.x = 0; pos.x < static_cast<int>(source.size.x); ++pos.x) {
+                    glm::vec3 g(0.0f);
+                    if (stencil == GradientStencil::CENTRAL_DIFFERENCE) {
+                        g.x = (value(pos + glm::ivec3(1, 0, 0)) - value(pos - glm::ivec3(1, 0, 0))) * 0.5f;
+                        g.y = (value(pos + glm::ivec3(0, 1, 0)) - value(pos - glm::ivec3(0, 1, 0))) * 0.5f;
+                        g.z = (value(pos + glm::ivec3(0, 0, 1)) - value(pos - glm::ivec3(0, 0, 1))) * 0.5f;
+                    } else {
+                        for (int d1 = -1; d1 <= 1; ++d1) {
+                            for (int d0 = -1; d0 <= 1; ++d0) {
+                                auto w = sobelWeights[d0 + 1] * sobelWeights[d1 + 1];
+                                g.x += w * (value(pos + glm::ivec3(1, d0, d1)) - value(pos + glm::ivec3(-1, d0, d1)));
+                                g.y += w * (value(pos + glm::ivec3(d0, 1, d1)) - value(pos + glm::ivec3(d0, -1, d1)));
+                                g.z += w * (value(pos + glm::ivec3(d0, d1, 1)) - value(pos + glm::ivec3(d0, d1, -1)));
+                            }
+                        }
+                        g *= sobelScale;
+                    }
+                    Encode(&g.x, &g.y, &g.z, 1, out);
+                    out += GetBytesPerVoxel();
+                }
+            }
+        }
+    }
+
+    /**
+     *  Returns the gradient texture of a volume.
+     *  The gradient volume is cached next to the volumes dat file and only generated if the cache is missing or was
+     *  created from different data or with different parameters, the raw data is only read in this case (see
+     *  LoadGradientData).
+     *  @param volume the volume to compute the gradients of.
+     *  @return the gradient texture.
+     */
+    std::unique_ptr<GLTexture> GradientVolumeGenerator::LoadGradientTexture(const Volume& volume) const
+    {
+        const auto& size = volume.GetSize();
+        auto cacheFilename = volume.GetCacheFilename("_gradient" + std::to_string(static_cast<int>(stencil))
+            + std::to_string(static_cast<int>(encoding)) + ".cache");
+        auto data = LoadGradientData(cacheFilename, volume.GetContentHash(), size, [&volume]() { return volume.LoadRawDataFromFile(); });
+        return std::make_unique<GLTexture>(size.x, size.y, size.z, 1, GetTextureDescriptor(), data.data());
+    }
+
+    /**
+     *  Returns the encoded gradients of a volume from a cache file or generates them and writes the cache.
+     *  @param cacheFilename the name of the cache file.
+     *  @param contentHash the hash of the volume data and its parameters (see Volume::GetContentHash).
+     *  @param size the size of the volume.
+     *  @param loadRawData the function loading the raw volume data, only called if the cache cannot be used.
+     *  @return the encoded gradients.
+     */
+    std::vector<uint8_t> GradientVolumeGenerator::LoadGradientData(const std::string& cacheFilename, uint64_t contentHash,
+        const glm::uvec3& size, const std::function<std::unique_ptr<RawVolumeSource>()>& loadRawData) const
+    {
+        std::stringstream parameters;
+        parameters << "gradient," << static_cast<int>(stencil) << "," << static_cast<int>(encoding);
+        VolumeCacheKey cacheKey(contentHash, volumeCache::HashString(parameters.str()));
+        auto numVoxels = static_cast<uint64_t>(size.x) * size.y * size.z;
+
+        std::vector<uint8_t> data;
+        auto loaded = volumeCache::ReadCache<VersionableSerializerType>(cacheFilename, cacheKey, [this, &data, numVoxels](std::istream& ifs)
+        {
+            serializeHelper::readV(ifs, data);
+            return data.size() == numVoxels * GetBytesPerVoxel();
+        });
+
+        if (!loaded) {
+            auto rawData = loadRawData();
+            Generate(rawData->GetView(), data);
+            volumeCache::WriteCache<VersionableSerializerType>(cacheFilename, cacheKey, [&data](std::ostream& ofs) { serializeHelper::writeV(ofs, data); });
+        }
+        return data;
+    }
+}
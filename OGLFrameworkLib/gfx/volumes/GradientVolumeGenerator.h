@@ -0,0 +1,88 @@
+/**
+ * @file   GradientVolumeGenerator.h
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Contains the CPU generator for precomputed gradient volumes.
+ */
+
+#ifndef GRADIENTVOLUMEGENERATOR_H
+#define GRADIENTVOLUMEGENERATOR_H
+
+#include "main.h"
+#include "gfx/volumes/DerivedVolumePipeline.h"
+#include "gfx/glrenderer/GLTexture.h"
+#include "core/serializationHelper.h"
+#include <functional>
+
+namespace cgu {
+
+    class Volume;
+
+    /** The stencils gradients can be computed with. */
+    enum class GradientStencil
+    {
+        /** Central differences of the 6 direct neighbors. */
+        CENTRAL_DIFFERENCE,
+        /** 3x3x3 Sobel operator. */
+        SOBEL
+    };
+
+    /** The encodings of gradient volumes. */
+    enum class GradientEncoding
+    {
+        /** Gradient vector in RGB8, each component stored as g + 0.5. */
+        RGB8,
+        /** Gradient vector in RGB10A2, each component stored as g + 0.5 (alpha is 1). */
+        RGB10A2,
+        /** Octahedral encoded direction in RG and magnitude in B of an RGB16 texture. */
+        OCTAHEDRAL16
+    };
+
+    /**
+     *  @brief Generates gradient volumes on the CPU.
+     *  Gradients are computed on the normalized volume (values in [0, 1], like in the volume texture) in voxel units.
+     *  The Sobel operator is scaled to the same range as central differences, so all gradient components are in
+     *  [-0.5, 0.5]. Volume borders are clamped.
+     *  The generator works row by row on a DerivedVolumePipeline: for each output row the needed neighbor rows are
+     *  converted to float once and the stencil runs as plain loops over these rows that the compiler vectorizes.
+     *  GenerateReference computes the same values voxel by voxel for verification.
+     *
+     * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+     * @date   2026.10.16
+     */
+    class GradientVolumeGenerator
+    {
+    public:
+        using VersionableSerializerType = serializeHelper::VersionableSerializer<'G', 'R', 'A', 'D', 1001>;
+
+        GradientVolumeGenerator(GradientStencil stencil, GradientEncoding encoding);
+
+        void Generate(const VolumeDataView& source, std::ostream& output, unsigned int numThreads = 0) const;
+        void Generate(const VolumeDataView& source, std::vector<uint8_t>& output, unsigned int numThreads = 0) const;
+        void GenerateReference(const VolumeDataView& source, std::vector<uint8_t>& output) const;
+        std::unique_ptr<GLTexture> LoadGradientTexture(const Volume& volume) const;
+        std::vector<uint8_t> LoadGradientData(const std::string& cacheFilename, uint64_t contentHash, const glm::uvec3& size,
+            const std::function<std::unique_ptr<RawVolumeSource>()>& loadRawData) const;
+
+        glm::vec4 Decode(const uint8_t* voxel) const;
+        unsigned int GetBytesPerVoxel() const;
+        TextureDescriptor GetTextureDescriptor() const;
+
+        /** Returns the stencil used. */
+        GradientStencil GetStencil() const { return stencil; }
+        /** Returns the encoding used. */
+        GradientEncoding GetEncoding() const { return encoding; }
+
+    private:
+        DerivedVolumePipeline::RowKernel CreateKernel(const VolumeDataView& source, float maxValue) const;
+        void Encode(const float* gx, const float* gy, const float* gz, unsigned int count, uint8_t* output) const;
+
+        /** Holds the stencil. */
+        GradientStencil stencil;
+        /** Holds the encoding. */
+        GradientEncoding encoding;
+    };
+}
+
+#endif // GRADIENTVOLUMEGENERATOR_H
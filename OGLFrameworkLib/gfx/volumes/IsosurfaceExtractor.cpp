@@ -0,0 +1,468 @@
+/**
+ * @file   IsosurfaceExtractor.cpp
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Implementation of the parallel CPU isosurface extractor for volumes.
+ */
+
+#include "IsosurfaceExtractor.h"
+#include "VolumeDataConversion.h"
+#include "gfx/mesh/IsosurfaceMesh.h"
+#include "core/parallel_helper.h"
+#include <array>
+
+namespace cgu {
+
+    /** The number of edges owned by each voxel (the edges to its neighbors in positive directions). */
+    static const unsigned int edgesPerVoxel = 7;
+    /** The corners of the six tetrahedra a cell is split into (corner index bits are x, y, z). */
+    static const unsigned int cellTetrahedra[6][4] = {
+        { 0, 1, 3, 7 }, { 0, 1, 5, 7 }, { 0, 2, 3, 7 }, { 0, 2, 6, 7 }, { 0, 4, 5, 7 }, { 0, 4, 6, 7 } };
+
+    /** Returns the offset of a cell corner from the cells first corner. */
+    static glm::uvec3 cornerOffset(unsigned int corner)
+    {
+        return glm::uvec3(corner & 1U, (corner >> 1) & 1U, (corner >> 2) & 1U);
+    }
+
+    /** The triangles of a tetrahedron for one classification of its corners. */
+    struct TetrahedronCase
+    {
+        /** Holds the number of triangles. */
+        unsigned int numTriangles;
+        /** Holds the cell edges (as pairs of cell corners) the vertices of each triangle lie on. */
+        unsigned int edges[2][3][2];
+    };
+
+    /**
+     *  Returns the triangles for all tetrahedra and classifications of their corners.
+     *  The triangles are oriented so their normals point to the corners below the isovalue. The orientation is the
+     *  same for all vertex positions on the edges, so it is determined with the edge midpoints in exact arithmetic.
+     *  @return the cases indexed by tetrahedron and a mask of the corners below the isovalue.
+     */
+    static const std::array<std::array<TetrahedronCase, 16>, 6>& tetrahedronCases()
+    {
+        static const auto cases = []()
+        {
+            std::array<std::array<TetrahedronCase, 16>, 6> result;
+            for (auto t = 0U; t < 6; ++t) {
+                for (auto mask = 0U; mask < 16; ++mask) {
+                    auto& tetCase = result[t][mask];
+                    tetCase.numTriangles = 0;
+                    unsigned int below[4], above[4], numBelow = 0, numAbove = 0;
+                    for (auto i = 0U; i < 4; ++i) {
+                        if ((mask & (1U << i)) != 0) below[numBelow++] = cellTetrahedra[t][i];
+                        else above[numAbove++] = cellTetrahedra[t][i];
+                    }
+                    if (numBelow == 0 || numAbove == 0) continue;
+
+                    auto setEdge = [&tetCase](unsigned int tri, unsigned int vtx, unsigned int c0, unsigned int c1)
+                    {
+                        tetCase.edges[tri][vtx][0] = glm::min(c0, c1);
+                        tetCase.edges[tri][vtx][1] = glm::max(c0, c1);
+                    };
+                    if (numBelow == 2) {
+                        tetCase.numTriangles = 2;
+                        setEdge(0, 0, below[0], above[0]); setEdge(0, 1, below[0], above[1]); setEdge(0, 2, below[1], above[1]);
+                        setEdge(1, 0, below[0], above[0]); setEdge(1, 1, below[1], above[1]); setEdge(1, 2, below[1], above[0]);
+                    } else {
+                        tetCase.numTriangles = 1;
+                        auto single = numBelow == 1 ? below[0] : above[0];
+                        auto others = numBelow == 1 ? above : below;
+                        for (auto i = 0U; i < 3; ++i) setEdge(0, i, single, others[i]);
+                    }
+
+                    glm::vec3 towardsBelow(0.0f), midpoints[3];
+                    for (auto i = 0U; i < numBelow; ++i) towardsBelow += static_cast<float>(numAbove) * glm::vec3(cornerOffset(below[i]));
+                    for (auto i = 0U; i < numAbove; ++i) towardsBelow -= static_cast<float>(numBelow) * glm::vec3(cornerOffset(above[i]));
+                    for (auto i = 0U; i < 3; ++i) midpoints[i] = glm::vec3(cornerOffset(tetCase.edges[0][i][0]) + cornerOffset(tetCase.edges[0][i][1]));
+                    if (glm::dot(glm::cross(midpoints[1] - midpoints[0], midpoints[2] - midpoints[0]), towardsBelow) < 0.0f) {
+                        for (auto tri = 0U; tri < tetCase.numTriangles; ++tri) {
+                            std::swap(tetCase.edges[tri][1][0], tetCase.edges[tri][2][0]);
+                            std::swap(tetCase.edges[tri][1][1], tetCase.edges[tri][2][1]);
+                        }
+                    }
+                }
+            }
+            return result;
+        }();
+        return cases;
+    }
+
+    /** The triangles generated for a single block. */
+    struct IsosurfaceExtractor::BlockResult
+    {
+        /** Holds the global keys of the edges the vertices lie on. */
+        std::vector<uint64_t> edgeKeys;
+        /** Holds whether a vertex lies on a face of the block (and may be shared with other blocks). */
+        std::vector<uint8_t> onBlockFace;
+        /** Holds the vertex positions. */
+        std::vector<glm::vec3> positions;
+        /** Holds the vertex normals. */
+        std::vector<glm::vec3> normals;
+        /** Holds the triangles as indices into the blocks vertices. */
+        std::vector<unsigned int> indices;
+    };
+
+    /** Per thread data used for welding the vertices of a block. */
+    struct IsosurfaceExtractor::BlockScratch
+    {
+        /** Holds the index of the vertex on each edge of the block (-1 if there is none). */
+        std::vector<int> edgeVertices;
+        /** Holds the entries of edgeVertices set for the current block. */
+        std::vector<unsigned int> usedEdges;
+    };
+
+    /**
+     *  Constructor for raw volume data.
+     *  The values are normalized by the maximum value of the volume, like the data of volume textures. The view has
+     *  to stay valid for the lifetime of the extractor.
+     *  @param view the raw volume data (single component).
+     *  @param voxelScale the scaling of a voxel.
+     *  @param slabSize the number of cells along z processed at once.
+     *  @param blockSize the number of cells along each axis of a block.
+     *  @param numThreads the number of threads to use (0 to use all hardware threads).
+     */
+    IsosurfaceExtractor::IsosurfaceExtractor(const VolumeDataView& view, const glm::vec3& voxelScale,
+        unsigned int slabSize, unsigned int blockSize, unsigned int numThreads) :
+        size(view.size),
+        voxelScale(voxelScale),
+        numThreads(numThreads)
+    {
+        if (view.numComponents != 1) {
+            LOG(ERROR) << "Isosurfaces can only be extracted from single component volumes.";
+            throw std::runtime_error("Isosurfaces can only be extracted from single component volumes.");
+        }
+
+        auto maxValue = volumeConversion::FindMaximumValue(view, numThreads);
+        loadSlices = [view, maxValue, numThreads](unsigned int firstSlice, unsigned int numSlices, float* data)
+        {
+            auto sliceVoxels = static_cast<uint64_t>(view.size.x) * view.size.y;
+            parallel::ForChunks(numSlices, 1, [&view, maxValue, data, firstSlice, sliceVoxels](uint64_t begin, uint64_t end, unsigned int)
+            {
+                for (auto i = begin; i < end; ++i) {
+                    volumeConversion::ConvertVoxelsToNormalizedFloat(view, view.GetVoxel((firstSlice + i) * sliceVoxels),
+                        sliceVoxels, maxValue, data + i * sliceVoxels);
+                }
+            }, numThreads);
+        };
+        Init(slabSize, blockSize);
+    }
+
+    /**
+     *  Constructor for a raw data source owned by the extractor.
+     *  @param source the raw volume data (single component).
+     *  @param voxelScale the scaling of a voxel.
+     *  @param slabSize the number of cells along z processed at once.
+     *  @param blockSize the number of cells along each axis of a block.
+     *  @param numThreads the number of threads to use (0 to use all hardware threads).
+     */
+    IsosurfaceExtractor::IsosurfaceExtractor(std::unique_ptr<RawVolumeSource> source, const glm::vec3& voxelScale,
+        unsigned int slabSize, unsigned int blockSize, unsigned int numThreads) :
+        IsosurfaceExtractor(source->GetView(), voxelScale, slabSize, blockSize, numThreads)
+    {
+        this->source = std::move(source);
+    }
+
+    /**
+     *  Constructor for values computed on demand (e.g. analytic fields).
+     *  @param size the size of the volume.
+     *  @param loadSlices the function loading slices of the volume.
+     *  @param voxelScale the scaling of a voxel.
+     *  @param slabSize the number of cells along z processed at once.
+     *  @param blockSize the number of cells along each axis of a block.
+     *  @param numThreads the number of threads to use (0 to use all hardware threads).
+     */
+    IsosurfaceExtractor::IsosurfaceExtractor(const glm::uvec3& size, SliceFunction loadSlices, const glm::vec3& voxelScale,
+        unsigned int slabSize, unsigned int blockSize, unsigned int numThreads) :
+        loadSlices(std::move(loadSlices)),
+        size(size),
+        voxelScale(voxelScale),
+        numThreads(numThreads)
+    {
+        Init(slabSize, blockSize);
+    }
+
+    /** Default move constructor. */
+    IsosurfaceExtractor::IsosurfaceExtractor(IsosurfaceExtractor&&) = default;
+    /** Default move assignment operator. */
+    IsosurfaceExtractor& IsosurfaceExtractor::operator=(IsosurfaceExtractor&&) = default;
+    /** Default destructor. */
+    IsosurfaceExtractor::~IsosurfaceExtractor() = default;
+
+    /**
+     *  Initializes the block layout.
+     *  @param slabSize the number of cells along z processed at once.
+     *  @param blockSize the number of cells along each axis of a block.
+     */
+    void IsosurfaceExtractor::Init(unsigned int slabSize, unsigned int blockSize)
+    {
+        this->blockSize = glm::max(blockSize, 1U);
+        this->slabSize = glm::max((slabSize + this->blockSize - 1) / this->blockSize, 1U) * this->blockSize;
+        if (numThreads == 0) numThreads = parallel::GetNumThreads();
+
+        if (glm::any(glm::lessThan(size, glm::uvec3(2)))) numBlocks = glm::uvec3(0);
+        else numBlocks = (size - glm::uvec3(1) + glm::uvec3(this->blockSize - 1)) / this->blockSize;
+        blockRanges.resize(static_cast<std::size_t>(numBlocks.x) * numBlocks.y * numBlocks.z);
+        rangesComputed.resize(numBlocks.z, 0);
+    }
+
+    /**
+     *  Extracts an isosurface.
+     *  @param isovalue the normalized value of the isosurface.
+     *  @param geometry the triangles of the isosurface (output).
+     */
+    void IsosurfaceExtractor::Extract(float isovalue, IsosurfaceGeometry& geometry)
+    {
+        geometry.positions.clear();
+        geometry.normals.clear();
+        geometry.indices.clear();
+        stats = IsosurfaceStatistics();
+        stats.numBlocks = blockRanges.size();
+        if (blockRanges.empty()) return;
+
+        auto blocksPerSlab = slabSize / blockSize;
+        auto sliceVoxels = static_cast<uint64_t>(size.x) * size.y;
+        auto numCellSlices = size.z - 1;
+        std::vector<float> slab;
+        std::vector<BlockScratch> scratch(numThreads);
+        std::vector<uint64_t> activeBlocks;
+        std::vector<BlockResult> results;
+        std::unordered_map<uint64_t, unsigned int> sharedVertices, nextSharedVertices;
+
+        for (auto cellBegin = 0U; cellBegin < numCellSlices; cellBegin += slabSize) {
+            auto cellEnd = glm::min(cellBegin + slabSize, numCellSlices);
+            auto firstBlockZ = cellBegin / blockSize;
+            auto endBlockZ = glm::min(firstBlockZ + blocksPerSlab, numBlocks.z);
+
+            auto slabKnown = true;
+            auto slabActive = false;
+            for (auto bz = firstBlockZ; bz < endBlockZ; ++bz) slabKnown = slabKnown && rangesComputed[bz] != 0;
+            auto firstBlock = static_cast<uint64_t>(firstBlockZ) * numBlocks.x * numBlocks.y;
+            auto endBlock = static_cast<uint64_t>(endBlockZ) * numBlocks.x * numBlocks.y;
+            for (auto b = firstBlock; slabKnown && b < endBlock; ++b) slabActive = slabActive || IsBlockActive(b, isovalue);
+            if (slabKnown && !slabActive) {
+                stats.numSlabsSkipped += 1;
+                sharedVertices.clear();
+                continue;
+            }
+
+            // the slab includes one slice before and after its cells for the gradients.
+            auto firstSlice = cellBegin == 0 ? 0 : cellBegin - 1;
+            auto endSlice = glm::min(cellEnd + 2, size.z);
+            auto numSlices = endSlice - firstSlice;
+            slab.resize(static_cast<std::size_t>(numSlices * sliceVoxels));
+            loadSlices(firstSlice, numSlices, slab.data());
+            stats.numSlabsLoaded += 1;
+            if (!slabKnown) ComputeBlockRanges(firstBlockZ, firstSlice, slab.data());
+
+            activeBlocks.clear();
+            for (auto b = firstBlock; b < endBlock; ++b) if (IsBlockActive(b, isovalue)) activeBlocks.push_back(b);
+            stats.numActiveBlocks += activeBlocks.size();
+
+            results.resize(activeBlocks.size());
+            parallel::ForChunks(activeBlocks.size(), 1, [&](uint64_t begin, uint64_t end, unsigned int threadIdx)
+            {
+                for (auto i = begin; i < end; ++i) {
+                    auto b = activeBlocks[i];
+                    glm::uvec3 block(b % numBlocks.x, (b / numBlocks.x) % numBlocks.y, b / (static_cast<uint64_t>(numBlocks.x) * numBlocks.y));
+                    ExtractBlock(block, firstSlice, numSlices, slab.data(), isovalue, scratch[threadIdx], results[i]);
+                }
+            }, numThreads);
+
+            // welding across blocks is done in block order, so the result does not depend on the threads.
+            for (auto& result : results) {
+                std::vector<unsigned int> globalIndices(result.positions.size());
+                for (std::size_t v = 0; v < result.positions.size(); ++v) {
+                    if (result.onBlockFace[v] != 0) {
+                        auto shared = sharedVertices.find(result.edgeKeys[v]);
+                        if (shared != sharedVertices.end()) {
+                            globalIndices[v] = shared->second;
+                            continue;
+                        }
+                    }
+
+                    if (geometry.positions.size() >= std::numeric_limits<unsigned int>::max()) {
+                        LOG(ERROR) << "Isosurface has too many vertices for 32 bit indices.";
+                        throw std::runtime_error("Isosurface has too many vertices for 32 bit indices.");
+                    }
+                    globalIndices[v] = static_cast<unsigned int>(geometry.positions.size());
+                    geometry.positions.push_back(result.positions[v]);
+                    geometry.normals.push_back(result.normals[v]);
+                    if (result.onBlockFace[v] != 0) sharedVertices[result.edgeKeys[v]] = globalIndices[v];
+                }
+                for (auto idx : result.indices) geometry.indices.push_back(globalIndices[idx]);
+                result = BlockResult();
+            }
+
+            // only vertices on the last slice of the slab can be shared with the next slab.
+            nextSharedVertices.clear();
+            for (const auto& shared : sharedVertices) {
+                auto voxel = shared.first / edgesPerVoxel;
+                auto edgeDir = static_cast<unsigned int>(shared.first % edgesPerVoxel) + 1;
+                if (voxel / sliceVoxels == cellEnd && (edgeDir & 4U) == 0) nextSharedVertices.insert(shared);
+            }
+            std::swap(sharedVertices, nextSharedVertices);
+        }
+    }
+
+    /**
+     *  Extracts an isosurface as a mesh.
+     *  The mesh creates OpenGL buffers, so this has to be called on a thread with an active OpenGL context.
+     *  @param isovalue the normalized value of the isosurface.
+     *  @return the mesh of the isosurface.
+     */
+    std::unique_ptr<IsosurfaceMesh> IsosurfaceExtractor::ExtractMesh(float isovalue)
+    {
+        IsosurfaceGeometry geometry;
+        Extract(isovalue, geometry);
+        return std::make_unique<IsosurfaceMesh>(geometry.positions, geometry.normals, geometry.indices);
+    }
+
+    /**
+     *  Computes the value ranges of the blocks of a slab.
+     *  @param firstBlockZ the first slice of blocks in the slab.
+     *  @param firstSlice the first slice of voxels in the slab data.
+     *  @param slab the slab data.
+     */
+    void IsosurfaceExtractor::ComputeBlockRanges(unsigned int firstBlockZ, unsigned int firstSlice, const float* slab)
+    {
+        auto endBlockZ = glm::min(firstBlockZ + slabSize / blockSize, numBlocks.z);
+        auto blocksPerSlice = static_cast<uint64_t>(numBlocks.x) * numBlocks.y;
+        auto firstBlock = firstBlockZ * blocksPerSlice;
+
+        parallel::ForChunks((endBlockZ - firstBlockZ) * blocksPerSlice, 16, [&](uint64_t begin, uint64_t end, unsigned int)
+        {
+            for (auto i = begin; i < end; ++i) {
+                auto b = firstBlock + i;
+                glm::uvec3 block(b % numBlocks.x, (b / numBlocks.x) % numBlocks.y, b / blocksPerSlice);
+                auto blockMin = block * blockSize;
+                auto blockMax = glm::min(blockMin + glm::uvec3(blockSize), size - glm::uvec3(1));
+
+                glm::vec2 range(std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest());
+                for (auto z = blockMin.z; z <= blockMax.z; ++z) {
+                    for (auto y = blockMin.y; y <= blockMax.y; ++y) {
+                        auto row = slab + (static_cast<uint64_t>(z - firstSlice) * size.y + y) * size.x;
+                        for (auto x = blockMin.x; x <= blockMax.x; ++x) {
+                            range.x = glm::min(range.x, row[x]);
+                            range.y = glm::max(range.y, row[x]);
+                        }
+                    }
+                }
+                blockRanges[b] = range;
+            }
+        }, numThreads);
+
+        for (auto bz = firstBlockZ; bz < endBlockZ; ++bz) rangesComputed[bz] = 1;
+    }
+
+    /** Returns whether a block contains voxels below and at or above the isovalue. */
+    bool IsosurfaceExtractor::IsBlockActive(uint64_t blockIdx, float isovalue) const
+    {
+        return blockRanges[blockIdx].x < isovalue && blockRanges[blockIdx].y >= isovalue;
+    }
+
+    /**
+     *  Computes the gradient at a voxel with central differences (one sided at the borders).
+     *  @param pos the voxels position.
+     *  @param firstSlice the first slice of voxels in the slab data.
+     *  @param numSlices the number of slices in the slab data.
+     *  @param slab the slab data.
+     *  @return the gradient.
+     */
+    glm::vec3 IsosurfaceExtractor::CalcGradient(const glm::uvec3& pos, unsigned int firstSlice, unsigned int numSlices, const float* slab) const
+    {
+        auto value = [this, firstSlice, slab](unsigned int x, unsigned int y, unsigned int z)
+        {
+            return slab[(static_cast<uint64_t>(z - firstSlice) * size.y + y) * size.x + x];
+        };
+
+        glm::uvec3 lower(pos.x == 0 ? 0 : pos.x - 1, pos.y == 0 ? 0 : pos.y - 1, pos.z == firstSlice ? firstSlice : pos.z - 1);
+        glm::uvec3 upper(glm::min(pos.x + 1, size.x - 1), glm::min(pos.y + 1, size.y - 1), glm::min(pos.z + 1, firstSlice + numSlices - 1));
+        glm::vec3 gradient;
+        gradient.x = (value(upper.x, pos.y, pos.z) - value(lower.x, pos.y, pos.z)) / static_cast<float>(upper.x - lower.x);
+        gradient.y = (value(pos.x, upper.y, pos.z) - value(pos.x, lower.y, pos.z)) / static_cast<float>(upper.y - lower.y);
+        gradient.z = (value(pos.x, pos.y, upper.z) - value(pos.x, pos.y, lower.z)) / static_cast<float>(upper.z - lower.z);
+        return gradient / voxelScale;
+    }
+
+    /**
+     *  Triangulates the cells of a block.
+     *  The vertices are welded within the block, vertices on the faces of the block are marked so they can be
+     *  welded with the ones of neighboring blocks.
+     *  @param block the block to triangulate.
+     *  @param firstSlice the first slice of voxels in the slab data.
+     *  @param numSlices the number of slices in the slab data.
+     *  @param slab the slab data.
+     *  @param isovalue the value of the isosurface.
+     *  @param scratch the per thread data to use.
+     *  @param result the triangles of the block (output).
+     */
+    void IsosurfaceExtractor::ExtractBlock(const glm::uvec3& block, unsigned int firstSlice, unsigned int numSlices,
+        const float* slab, float isovalue, BlockScratch& scratch, BlockResult& result) const
+    {
+        auto blockVoxels = blockSize + 1;
+        scratch.edgeVertices.resize(static_cast<std::size_t>(blockVoxels) * blockVoxels * blockVoxels * edgesPerVoxel, -1);
+        auto blockMin = block * blockSize;
+        auto blockEnd = glm::min(blockMin + glm::uvec3(blockSize), size - glm::uvec3(1));
+        auto value = [this, firstSlice, slab](const glm::uvec3& pos)
+        {
+            return slab[(static_cast<uint64_t>(pos.z - firstSlice) * size.y + pos.y) * size.x + pos.x];
+        };
+
+        auto getVertex = [&](const glm::uvec3& cell, unsigned int c0, unsigned int c1, const float* cornerValues)
+        {
+            auto edgeDir = c0 ^ c1;
+            auto owner = cell + cornerOffset(c0);
+            auto local = owner - blockMin;
+            auto localKey = ((local.z * blockVoxels + local.y) * blockVoxels + local.x) * edgesPerVoxel + edgeDir - 1;
+            if (scratch.edgeVertices[localKey] >= 0) return static_cast<unsigned int>(scratch.edgeVertices[localKey]);
+
+            auto other = owner + cornerOffset(edgeDir);
+            auto t = (isovalue - cornerValues[c0]) / (cornerValues[c1] - cornerValues[c0]);
+            auto normal = -glm::mix(CalcGradient(owner, firstSlice, numSlices, slab), CalcGradient(other, firstSlice, numSlices, slab), t);
+            auto normalLength = glm::length(normal);
+
+            auto onFace = false;
+            for (auto a = 0; a < 3; ++a) onFace = onFace || ((edgeDir & (1U << a)) == 0 && (local[a] == 0 || local[a] == blockSize));
+
+            auto idx = static_cast<unsigned int>(result.positions.size());
+            result.edgeKeys.push_back(((static_cast<uint64_t>(owner.z) * size.y + owner.y) * size.x + owner.x) * edgesPerVoxel + edgeDir - 1);
+            result.onBlockFace.push_back(onFace ? 1 : 0);
+            result.positions.push_back(glm::mix(glm::vec3(owner), glm::vec3(other), t) * voxelScale);
+            result.normals.push_back(normalLength > 0.0f ? normal / normalLength : normal);
+            scratch.edgeVertices[localKey] = static_cast<int>(idx);
+            scratch.usedEdges.push_back(localKey);
+            return idx;
+        };
+
+        const auto& cases = tetrahedronCases();
+        float cornerValues[8];
+        for (auto z = blockMin.z; z < blockEnd.z; ++z) {
+            for (auto y = blockMin.y; y < blockEnd.y; ++y) {
+                for (auto x = blockMin.x; x < blockEnd.x; ++x) {
+                    glm::uvec3 cell(x, y, z);
+                    unsigned int belowMask = 0;
+                    for (auto c = 0U; c < 8; ++c) {
+                        cornerValues[c] = value(cell + cornerOffset(c));
+                        if (cornerValues[c] < isovalue) belowMask |= 1U << c;
+                    }
+                    if (belowMask == 0 || belowMask == 0xFF) continue;
+
+                    for (auto t = 0U; t < 6; ++t) {
+                        unsigned int tetMask = 0;
+                        for (auto i = 0U; i < 4; ++i) if ((belowMask & (1U << cellTetrahedra[t][i])) != 0) tetMask |= 1U << i;
+                        const auto& tetCase = cases[t][tetMask];
+                        for (auto tri = 0U; tri < tetCase.numTriangles; ++tri) {
+                            for (const auto& edge : tetCase.edges[tri]) result.indices.push_back(getVertex(cell, edge[0], edge[1], cornerValues));
+                        }
+                    }
+                }
+            }
+        }
+
+        for (auto localKey : scratch.usedEdges) scratch.edgeVertices[localKey] = -1;
+        scratch.usedEdges.clear();
+    }
+}
@@ -0,0 +1,127 @@
+/**
+ * @file   IsosurfaceExtractor.h
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Contains the parallel CPU isosurface extractor for volumes.
+ */
+
+#ifndef ISOSURFACEEXTRACTOR_H
+#define ISOSURFACEEXTRACTOR_H
+
+#include "main.h"
+#include "gfx/volumes/RawVolumeSource.h"
+#include <functional>
+
+namespace cgu {
+
+    class IsosurfaceMesh;
+
+    /** Triangles of an extracted isosurface. */
+    struct IsosurfaceGeometry
+    {
+        /** Holds the vertex positions. */
+        std::vector<glm::vec3> positions;
+        /** Holds the vertex normals. */
+        std::vector<glm::vec3> normals;
+        /** Holds three indices per triangle. */
+        std::vector<unsigned int> indices;
+    };
+
+    /** Statistics of the last extraction. */
+    struct IsosurfaceStatistics
+    {
+        /** Holds the number of blocks of the volume. */
+        uint64_t numBlocks = 0;
+        /** Holds the number of blocks containing the isosurface. */
+        uint64_t numActiveBlocks = 0;
+        /** Holds the number of slabs loaded. */
+        unsigned int numSlabsLoaded = 0;
+        /** Holds the number of slabs skipped because no block contained the isosurface. */
+        unsigned int numSlabsSkipped = 0;
+    };
+
+    /**
+     *  @brief Extracts isosurfaces of a scalar volume as triangle meshes on all available threads.
+     *  The cells between the voxels are split into six tetrahedra around their main diagonal (marching
+     *  tetrahedra), which needs no case table, has no ambiguous cases and gives closed surfaces. Vertices lie on
+     *  the edges between voxels and are welded by edge, their normals point to lower values along the interpolated
+     *  central difference gradients. Positions are given in voxel coordinates (the first voxel is at the origin)
+     *  multiplied by the voxel scaling.
+     *  The volume is processed in slabs of slices, so only a slab has to be held in memory at once. The cells of
+     *  a slab are grouped into blocks whose value ranges (including a one voxel border, like the cells of the
+     *  OccupancyGrid) are kept between extractions: Blocks not containing the isovalue are skipped and slabs without
+     *  any such blocks are not loaded again.
+     *  The result does not depend on the number of threads used.
+     *
+     * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+     * @date   2026.10.16
+     */
+    class IsosurfaceExtractor
+    {
+    public:
+        /**
+         *  The function loading slices as fn(firstSlice, numSlices, data), the data holds numSlices slices of
+         *  normalized float values.
+         */
+        using SliceFunction = std::function<void(unsigned int, unsigned int, float*)>;
+
+        IsosurfaceExtractor(const VolumeDataView& view, const glm::vec3& voxelScale = glm::vec3(1.0f),
+            unsigned int slabSize = 64, unsigned int blockSize = 8, unsigned int numThreads = 0);
+        IsosurfaceExtractor(std::unique_ptr<RawVolumeSource> source, const glm::vec3& voxelScale = glm::vec3(1.0f),
+            unsigned int slabSize = 64, unsigned int blockSize = 8, unsigned int numThreads = 0);
+        IsosurfaceExtractor(const glm::uvec3& size, SliceFunction loadSlices, const glm::vec3& voxelScale = glm::vec3(1.0f),
+            unsigned int slabSize = 64, unsigned int blockSize = 8, unsigned int numThreads = 0);
+        IsosurfaceExtractor(const IsosurfaceExtractor&) = delete;
+        IsosurfaceExtractor& operator=(const IsosurfaceExtractor&) = delete;
+        IsosurfaceExtractor(IsosurfaceExtractor&&);
+        IsosurfaceExtractor& operator=(IsosurfaceExtractor&&);
+        ~IsosurfaceExtractor();
+
+        void Extract(float isovalue, IsosurfaceGeometry& geometry);
+        std::unique_ptr<IsosurfaceMesh> ExtractMesh(float isovalue);
+
+        /** Returns the size of the volume. */
+        const glm::uvec3& GetSize() const { return size; }
+        /** Returns the number of blocks in each dimension. */
+        const glm::uvec3& GetNumBlocks() const { return numBlocks; }
+        /** Returns the statistics of the last extraction. */
+        const IsosurfaceStatistics& GetStatistics() const { return stats; }
+
+    private:
+        struct BlockResult;
+        struct BlockScratch;
+
+        void Init(unsigned int slabSize, unsigned int blockSize);
+        void ComputeBlockRanges(unsigned int firstBlockZ, unsigned int firstSlice, const float* slab);
+        bool IsBlockActive(uint64_t blockIdx, float isovalue) const;
+        void ExtractBlock(const glm::uvec3& block, unsigned int firstSlice, unsigned int numSlices, const float* slab,
+            float isovalue, BlockScratch& scratch, BlockResult& result) const;
+        glm::vec3 CalcGradient(const glm::uvec3& pos, unsigned int firstSlice, unsigned int numSlices, const float* slab) const;
+
+        /** Holds the raw data source (if owned by the extractor). */
+        std::unique_ptr<RawVolumeSource> source;
+        /** Holds the function loading slices. */
+        SliceFunction loadSlices;
+        /** Holds the size of the volume. */
+        glm::uvec3 size;
+        /** Holds the voxel scaling. */
+        glm::vec3 voxelScale;
+        /** Holds the number of cells along z processed at once (a multiple of the block size). */
+        unsigned int slabSize;
+        /** Holds the number of cells along each axis of a block. */
+        unsigned int blockSize;
+        /** Holds the number of threads to use. */
+        unsigned int numThreads;
+        /** Holds the number of blocks. */
+        glm::uvec3 numBlocks;
+        /** Holds the value ranges of the blocks (valid for block slices with rangesComputed set). */
+        std::vector<glm::vec2> blockRanges;
+        /** Holds for each slice of blocks whether its ranges were computed. */
+        std::vector<uint8_t> rangesComputed;
+        /** Holds the statistics of the last extraction. */
+        IsosurfaceStatistics stats;
+    };
+}
+
+#endif // ISOSURFACEEXTRACTOR_H
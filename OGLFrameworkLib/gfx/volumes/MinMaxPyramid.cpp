@@ -0,0 +1,276 @@
+/**
+ * @file   MinMaxPyramid.cpp
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Implementation of the CPU builder for average and min/max pyramids of volumes.
+ */
+
+#include "MinMaxPyramid.h"
+#include "core/parallel_helper.h"
+
+namespace cgu {
+
+    /** The 2x2x2 neighborhood read by the level shaders (in the same order). */
+    static const glm::ivec3 levelReadOffsets[8] = {
+        glm::ivec3(0, 0, 0), glm::ivec3(0, 0, 1), glm::ivec3(0, 1, 0), glm::ivec3(0, 1, 1),
+        glm::ivec3(1, 0, 0), glm::ivec3(1, 0, 1), glm::ivec3(1, 1, 0), glm::ivec3(1, 1, 1)
+    };
+
+    /** Returns the linear index of a position clamped to a volume. */
+    static uint64_t clampedIndex(const glm::ivec3& pos, const glm::ivec3& size)
+    {
+        auto p = glm::clamp(pos, glm::ivec3(0), size - glm::ivec3(1));
+        return (static_cast<uint64_t>(p.z) * size.y + p.y) * size.x + p.x;
+    }
+
+    /** Calls a function for each voxel of a level in parallel (in rows). */
+    template<typename Fn>
+    static void forEachVoxel(const glm::uvec3& size, unsigned int numThreads, Fn fn)
+    {
+        parallel::ForChunks(static_cast<uint64_t>(size.y) * size.z, 16, [&size, &fn](uint64_t begin, uint64_t end, unsigned int)
+        {
+            for (auto row = begin; row < end; ++row) {
+                glm::ivec3 pos(0, static_cast<int>(row % size.y), static_cast<int>(row / size.y));
+                auto idx = row * size.x;
+                for (; pos.x < static_cast<int>(size.x); ++pos.x, ++idx) fn(pos, idx);
+            }
+        }, numThreads);
+    }
+
+    /** Default constructor. */
+    MinMaxPyramid::MinMaxPyramid() :
+        format(VolumeStorageFormat::UNORM8)
+    {
+    }
+
+    /**
+     *  Constructor, builds the pyramids.
+     *  @param level0 the volume data in storage format.
+     *  @param size the size of the volume.
+     *  @param format the storage format of the volume and the pyramids.
+     *  @param numLevels the number of average levels including level 0.
+     *  @param numThreads the number of threads to use (0 to use all hardware threads).
+     */
+    MinMaxPyramid::MinMaxPyramid(const void* level0, const glm::uvec3& size, VolumeStorageFormat format,
+        unsigned int numLevels, unsigned int numThreads) :
+        format(format)
+    {
+        numLevels = glm::max(1U, glm::min(numLevels, CalcNumLevels(size)));
+        for (unsigned int lvl = 0; lvl < numLevels; ++lvl) levelSizes.push_back(CalcLevelSize(size, lvl));
+
+        auto minMaxSize = CalcLevelSize(size, 2);
+        auto numMinMaxLevels = CalcNumLevels(minMaxSize);
+        for (unsigned int lvl = 0; lvl < numMinMaxLevels; ++lvl) minMaxSizes.push_back(CalcLevelSize(minMaxSize, lvl));
+
+        auto texMax = static_cast<float>(glm::max(glm::max(size.x, size.y), size.z));
+        stepSizes.resize(numLevels, 1.0f / (2.0f * texMax));
+        auto stepSizeFactor = 1.0f;
+        for (unsigned int lvl = 1; lvl < numLevels; ++lvl) {
+            stepSizeFactor *= 2.0f;
+            stepSizes[lvl] *= stepSizeFactor;
+        }
+
+        volumeStorage::WithStorage(format, [this, level0, numThreads](auto storage)
+        {
+            using S = decltype(storage);
+            BuildLevels<S>(reinterpret_cast<const typename S::Type*>(level0), numThreads);
+        });
+    }
+
+    /** Default copy constructor. */
+    MinMaxPyramid::MinMaxPyramid(const MinMaxPyramid&) = default;
+    /** Default copy assignment operator. */
+    MinMaxPyramid& MinMaxPyramid::operator=(const MinMaxPyramid&) = default;
+
+    /** Default move constructor. */
+    MinMaxPyramid::MinMaxPyramid(MinMaxPyramid&& rhs) :
+        format(rhs.format),
+        levelSizes(std::move(rhs.levelSizes)),
+        levels(std::move(rhs.levels)),
+        minMaxSizes(std::move(rhs.minMaxSizes)),
+        minMaxLevels(std::move(rhs.minMaxLevels)),
+        stepSizes(std::move(rhs.stepSizes))
+    {
+    }
+
+    /** Default move assignment operator. */
+    MinMaxPyramid& MinMaxPyramid::operator=(MinMaxPyramid&& rhs)
+    {
+        if (this != &rhs) {
+            format = rhs.format;
+            levelSizes = std::move(rhs.levelSizes);
+            levels = std::move(rhs.levels);
+            minMaxSizes = std::move(rhs.minMaxSizes);
+            minMaxLevels = std::move(rhs.minMaxLevels);
+            stepSizes = std::move(rhs.stepSizes);
+        }
+        return *this;
+    }
+
+    /** Destructor. */
+    MinMaxPyramid::~MinMaxPyramid() = default;
+
+    /**
+     *  Returns the size of a mip map level the way OpenGL computes it.
+     *  @param size the size of level 0.
+     *  @param level the level.
+     *  @return the size of the level.
+     */
+    glm::uvec3 MinMaxPyramid::CalcLevelSize(const glm::uvec3& size, unsigned int level)
+    {
+        return glm::max(glm::uvec3(1), size / glm::uvec3(1 << level));
+    }
+
+    /**
+     *  Returns the number of mip map levels of a volume (down to a size of 1 in the largest dimension).
+     *  @param size the size of level 0.
+     *  @return the number of levels.
+     */
+    unsigned int MinMaxPyramid::CalcNumLevels(const glm::uvec3& size)
+    {
+        auto maxSize = glm::max(glm::max(size.x, size.y), size.z);
+        return 1 + static_cast<unsigned int>(glm::floor(glm::log2(static_cast<float>(maxSize))));
+    }
+
+    /**
+     *  Builds all levels.
+     *  The average levels follow genMipLevels.cp, the first min/max level genMinMax.cp and all other min/max levels
+     *  genMinMaxLevels.cp.
+     *  @param level0 the volume data.
+     *  @param numThreads the number of threads to use.
+     */
+    template<typename S>
+    void MinMaxPyramid::BuildLevels(const typename S::Type* level0, unsigned int numThreads)
+    {
+        using T = typename S::Type;
+
+        levels.resize(levelSizes.size());
+        for (std::size_t lvl = 1; lvl < levelSizes.size(); ++lvl) {
+            auto origData = lvl == 1 ? level0 : reinterpret_cast<const T*>(levels[lvl - 1].data());
+            glm::ivec3 origSize(levelSizes[lvl - 1]);
+            const auto& nextSize = levelSizes[lvl];
+            auto ratio = glm::vec3(origSize) / glm::vec3(nextSize);
+
+            levels[lvl].resize(static_cast<std::size_t>(nextSize.x) * nextSize.y * nextSize.z * sizeof(T));
+            auto nextData = reinterpret_cast<T*>(levels[lvl].data());
+            forEachVoxel(nextSize, numThreads, [origData, &origSize, &ratio, nextData](const glm::ivec3& pos, uint64_t idx)
+            {
+                auto readBasePos = glm::ivec3(glm::vec3(pos) * ratio);
+                auto avg = 0.0f;
+                for (const auto& offset : levelReadOffsets) avg += S::Load(origData[clampedIndex(readBasePos + offset, origSize)]);
+                avg /= 8.0f;
+                nextData[idx] = S::Store(avg);
+            });
+        }
+
+        minMaxLevels.resize(minMaxSizes.size());
+        for (std::size_t lvl = 0; lvl < minMaxSizes.size(); ++lvl) {
+            const auto& nextSize = minMaxSizes[lvl];
+            minMaxLevels[lvl].resize(static_cast<std::size_t>(nextSize.x) * nextSize.y * nextSize.z * 2 * sizeof(T));
+            auto nextData = reinterpret_cast<T*>(minMaxLevels[lvl].data());
+
+            if (lvl == 0) {
+                glm::ivec3 origSize(levelSizes[0]);
+                auto baseReadSize = glm::ivec3(glm::floor(glm::vec3(origSize) / glm::vec3(nextSize)));
+                forEachVoxel(nextSize, numThreads, [level0, &origSize, &baseReadSize, nextData](const glm::ivec3& pos, uint64_t idx)
+                {
+                    auto baseReadPos = pos * baseReadSize;
+                    auto minValue = 1.0f;
+                    auto maxValue = 0.0f;
+                    for (int iz = 0; iz < baseReadSize.z; ++iz) {
+                        for (int iy = 0; iy < baseReadSize.y; ++iy) {
+                            for (int ix = 0; ix < baseReadSize.x; ++ix) {
+                                auto value = S::Load(level0[clampedIndex(baseReadPos + glm::ivec3(ix, iy, iz), origSize)]);
+                                minValue = glm::min(minValue, value);
+                                maxValue = glm::max(maxValue, value);
+                            }
+                        }
+                    }
+                    nextData[2 * idx] = S::Store(minValue);
+                    nextData[2 * idx + 1] = S::Store(maxValue);
+                });
+            } else {
+                auto origData = reinterpret_cast<const T*>(minMaxLevels[lvl - 1].data());
+                glm::ivec3 origSize(minMaxSizes[lvl - 1]);
+                auto ratio = glm::vec3(origSize) / glm::vec3(nextSize);
+                forEachVoxel(nextSize, numThreads, [origData, &origSize, &ratio, nextData](const glm::ivec3& pos, uint64_t idx)
+                {
+                    auto readBasePos = glm::ivec3(glm::vec3(pos) * ratio);
+                    auto minimum = 1.0f;
+                    auto maximum = 0.0f;
+                    for (const auto& offset : levelReadOffsets) {
+                        auto readIdx = clampedIndex(readBasePos + offset, origSize);
+                        minimum = glm::min(minimum, S::Load(origData[2 * readIdx]));
+                        maximum = glm::max(maximum, S::Load(origData[2 * readIdx + 1]));
+                    }
+                    nextData[2 * idx] = S::Store(minimum);
+                    nextData[2 * idx + 1] = S::Store(maximum);
+                });
+            }
+        }
+    }
+
+    /**
+     *  Stores the volume data as level 0, so it is written to and read from the cache with the other levels.
+     *  @param level0 the volume data in the storage format of the pyramid.
+     */
+    void MinMaxPyramid::SetLevel0Data(std::vector<uint8_t>&& level0)
+    {
+        assert(!levels.empty());
+        levels[0] = std::move(level0);
+    }
+
+    /**
+     *  Removes the volume data from level 0 and returns it.
+     *  @return the volume data (empty if it was not set).
+     */
+    std::vector<uint8_t> MinMaxPyramid::ReleaseLevel0Data()
+    {
+        std::vector<uint8_t> result;
+        if (!levels.empty()) std::swap(result, levels[0]);
+        return result;
+    }
+
+    /**
+     *  Loads the pyramids from a cache file.
+     *  @param filename the name of the cache file.
+     *  @param key the key the cache file needs to have.
+     *  @return whether the file existed and matched the key.
+     */
+    bool MinMaxPyramid::LoadFromCache(const std::string& filename, const VolumeCacheKey& key)
+    {
+        auto loaded = volumeCache::ReadCache<VersionableSerializerType>(filename, key, [this](std::istream& ifs)
+        {
+            uint32_t fileFormat;
+            serializeHelper::read(ifs, fileFormat);
+            serializeHelper::readV(ifs, levelSizes);
+            serializeHelper::readVV(ifs, levels);
+            serializeHelper::readV(ifs, minMaxSizes);
+            serializeHelper::readVV(ifs, minMaxLevels);
+            serializeHelper::readV(ifs, stepSizes);
+            format = static_cast<VolumeStorageFormat>(fileFormat);
+            return true;
+        });
+        if (!loaded) *this = MinMaxPyramid();
+        return loaded;
+    }
+
+    /**
+     *  Saves the pyramids to a cache file. Failing to write the cache is not an error.
+     *  @param filename the name of the cache file.
+     *  @param key the key to store with the pyramids.
+     */
+    void MinMaxPyramid::SaveToCache(const std::string& filename, const VolumeCacheKey& key) const
+    {
+        volumeCache::WriteCache<VersionableSerializerType>(filename, key, [this](std::ostream& ofs)
+        {
+            serializeHelper::write(ofs, static_cast<uint32_t>(format));
+            serializeHelper::writeV(ofs, levelSizes);
+            serializeHelper::writeVV(ofs, levels);
+            serializeHelper::writeV(ofs, minMaxSizes);
+            serializeHelper::writeVV(ofs, minMaxLevels);
+            serializeHelper::writeV(ofs, stepSizes);
+        });
+    }
+}
@@ -0,0 +1,88 @@
+/**
+ * @file   MinMaxPyramid.h
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Contains the CPU builder for average and min/max pyramids of volumes.
+ */
+
+#ifndef MINMAXPYRAMID_H
+#define MINMAXPYRAMID_H
+
+#include "main.h"
+#include "gfx/volumes/VolumeStorage.h"
+#include "gfx/volumes/VolumeCache.h"
+#include "core/serializationHelper.h"
+
+namespace cgu {
+
+    /**
+     *  @brief Average and min/max pyramids of a single channel volume.
+     *  The levels are computed on the CPU in the same way as the compute shaders in shader/minmaxmaps do it: Each
+     *  level is read in the storage format of the texture and quantized to it again after each level, so the results
+     *  match the GPU generated levels (assuming the driver rounds to nearest when storing normalized values).
+     *  The average levels start at level 1 (level 0 is the volume itself), the min/max levels start at the size of
+     *  average level 2.
+     *
+     * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+     * @date   2026.10.16
+     */
+    class MinMaxPyramid
+    {
+    public:
+        using VersionableSerializerType = serializeHelper::VersionableSerializer<'M', 'M', 'P', 'Y', 1001>;
+
+        MinMaxPyramid();
+        MinMaxPyramid(const void* level0, const glm::uvec3& size, VolumeStorageFormat format, unsigned int numLevels,
+            unsigned int numThreads = 0);
+        MinMaxPyramid(const MinMaxPyramid&);
+        MinMaxPyramid& operator=(const MinMaxPyramid&);
+        MinMaxPyramid(MinMaxPyramid&&);
+        MinMaxPyramid& operator=(MinMaxPyramid&&);
+        ~MinMaxPyramid();
+
+        bool LoadFromCache(const std::string& filename, const VolumeCacheKey& key);
+        void SaveToCache(const std::string& filename, const VolumeCacheKey& key) const;
+
+        void SetLevel0Data(std::vector<uint8_t>&& level0);
+        std::vector<uint8_t> ReleaseLevel0Data();
+
+        static glm::uvec3 CalcLevelSize(const glm::uvec3& size, unsigned int level);
+        static unsigned int CalcNumLevels(const glm::uvec3& size);
+
+        /** Returns the storage format of all levels. */
+        VolumeStorageFormat GetFormat() const { return format; }
+        /** Returns the number of average levels (including level 0). */
+        unsigned int GetNumLevels() const { return static_cast<unsigned int>(levelSizes.size()); }
+        /** Returns the size of an average level. */
+        const glm::uvec3& GetLevelSize(unsigned int level) const { return levelSizes[level]; }
+        /** Returns the data of an average level (level 0 is only available if it was set with SetLevel0Data). */
+        const std::vector<uint8_t>& GetLevelData(unsigned int level) const { return levels[level]; }
+        /** Returns the number of min/max levels. */
+        unsigned int GetNumMinMaxLevels() const { return static_cast<unsigned int>(minMaxSizes.size()); }
+        /** Returns the size of a min/max level. */
+        const glm::uvec3& GetMinMaxLevelSize(unsigned int level) const { return minMaxSizes[level]; }
+        /** Returns the data of a min/max level (two interleaved values per voxel). */
+        const std::vector<uint8_t>& GetMinMaxLevelData(unsigned int level) const { return minMaxLevels[level]; }
+        /** Returns the ray marching step sizes for each average level. */
+        const std::vector<float>& GetStepSizes() const { return stepSizes; }
+
+    private:
+        template<typename S> void BuildLevels(const typename S::Type* level0, unsigned int numThreads);
+
+        /** Holds the storage format. */
+        VolumeStorageFormat format;
+        /** Holds the sizes of the average levels. */
+        std::vector<glm::uvec3> levelSizes;
+        /** Holds the average levels (level 0 is empty unless it was set). */
+        std::vector<std::vector<uint8_t>> levels;
+        /** Holds the sizes of the min/max levels. */
+        std::vector<glm::uvec3> minMaxSizes;
+        /** Holds the min/max levels. */
+        std::vector<std::vector<uint8_t>> minMaxLevels;
+        /** Holds the step sizes. */
+        std::vector<float> stepSizes;
+    };
+}
+
+#endif // MINMAXPYRAMID_H
@@ -11,13 +11,16 @@
 
 #include "main.h"
 #include "gfx/glrenderer/GLTexture.h"
+#include "gfx/volumes/OccupancyGrid.h"
 
 namespace cgu {
 
     class Volume;
-    class GPUProgram;
     class ArcballCamera;
     class ApplicationBase;
+    namespace tf {
+        class TransferFunction;
+    }
 
     class MinMaxVolume
     {
@@ -31,6 +34,11 @@ namespace cgu {
         const GLTexture* GetMinMaxTexture() const { return minMaxTexture.get(); }
         float GetTexMax() const { return texMax; }
         float GetStepSize(unsigned int mipLevel) const { return stepSizes[mipLevel]; };
+        bool UpdateOccupancy(const tf::TransferFunction& transferFunction);
+        /** Returns the texture containing the occupancy for empty space skipping. */
+        const GLTexture* GetOccupancyTexture() const { return occupancyTexture.get(); }
+        /** Returns the occupancy grid for empty space skipping. */
+        const OccupancyGrid& GetOccupancyGrid() const { return *occupancyGrid; }
 
     private:
         /** Holds the 3D texture object to load from. */
@@ -40,18 +48,10 @@ namespace cgu {
         std::unique_ptr<GLTexture> volumeTexture;
         /** Holds the texture containing the min/max data. */
         std::unique_ptr<GLTexture> minMaxTexture;
-        /** Holds the GPUProgram for generating the lower mip map levels. */
-        std::shared_ptr<GPUProgram> mipLevelsProgram;
-        /** Holds the binding locations for the program generating the lower mip map levels. */
-        std::vector<BindingLocation> mipLevelsUniformNames;
-        /** Holds the GPUProgram for generating the top level min max texture. */
-        std::shared_ptr<GPUProgram> minMaxProgram;
-        /** Holds the binding locations for the program generating the top level min max texture. */
-        std::vector<BindingLocation> minMaxUniformNames;
-        /** Holds the GPUProgram for generating the lower min max levels. */
-        std::shared_ptr<GPUProgram> minMaxLevelsProgram;
-        /** Holds the binding locations for the program generating the lower min max levels. */
-        std::vector<BindingLocation> minMaxLevelsUniformNames;
+        /** Holds the occupancy grid used for empty space skipping. */
+        std::unique_ptr<OccupancyGrid> occupancyGrid;
+        /** Holds the texture containing the occupancy. */
+        std::unique_ptr<GLTexture> occupancyTexture;
 
         /** Holds the volumes size. */
         glm::uvec3 volumeSize;
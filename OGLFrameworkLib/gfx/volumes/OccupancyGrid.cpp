@@ -0,0 +1,309 @@
+/**
+ * @file   OccupancyGrid.cpp
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Implementation of the transfer function dependent occupancy grid for empty space skipping.
+ */
+
+#include "OccupancyGrid.h"
+#include "gfx/glrenderer/GLTexture.h"
+#include "volumeScene/TransferFunction.h"
+#include "core/parallel_helper.h"
+
+namespace cgu {
+
+    /**
+     *  Constructor, computes the value ranges of all cells. All cells are occupied until an opacity table is set.
+     *  @param level0 the volume data in storage format (as returned by Volume::LoadStorageData).
+     *  @param size the size of the volume.
+     *  @param format the storage format of the volume.
+     *  @param cellSize the number of voxels covered by a cell of level 0.
+     *  @param numThreads the number of threads to use (0 to use all hardware threads).
+     */
+    OccupancyGrid::OccupancyGrid(const void* level0, const glm::uvec3& size, VolumeStorageFormat format,
+        const glm::uvec3& cellSize, unsigned int numThreads) :
+        cellSize(cellSize),
+        numThreads(numThreads),
+        dirtyMin(0),
+        dirtyMax(0),
+        dirty(false),
+        lastUpdateCount(0)
+    {
+        assert(glm::all(glm::greaterThan(cellSize, glm::uvec3(0))));
+        levelSizes.push_back((size + cellSize - glm::uvec3(1)) / cellSize);
+        while (glm::any(glm::greaterThan(levelSizes.back(), glm::uvec3(1)))) levelSizes.push_back((levelSizes.back() + glm::uvec3(1)) / 2U);
+
+        ranges.resize(levelSizes.size());
+        occupancy.resize(levelSizes.size());
+        for (std::size_t lvl = 0; lvl < levelSizes.size(); ++lvl) {
+            auto numCells = static_cast<std::size_t>(levelSizes[lvl].x) * levelSizes[lvl].y * levelSizes[lvl].z;
+            ranges[lvl].resize(numCells);
+            occupancy[lvl].resize(numCells, 255);
+        }
+
+        volumeStorage::WithStorage(format, [this, level0, &size](auto storage)
+        {
+            using S = decltype(storage);
+            auto data = reinterpret_cast<const typename S::Type*>(level0);
+            const auto& levelSize = levelSizes[0];
+            auto& levelRanges = ranges[0];
+            parallel::ForChunks(levelRanges.size(), 16, [&](uint64_t begin, uint64_t end, unsigned int)
+            {
+                for (auto i = begin; i < end; ++i) {
+                    glm::uvec3 cell(i % levelSize.x, (i / levelSize.x) % levelSize.y, i / (static_cast<uint64_t>(levelSize.x) * levelSize.y));
+                    auto first = glm::ivec3(cell * this->cellSize) - glm::ivec3(1);
+                    auto last = glm::ivec3((cell + glm::uvec3(1)) * this->cellSize);
+                    first = glm::max(first, glm::ivec3(0));
+                    last = glm::min(last, glm::ivec3(size) - glm::ivec3(1));
+
+                    glm::vec2 range(std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest());
+                    for (auto z = first.z; z <= last.z; ++z) {
+                        for (auto y = first.y; y <= last.y; ++y) {
+                            auto row = data + (static_cast<uint64_t>(z) * size.y + y) * size.x;
+                            for (auto x = first.x; x <= last.x; ++x) {
+                                auto value = S::Load(row[x]);
+                                range.x = glm::min(range.x, value);
+                                range.y = glm::max(range.y, value);
+                            }
+                        }
+                    }
+                    levelRanges[static_cast<std::size_t>(i)] = range;
+                }
+            }, this->numThreads);
+        });
+
+        for (std::size_t lvl = 1; lvl < levelSizes.size(); ++lvl) {
+            const auto& prevSize = levelSizes[lvl - 1];
+            const auto& levelSize = levelSizes[lvl];
+            const auto& prevRanges = ranges[lvl - 1];
+            auto& levelRanges = ranges[lvl];
+            parallel::ForChunks(levelRanges.size(), 256, [&](uint64_t begin, uint64_t end, unsigned int)
+            {
+                for (auto i = begin; i < end; ++i) {
+                    glm::uvec3 cell(i % levelSize.x, (i / levelSize.x) % levelSize.y, i / (static_cast<uint64_t>(levelSize.x) * levelSize.y));
+                    auto childEnd = glm::min(2U * cell + glm::uvec3(2), prevSize);
+                    glm::vec2 range(std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest());
+                    for (auto z = 2 * cell.z; z < childEnd.z; ++z) {
+                        for (auto y = 2 * cell.y; y < childEnd.y; ++y) {
+                            for (auto x = 2 * cell.x; x < childEnd.x; ++x) {
+                                const auto& childRange = prevRanges[static_cast<std::size_t>((static_cast<uint64_t>(z) * prevSize.y + y) * prevSize.x + x)];
+                                range.x = glm::min(range.x, childRange.x);
+                                range.y = glm::max(range.y, childRange.y);
+                            }
+                        }
+                    }
+                    levelRanges[static_cast<std::size_t>(i)] = range;
+                }
+            }, numThreads);
+        }
+    }
+
+    /** Default copy constructor. */
+    OccupancyGrid::OccupancyGrid(const OccupancyGrid&) = default;
+    /** Default copy assignment operator. */
+    OccupancyGrid& OccupancyGrid::operator=(const OccupancyGrid&) = default;
+    /** Default move constructor. */
+    OccupancyGrid::OccupancyGrid(OccupancyGrid&&) = default;
+    /** Default move assignment operator. */
+    OccupancyGrid& OccupancyGrid::operator=(OccupancyGrid&&) = default;
+    /** Destructor. */
+    OccupancyGrid::~OccupancyGrid() = default;
+
+    /**
+     *  Sets the opacity table the volume is rendered with and updates the occupancy.
+     *  The table is interpreted like a linearly filtered 1D texture over the normalized values.
+     *  @param opacities the opacity of each table entry.
+     *  @return whether the occupancy needed to be updated.
+     */
+    bool OccupancyGrid::SetOpacityTable(const std::vector<float>& opacities)
+    {
+        assert(!opacities.empty());
+        std::vector<uint8_t> newVisible(opacities.size());
+        for (std::size_t i = 0; i < opacities.size(); ++i) newVisible[i] = opacities[i] > 0.0f ? 1 : 0;
+
+        auto fullUpdate = newVisible.size() != tableVisible.size();
+        glm::uvec2 changed(std::numeric_limits<unsigned int>::max(), 0);
+        if (!fullUpdate) {
+            for (unsigned int i = 0; i < newVisible.size(); ++i) {
+                if (newVisible[i] == tableVisible[i]) continue;
+                changed.x = glm::min(changed.x, i);
+                changed.y = i;
+            }
+            if (changed.x > changed.y) {
+                lastUpdateCount = 0;
+                return false;
+            }
+        }
+
+        tableVisible = std::move(newVisible);
+        tablePrefix.resize(tableVisible.size() + 1);
+        tablePrefix[0] = 0;
+        for (std::size_t i = 0; i < tableVisible.size(); ++i) tablePrefix[i + 1] = tablePrefix[i] + tableVisible[i];
+
+        lastUpdateCount = 0;
+        if (fullUpdate) UpdateAll();
+        else UpdateCell(GetNumLevels() - 1, glm::uvec3(0), changed);
+        return true;
+    }
+
+    /**
+     *  Sets the transfer function the volume is rendered with and updates the occupancy.
+     *  @param transferFunction the transfer function.
+     *  @param resolution the resolution of the transfer function texture.
+     *  @return whether the occupancy needed to be updated.
+     */
+    bool OccupancyGrid::SetTransferFunction(const tf::TransferFunction& transferFunction, unsigned int resolution)
+    {
+        std::vector<glm::vec4> tableData(resolution);
+        transferFunction.CreateTextureData(tableData.data(), static_cast<int>(resolution));
+        std::vector<float> opacities(resolution);
+        for (unsigned int i = 0; i < resolution; ++i) opacities[i] = tableData[i].w;
+        return SetOpacityTable(opacities);
+    }
+
+    /**
+     *  Returns the entries of the opacity table samples in a value range can be filtered from.
+     *  @param range the value range.
+     *  @return the first and last table entry.
+     */
+    glm::uvec2 OccupancyGrid::GetTableRange(const glm::vec2& range) const
+    {
+        auto tableSize = static_cast<float>(tableVisible.size());
+        auto clampedRange = glm::clamp(range, glm::vec2(0.0f), glm::vec2(1.0f));
+        auto first = glm::floor(clampedRange.x * tableSize - 0.5f);
+        auto last = glm::floor(clampedRange.y * tableSize - 0.5f) + 1.0f;
+        return glm::uvec2(glm::clamp(glm::vec2(first, last), glm::vec2(0.0f), glm::vec2(tableSize - 1.0f)));
+    }
+
+    /**
+     *  Returns whether any value of a range is visible under the current opacity table.
+     *  @param range the value range.
+     *  @return whether the range is visible (always true if no table is set).
+     */
+    bool OccupancyGrid::IsRangeVisible(const glm::vec2& range) const
+    {
+        if (tableVisible.empty()) return true;
+        auto tableRange = GetTableRange(range);
+        return tablePrefix[tableRange.y + 1] - tablePrefix[tableRange.x] > 0;
+    }
+
+    /**
+     *  Updates a cell and its children affected by changed table entries.
+     *  @param level the level of the cell.
+     *  @param cell the cell.
+     *  @param changed the first and last table entry changed.
+     *  @return the occupancy of the cell.
+     */
+    uint8_t OccupancyGrid::UpdateCell(unsigned int level, const glm::uvec3& cell, const glm::uvec2& changed)
+    {
+        ++lastUpdateCount;
+        auto idx = static_cast<std::size_t>(GetCellIndex(level, cell));
+        auto tableRange = GetTableRange(ranges[level][idx]);
+        if (tableRange.y < changed.x || tableRange.x > changed.y) return occupancy[level][idx];
+
+        uint8_t cellOccupancy = 0;
+        if (level == 0) {
+            cellOccupancy = IsRangeVisible(ranges[level][idx]) ? 255 : 0;
+            if (cellOccupancy != occupancy[level][idx]) MarkDirty(cell);
+        } else {
+            auto childEnd = glm::min(2U * cell + glm::uvec3(2), levelSizes[level - 1]);
+            for (auto z = 2 * cell.z; z < childEnd.z; ++z) {
+                for (auto y = 2 * cell.y; y < childEnd.y; ++y) {
+                    for (auto x = 2 * cell.x; x < childEnd.x; ++x) cellOccupancy |= UpdateCell(level - 1, glm::uvec3(x, y, z), changed);
+                }
+            }
+        }
+        occupancy[level][idx] = cellOccupancy;
+        return cellOccupancy;
+    }
+
+    /**
+     *  Classifies all cells.
+     */
+    void OccupancyGrid::UpdateAll()
+    {
+        auto& levelOccupancy = occupancy[0];
+        const auto& levelRanges = ranges[0];
+        parallel::ForChunks(levelOccupancy.size(), 1024, [this, &levelOccupancy, &levelRanges](uint64_t begin, uint64_t end, unsigned int)
+        {
+            for (auto i = begin; i < end; ++i) levelOccupancy[static_cast<std::size_t>(i)] = IsRangeVisible(levelRanges[static_cast<std::size_t>(i)]) ? 255 : 0;
+        }, numThreads);
+
+        for (std::size_t lvl = 1; lvl < levelSizes.size(); ++lvl) {
+            const auto& prevSize = levelSizes[lvl - 1];
+            const auto& levelSize = levelSizes[lvl];
+            const auto& prevOccupancy = occupancy[lvl - 1];
+            auto& nextOccupancy = occupancy[lvl];
+            parallel::ForChunks(nextOccupancy.size(), 256, [&](uint64_t begin, uint64_t end, unsigned int)
+            {
+                for (auto i = begin; i < end; ++i) {
+                    glm::uvec3 cell(i % levelSize.x, (i / levelSize.x) % levelSize.y, i / (static_cast<uint64_t>(levelSize.x) * levelSize.y));
+                    auto childEnd = glm::min(2U * cell + glm::uvec3(2), prevSize);
+                    uint8_t cellOccupancy = 0;
+                    for (auto z = 2 * cell.z; z < childEnd.z; ++z) {
+                        for (auto y = 2 * cell.y; y < childEnd.y; ++y) {
+                            for (auto x = 2 * cell.x; x < childEnd.x; ++x) {
+                                cellOccupancy |= prevOccupancy[static_cast<std::size_t>((static_cast<uint64_t>(z) * prevSize.y + y) * prevSize.x + x)];
+                            }
+                        }
+                    }
+                    nextOccupancy[static_cast<std::size_t>(i)] = cellOccupancy;
+                }
+            }, numThreads);
+        }
+
+        lastUpdateCount = 0;
+        for (const auto& levelOcc : occupancy) lastUpdateCount += levelOcc.size();
+        dirty = true;
+        dirtyMin = glm::uvec3(0);
+        dirtyMax = levelSizes[0] - glm::uvec3(1);
+    }
+
+    /**
+     *  Marks a cell of level 0 as changed for the next texture update.
+     *  @param cell the cell.
+     */
+    void OccupancyGrid::MarkDirty(const glm::uvec3& cell)
+    {
+        if (!dirty) {
+            dirtyMin = dirtyMax = cell;
+            dirty = true;
+        } else {
+            dirtyMin = glm::min(dirtyMin, cell);
+            dirtyMax = glm::max(dirtyMax, cell);
+        }
+    }
+
+    /**
+     *  Creates a texture with the occupancy of level 0 (GL_R8, 0 for empty and 1 for occupied cells).
+     *  @return the texture.
+     */
+    std::unique_ptr<GLTexture> OccupancyGrid::CreateTexture() const
+    {
+        const auto& size = levelSizes[0];
+        return std::make_unique<GLTexture>(size.x, size.y, size.z, 1, TextureDescriptor(1, GL_R8, GL_RED, GL_UNSIGNED_BYTE),
+            occupancy[0].data());
+    }
+
+    /**
+     *  Uploads the cells of level 0 changed since the last update to a texture created by CreateTexture.
+     *  @param texture the texture to update.
+     */
+    void OccupancyGrid::UpdateTexture(GLTexture* texture)
+    {
+        if (!dirty) return;
+        const auto& size = levelSizes[0];
+        auto boxSize = dirtyMax - dirtyMin + glm::uvec3(1);
+        std::vector<uint8_t> boxData(static_cast<std::size_t>(boxSize.x) * boxSize.y * boxSize.z);
+        auto dst = boxData.data();
+        for (auto z = dirtyMin.z; z <= dirtyMax.z; ++z) {
+            for (auto y = dirtyMin.y; y <= dirtyMax.y; ++y, dst += boxSize.x) {
+                auto src = occupancy[0].data() + (static_cast<std::size_t>(z) * size.y + y) * size.x + dirtyMin.x;
+                std::copy(src, src + boxSize.x, dst);
+            }
+        }
+        texture->SetData(0, dirtyMin, boxSize, boxData.data());
+        dirty = false;
+    }
+}
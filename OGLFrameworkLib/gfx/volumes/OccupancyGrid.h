@@ -0,0 +1,103 @@
+/**
+ * @file   OccupancyGrid.h
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Contains the transfer function dependent occupancy grid for empty space skipping.
+ */
+
+#ifndef OCCUPANCYGRID_H
+#define OCCUPANCYGRID_H
+
+#include "main.h"
+#include "gfx/volumes/VolumeStorage.h"
+
+namespace cgu {
+
+    class GLTexture;
+    namespace tf {
+        class TransferFunction;
+    }
+
+    /**
+     *  @brief Hierarchical occupancy grid classifying cells of a volume as transparent under a transfer function.
+     *  Each cell of level 0 stores the value range of its voxels including a one voxel border, so every sample
+     *  trilinearly interpolated inside the cell lies in the range. Coarser levels combine 2x2x2 cells. A cell is
+     *  occupied if the opacity table is non-zero anywhere in the table entries its range can be filtered from,
+     *  which is answered in constant time with a prefix sum over the table.
+     *  When the opacity table changes only the cells whose ranges overlap the changed table entries are visited,
+     *  so moving transfer function control points costs time proportional to the affected cells.
+     *
+     * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+     * @date   2026.10.16
+     */
+    class OccupancyGrid
+    {
+    public:
+        OccupancyGrid(const void* level0, const glm::uvec3& size, VolumeStorageFormat format,
+            const glm::uvec3& cellSize = glm::uvec3(8), unsigned int numThreads = 0);
+        OccupancyGrid(const OccupancyGrid&);
+        OccupancyGrid& operator=(const OccupancyGrid&);
+        OccupancyGrid(OccupancyGrid&&);
+        OccupancyGrid& operator=(OccupancyGrid&&);
+        ~OccupancyGrid();
+
+        bool SetOpacityTable(const std::vector<float>& opacities);
+        bool SetTransferFunction(const tf::TransferFunction& transferFunction, unsigned int resolution = 512);
+        bool IsRangeVisible(const glm::vec2& range) const;
+
+        std::unique_ptr<GLTexture> CreateTexture() const;
+        void UpdateTexture(GLTexture* texture);
+
+        /** Returns the number of levels. */
+        unsigned int GetNumLevels() const { return static_cast<unsigned int>(levelSizes.size()); }
+        /** Returns the number of cells of a level. */
+        const glm::uvec3& GetLevelSize(unsigned int level) const { return levelSizes[level]; }
+        /** Returns the number of voxels covered by a cell of level 0. */
+        const glm::uvec3& GetCellSize() const { return cellSize; }
+        /** Returns the occupancy of a level (0 for empty, 255 for occupied cells). */
+        const std::vector<uint8_t>& GetOccupancy(unsigned int level) const { return occupancy[level]; }
+        /** Returns the value ranges of the cells of a level. */
+        const std::vector<glm::vec2>& GetRanges(unsigned int level) const { return ranges[level]; }
+        /** Returns whether a cell is occupied. */
+        bool IsOccupied(unsigned int level, const glm::uvec3& cell) const { return occupancy[level][GetCellIndex(level, cell)] != 0; }
+        /** Returns the number of cells visited by the last update. */
+        uint64_t GetLastUpdateCount() const { return lastUpdateCount; }
+        /** Returns the linear index of a cell. */
+        uint64_t GetCellIndex(unsigned int level, const glm::uvec3& cell) const
+        {
+            return (static_cast<uint64_t>(cell.z) * levelSizes[level].y + cell.y) * levelSizes[level].x + cell.x;
+        }
+
+    private:
+        glm::uvec2 GetTableRange(const glm::vec2& range) const;
+        uint8_t UpdateCell(unsigned int level, const glm::uvec3& cell, const glm::uvec2& changed);
+        void UpdateAll();
+        void MarkDirty(const glm::uvec3& cell);
+
+        /** Holds the number of voxels covered by a cell. */
+        glm::uvec3 cellSize;
+        /** Holds the number of threads to use. */
+        unsigned int numThreads;
+        /** Holds the sizes of the levels. */
+        std::vector<glm::uvec3> levelSizes;
+        /** Holds the value ranges of the cells of each level. */
+        std::vector<std::vector<glm::vec2>> ranges;
+        /** Holds the occupancy of the cells of each level. */
+        std::vector<std::vector<uint8_t>> occupancy;
+        /** Holds for each table entry whether its opacity is non-zero. */
+        std::vector<uint8_t> tableVisible;
+        /** Holds the prefix sums of tableVisible. */
+        std::vector<uint32_t> tablePrefix;
+        /** Holds the first cell of level 0 changed since the last texture update. */
+        glm::uvec3 dirtyMin;
+        /** Holds the last cell of level 0 changed since the last texture update. */
+        glm::uvec3 dirtyMax;
+        /** Holds whether any cell changed since the last texture update. */
+        bool dirty;
+        /** Holds the number of cells visited by the last update. */
+        uint64_t lastUpdateCount;
+    };
+}
+
+#endif // OCCUPANCYGRID_H
@@ -0,0 +1,158 @@
+/**
+ * @file   ProgressiveVolumeLoad.cpp
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Implementation of the progressive loading of volume textures.
+ */
+
+#include "ProgressiveVolumeLoad.h"
+
+namespace cgu {
+
+    /**
+     *  Constructor, starts loading a volume progressively on a background thread.
+     *  @param volume the volume to load.
+     *  @param maxCoarseSize the maximum size of the coarsest level in each dimension.
+     *  @param maxSlabSize the maximum number of bytes uploaded at once.
+     */
+    ProgressiveVolumeLoad::ProgressiveVolumeLoad(std::shared_ptr<const Volume> volume, unsigned int maxCoarseSize, uint64_t maxSlabSize) :
+        ProgressiveVolumeLoad(CalcCoarseStride(volume->GetSize(), maxCoarseSize), [volume](unsigned int stride, const AsyncVolumeLoad::ProgressFunction& reportProgress)
+    {
+        return stride == 1 ? volume->LoadTextureData(reportProgress) : volume->LoadStridedTextureData(stride);
+    }, maxSlabSize)
+    {
+        this->volume = std::move(volume);
+    }
+
+    /**
+     *  Constructor, starts loading levels with a custom function on a background thread.
+     *  @param coarseStride the stride of the coarsest level (rounded down to a power of two).
+     *  @param levelFunction the function loading a level.
+     *  @param maxSlabSize the maximum number of bytes uploaded at once.
+     */
+    ProgressiveVolumeLoad::ProgressiveVolumeLoad(unsigned int coarseStride, LevelFunction levelFunction, uint64_t maxSlabSize) :
+        numLevels(1),
+        version(0),
+        uploadedVersion(0),
+        uploadLevelVersion(0),
+        upload(maxSlabSize),
+        state(VolumeLoadState::LOADING),
+        canceled(false)
+    {
+        while ((2U << (numLevels - 1)) <= coarseStride) ++numLevels;
+        Start(std::move(levelFunction));
+    }
+
+    /** Destructor, cancels the load and waits for the background thread. */
+    ProgressiveVolumeLoad::~ProgressiveVolumeLoad()
+    {
+        Cancel();
+        if (loadResult.valid()) loadResult.wait();
+    }
+
+    /**
+     *  Returns the stride of the coarsest level (a power of two) for a volume.
+     *  @param size the size of the volume.
+     *  @param maxCoarseSize the maximum size of the coarsest level in each dimension.
+     *  @return the stride.
+     */
+    unsigned int ProgressiveVolumeLoad::CalcCoarseStride(const glm::uvec3& size, unsigned int maxCoarseSize)
+    {
+        auto maxSize = glm::max(glm::max(size.x, size.y), size.z);
+        unsigned int stride = 1;
+        while ((maxSize + stride - 1) / stride > glm::max(maxCoarseSize, 1U)) stride *= 2;
+        return stride;
+    }
+
+    /**
+     *  Starts the background thread.
+     *  @param levelFunction the function loading a level.
+     */
+    void ProgressiveVolumeLoad::Start(LevelFunction levelFunction)
+    {
+        loadResult = std::async(std::launch::async, [this, levelFunction]()
+        {
+            for (unsigned int lvl = 0; lvl < numLevels && !canceled; ++lvl) {
+                auto level = std::make_shared<ProgressiveVolumeLevel>();
+                level->level = lvl;
+                level->stride = GetStride(lvl);
+                try {
+                    level->data = levelFunction(level->stride, [this](float) { return !canceled; });
+                }
+                catch (const std::exception& e) {
+                    std::lock_guard<std::mutex> lock(levelMutex);
+                    errorMessage = e.what();
+                    LOG(ERROR) << "Loading volume level " << lvl << " failed: " << errorMessage.c_str();
+                    state = VolumeLoadState::FAILED;
+                    return;
+                }
+                if (canceled || level->data.data.empty()) break;
+
+                std::lock_guard<std::mutex> lock(levelMutex);
+                latestLevel = std::move(level);
+                ++version;
+            }
+            state = version == numLevels ? VolumeLoadState::FINISHED : VolumeLoadState::CANCELED;
+        });
+    }
+
+    /**
+     *  Cancels the load. The background thread stops after the current level (or at its next progress report).
+     */
+    void ProgressiveVolumeLoad::Cancel()
+    {
+        canceled = true;
+    }
+
+    /**
+     *  Returns the newest level loaded.
+     *  @return the level or nullptr if no level is loaded yet.
+     */
+    std::shared_ptr<const ProgressiveVolumeLevel> ProgressiveVolumeLoad::GetLatestLevel() const
+    {
+        std::lock_guard<std::mutex> lock(levelMutex);
+        return latestLevel;
+    }
+
+    /**
+     *  Uploads the newest level if it was not uploaded yet, has to be called from the thread the sink uploads on
+     *  (e.g. once per frame). Slabs of slices are uploaded until the time budget is used up, at least one slab is
+     *  uploaded per call. The level callback is called after the last slab of a level.
+     *  @param sink the sink to upload to.
+     *  @param timeBudget the time that may be spent uploading.
+     *  @return whether the upload of a level was completed.
+     */
+    bool ProgressiveVolumeLoad::Update(VolumeUploadSink& sink, std::chrono::microseconds timeBudget)
+    {
+        auto startTime = std::chrono::steady_clock::now();
+        if (version != uploadedVersion && version != uploadLevelVersion) {
+            {
+                std::lock_guard<std::mutex> lock(levelMutex);
+                uploadLevel = latestLevel;
+                uploadLevelVersion = version;
+            }
+            upload.Begin(sink, uploadLevel->data);
+        }
+        if (!uploadLevel) return false;
+
+        if (!upload.Continue(startTime, timeBudget)) return false;
+        auto level = std::move(uploadLevel);
+        uploadLevel.reset();
+        uploadedVersion = uploadLevelVersion;
+        if (levelCallback) levelCallback(*level);
+        return true;
+    }
+
+    /**
+     *  Waits for the background thread and uploads the final level.
+     *  @param sink the sink to upload to.
+     *  @return the final state.
+     */
+    VolumeLoadState ProgressiveVolumeLoad::Wait(VolumeUploadSink& sink)
+    {
+        if (loadResult.valid()) loadResult.wait();
+        Update(sink);
+        return state;
+    }
+}
@@ -0,0 +1,116 @@
+/**
+ * @file   ProgressiveVolumeLoad.h
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Contains the progressive loading of volume textures.
+ */
+
+#ifndef PROGRESSIVEVOLUMELOAD_H
+#define PROGRESSIVEVOLUMELOAD_H
+
+#include "main.h"
+#include "gfx/volumes/AsyncVolumeLoad.h"
+#include <mutex>
+
+namespace cgu {
+
+    /** A level of a progressively loaded volume. */
+    struct ProgressiveVolumeLevel
+    {
+        /** Holds the index of the level (0 is the coarsest level). */
+        unsigned int level;
+        /** Holds the distance between the loaded voxels. */
+        unsigned int stride;
+        /** Holds the converted data of the level. */
+        VolumeTextureData data;
+    };
+
+    /**
+     *  @brief Handle of a volume loaded progressively.
+     *  A background thread loads every stride-th voxel of the volume, starting with a coarse stride that is halved
+     *  for each level until the full resolution (stride 1) is loaded. The full resolution level is loaded with
+     *  Volume::LoadTextureData, so it is exactly the data Load3DTexture would upload. Each finished level increments
+     *  the version. Update uploads the newest level in slabs of z slices within a time budget per call (see
+     *  VolumeSlabUpload) and calls the level callback once the level is complete. Levels that were overtaken are
+     *  skipped, an unfinished upload is restarted with a newer level.
+     *
+     * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+     * @date   2026.10.16
+     */
+    class ProgressiveVolumeLoad
+    {
+    public:
+        /** The function loading a level on the background thread (see Volume::LoadStridedTextureData). */
+        using LevelFunction = std::function<VolumeTextureData(unsigned int stride, const AsyncVolumeLoad::ProgressFunction& reportProgress)>;
+        /** The function called after a level was uploaded. */
+        using LevelCallback = std::function<void(const ProgressiveVolumeLevel& level)>;
+
+        explicit ProgressiveVolumeLoad(std::shared_ptr<const Volume> volume, unsigned int maxCoarseSize = 64,
+            uint64_t maxSlabSize = 16 * 1024 * 1024);
+        ProgressiveVolumeLoad(unsigned int coarseStride, LevelFunction levelFunction, uint64_t maxSlabSize = 16 * 1024 * 1024);
+        ProgressiveVolumeLoad(const ProgressiveVolumeLoad&) = delete;
+        ProgressiveVolumeLoad& operator=(const ProgressiveVolumeLoad&) = delete;
+        ~ProgressiveVolumeLoad();
+
+        bool Update(VolumeUploadSink& sink, std::chrono::microseconds timeBudget = std::chrono::microseconds::max());
+        VolumeLoadState Wait(VolumeUploadSink& sink);
+        void Cancel();
+        std::shared_ptr<const ProgressiveVolumeLevel> GetLatestLevel() const;
+
+        static unsigned int CalcCoarseStride(const glm::uvec3& size, unsigned int maxCoarseSize);
+
+        /** Sets the function called after a level was uploaded. */
+        void SetLevelCallback(LevelCallback callback) { levelCallback = std::move(callback); }
+        /** Returns the volume loaded (nullptr if loaded by a custom function). */
+        const std::shared_ptr<const Volume>& GetVolume() const { return volume; }
+        /** Returns the number of levels. */
+        unsigned int GetNumLevels() const { return numLevels; }
+        /** Returns the stride of a level. */
+        unsigned int GetStride(unsigned int level) const { return 1U << (numLevels - level - 1); }
+        /** Returns the number of levels loaded so far (increases each time a level is finished). */
+        uint64_t GetVersion() const { return version; }
+        /** Returns the number of levels uploaded so far. */
+        uint64_t GetUploadedVersion() const { return uploadedVersion; }
+        /** Returns the state of the background thread (LOADING, FINISHED, CANCELED or FAILED). */
+        VolumeLoadState GetState() const { return state; }
+        /** Returns whether the full resolution level is loaded. */
+        bool IsFinalLevelLoaded() const { return version == numLevels; }
+        /** Returns the error message if loading failed. */
+        std::string GetError() const { std::lock_guard<std::mutex> lock(levelMutex); return errorMessage; }
+
+    private:
+        void Start(LevelFunction levelFunction);
+
+        /** Holds the volume loaded. */
+        std::shared_ptr<const Volume> volume;
+        /** Holds the number of levels. */
+        unsigned int numLevels;
+        /** Holds the result of the background thread. */
+        std::future<void> loadResult;
+        /** Holds the newest level loaded. */
+        std::shared_ptr<const ProgressiveVolumeLevel> latestLevel;
+        /** Holds the function called after a level was uploaded. */
+        LevelCallback levelCallback;
+        /** Holds the number of levels loaded. */
+        std::atomic<uint64_t> version;
+        /** Holds the number of levels uploaded. */
+        uint64_t uploadedVersion;
+        /** Holds the level currently uploaded. */
+        std::shared_ptr<const ProgressiveVolumeLevel> uploadLevel;
+        /** Holds the version of the level currently uploaded. */
+        uint64_t uploadLevelVersion;
+        /** Holds the slab wise upload of the current level. */
+        VolumeSlabUpload upload;
+        /** Holds the state of the background thread. */
+        std::atomic<VolumeLoadState> state;
+        /** Holds whether the load was canceled. */
+        std::atomic<bool> canceled;
+        /** Holds the error message. */
+        std::string errorMessage;
+        /** Holds the mutex for the latest level and the error message. */
+        mutable std::mutex levelMutex;
+    };
+}
+
+#endif // PROGRESSIVEVOLUMELOAD_H
@@ -0,0 +1,93 @@
+/**
+ * @file   RawVolumeSource.cpp
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Implementation of the memory mapped source for raw volume data.
+ */
+
+#include "RawVolumeSource.h"
+#include <codecvt>
+#include <ios>
+
+namespace cgu {
+
+    /**
+     *  Constructor.
+     *  @param rawFilename the file name of the raw file.
+     *  @param dataOffset the offset of the first voxel in the file in bytes.
+     *  @param layout the layout of the data (the data pointer is ignored, a voxel stride of 0 means packed voxels).
+     */
+    RawVolumeSource::RawVolumeSource(const std::string& rawFilename, uint64_t dataOffset, const VolumeDataView& layout) :
+        filename(rawFilename),
+        view(layout)
+    {
+        try {
+            rawFile.open(filename);
+        }
+        catch (const std::ios_base::failure&) {}
+
+        if (!rawFile.is_open()) {
+            std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+            LOG(ERROR) << "Could not open file '" << converter.from_bytes(filename) << "'.";
+            throw std::runtime_error("Could not open file '" + filename + "'.");
+        }
+
+        if (view.voxelStride == 0) view.voxelStride = view.bytesPerVoxel;
+        if (dataOffset + view.GetNumBytes() > GetFileSize()) {
+            std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+            LOG(ERROR) << "File '" << converter.from_bytes(filename) << "' is too small for the volume described ("
+                << GetFileSize() << " bytes, " << dataOffset + view.GetNumBytes() << " bytes needed).";
+            throw std::runtime_error("File '" + filename + "' is too small for the volume described.");
+        }
+
+        view.data = reinterpret_cast<const uint8_t*>(rawFile.data()) + dataOffset;
+    }
+
+    /**
+     *  Constructor for data decoded to memory.
+     *  @param sourceFilename the file name the data was decoded from.
+     *  @param decodedData the tightly packed voxels, the data is shared and not copied.
+     *  @param layout the layout of the data (the data pointer and voxel stride are ignored).
+     */
+    RawVolumeSource::RawVolumeSource(const std::string& sourceFilename, std::shared_ptr<const std::vector<uint8_t>> decodedData,
+        const VolumeDataView& layout) :
+        filename(sourceFilename),
+        decodedData(std::move(decodedData)),
+        view(layout)
+    {
+        view.voxelStride = view.bytesPerVoxel;
+        if (view.GetNumBytes() > GetFileSize()) {
+            std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+            LOG(ERROR) << "Data decoded from '" << converter.from_bytes(filename) << "' is too small for the volume described.";
+            throw std::runtime_error("Data decoded from '" + filename + "' is too small for the volume described.");
+        }
+        view.data = this->decodedData->data();
+    }
+
+    /** Default move constructor. */
+    RawVolumeSource::RawVolumeSource(RawVolumeSource&& rhs) :
+        filename(std::move(rhs.filename)),
+        rawFile(std::move(rhs.rawFile)),
+        decodedData(std::move(rhs.decodedData)),
+        view(rhs.view)
+    {
+        rhs.view.data = nullptr;
+    }
+
+    /** Default move assignment operator. */
+    RawVolumeSource& RawVolumeSource::operator=(RawVolumeSource&& rhs)
+    {
+        if (this != &rhs) {
+            filename = std::move(rhs.filename);
+            rawFile = std::move(rhs.rawFile);
+            decodedData = std::move(rhs.decodedData);
+            view = rhs.view;
+            rhs.view.data = nullptr;
+        }
+        return *this;
+    }
+
+    /** Destructor. */
+    RawVolumeSource::~RawVolumeSource() = default;
+}
@@ -0,0 +1,107 @@
+/**
+ * @file   RawVolumeSource.h
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Contains a memory mapped source for raw volume data.
+ */
+
+#ifndef RAWVOLUMESOURCE_H
+#define RAWVOLUMESOURCE_H
+
+#include "main.h"
+#include <boost/iostreams/device/mapped_file.hpp>
+
+namespace cgu {
+
+    /**
+     *  @brief Read-only view on raw volume data.
+     *  The view does not own the data it points to, it can be created on memory mapped files as well as on
+     *  data held in memory.
+     */
+    struct VolumeDataView
+    {
+        VolumeDataView() : data{ nullptr }, size{ 0 }, voxelStride{ 0 }, bytesPerVoxel{ 0 }, numComponents{ 1 },
+            type{ GL_UNSIGNED_BYTE }, scaleValue{ 1 } {}
+
+        /** Holds a pointer to the first voxel. */
+        const uint8_t* data;
+        /** Holds the volumes dimensions. */
+        glm::uvec3 size;
+        /** Holds the number of bytes between two consecutive voxels. */
+        uint64_t voxelStride;
+        /** Holds the number of bytes used by a single voxel. */
+        unsigned int bytesPerVoxel;
+        /** Holds the number of components of each voxel. */
+        unsigned int numComponents;
+        /** Holds the (OpenGL) type of each component. */
+        GLenum type;
+        /** Holds a scale value for the stored data (e.g. 16 for 12 bit data stored in 16 bit). */
+        unsigned int scaleValue;
+
+        /** Returns the number of voxels. */
+        uint64_t GetNumVoxels() const { return static_cast<uint64_t>(size.x) * static_cast<uint64_t>(size.y) * static_cast<uint64_t>(size.z); }
+        /** Returns the number of bytes spanned by the view. */
+        uint64_t GetNumBytes() const { return GetNumVoxels() == 0 ? 0 : (GetNumVoxels() - 1) * voxelStride + bytesPerVoxel; }
+        /** Returns the size of a single component in bytes. */
+        unsigned int GetComponentSize() const { return bytesPerVoxel / numComponents; }
+        /** Returns whether the voxels are tightly packed. */
+        bool IsContiguous() const { return voxelStride == bytesPerVoxel; }
+        /** Returns the linear index of a voxel position. */
+        uint64_t GetIndex(const glm::uvec3& pos) const
+        {
+            return (static_cast<uint64_t>(pos.z) * size.y + pos.y) * size.x + pos.x;
+        }
+        /** Returns a pointer to the voxel with the given linear index. */
+        const uint8_t* GetVoxel(uint64_t idx) const { return data + idx * voxelStride; }
+        /** Returns a pointer to the voxel at the given position. */
+        const uint8_t* GetVoxel(const glm::uvec3& pos) const { return GetVoxel(GetIndex(pos)); }
+        /** Returns a view on the slices [firstSlice, endSlice). */
+        VolumeDataView GetSlices(unsigned int firstSlice, unsigned int endSlice) const
+        {
+            auto slices = *this;
+            slices.size.z = endSlice - firstSlice;
+            if (data != nullptr) slices.data = GetVoxel(glm::uvec3(0, 0, firstSlice));
+            return slices;
+        }
+    };
+
+    /**
+     *  @brief Memory maps a raw volume file.
+     *  The data is never copied, the operating system pages it in as needed. Files larger than 4GB are supported on
+     *  64 bit systems. Alternatively the source can hold data decoded to memory (e.g. from a compressed volume).
+     *
+     * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+     * @date   2026.10.16
+     */
+    class RawVolumeSource
+    {
+    public:
+        RawVolumeSource(const std::string& rawFilename, uint64_t dataOffset, const VolumeDataView& layout);
+        RawVolumeSource(const std::string& sourceFilename, std::shared_ptr<const std::vector<uint8_t>> decodedData, const VolumeDataView& layout);
+        RawVolumeSource(const RawVolumeSource&) = delete;
+        RawVolumeSource& operator=(const RawVolumeSource&) = delete;
+        RawVolumeSource(RawVolumeSource&&);
+        RawVolumeSource& operator=(RawVolumeSource&&);
+        ~RawVolumeSource();
+
+        /** Returns the view on the mapped data. */
+        const VolumeDataView& GetView() const { return view; }
+        /** Returns the size of the mapped file (or the decoded data) in bytes. */
+        uint64_t GetFileSize() const { return rawFile.is_open() ? static_cast<uint64_t>(rawFile.size()) : (decodedData ? static_cast<uint64_t>(decodedData->size()) : 0); }
+        /** Returns the name of the mapped file. */
+        const std::string& GetFilename() const { return filename; }
+
+    private:
+        /** Holds the raw files name. */
+        std::string filename;
+        /** Holds the memory mapped file. */
+        boost::iostreams::mapped_file_source rawFile;
+        /** Holds the data if it was decoded to memory (may be shared with other sources). */
+        std::shared_ptr<const std::vector<uint8_t>> decodedData;
+        /** Holds the view on the volume data. */
+        VolumeDataView view;
+    };
+}
+
+#endif // RAWVOLUMESOURCE_H
@@ -0,0 +1,203 @@
+/**
+ * @file   SPHCoefficients.cpp
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Implementation of the CPU projection of volumes to spherical harmonics shells.
+ */
+
+#include "SPHCoefficients.h"
+#include "MinMaxPyramid.h"
+#include "core/parallel_helper.h"
+
+namespace cgu {
+
+    /** Default constructor. */
+    SPHCoefficients::SPHCoefficients() :
+        format(VolumeStorageFormat::UNORM8)
+    {
+    }
+
+    /**
+     *  Constructor, computes the coefficients of all levels.
+     *  @param level0 the volume data in storage format.
+     *  @param size the size of the volume.
+     *  @param format the storage format of the volume and the coefficients.
+     *  @param numThreads the number of threads to use (0 to use all hardware threads).
+     */
+    SPHCoefficients::SPHCoefficients(const void* level0, const glm::uvec3& size, VolumeStorageFormat format, unsigned int numThreads) :
+        format(format)
+    {
+        auto baseSize = CalcBaseSize(size);
+        auto numLevels = CalcNumLevels(size);
+        for (unsigned int lvl = 0; lvl < numLevels; ++lvl) levelSizes.push_back(MinMaxPyramid::CalcLevelSize(baseSize, lvl));
+        for (auto& shell : shells) shell.resize(numLevels);
+
+        volumeStorage::WithStorage(format, [this, level0, &size, numThreads](auto storage)
+        {
+            using S = decltype(storage);
+            for (unsigned int lvl = 0; lvl < GetNumLevels(); ++lvl) {
+                ProjectLevel<S>(reinterpret_cast<const typename S::Type*>(level0), size, lvl, numThreads);
+            }
+        });
+    }
+
+    /** Default copy constructor. */
+    SPHCoefficients::SPHCoefficients(const SPHCoefficients&) = default;
+    /** Default copy assignment operator. */
+    SPHCoefficients& SPHCoefficients::operator=(const SPHCoefficients&) = default;
+
+    /** Default move constructor. */
+    SPHCoefficients::SPHCoefficients(SPHCoefficients&& rhs) :
+        format(rhs.format),
+        levelSizes(std::move(rhs.levelSizes)),
+        shells(std::move(rhs.shells))
+    {
+    }
+
+    /** Default move assignment operator. */
+    SPHCoefficients& SPHCoefficients::operator=(SPHCoefficients&& rhs)
+    {
+        if (this != &rhs) {
+            format = rhs.format;
+            levelSizes = std::move(rhs.levelSizes);
+            shells = std::move(rhs.shells);
+        }
+        return *this;
+    }
+
+    /** Destructor. */
+    SPHCoefficients::~SPHCoefficients() = default;
+
+    /**
+     *  Returns the size of the first coefficient level (the size of mip level 2 of the volume).
+     *  @param size the size of the volume.
+     *  @return the size of the first level.
+     */
+    glm::uvec3 SPHCoefficients::CalcBaseSize(const glm::uvec3& size)
+    {
+        return MinMaxPyramid::CalcLevelSize(size, 2);
+    }
+
+    /**
+     *  Returns the number of coefficient levels (the coarsest four mip levels are not computed).
+     *  @param size the size of the volume.
+     *  @return the number of levels (at least one).
+     */
+    unsigned int SPHCoefficients::CalcNumLevels(const glm::uvec3& size)
+    {
+        auto numBaseLevels = MinMaxPyramid::CalcNumLevels(CalcBaseSize(size));
+        return numBaseLevels > 5 ? numBaseLevels - 4 : 1;
+    }
+
+    /**
+     *  Evaluates the (unnormalized) SH basis functions of the first two bands the way the shader does.
+     *  @param dir the normalized direction.
+     *  @return the basis functions (constant, y, z, x).
+     */
+    glm::vec4 SPHCoefficients::EvalBasis(const glm::vec3& dir)
+    {
+        return glm::vec4(1.0f, dir.y, dir.z, dir.x);
+    }
+
+    /**
+     *  Computes the coefficients of a single level.
+     *  @param level0 the volume data.
+     *  @param size the size of the volume.
+     *  @param level the level to compute.
+     *  @param numThreads the number of threads to use.
+     */
+    template<typename S>
+    void SPHCoefficients::ProjectLevel(const typename S::Type* level0, const glm::uvec3& size, unsigned int level, unsigned int numThreads)
+    {
+        const auto& levelSize = levelSizes[level];
+        auto origSize = glm::ivec3(size);
+        auto baseReadSize = glm::ivec3(glm::floor(glm::vec3(size) / glm::vec3(levelSize)));
+        auto relMidPos = 0.5f * glm::vec3(baseReadSize);
+        auto halfVoxelRadius = static_cast<float>(baseReadSize.x) * 0.5f;
+        auto halfVoxelRadSq = halfVoxelRadius * halfVoxelRadius;
+
+        // the basis and shell of each position in the block are the same for all voxels.
+        std::vector<glm::vec4> blockBasis;
+        std::vector<unsigned int> blockShell;
+        std::vector<glm::ivec3> blockOffsets;
+        for (auto ix = 0; ix < baseReadSize.x; ++ix) {
+            for (auto iy = 0; iy < baseReadSize.y; ++iy) {
+                for (auto iz = 0; iz < baseReadSize.z; ++iz) {
+                    auto relPos = glm::vec3(ix, iy, iz) - relMidPos;
+                    auto distSq = glm::dot(relPos, relPos);
+                    blockBasis.push_back(EvalBasis(distSq > 0.0f ? glm::normalize(relPos) : glm::vec3(0.0f)));
+                    blockShell.push_back(distSq > halfVoxelRadSq ? 1 : 0);
+                    blockOffsets.emplace_back(ix, iy, iz);
+                }
+            }
+        }
+
+        auto numVoxels = static_cast<std::size_t>(levelSize.x) * levelSize.y * levelSize.z;
+        for (auto& shell : shells) shell[level].resize(numVoxels * 4 * sizeof(typename S::Type));
+        auto shell0Data = reinterpret_cast<typename S::Type*>(shells[0][level].data());
+        auto shell1Data = reinterpret_cast<typename S::Type*>(shells[1][level].data());
+
+        parallel::ForChunks(static_cast<uint64_t>(levelSize.y) * levelSize.z, 16, [&](uint64_t begin, uint64_t end, unsigned int)
+        {
+            for (auto row = begin; row < end; ++row) {
+                glm::ivec3 storePos(0, static_cast<int>(row % levelSize.y), static_cast<int>(row / levelSize.y));
+                for (; storePos.x < static_cast<int>(levelSize.x); ++storePos.x) {
+                    auto baseReadPos = storePos * baseReadSize;
+                    std::array<glm::vec4, NUM_SHELLS> shell{ { glm::vec4(0.0f), glm::vec4(0.0f) } };
+                    std::array<float, NUM_SHELLS> numShell{ { 0.0f, 0.0f } };
+                    for (std::size_t i = 0; i < blockOffsets.size(); ++i) {
+                        auto readPos = glm::clamp(baseReadPos + blockOffsets[i], glm::ivec3(0), origSize - glm::ivec3(1));
+                        auto value = S::Load(level0[(static_cast<uint64_t>(readPos.z) * size.y + readPos.y) * size.x + readPos.x]);
+                        numShell[blockShell[i]] += 1.0f;
+                        shell[blockShell[i]] += value * blockBasis[i];
+                    }
+
+                    auto idx = (row * levelSize.x + storePos.x) * 4;
+                    for (unsigned int s = 0; s < NUM_SHELLS; ++s) {
+                        if (numShell[s] > 0.0f) shell[s] /= numShell[s];
+                        auto result = (shell[s] + glm::vec4(1.0f)) * 0.5f;
+                        auto dst = s == 0 ? shell0Data : shell1Data;
+                        for (int c = 0; c < 4; ++c) dst[idx + c] = S::Store(result[c]);
+                    }
+                }
+            }
+        }, numThreads);
+    }
+
+    /**
+     *  Loads the coefficients from a cache file.
+     *  @param filename the name of the cache file.
+     *  @param key the key the cache needs to match.
+     *  @return whether the coefficients were loaded.
+     */
+    bool SPHCoefficients::LoadFromCache(const std::string& filename, const VolumeCacheKey& key)
+    {
+        auto loaded = volumeCache::ReadCache<VersionableSerializerType>(filename, key, [this](std::istream& ifs)
+        {
+            uint32_t fileFormat;
+            serializeHelper::read(ifs, fileFormat);
+            serializeHelper::readV(ifs, levelSizes);
+            for (auto& shell : shells) serializeHelper::readVV(ifs, shell);
+            format = static_cast<VolumeStorageFormat>(fileFormat);
+            return true;
+        });
+        if (!loaded) *this = SPHCoefficients();
+        return loaded;
+    }
+
+    /**
+     *  Saves the coefficients to a cache file. Failing to write the cache is not an error.
+     *  @param filename the name of the cache file.
+     *  @param key the key to store with the coefficients.
+     */
+    void SPHCoefficients::SaveToCache(const std::string& filename, const VolumeCacheKey& key) const
+    {
+        volumeCache::WriteCache<VersionableSerializerType>(filename, key, [this](std::ostream& ofs)
+        {
+            serializeHelper::write(ofs, static_cast<uint32_t>(format));
+            serializeHelper::writeV(ofs, levelSizes);
+            for (const auto& shell : shells) serializeHelper::writeVV(ofs, shell);
+        });
+    }
+}
@@ -0,0 +1,74 @@
+/**
+ * @file   SPHCoefficients.h
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Contains the CPU projection of volumes to spherical harmonics shells.
+ */
+
+#ifndef SPHCOEFFICIENTS_H
+#define SPHCOEFFICIENTS_H
+
+#include "main.h"
+#include "gfx/volumes/VolumeStorage.h"
+#include "gfx/volumes/VolumeCache.h"
+#include "core/serializationHelper.h"
+
+namespace cgu {
+
+    /**
+     *  @brief Spherical harmonics coefficient volumes of a single channel volume.
+     *  The coefficients are computed on the CPU in the same way as shader/sphvolumes/genSPHMap.cp does: Each voxel
+     *  of a level projects the block of original voxels it covers onto the first two SH bands, split into an inner
+     *  and an outer shell. The input is read in its storage format and the results are quantized to the RGBA
+     *  version of it, summation order is the same as in the shader.
+     *  Where the shader is undefined (normalizing the zero vector at the block center, empty shells) the center
+     *  voxel only contributes to the constant band and empty shells are zero.
+     *
+     * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+     * @date   2026.10.16
+     */
+    class SPHCoefficients
+    {
+    public:
+        using VersionableSerializerType = serializeHelper::VersionableSerializer<'S', 'P', 'H', 'C', 1001>;
+        /** The number of shells. */
+        static const unsigned int NUM_SHELLS = 2;
+
+        SPHCoefficients();
+        SPHCoefficients(const void* level0, const glm::uvec3& size, VolumeStorageFormat format, unsigned int numThreads = 0);
+        SPHCoefficients(const SPHCoefficients&);
+        SPHCoefficients& operator=(const SPHCoefficients&);
+        SPHCoefficients(SPHCoefficients&&);
+        SPHCoefficients& operator=(SPHCoefficients&&);
+        ~SPHCoefficients();
+
+        bool LoadFromCache(const std::string& filename, const VolumeCacheKey& key);
+        void SaveToCache(const std::string& filename, const VolumeCacheKey& key) const;
+
+        static glm::uvec3 CalcBaseSize(const glm::uvec3& size);
+        static unsigned int CalcNumLevels(const glm::uvec3& size);
+        static glm::vec4 EvalBasis(const glm::vec3& dir);
+
+        /** Returns the storage format of the coefficient volumes (four values per voxel). */
+        VolumeStorageFormat GetFormat() const { return format; }
+        /** Returns the number of levels. */
+        unsigned int GetNumLevels() const { return static_cast<unsigned int>(levelSizes.size()); }
+        /** Returns the size of a level. */
+        const glm::uvec3& GetLevelSize(unsigned int level) const { return levelSizes[level]; }
+        /** Returns the coefficients of a shell at a level (RGBA in storage format). */
+        const std::vector<uint8_t>& GetLevelData(unsigned int shell, unsigned int level) const { return shells[shell][level]; }
+
+    private:
+        template<typename S> void ProjectLevel(const typename S::Type* level0, const glm::uvec3& size, unsigned int level, unsigned int numThreads);
+
+        /** Holds the storage format. */
+        VolumeStorageFormat format;
+        /** Holds the sizes of the levels. */
+        std::vector<glm::uvec3> levelSizes;
+        /** Holds the levels of each shell. */
+        std::array<std::vector<std::vector<uint8_t>>, NUM_SHELLS> shells;
+    };
+}
+
+#endif // SPHCOEFFICIENTS_H
@@ -8,6 +8,7 @@
 
 #include "SPHVolume.h"
 #include "gfx/volumes/Volume.h"
+#include "gfx/volumes/SPHCoefficients.h"
 #include "gfx/glrenderer/GLTexture.h"
 #include "app/ApplicationBase.h"
 #include <glm/gtc/matrix_transform.hpp>
@@ -34,7 +35,6 @@ namespace cgu {
     SPHVolume::SPHVolume(const std::shared_ptr<const Volume>& texData, ApplicationBase* app) :
         volumeData(texData),
         volumeTexture(nullptr),
-        sphProgram(nullptr),
         sphLevelsProgram(nullptr),
         volumeSize(volumeData->GetSize()),
         texMax(static_cast<float>(calcTextureMaxSize(volumeSize))),
@@ -43,25 +43,21 @@ namespace cgu {
         auto numLevels = calcMipLevels(static_cast<unsigned int>(texMax));
         stepSizes.resize(numLevels, 1.0f / (2.0f * texMax));
 
-        volumeTexture = volumeData->Load3DTexture(3);
+        VolumeStorageFormat storageFormat;
+        auto level0 = volumeData->LoadStorageData(storageFormat);
+        const auto& volumeDesc = volumeData->GetTextureDescriptor();
+        auto elementSize = volumeStorage::GetElementSize(storageFormat);
+        TextureDescriptor volDesc(elementSize, volumeDesc.internalFormat, GL_RED, volumeStorage::GetType(storageFormat));
+        volumeTexture = std::make_unique<GLTexture>(volumeSize.x, volumeSize.y, volumeSize.z, 3, volDesc, level0.data());
 
-        std::string shaderDefines;
-        auto sphDesc = volumeTexture->GetDescriptor();
+        auto sphDesc = volDesc;
         sphDesc.bytesPP *= 4;
         sphDesc.format = GL_RGBA;
         switch (sphDesc.internalFormat) {
-        case GL_R8:
-            sphDesc.internalFormat = GL_RGBA8;
-            shaderDefines = "TEX r8,SPHTEX rgba8";
-            break;
-        case GL_R16F:
-            sphDesc.internalFormat = GL_RGBA16F;
-            shaderDefines = "TEX r16f,SPHTEX rgba16f";
-            break;
-        case GL_R32F:
-            sphDesc.internalFormat = GL_RGBA32F;
-            shaderDefines = "TEX r32f,SPHTEX rgba32f";
-            break;
+        case GL_R8: sphDesc.internalFormat = GL_RGBA8; break;
+        case GL_R16: sphDesc.internalFormat = GL_RGBA16; break;
+        case GL_R16F: sphDesc.internalFormat = GL_RGBA16F; break;
+        case GL_R32F: sphDesc.internalFormat = GL_RGBA32F; break;
         default:
             throw std::runtime_error("Texture format not allowed.");
         }
@@ -89,34 +85,19 @@ namespace cgu {
         OGL_CALL(glMemoryBarrier, GL_ALL_BARRIER_BITS);
         OGL_SCALL(glFinish);*/
 
-        auto sphSize = volumeTexture->GetLevelDimensions(2);
-        auto sphLevels = calcMipLevels(calcTextureMaxSize(sphSize)) - 4;
+        // the coefficients are computed on the CPU the same way shader/sphvolumes/genSPHMap.cp does.
+        auto sph = volumeData->GetSPHCoefficients(level0, storageFormat);
+        level0.clear();
+        level0.shrink_to_fit();
+
         auto twoRootPi = 2.0f * glm::root_pi<float>();
         sphCoeffs = glm::vec2(1.0f / twoRootPi, glm::root_three<float>() / twoRootPi);
 
-        sphTextures[0] = std::make_unique<GLTexture>(sphSize.x, sphSize.y, sphSize.z, sphLevels, sphDesc, nullptr);
-        sphTextures[1] = std::make_unique<GLTexture>(sphSize.x, sphSize.y, sphSize.z, sphLevels, sphDesc, nullptr);
-        sphProgram = app->GetGPUProgramManager()->GetResource("shader/sphvolumes/genSPHMap.cp," + shaderDefines);
-        sphUniformNames = sphProgram->GetUniformLocations({ "origTex", "sphTex0", "sphTex1", "sphCoeffs" });
-        sphProgram->UseProgram();
-        sphProgram->SetUniform(sphUniformNames[0], 0);
-        sphProgram->SetUniform(sphUniformNames[1], 1);
-        sphProgram->SetUniform(sphUniformNames[2], 2);
-        sphProgram->SetUniform(sphUniformNames[3], sphCoeffs);
-
-        auto numGroups = glm::ivec3(glm::ceil(glm::vec3(sphSize) / 8.0f));
-        volumeTexture->ActivateImage(0, 0, GL_READ_ONLY);
-        for (unsigned int lvl = 0; lvl < sphLevels; ++lvl) {
-            OGL_CALL(glMemoryBarrier, GL_ALL_BARRIER_BITS);
-            OGL_SCALL(glFinish);
-
-            sphTextures[0]->ActivateImage(1, lvl, GL_WRITE_ONLY);
-            sphTextures[1]->ActivateImage(2, lvl, GL_WRITE_ONLY);
-            OGL_CALL(glDispatchCompute, numGroups.x, numGroups.y, numGroups.z);
-            numGroups = glm::ivec3(glm::ceil(glm::vec3(numGroups) * 0.5f));
+        auto sphSize = sph->GetLevelSize(0);
+        for (unsigned int i = 0; i < NUM_SHELLS; ++i) {
+            sphTextures[i] = std::make_unique<GLTexture>(sphSize.x, sphSize.y, sphSize.z, sph->GetNumLevels(), sphDesc, sph->GetLevelData(i, 0).data());
+            for (unsigned int lvl = 1; lvl < sph->GetNumLevels(); ++lvl) sphTextures[i]->SetData(lvl, sph->GetLevelData(i, lvl).data());
         }
-        OGL_CALL(glMemoryBarrier, GL_ALL_BARRIER_BITS);
-        OGL_SCALL(glFinish);
 
 
         /*volumeTexture->ActivateImage(0, 0, GL_READ_ONLY);
@@ -11,6 +11,7 @@
 
 #include "main.h"
 #include "gfx/glrenderer/GLTexture.h"
+#include "gfx/volumes/SPHCoefficients.h"
 
 namespace cgu {
 
@@ -33,7 +34,7 @@ namespace cgu {
         const glm::vec2& GetSPHCoeffs() const { return sphCoeffs; };
 
     private:
-        static const unsigned int NUM_SHELLS = 2;
+        static const unsigned int NUM_SHELLS = SPHCoefficients::NUM_SHELLS;
         /** Holds the 3D texture object to load from. */
         std::shared_ptr<const Volume> volumeData;
 
@@ -45,10 +46,6 @@ namespace cgu {
         // std::shared_ptr<GPUProgram> mipLevelsProgram;
         /** Holds the binding locations for the program generating the lower mip map levels. */
         std::vector<BindingLocation> mipLevelsUniformNames;
-        /** Holds the GPUProgram for generating the top level min max texture. */
-        std::shared_ptr<GPUProgram> sphProgram;
-        /** Holds the binding locations for the program generating the top level min max texture. */
-        std::vector<BindingLocation> sphUniformNames;
         /** Holds the GPUProgram for generating the lower min max levels. */
         std::shared_ptr<GPUProgram> sphLevelsProgram;
         /** Holds the binding locations for the program generating the lower min max levels. */
@@ -0,0 +1,284 @@
+/**
+ * @file   SyntheticVolumeGenerator.cpp
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Implementation of the CPU generator for synthetic test volumes.
+ */
+
+#include "SyntheticVolumeGenerator.h"
+#include "gfx/volumes/VolumeStorage.h"
+#include "app/ApplicationBase.h"
+#include "app/Configuration.h"
+#include <boost/filesystem.hpp>
+#include <codecvt>
+#include <cstring>
+#include <fstream>
+
+namespace cgu {
+
+    /**
+     *  Stores a row of values in the given type.
+     *  @param type the (OpenGL) type of the output.
+     *  @param values the values to store.
+     *  @param count the number of values.
+     *  @param output the output row.
+     */
+    static void storeRow(GLenum type, const float* values, unsigned int count, uint8_t* output)
+    {
+        if (type == GL_UNSIGNED_BYTE) {
+            for (unsigned int x = 0; x < count; ++x) output[x] = volumeStorage::Unorm8::Store(values[x]);
+        } else if (type == GL_UNSIGNED_SHORT) {
+            auto out = reinterpret_cast<uint16_t*>(output);
+            for (unsigned int x = 0; x < count; ++x) out[x] = volumeStorage::Unorm16::Store(values[x]);
+        } else if (type == GL_UNSIGNED_INT) {
+            auto out = reinterpret_cast<uint32_t*>(output);
+            for (unsigned int x = 0; x < count; ++x) {
+                out[x] = static_cast<uint32_t>(static_cast<double>(glm::clamp(values[x], 0.0f, 1.0f)) * 4294967295.0 + 0.5);
+            }
+        } else {
+            std::memcpy(output, values, count * sizeof(float));
+        }
+    }
+
+    /**
+     *  Creates a kernel computing a pattern.
+     *  @param type the (OpenGL) type of the output.
+     *  @param fn the function computing the value of a voxel as fn(const glm::uvec3& pos) -> float.
+     */
+    template<class Fn> static DerivedVolumePipeline::RowKernel createPatternKernel(GLenum type, Fn fn)
+    {
+        return [type, fn](const VolumeSlab& slab, unsigned int y, unsigned int z, uint8_t* output) {
+            thread_local std::vector<float> values;
+            auto sizeX = slab.GetVolumeSize().x;
+            values.resize(sizeX);
+            for (unsigned int x = 0; x < sizeX; ++x) values[x] = fn(glm::uvec3(x, y, z));
+            storeRow(type, values.data(), sizeX, output);
+        };
+    }
+
+    /**
+     *  Constructor.
+     *  @param size the size of the volumes to generate.
+     *  @param type the (OpenGL) type of the voxels (GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT, GL_UNSIGNED_INT or GL_FLOAT).
+     */
+    SyntheticVolumeGenerator::SyntheticVolumeGenerator(const glm::uvec3& size, GLenum type) :
+        volSize(size),
+        type(type),
+        numThreads(0)
+    {
+        assert(type == GL_UNSIGNED_BYTE || type == GL_UNSIGNED_SHORT || type == GL_UNSIGNED_INT || type == GL_FLOAT);
+    }
+
+    /** Returns the number of bytes of a voxel. */
+    unsigned int SyntheticVolumeGenerator::GetBytesPerVoxel() const
+    {
+        if (type == GL_UNSIGNED_BYTE) return 1;
+        if (type == GL_UNSIGNED_SHORT) return 2;
+        return 4;
+    }
+
+    /** Returns the value of the checker pattern (synthChecker.cp) at a position. */
+    float SyntheticVolumeGenerator::CheckerValue(const glm::uvec3& pos, const glm::uvec3& checkerSize)
+    {
+        auto checker = pos / checkerSize;
+        if (checker.z % 2 == 1) checker.y += 1;
+        if (checker.y % 2 == 1) checker.x += 1;
+        return checker.x % 2 == 1 ? 1.0f : 0.0f;
+    }
+
+    /** Returns the value of the stripes pattern (synthStripes.cp) at a position. */
+    float SyntheticVolumeGenerator::StripesValue(const glm::uvec3& pos, unsigned int stripeSize)
+    {
+        return (pos.x / stripeSize) % 2 == 1 ? 1.0f : 0.0f;
+    }
+
+    /** Returns the value of the spherical pattern (synthSpherical.cp) at a position. */
+    float SyntheticVolumeGenerator::SphericalValue(const glm::uvec3& pos, const glm::vec3& sphereCenter, const glm::vec3& sphereScale)
+    {
+        return glm::length((glm::vec3(pos) - sphereCenter) * sphereScale);
+    }
+
+    /**
+     *  Creates a checker volume in the resource directory (if it does not exist) and loads it.
+     *  @param filename the file name of the volume relative to the resource directory.
+     *  @param checkerSize the size of a checker cell.
+     *  @param app the application object.
+     *  @return the volume.
+     */
+    std::shared_ptr<Volume> SyntheticVolumeGenerator::InitChecker(const std::string& filename, const glm::uvec3& checkerSize, ApplicationBase* app) const
+    {
+        return InitGeneral(filename, app, [this, &checkerSize](const std::string& datFilename) { WriteChecker(datFilename, checkerSize); });
+    }
+
+    /**
+     *  Creates a stripes volume in the resource directory (if it does not exist) and loads it.
+     *  @param filename the file name of the volume relative to the resource directory.
+     *  @param stripeSize the width of a stripe.
+     *  @param app the application object.
+     *  @return the volume.
+     */
+    std::shared_ptr<Volume> SyntheticVolumeGenerator::InitStripes(const std::string& filename, unsigned int stripeSize, ApplicationBase* app) const
+    {
+        return InitGeneral(filename, app, [this, stripeSize](const std::string& datFilename) { WriteStripes(datFilename, stripeSize); });
+    }
+
+    /**
+     *  Creates a spherical distance volume in the resource directory (if it does not exist) and loads it.
+     *  @param filename the file name of the volume relative to the resource directory.
+     *  @param sphereCenter the center of the spheres.
+     *  @param sphereScale the scaling of the distances.
+     *  @param app the application object.
+     *  @return the volume.
+     */
+    std::shared_ptr<Volume> SyntheticVolumeGenerator::InitSpherical(const std::string& filename, const glm::vec3& sphereCenter,
+        const glm::vec3& sphereScale, ApplicationBase* app) const
+    {
+        return InitGeneral(filename, app, [this, &sphereCenter, &sphereScale](const std::string& datFilename)
+        {
+            WriteSpherical(datFilename, sphereCenter, sphereScale);
+        });
+    }
+
+    /**
+     *  Writes a checker volume.
+     *  @param datFilename the file name of the dat file, the raw file is written next to it.
+     *  @param checkerSize the size of a checker cell.
+     */
+    void SyntheticVolumeGenerator::WriteChecker(const std::string& datFilename, const glm::uvec3& checkerSize) const
+    {
+        WriteGeneral(datFilename, createPatternKernel(type, [checkerSize](const glm::uvec3& pos) { return CheckerValue(pos, checkerSize); }));
+    }
+
+    /**
+     *  Writes a stripes volume.
+     *  @param datFilename the file name of the dat file, the raw file is written next to it.
+     *  @param stripeSize the width of a stripe.
+     */
+    void SyntheticVolumeGenerator::WriteStripes(const std::string& datFilename, unsigned int stripeSize) const
+    {
+        WriteGeneral(datFilename, createPatternKernel(type, [stripeSize](const glm::uvec3& pos) { return StripesValue(pos, stripeSize); }));
+    }
+
+    /**
+     *  Writes a spherical distance volume.
+     *  @param datFilename the file name of the dat file, the raw file is written next to it.
+     *  @param sphereCenter the center of the spheres.
+     *  @param sphereScale the scaling of the distances.
+     */
+    void SyntheticVolumeGenerator::WriteSpherical(const std::string& datFilename, const glm::vec3& sphereCenter, const glm::vec3& sphereScale) const
+    {
+        WriteGeneral(datFilename, createPatternKernel(type, [sphereCenter, sphereScale](const glm::uvec3& pos)
+        {
+            return SphericalValue(pos, sphereCenter, sphereScale);
+        }));
+    }
+
+    /**
+     *  Generates a checker volume in memory.
+     *  @param data the voxels (output).
+     *  @param checkerSize the size of a checker cell.
+     */
+    void SyntheticVolumeGenerator::GenerateChecker(std::vector<uint8_t>& data, const glm::uvec3& checkerSize) const
+    {
+        GenerateGeneral(data, createPatternKernel(type, [checkerSize](const glm::uvec3& pos) { return CheckerValue(pos, checkerSize); }));
+    }
+
+    /**
+     *  Generates a stripes volume in memory.
+     *  @param data the voxels (output).
+     *  @param stripeSize the width of a stripe.
+     */
+    void SyntheticVolumeGenerator::GenerateStripes(std::vector<uint8_t>& data, unsigned int stripeSize) const
+    {
+        GenerateGeneral(data, createPatternKernel(type, [stripeSize](const glm::uvec3& pos) { return StripesValue(pos, stripeSize); }));
+    }
+
+    /**
+     *  Generates a spherical distance volume in memory.
+     *  @param data the voxels (output).
+     *  @param sphereCenter the center of the spheres.
+     *  @param sphereScale the scaling of the distances.
+     */
+    void SyntheticVolumeGenerator::GenerateSpherical(std::vector<uint8_t>& data, const glm::vec3& sphereCenter, const glm::vec3& sphereScale) const
+    {
+        GenerateGeneral(data, createPatternKernel(type, [sphereCenter, sphereScale](const glm::uvec3& pos)
+        {
+            return SphericalValue(pos, sphereCenter, sphereScale);
+        }));
+    }
+
+    /**
+     *  Creates a volume in the resource directory (if it does not exist) and loads it.
+     *  @param filename the file name of the volume relative to the resource directory.
+     *  @param app the application object.
+     *  @param writeVolume the function writing the volume to the dat file name passed.
+     *  @return the volume.
+     */
+    std::shared_ptr<Volume> SyntheticVolumeGenerator::InitGeneral(const std::string& filename, ApplicationBase* app,
+        const std::function<void(const std::string&)>& writeVolume) const
+    {
+        auto baseFileName = filename.substr(0, filename.find_last_of("."));
+        auto newFilename = app->GetConfig().resourceBase + "/" + baseFileName + ".dat";
+
+        if (!boost::filesystem::exists(newFilename)) writeVolume(newFilename);
+        return app->GetVolumeManager()->GetResource(baseFileName + ".dat");
+    }
+
+    /**
+     *  Writes a volume and its dat file.
+     *  @param datFilename the file name of the dat file, the raw file is written next to it.
+     *  @param kernel the kernel computing the rows of the volume.
+     */
+    void SyntheticVolumeGenerator::WriteGeneral(const std::string& datFilename, const DerivedVolumePipeline::RowKernel& kernel) const
+    {
+        boost::filesystem::path datPath{ datFilename };
+        auto rawName = datPath.filename().stem().string() + ".raw";
+        auto rawFilename = datPath.parent_path().string() + "/" + rawName;
+
+        std::ofstream rawOut(rawFilename, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+        if (!rawOut.is_open()) {
+            std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+            LOG(ERROR) << "Could not open file '" << converter.from_bytes(rawFilename) << "'.";
+            throw std::runtime_error("Could not open file '" + rawFilename + "'.");
+        }
+
+        DerivedVolumePipeline pipeline(volSize, GetBytesPerVoxel());
+        pipeline.SetNumThreads(numThreads);
+        pipeline.Run(kernel, rawOut);
+        rawOut.close();
+
+        std::ofstream datOut(datFilename, std::ofstream::out | std::ofstream::trunc);
+        if (!datOut.is_open()) {
+            std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+            LOG(ERROR) << "Could not open file '" << converter.from_bytes(datFilename) << "'.";
+            throw std::runtime_error("Could not open file '" + datFilename + "'.");
+        }
+
+        std::string newFormat = "UCHAR";
+        if (type == GL_UNSIGNED_SHORT) newFormat = "USHORT";
+        else if (type == GL_UNSIGNED_INT) newFormat = "UINT";
+        else if (type == GL_FLOAT) newFormat = "FLOAT";
+
+        datOut << "ObjectFileName:\t" << rawName << std::endl;
+        datOut << "Resolution:\t" << volSize.x << " " << volSize.y << " " << volSize.z << std::endl;
+        datOut << "SliceThickness:\t" << 1 << " " << 1 << " " << 1 << std::endl;
+        datOut << "Format:\t" << newFormat << std::endl;
+        datOut << "ObjectModel:\tI" << std::endl;
+        datOut.close();
+    }
+
+    /**
+     *  Generates a volume in memory.
+     *  @param data the voxels (output).
+     *  @param kernel the kernel computing the rows of the volume.
+     */
+    void SyntheticVolumeGenerator::GenerateGeneral(std::vector<uint8_t>& data, const DerivedVolumePipeline::RowKernel& kernel) const
+    {
+        data.clear();
+        data.reserve(static_cast<std::size_t>(static_cast<uint64_t>(volSize.x) * volSize.y * volSize.z * GetBytesPerVoxel()));
+        DerivedVolumePipeline pipeline(volSize, GetBytesPerVoxel());
+        pipeline.SetNumThreads(numThreads);
+        pipeline.Run(kernel, [&data](const uint8_t* slabData, uint64_t size) { data.insert(data.end(), slabData, slabData + size); });
+    }
+}
@@ -0,0 +1,70 @@
+/**
+ * @file   SyntheticVolumeGenerator.h
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Contains the CPU generator for synthetic test volumes.
+ */
+
+#ifndef SYNTHETICVOLUMEGENERATOR_H
+#define SYNTHETICVOLUMEGENERATOR_H
+
+#include "main.h"
+#include "gfx/volumes/DerivedVolumePipeline.h"
+
+namespace cgu {
+
+    class Volume;
+
+    /**
+     *  @brief Generates synthetic test volumes on the CPU.
+     *  The patterns are the same as the ones of the synth*.cp compute shaders used by GLVolumeInitializer, values are
+     *  converted to the volume type the same way OpenGL converts them on download (clamped and rounded for normalized
+     *  integers). The volume is computed slab by slab on all hardware threads and written sequentially, no GPU is
+     *  needed.
+     *
+     * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+     * @date   2026.10.16
+     */
+    class SyntheticVolumeGenerator
+    {
+    public:
+        SyntheticVolumeGenerator(const glm::uvec3& size, GLenum type);
+
+        std::shared_ptr<Volume> InitChecker(const std::string& filename, const glm::uvec3& checkerSize, ApplicationBase* app) const;
+        std::shared_ptr<Volume> InitStripes(const std::string& filename, unsigned int stripeSize, ApplicationBase* app) const;
+        std::shared_ptr<Volume> InitSpherical(const std::string& filename, const glm::vec3& sphereCenter, const glm::vec3& sphereScale, ApplicationBase* app) const;
+
+        void WriteChecker(const std::string& datFilename, const glm::uvec3& checkerSize) const;
+        void WriteStripes(const std::string& datFilename, unsigned int stripeSize) const;
+        void WriteSpherical(const std::string& datFilename, const glm::vec3& sphereCenter, const glm::vec3& sphereScale) const;
+
+        void GenerateChecker(std::vector<uint8_t>& data, const glm::uvec3& checkerSize) const;
+        void GenerateStripes(std::vector<uint8_t>& data, unsigned int stripeSize) const;
+        void GenerateSpherical(std::vector<uint8_t>& data, const glm::vec3& sphereCenter, const glm::vec3& sphereScale) const;
+
+        static float CheckerValue(const glm::uvec3& pos, const glm::uvec3& checkerSize);
+        static float StripesValue(const glm::uvec3& pos, unsigned int stripeSize);
+        static float SphericalValue(const glm::uvec3& pos, const glm::vec3& sphereCenter, const glm::vec3& sphereScale);
+
+        /** Sets the number of threads used (0 to use all hardware threads). */
+        void SetNumThreads(unsigned int threads) { numThreads = threads; }
+        /** Returns the number of bytes of a voxel. */
+        unsigned int GetBytesPerVoxel() const;
+
+    private:
+        std::shared_ptr<Volume> InitGeneral(const std::string& filename, ApplicationBase* app,
+            const std::function<void(const std::string&)>& writeVolume) const;
+        void WriteGeneral(const std::string& datFilename, const DerivedVolumePipeline::RowKernel& kernel) const;
+        void GenerateGeneral(std::vector<uint8_t>& data, const DerivedVolumePipeline::RowKernel& kernel) const;
+
+        /** Holds the volume size. */
+        glm::uvec3 volSize;
+        /** Holds the (OpenGL) type of the voxels. */
+        GLenum type;
+        /** Holds the number of threads to use. */
+        unsigned int numThreads;
+    };
+}
+
+#endif // SYNTHETICVOLUMEGENERATOR_H
@@ -8,9 +8,22 @@
 
 #define GLM_SWIZZLE
 #include "Volume.h"
+#include "BrickedVolume.h"
+#include "CompressedVolume.h"
+#include "VolumeStatistics.h"
+#include "MinMaxPyramid.h"
+#include "SPHCoefficients.h"
+#include "IsosurfaceExtractor.h"
+#include "VolumeDataConversion.h"
+#include "VolumeCache.h"
+#include "VolumeDownsampler.h"
+#include "VolumeDatFile.h"
+#include "core/parallel_helper.h"
+#include "core/serializationHelper.h"
 #include "app/ApplicationBase.h"
 #include <codecvt>
 #include <fstream>
+#include <sstream>
 #include "gfx/glrenderer/GLTexture.h"
 #include <ios>
 #include <boost/filesystem.hpp>
@@ -23,18 +36,6 @@
 
 namespace cgu {
 
-    template<typename OT, typename OET, typename I, typename IT>
-    static std::vector<OT> readModifyData(const std::vector<IT>& rawData, size_t size, std::function<OET(const I&)> modify)
-    {
-        auto elementsToRead = size / sizeof(I);
-        auto ptr = reinterpret_cast<const I*>(rawData.data());
-        std::vector<OT> data(elementsToRead * sizeof(OET) / sizeof(OT));
-        for (size_t i = 0; i < elementsToRead; ++i) {
-            reinterpret_cast<OET*>(data.data())[i] = modify(ptr[i]);
-        }
-        return std::move(data);
-    }
-
     /**
      * Constructor.
      * @param texFilename the textures file name
@@ -46,7 +47,11 @@ namespace cgu {
         cellSize(1.0f),
         scaleValue(1),
         dataDim(1),
-        texDesc(4, GL_R8, GL_RED, GL_UNSIGNED_BYTE)
+        componentSize(1),
+        dataOffset(0),
+        voxelStride(0),
+        texDesc(4, GL_R8, GL_RED, GL_UNSIGNED_BYTE),
+        loadMode(VolumeLoadMode::FLOAT)
     {
         LoadDatFile();
     }
@@ -74,7 +79,12 @@ namespace cgu {
         rawFileName(std::move(rhs.rawFileName)),
         scaleValue(std::move(rhs.scaleValue)),
         dataDim(std::move(rhs.dataDim)),
-        texDesc(std::move(rhs.texDesc))
+        componentSize(std::move(rhs.componentSize)),
+        dataOffset(std::move(rhs.dataOffset)),
+        voxelStride(std::move(rhs.voxelStride)),
+        texDesc(std::move(rhs.texDesc)),
+        loadMode(rhs.loadMode),
+        decodedData(std::move(rhs.decodedData))
     {
         
     }
@@ -86,7 +96,12 @@ namespace cgu {
         rawFileName = std::move(rhs.rawFileName);
         scaleValue = std::move(rhs.scaleValue);
         dataDim = std::move(rhs.dataDim);
+        componentSize = std::move(rhs.componentSize);
+        dataOffset = std::move(rhs.dataOffset);
+        voxelStride = std::move(rhs.voxelStride);
         texDesc = std::move(rhs.texDesc);
+        loadMode = rhs.loadMode;
+        decodedData = std::move(rhs.decodedData);
         return *this;
     }
 
@@ -100,9 +115,9 @@ namespace cgu {
     {
         auto filename = FindResourceLocation(GetParameters()[0]);
         auto forceBits = GetNamedParameterValue<unsigned int>("forceBits", 0);
+        auto loadModeStr = GetNamedParameterValue<std::string>("loadMode", "float");
 
         boost::filesystem::path datFile{ filename };
-        auto path = datFile.parent_path().string() + "/";
         auto ending = datFile.extension().string();
 
         if (ending != ".dat" && ending != ".DAT") {
@@ -112,78 +127,46 @@ namespace cgu {
                 << errdesc_info("Cannot load file, file type not supported.");
         }
 
-        std::ifstream ifs(filename);
-        if (!ifs.is_open()) {
+        VolumeDatFile datContent;
+        if (!datContent.Read(filename)) {
             std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
             LOG(ERROR) << "Cannot open file '" << converter.from_bytes(filename) << "'.";
             throw resource_loading_error() << ::boost::errinfo_file_name(datFile.filename().string()) << resid_info(getId())
                 << errdesc_info("Cannot open file.");
         }
 
-        std::string str, raw_file, format_str, obj_model;
-
-        while (ifs >> str && ifs.good()) {
-            if (str == "ObjectFileName:")
-                ifs >> raw_file;
-            else if (str == "Resolution:") {
-                ifs >> volumeSize.x; ifs >> volumeSize.y; ifs >> volumeSize.z;
-            } else if (str == "SliceThickness:") {
-                ifs >> cellSize.x; ifs >> cellSize.y; ifs >> cellSize.z;
-            } else if (str == "Format:")
-                ifs >> format_str;
-            else if (str == "ObjectModel:")
-                ifs >> obj_model;
-        }
-        ifs.close();
-
-        if (raw_file == "" || volumeSize == glm::uvec3(0) || format_str == "") {
+        if (datContent.rawFile == "" || datContent.resolution == glm::uvec3(0) || datContent.format == "") {
             LOG(ERROR) << "Could find all required fields in dat file.";
             throw resource_loading_error() << ::boost::errinfo_file_name(datFile.filename().string()) << resid_info(getId())
                 << errdesc_info("Cannot find all required fields in dat file.");
         }
 
-        unsigned int componentSize;
-        if (format_str == "UCHAR") {
-            texDesc.type = GL_UNSIGNED_BYTE;
-            componentSize = 1;
-        } else if (format_str == "USHORT") {
-            texDesc.type = GL_UNSIGNED_SHORT;
-            componentSize = 2;
-        } else if (format_str == "USHORT_12") {
-            texDesc.type = GL_UNSIGNED_SHORT;
-            componentSize = 2;
-        } else if (format_str == "UINT") {
-            texDesc.type = GL_UNSIGNED_INT;
-            componentSize = 4;
-        } else if (format_str == "FLOAT") {
-            texDesc.type = GL_FLOAT;
-            componentSize = 4;
-        } else {
+        VolumeDataView layout;
+        if (!VolumeDatFile::ParseFormat(datContent.format, layout)) {
             std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
-            LOG(ERROR) << "Format '" << converter.from_bytes(format_str) << "' is not supported.";
+            LOG(ERROR) << "Format '" << converter.from_bytes(datContent.format) << "' is not supported.";
             throw resource_loading_error() << ::boost::errinfo_file_name(datFile.filename().string()) << resid_info(getId())
                 << errdesc_info("Format not supported.");
         }
 
-        if (obj_model == "I") {
-            dataDim = 1;
-            texDesc.format = GL_RED;
-        } else if (obj_model == "RG" || obj_model == "XY") {
-            dataDim = 2;
-            texDesc.format = GL_RG;
-        } else if (obj_model == "RGB" || obj_model == "XYZ") {
-            dataDim = 3;
-            texDesc.format = GL_RGB;
-        } else if (obj_model == "RGBA" || obj_model == "XYZW") {
-            dataDim = 4;
-            texDesc.format = GL_RGBA;
-        } else {
+        if (!VolumeDatFile::ParseObjectModel(datContent.objectModel, layout)) {
             std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
-            LOG(ERROR) << "ObjectModel '" << converter.from_bytes(obj_model) << "' is not supported.";
+            LOG(ERROR) << "ObjectModel '" << converter.from_bytes(datContent.objectModel) << "' is not supported.";
             throw resource_loading_error() << ::boost::errinfo_file_name(datFile.filename().string()) << resid_info(getId())
                 << errdesc_info("ObjectModel not supported.");
         }
 
+        static const GLenum textureFormats[] = { GL_RED, GL_RG, GL_RGB, GL_RGBA };
+        volumeSize = datContent.resolution;
+        cellSize = datContent.sliceThickness;
+        dataOffset = datContent.dataOffset;
+        voxelStride = datContent.voxelStride;
+        texDesc.type = layout.type;
+        componentSize = layout.bytesPerVoxel;
+        scaleValue = layout.scaleValue;
+        dataDim = static_cast<int>(layout.numComponents);
+        texDesc.format = textureFormats[dataDim - 1];
+
         if (forceBits == 0) {
             texDesc.bytesPP = dataDim * componentSize;
             if (texDesc.type == GL_UNSIGNED_BYTE && texDesc.format == GL_RED)
@@ -238,99 +221,572 @@ namespace cgu {
             texDesc.internalFormat = GL_RGBA32F;
         }
 
-        scaleValue = (format_str == "USHORT_12") ? 16 : 1;
-        rawFileName = path + "/" + raw_file;
+        if (loadModeStr == "native") loadMode = VolumeLoadMode::NATIVE;
+        else if (loadModeStr == "half") loadMode = VolumeLoadMode::HALF;
+        else if (loadModeStr != "float") {
+            std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+            LOG(ERROR) << "Load mode '" << converter.from_bytes(loadModeStr) << "' is not supported.";
+            throw resource_loading_error() << ::boost::errinfo_file_name(datFile.filename().string()) << resid_info(getId())
+                << errdesc_info("Load mode not supported.");
+        }
+        SetLoadModeFormat();
+
+        rawFileName = datContent.GetRawFilePath();
     }
 
-    void Volume::LoadRawDataFromFile(unsigned int& data_size, std::vector<char>& rawData) const
+    /**
+     *  Sets the internal format of the texture for the native and half load modes.
+     *  Native mode uses normalized integer formats for 8 and 16 bit data and falls back to float otherwise.
+     */
+    void Volume::SetLoadModeFormat()
     {
-        std::ifstream ifsRaw(rawFileName, std::ios::in | std::ios::binary);
-        if (!ifsRaw || !ifsRaw.is_open()) {
-            std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
-            LOG(ERROR) << "Could not open file '" << converter.from_bytes(rawFileName) << "'.";
-            throw std::runtime_error("Could not open file '" + rawFileName + "'.");
+        static const GLint halfFormats[] = { GL_R16F, GL_RG16F, GL_RGB16F, GL_RGBA16F };
+        static const GLint native8Formats[] = { GL_R8, GL_RG8, GL_RGB8, GL_RGBA8 };
+        static const GLint native16Formats[] = { GL_R16, GL_RG16, GL_RGB16, GL_RGBA16 };
+
+        if (loadMode == VolumeLoadMode::NATIVE && texDesc.type != GL_UNSIGNED_BYTE && texDesc.type != GL_UNSIGNED_SHORT) {
+            LOG(INFO) << "Volume data has no native normalized format, it will be loaded as float.";
+            loadMode = VolumeLoadMode::FLOAT;
         }
 
-        ifsRaw.seekg(0, std::ios::end);
-        data_size = static_cast<unsigned int>(ifsRaw.tellg());
-        ifsRaw.seekg(0, std::ios::beg);
+        if (loadMode == VolumeLoadMode::NATIVE) {
+            texDesc.bytesPP = dataDim * componentSize;
+            texDesc.internalFormat = texDesc.type == GL_UNSIGNED_BYTE ? native8Formats[dataDim - 1] : native16Formats[dataDim - 1];
+        } else if (loadMode == VolumeLoadMode::HALF) {
+            texDesc.bytesPP = dataDim * 2;
+            texDesc.internalFormat = halfFormats[dataDim - 1];
+        }
+    }
 
-        rawData = std::vector<char>(data_size, 9);
-        ifsRaw.read(rawData.data(), data_size);
-        ifsRaw.close();
+    /**
+     *  Maps the raw file of the volume to memory.
+     *  Compressed volumes (.cvol) are decoded to memory instead. This is done only once, the decoded data is kept
+     *  with the volume and shared by all sources returned.
+     *  @return the memory mapped raw data.
+     */
+    std::unique_ptr<RawVolumeSource> Volume::LoadRawDataFromFile() const
+    {
+        VolumeDataView layout;
+        layout.size = volumeSize;
+        layout.voxelStride = voxelStride;
+        layout.bytesPerVoxel = dataDim * componentSize;
+        layout.numComponents = dataDim;
+        layout.type = texDesc.type;
+        layout.scaleValue = scaleValue;
+
+        auto rawExtension = boost::filesystem::path(rawFileName).extension().string();
+        if (rawExtension == ".cvol" || rawExtension == ".CVOL") {
+            std::lock_guard<std::mutex> lock(decodeMutex);
+            if (decodedData) return std::make_unique<RawVolumeSource>(rawFileName, decodedData, layout);
+
+            CompressedVolume compressedData(rawFileName);
+            const auto& cvolLayout = compressedData.GetLayout();
+            if (cvolLayout.size != layout.size || cvolLayout.bytesPerVoxel != layout.bytesPerVoxel || cvolLayout.type != layout.type) {
+                std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+                LOG(ERROR) << "Compressed volume '" << converter.from_bytes(rawFileName) << "' does not match its dat file.";
+                throw std::runtime_error("Compressed volume '" + rawFileName + "' does not match its dat file.");
+            }
+            decodedData = std::make_shared<const std::vector<uint8_t>>(compressedData.Decode());
+            return std::make_unique<RawVolumeSource>(rawFileName, decodedData, layout);
+        }
+        return std::make_unique<RawVolumeSource>(rawFileName, dataOffset, layout);
     }
 
     /**
-         *  Loads the content of the volume to a 3D texture.
-         *  @param mipLevels the number of MipMap levels the texture should have.
-         *  @return the loaded texture.
-         */
+     *  Loads the content of the volume to a 3D texture.
+     *  The data is normalized to the maximum value of the volume and uploaded as float, half float or at its native
+     *  precision depending on the resources "loadMode" parameter.
+     *  @param mipLevels the number of MipMap levels the texture should have.
+     *  @return the loaded texture.
+     */
     std::unique_ptr<GLTexture> Volume::Load3DTexture(unsigned int mipLevels) const
     {
-        unsigned int data_size;
-        std::vector<char> rawData;
-        LoadRawDataFromFile(data_size, rawData);
+        auto rawData = LoadRawDataFromFile();
+        const auto& rawView = rawData->GetView();
+        auto numElements = rawView.GetNumVoxels() * rawView.numComponents;
+
+        if (loadMode == VolumeLoadMode::NATIVE) {
+            auto maxValue = volumeConversion::FindMaximumValue(rawView);
+            if (volumeConversion::IsNativeNormalized(rawView, maxValue)) {
+                return std::make_unique<GLTexture>(volumeSize.x, volumeSize.y, volumeSize.z, mipLevels, texDesc, rawView.data);
+            }
+
+            std::unique_ptr<uint8_t[]> data(new uint8_t[numElements * componentSize]);
+            volumeConversion::ConvertToNormalizedNative(rawView, maxValue, data.get());
+            rawData.reset();
+            return std::make_unique<GLTexture>(volumeSize.x, volumeSize.y, volumeSize.z, mipLevels, texDesc, data.get());
+        }
+
+        auto tempDesc = texDesc;
+        if (loadMode == VolumeLoadMode::HALF) {
+            std::unique_ptr<uint16_t[]> data(new uint16_t[numElements]);
+            volumeConversion::ConvertToNormalizedHalf(rawView, data.get());
+            rawData.reset();
+
+            tempDesc.type = GL_HALF_FLOAT;
+            return std::make_unique<GLTexture>(volumeSize.x, volumeSize.y, volumeSize.z, mipLevels, tempDesc, data.get());
+        }
+
+        std::unique_ptr<float[]> data(new float[numElements]);
+        volumeConversion::ConvertToNormalizedFloat(rawView, data.get());
+        rawData.reset();
+
+        tempDesc.type = GL_FLOAT;
+        auto volTex = std::make_unique<GLTexture>(volumeSize.x, volumeSize.y, volumeSize.z, mipLevels, tempDesc, data.get());
+        return std::move(volTex);
+    }
+
+    /**
+     *  Loads and converts the volume data the way Load3DTexture uploads it without using OpenGL.
+     *  This can be called from any thread, the data can be uploaded later (e.g. by AsyncVolumeLoad).
+     *  If a progress function is given the progress in [0, 1] is reported after each slab of the conversion (see
+     *  ConvertTextureData), loading stops (and returns empty data) if the function returns false.
+     *  @param reportProgress the function to report the progress to (optional).
+     *  @return the converted data.
+     */
+    VolumeTextureData Volume::LoadTextureData(const std::function<bool(float)>& reportProgress) const
+    {
+        auto rawData = LoadRawDataFromFile();
+        return ConvertTextureData(rawData->GetView(), reportProgress);
+    }
+
+    /**
+     *  Loads every stride-th voxel in each dimension and converts them the way LoadTextureData does.
+     *  The values are normalized with the maximum of the whole volume (see GetMaximumValue), so the coarse levels
+     *  match the full resolution one.
+     *  @param stride the distance between loaded voxels (1 loads the full volume).
+     *  @return the converted data with a size of ceil(size / stride).
+     */
+    VolumeTextureData Volume::LoadStridedTextureData(unsigned int stride) const
+    {
+        if (stride <= 1) return LoadTextureData();
+
+        auto maxValue = GetMaximumValue();
+        auto rawData = LoadRawDataFromFile();
+        const auto& rawView = rawData->GetView();
+        auto stridedView = rawView;
+        stridedView.size = (volumeSize + glm::uvec3(stride - 1)) / glm::uvec3(stride);
+        stridedView.voxelStride = rawView.bytesPerVoxel;
+        std::vector<uint8_t> stridedData(static_cast<std::size_t>(stridedView.GetNumVoxels() * rawView.bytesPerVoxel));
+
+        auto bytesPerVoxel = rawView.bytesPerVoxel;
+        const auto& stridedSize = stridedView.size;
+        parallel::ForChunks(static_cast<uint64_t>(stridedSize.y) * stridedSize.z, 64, [&](uint64_t begin, uint64_t end, unsigned int)
+        {
+            for (auto row = begin; row < end; ++row) {
+                glm::uvec3 pos(0, static_cast<unsigned int>(row % stridedSize.y), static_cast<unsigned int>(row / stridedSize.y));
+                auto dst = stridedData.data() + row * stridedSize.x * bytesPerVoxel;
+                for (; pos.x < stridedSize.x; ++pos.x, dst += bytesPerVoxel) {
+                    auto src = rawView.GetVoxel(pos * stride);
+                    std::copy(src, src + bytesPerVoxel, dst);
+                }
+            }
+        });
+        stridedView.data = stridedData.data();
+        return NormalizeTextureData(stridedView, maxValue, nullptr, 0.0f);
+    }
+
+    /**
+     *  Loads the volume data like LoadTextureData but normalizes it with a given maximum instead of the maximum of
+     *  this volume. Volume series use this to normalize all time steps the same way (see VolumeSeries::GetMaximumValue).
+     *  @param maxValue the value the data is normalized with (has to be at least the maximum of this volume).
+     *  @param reportProgress the function to report the progress in [0, 1] to, returning false cancels (optional).
+     *  @return the converted data (empty if cancelled).
+     */
+    VolumeTextureData Volume::LoadTextureData(float maxValue, const std::function<bool(float)>& reportProgress) const
+    {
+        auto rawData = LoadRawDataFromFile();
+        return NormalizeTextureData(rawData->GetView(), maxValue, reportProgress, 0.0f);
+    }
+
+    /**
+     *  Returns the maximum value the volume data is normalized with by LoadTextureData.
+     *  The value is cached next to the dat file.
+     *  @return the maximum value.
+     */
+    float Volume::GetMaximumValue() const
+    {
+        using MaximumSerializerType = serializeHelper::VersionableSerializer<'V', 'M', 'A', 'X', 1001>;
+        VolumeCacheKey cacheKey(GetContentHash(), volumeCache::HashString("max"));
+        auto cacheFilename = GetCacheFilename("_max.cache");
 
-        // std::vector<int8_t> data;
-        std::vector<float> data;
         auto maxValue = 0.0f;
-        if (texDesc.type == GL_UNSIGNED_BYTE) {
-            // data = readModifyData<int8_t, uint8_t, uint8_t>(rawData, data_size, [](const uint8_t& val){ return val; });
-            data = readModifyData<float, float, uint8_t, char>(rawData, data_size, [&maxValue](const uint8_t& val)
+        if (volumeCache::ReadCache<MaximumSerializerType>(cacheFilename, cacheKey, [&maxValue](std::istream& ifs)
+        {
+            serializeHelper::read(ifs, maxValue);
+            return true;
+        })) return maxValue;
+
+        auto rawData = LoadRawDataFromFile();
+        const auto& rawView = rawData->GetView();
+        auto slabDepth = GetProgressSlabDepth(rawView);
+        maxValue = 0.0f;
+        for (unsigned int z0 = 0; z0 < volumeSize.z; z0 += slabDepth) {
+            maxValue = glm::max(maxValue, volumeConversion::FindMaximumValue(rawView.GetSlices(z0, glm::min(z0 + slabDepth, volumeSize.z))));
+        }
+
+        volumeCache::WriteCache<MaximumSerializerType>(cacheFilename, cacheKey, [maxValue](std::ostream& ofs) { serializeHelper::write(ofs, maxValue); });
+        return maxValue;
+    }
+
+    /**
+     *  Returns the number of slices processed between two progress reports (about 64MB of raw data).
+     *  @param rawView the raw data.
+     *  @return the number of slices.
+     */
+    unsigned int Volume::GetProgressSlabDepth(const VolumeDataView& rawView) const
+    {
+        const uint64_t progressSlabSize = 64 * 1024 * 1024;
+        const auto& size = rawView.size;
+        auto sliceBytes = static_cast<uint64_t>(size.x) * size.y * rawView.voxelStride;
+        return static_cast<unsigned int>(glm::clamp<uint64_t>(progressSlabSize / glm::max<uint64_t>(sliceBytes, 1), 1, glm::max(size.z, 1U)));
+    }
+
+    /**
+     *  Converts raw volume data the way Load3DTexture does.
+     *  The data is processed in slabs of about 64MB: the first pass finds the maximum value (and reads the file for
+     *  memory mapped sources), the second one converts the slabs. The progress is reported after each slab of both
+     *  passes, the first pass reports [0, 0.5], the second one (0.5, 1].
+     *  @param rawView the raw data in the format of this volume.
+     *  @param reportProgress the function to report the progress to, returning false cancels (optional).
+     *  @return the converted data (empty if cancelled).
+     */
+    VolumeTextureData Volume::ConvertTextureData(const VolumeDataView& rawView, const std::function<bool(float)>& reportProgress) const
+    {
+        const auto& size = rawView.size;
+        auto slabDepth = GetProgressSlabDepth(rawView);
+        auto maxValue = 0.0f;
+        for (unsigned int z0 = 0; z0 < size.z; z0 += slabDepth) {
+            auto z1 = glm::min(z0 + slabDepth, size.z);
+            maxValue = glm::max(maxValue, volumeConversion::FindMaximumValue(rawView.GetSlices(z0, z1)));
+            if (reportProgress && !reportProgress(0.5f * static_cast<float>(z1) / static_cast<float>(size.z))) return VolumeTextureData();
+        }
+        return NormalizeTextureData(rawView, maxValue, reportProgress, 0.5f);
+    }
+
+    /**
+     *  Converts raw volume data normalized with a given maximum value slab by slab.
+     *  @param rawView the raw data in the format of this volume.
+     *  @param maxValue the value the data is normalized with.
+     *  @param reportProgress the function to report the progress to, returning false cancels (optional).
+     *  @param progressStart the progress reported before the conversion, the conversion reports (progressStart, 1].
+     *  @return the converted data (empty if cancelled).
+     */
+    VolumeTextureData Volume::NormalizeTextureData(const VolumeDataView& rawView, float maxValue, const std::function<bool(float)>& reportProgress,
+        float progressStart) const
+    {
+        const auto& size = rawView.size;
+        auto slabDepth = GetProgressSlabDepth(rawView);
+
+        VolumeTextureData result;
+        result.descriptor = texDesc;
+        result.size = size;
+        auto elementSize = static_cast<uint64_t>(componentSize);
+        auto nativeNormalized = false;
+        if (loadMode == VolumeLoadMode::NATIVE) nativeNormalized = volumeConversion::IsNativeNormalized(rawView, maxValue);
+        else if (loadMode == VolumeLoadMode::HALF) {
+            elementSize = sizeof(uint16_t);
+            result.descriptor.type = GL_HALF_FLOAT;
+        } else {
+            elementSize = sizeof(float);
+            result.descriptor.type = GL_FLOAT;
+        }
+        auto sliceElements = static_cast<uint64_t>(size.x) * size.y * rawView.numComponents;
+        result.data.resize(static_cast<std::size_t>(sliceElements * size.z * elementSize));
+
+        for (unsigned int z0 = 0; z0 < size.z; z0 += slabDepth) {
+            auto z1 = glm::min(z0 + slabDepth, size.z);
+            auto slab = rawView.GetSlices(z0, z1);
+            auto slabData = result.data.data() + z0 * sliceElements * elementSize;
+            if (nativeNormalized) std::copy(slab.data, slab.data + slab.GetNumBytes(), slabData);
+            else if (loadMode == VolumeLoadMode::NATIVE) volumeConversion::ConvertToNormalizedNative(slab, maxValue, slabData);
+            else if (loadMode == VolumeLoadMode::HALF) volumeConversion::ConvertToNormalizedHalf(slab, maxValue, reinterpret_cast<uint16_t*>(slabData));
+            else volumeConversion::ConvertToNormalizedFloat(slab, maxValue, reinterpret_cast<float*>(slabData));
+            auto progress = progressStart + (1.0f - progressStart) * static_cast<float>(z1) / static_cast<float>(size.z);
+            if (reportProgress && !reportProgress(progress)) return VolumeTextureData();
+        }
+        return result;
+    }
+
+    /**
+     *  Loads the volume data the way it is stored in a single channel texture of the volumes internal format.
+     *  This is the data a texture created by Load3DTexture contains in level 0.
+     *  @param format the storage format of the data (output).
+     *  @return the volume data.
+     */
+    std::vector<uint8_t> Volume::LoadStorageData(VolumeStorageFormat& format) const
+    {
+        if (dataDim != 1 || !volumeStorage::FromInternalFormat(texDesc.internalFormat, format)) {
+            LOG(ERROR) << "Volume format cannot be loaded to storage data.";
+            throw std::runtime_error("Texture format not allowed.");
+        }
+
+        auto rawData = LoadRawDataFromFile();
+        const auto& rawView = rawData->GetView();
+        auto numVoxels = rawView.GetNumVoxels();
+        std::vector<uint8_t> result(static_cast<std::size_t>(numVoxels * volumeStorage::GetElementSize(format)));
+
+        if (loadMode == VolumeLoadMode::NATIVE) {
+            auto maxValue = volumeConversion::FindMaximumValue(rawView);
+            if (volumeConversion::IsNativeNormalized(rawView, maxValue)) std::copy(rawView.data, rawView.data + result.size(), result.begin());
+            else volumeConversion::ConvertToNormalizedNative(rawView, maxValue, result.data());
+        } else if (loadMode == VolumeLoadMode::HALF) {
+            volumeConversion::ConvertToNormalizedHalf(rawView, reinterpret_cast<uint16_t*>(result.data()));
+        } else {
+            std::unique_ptr<float[]> data(new float[numVoxels]);
+            volumeConversion::ConvertToNormalizedFloat(rawView, data.get());
+            rawData.reset();
+
+            volumeStorage::WithStorage(format, [&data, &result, numVoxels](auto storage)
             {
-                auto value = static_cast<float>(val) / static_cast<float>(std::numeric_limits<uint8_t>::max());
-                maxValue = glm::max(maxValue, value);
-                return value;
+                using S = decltype(storage);
+                auto dst = reinterpret_cast<typename S::Type*>(result.data());
+                auto src = data.get();
+                parallel::ForChunks(numVoxels, 1 << 16, [src, dst](uint64_t begin, uint64_t end, unsigned int)
+                {
+                    for (auto i = begin; i < end; ++i) dst[i] = S::Store(src[i]);
+                });
             });
+        }
+        return result;
+    }
+
+    /**
+     *  Computes a key of the volumes raw data for identifying cache files.
+     *  The key combines a hash of the raw data with all dat file parameters that change how the data is
+     *  interpreted. The hash of the data is memoized next to the dat file (see volumeCache::HashFileContent), so the
+     *  raw file is only read again if it changed.
+     *  @return the hash value.
+     */
+    uint64_t Volume::GetContentHash() const
+    {
+        std::stringstream parameters;
+        parameters << volumeSize.x << "," << volumeSize.y << "," << volumeSize.z << "," << texDesc.type << "," << texDesc.format
+            << "," << dataDim << "," << componentSize << "," << scaleValue << "," << dataOffset << "," << voxelStride;
+        auto dataHash = volumeCache::HashFileContent(rawFileName, GetCacheFilename("_content.cache"), volumeCache::HashString(parameters.str()), [this]()
+        {
+            auto rawData = LoadRawDataFromFile();
+            const auto& rawView = rawData->GetView();
+            return volumeCache::HashData(rawView.data, rawView.GetNumBytes());
+        });
+        return volumeCache::HashString(std::to_string(dataHash) + "," + parameters.str());
+    }
+
+    /**
+     *  Returns the name of a cache file next to the volumes dat file.
+     *  @param suffix the suffix (including an extension) replacing the dat files extension.
+     *  @return the cache file name.
+     */
+    std::string Volume::GetCacheFilename(const std::string& suffix) const
+    {
+        boost::filesystem::path volumeFilename(FindResourceLocation(GetParameters()[0]));
+        return volumeFilename.parent_path().string() + "/" + volumeFilename.filename().stem().string() + suffix;
+    }
+
+    /**
+     *  Returns the volume as a bricked volume for out-of-core access.
+     *  The bricked file is created next to the dat file. An existing file is only used if it was created from the
+     *  same data with the same layout, otherwise it is recreated.
+     *  @param brickSize the size of a single brick.
+     *  @return the bricked volume.
+     */
+    std::unique_ptr<BrickedVolume> Volume::GetBrickedVolume(const glm::uvec3& brickSize) const
+    {
+        auto bvolFilename = GetCacheFilename("_bricked" + std::to_string(brickSize.x) + "x" + std::to_string(brickSize.y)
+            + "x" + std::to_string(brickSize.z) + ".bvol");
+        auto sourceKey = GetContentHash();
+
+        if (boost::filesystem::exists(bvolFilename)) {
+            try {
+                auto bricked = std::make_unique<BrickedVolume>(bvolFilename);
+                if (bricked->GetSourceKey() == sourceKey && bricked->GetBrickSize() == brickSize
+                    && bricked->GetLayout().size == volumeSize) return bricked;
+            } catch (std::runtime_error&) {
+                // the file is outdated or damaged and will be recreated.
+            }
+        }
+
+        auto rawData = LoadRawDataFromFile();
+        BrickedVolume::CreateFromView(bvolFilename, rawData->GetView(), brickSize, sourceKey);
+        return std::make_unique<BrickedVolume>(bvolFilename);
+    }
+
+    /**
+     *  Returns an isosurface extractor working on the memory mapped raw data.
+     *  Isovalues are given in normalized values like the ones of the volume texture, positions are scaled by the
+     *  voxel scaling.
+     *  @param slabSize the number of slices processed at once.
+     *  @return the isosurface extractor.
+     */
+    std::unique_ptr<IsosurfaceExtractor> Volume::GetIsosurfaceExtractor(unsigned int slabSize) const
+    {
+        if (dataDim != 1) {
+            LOG(ERROR) << "Isosurfaces can only be extracted from single component volumes.";
+            throw std::runtime_error("Texture format not allowed.");
+        }
+        return std::make_unique<IsosurfaceExtractor>(LoadRawDataFromFile(), cellSize, slabSize);
+    }
+
+    /**
+     *  Returns the histograms and statistics of the volume.
+     *  The statistics are cached next to the dat file and only computed if the cache is missing or was created
+     *  from different data or with different parameters. On a cache hit the raw data is not read.
+     *  @param numBins the number of histogram bins (0 uses 256 bins for 8 bit data and 65536 otherwise).
+     *  @param numGradientBins the number of bins on each axis of the value / gradient magnitude histogram.
+     *  @param brickSize the size of the bricks to summarize.
+     *  @return the statistics.
+     */
+    std::unique_ptr<VolumeStatistics> Volume::GetStatistics(unsigned int numBins, unsigned int numGradientBins, const glm::uvec3& brickSize) const
+    {
+        VolumeCacheKey cacheKey(GetContentHash(),
+            volumeCache::HashString(VolumeStatistics::GetParameterString(numBins, numGradientBins, brickSize)));
+        auto cacheFilename = GetCacheFilename("_statistics.cache");
+
+        auto statistics = std::make_unique<VolumeStatistics>();
+        if (!statistics->LoadFromCache(cacheFilename, cacheKey)) {
+            auto rawData = LoadRawDataFromFile();
+            *statistics = VolumeStatistics(rawData->GetView(), numBins, numGradientBins, brickSize);
+            statistics->SaveToCache(cacheFilename, cacheKey);
+        }
+        return statistics;
+    }
+
+    /**
+     *  Returns the average and min/max pyramids of the volume with all mip levels including the volume data itself
+     *  in storage format as level 0 (see MinMaxPyramid::ReleaseLevel0Data).
+     *  The pyramids are cached next to the dat file, so on a cache hit the raw data is neither read nor converted.
+     *  @param format the storage format of the data (output).
+     *  @return the pyramids.
+     */
+    std::unique_ptr<MinMaxPyramid> Volume::GetMinMaxPyramid(VolumeStorageFormat& format) const
+    {
+        if (dataDim != 1 || !volumeStorage::FromInternalFormat(texDesc.internalFormat, format)) {
+            LOG(ERROR) << "Volume format cannot be loaded to storage data.";
+            throw std::runtime_error("Texture format not allowed.");
+        }
+
+        auto numLevels = MinMaxPyramid::CalcNumLevels(volumeSize);
+        auto parameters = "minmax," + std::to_string(texDesc.internalFormat) + ","
+            + std::to_string(static_cast<int>(loadMode)) + "," + std::to_string(numLevels);
+        VolumeCacheKey cacheKey(GetContentHash(), volumeCache::HashString(parameters));
+        auto cacheFilename = GetCacheFilename("_minmax.cache");
+        auto level0Size = static_cast<uint64_t>(volumeSize.x) * volumeSize.y * volumeSize.z * volumeStorage::GetElementSize(format);
+
+        auto pyramid = std::make_unique<MinMaxPyramid>();
+        if (!pyramid->LoadFromCache(cacheFilename, cacheKey) || pyramid->GetFormat() != format
+            || pyramid->GetNumLevels() == 0 || pyramid->GetLevelData(0).size() != level0Size) {
+            auto level0 = LoadStorageData(format);
+            *pyramid = MinMaxPyramid(level0.data(), volumeSize, format, numLevels);
+            pyramid->SetLevel0Data(std::move(level0));
+            pyramid->SaveToCache(cacheFilename, cacheKey);
+        }
+        return pyramid;
+    }
+
+    /**
+     *  Returns the spherical harmonics coefficient volumes of the volume.
+     *  The coefficients are cached next to the dat file. The cache key only depends on the volume data and the
+     *  parameters, not on the path of the volume, so cache files precomputed on another machine and copied next to
+     *  the dat file are used as well.
+     *  @param level0 the volume data in storage format (as returned by LoadStorageData).
+     *  @param format the storage format of the data.
+     *  @return the coefficients.
+     */
+    std::unique_ptr<SPHCoefficients> Volume::GetSPHCoefficients(const std::vector<uint8_t>& level0, VolumeStorageFormat format) const
+    {
+        auto parameters = "sph," + std::to_string(texDesc.internalFormat) + ","
+            + std::to_string(static_cast<int>(loadMode)) + "," + std::to_string(SPHCoefficients::CalcNumLevels(volumeSize));
+        VolumeCacheKey cacheKey(GetContentHash(), volumeCache::HashString(parameters));
+        auto cacheFilename = GetCacheFilename("_sph.cache");
+
+        auto coefficients = std::make_unique<SPHCoefficients>();
+        if (!coefficients->LoadFromCache(cacheFilename, cacheKey) || coefficients->GetFormat() != format) {
+            *coefficients = SPHCoefficients(level0.data(), volumeSize, format);
+            coefficients->SaveToCache(cacheFilename, cacheKey);
+        }
+        return coefficients;
+    }
+
+    /**
+     *  Returns a volume with the length of the vectors stored in this (RGBA) volume.
+     *  The speed volume is created next to the dat file if it does not exist yet.
+     *  @return the speed volume.
+     */
+    std::shared_ptr<Volume> Volume::GetSpeedVolume() const
+    {
+        if (texDesc.format != GL_RGBA) {
+            LOG(ERROR) << "Speed volumes can only be computed from RGBA volumes.";
+            throw std::runtime_error("Texture format not allowed.");
+        }
+
+        if (texDesc.type == GL_UNSIGNED_BYTE) {
+            return GetDerivedVolume("_speed", "UCHAR", "I", sizeof(uint8_t), 0,
+                DerivedVolumePipeline::VoxelKernel<glm::u8vec4, uint8_t>([](const glm::u8vec4& val)
+            {
+                auto sval = glm::vec3(val.xyz()) / glm::vec3(std::numeric_limits<uint8_t>::max());
+                return static_cast<uint8_t>(glm::length((sval - glm::vec3(0.5f)) * 2.0f) * static_cast<float>(std::numeric_limits<uint8_t>::max()));
+            }));
         } else if (texDesc.type == GL_UNSIGNED_SHORT) {
             auto l_scaleValue = scaleValue;
-            // data = readModifyData<int8_t, uint16_t, uint16_t>(rawData, data_size, [l_scaleValue](const uint16_t& val){ return val * l_scaleValue; });
-            data = readModifyData<float, float, uint16_t, char>(rawData, data_size, [l_scaleValue, &maxValue](const uint16_t& val)
+            return GetDerivedVolume("_speed", "USHORT", "I", sizeof(uint16_t), 0,
+                DerivedVolumePipeline::VoxelKernel<glm::u16vec4, uint16_t>([l_scaleValue](const glm::u16vec4& val)
             {
-                auto value = static_cast<float>(val * l_scaleValue) / static_cast<float>(std::numeric_limits<uint16_t>::max());
-                maxValue = glm::max(maxValue, value);
-                return value;
-            });
+                auto sval = glm::vec3(val.xyz() * glm::u16vec3(l_scaleValue)) / glm::vec3(std::numeric_limits<uint16_t>::max());
+                return static_cast<uint16_t>(glm::length((sval - glm::vec3(0.5f)) * 2.0f) * static_cast<float>(std::numeric_limits<uint16_t>::max()));
+            }));
         } else if (texDesc.type == GL_UNSIGNED_INT) {
-            // data = readModifyData<int8_t, uint32_t, uint32_t>(rawData, data_size, [](const uint32_t& val){ return val; });
-            data = readModifyData<float, float, uint32_t, char>(rawData, data_size, [&maxValue](const uint32_t& val)
-            {
-                auto value = static_cast<float>(val) / static_cast<float>(std::numeric_limits<uint32_t>::max());
-                maxValue = glm::max(maxValue, value);
-                return value;
-            });
-        } else if (texDesc.type == GL_FLOAT) {
-            // data = readModifyData<int8_t, float, float>(rawData, data_size, [](const float& val){ return val; });
-            data = readModifyData<float, float, float, char>(rawData, data_size, [&maxValue](const float& val)
+            return GetDerivedVolume("_speed", "UINT", "I", sizeof(uint32_t), 0,
+                DerivedVolumePipeline::VoxelKernel<glm::u32vec4, uint32_t>([](const glm::u32vec4& val)
             {
-                auto value = val;
-                maxValue = glm::max(maxValue, value);
-                return value;
-            });
+                auto sval = glm::vec3(val.xyz()) / glm::vec3(static_cast<float>(std::numeric_limits<uint32_t>::max()));
+                return static_cast<uint32_t>(glm::length((sval - glm::vec3(0.5f)) * 2.0f) * static_cast<float>(std::numeric_limits<uint32_t>::max()));
+            }));
         }
-
-        data = readModifyData<float, float, float, float>(data, data.size() * sizeof(float), [maxValue](const float& val) { return val / maxValue; });
-
-        auto tempDesc = texDesc;
-        tempDesc.type = GL_FLOAT;
-        auto volTex = std::make_unique<GLTexture>(volumeSize.x, volumeSize.y, volumeSize.z, mipLevels, tempDesc, data.data());
-        return std::move(volTex);
+        return GetDerivedVolume("_speed", "FLOAT", "I", sizeof(float), 0,
+            DerivedVolumePipeline::VoxelKernel<glm::vec4, float>([](const glm::vec4& val)
+        {
+            return glm::length((val.xyz() - glm::vec3(0.5f)) * 2.0f);
+        }));
     }
 
-    std::shared_ptr<Volume> Volume::GetSpeedVolume() const
+    /**
+     *  Returns a volume derived from this one.
+     *  If the derived volume does not exist yet it is computed with a DerivedVolumePipeline and written next to
+     *  the dat file of this volume. The derived volume is loaded with the same parameters as this volume.
+     *  @param suffix the suffix appended to the file name of the derived volume.
+     *  @param format the format of the derived volume (as in dat files).
+     *  @param objectModel the object model of the derived volume (as in dat files).
+     *  @param bytesPerVoxel the size of a voxel of the derived volume.
+     *  @param halo the number of neighboring slices the kernel accesses.
+     *  @param kernel the kernel computing the derived volume.
+     *  @return the derived volume.
+     */
+    std::shared_ptr<Volume> Volume::GetDerivedVolume(const std::string& suffix, const std::string& format, const std::string& objectModel,
+        unsigned int bytesPerVoxel, unsigned int halo, const DerivedVolumePipeline::RowKernel& kernel) const
     {
-        assert(texDesc.format == GL_RGBA);
-
         boost::filesystem::path volumeRelativeFilename(GetParameters()[0]);
         boost::filesystem::path volumeFilename(FindResourceLocation(GetParameters()[0]));
 
-        auto newStrippedFilename = volumeFilename.filename().stem().string() + "_speed";
+        auto newStrippedFilename = volumeFilename.filename().stem().string() + suffix;
 
         auto newDatFilename = volumeFilename.parent_path().string() + "/" + newStrippedFilename + ".dat";
         auto newRelativeDatFilename = volumeRelativeFilename.parent_path().string() + "/" + newStrippedFilename + ".dat";
         auto newRawFilename = volumeFilename.parent_path().string() + "/" + newStrippedFilename + ".raw";
 
         if (!boost::filesystem::exists(newDatFilename)) {
+            std::ofstream rawOut(newRawFilename, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+            if (!rawOut.is_open()) {
+                std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+                LOG(ERROR) << "Could not open file '" << converter.from_bytes(newRawFilename) << "'.";
+                throw std::runtime_error("Could not open file '" + newRawFilename + "'.");
+            }
+
+            auto rawData = LoadRawDataFromFile();
+            DerivedVolumePipeline pipeline(rawData->GetView(), bytesPerVoxel);
+            pipeline.SetHalo(halo);
+            pipeline.Run(kernel, rawOut);
+            rawOut.close();
+
             std::ofstream datOut(newDatFilename, std::ofstream::out | std::ofstream::trunc);
             if (!datOut.is_open()) {
                 std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
@@ -338,70 +794,58 @@ namespace cgu {
                 throw std::runtime_error("Could not open file '" + newDatFilename + "'.");
             }
 
-            std::string newFormat = "UCHAR";
-            if (texDesc.type == GL_UNSIGNED_SHORT) newFormat = "USHORT";
-            else if (texDesc.type == GL_UNSIGNED_INT) newFormat = "UINT";
-
-            datOut << "ObjectFileName:\t" << newRawFilename << ".raw" << std::endl;
+            datOut << "ObjectFileName:\t" << newStrippedFilename << ".raw" << std::endl;
             datOut << "Resolution:\t" << volumeSize.x << " " << volumeSize.y << " " << volumeSize.z << std::endl;
             datOut << "SliceThickness:\t" << cellSize.x << " " << cellSize.y << " " << cellSize.z << std::endl;
-            datOut << "Format:\t" << newFormat << std::endl;
-            datOut << "ObjectModel:\tI" << std::endl;
-
+            datOut << "Format:\t" << format << std::endl;
+            datOut << "ObjectModel:\t" << objectModel << std::endl;
             datOut.close();
+        }
 
-            std::fstream rawOut(newRawFilename, std::ios_base::in | std::ios_base::out | std::ios_base::binary
-                | std::ios_base::trunc);
-            if (!rawOut.is_open()) {
-                std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
-                LOG(ERROR) << "Could not open file '" << converter.from_bytes(newRawFilename) << "'.";
-                throw std::runtime_error("Could not open file '" + newRawFilename + "'.");
-            }
+        std::string newFileParameters;
+        for (unsigned int i = 1; i < GetParameters().size(); ++i) {
+            newFileParameters += "," + GetParameter(i);
+        }
+        return application->GetVolumeManager()->GetResource(newRelativeDatFilename + newFileParameters);
+    }
 
-            unsigned data_size;
-            std::vector<char> rawData;
-            LoadRawDataFromFile(data_size, rawData);
+    /**
+     *  Returns the level of detail chain of this volume.
+     *  Levels that do not exist yet are downsampled on the CPU and written next to the dat file of this volume as
+     *  <name>_lod_<filter>_<level>.dat. The levels are loaded with the same parameters as this volume.
+     *  @param filter the filter used for downsampling.
+     *  @param numLevels the number of levels below this volume (0 for all levels down to a single voxel).
+     *  @return the levels, starting with level 1.
+     */
+    std::vector<std::shared_ptr<Volume>> Volume::GetLODChain(DownsampleFilter filter, unsigned int numLevels) const
+    {
+        if (numLevels == 0) numLevels = VolumeDownsampler::GetNumLODLevels(volumeSize);
 
-            std::vector<int8_t> data;
-            auto volumeNumBytes = volumeSize.x * volumeSize.y * volumeSize.z * texDesc.bytesPP;
+        boost::filesystem::path volumeRelativeFilename(GetParameters()[0]);
+        boost::filesystem::path volumeFilename(FindResourceLocation(GetParameters()[0]));
+        auto lodStrippedFilename = volumeFilename.filename().stem().string() + "_lod_" + VolumeDownsampler::GetFilterName(filter);
 
-            int size = std::min(data_size, volumeNumBytes);
-            if (texDesc.type == GL_UNSIGNED_BYTE) {
-                data = readModifyData<int8_t, uint8_t, glm::u8vec4, char>(rawData, size, [](const glm::u8vec4& val)
-                {
-                    auto sval = glm::vec3(val.xyz()) / glm::vec3(std::numeric_limits<uint8_t>::max());
-                    return static_cast<uint8_t>(glm::length((sval - glm::vec3(0.5f)) * 2.0f) * static_cast<float>(std::numeric_limits<uint8_t>::max()));
-                });
-            } else if (texDesc.type == GL_UNSIGNED_SHORT) {
-                auto l_scaleValue = scaleValue;
-                data = readModifyData<int8_t, uint16_t, glm::u16vec4, char>(rawData, size, [l_scaleValue](const glm::u16vec4& val)
-                {
-                    auto sval = glm::vec3(val.xyz() * glm::u16vec3(l_scaleValue)) / glm::vec3(std::numeric_limits<uint16_t>::max());
-                    return static_cast<uint16_t>(glm::length((sval - glm::vec3(0.5f)) * 2.0f) * static_cast<float>(std::numeric_limits<uint16_t>::max()));
-                });
-            } else if (texDesc.type == GL_UNSIGNED_INT) {
-                data = readModifyData<int8_t, uint32_t, glm::u32vec4, char>(rawData, size, [](const glm::u32vec4& val)
-                {
-                    auto sval = glm::vec3(val.xyz()) / glm::vec3(static_cast<float>(std::numeric_limits<uint32_t>::max()));
-                    return static_cast<uint32_t>(glm::length((sval - glm::vec3(0.5f)) * 2.0f) * static_cast<float>(std::numeric_limits<uint32_t>::max()));
-                });
-            } else if (texDesc.type == GL_FLOAT) {
-                data = readModifyData<int8_t, float, glm::vec4, char>(rawData, size, [](const glm::vec4& val)
-                {
-                    return glm::length((val.xyz() - glm::vec3(0.5f)) * 2.0f);
-                });
-            }
+        auto lodExists = true;
+        for (unsigned int lvl = 1; lvl <= numLevels && lodExists; ++lvl) {
+            lodExists = boost::filesystem::exists(volumeFilename.parent_path().string() + "/" + lodStrippedFilename + "_" + std::to_string(lvl) + ".dat");
+        }
 
-            auto dataPtr = reinterpret_cast<char*>(data.data());
-            rawOut.seekp(0, std::ios::beg);
-            rawOut.write(dataPtr, size);
-            rawOut.close();
+        if (!lodExists) {
+            auto rawData = LoadRawDataFromFile();
+            VolumeDownsampler downsampler(filter);
+            downsampler.WriteLODChain(rawData->GetView(), cellSize, volumeFilename.parent_path().string() + "/" + lodStrippedFilename, numLevels);
         }
 
         std::string newFileParameters;
         for (unsigned int i = 1; i < GetParameters().size(); ++i) {
             newFileParameters += "," + GetParameter(i);
         }
-        return application->GetVolumeManager()->GetResource(newRelativeDatFilename + newFileParameters);
+
+        std::vector<std::shared_ptr<Volume>> levels;
+        for (unsigned int lvl = 1; lvl <= numLevels; ++lvl) {
+            auto lodRelativeDatFilename = volumeRelativeFilename.parent_path().string() + "/" + lodStrippedFilename + "_" + std::to_string(lvl) + ".dat";
+            levels.push_back(application->GetVolumeManager()->GetResource(lodRelativeDatFilename + newFileParameters));
+        }
+        return levels;
     }
 }
@@ -12,10 +12,45 @@
 #include "main.h"
 #include "core/Resource.h"
 #include "gfx/glrenderer/GLTexture.h"
+#include "gfx/volumes/RawVolumeSource.h"
+#include "gfx/volumes/VolumeStorage.h"
+#include "gfx/volumes/DerivedVolumePipeline.h"
+#include <mutex>
 
 namespace cgu {
 
     class MinMaxVolume;
+    class BrickedVolume;
+    class VolumeStatistics;
+    class MinMaxPyramid;
+    class SPHCoefficients;
+    class IsosurfaceExtractor;
+    enum class DownsampleFilter;
+
+    /** The precision volume data is kept in when loaded to a texture. */
+    enum class VolumeLoadMode
+    {
+        /** Data is expanded to float (internal format may be reduced by forceBits). */
+        FLOAT,
+        /** 8 and 16 bit data is kept as normalized integers, other data is expanded to float. */
+        NATIVE,
+        /** Data is converted to half float on the CPU. */
+        HALF
+    };
+
+    /** Volume data converted on the CPU to the format it is uploaded to a texture with. */
+    struct VolumeTextureData
+    {
+        /** Holds the texture descriptor (the type is the type of the data). */
+        TextureDescriptor descriptor = TextureDescriptor(4, GL_R8, GL_RED, GL_UNSIGNED_BYTE);
+        /** Holds the size of the volume. */
+        glm::uvec3 size;
+        /** Holds the tightly packed voxels. */
+        std::vector<uint8_t> data;
+
+        /** Returns the number of bytes of a single z slice. */
+        uint64_t GetSliceSize() const { return size.z == 0 ? 0 : data.size() / size.z; }
+    };
 
     /**
      *  @brief Volume resource.
@@ -34,12 +69,30 @@ namespace cgu {
         virtual ~Volume();
 
         std::unique_ptr<GLTexture> Load3DTexture(unsigned int mipLevels) const;
+        VolumeTextureData LoadTextureData(const std::function<bool(float)>& reportProgress = nullptr) const;
+        VolumeTextureData LoadTextureData(float maxValue, const std::function<bool(float)>& reportProgress = nullptr) const;
+        float GetMaximumValue() const;
+        VolumeTextureData LoadStridedTextureData(unsigned int stride) const;
 
         const glm::vec3& GetScaling() const { return cellSize; }
 
         std::shared_ptr<Volume> GetSpeedVolume() const;
+        std::shared_ptr<Volume> GetDerivedVolume(const std::string& suffix, const std::string& format, const std::string& objectModel,
+            unsigned int bytesPerVoxel, unsigned int halo, const DerivedVolumePipeline::RowKernel& kernel) const;
+        std::vector<std::shared_ptr<Volume>> GetLODChain(DownsampleFilter filter, unsigned int numLevels = 0) const;
         const TextureDescriptor& GetTextureDescriptor() const { return texDesc; }
         const glm::uvec3& GetSize() const { return volumeSize; }
+        VolumeLoadMode GetLoadMode() const { return loadMode; }
+        std::unique_ptr<RawVolumeSource> LoadRawDataFromFile() const;
+        std::unique_ptr<BrickedVolume> GetBrickedVolume(const glm::uvec3& brickSize) const;
+        std::unique_ptr<IsosurfaceExtractor> GetIsosurfaceExtractor(unsigned int slabSize = 64) const;
+        std::unique_ptr<VolumeStatistics> GetStatistics(unsigned int numBins = 0, unsigned int numGradientBins = 256,
+            const glm::uvec3& brickSize = glm::uvec3(32)) const;
+        std::vector<uint8_t> LoadStorageData(VolumeStorageFormat& format) const;
+        std::unique_ptr<MinMaxPyramid> GetMinMaxPyramid(VolumeStorageFormat& format) const;
+        std::unique_ptr<SPHCoefficients> GetSPHCoefficients(const std::vector<uint8_t>& level0, VolumeStorageFormat format) const;
+        uint64_t GetContentHash() const;
+        std::string GetCacheFilename(const std::string& suffix) const;
 
     private:
         /** Holds the textures size. */
@@ -52,11 +105,27 @@ namespace cgu {
         unsigned int scaleValue;
         /** Holds the dimension of the data. */
         int dataDim;
+        /** Holds the size of a single component in the raw file. */
+        unsigned int componentSize;
+        /** Holds the offset of the first voxel in the raw file. */
+        uint64_t dataOffset;
+        /** Holds the number of bytes between two voxels in the raw file (0 for packed voxels). */
+        uint64_t voxelStride;
         /** Holds the texture description. */
         TextureDescriptor texDesc;
+        /** Holds the precision the data is uploaded with. */
+        VolumeLoadMode loadMode;
+        /** Holds the decoded data of a compressed volume (decoded on first use). */
+        mutable std::shared_ptr<const std::vector<uint8_t>> decodedData;
+        /** Holds the mutex for decoding compressed volumes. */
+        mutable std::mutex decodeMutex;
 
         void LoadDatFile();
-        void LoadRawDataFromFile(unsigned int& data_size, std::vector<char>& rawData) const;
+        void SetLoadModeFormat();
+        VolumeTextureData ConvertTextureData(const VolumeDataView& rawView, const std::function<bool(float)>& reportProgress = nullptr) const;
+        VolumeTextureData NormalizeTextureData(const VolumeDataView& rawView, float maxValue, const std::function<bool(float)>& reportProgress,
+            float progressStart) const;
+        unsigned int GetProgressSlabDepth(const VolumeDataView& rawView) const;
     };
 }
 
@@ -0,0 +1,178 @@
+/**
+ * @file   VolumeCache.cpp
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Implementation of the helpers for cache files of data derived from volumes.
+ */
+
+#include "VolumeCache.h"
+#include "core/parallel_helper.h"
+#include "core/serializationHelper.h"
+#include <boost/filesystem.hpp>
+#include <codecvt>
+#include <cstring>
+
+namespace cgu {
+
+    namespace volumeCache {
+
+        /** The number of bytes hashed by a single task, the hash does not depend on the number of threads. */
+        static const uint64_t HASH_CHUNK_SIZE = 1 << 22;
+        /** The multiplier used for hashing. */
+        static const uint64_t HASH_PRIME = 0x100000001b3ULL;
+        /** The initial value of a hash. */
+        static const uint64_t HASH_OFFSET = 0xcbf29ce484222325ULL;
+        /** The serializer of the files memoizing content hashes. */
+        using ContentHashSerializerType = serializeHelper::VersionableSerializer<'V', 'H', 'S', 'H', 1001>;
+
+        /** Mixes the bits of a hash value. */
+        static uint64_t mix(uint64_t h)
+        {
+            h ^= h >> 33;
+            h *= 0xff51afd7ed558ccdULL;
+            h ^= h >> 33;
+            h *= 0xc4ceb9fe1a85ec53ULL;
+            h ^= h >> 33;
+            return h;
+        }
+
+        /** Hashes a block of memory 8 bytes at a time. */
+        static uint64_t hashBlock(const uint8_t* data, uint64_t size)
+        {
+            auto h = HASH_OFFSET ^ size;
+            uint64_t i = 0;
+            for (; i + 8 <= size; i += 8) {
+                uint64_t word;
+                std::memcpy(&word, data + i, 8);
+                h = (h ^ word) * HASH_PRIME;
+            }
+            for (; i < size; ++i) h = (h ^ data[i]) * HASH_PRIME;
+            return mix(h);
+        }
+
+        /**
+         *  Computes a 64 bit hash of a block of data.
+         *  The data is split into fixed chunks that are hashed in parallel and combined in order.
+         *  @param data the data to hash.
+         *  @param size the size of the data in bytes.
+         *  @param numThreads the number of threads to use (0 to use all hardware threads).
+         *  @return the hash value.
+         */
+        uint64_t HashData(const uint8_t* data, uint64_t size, unsigned int numThreads)
+        {
+            auto numChunks = (size + HASH_CHUNK_SIZE - 1) / HASH_CHUNK_SIZE;
+            std::vector<uint64_t> chunkHashes(static_cast<std::size_t>(numChunks));
+            parallel::ForChunks(numChunks, 1, [data, size, &chunkHashes](uint64_t begin, uint64_t, unsigned int)
+            {
+                auto offset = begin * HASH_CHUNK_SIZE;
+                chunkHashes[static_cast<std::size_t>(begin)] = hashBlock(data + offset, std::min(HASH_CHUNK_SIZE, size - offset));
+            }, numThreads);
+
+            auto h = mix(HASH_OFFSET ^ size);
+            for (auto chunkHash : chunkHashes) h = mix((h ^ chunkHash) * HASH_PRIME);
+            return h;
+        }
+
+        /**
+         *  Computes a 64 bit hash of a string.
+         *  @param str the string to hash.
+         *  @return the hash value.
+         */
+        uint64_t HashString(const std::string& str)
+        {
+            return hashBlock(reinterpret_cast<const uint8_t*>(str.data()), str.size());
+        }
+
+        /**
+         *  Computes a hash identifying a version of a file without reading it.
+         *  The hash combines the absolute path, the size and the last modification time of the file.
+         *  @param filename the name of the file.
+         *  @return the hash value.
+         */
+        uint64_t HashFileStamp(const std::string& filename)
+        {
+            boost::filesystem::path path(filename);
+            auto stamp = boost::filesystem::absolute(path).generic_string() + "," + std::to_string(boost::filesystem::file_size(path))
+                + "," + std::to_string(static_cast<int64_t>(boost::filesystem::last_write_time(path)));
+            return HashString(stamp);
+        }
+
+        /**
+         *  Returns the hash of a files content. Hashing reads the whole file, so the hash is memoized in a second
+         *  file together with the files stamp (see HashFileStamp) and is only recomputed if the stamp changes.
+         *  As the modification time has a resolution of seconds, the memo is only used if it was written after the
+         *  last modification of the file: a file rewritten with the same size in the same second the memo was
+         *  written is hashed again.
+         *  @param filename the name of the file.
+         *  @param memoFilename the name of the file memoizing the hash.
+         *  @param parameterHash a hash of everything else the content hash depends on.
+         *  @param hashContent the function computing the hash of the content (e.g. by HashData).
+         *  @return the hash value.
+         */
+        uint64_t HashFileContent(const std::string& filename, const std::string& memoFilename, uint64_t parameterHash,
+            const std::function<uint64_t()>& hashContent)
+        {
+            VolumeCacheKey stampKey(HashFileStamp(filename), parameterHash);
+            boost::system::error_code ec;
+            auto memoTime = boost::filesystem::last_write_time(memoFilename, ec);
+
+            uint64_t contentHash = 0;
+            if (!ec && memoTime > boost::filesystem::last_write_time(filename)
+                && ReadCache<ContentHashSerializerType>(memoFilename, stampKey, [&contentHash](std::istream& ifs)
+            {
+                serializeHelper::read(ifs, contentHash);
+                return true;
+            })) return contentHash;
+
+            contentHash = hashContent();
+            WriteCache<ContentHashSerializerType>(memoFilename, stampKey, [contentHash](std::ostream& ofs) { serializeHelper::write(ofs, contentHash); });
+            return contentHash;
+        }
+
+        /**
+         *  Writes a cache key to a stream.
+         *  @param ofs the stream to write to.
+         *  @param key the key to write.
+         */
+        void WriteKey(std::ostream& ofs, const VolumeCacheKey& key)
+        {
+            serializeHelper::write(ofs, key.contentHash);
+            serializeHelper::write(ofs, key.parameterHash);
+        }
+
+        /**
+         *  Reads a cache key from a stream and compares it.
+         *  @param ifs the stream to read from.
+         *  @param key the expected key.
+         *  @return whether the key could be read and is equal to the expected one.
+         */
+        bool CheckKey(std::istream& ifs, const VolumeCacheKey& key)
+        {
+            VolumeCacheKey fileKey;
+            serializeHelper::read(ifs, fileKey.contentHash);
+            serializeHelper::read(ifs, fileKey.parameterHash);
+            return ifs.good() && fileKey == key;
+        }
+
+        /**
+         *  Reports a cache file that matched its key but could not be read, it will be rebuilt.
+         *  @param filename the name of the cache file.
+         */
+        void ReportCorruptCache(const std::string& filename)
+        {
+            std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+            LOG(WARNING) << "Cache file '" << converter.from_bytes(filename) << "' is corrupt and will be rebuilt.";
+        }
+
+        /**
+         *  Reports a cache file that could not be written.
+         *  @param filename the name of the cache file.
+         */
+        void ReportCacheWriteError(const std::string& filename)
+        {
+            std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+            LOG(WARNING) << "Could not write cache file '" << converter.from_bytes(filename) << "'.";
+        }
+    }
+}
@@ -0,0 +1,90 @@
+/**
+ * @file   VolumeCache.h
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Contains helpers for cache files of data derived from volumes.
+ */
+
+#ifndef VOLUMECACHE_H
+#define VOLUMECACHE_H
+
+#include "main.h"
+#include <fstream>
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <tuple>
+
+namespace cgu {
+
+    /** Identifies data derived from a volume by the volumes content and the parameters used. */
+    struct VolumeCacheKey
+    {
+        VolumeCacheKey() : contentHash{ 0 }, parameterHash{ 0 } {}
+        VolumeCacheKey(uint64_t content, uint64_t parameters) : contentHash{ content }, parameterHash{ parameters } {}
+
+        /** Holds a key identifying the volumes raw data (see Volume::GetContentHash). */
+        uint64_t contentHash;
+        /** Holds the hash of the parameters the data was generated with. */
+        uint64_t parameterHash;
+
+        bool operator==(const VolumeCacheKey& rhs) const { return contentHash == rhs.contentHash && parameterHash == rhs.parameterHash; }
+        bool operator!=(const VolumeCacheKey& rhs) const { return !(*this == rhs); }
+    };
+
+    namespace volumeCache {
+
+        uint64_t HashData(const uint8_t* data, uint64_t size, unsigned int numThreads = 0);
+        uint64_t HashString(const std::string& str);
+        uint64_t HashFileStamp(const std::string& filename);
+        uint64_t HashFileContent(const std::string& filename, const std::string& memoFilename, uint64_t parameterHash,
+            const std::function<uint64_t()>& hashContent);
+        void WriteKey(std::ostream& ofs, const VolumeCacheKey& key);
+        bool CheckKey(std::istream& ifs, const VolumeCacheKey& key);
+        void ReportCorruptCache(const std::string& filename);
+        void ReportCacheWriteError(const std::string& filename);
+
+        /**
+         *  Reads a cache file consisting of a header, the key and the cached data.
+         *  @param filename the name of the cache file.
+         *  @param key the key the cache file needs to have.
+         *  @param readContent reads the cached data from the stream, returns false if the data does not fit.
+         *  @return whether the file existed, matched the key and the data could be read.
+         */
+        template<class SerializerType, class Fn> bool ReadCache(const std::string& filename, const VolumeCacheKey& key, Fn readContent)
+        {
+            std::ifstream ifs(filename, std::ios::in | std::ios::binary);
+            if (!ifs.is_open()) return false;
+
+            bool correctHeader;
+            unsigned int actualVersion;
+            std::tie(correctHeader, actualVersion) = SerializerType::checkHeader(ifs);
+            if (!correctHeader || !CheckKey(ifs, key)) return false;
+            if (readContent(static_cast<std::istream&>(ifs)) && ifs) return true;
+
+            ReportCorruptCache(filename);
+            return false;
+        }
+
+        /**
+         *  Writes a cache file consisting of a header, the key and the cached data. Failing to write the cache is
+         *  not an error.
+         *  @param filename the name of the cache file.
+         *  @param key the key to store with the data.
+         *  @param writeContent writes the cached data to the stream.
+         */
+        template<class SerializerType, class Fn> void WriteCache(const std::string& filename, const VolumeCacheKey& key, Fn writeContent)
+        {
+            std::ofstream ofs(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+            if (ofs.is_open()) {
+                SerializerType::writeHeader(ofs);
+                WriteKey(ofs, key);
+                writeContent(static_cast<std::ostream&>(ofs));
+            }
+            if (!ofs) ReportCacheWriteError(filename);
+        }
+    }
+}
+
+#endif // VOLUMECACHE_H
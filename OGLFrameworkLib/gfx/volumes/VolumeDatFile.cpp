@@ -0,0 +1,104 @@
+/**
+ * @file   VolumeDatFile.cpp
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Implementation of the reader for volume description (.dat) files.
+ */
+
+#include "VolumeDatFile.h"
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <sstream>
+
+namespace cgu {
+
+    /**
+     *  Reads a dat file.
+     *  @param datFilename the name of the dat file.
+     *  @return whether the file could be opened.
+     */
+    bool VolumeDatFile::Read(const std::string& datFilename)
+    {
+        std::ifstream ifs(datFilename);
+        if (!ifs.is_open()) return false;
+
+        filename = datFilename;
+        std::stringstream content;
+        std::string line;
+        while (std::getline(ifs, line)) {
+            lines.push_back(line);
+            content << line << "\n";
+        }
+
+        std::string str;
+        while (content >> str && content.good()) {
+            if (str == "ObjectFileName:") content >> rawFile;
+            else if (str == "Resolution:") content >> resolution.x >> resolution.y >> resolution.z;
+            else if (str == "SliceThickness:") content >> sliceThickness.x >> sliceThickness.y >> sliceThickness.z;
+            else if (str == "Format:") content >> format;
+            else if (str == "ObjectModel:") content >> objectModel;
+            else if (str == "DataOffset:") content >> dataOffset;
+            else if (str == "VoxelStride:") content >> voxelStride;
+        }
+        return true;
+    }
+
+    /**
+     *  Returns the path of the raw file.
+     *  @return the raw files path.
+     */
+    std::string VolumeDatFile::GetRawFilePath() const
+    {
+        return boost::filesystem::path(filename).parent_path().string() + "/" + rawFile;
+    }
+
+    /**
+     *  Returns the layout of the raw data.
+     *  @param layout the layout of the raw data, the data pointer is not set (output).
+     *  @return whether all required fields were found and are supported.
+     */
+    bool VolumeDatFile::GetLayout(VolumeDataView& layout) const
+    {
+        if (rawFile == "" || resolution == glm::uvec3(0)) return false;
+        if (!ParseFormat(format, layout) || !ParseObjectModel(objectModel, layout)) return false;
+        layout.size = resolution;
+        layout.bytesPerVoxel *= layout.numComponents;
+        layout.voxelStride = voxelStride;
+        return true;
+    }
+
+    /**
+     *  Sets the type, scale value and component size (in bytesPerVoxel) of a layout from a format string.
+     *  @param format the format (UCHAR, USHORT, USHORT_12, UINT or FLOAT).
+     *  @param layout the layout to set (output).
+     *  @return whether the format is supported.
+     */
+    bool VolumeDatFile::ParseFormat(const std::string& format, VolumeDataView& layout)
+    {
+        layout.scaleValue = 1;
+        if (format == "UCHAR") { layout.type = GL_UNSIGNED_BYTE; layout.bytesPerVoxel = 1; }
+        else if (format == "USHORT") { layout.type = GL_UNSIGNED_SHORT; layout.bytesPerVoxel = 2; }
+        else if (format == "USHORT_12") { layout.type = GL_UNSIGNED_SHORT; layout.bytesPerVoxel = 2; layout.scaleValue = 16; }
+        else if (format == "UINT") { layout.type = GL_UNSIGNED_INT; layout.bytesPerVoxel = 4; }
+        else if (format == "FLOAT") { layout.type = GL_FLOAT; layout.bytesPerVoxel = 4; }
+        else return false;
+        return true;
+    }
+
+    /**
+     *  Sets the number of components of a layout from an object model string.
+     *  @param objectModel the object model (I, RG/XY, RGB/XYZ or RGBA/XYZW).
+     *  @param layout the layout to set (output).
+     *  @return whether the object model is supported.
+     */
+    bool VolumeDatFile::ParseObjectModel(const std::string& objectModel, VolumeDataView& layout)
+    {
+        if (objectModel == "I") layout.numComponents = 1;
+        else if (objectModel == "RG" || objectModel == "XY") layout.numComponents = 2;
+        else if (objectModel == "RGB" || objectModel == "XYZ") layout.numComponents = 3;
+        else if (objectModel == "RGBA" || objectModel == "XYZW") layout.numComponents = 4;
+        else return false;
+        return true;
+    }
+}
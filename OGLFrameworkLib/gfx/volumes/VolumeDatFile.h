@@ -0,0 +1,55 @@
+/**
+ * @file   VolumeDatFile.h
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Contains the reader for volume description (.dat) files.
+ */
+
+#ifndef VOLUMEDATFILE_H
+#define VOLUMEDATFILE_H
+
+#include "main.h"
+#include "gfx/volumes/RawVolumeSource.h"
+
+namespace cgu {
+
+    /**
+     *  @brief The fields of a volume description (.dat) file.
+     *  Fields are read as whitespace separated "Name: values" pairs, unknown fields are ignored. The lines of the
+     *  file are kept so derived dat files can be written.
+     *
+     * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+     * @date   2026.10.16
+     */
+    struct VolumeDatFile
+    {
+        bool Read(const std::string& datFilename);
+        std::string GetRawFilePath() const;
+        bool GetLayout(VolumeDataView& layout) const;
+
+        static bool ParseFormat(const std::string& format, VolumeDataView& layout);
+        static bool ParseObjectModel(const std::string& objectModel, VolumeDataView& layout);
+
+        /** Holds the name of the dat file. */
+        std::string filename;
+        /** Holds the lines of the dat file. */
+        std::vector<std::string> lines;
+        /** Holds the name of the raw file (relative to the dat file). */
+        std::string rawFile;
+        /** Holds the resolution of the volume. */
+        glm::uvec3 resolution = glm::uvec3(0);
+        /** Holds the size of a voxel. */
+        glm::vec3 sliceThickness = glm::vec3(1.0f);
+        /** Holds the format of a component. */
+        std::string format;
+        /** Holds the object model (number and meaning of the components). */
+        std::string objectModel;
+        /** Holds the offset of the first voxel in the raw file. */
+        uint64_t dataOffset = 0;
+        /** Holds the number of bytes between two voxels in the raw file (0 for packed voxels). */
+        uint64_t voxelStride = 0;
+    };
+}
+
+#endif // VOLUMEDATFILE_H
@@ -0,0 +1,298 @@
+/**
+ * @file   VolumeDataConversion.cpp
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Implementation of the functions to convert raw volume data for uploading.
+ */
+
+#include "VolumeDataConversion.h"
+#include "core/parallel_helper.h"
+#include <glm/gtc/packing.hpp>
+#include <limits>
+
+namespace cgu {
+
+    namespace volumeConversion {
+
+        /** The number of voxels converted by a single task. */
+        static const uint64_t CONVERSION_CHUNK_SIZE = 1 << 16;
+
+        /** Converts unsigned bytes to float. */
+        struct UByteConverter
+        {
+            using Type = uint8_t;
+            float operator()(uint8_t val) const { return static_cast<float>(val) / static_cast<float>(std::numeric_limits<uint8_t>::max()); }
+        };
+
+        /** Converts unsigned shorts to float, applying the scale value. */
+        struct UShortConverter
+        {
+            using Type = uint16_t;
+            explicit UShortConverter(unsigned int scale) : scaleValue(scale) {}
+            float operator()(uint16_t val) const { return static_cast<float>(val * scaleValue) / static_cast<float>(std::numeric_limits<uint16_t>::max()); }
+            unsigned int scaleValue;
+        };
+
+        /** Converts unsigned integers to float. */
+        struct UIntConverter
+        {
+            using Type = uint32_t;
+            float operator()(uint32_t val) const { return static_cast<float>(val) / static_cast<float>(std::numeric_limits<uint32_t>::max()); }
+        };
+
+        /** Passes floats through. */
+        struct FloatConverter
+        {
+            using Type = float;
+            float operator()(float val) const { return val; }
+        };
+
+        /** Returns the value data is divided by for normalization (1 for volumes without positive values). */
+        static float normalizationDivisor(float maxValue)
+        {
+            return maxValue > 0.0f ? maxValue : 1.0f;
+        }
+
+        /** Calls a function with the converter matching the views data type. */
+        template<typename Fn>
+        static auto withConverter(const VolumeDataView& view, Fn fn) -> decltype(fn(FloatConverter()))
+        {
+            switch (view.type) {
+            case GL_UNSIGNED_BYTE: return fn(UByteConverter());
+            case GL_UNSIGNED_SHORT: return fn(UShortConverter(view.scaleValue));
+            case GL_UNSIGNED_INT: return fn(UIntConverter());
+            case GL_FLOAT: return fn(FloatConverter());
+            default:
+                LOG(ERROR) << "Volume data type " << view.type << " cannot be converted.";
+                throw std::runtime_error("Volume data type cannot be converted.");
+            }
+        }
+
+        /**
+         *  Computes the maximum raw value of all components in the volume.
+         *  The loops over contiguous data are kept simple so the compiler can vectorize them.
+         */
+        template<typename I>
+        static I findMaximum(const VolumeDataView& view, unsigned int numThreads)
+        {
+            auto elementsPerVoxel = view.bytesPerVoxel / sizeof(I);
+            std::vector<I> threadMax(numThreads == 0 ? parallel::GetNumThreads() : numThreads, std::numeric_limits<I>::lowest());
+            parallel::ForChunks(view.GetNumVoxels(), CONVERSION_CHUNK_SIZE, [&view, &threadMax, elementsPerVoxel](uint64_t begin, uint64_t end, unsigned int threadIdx)
+            {
+                auto maxValue = threadMax[threadIdx];
+                if (view.IsContiguous()) {
+                    auto src = reinterpret_cast<const I*>(view.GetVoxel(begin));
+                    auto numElements = (end - begin) * elementsPerVoxel;
+                    for (uint64_t i = 0; i < numElements; ++i) maxValue = src[i] > maxValue ? src[i] : maxValue;
+                } else {
+                    for (auto v = begin; v < end; ++v) {
+                        auto src = reinterpret_cast<const I*>(view.GetVoxel(v));
+                        for (size_t i = 0; i < elementsPerVoxel; ++i) maxValue = src[i] > maxValue ? src[i] : maxValue;
+                    }
+                }
+                threadMax[threadIdx] = maxValue;
+            }, numThreads);
+
+            auto result = std::numeric_limits<I>::lowest();
+            for (auto value : threadMax) result = value > result ? value : result;
+            return result;
+        }
+
+        /**
+         *  Applies a function to all components of the volume in parallel chunks.
+         *  The output is tightly packed with numComponents values per voxel.
+         */
+        template<typename I, typename O, typename Fn>
+        static void transform(const VolumeDataView& view, O* data, unsigned int numThreads, Fn fn)
+        {
+            auto elementsPerVoxel = view.bytesPerVoxel / sizeof(I);
+            parallel::ForChunks(view.GetNumVoxels(), CONVERSION_CHUNK_SIZE, [&view, data, elementsPerVoxel, &fn](uint64_t begin, uint64_t end, unsigned int)
+            {
+                auto dst = data + begin * elementsPerVoxel;
+                if (view.IsContiguous()) {
+                    auto src = reinterpret_cast<const I*>(view.GetVoxel(begin));
+                    auto numElements = (end - begin) * elementsPerVoxel;
+                    for (uint64_t i = 0; i < numElements; ++i) dst[i] = fn(src[i]);
+                } else {
+                    for (auto v = begin; v < end; ++v) {
+                        auto src = reinterpret_cast<const I*>(view.GetVoxel(v));
+                        for (size_t i = 0; i < elementsPerVoxel; ++i) *dst++ = fn(src[i]);
+                    }
+                }
+            }, numThreads);
+        }
+
+        /**
+         *  Finds the value the volume is normalized with.
+         *  This is the maximum of all components after conversion to float (but at least 0). As all conversions are
+         *  monotonic it is computed on the raw data.
+         *  @param view the raw volume data.
+         *  @param numThreads the number of threads to use (0 to use all hardware threads).
+         *  @return the maximum value used for normalization.
+         */
+        float FindMaximumValue(const VolumeDataView& view, unsigned int numThreads)
+        {
+            return withConverter(view, [&view, numThreads](auto convert)
+            {
+                using I = typename decltype(convert)::Type;
+                return glm::max(0.0f, convert(findMaximum<I>(view, numThreads)));
+            });
+        }
+
+        /**
+         *  Converts raw volume data to floats in [0, 1] and normalizes them by the maximum value of the volume.
+         *  All components of all voxels are converted in parallel chunks. The result is bit-exact to converting each
+         *  value to float (dividing integers by the maximum value of their type and applying the scale value) and
+         *  dividing by the maximum converted value afterwards. Volumes without a positive value are not normalized.
+         *  @param view the raw volume data.
+         *  @param data the converted data, has to hold numVoxels * numComponents floats (output).
+         *  @param numThreads the number of threads to use (0 to use all hardware threads).
+         *  @return the maximum value used for normalization.
+         */
+        float ConvertToNormalizedFloat(const VolumeDataView& view, float* data, unsigned int numThreads)
+        {
+            auto maxValue = FindMaximumValue(view, numThreads);
+            ConvertToNormalizedFloat(view, maxValue, data, numThreads);
+            return maxValue;
+        }
+
+        /**
+         *  Converts raw volume data to floats normalized by a given value.
+         *  Converting the slices of a volume separately with the maximum of the whole volume gives the same values as
+         *  converting the whole volume at once.
+         *  @param view the raw volume data.
+         *  @param maxValue the value the volume is normalized with (see FindMaximumValue).
+         *  @param data the converted data, has to hold numVoxels * numComponents floats (output).
+         *  @param numThreads the number of threads to use (0 to use all hardware threads).
+         */
+        void ConvertToNormalizedFloat(const VolumeDataView& view, float maxValue, float* data, unsigned int numThreads)
+        {
+            auto divisor = normalizationDivisor(maxValue);
+            withConverter(view, [&view, data, numThreads, divisor](auto convert)
+            {
+                using I = typename decltype(convert)::Type;
+                transform<I>(view, data, numThreads, [convert, divisor](I val) { return convert(val) / divisor; });
+            });
+        }
+
+        /**
+         *  Converts a run of consecutive voxels to normalized floats on the calling thread.
+         *  The values are the same as the ones ConvertToNormalizedFloat computes for these voxels.
+         *  @param view the layout of the raw data.
+         *  @param firstVoxel a pointer to the first voxel to convert.
+         *  @param numVoxels the number of voxels to convert.
+         *  @param maxValue the value the volume is normalized with (see FindMaximumValue).
+         *  @param data the converted data, has to hold numVoxels * numComponents floats (output).
+         */
+        void ConvertVoxelsToNormalizedFloat(const VolumeDataView& view, const uint8_t* firstVoxel, uint64_t numVoxels,
+            float maxValue, float* data)
+        {
+            auto divisor = normalizationDivisor(maxValue);
+            withConverter(view, [&view, firstVoxel, numVoxels, divisor, data](auto convert)
+            {
+                using I = typename decltype(convert)::Type;
+                auto elementsPerVoxel = view.bytesPerVoxel / sizeof(I);
+                if (view.IsContiguous()) {
+                    auto src = reinterpret_cast<const I*>(firstVoxel);
+                    auto numElements = numVoxels * elementsPerVoxel;
+                    for (uint64_t i = 0; i < numElements; ++i) data[i] = convert(src[i]) / divisor;
+                } else {
+                    auto dst = data;
+                    for (uint64_t v = 0; v < numVoxels; ++v) {
+                        auto src = reinterpret_cast<const I*>(firstVoxel + v * view.voxelStride);
+                        for (size_t i = 0; i < elementsPerVoxel; ++i) *dst++ = convert(src[i]) / divisor;
+                    }
+                }
+            });
+        }
+
+        /**
+         *  Converts raw volume data to normalized half floats.
+         *  The values are the same as the ones of ConvertToNormalizedFloat rounded to half precision.
+         *  @param view the raw volume data.
+         *  @param data the converted data, has to hold numVoxels * numComponents half floats (output).
+         *  @param numThreads the number of threads to use (0 to use all hardware threads).
+         *  @return the maximum value used for normalization.
+         */
+        float ConvertToNormalizedHalf(const VolumeDataView& view, uint16_t* data, unsigned int numThreads)
+        {
+            auto maxValue = FindMaximumValue(view, numThreads);
+            ConvertToNormalizedHalf(view, maxValue, data, numThreads);
+            return maxValue;
+        }
+
+        /**
+         *  Converts raw volume data to half floats normalized by a given value.
+         *  @param view the raw volume data.
+         *  @param maxValue the value the volume is normalized with (see FindMaximumValue).
+         *  @param data the converted data, has to hold numVoxels * numComponents half floats (output).
+         *  @param numThreads the number of threads to use (0 to use all hardware threads).
+         */
+        void ConvertToNormalizedHalf(const VolumeDataView& view, float maxValue, uint16_t* data, unsigned int numThreads)
+        {
+            auto divisor = normalizationDivisor(maxValue);
+            withConverter(view, [&view, data, numThreads, divisor](auto convert)
+            {
+                using I = typename decltype(convert)::Type;
+                transform<I>(view, data, numThreads, [convert, divisor](I val)
+                {
+                    return static_cast<uint16_t>(glm::packHalf1x16(convert(val) / divisor));
+                });
+            });
+        }
+
+        /**
+         *  Checks if the volume data can be stored in a normalized integer texture of the same width.
+         *  This is the case for 8 and 16 bit data.
+         *  @param view the raw volume data.
+         *  @return whether the data can be stored at native precision.
+         */
+        bool HasNativeFormat(const VolumeDataView& view)
+        {
+            return view.type == GL_UNSIGNED_BYTE || view.type == GL_UNSIGNED_SHORT;
+        }
+
+        /**
+         *  Checks if the volume data can be uploaded to a normalized integer texture without any conversion.
+         *  @param view the raw volume data.
+         *  @param maxValue the value the volume is normalized with.
+         *  @return whether the data can be used directly.
+         */
+        bool IsNativeNormalized(const VolumeDataView& view, float maxValue)
+        {
+            return HasNativeFormat(view) && view.IsContiguous() && view.scaleValue == 1 && maxValue == 1.0f;
+        }
+
+        /**
+         *  Normalizes raw 8 or 16 bit volume data keeping the type of the data.
+         *  The maximum value of the volume is mapped to the maximum value of the type, all values are rounded to the
+         *  nearest representable value. A volume without a positive value is converted to zeros.
+         *  @param view the raw volume data.
+         *  @param maxValue the value the volume is normalized with (see FindMaximumValue).
+         *  @param data the converted data, has to hold numVoxels * bytesPerVoxel bytes (output).
+         *  @param numThreads the number of threads to use (0 to use all hardware threads).
+         */
+        void ConvertToNormalizedNative(const VolumeDataView& view, float maxValue, void* data, unsigned int numThreads)
+        {
+            if (view.type == GL_UNSIGNED_BYTE) {
+                UByteConverter convert;
+                auto scale = maxValue > 0.0f ? static_cast<float>(std::numeric_limits<uint8_t>::max()) / maxValue : 0.0f;
+                transform<uint8_t>(view, reinterpret_cast<uint8_t*>(data), numThreads, [convert, scale](uint8_t val)
+                {
+                    return static_cast<uint8_t>(glm::min(convert(val) * scale + 0.5f, 255.0f));
+                });
+            } else if (view.type == GL_UNSIGNED_SHORT) {
+                UShortConverter convert(view.scaleValue);
+                auto scale = maxValue > 0.0f ? static_cast<float>(std::numeric_limits<uint16_t>::max()) / maxValue : 0.0f;
+                transform<uint16_t>(view, reinterpret_cast<uint16_t*>(data), numThreads, [convert, scale](uint16_t val)
+                {
+                    return static_cast<uint16_t>(glm::min(convert(val) * scale + 0.5f, 65535.0f));
+                });
+            } else {
+                LOG(ERROR) << "Volume data type " << view.type << " has no native normalized format.";
+                throw std::runtime_error("Volume data type has no native normalized format.");
+            }
+        }
+    }
+}
@@ -0,0 +1,32 @@
+/**
+ * @file   VolumeDataConversion.h
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Contains functions to convert raw volume data for uploading.
+ */
+
+#ifndef VOLUMEDATACONVERSION_H
+#define VOLUMEDATACONVERSION_H
+
+#include "main.h"
+#include "gfx/volumes/RawVolumeSource.h"
+
+namespace cgu {
+
+    namespace volumeConversion {
+
+        float FindMaximumValue(const VolumeDataView& view, unsigned int numThreads = 0);
+        float ConvertToNormalizedFloat(const VolumeDataView& view, float* data, unsigned int numThreads = 0);
+        void ConvertToNormalizedFloat(const VolumeDataView& view, float maxValue, float* data, unsigned int numThreads = 0);
+        void ConvertVoxelsToNormalizedFloat(const VolumeDataView& view, const uint8_t* firstVoxel, uint64_t numVoxels,
+            float maxValue, float* data);
+        float ConvertToNormalizedHalf(const VolumeDataView& view, uint16_t* data, unsigned int numThreads = 0);
+        void ConvertToNormalizedHalf(const VolumeDataView& view, float maxValue, uint16_t* data, unsigned int numThreads = 0);
+        bool HasNativeFormat(const VolumeDataView& view);
+        bool IsNativeNormalized(const VolumeDataView& view, float maxValue);
+        void ConvertToNormalizedNative(const VolumeDataView& view, float maxValue, void* data, unsigned int numThreads = 0);
+    }
+}
+
+#endif // VOLUMEDATACONVERSION_H
@@ -0,0 +1,498 @@
+/**
+ * @file   VolumeDownsampler.cpp
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Implementation of the CPU downsampler for volumes.
+ */
+
+#include "VolumeDownsampler.h"
+#include "core/parallel_helper.h"
+#include <boost/filesystem.hpp>
+#include <codecvt>
+#include <fstream>
+#include <limits>
+
+namespace cgu {
+
+    /** The number of lobes of the Lanczos filter. */
+    static const double lanczosLobes = 2.0;
+    /** The number of output slices whose filtered source slices are computed and kept at once. */
+    static const unsigned int slicesPerSlab = 32;
+
+    /** The weights of a separable filter along one axis. */
+    struct FilterTaps
+    {
+        /** Holds the first tap of each output voxel (and the end of the last one). */
+        std::vector<unsigned int> offsets;
+        /** Holds the source voxel of each tap. */
+        std::vector<unsigned int> indices;
+        /** Holds the weight of each tap (not used by the min and max filters). */
+        std::vector<float> weights;
+    };
+
+    /** The Lanczos kernel. */
+    static double lanczos(double x)
+    {
+        if (x == 0.0) return 1.0;
+        if (glm::abs(x) >= lanczosLobes) return 0.0;
+        auto px = glm::pi<double>() * x;
+        return lanczosLobes * std::sin(px) * std::sin(px / lanczosLobes) / (px * px);
+    }
+
+    /**
+     *  Computes the filter taps for resampling an axis.
+     *  Box, min and max filters cover the source voxels overlapping an output voxel, the box weights are the
+     *  overlaps. The Lanczos filter is centered on the output voxel and widened by the downsampling ratio, taps
+     *  outside the volume are clamped to the border.
+     */
+    static FilterTaps createTaps(unsigned int sourceSize, unsigned int targetSize, DownsampleFilter filter)
+    {
+        FilterTaps taps;
+        taps.offsets.push_back(0);
+        auto ratio = static_cast<double>(sourceSize) / static_cast<double>(targetSize);
+        std::vector<double> weights;
+        for (unsigned int i = 0; i < targetSize; ++i) {
+            weights.clear();
+            auto begin = taps.indices.size();
+            if (filter == DownsampleFilter::LANCZOS) {
+                auto scale = glm::max(ratio, 1.0);
+                auto center = (static_cast<double>(i) + 0.5) * ratio - 0.5;
+                auto radius = lanczosLobes * scale;
+                auto weightSum = 0.0;
+                for (auto j = static_cast<int>(glm::ceil(center - radius)); j <= static_cast<int>(glm::floor(center + radius)); ++j) {
+                    auto weight = lanczos((static_cast<double>(j) - center) / scale);
+                    if (weight == 0.0) continue;
+                    auto idx = static_cast<unsigned int>(glm::clamp(j, 0, static_cast<int>(sourceSize) - 1));
+                    if (taps.indices.size() > begin && taps.indices.back() == idx) weights.back() += weight;
+                    else {
+                        taps.indices.push_back(idx);
+                        weights.push_back(weight);
+                    }
+                    weightSum += weight;
+                }
+                for (auto& weight : weights) weight /= weightSum;
+            } else {
+                auto low = static_cast<double>(i) * ratio;
+                auto high = static_cast<double>(i + 1) * ratio;
+                for (auto j = static_cast<unsigned int>(glm::floor(low)); j < sourceSize && static_cast<double>(j) < high; ++j) {
+                    auto overlap = glm::min(high, static_cast<double>(j + 1)) - glm::max(low, static_cast<double>(j));
+                    if (overlap <= 0.0) continue;
+                    taps.indices.push_back(j);
+                    weights.push_back(overlap / ratio);
+                }
+            }
+            for (auto weight : weights) taps.weights.push_back(static_cast<float>(weight));
+            taps.offsets.push_back(static_cast<unsigned int>(taps.indices.size()));
+        }
+        return taps;
+    }
+
+    /** Stores a filtered value as an integer element (rounded and clamped to the types range). */
+    template<typename I> struct ElementStore
+    {
+        static I Store(float value)
+        {
+            return static_cast<I>(glm::clamp(static_cast<double>(glm::round(value)), 0.0, static_cast<double>(std::numeric_limits<I>::max())));
+        }
+    };
+
+    /** Stores a filtered value as a float element. */
+    template<> struct ElementStore<float>
+    {
+        static float Store(float value) { return value; }
+    };
+
+    /** The element type of a volume. */
+    template<typename I> struct ElementType { using Type = I; };
+
+    /** Calls a function with the element type of a volume. */
+    template<typename Fn>
+    static void withElementType(const VolumeDataView& view, Fn fn)
+    {
+        switch (view.type) {
+        case GL_UNSIGNED_BYTE: fn(ElementType<uint8_t>()); break;
+        case GL_UNSIGNED_SHORT: fn(ElementType<uint16_t>()); break;
+        case GL_UNSIGNED_INT: fn(ElementType<uint32_t>()); break;
+        case GL_FLOAT: fn(ElementType<float>()); break;
+        default:
+            LOG(ERROR) << "Volume data type " << view.type << " cannot be downsampled.";
+            throw std::runtime_error("Volume data type cannot be downsampled.");
+        }
+    }
+
+    /** Combines taps by their weighted sum (box and Lanczos filters). */
+    struct WeightedCombine
+    {
+        static float First(float weight, float src) { return 0.0f + weight * src; }
+        static float Next(float weight, float src, float dst) { return dst + weight * src; }
+    };
+
+    /** Combines taps by their minimum. */
+    struct MinCombine
+    {
+        static float First(float, float src) { return src; }
+        static float Next(float, float src, float dst) { return glm::min(dst, src); }
+    };
+
+    /** Combines taps by their maximum. */
+    struct MaxCombine
+    {
+        static float First(float, float src) { return src; }
+        static float Next(float, float src, float dst) { return glm::max(dst, src); }
+    };
+
+    /** Calls a function with the combine operation of a filter, so all loops are compiled for a single filter. */
+    template<typename Fn>
+    static void withCombine(DownsampleFilter filter, Fn fn)
+    {
+        if (filter == DownsampleFilter::MIN) fn(MinCombine());
+        else if (filter == DownsampleFilter::MAX) fn(MaxCombine());
+        else fn(WeightedCombine());
+    }
+
+    /**
+     *  Combines a tap into an accumulated row.
+     *  @param firstTap whether this is the first tap (initializes the row).
+     *  @param weight the weight of the tap.
+     *  @param src the row of the tap.
+     *  @param dst the accumulated row.
+     *  @param count the number of elements in the row.
+     */
+    template<typename C>
+    static void combineRow(bool firstTap, float weight, const float* src, float* dst, std::size_t count)
+    {
+        if (firstTap) for (std::size_t i = 0; i < count; ++i) dst[i] = C::First(weight, src[i]);
+        else for (std::size_t i = 0; i < count; ++i) dst[i] = C::Next(weight, src[i], dst[i]);
+    }
+
+    /**
+     *  Filters a row in x.
+     *  @param taps the filter taps in x.
+     *  @param numComponents the number of components of each voxel.
+     *  @param src the source row.
+     *  @param dst the filtered row.
+     *  @param targetSizeX the number of voxels of the filtered row.
+     */
+    template<typename C>
+    static void filterRowX(const FilterTaps& taps, unsigned int numComponents, const float* src, float* dst, unsigned int targetSizeX)
+    {
+        for (unsigned int x = 0; x < targetSizeX; ++x, dst += numComponents) {
+            auto k = taps.offsets[x];
+            auto tap = src + taps.indices[k] * numComponents;
+            for (unsigned int c = 0; c < numComponents; ++c) dst[c] = C::First(taps.weights[k], tap[c]);
+            for (++k; k < taps.offsets[x + 1]; ++k) {
+                tap = src + taps.indices[k] * numComponents;
+                for (unsigned int c = 0; c < numComponents; ++c) dst[c] = C::Next(taps.weights[k], tap[c], dst[c]);
+            }
+        }
+    }
+
+    /** Combines a single value into an accumulated value. */
+    template<typename C>
+    static float combineValue(bool firstTap, float weight, float src, float dst)
+    {
+        return firstTap ? C::First(weight, src) : C::Next(weight, src, dst);
+    }
+
+    /** Reads a row of a volume as floats. */
+    template<typename I>
+    static void readRow(const VolumeDataView& view, unsigned int y, unsigned int z, float* row)
+    {
+        auto elementsPerVoxel = view.numComponents;
+        auto first = view.GetVoxel(glm::uvec3(0, y, z));
+        if (view.IsContiguous()) {
+            auto src = reinterpret_cast<const I*>(first);
+            auto numElements = static_cast<std::size_t>(view.size.x) * elementsPerVoxel;
+            for (std::size_t i = 0; i < numElements; ++i) row[i] = static_cast<float>(src[i]);
+        } else {
+            for (unsigned int x = 0; x < view.size.x; ++x) {
+                auto src = reinterpret_cast<const I*>(first + x * view.voxelStride);
+                for (unsigned int c = 0; c < elementsPerVoxel; ++c) row[x * elementsPerVoxel + c] = static_cast<float>(src[c]);
+            }
+        }
+    }
+
+    /** Reads a single element of a volume as float. */
+    template<typename I>
+    static float readElement(const VolumeDataView& view, unsigned int x, unsigned int y, unsigned int z, unsigned int c)
+    {
+        return static_cast<float>(reinterpret_cast<const I*>(view.GetVoxel(glm::uvec3(x, y, z)))[c]);
+    }
+
+    /**
+     *  Returns a view on the data of a level.
+     *  @param sourceLayout the layout of the volume the level was created from.
+     *  @return the view.
+     */
+    VolumeDataView VolumeLODLevel::GetView(const VolumeDataView& sourceLayout) const
+    {
+        auto view = sourceLayout;
+        view.data = data.data();
+        view.size = size;
+        view.voxelStride = view.bytesPerVoxel;
+        return view;
+    }
+
+    /**
+     *  Constructor.
+     *  @param filter the filter to downsample with.
+     *  @param numThreads the number of threads to use (0 to use all hardware threads).
+     */
+    VolumeDownsampler::VolumeDownsampler(DownsampleFilter filter, unsigned int numThreads) :
+        filter(filter),
+        numThreads(numThreads)
+    {
+    }
+
+    /**
+     *  Downsamples a volume.
+     *  @param source the source volume.
+     *  @param targetSize the size of the result (has to be at most the size of the source in each dimension).
+     *  @param output the tightly packed voxels of the result with the type and components of the source (output).
+     */
+    void VolumeDownsampler::Downsample(const VolumeDataView& source, const glm::uvec3& targetSize, std::vector<uint8_t>& output) const
+    {
+        assert(glm::all(glm::lessThanEqual(targetSize, source.size)) && glm::all(glm::greaterThan(targetSize, glm::uvec3(0))));
+        output.resize(static_cast<std::size_t>(targetSize.x) * targetSize.y * targetSize.z * source.bytesPerVoxel);
+
+        auto tapsX = createTaps(source.size.x, targetSize.x, filter);
+        auto tapsY = createTaps(source.size.y, targetSize.y, filter);
+        auto tapsZ = createTaps(source.size.z, targetSize.z, filter);
+        withElementType(source, [&](auto elementType)
+        {
+            withCombine(filter, [&](auto combine)
+            {
+                using I = typename decltype(elementType)::Type;
+                using C = decltype(combine);
+                auto numComponents = source.numComponents;
+                auto rowLength = static_cast<std::size_t>(targetSize.x) * numComponents;
+                auto sliceLength = rowLength * targetSize.y;
+                auto dst = reinterpret_cast<I*>(output.data());
+                std::vector<float> filteredSlices;
+
+                for (unsigned int z0 = 0; z0 < targetSize.z; z0 += slicesPerSlab) {
+                    auto z1 = glm::min(z0 + slicesPerSlab, targetSize.z);
+                    auto sourceZ0 = source.size.z;
+                    auto sourceZ1 = 0U;
+                    for (auto k = tapsZ.offsets[z0]; k < tapsZ.offsets[z1]; ++k) {
+                        sourceZ0 = glm::min(sourceZ0, tapsZ.indices[k]);
+                        sourceZ1 = glm::max(sourceZ1, tapsZ.indices[k] + 1);
+                    }
+
+                    // filter each source slice of the slab in x and y once, the slab is shared by all output slices.
+                    filteredSlices.resize((sourceZ1 - sourceZ0) * sliceLength);
+                    parallel::ForChunks(sourceZ1 - sourceZ0, 1, [&](uint64_t begin, uint64_t end, unsigned int)
+                    {
+                        thread_local std::vector<float> sourceRow;
+                        thread_local std::vector<float> filteredRows;
+                        sourceRow.resize(static_cast<std::size_t>(source.size.x) * numComponents);
+                        filteredRows.resize(rowLength * source.size.y);
+                        for (auto sz = sourceZ0 + static_cast<unsigned int>(begin); sz < sourceZ0 + end; ++sz) {
+                            for (unsigned int sy = 0; sy < source.size.y; ++sy) {
+                                readRow<I>(source, sy, sz, sourceRow.data());
+                                filterRowX<C>(tapsX, numComponents, sourceRow.data(), filteredRows.data() + sy * rowLength, targetSize.x);
+                            }
+
+                            auto filteredSlice = filteredSlices.data() + (sz - sourceZ0) * sliceLength;
+                            for (unsigned int y = 0; y < targetSize.y; ++y) {
+                                for (auto k = tapsY.offsets[y]; k < tapsY.offsets[y + 1]; ++k) {
+                                    combineRow<C>(k == tapsY.offsets[y], tapsY.weights[k], filteredRows.data() + tapsY.indices[k] * rowLength,
+                                        filteredSlice + y * rowLength, rowLength);
+                                }
+                            }
+                        }
+                    }, numThreads);
+
+                    // filter in z and store.
+                    parallel::ForChunks(z1 - z0, 1, [&](uint64_t begin, uint64_t end, unsigned int)
+                    {
+                        thread_local std::vector<float> outputSlice;
+                        outputSlice.resize(sliceLength);
+                        for (auto z = z0 + static_cast<unsigned int>(begin); z < z0 + end; ++z) {
+                            for (auto k = tapsZ.offsets[z]; k < tapsZ.offsets[z + 1]; ++k) {
+                                combineRow<C>(k == tapsZ.offsets[z], tapsZ.weights[k], filteredSlices.data() + (tapsZ.indices[k] - sourceZ0) * sliceLength,
+                                    outputSlice.data(), sliceLength);
+                            }
+                            auto dstSlice = dst + z * sliceLength;
+                            for (std::size_t i = 0; i < sliceLength; ++i) dstSlice[i] = ElementStore<I>::Store(outputSlice[i]);
+                        }
+                    }, numThreads);
+                }
+            });
+        });
+    }
+
+    /**
+     *  Downsamples a volume voxel by voxel on a single thread.
+     *  The filter taps are evaluated in the same order as by Downsample so the result is identical.
+     *  @param source the source volume.
+     *  @param targetSize the size of the result.
+     *  @param output the tightly packed voxels of the result (output).
+     */
+    void VolumeDownsampler::DownsampleReference(const VolumeDataView& source, const glm::uvec3& targetSize, std::vector<uint8_t>& output) const
+    {
+        assert(glm::all(glm::lessThanEqual(targetSize, source.size)) && glm::all(glm::greaterThan(targetSize, glm::uvec3(0))));
+        output.resize(static_cast<std::size_t>(targetSize.x) * targetSize.y * targetSize.z * source.bytesPerVoxel);
+
+        auto tapsX = createTaps(source.size.x, targetSize.x, filter);
+        auto tapsY = createTaps(source.size.y, targetSize.y, filter);
+        auto tapsZ = createTaps(source.size.z, targetSize.z, filter);
+        withElementType(source, [&](auto elementType)
+        {
+            withCombine(filter, [&](auto combine)
+            {
+                using I = typename decltype(elementType)::Type;
+                using C = decltype(combine);
+                auto dst = reinterpret_cast<I*>(output.data());
+
+                for (unsigned int z = 0; z < targetSize.z; ++z) {
+                    for (unsigned int y = 0; y < targetSize.y; ++y) {
+                        for (unsigned int x = 0; x < targetSize.x; ++x) {
+                            for (unsigned int c = 0; c < source.numComponents; ++c) {
+                                auto valueZ = 0.0f;
+                                for (auto kz = tapsZ.offsets[z]; kz < tapsZ.offsets[z + 1]; ++kz) {
+                                    auto valueY = 0.0f;
+                                    for (auto ky = tapsY.offsets[y]; ky < tapsY.offsets[y + 1]; ++ky) {
+                                        auto valueX = 0.0f;
+                                        for (auto kx = tapsX.offsets[x]; kx < tapsX.offsets[x + 1]; ++kx) {
+                                            valueX = combineValue<C>(kx == tapsX.offsets[x], tapsX.weights[kx],
+                                                readElement<I>(source, tapsX.indices[kx], tapsY.indices[ky], tapsZ.indices[kz], c), valueX);
+                                        }
+                                        valueY = combineValue<C>(ky == tapsY.offsets[y], tapsY.weights[ky], valueX, valueY);
+                                    }
+                                    valueZ = combineValue<C>(kz == tapsZ.offsets[z], tapsZ.weights[kz], valueY, valueZ);
+                                }
+                                dst[(static_cast<std::size_t>(z) * targetSize.y + y) * targetSize.x * source.numComponents
+                                    + x * source.numComponents + c] = ElementStore<I>::Store(valueZ);
+                            }
+                        }
+                    }
+                }
+            });
+        });
+    }
+
+    /**
+     *  Creates the level of detail chain of a volume, each level is downsampled from the previous one.
+     *  @param source the source volume (level 0).
+     *  @param numLevels the number of levels to create below the source (0 for all levels down to a single voxel).
+     *  @return the levels, starting with level 1.
+     */
+    std::vector<VolumeLODLevel> VolumeDownsampler::CreateLODChain(const VolumeDataView& source, unsigned int numLevels) const
+    {
+        if (numLevels == 0) numLevels = GetNumLODLevels(source.size);
+        std::vector<VolumeLODLevel> levels(numLevels);
+        auto previous = source;
+        for (auto& level : levels) {
+            level.size = GetNextLevelSize(previous.size);
+            Downsample(previous, level.size, level.data);
+            previous = level.GetView(source);
+        }
+        return levels;
+    }
+
+    /**
+     *  Writes the level of detail chain of a volume to dat and raw files.
+     *  Level i is written to baseFilename_i.dat/.raw, only two levels are kept in memory at once.
+     *  @param source the source volume (level 0).
+     *  @param cellSize the size of a voxel of the source volume.
+     *  @param baseFilename the file name of the levels without level number and extension.
+     *  @param numLevels the number of levels to create below the source (0 for all levels down to a single voxel).
+     *  @return the dat file names of the levels, starting with level 1.
+     */
+    std::vector<std::string> VolumeDownsampler::WriteLODChain(const VolumeDataView& source, const glm::vec3& cellSize,
+        const std::string& baseFilename, unsigned int numLevels) const
+    {
+        static const char* objectModels[] = { "I", "RG", "RGB", "RGBA" };
+        std::string format;
+        switch (source.type) {
+        case GL_UNSIGNED_BYTE: format = "UCHAR"; break;
+        case GL_UNSIGNED_SHORT: format = source.scaleValue == 16 ? "USHORT_12" : "USHORT"; break;
+        case GL_UNSIGNED_INT: format = "UINT"; break;
+        case GL_FLOAT: format = "FLOAT"; break;
+        default:
+            LOG(ERROR) << "Volume data type " << source.type << " cannot be downsampled.";
+            throw std::runtime_error("Volume data type cannot be downsampled.");
+        }
+        assert(source.numComponents >= 1 && source.numComponents <= 4);
+
+        if (numLevels == 0) numLevels = GetNumLODLevels(source.size);
+        std::vector<std::string> datFilenames;
+        VolumeLODLevel previousLevel, level;
+        auto previous = source;
+        for (unsigned int lvl = 1; lvl <= numLevels; ++lvl) {
+            level.size = GetNextLevelSize(previous.size);
+            Downsample(previous, level.size, level.data);
+
+            auto rawFilename = baseFilename + "_" + std::to_string(lvl) + ".raw";
+            std::ofstream rawOut(rawFilename, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+            if (!rawOut.is_open()) {
+                std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+                LOG(ERROR) << "Could not open file '" << converter.from_bytes(rawFilename) << "'.";
+                throw std::runtime_error("Could not open file '" + rawFilename + "'.");
+            }
+            rawOut.write(reinterpret_cast<const char*>(level.data.data()), level.data.size());
+            rawOut.close();
+
+            auto datFilename = baseFilename + "_" + std::to_string(lvl) + ".dat";
+            std::ofstream datOut(datFilename, std::ofstream::out | std::ofstream::trunc);
+            if (!datOut.is_open()) {
+                std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+                LOG(ERROR) << "Could not open file '" << converter.from_bytes(datFilename) << "'.";
+                throw std::runtime_error("Could not open file '" + datFilename + "'.");
+            }
+
+            auto levelCellSize = cellSize * glm::vec3(source.size) / glm::vec3(level.size);
+            datOut << "ObjectFileName:\t" << boost::filesystem::path(rawFilename).filename().string() << std::endl;
+            datOut << "Resolution:\t" << level.size.x << " " << level.size.y << " " << level.size.z << std::endl;
+            datOut << "SliceThickness:\t" << levelCellSize.x << " " << levelCellSize.y << " " << levelCellSize.z << std::endl;
+            datOut << "Format:\t" << format << std::endl;
+            datOut << "ObjectModel:\t" << objectModels[source.numComponents - 1] << std::endl;
+            datOut.close();
+            datFilenames.push_back(datFilename);
+
+            std::swap(previousLevel, level);
+            previous = previousLevel.GetView(source);
+        }
+        return datFilenames;
+    }
+
+    /**
+     *  Returns the size of the next coarser level (halved and rounded down like OpenGL mip maps).
+     *  @param size the size of the current level.
+     *  @return the size of the next level.
+     */
+    glm::uvec3 VolumeDownsampler::GetNextLevelSize(const glm::uvec3& size)
+    {
+        return glm::max(glm::uvec3(1), size / glm::uvec3(2));
+    }
+
+    /**
+     *  Returns the number of levels below a volume until it has a single voxel.
+     *  @param size the size of the volume.
+     *  @return the number of levels.
+     */
+    unsigned int VolumeDownsampler::GetNumLODLevels(const glm::uvec3& size)
+    {
+        unsigned int numLevels = 0;
+        for (auto levelSize = size; glm::any(glm::greaterThan(levelSize, glm::uvec3(1))); levelSize = GetNextLevelSize(levelSize)) ++numLevels;
+        return numLevels;
+    }
+
+    /**
+     *  Returns the name of a filter (used in file names).
+     *  @param filter the filter.
+     *  @return the name.
+     */
+    std::string VolumeDownsampler::GetFilterName(DownsampleFilter filter)
+    {
+        switch (filter) {
+        case DownsampleFilter::BOX: return "box";
+        case DownsampleFilter::MIN: return "min";
+        case DownsampleFilter::MAX: return "max";
+        case DownsampleFilter::LANCZOS: return "lanczos";
+        }
+        return "";
+    }
+}
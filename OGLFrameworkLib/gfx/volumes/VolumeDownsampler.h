@@ -0,0 +1,80 @@
+/**
+ * @file   VolumeDownsampler.h
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Contains the CPU downsampler for volumes and their level of detail chains.
+ */
+
+#ifndef VOLUMEDOWNSAMPLER_H
+#define VOLUMEDOWNSAMPLER_H
+
+#include "main.h"
+#include "gfx/volumes/RawVolumeSource.h"
+
+namespace cgu {
+
+    /** The filters used for downsampling. */
+    enum class DownsampleFilter
+    {
+        /** Average of the covered source voxels weighted by their overlap. */
+        BOX,
+        /** Minimum of the covered source voxels. */
+        MIN,
+        /** Maximum of the covered source voxels. */
+        MAX,
+        /** Lanczos filter with two lobes scaled to the downsampling ratio. */
+        LANCZOS
+    };
+
+    /** A level of a downsampled volume, the voxels have the type and components of the source volume. */
+    struct VolumeLODLevel
+    {
+        /** Holds the size of the level. */
+        glm::uvec3 size;
+        /** Holds the tightly packed voxels. */
+        std::vector<uint8_t> data;
+
+        VolumeDataView GetView(const VolumeDataView& sourceLayout) const;
+    };
+
+    /**
+     *  @brief Downsamples volumes on the CPU.
+     *  Volumes of any type and number of components are resampled to arbitrary smaller sizes (sizes do not need to
+     *  be powers of two or multiples of the target size). The filters are separable and applied with precomputed
+     *  weight tables per axis: rows are filtered in x first, then the rows of a slice in y, then slices in z. All
+     *  loops are compiled per filter, the y and z passes are plain loops over contiguous rows the compiler
+     *  vectorizes. The output is computed in slabs of slices: the source slices a slab needs are filtered in x and y
+     *  once in parallel and shared by all its output slices, which are then filtered in z in parallel. Values are computed in float from the raw values and rounded and clamped to the source
+     *  type when stored. DownsampleReference computes the same result voxel by voxel for verification.
+     *
+     * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+     * @date   2026.10.16
+     */
+    class VolumeDownsampler
+    {
+    public:
+        explicit VolumeDownsampler(DownsampleFilter filter, unsigned int numThreads = 0);
+
+        void Downsample(const VolumeDataView& source, const glm::uvec3& targetSize, std::vector<uint8_t>& output) const;
+        void DownsampleReference(const VolumeDataView& source, const glm::uvec3& targetSize, std::vector<uint8_t>& output) const;
+        std::vector<VolumeLODLevel> CreateLODChain(const VolumeDataView& source, unsigned int numLevels = 0) const;
+        std::vector<std::string> WriteLODChain(const VolumeDataView& source, const glm::vec3& cellSize, const std::string& baseFilename,
+            unsigned int numLevels = 0) const;
+
+        static glm::uvec3 GetNextLevelSize(const glm::uvec3& size);
+        static unsigned int GetNumLODLevels(const glm::uvec3& size);
+        static std::string GetFilterName(DownsampleFilter filter);
+
+        /** Returns the filter used. */
+        DownsampleFilter GetFilter() const { return filter; }
+
+    private:
+        /** Holds the filter. */
+        DownsampleFilter filter;
+        /** Holds the number of threads to use. */
+        unsigned int numThreads;
+    };
+}
+
+#endif // VOLUMEDOWNSAMPLER_H
@@ -0,0 +1,389 @@
+/**
+ * @file   VolumeSampler.cpp
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Implementation of the cache friendly CPU sampler for volumes.
+ */
+
+#include "VolumeSampler.h"
+#include "VolumeDataConversion.h"
+#include "core/parallel_helper.h"
+#include <emmintrin.h>
+
+namespace cgu {
+
+    /** The edge length of a tile in the tiled layout. */
+    static const unsigned int tileSize = 8;
+    /** The number of positions processed together by the batched sampling functions. */
+    static const std::size_t sampleBatchSize = 16;
+
+    /** Returns the number of bits needed to address a coordinate in [0, size). */
+    static unsigned int calcNumBits(unsigned int size)
+    {
+        unsigned int numBits = 0;
+        while ((1ULL << numBits) < size) ++numBits;
+        return numBits;
+    }
+
+    /** Returns the position of the voxel nearest to a texture coordinate (clamped to the volume). */
+    static glm::ivec3 nearestVoxel(const glm::vec3& position, const glm::uvec3& size)
+    {
+        return glm::clamp(glm::ivec3(glm::floor(position * glm::vec3(size))), glm::ivec3(0), glm::ivec3(size) - glm::ivec3(1));
+    }
+
+    /** Interpolates linearly, the SSE2 path uses the same operations so both are bit identical. */
+    static float lerp(float a, float b, float t)
+    {
+        return a + t * (b - a);
+    }
+
+    /** Interpolates four values linearly. */
+    static __m128 lerp(__m128 a, __m128 b, __m128 t)
+    {
+        return _mm_add_ps(a, _mm_mul_ps(t, _mm_sub_ps(b, a)));
+    }
+
+    /** Rounds four values down to integers (SSE2 has no floor), the same as floor for values in the int range. */
+    static __m128i floorToInt(__m128 x)
+    {
+        auto truncated = _mm_cvttps_epi32(x);
+        // the comparison is all ones (-1) where truncation rounded up.
+        return _mm_add_epi32(truncated, _mm_castps_si128(_mm_cmpgt_ps(_mm_cvtepi32_ps(truncated), x)));
+    }
+
+    /** Clamps four integers to [0, maxValue] (SSE2 has no integer min and max). */
+    static __m128i clampToVolume(__m128i x, __m128i maxValue)
+    {
+        x = _mm_and_si128(x, _mm_cmpgt_epi32(x, _mm_setzero_si128()));
+        auto greater = _mm_cmpgt_epi32(x, maxValue);
+        return _mm_or_si128(_mm_and_si128(greater, maxValue), _mm_andnot_si128(greater, x));
+    }
+
+    /** Loads one coordinate of four positions starting at first, positions past count repeat the last one. */
+    static __m128 loadCoordinate(const glm::vec3* positions, std::size_t first, std::size_t count, int axis)
+    {
+        auto last = count - 1;
+        return _mm_set_ps(positions[glm::min(first + 3, last)][axis], positions[glm::min(first + 2, last)][axis],
+            positions[glm::min(first + 1, last)][axis], positions[first][axis]);
+    }
+
+    /**
+     *  Constructor.
+     *  @param data the normalized values of the volume (x-major).
+     *  @param size the size of the volume.
+     *  @param layout the layout to store the values in.
+     *  @param numThreads the number of threads to use for reordering (0 to use all hardware threads).
+     */
+    VolumeSampler::VolumeSampler(const float* data, const glm::uvec3& size, VolumeLayout layout, unsigned int numThreads) :
+        size(size),
+        layout(layout)
+    {
+        CreateLayout(data, numThreads);
+    }
+
+    /**
+     *  Constructor, normalizes raw volume data the same way Volume::Load3DTexture does for float textures.
+     *  @param view the raw volume data (single channel).
+     *  @param layout the layout to store the values in.
+     *  @param numThreads the number of threads to use (0 to use all hardware threads).
+     */
+    VolumeSampler::VolumeSampler(const VolumeDataView& view, VolumeLayout layout, unsigned int numThreads) :
+        size(view.size),
+        layout(layout)
+    {
+        if (view.numComponents != 1) {
+            LOG(ERROR) << "Only single channel volumes can be sampled (volume has " << view.numComponents << " components).";
+            throw std::runtime_error("Only single channel volumes can be sampled.");
+        }
+
+        std::vector<float> linearData(static_cast<std::size_t>(view.GetNumVoxels()));
+        volumeConversion::ConvertToNormalizedFloat(view, linearData.data(), numThreads);
+        CreateLayout(linearData.data(), numThreads);
+    }
+
+    /** Default copy constructor. */
+    VolumeSampler::VolumeSampler(const VolumeSampler&) = default;
+    /** Default copy assignment operator. */
+    VolumeSampler& VolumeSampler::operator=(const VolumeSampler&) = default;
+
+    /** Default move constructor. */
+    VolumeSampler::VolumeSampler(VolumeSampler&& rhs) :
+        size(rhs.size),
+        layout(rhs.layout),
+        axisOffsets(std::move(rhs.axisOffsets)),
+        values(std::move(rhs.values))
+    {
+    }
+
+    /** Default move assignment operator. */
+    VolumeSampler& VolumeSampler::operator=(VolumeSampler&& rhs)
+    {
+        if (this != &rhs) {
+            size = rhs.size;
+            layout = rhs.layout;
+            axisOffsets = std::move(rhs.axisOffsets);
+            values = std::move(rhs.values);
+        }
+        return *this;
+    }
+
+    /** Destructor. */
+    VolumeSampler::~VolumeSampler() = default;
+
+    /**
+     *  Creates the address tables of the layout and reorders the values.
+     *  @param data the values (x-major).
+     *  @param numThreads the number of threads to use.
+     */
+    void VolumeSampler::CreateLayout(const float* data, unsigned int numThreads)
+    {
+        for (int axis = 0; axis < 3; ++axis) axisOffsets[axis].resize(size[axis]);
+        uint64_t numValues = 0;
+
+        if (layout == VolumeLayout::LINEAR) {
+            glm::u64vec3 axisStride(1, size.x, static_cast<uint64_t>(size.x) * size.y);
+            for (int axis = 0; axis < 3; ++axis) {
+                for (unsigned int i = 0; i < size[axis]; ++i) axisOffsets[axis][i] = i * axisStride[axis];
+            }
+            numValues = axisStride.z * size.z;
+        } else if (layout == VolumeLayout::TILED) {
+            auto numTiles = (size + glm::uvec3(tileSize - 1)) / glm::uvec3(tileSize);
+            const uint64_t tileVoxels = tileSize * tileSize * tileSize;
+            glm::u64vec3 tileStride(tileVoxels, tileVoxels * numTiles.x, tileVoxels * numTiles.x * numTiles.y);
+            glm::u64vec3 voxelStride(1, tileSize, tileSize * tileSize);
+            for (int axis = 0; axis < 3; ++axis) {
+                for (unsigned int i = 0; i < size[axis]; ++i) {
+                    axisOffsets[axis][i] = (i / tileSize) * tileStride[axis] + (i % tileSize) * voxelStride[axis];
+                }
+            }
+            numValues = tileStride.z * numTiles.z;
+        } else {
+            // interleave the bits of all axes, axes with fewer bits drop out so each axis is only padded to a power of two.
+            glm::uvec3 numBits(calcNumBits(size.x), calcNumBits(size.y), calcNumBits(size.z));
+            std::array<std::vector<unsigned int>, 3> bitPositions;
+            unsigned int outputBit = 0;
+            for (unsigned int bit = 0; bit < glm::max(glm::max(numBits.x, numBits.y), numBits.z); ++bit) {
+                for (int axis = 0; axis < 3; ++axis) if (bit < numBits[axis]) bitPositions[axis].push_back(outputBit++);
+            }
+            for (int axis = 0; axis < 3; ++axis) {
+                for (unsigned int i = 0; i < size[axis]; ++i) {
+                    uint64_t offset = 0;
+                    for (unsigned int bit = 0; bit < numBits[axis]; ++bit) offset |= static_cast<uint64_t>((i >> bit) & 1) << bitPositions[axis][bit];
+                    axisOffsets[axis][i] = offset;
+                }
+            }
+            numValues = 1ULL << outputBit;
+        }
+
+        values.assign(static_cast<std::size_t>(numValues), 0.0f);
+        parallel::ForChunks(static_cast<uint64_t>(size.y) * size.z, 16, [this, data](uint64_t begin, uint64_t end, unsigned int)
+        {
+            for (auto row = begin; row < end; ++row) {
+                auto rowOffset = axisOffsets[1][row % size.y] + axisOffsets[2][row / size.y];
+                auto src = data + row * size.x;
+                for (unsigned int x = 0; x < size.x; ++x) values[axisOffsets[0][x] + rowOffset] = src[x];
+            }
+        }, numThreads);
+    }
+
+    /**
+     *  Samples the nearest voxel.
+     *  @param position the texture coordinates.
+     *  @return the value.
+     */
+    float VolumeSampler::SampleNearest(const glm::vec3& position) const
+    {
+        return GetVoxel(glm::uvec3(nearestVoxel(position, size)));
+    }
+
+    /**
+     *  Samples the volume with trilinear filtering.
+     *  @param position the texture coordinates.
+     *  @return the value.
+     */
+    float VolumeSampler::SampleTrilinear(const glm::vec3& position) const
+    {
+        float result;
+        SampleTrilinear(&position, &result, 1);
+        return result;
+    }
+
+    /**
+     *  Samples the gradient with central differences of trilinear samples one voxel apart.
+     *  @param position the texture coordinates.
+     *  @return the gradient (change of the value per voxel).
+     */
+    glm::vec3 VolumeSampler::SampleGradient(const glm::vec3& position) const
+    {
+        glm::vec3 result;
+        SampleGradient(&position, &result, 1);
+        return result;
+    }
+
+    /**
+     *  Samples the nearest voxels of many positions.
+     *  @param positions the texture coordinates.
+     *  @param results the values (output).
+     *  @param count the number of positions.
+     */
+    void VolumeSampler::SampleNearest(const glm::vec3* positions, float* results, std::size_t count) const
+    {
+        alignas(16) std::array<int, 4> voxels;
+        std::array<uint64_t, sampleBatchSize> addresses;
+        for (std::size_t start = 0; start < count; start += sampleBatchSize) {
+            auto n = glm::min(sampleBatchSize, count - start);
+            addresses.fill(0);
+            for (std::size_t i = 0; i < n; i += 4) {
+                for (int axis = 0; axis < 3; ++axis) {
+                    auto coords = _mm_mul_ps(loadCoordinate(positions, start + i, count, axis), _mm_set1_ps(static_cast<float>(size[axis])));
+                    _mm_store_si128(reinterpret_cast<__m128i*>(voxels.data()), clampToVolume(floorToInt(coords), _mm_set1_epi32(static_cast<int>(size[axis]) - 1)));
+                    for (std::size_t k = 0; k < 4; ++k) addresses[i + k] += axisOffsets[axis][voxels[k]];
+                }
+            }
+            for (std::size_t i = 0; i < n; ++i) results[start + i] = values[addresses[i]];
+        }
+    }
+
+    /**
+     *  Samples many positions with trilinear filtering.
+     *  @param positions the texture coordinates.
+     *  @param results the values (output).
+     *  @param count the number of positions.
+     */
+    void VolumeSampler::SampleTrilinear(const glm::vec3* positions, float* results, std::size_t count) const
+    {
+        alignas(16) std::array<std::array<float, sampleBatchSize>, 3> fractions;
+        alignas(16) std::array<std::array<float, sampleBatchSize>, 8> corners;
+        alignas(16) std::array<int, 4> voxels0, voxels1;
+        alignas(16) std::array<float, 4> blended;
+        std::array<std::array<uint64_t, sampleBatchSize>, 6> offsets;
+
+        for (std::size_t start = 0; start < count; start += sampleBatchSize) {
+            auto n = glm::min(sampleBatchSize, count - start);
+            auto numLanes = (n + 3) & ~std::size_t(3);
+
+            // weights and corner offsets of four positions at once, positions past the end repeat the last one.
+            for (std::size_t i = 0; i < numLanes; i += 4) {
+                for (int axis = 0; axis < 3; ++axis) {
+                    auto coords = _mm_sub_ps(_mm_mul_ps(loadCoordinate(positions, start + i, count, axis), _mm_set1_ps(static_cast<float>(size[axis]))),
+                        _mm_set1_ps(0.5f));
+                    auto base = floorToInt(coords);
+                    _mm_store_ps(&fractions[axis][i], _mm_sub_ps(coords, _mm_cvtepi32_ps(base)));
+                    auto maxPos = _mm_set1_epi32(static_cast<int>(size[axis]) - 1);
+                    _mm_store_si128(reinterpret_cast<__m128i*>(voxels0.data()), clampToVolume(base, maxPos));
+                    _mm_store_si128(reinterpret_cast<__m128i*>(voxels1.data()), clampToVolume(_mm_add_epi32(base, _mm_set1_epi32(1)), maxPos));
+                    for (std::size_t k = 0; k < 4; ++k) {
+                        offsets[2 * axis][i + k] = axisOffsets[axis][voxels0[k]];
+                        offsets[2 * axis + 1][i + k] = axisOffsets[axis][voxels1[k]];
+                    }
+                }
+            }
+
+            // SSE2 has no gather, the corners are loaded one by one.
+            for (std::size_t i = 0; i < numLanes; ++i) {
+                for (int c = 0; c < 8; ++c) {
+                    corners[c][i] = values[offsets[c & 1][i] + offsets[2 + ((c >> 1) & 1)][i] + offsets[4 + ((c >> 2) & 1)][i]];
+                }
+            }
+
+            for (std::size_t i = 0; i < numLanes; i += 4) {
+                auto fx = _mm_load_ps(&fractions[0][i]), fy = _mm_load_ps(&fractions[1][i]), fz = _mm_load_ps(&fractions[2][i]);
+                auto v00 = lerp(_mm_load_ps(&corners[0][i]), _mm_load_ps(&corners[1][i]), fx);
+                auto v10 = lerp(_mm_load_ps(&corners[2][i]), _mm_load_ps(&corners[3][i]), fx);
+                auto v01 = lerp(_mm_load_ps(&corners[4][i]), _mm_load_ps(&corners[5][i]), fx);
+                auto v11 = lerp(_mm_load_ps(&corners[6][i]), _mm_load_ps(&corners[7][i]), fx);
+                _mm_store_ps(blended.data(), lerp(lerp(v00, v10, fy), lerp(v01, v11, fy), fz));
+                for (std::size_t k = 0; k < 4 && i + k < n; ++k) results[start + i + k] = blended[k];
+            }
+        }
+    }
+
+    /**
+     *  Samples the gradients at many positions.
+     *  @param positions the texture coordinates.
+     *  @param results the gradients (output).
+     *  @param count the number of positions.
+     */
+    void VolumeSampler::SampleGradient(const glm::vec3* positions, glm::vec3* results, std::size_t count) const
+    {
+        auto voxelStep = glm::vec3(1.0f) / glm::vec3(size);
+        std::array<glm::vec3, 6 * sampleBatchSize> samplePositions;
+        std::array<float, 6 * sampleBatchSize> samples;
+
+        for (std::size_t start = 0; start < count; start += sampleBatchSize) {
+            auto n = glm::min(sampleBatchSize, count - start);
+            for (std::size_t i = 0; i < n; ++i) {
+                for (int axis = 0; axis < 3; ++axis) {
+                    glm::vec3 offset(0.0f);
+                    offset[axis] = voxelStep[axis];
+                    samplePositions[6 * i + 2 * axis] = positions[start + i] + offset;
+                    samplePositions[6 * i + 2 * axis + 1] = positions[start + i] - offset;
+                }
+            }
+            SampleTrilinear(samplePositions.data(), samples.data(), 6 * n);
+            for (std::size_t i = 0; i < n; ++i) {
+                for (int axis = 0; axis < 3; ++axis) results[start + i][axis] = (samples[6 * i + 2 * axis] - samples[6 * i + 2 * axis + 1]) * 0.5f;
+            }
+        }
+    }
+
+    /**
+     *  Samples the nearest voxel of x-major data (reference implementation).
+     *  @param data the values.
+     *  @param size the size of the volume.
+     *  @param position the texture coordinates.
+     *  @return the value.
+     */
+    float VolumeSampler::SampleNearestReference(const float* data, const glm::uvec3& size, const glm::vec3& position)
+    {
+        auto p = nearestVoxel(position, size);
+        return data[(static_cast<std::size_t>(p.z) * size.y + p.y) * size.x + p.x];
+    }
+
+    /**
+     *  Samples x-major data with trilinear filtering (reference implementation).
+     *  @param data the values.
+     *  @param size the size of the volume.
+     *  @param position the texture coordinates.
+     *  @return the value.
+     */
+    float VolumeSampler::SampleTrilinearReference(const float* data, const glm::uvec3& size, const glm::vec3& position)
+    {
+        auto coords = position * glm::vec3(size) - glm::vec3(0.5f);
+        auto base = glm::floor(coords);
+        auto f = coords - base;
+        auto maxPos = glm::ivec3(size) - glm::ivec3(1);
+        auto p0 = glm::clamp(glm::ivec3(base), glm::ivec3(0), maxPos);
+        auto p1 = glm::clamp(glm::ivec3(base) + glm::ivec3(1), glm::ivec3(0), maxPos);
+
+        auto load = [data, &size](int x, int y, int z)
+        {
+            return data[(static_cast<std::size_t>(z) * size.y + y) * size.x + x];
+        };
+        auto v00 = lerp(load(p0.x, p0.y, p0.z), load(p1.x, p0.y, p0.z), f.x);
+        auto v10 = lerp(load(p0.x, p1.y, p0.z), load(p1.x, p1.y, p0.z), f.x);
+        auto v01 = lerp(load(p0.x, p0.y, p1.z), load(p1.x, p0.y, p1.z), f.x);
+        auto v11 = lerp(load(p0.x, p1.y, p1.z), load(p1.x, p1.y, p1.z), f.x);
+        return lerp(lerp(v00, v10, f.y), lerp(v01, v11, f.y), f.z);
+    }
+
+    /**
+     *  Samples the gradient of x-major data (reference implementation).
+     *  @param data the values.
+     *  @param size the size of the volume.
+     *  @param position the texture coordinates.
+     *  @return the gradient (change of the value per voxel).
+     */
+    glm::vec3 VolumeSampler::SampleGradientReference(const float* data, const glm::uvec3& size, const glm::vec3& position)
+    {
+        auto voxelStep = glm::vec3(1.0f) / glm::vec3(size);
+        glm::vec3 gradient;
+        for (int axis = 0; axis < 3; ++axis) {
+            glm::vec3 offset(0.0f);
+            offset[axis] = voxelStep[axis];
+            gradient[axis] = (SampleTrilinearReference(data, size, position + offset) - SampleTrilinearReference(data, size, position - offset)) * 0.5f;
+        }
+        return gradient;
+    }
+}
@@ -0,0 +1,92 @@
+/**
+ * @file   VolumeSampler.h
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Contains the cache friendly CPU sampler for volumes.
+ */
+
+#ifndef VOLUMESAMPLER_H
+#define VOLUMESAMPLER_H
+
+#include "main.h"
+#include "gfx/volumes/RawVolumeSource.h"
+
+namespace cgu {
+
+    /** The memory layouts of a VolumeSampler. */
+    enum class VolumeLayout
+    {
+        /** Voxels are stored x-major (like the raw files). */
+        LINEAR,
+        /** Voxels are stored in 8x8x8 tiles, tiles and the voxels inside them are stored x-major. */
+        TILED,
+        /**
+         *  Voxels are stored in Morton (z-curve) order, each dimension is padded to a power of two. This needs up to
+         *  8 times the memory of the volume (e.g. 129^3 voxels are stored as 256^3), see GetStorageSize. Use the
+         *  tiled layout for volumes far from power of two sizes.
+         */
+        MORTON
+    };
+
+    /**
+     *  @brief Single channel volume stored for fast sampling on the CPU.
+     *  The values are kept as normalized floats in a tiled or Morton layout so neighboring voxels in all directions
+     *  are close in memory. The address of a voxel is the sum of one table entry per axis, so all layouts share the
+     *  same sampling code. Positions are texture coordinates in [0, 1]; filtering follows OpenGL (voxel centers at
+     *  (i + 0.5) / size, clamp to edge). The batched functions process positions in blocks: weights and voxel
+     *  coordinates of four positions are computed and the corners blended with SSE2, the corners are loaded one by
+     *  one as SSE2 has no gather. Positions have to be inside the int range in voxels. The results are bit identical
+     *  to the reference functions for all layouts.
+     *
+     * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+     * @date   2026.10.16
+     */
+    class VolumeSampler
+    {
+    public:
+        VolumeSampler(const float* data, const glm::uvec3& size, VolumeLayout layout, unsigned int numThreads = 0);
+        VolumeSampler(const VolumeDataView& view, VolumeLayout layout, unsigned int numThreads = 0);
+        VolumeSampler(const VolumeSampler&);
+        VolumeSampler& operator=(const VolumeSampler&);
+        VolumeSampler(VolumeSampler&&);
+        VolumeSampler& operator=(VolumeSampler&&);
+        ~VolumeSampler();
+
+        float SampleNearest(const glm::vec3& position) const;
+        float SampleTrilinear(const glm::vec3& position) const;
+        glm::vec3 SampleGradient(const glm::vec3& position) const;
+        void SampleNearest(const glm::vec3* positions, float* results, std::size_t count) const;
+        void SampleTrilinear(const glm::vec3* positions, float* results, std::size_t count) const;
+        void SampleGradient(const glm::vec3* positions, glm::vec3* results, std::size_t count) const;
+
+        static float SampleNearestReference(const float* data, const glm::uvec3& size, const glm::vec3& position);
+        static float SampleTrilinearReference(const float* data, const glm::uvec3& size, const glm::vec3& position);
+        static glm::vec3 SampleGradientReference(const float* data, const glm::uvec3& size, const glm::vec3& position);
+
+        /** Returns the value of a voxel. */
+        float GetVoxel(const glm::uvec3& pos) const { return values[GetAddress(pos)]; }
+        /** Returns the address of a voxel in the layout. */
+        uint64_t GetAddress(const glm::uvec3& pos) const { return axisOffsets[0][pos.x] + axisOffsets[1][pos.y] + axisOffsets[2][pos.z]; }
+        /** Returns the size of the volume. */
+        const glm::uvec3& GetSize() const { return size; }
+        /** Returns the layout. */
+        VolumeLayout GetLayout() const { return layout; }
+        /** Returns the memory used by the values (including padding) in bytes. */
+        uint64_t GetStorageSize() const { return values.size() * sizeof(float); }
+
+    private:
+        void CreateLayout(const float* data, unsigned int numThreads);
+
+        /** Holds the size of the volume. */
+        glm::uvec3 size;
+        /** Holds the layout. */
+        VolumeLayout layout;
+        /** Holds the address offsets of each coordinate for the three axes. */
+        std::array<std::vector<uint64_t>, 3> axisOffsets;
+        /** Holds the values. */
+        std::vector<float> values;
+    };
+}
+
+#endif // VOLUMESAMPLER_H
@@ -0,0 +1,165 @@
+/**
+ * @file   VolumeSeries.cpp
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Implementation of the resource for time-varying volume series.
+ */
+
+#include "VolumeSeries.h"
+#include "Volume.h"
+#include "app/ApplicationBase.h"
+#include "core/parallel_helper.h"
+#include <boost/filesystem.hpp>
+#include <codecvt>
+#include <fstream>
+
+namespace cgu {
+
+    /**
+     *  Constructor, reads the series file and the dat files of all time steps.
+     *  @param seriesFilename the resource id of the series file.
+     *  @param app the application object.
+     */
+    VolumeSeries::VolumeSeries(const std::string& seriesFilename, ApplicationBase* app) :
+        Resource{ seriesFilename, app },
+        stepDuration(1.0f / 25.0f),
+        maxValue(-1.0f)
+    {
+        LoadSeriesFile();
+    }
+
+    /** Default move constructor. */
+    VolumeSeries::VolumeSeries(VolumeSeries&& rhs) :
+        Resource(std::move(rhs)),
+        timeSteps(std::move(rhs.timeSteps)),
+        stepDuration(rhs.stepDuration),
+        maxValue(rhs.maxValue)
+    {
+    }
+
+    /** Default move assignment operator. */
+    VolumeSeries& VolumeSeries::operator=(VolumeSeries&& rhs)
+    {
+        if (this != &rhs) {
+            Resource* tRes = this;
+            *tRes = static_cast<Resource&&>(std::move(rhs));
+            timeSteps = std::move(rhs.timeSteps);
+            stepDuration = rhs.stepDuration;
+            maxValue = rhs.maxValue;
+        }
+        return *this;
+    }
+
+    /** Destructor. */
+    VolumeSeries::~VolumeSeries() = default;
+
+    /**
+     *  Returns the maximum value of all time steps that the steps are normalized with (see Volume::LoadTextureData).
+     *  This is the maximum from the series file if it has one. Otherwise it is computed on first use from the maximum
+     *  of each step, which is cached next to the steps dat files. As each step without a cache has to be read
+     *  completely, the steps are processed in parallel.
+     *  @return the maximum value of the series.
+     */
+    float VolumeSeries::GetMaximumValue() const
+    {
+        std::lock_guard<std::mutex> lock(maxValueMutex);
+        if (maxValue < 0.0f) {
+            std::vector<float> stepMaxValues(timeSteps.size(), 0.0f);
+            parallel::ForChunks(timeSteps.size(), 1, [this, &stepMaxValues](uint64_t begin, uint64_t end, unsigned int)
+            {
+                for (auto i = begin; i < end; ++i) stepMaxValues[i] = timeSteps[i]->GetMaximumValue();
+            });
+            maxValue = *std::max_element(stepMaxValues.begin(), stepMaxValues.end());
+        }
+        return maxValue;
+    }
+
+    /**
+     *  Replaces the first run of '#' in a file pattern by a zero padded step number.
+     *  @param pattern the file pattern.
+     *  @param step the step number.
+     *  @return the file name.
+     */
+    std::string VolumeSeries::ExpandFilePattern(const std::string& pattern, unsigned int step)
+    {
+        auto first = pattern.find('#');
+        if (first == std::string::npos) return pattern;
+        auto last = pattern.find_first_not_of('#', first);
+        if (last == std::string::npos) last = pattern.size();
+
+        auto number = std::to_string(step);
+        if (number.size() < last - first) number.insert(0, last - first - number.size(), '0');
+        return pattern.substr(0, first) + number + pattern.substr(last);
+    }
+
+    /**
+     *  Loads the series file.
+     */
+    void VolumeSeries::LoadSeriesFile()
+    {
+        auto filename = FindResourceLocation(GetParameters()[0]);
+        boost::filesystem::path seriesFile{ filename };
+        boost::filesystem::path seriesRelativeFile{ GetParameters()[0] };
+
+        std::ifstream ifs(filename);
+        if (!ifs.is_open()) {
+            std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+            LOG(ERROR) << "Cannot open file '" << converter.from_bytes(filename) << "'.";
+            throw resource_loading_error() << ::boost::errinfo_file_name(seriesFile.filename().string()) << resid_info(getId())
+                << errdesc_info("Cannot open file.");
+        }
+
+        std::vector<std::string> stepFiles;
+        std::string str, filePattern;
+        unsigned int firstStep = 0, numSteps = 0, stepStride = 1;
+        while (ifs >> str && ifs.good()) {
+            if (str == "TimeStep:") {
+                stepFiles.emplace_back();
+                ifs >> stepFiles.back();
+            } else if (str == "FilePattern:")
+                ifs >> filePattern;
+            else if (str == "FirstStep:")
+                ifs >> firstStep;
+            else if (str == "NumSteps:")
+                ifs >> numSteps;
+            else if (str == "StepStride:")
+                ifs >> stepStride;
+            else if (str == "StepDuration:")
+                ifs >> stepDuration;
+            else if (str == "MaximumValue:")
+                ifs >> maxValue;
+        }
+        ifs.close();
+
+        if (!filePattern.empty()) {
+            for (unsigned int i = 0; i < numSteps; ++i) stepFiles.push_back(ExpandFilePattern(filePattern, firstStep + i * stepStride));
+        }
+
+        if (stepFiles.empty()) {
+            LOG(ERROR) << "Could not find any time steps in series file.";
+            throw resource_loading_error() << ::boost::errinfo_file_name(seriesFile.filename().string()) << resid_info(getId())
+                << errdesc_info("Cannot find any time steps in series file.");
+        }
+
+        std::string fileParameters;
+        for (unsigned int i = 1; i < GetParameters().size(); ++i) {
+            fileParameters += "," + GetParameter(i);
+        }
+
+        for (const auto& stepFile : stepFiles) {
+            auto stepRelativeFilename = seriesRelativeFile.parent_path().string() + "/" + stepFile;
+            timeSteps.push_back(application->GetVolumeManager()->GetResource(stepRelativeFilename + fileParameters));
+
+            const auto& firstDesc = timeSteps.front()->GetTextureDescriptor();
+            const auto& stepDesc = timeSteps.back()->GetTextureDescriptor();
+            if (timeSteps.back()->GetSize() != timeSteps.front()->GetSize() || stepDesc.internalFormat != firstDesc.internalFormat
+                || stepDesc.format != firstDesc.format || stepDesc.type != firstDesc.type) {
+                std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+                LOG(ERROR) << "Time step '" << converter.from_bytes(stepFile) << "' does not match the size or format of the first time step.";
+                throw resource_loading_error() << ::boost::errinfo_file_name(seriesFile.filename().string()) << resid_info(getId())
+                    << errdesc_info("Time steps differ in size or format.");
+            }
+        }
+    }
+}
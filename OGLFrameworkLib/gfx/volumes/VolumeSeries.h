@@ -0,0 +1,71 @@
+/**
+ * @file   VolumeSeries.h
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Contains the resource for time-varying volume series.
+ */
+
+#ifndef VOLUMESERIES_H
+#define VOLUMESERIES_H
+
+#include "main.h"
+#include "core/Resource.h"
+#include <mutex>
+
+namespace cgu {
+
+    class Volume;
+
+    /**
+     *  @brief Resource for a series of volumes (time steps of a simulation).
+     *  The series is described by a text file with the fields
+     *  - "TimeStep: <file>.dat" (once for each time step) or
+     *  - "FilePattern: <file>_####.dat", "FirstStep: <n>", "NumSteps: <n>" and optionally "StepStride: <n>" where the
+     *    run of '#' is replaced by the zero padded step number,
+     *  - optionally "StepDuration: <seconds>",
+     *  - optionally "MaximumValue: <value>", the maximum value of all time steps (e.g. written by the simulation).
+     *  The dat file names are relative to the series file. Only the dat files are read, all time steps need to have
+     *  the same size and format. Parameters of the series resource are passed on to the volumes.
+     *  All time steps are normalized with the maximum value of the whole series, so their values are comparable. If
+     *  the series file does not contain it, it is computed from all time steps on first use.
+     *
+     * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+     * @date   2026.10.16
+     */
+    class VolumeSeries : public Resource
+    {
+    public:
+        VolumeSeries(const std::string& seriesFilename, ApplicationBase* app);
+        VolumeSeries(const VolumeSeries&) = delete;
+        VolumeSeries& operator=(const VolumeSeries&) = delete;
+        VolumeSeries(VolumeSeries&&);
+        VolumeSeries& operator=(VolumeSeries&&);
+        virtual ~VolumeSeries();
+
+        /** Returns the number of time steps. */
+        unsigned int GetNumSteps() const { return static_cast<unsigned int>(timeSteps.size()); }
+        /** Returns the volume of a time step. */
+        const std::shared_ptr<const Volume>& GetTimeStep(unsigned int step) const { return timeSteps[step]; }
+        /** Returns the duration of a time step in seconds. */
+        float GetStepDuration() const { return stepDuration; }
+
+        float GetMaximumValue() const;
+
+        static std::string ExpandFilePattern(const std::string& pattern, unsigned int step);
+
+    private:
+        void LoadSeriesFile();
+
+        /** Holds the volumes of the time steps. */
+        std::vector<std::shared_ptr<const Volume>> timeSteps;
+        /** Holds the duration of a time step. */
+        float stepDuration;
+        /** Holds the maximum value of all time steps (negative until it is computed if the series file has none). */
+        mutable float maxValue;
+        /** Holds the mutex for computing the maximum value. */
+        mutable std::mutex maxValueMutex;
+    };
+}
+
+#endif // VOLUMESERIES_H
@@ -0,0 +1,307 @@
+/**
+ * @file   VolumeSeriesStreamer.cpp
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Implementation of the prefetching and double buffered playback of volume series.
+ */
+
+#include "VolumeSeriesStreamer.h"
+#include "VolumeSeries.h"
+
+namespace cgu {
+
+    /**
+     *  Constructor, streams the time steps of a volume series resource.
+     *  @param series the volume series.
+     *  @param prefetchCount the number of steps loaded ahead of the requested one.
+     *  @param numIOThreads the number of I/O threads.
+     */
+    VolumeSeriesStreamer::VolumeSeriesStreamer(std::shared_ptr<const VolumeSeries> series, unsigned int prefetchCount, unsigned int numIOThreads) :
+        VolumeSeriesStreamer(series->GetNumSteps(), [series](unsigned int step, const AsyncVolumeLoad::ProgressFunction& reportProgress)
+    {
+        return series->GetTimeStep(step)->LoadTextureData(series->GetMaximumValue(), reportProgress);
+    }, prefetchCount, numIOThreads)
+    {
+    }
+
+    /**
+     *  Constructor, streams time steps loaded by a custom function.
+     *  @param numSteps the number of time steps.
+     *  @param loadFunction the function loading a time step.
+     *  @param prefetchCount the number of steps loaded ahead of the requested one.
+     *  @param numIOThreads the number of I/O threads.
+     */
+    VolumeSeriesStreamer::VolumeSeriesStreamer(unsigned int numSteps, LoadFunction loadFunction, unsigned int prefetchCount, unsigned int numIOThreads) :
+        numSteps(numSteps),
+        loadFunction(std::move(loadFunction)),
+        slots(prefetchCount + 1),
+        looping(true),
+        maxRetries(2),
+        lastRequestedStep(numSteps),
+        stopThreads(false)
+    {
+        assert(numSteps > 0);
+        Start(glm::max(numIOThreads, 1U));
+    }
+
+    /** Destructor, cancels all loads and waits for the I/O threads. */
+    VolumeSeriesStreamer::~VolumeSeriesStreamer()
+    {
+        {
+            std::lock_guard<std::mutex> lock(streamerMutex);
+            stopThreads = true;
+        }
+        workCondition.notify_all();
+        for (auto& thread : ioThreads) thread.join();
+    }
+
+    /**
+     *  Starts the I/O threads.
+     *  @param numIOThreads the number of threads.
+     */
+    void VolumeSeriesStreamer::Start(unsigned int numIOThreads)
+    {
+        for (unsigned int i = 0; i < numIOThreads; ++i) ioThreads.emplace_back([this]() { IOThread(); });
+    }
+
+    /**
+     *  Requests a time step without blocking. The following steps are prefetched.
+     *  @param step the time step.
+     *  @return the data of the step or nullptr if it is not loaded yet (or failed to load).
+     */
+    std::shared_ptr<const VolumeTextureData> VolumeSeriesStreamer::RequestStep(unsigned int step)
+    {
+        assert(step < numSteps);
+        std::lock_guard<std::mutex> lock(streamerMutex);
+        Schedule(step);
+
+        auto slot = FindSlot(step);
+        auto isReady = slot->state == SlotState::READY;
+        if (step != lastRequestedStep) {
+            lastRequestedStep = step;
+            ++stats.stepRequests;
+            if (isReady) ++stats.prefetchHits;
+        }
+        if (!isReady) {
+            ++stats.stalls;
+            return nullptr;
+        }
+        return slot->data;
+    }
+
+    /**
+     *  Requests a time step and waits until it is loaded.
+     *  @param step the time step.
+     *  @return the data of the step.
+     */
+    std::shared_ptr<const VolumeTextureData> VolumeSeriesStreamer::WaitForStep(unsigned int step)
+    {
+        auto data = RequestStep(step);
+        if (data) return data;
+
+        std::unique_lock<std::mutex> lock(streamerMutex);
+        Slot* slot = nullptr;
+        loadedCondition.wait(lock, [this, step, &slot]()
+        {
+            slot = FindSlot(step);
+            if (!slot) Schedule(step);
+            return slot && (slot->state == SlotState::READY || slot->state == SlotState::FAILED);
+        });
+
+        if (slot->state == SlotState::FAILED) {
+            LOG(ERROR) << "Loading time step " << step << " failed: " << slot->errorMessage.c_str();
+            throw std::runtime_error("Loading time step " + std::to_string(step) + " failed: " + slot->errorMessage);
+        }
+        return slot->data;
+    }
+
+    /**
+     *  Returns whether a time step is loaded.
+     *  @param step the time step.
+     *  @return whether the step is loaded.
+     */
+    bool VolumeSeriesStreamer::IsStepReady(unsigned int step) const
+    {
+        std::lock_guard<std::mutex> lock(streamerMutex);
+        auto slot = FindSlot(step);
+        return slot && slot->state == SlotState::READY;
+    }
+
+    /**
+     *  Assigns the buffers to a step and the steps following it, buffers of other steps are reused.
+     *  A failed step is loaded again when it is requested anew. Has to be called with the mutex locked.
+     *  @param step the requested time step.
+     */
+    void VolumeSeriesStreamer::Schedule(unsigned int step)
+    {
+        std::vector<unsigned int> neededSteps;
+        for (unsigned int i = 0; i < slots.size() && i < numSteps; ++i) {
+            auto neededStep = step + i;
+            if (neededStep >= numSteps) {
+                if (!looping) break;
+                neededStep -= numSteps;
+            }
+            neededSteps.push_back(neededStep);
+        }
+
+        for (auto& slot : slots) {
+            if (slot.state == SlotState::EMPTY) continue;
+            if (std::find(neededSteps.begin(), neededSteps.end(), slot.step) != neededSteps.end()) continue;
+            if (slot.state == SlotState::QUEUED || slot.state == SlotState::LOADING) ++stats.loadsDiscarded;
+            ++slot.generation;
+            slot.state = SlotState::EMPTY;
+            slot.data.reset();
+            slot.errorMessage.clear();
+            slot.numFailures = 0;
+        }
+
+        loadQueue.clear();
+        for (auto neededStep : neededSteps) {
+            auto slot = FindSlot(neededStep);
+            if (!slot) {
+                slot = &*std::find_if(slots.begin(), slots.end(), [](const Slot& s) { return s.state == SlotState::EMPTY; });
+                slot->step = neededStep;
+                slot->state = SlotState::QUEUED;
+                ++slot->generation;
+            } else if (slot->state == SlotState::FAILED && neededStep == step && step != lastRequestedStep) {
+                slot->state = SlotState::QUEUED;
+                slot->numFailures = 0;
+                slot->errorMessage.clear();
+            }
+            if (slot->state == SlotState::QUEUED) loadQueue.push_back(static_cast<std::size_t>(slot - slots.data()));
+        }
+        if (!loadQueue.empty()) workCondition.notify_all();
+    }
+
+    /**
+     *  Finds the buffer assigned to a step. Has to be called with the mutex locked.
+     *  @param step the time step.
+     *  @return the buffer or nullptr if no buffer is assigned.
+     */
+    VolumeSeriesStreamer::Slot* VolumeSeriesStreamer::FindSlot(unsigned int step)
+    {
+        for (auto& slot : slots) if (slot.state != SlotState::EMPTY && slot.step == step) return &slot;
+        return nullptr;
+    }
+
+    /**
+     *  Finds the buffer assigned to a step. Has to be called with the mutex locked.
+     *  @param step the time step.
+     *  @return the buffer or nullptr if no buffer is assigned.
+     */
+    const VolumeSeriesStreamer::Slot* VolumeSeriesStreamer::FindSlot(unsigned int step) const
+    {
+        for (const auto& slot : slots) if (slot.state != SlotState::EMPTY && slot.step == step) return &slot;
+        return nullptr;
+    }
+
+    /**
+     *  The I/O thread, loads the queued buffers in order. A load is canceled when its buffer is reassigned, a failed
+     *  load is queued again until it failed more than maxRetries times.
+     */
+    void VolumeSeriesStreamer::IOThread()
+    {
+        std::unique_lock<std::mutex> lock(streamerMutex);
+        while (true) {
+            workCondition.wait(lock, [this]() { return stopThreads || !loadQueue.empty(); });
+            if (stopThreads) return;
+
+            auto slotIndex = loadQueue.front();
+            auto& slot = slots[slotIndex];
+            loadQueue.pop_front();
+            slot.state = SlotState::LOADING;
+            auto step = slot.step;
+            uint64_t generation = slot.generation;
+            lock.unlock();
+
+            std::shared_ptr<VolumeTextureData> data;
+            std::string errorMessage;
+            try {
+                data = std::make_shared<VolumeTextureData>(loadFunction(step, [this, &slot, generation](float)
+                {
+                    return !stopThreads && slot.generation == generation;
+                }));
+            }
+            catch (const std::exception& e) {
+                errorMessage = e.what();
+                LOG(ERROR) << "Loading time step " << step << " failed: " << errorMessage.c_str();
+            }
+
+            if (data && data->data.empty() && errorMessage.empty()) errorMessage = "The time step contains no data.";
+
+            lock.lock();
+            if (slot.generation != generation || stopThreads) ++stats.loadsDiscarded;
+            else if (!data || data->data.empty()) {
+                ++stats.loadsFailed;
+                slot.errorMessage = errorMessage;
+                if (++slot.numFailures <= maxRetries) {
+                    slot.state = SlotState::QUEUED;
+                    loadQueue.push_back(slotIndex);
+                    workCondition.notify_one();
+                } else slot.state = SlotState::FAILED;
+            } else {
+                ++stats.loadsCompleted;
+                stats.bytesLoaded += data->data.size();
+                slot.state = SlotState::READY;
+                slot.data = std::move(data);
+            }
+            loadedCondition.notify_all();
+        }
+    }
+
+    /**
+     *  Constructor.
+     *  @param streamer the streamer providing the time steps.
+     *  @param sink0 the first sink.
+     *  @param sink1 the second sink.
+     *  @param maxSlabSize the maximum number of bytes uploaded at once.
+     */
+    VolumeSeriesPlayer::VolumeSeriesPlayer(VolumeSeriesStreamer* streamer, VolumeUploadSink* sink0, VolumeUploadSink* sink1,
+        uint64_t maxSlabSize) :
+        streamer(streamer),
+        sinks{ { sink0, sink1 } },
+        upload(maxSlabSize),
+        frontIndex(0),
+        hasDisplayedStep(false),
+        displayedStep(0),
+        uploadStep(0)
+    {
+    }
+
+    /** Destructor. */
+    VolumeSeriesPlayer::~VolumeSeriesPlayer() = default;
+
+    /**
+     *  Advances playback towards a time step, has to be called from the thread the sinks upload on (once per frame).
+     *  If the step is loaded its slices are uploaded to the back sink until the time budget is used up (at least one
+     *  slab per call), the sinks are swapped when the upload is complete.
+     *  @param step the time step that should be displayed.
+     *  @param timeBudget the time that may be spent uploading.
+     *  @return whether the step is displayed (the front sink holds it).
+     */
+    bool VolumeSeriesPlayer::Update(unsigned int step, std::chrono::microseconds timeBudget)
+    {
+        auto startTime = std::chrono::steady_clock::now();
+        if (hasDisplayedStep && displayedStep == step) {
+            streamer->RequestStep(step);
+            return true;
+        }
+
+        auto backSink = sinks[1 - frontIndex];
+        if (!uploadData || uploadStep != step) {
+            upload.Abort();
+            uploadData = streamer->RequestStep(step);
+            if (!uploadData) return false;
+            uploadStep = step;
+            upload.Begin(*backSink, *uploadData);
+        }
+
+        if (!upload.Continue(startTime, timeBudget)) return false;
+        uploadData.reset();
+        frontIndex = 1 - frontIndex;
+        displayedStep = step;
+        hasDisplayedStep = true;
+        return true;
+    }
+}
@@ -0,0 +1,189 @@
+/**
+ * @file   VolumeSeriesStreamer.h
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Contains the prefetching and double buffered playback of volume series.
+ */
+
+#ifndef VOLUMESERIESSTREAMER_H
+#define VOLUMESERIESSTREAMER_H
+
+#include "main.h"
+#include "gfx/volumes/AsyncVolumeLoad.h"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace cgu {
+
+    class VolumeSeries;
+
+    /** Statistics of a volume series streamer. */
+    struct VolumeStreamingStatistics
+    {
+        /** Holds the number of time steps requested (repeated requests of the same step are counted once). */
+        uint64_t stepRequests = 0;
+        /** Holds the number of time steps that were loaded when they were first requested. */
+        uint64_t prefetchHits = 0;
+        /** Holds the number of requests that could not be served because the step was not loaded yet. */
+        uint64_t stalls = 0;
+        /** Holds the number of time steps loaded. */
+        uint64_t loadsCompleted = 0;
+        /** Holds the number of loads canceled or thrown away because the step was no longer needed. */
+        uint64_t loadsDiscarded = 0;
+        /** Holds the number of loads that failed (each attempt is counted). */
+        uint64_t loadsFailed = 0;
+        /** Holds the number of bytes loaded. */
+        uint64_t bytesLoaded = 0;
+
+        /** Returns the fraction of requested steps that were prefetched in time. */
+        float GetHitRate() const { return stepRequests == 0 ? 0.0f : static_cast<float>(prefetchHits) / static_cast<float>(stepRequests); }
+    };
+
+    /**
+     *  @brief Prefetches the time steps of a volume series into a bounded ring of host buffers.
+     *  When a step is requested the following steps (wrapping around if looping) are loaded on I/O threads. Buffers
+     *  of steps that are no longer needed are reused, loads that are no longer needed are canceled. Failed loads are
+     *  retried (see SetMaxRetries), a step that still fails stays failed until it is requested anew or leaves the
+     *  prefetch window. The streamer does not need a GL context, RequestStep never blocks.
+     *  Time steps of a VolumeSeries are normalized with the maximum of the whole series, so playback does not
+     *  flicker between steps of different maxima.
+     *
+     * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+     * @date   2026.10.16
+     */
+    class VolumeSeriesStreamer
+    {
+    public:
+        /** The function loading the data of a time step on an I/O thread (see Volume::LoadTextureData). */
+        using LoadFunction = std::function<VolumeTextureData(unsigned int step, const AsyncVolumeLoad::ProgressFunction& reportProgress)>;
+
+        VolumeSeriesStreamer(std::shared_ptr<const VolumeSeries> series, unsigned int prefetchCount = 4, unsigned int numIOThreads = 2);
+        VolumeSeriesStreamer(unsigned int numSteps, LoadFunction loadFunction, unsigned int prefetchCount = 4, unsigned int numIOThreads = 2);
+        VolumeSeriesStreamer(const VolumeSeriesStreamer&) = delete;
+        VolumeSeriesStreamer& operator=(const VolumeSeriesStreamer&) = delete;
+        ~VolumeSeriesStreamer();
+
+        std::shared_ptr<const VolumeTextureData> RequestStep(unsigned int step);
+        std::shared_ptr<const VolumeTextureData> WaitForStep(unsigned int step);
+        bool IsStepReady(unsigned int step) const;
+
+        /** Sets whether playback wraps around at the end of the series (prefetches the first steps). */
+        void SetLooping(bool loop) { std::lock_guard<std::mutex> lock(streamerMutex); looping = loop; }
+        /** Sets how often a failed load is retried before the step is marked as failed. */
+        void SetMaxRetries(unsigned int retries) { std::lock_guard<std::mutex> lock(streamerMutex); maxRetries = retries; }
+        /** Returns the number of time steps. */
+        unsigned int GetNumSteps() const { return numSteps; }
+        /** Returns the number of steps loaded ahead of the requested one. */
+        unsigned int GetPrefetchCount() const { return static_cast<unsigned int>(slots.size()) - 1; }
+        /** Returns the statistics. */
+        VolumeStreamingStatistics GetStatistics() const { std::lock_guard<std::mutex> lock(streamerMutex); return stats; }
+        /** Resets the statistics. */
+        void ResetStatistics() { std::lock_guard<std::mutex> lock(streamerMutex); stats = VolumeStreamingStatistics(); }
+
+    private:
+        /** The states of a buffer. */
+        enum class SlotState { EMPTY, QUEUED, LOADING, READY, FAILED };
+
+        /** A host buffer of the ring. */
+        struct Slot
+        {
+            /** Holds the step assigned to the buffer. */
+            unsigned int step = 0;
+            /** Holds the state of the buffer. */
+            SlotState state = SlotState::EMPTY;
+            /** Holds the number of assignments, used to detect loads that are no longer needed. */
+            std::atomic<uint64_t> generation{ 0 };
+            /** Holds the loaded data. */
+            std::shared_ptr<const VolumeTextureData> data;
+            /** Holds the error message if loading failed. */
+            std::string errorMessage;
+            /** Holds the number of failed loads of the assigned step. */
+            unsigned int numFailures = 0;
+        };
+
+        void Start(unsigned int numIOThreads);
+        void Schedule(unsigned int step);
+        Slot* FindSlot(unsigned int step);
+        const Slot* FindSlot(unsigned int step) const;
+        void IOThread();
+
+        /** Holds the number of time steps. */
+        unsigned int numSteps;
+        /** Holds the function loading a time step. */
+        LoadFunction loadFunction;
+        /** Holds the buffers. */
+        std::vector<Slot> slots;
+        /** Holds the buffers waiting to be loaded (in the order they are needed). */
+        std::deque<std::size_t> loadQueue;
+        /** Holds whether playback wraps around. */
+        bool looping;
+        /** Holds the number of retries of failed loads. */
+        unsigned int maxRetries;
+        /** Holds the last step requested. */
+        unsigned int lastRequestedStep;
+        /** Holds the statistics. */
+        VolumeStreamingStatistics stats;
+        /** Holds whether the I/O threads should stop. */
+        std::atomic<bool> stopThreads;
+        /** Holds the mutex for all data shared with the I/O threads. */
+        mutable std::mutex streamerMutex;
+        /** Holds the condition the I/O threads wait on for work. */
+        std::condition_variable workCondition;
+        /** Holds the condition signaled when a load finished. */
+        std::condition_variable loadedCondition;
+        /** Holds the I/O threads. */
+        std::vector<std::thread> ioThreads;
+    };
+
+    /**
+     *  @brief Double buffered playback of a volume series.
+     *  The displayed step is held by one sink while the next one is uploaded to the other in slabs (within a time
+     *  budget per frame), the sinks are swapped once the upload is complete. If a step is not loaded yet the previous
+     *  one stays on display. With GLTextureUploadSinks the textures are reused for all steps.
+     *
+     * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+     * @date   2026.10.16
+     */
+    class VolumeSeriesPlayer
+    {
+    public:
+        VolumeSeriesPlayer(VolumeSeriesStreamer* streamer, VolumeUploadSink* sink0, VolumeUploadSink* sink1,
+            uint64_t maxSlabSize = 16 * 1024 * 1024);
+        VolumeSeriesPlayer(const VolumeSeriesPlayer&) = delete;
+        VolumeSeriesPlayer& operator=(const VolumeSeriesPlayer&) = delete;
+        ~VolumeSeriesPlayer();
+
+        bool Update(unsigned int step, std::chrono::microseconds timeBudget);
+
+        /** Returns the index of the sink holding the displayed step. */
+        unsigned int GetFrontIndex() const { return frontIndex; }
+        /** Returns the sink holding the displayed step. */
+        VolumeUploadSink* GetFrontSink() const { return sinks[frontIndex]; }
+        /** Returns whether a step is displayed. */
+        bool HasDisplayedStep() const { return hasDisplayedStep; }
+        /** Returns the displayed step. */
+        unsigned int GetDisplayedStep() const { return displayedStep; }
+
+    private:
+        /** Holds the streamer. */
+        VolumeSeriesStreamer* streamer;
+        /** Holds the sinks. */
+        std::array<VolumeUploadSink*, 2> sinks;
+        /** Holds the slab wise upload to the back sink. */
+        VolumeSlabUpload upload;
+        /** Holds the index of the front sink. */
+        unsigned int frontIndex;
+        /** Holds whether a step is displayed. */
+        bool hasDisplayedStep;
+        /** Holds the displayed step. */
+        unsigned int displayedStep;
+        /** Holds the data of the step uploaded to the back sink. */
+        std::shared_ptr<const VolumeTextureData> uploadData;
+        /** Holds the step uploaded to the back sink. */
+        unsigned int uploadStep;
+    };
+}
+
+#endif // VOLUMESERIESSTREAMER_H
@@ -0,0 +1,323 @@
+/**
+ * @file   VolumeStatistics.cpp
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Implementation of the histogram and statistics of a volume.
+ */
+
+#include "VolumeStatistics.h"
+#include "gfx/volumes/DerivedVolumePipeline.h"
+#include "gfx/volumes/VolumeDataConversion.h"
+#include "core/parallel_helper.h"
+#include <limits>
+
+namespace cgu {
+
+    /** The amount of source data a slab should have. */
+    static const uint64_t SLAB_SOURCE_SIZE = 64 << 20;
+    /** The maximum length of a gradient of normalized values. */
+    static const float maxGradientLength = 0.8660254f;
+
+    /** The mean and the sum of the squared deviations of a set of values. */
+    struct MomentAccumulator
+    {
+        /** Holds the number of values. */
+        uint64_t count = 0;
+        /** Holds the mean. */
+        double mean = 0.0;
+        /** Holds the sum of the squared deviations from the mean. */
+        double m2 = 0.0;
+
+        /** Merges the mean and deviations of another set of values into the accumulator. */
+        void Merge(uint64_t otherCount, double otherMean, double otherM2)
+        {
+            if (otherCount == 0) return;
+            auto newCount = count + otherCount;
+            auto delta = otherMean - mean;
+            mean += delta * static_cast<double>(otherCount) / static_cast<double>(newCount);
+            m2 += otherM2 + delta * delta * static_cast<double>(count) * static_cast<double>(otherCount) / static_cast<double>(newCount);
+            count = newCount;
+        }
+    };
+
+    /** The statistics collected by a single thread. */
+    struct StatisticsAccumulator
+    {
+        /** Holds the histogram. */
+        std::vector<uint64_t> histogram;
+        /** Holds the value / gradient magnitude histogram. */
+        std::vector<uint64_t> gradientHistogram;
+        /** Holds the minimum value. */
+        float minValue = std::numeric_limits<float>::max();
+        /** Holds the maximum value. */
+        float maxValue = std::numeric_limits<float>::lowest();
+    };
+
+    /** Default constructor. */
+    VolumeStatistics::VolumeStatistics() :
+        numGradientBins(0),
+        numVoxels(0),
+        minValue(0.0f),
+        maxValue(0.0f),
+        mean(0.0),
+        sumSquaredDeviations(0.0),
+        brickSize(0),
+        numBricks(0)
+    {
+    }
+
+    /**
+     *  Constructor, computes the statistics.
+     *  @param view the volume data (single channel).
+     *  @param numBins the number of histogram bins (0 uses 256 bins for 8 bit data and 65536 otherwise).
+     *  @param numGradientBins the number of bins on each axis of the 2D histogram.
+     *  @param brickSize the size of the bricks to summarize.
+     *  @param numThreads the number of threads to use (0 to use all hardware threads).
+     */
+    VolumeStatistics::VolumeStatistics(const VolumeDataView& view, unsigned int numBins, unsigned int numGradientBins,
+        const glm::uvec3& brickSize, unsigned int numThreads) :
+        VolumeStatistics()
+    {
+        if (view.numComponents != 1) throw std::runtime_error("Statistics can only be computed for single channel volumes.");
+        assert(glm::all(glm::greaterThan(brickSize, glm::uvec3(0))) && numGradientBins > 0);
+        if (numBins == 0) numBins = view.type == GL_UNSIGNED_BYTE ? 256 : 65536;
+        if (numThreads == 0) numThreads = parallel::GetNumThreads();
+
+        this->numGradientBins = numGradientBins;
+        this->brickSize = brickSize;
+        numBricks = (view.size + brickSize - glm::uvec3(1)) / brickSize;
+        brickSummaries.resize(static_cast<std::size_t>(numBricks.x) * numBricks.y * numBricks.z);
+
+        auto normalizeMax = volumeConversion::FindMaximumValue(view, numThreads);
+        std::vector<StatisticsAccumulator> accumulators(numThreads);
+        for (auto& acc : accumulators) {
+            acc.histogram.resize(numBins, 0);
+            acc.gradientHistogram.resize(static_cast<std::size_t>(numGradientBins) * numGradientBins, 0);
+        }
+        // the moments of each row of bricks are merged in order afterwards, so they do not depend on the scheduling.
+        std::vector<MomentAccumulator> brickRowMoments(static_cast<std::size_t>(numBricks.y) * numBricks.z);
+
+        const auto& size = view.size;
+        auto sliceSize = static_cast<uint64_t>(size.x) * size.y * view.bytesPerVoxel;
+        auto slabBricks = static_cast<unsigned int>(glm::max<uint64_t>(1, SLAB_SOURCE_SIZE / glm::max<uint64_t>(1, sliceSize * brickSize.z)));
+        auto numBinsF = static_cast<float>(numBins);
+        auto numGradientBinsF = static_cast<float>(numGradientBins);
+        auto planeRows = brickSize.y + 2;
+
+        for (unsigned int bz0 = 0; bz0 < numBricks.z; bz0 += slabBricks) {
+            auto bz1 = glm::min(bz0 + slabBricks, numBricks.z);
+            VolumeSlab slab(view, bz0 * brickSize.z, glm::min(bz1 * brickSize.z, size.z), 1);
+
+            // each work item is a row of bricks, so brick summaries are never shared between threads.
+            parallel::ForChunks(static_cast<uint64_t>(bz1 - bz0) * numBricks.y, 1, [&](uint64_t begin, uint64_t end, unsigned int threadIdx)
+            {
+                // a ring of three planes holding the converted rows of the slices z - 1, z and z + 1 (with the rows
+                // above and below the brick row), so each source row is converted once per brick row.
+                thread_local std::vector<float> ringBuffer;
+                thread_local std::vector<double> brickSums;
+                ringBuffer.resize(static_cast<std::size_t>(3) * planeRows * size.x);
+                brickSums.resize(numBricks.x);
+                auto& acc = accumulators[threadIdx];
+
+                for (auto item = begin; item < end; ++item) {
+                    auto by = static_cast<unsigned int>(item % numBricks.y);
+                    auto bz = bz0 + static_cast<unsigned int>(item / numBricks.y);
+                    auto brickRowIdx = static_cast<std::size_t>(bz) * numBricks.y + by;
+                    auto brickRow = brickSummaries.data() + brickRowIdx * numBricks.x;
+                    for (unsigned int bx = 0; bx < numBricks.x; ++bx) {
+                        brickRow[bx].minValue = std::numeric_limits<float>::max();
+                        brickRow[bx].maxValue = std::numeric_limits<float>::lowest();
+                        brickSums[bx] = 0.0;
+                    }
+
+                    auto yBegin = static_cast<int>(by * brickSize.y);
+                    auto yEnd = static_cast<int>(glm::min((by + 1) * brickSize.y, size.y));
+                    auto zBegin = static_cast<int>(bz * brickSize.z);
+                    auto zEnd = static_cast<int>(glm::min((bz + 1) * brickSize.z, size.z));
+                    auto getRow = [&](int y, int z) {
+                        return ringBuffer.data() + (static_cast<std::size_t>((z + 1) % 3) * planeRows + (y - yBegin + 1)) * size.x;
+                    };
+                    auto convertPlane = [&](int z) {
+                        for (auto y = yBegin - 1; y <= yEnd; ++y) {
+                            volumeConversion::ConvertVoxelsToNormalizedFloat(view, slab.GetVoxel(glm::ivec3(0, y, z)), size.x, normalizeMax, getRow(y, z));
+                        }
+                    };
+
+                    auto& moments = brickRowMoments[brickRowIdx];
+                    convertPlane(zBegin - 1);
+                    convertPlane(zBegin);
+                    for (auto z = zBegin; z < zEnd; ++z) {
+                        convertPlane(z + 1);
+                        for (auto y = yBegin; y < yEnd; ++y) {
+                            auto rowC = getRow(y, z);
+                            auto rowYM = getRow(y - 1, z), rowYP = getRow(y + 1, z), rowZM = getRow(y, z - 1), rowZP = getRow(y, z + 1);
+
+                            double rowSum = 0.0;
+                            for (unsigned int x = 0; x < size.x; ++x) {
+                                auto value = rowC[x];
+                                auto gx = (rowC[glm::min(x + 1, size.x - 1)] - rowC[x > 0 ? x - 1 : 0]) * 0.5f;
+                                auto gy = (rowYP[x] - rowYM[x]) * 0.5f;
+                                auto gz = (rowZP[x] - rowZM[x]) * 0.5f;
+                                auto gradient = glm::sqrt(gx * gx + gy * gy + gz * gz);
+
+                                auto bin = static_cast<unsigned int>(glm::clamp(value * numBinsF, 0.0f, numBinsF - 1.0f));
+                                auto valueBin2D = static_cast<unsigned int>(glm::clamp(value * numGradientBinsF, 0.0f, numGradientBinsF - 1.0f));
+                                auto gradientBin = static_cast<unsigned int>(glm::clamp(gradient / maxGradientLength * numGradientBinsF, 0.0f, numGradientBinsF - 1.0f));
+                                ++acc.histogram[bin];
+                                ++acc.gradientHistogram[gradientBin * numGradientBins + valueBin2D];
+
+                                auto& brick = brickRow[x / brickSize.x];
+                                brick.minValue = glm::min(brick.minValue, value);
+                                brick.maxValue = glm::max(brick.maxValue, value);
+                                brickSums[x / brickSize.x] += value;
+                                rowSum += value;
+                            }
+
+                            auto rowMean = rowSum / static_cast<double>(size.x);
+                            double rowM2 = 0.0;
+                            for (unsigned int x = 0; x < size.x; ++x) rowM2 += (rowC[x] - rowMean) * (rowC[x] - rowMean);
+                            moments.Merge(size.x, rowMean, rowM2);
+                        }
+                    }
+
+                    for (unsigned int bx = 0; bx < numBricks.x; ++bx) {
+                        acc.minValue = glm::min(acc.minValue, brickRow[bx].minValue);
+                        acc.maxValue = glm::max(acc.maxValue, brickRow[bx].maxValue);
+                        auto brickVoxels = static_cast<uint64_t>(glm::min((bx + 1) * brickSize.x, size.x) - bx * brickSize.x)
+                            * static_cast<uint64_t>(yEnd - yBegin) * static_cast<uint64_t>(zEnd - zBegin);
+                        brickRow[bx].meanValue = static_cast<float>(brickSums[bx] / static_cast<double>(brickVoxels));
+                    }
+                }
+            }, numThreads);
+        }
+
+        StatisticsAccumulator result;
+        result.histogram.resize(numBins, 0);
+        result.gradientHistogram.resize(static_cast<std::size_t>(numGradientBins) * numGradientBins, 0);
+        for (const auto& acc : accumulators) {
+            for (std::size_t i = 0; i < acc.histogram.size(); ++i) result.histogram[i] += acc.histogram[i];
+            for (std::size_t i = 0; i < acc.gradientHistogram.size(); ++i) result.gradientHistogram[i] += acc.gradientHistogram[i];
+            result.minValue = glm::min(result.minValue, acc.minValue);
+            result.maxValue = glm::max(result.maxValue, acc.maxValue);
+        }
+        MomentAccumulator resultMoments;
+        for (const auto& moments : brickRowMoments) resultMoments.Merge(moments.count, moments.mean, moments.m2);
+
+        histogram = std::move(result.histogram);
+        gradientHistogram = std::move(result.gradientHistogram);
+        numVoxels = resultMoments.count;
+        mean = resultMoments.mean;
+        sumSquaredDeviations = resultMoments.m2;
+        minValue = numVoxels == 0 ? 0.0f : result.minValue;
+        maxValue = numVoxels == 0 ? 0.0f : result.maxValue;
+    }
+
+    /** Default copy constructor. */
+    VolumeStatistics::VolumeStatistics(const VolumeStatistics&) = default;
+    /** Default copy assignment operator. */
+    VolumeStatistics& VolumeStatistics::operator=(const VolumeStatistics&) = default;
+    /** Default move constructor. */
+    VolumeStatistics::VolumeStatistics(VolumeStatistics&&) = default;
+    /** Default move assignment operator. */
+    VolumeStatistics& VolumeStatistics::operator=(VolumeStatistics&&) = default;
+    /** Destructor. */
+    VolumeStatistics::~VolumeStatistics() = default;
+
+    /**
+     *  Returns the string describing the parameters for cache keys.
+     *  @param numBins the number of histogram bins.
+     *  @param numGradientBins the number of bins on each axis of the 2D histogram.
+     *  @param brickSize the size of the bricks summarized.
+     */
+    std::string VolumeStatistics::GetParameterString(unsigned int numBins, unsigned int numGradientBins, const glm::uvec3& brickSize)
+    {
+        return "statistics," + std::to_string(numBins) + "," + std::to_string(numGradientBins) + "," + std::to_string(brickSize.x)
+            + "," + std::to_string(brickSize.y) + "," + std::to_string(brickSize.z);
+    }
+
+    /**
+     *  Returns the value below which a given fraction of the voxels lies.
+     *  The value is interpolated linearly inside the histogram bin.
+     *  @param percentile the fraction of voxels in [0, 1].
+     *  @return the normalized value.
+     */
+    float VolumeStatistics::GetPercentile(float percentile) const
+    {
+        if (numVoxels == 0 || histogram.empty()) return 0.0f;
+        auto target = static_cast<double>(glm::clamp(percentile, 0.0f, 1.0f)) * static_cast<double>(numVoxels);
+        double cumulative = 0.0;
+        for (std::size_t i = 0; i < histogram.size(); ++i) {
+            auto binCount = static_cast<double>(histogram[i]);
+            if (binCount > 0.0 && cumulative + binCount >= target) {
+                auto binPosition = (target - cumulative) / binCount;
+                return static_cast<float>((static_cast<double>(i) + binPosition) / static_cast<double>(histogram.size()));
+            }
+            cumulative += binCount;
+        }
+        return 1.0f;
+    }
+
+    /**
+     *  Returns a window of values for transfer functions that clips outliers.
+     *  @param lowerPercentile the fraction of voxels below the window.
+     *  @param upperPercentile the fraction of voxels below the end of the window.
+     *  @return the start and end of the window as normalized values.
+     */
+    glm::vec2 VolumeStatistics::GetWindow(float lowerPercentile, float upperPercentile) const
+    {
+        glm::vec2 window(GetPercentile(lowerPercentile), GetPercentile(upperPercentile));
+        if (window.y <= window.x) window = glm::vec2(minValue, maxValue);
+        return window;
+    }
+
+    /**
+     *  Loads the statistics from a cache file.
+     *  @param filename the name of the cache file.
+     *  @param key the key the cache file needs to have.
+     *  @return whether the statistics could be loaded.
+     */
+    bool VolumeStatistics::LoadFromCache(const std::string& filename, const VolumeCacheKey& key)
+    {
+        auto loaded = volumeCache::ReadCache<VersionableSerializerType>(filename, key, [this](std::istream& ifs)
+        {
+            serializeHelper::readV(ifs, histogram);
+            serializeHelper::readV(ifs, gradientHistogram);
+            serializeHelper::read(ifs, numGradientBins);
+            serializeHelper::read(ifs, numVoxels);
+            serializeHelper::read(ifs, minValue);
+            serializeHelper::read(ifs, maxValue);
+            serializeHelper::read(ifs, mean);
+            serializeHelper::read(ifs, sumSquaredDeviations);
+            serializeHelper::read(ifs, brickSize);
+            serializeHelper::read(ifs, numBricks);
+            serializeHelper::readV(ifs, brickSummaries);
+            return true;
+        });
+        if (!loaded) *this = VolumeStatistics();
+        return loaded;
+    }
+
+    /**
+     *  Saves the statistics to a cache file. Failing to write the cache is not an error.
+     *  @param filename the name of the cache file.
+     *  @param key the key to store with the statistics.
+     */
+    void VolumeStatistics::SaveToCache(const std::string& filename, const VolumeCacheKey& key) const
+    {
+        volumeCache::WriteCache<VersionableSerializerType>(filename, key, [this](std::ostream& ofs)
+        {
+            serializeHelper::writeV(ofs, histogram);
+            serializeHelper::writeV(ofs, gradientHistogram);
+            serializeHelper::write(ofs, numGradientBins);
+            serializeHelper::write(ofs, numVoxels);
+            serializeHelper::write(ofs, minValue);
+            serializeHelper::write(ofs, maxValue);
+            serializeHelper::write(ofs, mean);
+            serializeHelper::write(ofs, sumSquaredDeviations);
+            serializeHelper::write(ofs, brickSize);
+            serializeHelper::write(ofs, numBricks);
+            serializeHelper::writeV(ofs, brickSummaries);
+        });
+    }
+}
@@ -0,0 +1,117 @@
+/**
+ * @file   VolumeStatistics.h
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Contains the histogram and statistics of a volume.
+ */
+
+#ifndef VOLUMESTATISTICS_H
+#define VOLUMESTATISTICS_H
+
+#include "main.h"
+#include "gfx/volumes/RawVolumeSource.h"
+#include "gfx/volumes/VolumeCache.h"
+#include "core/serializationHelper.h"
+
+namespace cgu {
+
+    /** Summary of the values inside a brick. */
+    struct VolumeBrickSummary
+    {
+        /** Holds the minimum value. */
+        float minValue;
+        /** Holds the maximum value. */
+        float maxValue;
+        /** Holds the mean value. */
+        float meanValue;
+    };
+
+    /**
+     *  @brief Histograms and statistics of a single channel volume.
+     *  All values are normalized to the maximum value of the volume like the values in volume textures, so they can be
+     *  used directly with transfer functions. Gradients are central differences on the normalized values in voxel
+     *  units, the gradient magnitude axis of the 2D histogram spans the maximum possible magnitude [0, sqrt(3)/2].
+     *  The volume is processed in slabs of bricks on all hardware threads, only the current slab needs to be in
+     *  memory for memory mapped sources. Mean and variance are merged per row of bricks in a fixed order, so all
+     *  results are independent of the number of threads.
+     *
+     * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+     * @date   2026.10.16
+     */
+    class VolumeStatistics
+    {
+    public:
+        using VersionableSerializerType = serializeHelper::VersionableSerializer<'V', 'S', 'T', 'A', 1001>;
+
+        VolumeStatistics();
+        VolumeStatistics(const VolumeDataView& view, unsigned int numBins = 0, unsigned int numGradientBins = 256,
+            const glm::uvec3& brickSize = glm::uvec3(32), unsigned int numThreads = 0);
+        VolumeStatistics(const VolumeStatistics&);
+        VolumeStatistics& operator=(const VolumeStatistics&);
+        VolumeStatistics(VolumeStatistics&&);
+        VolumeStatistics& operator=(VolumeStatistics&&);
+        ~VolumeStatistics();
+
+        bool LoadFromCache(const std::string& filename, const VolumeCacheKey& key);
+        void SaveToCache(const std::string& filename, const VolumeCacheKey& key) const;
+        static std::string GetParameterString(unsigned int numBins, unsigned int numGradientBins, const glm::uvec3& brickSize);
+
+        float GetPercentile(float percentile) const;
+        glm::vec2 GetWindow(float lowerPercentile = 0.01f, float upperPercentile = 0.99f) const;
+
+        /** Returns the histogram of the normalized values in [0, 1]. */
+        const std::vector<uint64_t>& GetHistogram() const { return histogram; }
+        /** Returns the 2D histogram (value bins run fastest, gradient magnitude bins second). */
+        const std::vector<uint64_t>& GetGradientHistogram() const { return gradientHistogram; }
+        /** Returns the number of bins on each axis of the 2D histogram. */
+        unsigned int GetNumGradientBins() const { return numGradientBins; }
+        /** Returns the number of voxels. */
+        uint64_t GetNumVoxels() const { return numVoxels; }
+        /** Returns the minimum value. */
+        float GetMinValue() const { return minValue; }
+        /** Returns the maximum value. */
+        float GetMaxValue() const { return maxValue; }
+        /** Returns the mean value. */
+        double GetMean() const { return mean; }
+        /** Returns the variance of the values. */
+        double GetVariance() const { return numVoxels == 0 ? 0.0 : sumSquaredDeviations / static_cast<double>(numVoxels); }
+        /** Returns the size of the bricks summarized. */
+        const glm::uvec3& GetBrickSize() const { return brickSize; }
+        /** Returns the number of bricks in each dimension. */
+        const glm::uvec3& GetNumBricks() const { return numBricks; }
+        /** Returns the brick summaries (x runs fastest). */
+        const std::vector<VolumeBrickSummary>& GetBrickSummaries() const { return brickSummaries; }
+        /** Returns the summary of a brick. */
+        const VolumeBrickSummary& GetBrickSummary(const glm::uvec3& brick) const
+        {
+            return brickSummaries[(static_cast<std::size_t>(brick.z) * numBricks.y + brick.y) * numBricks.x + brick.x];
+        }
+
+    private:
+        /** Holds the histogram. */
+        std::vector<uint64_t> histogram;
+        /** Holds the value / gradient magnitude histogram. */
+        std::vector<uint64_t> gradientHistogram;
+        /** Holds the number of bins on each axis of the 2D histogram. */
+        unsigned int numGradientBins;
+        /** Holds the number of voxels. */
+        uint64_t numVoxels;
+        /** Holds the minimum value. */
+        float minValue;
+        /** Holds the maximum value. */
+        float maxValue;
+        /** Holds the mean value. */
+        double mean;
+        /** Holds the sum of the squared deviations from the mean. */
+        double sumSquaredDeviations;
+        /** Holds the brick size. */
+        glm::uvec3 brickSize;
+        /** Holds the number of bricks. */
+        glm::uvec3 numBricks;
+        /** Holds the brick summaries. */
+        std::vector<VolumeBrickSummary> brickSummaries;
+    };
+}
+
+#endif // VOLUMESTATISTICS_H
@@ -0,0 +1,117 @@
+/**
+ * @file   VolumeStorage.h
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Contains the formats single channel volume textures are stored in on the GPU.
+ */
+
+#ifndef VOLUMESTORAGE_H
+#define VOLUMESTORAGE_H
+
+#include "main.h"
+#include <glm/gtc/packing.hpp>
+
+namespace cgu {
+
+    /** The formats of single channel volume textures. */
+    enum class VolumeStorageFormat
+    {
+        /** Normalized 8 bit integers (GL_R8). */
+        UNORM8,
+        /** Normalized 16 bit integers (GL_R16). */
+        UNORM16,
+        /** Half floats (GL_R16F). */
+        HALF,
+        /** Floats (GL_R32F). */
+        FLOAT
+    };
+
+    namespace volumeStorage {
+
+        /** Loads and stores normalized 8 bit values the way OpenGL does. */
+        struct Unorm8
+        {
+            using Type = uint8_t;
+            static float Load(Type val) { return static_cast<float>(val) / 255.0f; }
+            static Type Store(float val) { return static_cast<Type>(glm::clamp(val, 0.0f, 1.0f) * 255.0f + 0.5f); }
+        };
+
+        /** Loads and stores normalized 16 bit values the way OpenGL does. */
+        struct Unorm16
+        {
+            using Type = uint16_t;
+            static float Load(Type val) { return static_cast<float>(val) / 65535.0f; }
+            static Type Store(float val) { return static_cast<Type>(glm::clamp(val, 0.0f, 1.0f) * 65535.0f + 0.5f); }
+        };
+
+        /** Loads and stores half floats. */
+        struct Half
+        {
+            using Type = uint16_t;
+            static float Load(Type val) { return glm::unpackHalf1x16(val); }
+            static Type Store(float val) { return static_cast<Type>(glm::packHalf1x16(val)); }
+        };
+
+        /** Loads and stores floats. */
+        struct Float
+        {
+            using Type = float;
+            static float Load(Type val) { return val; }
+            static Type Store(float val) { return val; }
+        };
+
+        /**
+         *  Finds the storage format for an internal texture format.
+         *  @param internalFormat the internal format.
+         *  @param format the storage format (output).
+         *  @return whether the internal format has a storage format.
+         */
+        inline bool FromInternalFormat(GLint internalFormat, VolumeStorageFormat& format)
+        {
+            switch (internalFormat) {
+            case GL_R8: format = VolumeStorageFormat::UNORM8; return true;
+            case GL_R16: format = VolumeStorageFormat::UNORM16; return true;
+            case GL_R16F: format = VolumeStorageFormat::HALF; return true;
+            case GL_R32F: format = VolumeStorageFormat::FLOAT; return true;
+            default: return false;
+            }
+        }
+
+        /** Returns the size of a single value in bytes. */
+        inline unsigned int GetElementSize(VolumeStorageFormat format)
+        {
+            switch (format) {
+            case VolumeStorageFormat::UNORM8: return 1;
+            case VolumeStorageFormat::UNORM16: return 2;
+            case VolumeStorageFormat::HALF: return 2;
+            default: return 4;
+            }
+        }
+
+        /** Returns the OpenGL type used to upload values. */
+        inline GLenum GetType(VolumeStorageFormat format)
+        {
+            switch (format) {
+            case VolumeStorageFormat::UNORM8: return GL_UNSIGNED_BYTE;
+            case VolumeStorageFormat::UNORM16: return GL_UNSIGNED_SHORT;
+            case VolumeStorageFormat::HALF: return GL_HALF_FLOAT;
+            default: return GL_FLOAT;
+            }
+        }
+
+        /** Calls a function with the load/store helper of a storage format. */
+        template<typename Fn>
+        auto WithStorage(VolumeStorageFormat format, Fn fn) -> decltype(fn(Float()))
+        {
+            switch (format) {
+            case VolumeStorageFormat::UNORM8: return fn(Unorm8());
+            case VolumeStorageFormat::UNORM16: return fn(Unorm16());
+            case VolumeStorageFormat::HALF: return fn(Half());
+            default: return fn(Float());
+            }
+        }
+    }
+}
+
+#endif // VOLUMESTORAGE_H
@@ -88,5 +88,52 @@ namespace cgu {
             result.psnrMaxAll_ = 20.0f * glm::log(1.0f / result.errorRMSMaxAll_, 10.0f);
             return result;
         }
+
+        /**
+         *  Computes the same statistics as CreateDiffImage on the CPU for two RGBA8 images in memory
+         *  (e.g. from CPURayCaster::ConvertToRGBA8).
+         *  @param origImage the original image.
+         *  @param compareImage the image to compare to the original.
+         *  @param diffImage if not null the difference image is stored here.
+         *  @return the statistics.
+         */
+        EvalStatistics Image2DStatistics::CompareImageData(const std::vector<uint8_t>& origImage, const std::vector<uint8_t>& compareImage,
+            std::vector<uint8_t>* diffImage)
+        {
+            assert(origImage.size() == compareImage.size() && origImage.size() % 4 == 0);
+            auto numPixelsInt = origImage.size() / 4;
+            if (diffImage) diffImage->resize(origImage.size());
+
+            glm::vec4 statResults(0.0f);
+            for (std::size_t i = 0; i < numPixelsInt; ++i) {
+                glm::vec3 diff;
+                for (int c = 0; c < 3; ++c) {
+                    diff[c] = glm::abs(static_cast<float>(compareImage[4 * i + c]) - static_cast<float>(origImage[4 * i + c])) / 255.0f;
+                    if (diffImage) (*diffImage)[4 * i + c] = static_cast<uint8_t>(diff[c] * 255.0f + 0.5f);
+                }
+                if (diffImage) (*diffImage)[4 * i + 3] = 255;
+
+                auto rmsAvg = glm::dot(diff, glm::vec3(1.0f)) / 3.0f;
+                auto rmsMax = glm::max(glm::max(diff.x, diff.y), diff.z);
+                statResults.x += rmsAvg * rmsAvg;
+                statResults.y += rmsMax * rmsMax;
+                statResults.z = glm::max(statResults.z, rmsMax);
+                if (diff.x > 0.0001f || diff.y > 0.0001f || diff.z > 0.0001f) statResults.w += 1.0f;
+            }
+
+            auto numPixels = static_cast<float>(numPixelsInt);
+            EvalStatistics result;
+            result.errorMax_ = statResults.z;
+            result.numErrorPixels_ = statResults.w;
+            result.errorRMSAvg_ = glm::sqrt(statResults.x / result.numErrorPixels_);
+            result.errorRMSAvgAll_ = glm::sqrt(statResults.x / numPixels);
+            result.errorRMSMax_ = glm::sqrt(statResults.y / result.numErrorPixels_);
+            result.errorRMSMaxAll_ = glm::sqrt(statResults.y / numPixels);
+            result.psnrAvg_ = 20.0f * glm::log(1.0f / result.errorRMSAvg_, 10.0f);
+            result.psnrAvgAll_ = 20.0f * glm::log(1.0f / result.errorRMSAvgAll_, 10.0f);
+            result.psnrMax_ = 20.0f * glm::log(1.0f / result.errorRMSMax_, 10.0f);
+            result.psnrMaxAll_ = 20.0f * glm::log(1.0f / result.errorRMSMaxAll_, 10.0f);
+            return result;
+        }
     }
 }
@@ -42,6 +42,8 @@ namespace cgu {
             ~Image2DStatistics();
 
             EvalStatistics CreateDiffImage(const std::string& compareImage, const std::string& diffImage) const;
+            static EvalStatistics CompareImageData(const std::vector<uint8_t>& origImage, const std::vector<uint8_t>& compareImage,
+                std::vector<uint8_t>* diffImage = nullptr);
             /*glm::vec2 GetRMSErrorDeltaE() const;
             glm::vec3 GetRMSErrorMax() const;
             glm::vec2 GetRMSErrorAvg() const;*/
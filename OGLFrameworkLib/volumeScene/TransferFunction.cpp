@@ -117,6 +117,18 @@ namespace cgu {
 
         }
 
+        // Initializes a gray ramp over a window of values (e.g. VolumeStatistics::GetWindow)
+        // that is transparent below the window and has the given opacity above it
+        void TransferFunction::InitWithWindow(const glm::vec2& window, float alpha /*= 0.3f*/)
+        {
+            points_.clear();
+            points_.push_back(ControlPoint{ 0.0f, glm::vec4(0.0f) });
+            points_.push_back(ControlPoint{ window.x, glm::vec4(0.0f) });
+            points_.push_back(ControlPoint{ window.y, glm::vec4(1.0f, 1.0f, 1.0f, alpha) });
+            points_.push_back(ControlPoint{ 1.0f, glm::vec4(1.0f, 1.0f, 1.0f, alpha) });
+            std::sort(points_.begin(), points_.end(), PointLess);
+        }
+
         void TransferFunction::SaveToFile(const std::string& filename) const
         {
             std::ofstream tfOut(filename, std::ios::binary | std::ios::out);
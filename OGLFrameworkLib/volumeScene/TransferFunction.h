@@ -60,6 +60,7 @@ namespace cgu {
             void SaveToFile(const std::string& filename) const;
             void LoadFromFile(const std::string& filename);
             void InitWithFreqRGBA(float start, float end, float freq, float alpha = 0.3f);
+            void InitWithWindow(const glm::vec2& window, float alpha = 0.3f);
 
             std::vector<ControlPoint>& points() { return points_; }
             const std::vector<ControlPoint>& points() const { return points_; }
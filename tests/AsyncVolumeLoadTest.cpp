@@ -0,0 +1,226 @@
+/**
+ * @file   AsyncVolumeLoadTest.cpp
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Tests the slab order, the time budget, the cancellation, the errors and the destruction of asynchronous loads.
+ */
+
+#include "TestHelper.h"
+#include "gfx/volumes/AsyncVolumeLoad.h"
+#include <algorithm>
+#include <thread>
+
+using namespace cgu;
+
+namespace {
+
+    const glm::uvec3 volumeSize(16, 8, 20);
+    const uint64_t sliceSize = static_cast<uint64_t>(volumeSize.x) * volumeSize.y;
+
+    /** Creates volume data with every voxel of a slice set to the slices index. */
+    VolumeTextureData CreateData()
+    {
+        VolumeTextureData data;
+        data.size = volumeSize;
+        data.data.resize(static_cast<std::size_t>(sliceSize * volumeSize.z));
+        for (unsigned int z = 0; z < volumeSize.z; ++z) std::fill_n(data.data.begin() + z * sliceSize, sliceSize, static_cast<uint8_t>(z));
+        return data;
+    }
+
+    /** Records the uploaded slabs and checks they are complete and in order. */
+    class TestSink final : public VolumeUploadSink
+    {
+    public:
+        explicit TestSink(std::chrono::microseconds slabTime = std::chrono::microseconds(0)) : slabTime(slabTime) {}
+
+        void BeginUpload(const VolumeTextureData& data) override
+        {
+            ++numBegun;
+            if (data.size != volumeSize || data.data.size() != sliceSize * volumeSize.z) valid = false;
+        }
+        void UploadSlices(const VolumeTextureData& data, unsigned int firstSlice, unsigned int numSlices) override
+        {
+            if (numBegun != 1 || numEnded != 0 || firstSlice != numUploaded || numSlices == 0) valid = false;
+            for (auto z = firstSlice; z < firstSlice + numSlices; ++z) {
+                auto slice = data.data.begin() + z * data.GetSliceSize();
+                if (std::count(slice, slice + sliceSize, static_cast<uint8_t>(z)) != static_cast<std::ptrdiff_t>(sliceSize)) valid = false;
+            }
+            numUploaded += numSlices;
+            ++numSlabs;
+            if (slabTime.count() > 0) std::this_thread::sleep_for(slabTime);
+        }
+        void EndUpload() override
+        {
+            if (numUploaded != volumeSize.z) valid = false;
+            ++numEnded;
+        }
+
+        /** Holds the time each slab takes. */
+        std::chrono::microseconds slabTime;
+        unsigned int numBegun = 0;
+        unsigned int numEnded = 0;
+        unsigned int numUploaded = 0;
+        unsigned int numSlabs = 0;
+        bool valid = true;
+    };
+
+    /** Returns a load function that blocks until the load is canceled and records that it returned. */
+    AsyncVolumeLoad::LoadFunction CreateBlockingLoad(std::atomic<bool>& started, std::atomic<bool>& returned)
+    {
+        return [&started, &returned](const AsyncVolumeLoad::ProgressFunction& reportProgress)
+        {
+            started = true;
+            while (reportProgress(0.25f)) std::this_thread::sleep_for(std::chrono::microseconds(100));
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            returned = true;
+            return VolumeTextureData();
+        };
+    }
+
+    template<typename F> bool WaitUntil(F condition)
+    {
+        for (auto i = 0; i < 5000; ++i) {
+            if (condition()) return true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return false;
+    }
+
+    void TestSlabOrder()
+    {
+        // without time budget each update uploads a single slab of three slices.
+        AsyncVolumeLoad load([](const AsyncVolumeLoad::ProgressFunction& reportProgress)
+        {
+            reportProgress(1.0f);
+            return CreateData();
+        }, sliceSize * 3);
+        TestSink sink;
+        FWLIB_CHECK(WaitUntil([&load]() { return load.GetProgress() == 0.5f; }));
+        auto numUpdates = 0U;
+        auto lastProgress = 0.0f;
+        auto monotonic = true;
+        while (load.Update(sink, std::chrono::microseconds(0)) != VolumeLoadState::FINISHED) {
+            monotonic = monotonic && load.GetProgress() >= lastProgress;
+            lastProgress = load.GetProgress();
+            if (load.GetState() == VolumeLoadState::UPLOADING) ++numUpdates;
+            FWLIB_CHECK(!load.IsDone() && numUpdates <= volumeSize.z);
+        }
+        FWLIB_CHECK(numUpdates == 6 && sink.numSlabs == 7 && monotonic);
+        FWLIB_CHECK(sink.valid && sink.numBegun == 1 && sink.numEnded == 1 && sink.numUploaded == volumeSize.z);
+        FWLIB_CHECK(load.GetProgress() == 1.0f && load.IsDone());
+        FWLIB_CHECK(load.Update(sink, std::chrono::microseconds(0)) == VolumeLoadState::FINISHED && sink.numSlabs == 7);
+
+        // a slab size smaller than a slice uploads single slices, Wait uploads everything.
+        AsyncVolumeLoad sliceLoad([](const AsyncVolumeLoad::ProgressFunction&) { return CreateData(); }, 1);
+        TestSink sliceSink;
+        FWLIB_CHECK(sliceLoad.Wait(sliceSink) == VolumeLoadState::FINISHED);
+        FWLIB_CHECK(sliceSink.valid && sliceSink.numSlabs == volumeSize.z && sliceSink.numEnded == 1);
+    }
+
+    void TestTimeBudget()
+    {
+        // each slab takes at least 2ms: a 9ms budget allows at most 5 slabs, at least one slab is uploaded per update.
+        const auto slabTime = std::chrono::milliseconds(2);
+        const auto timeBudget = std::chrono::milliseconds(9);
+        AsyncVolumeLoad load([](const AsyncVolumeLoad::ProgressFunction&) { return CreateData(); }, sliceSize);
+        TestSink sink(slabTime);
+        FWLIB_CHECK(WaitUntil([&load, &sink, timeBudget]() { return load.Update(sink, timeBudget) != VolumeLoadState::LOADING; }));
+        std::vector<unsigned int> slabsPerUpdate(1, sink.numSlabs);
+        while (!load.IsDone()) {
+            auto numSlabs = sink.numSlabs;
+            load.Update(sink, timeBudget);
+            slabsPerUpdate.push_back(sink.numSlabs - numSlabs);
+        }
+        FWLIB_CHECK(load.GetState() == VolumeLoadState::FINISHED && sink.valid && sink.numEnded == 1);
+        FWLIB_CHECK(slabsPerUpdate.size() >= volumeSize.z / 5);
+        for (auto numSlabs : slabsPerUpdate) FWLIB_CHECK(numSlabs >= 1 && numSlabs <= 5);
+
+        // an unlimited budget uploads all slabs in the first update after loading.
+        AsyncVolumeLoad unlimited([](const AsyncVolumeLoad::ProgressFunction&) { return CreateData(); }, sliceSize);
+        TestSink unlimitedSink;
+        FWLIB_CHECK(WaitUntil([&unlimited, &unlimitedSink]() { return unlimited.Update(unlimitedSink, std::chrono::microseconds::max()) != VolumeLoadState::LOADING; }));
+        FWLIB_CHECK(unlimited.GetState() == VolumeLoadState::FINISHED && unlimitedSink.valid && unlimitedSink.numSlabs == volumeSize.z);
+    }
+
+    void TestCancel()
+    {
+        // canceling from another thread stops the load function at its next progress report.
+        std::atomic<bool> started(false), returned(false);
+        AsyncVolumeLoad load(CreateBlockingLoad(started, returned));
+        TestSink sink;
+        FWLIB_CHECK(WaitUntil([&load]() { return load.GetProgress() == 0.125f; }));
+        FWLIB_CHECK(load.Update(sink, std::chrono::microseconds(0)) == VolumeLoadState::LOADING && started);
+        std::thread([&load]() { load.Cancel(); }).join();
+        FWLIB_CHECK(load.Wait(sink) == VolumeLoadState::CANCELED && returned);
+        FWLIB_CHECK(sink.numBegun == 0 && sink.numSlabs == 0);
+
+        // canceling during the upload abandons it without ending the sinks upload.
+        AsyncVolumeLoad uploading([](const AsyncVolumeLoad::ProgressFunction&) { return CreateData(); }, sliceSize);
+        TestSink uploadingSink;
+        FWLIB_CHECK(WaitUntil([&uploading, &uploadingSink]() { return uploading.Update(uploadingSink, std::chrono::microseconds(0)) == VolumeLoadState::UPLOADING; }));
+        FWLIB_CHECK(uploadingSink.numSlabs == 1);
+        uploading.Cancel();
+        FWLIB_CHECK(uploading.Update(uploadingSink, std::chrono::microseconds(0)) == VolumeLoadState::CANCELED);
+        FWLIB_CHECK(uploading.Update(uploadingSink, std::chrono::microseconds(0)) == VolumeLoadState::CANCELED);
+        FWLIB_CHECK(uploadingSink.valid && uploadingSink.numSlabs == 1 && uploadingSink.numEnded == 0);
+
+        // a load function returning no data counts as canceled.
+        AsyncVolumeLoad empty([](const AsyncVolumeLoad::ProgressFunction&) { return VolumeTextureData(); });
+        TestSink emptySink;
+        FWLIB_CHECK(empty.Wait(emptySink) == VolumeLoadState::CANCELED && emptySink.numBegun == 0);
+    }
+
+    void TestReadFailure(const test::TemporaryDirectory& dir)
+    {
+        // the error of reading a missing file is reported by the update after loading, nothing is uploaded.
+        auto filename = dir.GetFile("missing.raw");
+        AsyncVolumeLoad load([&filename](const AsyncVolumeLoad::ProgressFunction&)
+        {
+            VolumeDataView layout;
+            layout.size = volumeSize;
+            layout.bytesPerVoxel = 1;
+            RawVolumeSource source(filename, 0, layout);
+            return CreateData();
+        });
+        TestSink sink;
+        FWLIB_CHECK(WaitUntil([&load, &sink]() { return load.Update(sink, std::chrono::microseconds(0)) != VolumeLoadState::LOADING; }));
+        FWLIB_CHECK(load.GetState() == VolumeLoadState::FAILED && load.IsDone() && !load.GetError().empty());
+        FWLIB_CHECK(load.Update(sink, std::chrono::microseconds(0)) == VolumeLoadState::FAILED);
+        FWLIB_CHECK(sink.numBegun == 0 && sink.numSlabs == 0);
+
+        AsyncVolumeLoad thrown([](const AsyncVolumeLoad::ProgressFunction&) -> VolumeTextureData { throw std::runtime_error("test failure"); });
+        FWLIB_CHECK(thrown.Wait(sink) == VolumeLoadState::FAILED && thrown.GetError() == "test failure");
+    }
+
+    void TestDestruction()
+    {
+        // destroying a load while the background thread works cancels it and waits for the thread.
+        std::atomic<bool> started(false), returned(false);
+        {
+            AsyncVolumeLoad load(CreateBlockingLoad(started, returned));
+            FWLIB_CHECK(WaitUntil([&started]() { return started.load(); }));
+        }
+        FWLIB_CHECK(returned);
+
+        // a load destroyed before it was updated or during the upload leaves the sink unfinished.
+        TestSink sink;
+        {
+            AsyncVolumeLoad loaded([](const AsyncVolumeLoad::ProgressFunction&) { return CreateData(); }, sliceSize);
+            AsyncVolumeLoad uploading([](const AsyncVolumeLoad::ProgressFunction&) { return CreateData(); }, sliceSize);
+            FWLIB_CHECK(WaitUntil([&uploading, &sink]() { return uploading.Update(sink, std::chrono::microseconds(0)) == VolumeLoadState::UPLOADING; }));
+        }
+        FWLIB_CHECK(sink.valid && sink.numSlabs == 1 && sink.numEnded == 0);
+    }
+}
+
+int main(int, char**)
+{
+    TestSlabOrder();
+    TestTimeBudget();
+    TestCancel();
+    test::TemporaryDirectory dir;
+    TestReadFailure(dir);
+    TestDestruction();
+    return test::Finish("AsyncVolumeLoadTest");
+}
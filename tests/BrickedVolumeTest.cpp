@@ -0,0 +1,134 @@
+/**
+ * @file   BrickedVolumeTest.cpp
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Tests creating, validating and caching bricked volumes.
+ */
+
+#include "TestHelper.h"
+#include "gfx/volumes/BrickedVolume.h"
+#include <fstream>
+
+using namespace cgu;
+
+namespace {
+
+    const glm::uvec3 volumeSize(7, 5, 6);
+    const glm::uvec3 brickSize(4, 4, 4);
+
+    VolumeDataView CreateView(const std::vector<uint8_t>& data)
+    {
+        VolumeDataView view;
+        view.data = data.data();
+        view.size = volumeSize;
+        view.bytesPerVoxel = 2;
+        view.voxelStride = 2;
+        view.type = GL_UNSIGNED_SHORT;
+        return view;
+    }
+
+    std::vector<uint8_t> CreateData()
+    {
+        std::vector<uint8_t> data(static_cast<std::size_t>(volumeSize.x) * volumeSize.y * volumeSize.z * 2);
+        for (std::size_t i = 0; i < data.size(); ++i) data[i] = static_cast<uint8_t>(i * 7 + 3);
+        return data;
+    }
+
+    void TestRoundTrip(const test::TemporaryDirectory& dir)
+    {
+        auto data = CreateData();
+        auto source = CreateView(data);
+        auto filename = dir.GetFile("roundtrip.bvol");
+        BrickedVolume::CreateFromView(filename, source, brickSize, 1234);
+        FWLIB_CHECK(!boost::filesystem::exists(filename + ".tmp"));
+
+        BrickedVolume bricked(filename);
+        FWLIB_CHECK(bricked.GetSourceKey() == 1234);
+        FWLIB_CHECK(bricked.GetNumBricks() == glm::uvec3(2, 2, 2));
+        FWLIB_CHECK(bricked.GetNumBricksTotal() == 8);
+
+        auto numMismatches = 0;
+        std::vector<uint8_t> brickData;
+        for (unsigned int i = 0; i < bricked.GetNumBricksTotal(); ++i) {
+            auto brick = bricked.GetBrickCoordinates(i);
+            bricked.ReadBrick(brick, brickData);
+            auto view = bricked.GetBrickView(brick, brickData);
+            auto origin = bricked.GetBrickOrigin(brick);
+            for (unsigned int z = 0; z < view.size.z; ++z) for (unsigned int y = 0; y < view.size.y; ++y) for (unsigned int x = 0; x < view.size.x; ++x) {
+                auto expected = source.GetVoxel(origin + glm::uvec3(x, y, z));
+                auto actual = view.GetVoxel(glm::uvec3(x, y, z));
+                if (expected[0] != actual[0] || expected[1] != actual[1]) ++numMismatches;
+            }
+        }
+        FWLIB_CHECK(numMismatches == 0);
+
+        FWLIB_CHECK_THROWS(bricked.GetBrickIndex(glm::uvec3(2, 0, 0)), std::runtime_error);
+        FWLIB_CHECK_THROWS(bricked.GetPageEntry(glm::uvec3(0, 0, 7)), std::runtime_error);
+        FWLIB_CHECK_THROWS(bricked.ReadBrick(glm::uvec3(0, 5, 0), brickData), std::runtime_error);
+    }
+
+    void TestDamagedFiles(const test::TemporaryDirectory& dir)
+    {
+        auto data = CreateData();
+        auto filename = dir.GetFile("damaged.bvol");
+        BrickedVolume::CreateFromView(filename, CreateView(data), brickSize, 1);
+        auto fileSize = boost::filesystem::file_size(filename);
+
+        // cutting off the last brick makes its page table entry point outside of the file.
+        boost::filesystem::resize_file(filename, fileSize - 1);
+        FWLIB_CHECK_THROWS(BrickedVolume{ filename }, std::runtime_error);
+
+        // cutting into the page table.
+        boost::filesystem::resize_file(filename, 80);
+        FWLIB_CHECK_THROWS(BrickedVolume{ filename }, std::runtime_error);
+
+        // a corrupted page table entry.
+        BrickedVolume::CreateFromView(filename, CreateView(data), brickSize, 1);
+        {
+            // the brick data follows the page table directly.
+            BrickedVolume bricked(filename);
+            auto pageTableEnd = fileSize - data.size();
+            std::fstream file(filename, std::ios::in | std::ios::out | std::ios::binary);
+            file.seekp(static_cast<std::streamoff>(pageTableEnd - sizeof(BrickPageEntry)));
+            uint64_t badOffset = fileSize;
+            file.write(reinterpret_cast<const char*>(&badOffset), sizeof(badOffset));
+        }
+        FWLIB_CHECK_THROWS(BrickedVolume{ filename }, std::runtime_error);
+
+        FWLIB_CHECK_THROWS(BrickedVolume::CreateFromView(filename, CreateView(data), glm::uvec3(4, 0, 4)), std::runtime_error);
+        FWLIB_CHECK_THROWS(BrickedVolume{ dir.GetFile("missing.bvol") }, std::runtime_error);
+    }
+
+    void TestCache(const test::TemporaryDirectory& dir)
+    {
+        auto data = CreateData();
+        auto filename = dir.GetFile("cache.bvol");
+        BrickedVolume::CreateFromView(filename, CreateView(data), brickSize, 1);
+        BrickedVolume bricked(filename);
+
+        // budget for brick (0, 0, 0) with 4x4x4 voxels and brick (0, 0, 1) with 4x4x2 voxels.
+        BrickCache cache(&bricked, (4 * 4 * 4 + 4 * 4 * 2) * 2);
+        cache.GetBrick(glm::uvec3(0, 0, 0));
+        cache.GetBrick(glm::uvec3(0, 0, 1));
+        cache.GetBrick(glm::uvec3(0, 0, 0));
+        FWLIB_CHECK(cache.GetStatistics().hits == 1);
+        cache.GetBrick(glm::uvec3(0, 1, 0));
+        FWLIB_CHECK(cache.IsResident(glm::uvec3(0, 0, 0)));
+        FWLIB_CHECK(!cache.IsResident(glm::uvec3(0, 0, 1)));
+        FWLIB_CHECK(cache.GetMemoryUsage() <= cache.GetMemoryBudget());
+
+        FWLIB_CHECK_THROWS(cache.GetBrick(glm::uvec3(2, 0, 0)), std::runtime_error);
+        FWLIB_CHECK_THROWS(cache.Prefetch(std::vector<glm::uvec3>{ glm::uvec3(0, 2, 0) }), std::runtime_error);
+        FWLIB_CHECK_THROWS(cache.IsResident(glm::uvec3(0, 0, 2)), std::runtime_error);
+    }
+}
+
+int main(int, char**)
+{
+    test::TemporaryDirectory dir;
+    TestRoundTrip(dir);
+    TestDamagedFiles(dir);
+    TestCache(dir);
+    return test::Finish("BrickedVolumeTest");
+}
@@ -0,0 +1,152 @@
+/**
+ * @file   CPURayCasterTest.cpp
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Tests sampling, compositing and the tile parallel rendering of the CPU ray caster.
+ */
+
+#include "TestHelper.h"
+#include "gfx/volumes/CPURayCaster.h"
+#include "gfx/volumes/MinMaxPyramid.h"
+#include "gpgpu/Image2DStatistics.h"
+
+using namespace cgu;
+
+namespace {
+
+    const glm::uvec3 volumeSize(16, 16, 16);
+
+    std::unique_ptr<CPURayCaster> CreateRayCaster(const std::vector<uint8_t>& data, unsigned int numThreads)
+    {
+        auto pyramid = std::make_unique<MinMaxPyramid>(data.data(), volumeSize, VolumeStorageFormat::UNORM8, MinMaxPyramid::CalcNumLevels(volumeSize));
+        pyramid->SetLevel0Data(std::vector<uint8_t>(data));
+        return std::make_unique<CPURayCaster>(std::move(pyramid), glm::vec3(1.0f), numThreads);
+    }
+
+    /** A ramp along x (value = x * 16) with a sphere of 255 in the center. */
+    std::vector<uint8_t> CreateVolume()
+    {
+        std::vector<uint8_t> data(static_cast<std::size_t>(volumeSize.x) * volumeSize.y * volumeSize.z);
+        for (unsigned int z = 0; z < volumeSize.z; ++z) for (unsigned int y = 0; y < volumeSize.y; ++y) for (unsigned int x = 0; x < volumeSize.x; ++x) {
+            auto inSphere = glm::length(glm::vec3(x, y, z) + glm::vec3(0.5f) - glm::vec3(volumeSize) * 0.5f) < 4.0f;
+            data[(static_cast<std::size_t>(z) * volumeSize.y + y) * volumeSize.x + x] = inSphere ? 255 : static_cast<uint8_t>(x * 16);
+        }
+        return data;
+    }
+
+    bool IsClose(const glm::vec4& a, const glm::vec4& b, float epsilon = 1e-5f) { return glm::all(glm::lessThanEqual(glm::abs(a - b), glm::vec4(epsilon))); }
+
+    void TestSampling()
+    {
+        auto rayCaster = CreateRayCaster(CreateVolume(), 1);
+        FWLIB_CHECK(rayCaster->GetNumLevels() == MinMaxPyramid::CalcNumLevels(volumeSize));
+
+        // voxel centers return the voxel, positions between voxel centers are interpolated, borders are clamped.
+        auto voxelCenter = [](const glm::uvec3& voxel) { return (glm::vec3(voxel) + glm::vec3(0.5f)) / glm::vec3(volumeSize); };
+        FWLIB_CHECK(glm::abs(rayCaster->Sample(voxelCenter(glm::uvec3(3, 1, 2)), 0.0f) - 48.0f / 255.0f) < 1e-6f);
+        FWLIB_CHECK(glm::abs(rayCaster->Sample(voxelCenter(glm::uvec3(8, 8, 8)), 0.0f) - 1.0f) < 1e-6f);
+        auto between = (voxelCenter(glm::uvec3(3, 1, 2)) + voxelCenter(glm::uvec3(4, 1, 2))) * 0.5f;
+        FWLIB_CHECK(glm::abs(rayCaster->Sample(between, 0.0f) - 56.0f / 255.0f) < 1e-6f);
+        FWLIB_CHECK(rayCaster->Sample(glm::vec3(0.0f, 0.1f, 0.1f), 0.0f) == rayCaster->Sample(glm::vec3(-0.5f, 0.1f, 0.1f), 0.0f));
+
+        // mip levels are filtered linearly.
+        auto position = glm::vec3(0.3f, 0.6f, 0.45f);
+        auto level0 = rayCaster->Sample(position, 0.0f), level1 = rayCaster->Sample(position, 1.0f);
+        FWLIB_CHECK(glm::abs(rayCaster->Sample(position, 0.25f) - glm::mix(level0, level1, 0.25f)) < 1e-6f);
+    }
+
+    void TestTransferFunctionLookup()
+    {
+        auto rayCaster = CreateRayCaster(CreateVolume(), 1);
+        rayCaster->SetTransferFunctionTable({ glm::vec4(0.0f), glm::vec4(1.0f, 0.5f, 0.0f, 1.0f) });
+        FWLIB_CHECK(IsClose(rayCaster->LookupTransferFunction(0.0f), glm::vec4(0.0f)));
+        FWLIB_CHECK(IsClose(rayCaster->LookupTransferFunction(0.5f), glm::vec4(0.5f, 0.25f, 0.0f, 0.5f)));
+        FWLIB_CHECK(IsClose(rayCaster->LookupTransferFunction(1.0f), glm::vec4(1.0f, 0.5f, 0.0f, 1.0f)));
+    }
+
+    void TestCompositing()
+    {
+        // a constant volume and transfer function composite to a closed form.
+        std::vector<uint8_t> data(static_cast<std::size_t>(volumeSize.x) * volumeSize.y * volumeSize.z, 128);
+        auto rayCaster = CreateRayCaster(data, 1);
+        const auto alpha = 0.01f;
+        const glm::vec3 color(0.2f, 0.4f, 0.8f);
+        rayCaster->SetTransferFunctionTable(std::vector<glm::vec4>(8, glm::vec4(color, alpha)));
+
+        auto stepSize = rayCaster->GetStepSize(0);
+        auto numSamples = 0;
+        for (auto t = 0.0f; t < 1.0f; t += stepSize) ++numSamples;
+        // opacity correction to the reference sampling interval of renderVolume.fp.
+        auto correctedAlpha = 1.0f - glm::pow(1.0f - alpha, stepSize * 150.0f);
+        auto accumulatedAlpha = 1.0f - glm::pow(1.0f - correctedAlpha, static_cast<float>(numSamples));
+
+        auto result = rayCaster->CastRay(glm::vec3(0.5f, 0.5f, 0.0f), glm::vec3(0.5f, 0.5f, 1.0f), stepSize, 0.0f);
+        FWLIB_CHECK(IsClose(result, glm::vec4(color * accumulatedAlpha, 1.0f), 1e-4f));
+
+        // fully opaque samples stop the ray at the first sample.
+        rayCaster->SetTransferFunctionTable(std::vector<glm::vec4>(8, glm::vec4(color, 1.0f)));
+        FWLIB_CHECK(IsClose(rayCaster->CastRay(glm::vec3(0.5f, 0.5f, 0.0f), glm::vec3(0.5f, 0.5f, 1.0f), stepSize, 0.0f), glm::vec4(color, 1.0f)));
+    }
+
+    void TestRender()
+    {
+        auto data = CreateVolume();
+        std::vector<glm::vec4> table(256);
+        for (std::size_t i = 0; i < table.size(); ++i) {
+            auto value = static_cast<float>(i) / 255.0f;
+            table[i] = glm::vec4(value, 1.0f - value, 0.5f, value > 0.9f ? 0.5f : 0.02f);
+        }
+
+        CPURayCastParameters params;
+        params.imageSize = glm::uvec2(37, 29);
+        params.backgroundColor = glm::vec4(0.1f, 0.2f, 0.3f, 0.0f);
+
+        auto singleThreaded = CreateRayCaster(data, 1);
+        singleThreaded->SetTransferFunctionTable(table);
+        std::vector<glm::vec4> reference;
+        singleThreaded->Render(params, reference);
+        FWLIB_CHECK(reference.size() == static_cast<std::size_t>(params.imageSize.x) * params.imageSize.y);
+
+        // with identity matrices the unit cube covers the center half of the image and rays run along z.
+        FWLIB_CHECK(reference[0] == params.backgroundColor);
+        auto pixel = glm::uvec2(18, 14);
+        auto ndc = 2.0f * (glm::vec2(pixel) + glm::vec2(0.5f)) / glm::vec2(params.imageSize) - glm::vec2(1.0f);
+        auto texCoords = ndc + glm::vec2(0.5f);
+        auto expected = singleThreaded->CastRay(glm::vec3(texCoords, 0.0f), glm::vec3(texCoords, 1.0f), singleThreaded->GetStepSize(0), 0.0f);
+        FWLIB_CHECK(IsClose(reference[pixel.y * params.imageSize.x + pixel.x], expected, 1e-4f));
+
+        // the image does not depend on the number of threads or the tile size.
+        auto multiThreaded = CreateRayCaster(data, 3);
+        multiThreaded->SetTransferFunctionTable(table);
+        for (auto tileSize : { 1u, 7u, 64u }) {
+            params.tileSize = tileSize;
+            std::vector<glm::vec4> image;
+            multiThreaded->Render(params, image);
+            FWLIB_CHECK(image == reference);
+        }
+
+        // images can be compared with the Image2DStatistics metrics, a finer step size changes the image slightly.
+        std::vector<uint8_t> referenceRGBA8, fineRGBA8;
+        CPURayCaster::ConvertToRGBA8(reference, referenceRGBA8);
+        FWLIB_CHECK(referenceRGBA8.size() == reference.size() * 4);
+        auto identical = eval::Image2DStatistics::CompareImageData(referenceRGBA8, referenceRGBA8);
+        FWLIB_CHECK(identical.numErrorPixels_ == 0.0f && identical.errorMax_ == 0.0f);
+
+        params.stepSize = singleThreaded->GetStepSize(0) * 0.5f;
+        std::vector<glm::vec4> fine;
+        singleThreaded->Render(params, fine);
+        CPURayCaster::ConvertToRGBA8(fine, fineRGBA8);
+        auto difference = eval::Image2DStatistics::CompareImageData(referenceRGBA8, fineRGBA8);
+        FWLIB_CHECK(difference.numErrorPixels_ > 0.0f && difference.errorMax_ < 0.1f && difference.psnrAvgAll_ > 30.0f);
+    }
+}
+
+int main(int, char**)
+{
+    TestSampling();
+    TestTransferFunctionLookup();
+    TestCompositing();
+    TestRender();
+    return test::Finish("CPURayCasterTest");
+}
@@ -0,0 +1,124 @@
+/**
+ * @file   CompressedVolumeTest.cpp
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Tests compressing volumes, converting dat files and reading dat files.
+ */
+
+#include "TestHelper.h"
+#include "VolumeDataReference.h"
+#include "gfx/volumes/CompressedVolume.h"
+#include "gfx/volumes/VolumeDatFile.h"
+#include <cmath>
+#include <fstream>
+
+using namespace cgu;
+
+namespace {
+
+    void WriteFile(const std::string& filename, const uint8_t* data, std::size_t size)
+    {
+        std::ofstream ofs(filename, std::ios::binary | std::ios::trunc);
+        ofs.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+    }
+
+    void TestLossless(const test::TemporaryDirectory& dir, GLenum type, unsigned int numComponents)
+    {
+        test::VolumeTestData volume(glm::uvec3(37, 19, 23), type, numComponents);
+        VolumeCompressionParameters parameters;
+        parameters.blockSize = glm::uvec3(16, 8, 8);
+        auto filename = dir.GetFile("lossless.cvol");
+        CompressedVolume::CreateFromView(filename, volume.view, parameters);
+
+        CompressedVolume compressed(filename);
+        FWLIB_CHECK(compressed.Decode(2) == volume.data);
+    }
+
+    void TestQuantizedFloats(const test::TemporaryDirectory& dir)
+    {
+        const unsigned int quantizationBits = 12;
+        test::VolumeTestData volume(glm::uvec3(16, 8, 4), GL_FLOAT, 1);
+        auto values = reinterpret_cast<float*>(volume.data.data());
+        values[0] = std::numeric_limits<float>::max();
+        values[1] = -std::numeric_limits<float>::max();
+        values[2] = std::numeric_limits<float>::infinity();
+        values[3] = 0.0f;
+        values[4] = std::numeric_limits<float>::denorm_min();
+
+        VolumeCompressionParameters parameters;
+        parameters.mode = VolumeCompressionMode::QUANTIZED;
+        parameters.quantizationBits = quantizationBits;
+        auto filename = dir.GetFile("quantized.cvol");
+        CompressedVolume::CreateFromView(filename, volume.view, parameters);
+
+        auto decoded = CompressedVolume(filename).Decode();
+        auto decodedValues = reinterpret_cast<const float*>(decoded.data());
+        FWLIB_CHECK(std::isfinite(decodedValues[0]) && std::isfinite(decodedValues[1]));
+        FWLIB_CHECK(std::isinf(decodedValues[2]));
+        FWLIB_CHECK(decodedValues[3] == 0.0f);
+
+        auto maxRelativeError = 0.0f;
+        for (uint64_t i = 5; i < volume.view.GetNumVoxels(); ++i) {
+            if (values[i] == 0.0f) continue;
+            maxRelativeError = glm::max(maxRelativeError, glm::abs(decodedValues[i] - values[i]) / glm::abs(values[i]));
+        }
+        FWLIB_CHECK(maxRelativeError <= std::ldexp(1.0f, static_cast<int>(quantizationBits) - 24));
+    }
+
+    void TestConvertDatFile(const test::TemporaryDirectory& dir)
+    {
+        // 12 bit data stored with a header and two padding bytes after each voxel.
+        const uint64_t dataOffset = 6;
+        test::VolumeTestData volume(glm::uvec3(9, 7, 5), GL_UNSIGNED_SHORT, 2, 16, 2);
+        std::vector<uint8_t> rawFile(dataOffset, 0xAB);
+        rawFile.insert(rawFile.end(), volume.data.begin(), volume.data.end());
+        WriteFile(dir.GetFile("volume.raw"), rawFile.data(), rawFile.size());
+        {
+            std::ofstream dat(dir.GetFile("volume.dat"));
+            dat << "ObjectFileName:\tvolume.raw\nResolution:\t9 7 5\nSliceThickness:\t1 2 0.5\nFormat:\tUSHORT_12\n"
+                << "ObjectModel:\tRG\nDataOffset:\t" << dataOffset << "\nVoxelStride:\t6\n";
+        }
+
+        VolumeDatFile datContent;
+        FWLIB_CHECK(datContent.Read(dir.GetFile("volume.dat")));
+        VolumeDataView layout;
+        FWLIB_CHECK(datContent.GetLayout(layout));
+        FWLIB_CHECK(layout.size == volume.view.size && layout.type == GL_UNSIGNED_SHORT && layout.scaleValue == 16);
+        FWLIB_CHECK(layout.numComponents == 2 && layout.bytesPerVoxel == 4 && layout.voxelStride == 6);
+        FWLIB_CHECK(datContent.dataOffset == dataOffset && datContent.sliceThickness == glm::vec3(1.0f, 2.0f, 0.5f));
+
+        auto cvolFilename = CompressedVolume::ConvertDatFile(dir.GetFile("volume.dat"), dir.GetFile("compressed.dat"), VolumeCompressionParameters());
+        FWLIB_CHECK(boost::filesystem::path(cvolFilename).filename() == "compressed.cvol");
+
+        VolumeDatFile compressedDat;
+        FWLIB_CHECK(compressedDat.Read(dir.GetFile("compressed.dat")));
+        FWLIB_CHECK(compressedDat.rawFile == "compressed.cvol");
+        FWLIB_CHECK(compressedDat.dataOffset == 0 && compressedDat.voxelStride == 0);
+        FWLIB_CHECK(compressedDat.format == "USHORT_12" && compressedDat.resolution == volume.view.size);
+
+        auto decoded = CompressedVolume(cvolFilename).Decode();
+        FWLIB_CHECK(decoded == test::GatherVoxels(volume.view));
+
+        VolumeDatFile invalidDat;
+        FWLIB_CHECK(!invalidDat.Read(dir.GetFile("missing.dat")));
+        invalidDat.rawFile = "volume.raw";
+        invalidDat.resolution = glm::uvec3(1);
+        invalidDat.format = "DOUBLE";
+        invalidDat.objectModel = "I";
+        FWLIB_CHECK(!invalidDat.GetLayout(layout));
+    }
+}
+
+int main(int, char**)
+{
+    test::TemporaryDirectory dir;
+    const GLenum types[] = { GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT, GL_UNSIGNED_INT, GL_FLOAT };
+    for (auto type : types) {
+        TestLossless(dir, type, 1);
+        TestLossless(dir, type, 3);
+    }
+    TestQuantizedFloats(dir);
+    TestConvertDatFile(dir);
+    return test::Finish("CompressedVolumeTest");
+}
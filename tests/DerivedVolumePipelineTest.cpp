@@ -0,0 +1,134 @@
+/**
+ * @file   DerivedVolumePipelineTest.cpp
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Tests the slab wise derived volume pipeline against computing the whole volume at once.
+ */
+
+#include "TestHelper.h"
+#include "VolumeDataReference.h"
+#include "gfx/volumes/DerivedVolumePipeline.h"
+#include <atomic>
+#include <sstream>
+
+using namespace cgu;
+
+namespace {
+
+    const glm::uvec3 volumeSize(13, 7, 11);
+
+    /** Sums the voxels of the 3x3x3 neighborhood (clamped to the volume). */
+    uint16_t BoxSum(const std::function<uint8_t(const glm::ivec3&)>& voxel, const glm::ivec3& pos)
+    {
+        uint16_t sum = 0;
+        for (int dz = -1; dz <= 1; ++dz) for (int dy = -1; dy <= 1; ++dy) for (int dx = -1; dx <= 1; ++dx) sum += voxel(pos + glm::ivec3(dx, dy, dz));
+        return sum;
+    }
+
+    std::vector<uint16_t> ComputeReference(const VolumeDataView& view)
+    {
+        std::vector<uint16_t> result;
+        auto voxel = [&view](const glm::ivec3& pos)
+        {
+            auto p = glm::clamp(pos, glm::ivec3(0), glm::ivec3(view.size) - glm::ivec3(1));
+            return *view.GetVoxel(glm::uvec3(p));
+        };
+        for (unsigned int z = 0; z < view.size.z; ++z) for (unsigned int y = 0; y < view.size.y; ++y) for (unsigned int x = 0; x < view.size.x; ++x) {
+            result.push_back(BoxSum(voxel, glm::ivec3(x, y, z)));
+        }
+        return result;
+    }
+
+    void TestStencil(unsigned int slabDepth, unsigned int numThreads)
+    {
+        test::VolumeTestData volume(volumeSize, GL_UNSIGNED_BYTE, 1);
+        auto reference = ComputeReference(volume.view);
+
+        DerivedVolumePipeline pipeline(volume.view, sizeof(uint16_t));
+        pipeline.SetHalo(1);
+        pipeline.SetSlabDepth(slabDepth);
+        pipeline.SetNumThreads(numThreads);
+
+        std::vector<uint16_t> result;
+        auto maxChunkSize = static_cast<uint64_t>(0);
+        pipeline.Run(DerivedVolumePipeline::StencilKernel<uint16_t>([](const VolumeSlab& slab, const glm::ivec3& pos)
+        {
+            return BoxSum([&slab](const glm::ivec3& p) { return slab.Get<uint8_t>(p); }, pos);
+        }), [&result, &maxChunkSize](const uint8_t* data, uint64_t size)
+        {
+            auto values = reinterpret_cast<const uint16_t*>(data);
+            result.insert(result.end(), values, values + size / sizeof(uint16_t));
+            maxChunkSize = glm::max(maxChunkSize, size);
+        });
+
+        FWLIB_CHECK(result == reference);
+        if (slabDepth != 0) FWLIB_CHECK(maxChunkSize <= static_cast<uint64_t>(slabDepth) * volumeSize.x * volumeSize.y * sizeof(uint16_t));
+    }
+
+    void TestVoxelKernelToStream()
+    {
+        test::VolumeTestData volume(volumeSize, GL_UNSIGNED_BYTE, 4);
+        DerivedVolumePipeline pipeline(volume.view, 1);
+        pipeline.SetSlabDepth(3);
+
+        std::stringstream output;
+        pipeline.Run(DerivedVolumePipeline::VoxelKernel<glm::u8vec4, uint8_t>([](const glm::u8vec4& val)
+        {
+            return static_cast<uint8_t>(glm::max(glm::max(val.x, val.y), glm::max(val.z, val.w)));
+        }), output);
+
+        auto data = output.str();
+        FWLIB_CHECK(data.size() == volume.view.GetNumVoxels());
+        auto numMismatches = 0;
+        for (uint64_t v = 0; v < volume.view.GetNumVoxels(); ++v) {
+            auto voxel = volume.view.GetVoxel(v);
+            auto expected = glm::max(glm::max(voxel[0], voxel[1]), glm::max(voxel[2], voxel[3]));
+            if (static_cast<uint8_t>(data[static_cast<std::size_t>(v)]) != expected) ++numMismatches;
+        }
+        FWLIB_CHECK(numMismatches == 0);
+    }
+
+    void TestGenerator()
+    {
+        DerivedVolumePipeline pipeline(volumeSize, sizeof(uint32_t));
+        pipeline.SetSlabDepth(4);
+
+        std::vector<uint32_t> result;
+        std::atomic<int> numSlabsWithData(0);
+        pipeline.Run(DerivedVolumePipeline::StencilKernel<uint32_t>([&numSlabsWithData](const VolumeSlab& slab, const glm::ivec3& pos)
+        {
+            if (slab.HasData() || slab.GetVoxel(pos) != nullptr) ++numSlabsWithData;
+            return static_cast<uint32_t>((pos.z * 100 + pos.y) * 100 + pos.x);
+        }), [&result](const uint8_t* data, uint64_t size)
+        {
+            auto values = reinterpret_cast<const uint32_t*>(data);
+            result.insert(result.end(), values, values + size / sizeof(uint32_t));
+        });
+
+        FWLIB_CHECK(numSlabsWithData == 0);
+        FWLIB_CHECK(result.size() == static_cast<std::size_t>(volumeSize.x) * volumeSize.y * volumeSize.z);
+        FWLIB_CHECK(result.back() == ((volumeSize.z - 1) * 100 + volumeSize.y - 1) * 100 + volumeSize.x - 1);
+        FWLIB_CHECK(result[volumeSize.x * volumeSize.y + 2] == 10002);
+    }
+
+    void TestSinkErrors()
+    {
+        test::VolumeTestData volume(volumeSize, GL_UNSIGNED_BYTE, 1);
+        DerivedVolumePipeline pipeline(volume.view, 1);
+        pipeline.SetSlabDepth(2);
+        auto kernel = DerivedVolumePipeline::VoxelKernel<uint8_t, uint8_t>([](uint8_t val) { return val; });
+        FWLIB_CHECK_THROWS(pipeline.Run(kernel, [](const uint8_t*, uint64_t) { throw std::runtime_error("Disk full."); }), std::runtime_error);
+    }
+}
+
+int main(int, char**)
+{
+    for (auto slabDepth : { 0u, 1u, 2u, 5u, 11u }) {
+        for (auto numThreads : { 1u, 3u }) TestStencil(slabDepth, numThreads);
+    }
+    TestVoxelKernelToStream();
+    TestGenerator();
+    TestSinkErrors();
+    return test::Finish("DerivedVolumePipelineTest");
+}
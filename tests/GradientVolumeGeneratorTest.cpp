@@ -0,0 +1,173 @@
+/**
+ * @file   GradientVolumeGeneratorTest.cpp
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Tests the row wise gradient generator against the voxel by voxel reference and the gradient cache.
+ */
+
+#include "TestHelper.h"
+#include "VolumeDataReference.h"
+#include "gfx/volumes/GradientVolumeGenerator.h"
+#include "core/parallel_helper.h"
+#include <fstream>
+#include <sstream>
+
+using namespace cgu;
+
+namespace {
+
+    const GradientStencil stencils[] = { GradientStencil::CENTRAL_DIFFERENCE, GradientStencil::SOBEL };
+    const GradientEncoding encodings[] = { GradientEncoding::RGB8, GradientEncoding::RGB10A2, GradientEncoding::OCTAHEDRAL16 };
+
+    /** Random volume data with padding after each voxel that starts at an offset into its buffer. */
+    struct OffsetVolumeData
+    {
+        OffsetVolumeData(const glm::uvec3& size, GLenum type, unsigned int scaleValue, unsigned int paddingBytes, std::size_t offset) :
+            volume(size, type, 1, scaleValue, paddingBytes)
+        {
+            data.resize(offset);
+            data.insert(data.end(), volume.data.begin(), volume.data.end());
+            view = volume.view;
+            view.data = data.data() + offset;
+        }
+
+        /** Holds the random volume. */
+        test::VolumeTestData volume;
+        /** Holds the volume data after the offset. */
+        std::vector<uint8_t> data;
+        /** Holds the view on the data at the offset. */
+        VolumeDataView view;
+    };
+
+    void TestAgainstReference(GLenum type, unsigned int scaleValue)
+    {
+        // a non-cubic size with sizes that are not a multiple of any vector width, the components stay aligned.
+        OffsetVolumeData source(glm::uvec3(13, 6, 9), type, scaleValue, 4, 12);
+        auto packedData = test::GatherVoxels(source.view);
+        auto packedView = source.view;
+        packedView.voxelStride = packedView.bytesPerVoxel;
+        packedView.data = packedData.data();
+
+        for (auto stencil : stencils) {
+            for (auto encoding : encodings) {
+                GradientVolumeGenerator generator(stencil, encoding);
+                std::vector<uint8_t> reference;
+                generator.GenerateReference(source.view, reference);
+                FWLIB_CHECK(reference.size() == source.view.GetNumVoxels() * generator.GetBytesPerVoxel());
+
+                std::vector<uint8_t> packedReference;
+                generator.GenerateReference(packedView, packedReference);
+                FWLIB_CHECK(packedReference == reference);
+
+                for (auto numThreads : { 1u, parallel::GetNumThreads() }) {
+                    std::vector<uint8_t> result;
+                    generator.Generate(source.view, result, numThreads);
+                    FWLIB_CHECK(result == reference);
+
+                    std::stringstream stream;
+                    generator.Generate(source.view, stream, numThreads);
+                    FWLIB_CHECK(stream.str() == std::string(reference.begin(), reference.end()));
+                }
+            }
+        }
+    }
+
+    void TestRamp()
+    {
+        // values rising along x: the normalized gradient inside is (1 / (size.x - 1), 0, 0) for both stencils.
+        const glm::uvec3 size(11, 5, 4);
+        std::vector<float> values(size.x * size.y * size.z);
+        for (std::size_t i = 0; i < values.size(); ++i) values[i] = 0.5f * static_cast<float>(i % size.x);
+        VolumeDataView view;
+        view.data = reinterpret_cast<const uint8_t*>(values.data());
+        view.size = size;
+        view.type = GL_FLOAT;
+        view.bytesPerVoxel = sizeof(float);
+        view.voxelStride = sizeof(float);
+
+        const glm::vec3 expected(1.0f / static_cast<float>(size.x - 1), 0.0f, 0.0f);
+        const float tolerances[] = { 1.0f / 255.0f, 1.0f / 1023.0f, 1.0f / 4096.0f };
+        for (auto stencil : stencils) {
+            for (auto e = 0U; e < 3; ++e) {
+                GradientVolumeGenerator generator(stencil, encodings[e]);
+                std::vector<uint8_t> result;
+                generator.Generate(view, result);
+                auto maxError = 0.0f;
+                for (unsigned int z = 0; z < size.z; ++z) for (unsigned int y = 0; y < size.y; ++y) for (unsigned int x = 1; x < size.x - 1; ++x) {
+                    auto idx = view.GetIndex(glm::uvec3(x, y, z));
+                    auto gradient = generator.Decode(result.data() + idx * generator.GetBytesPerVoxel());
+                    maxError = glm::max(maxError, glm::max(glm::abs(gradient.x - expected.x), glm::max(glm::abs(gradient.y), glm::abs(gradient.z))));
+                    maxError = glm::max(maxError, glm::abs(gradient.w - expected.x));
+                }
+                FWLIB_CHECK(maxError <= tolerances[e]);
+            }
+        }
+
+        // only single channel volumes have gradients.
+        auto multiChannel = test::VolumeTestData(size, GL_UNSIGNED_BYTE, 2).view;
+        GradientVolumeGenerator generator(GradientStencil::SOBEL, GradientEncoding::RGB8);
+        std::vector<uint8_t> result;
+        FWLIB_CHECK_THROWS(generator.Generate(multiChannel, result), std::runtime_error);
+        FWLIB_CHECK_THROWS(generator.GenerateReference(multiChannel, result), std::runtime_error);
+    }
+
+    void TestCache(const test::TemporaryDirectory& dir)
+    {
+        // the raw file has a header and padding after each voxel like the ones of strided dat files.
+        const std::size_t offset = 10;
+        OffsetVolumeData source(glm::uvec3(10, 7, 12), GL_UNSIGNED_SHORT, 16, 2, offset);
+        auto rawFilename = dir.GetFile("volume.raw");
+        {
+            std::ofstream ofs(rawFilename, std::ios::binary | std::ios::trunc);
+            ofs.write(reinterpret_cast<const char*>(source.data.data()), static_cast<std::streamsize>(source.data.size()));
+        }
+        auto layout = source.view;
+        layout.data = nullptr;
+
+        auto numLoaded = 0U;
+        auto loadRawData = [&numLoaded, &rawFilename, &layout, offset]()
+        {
+            ++numLoaded;
+            return std::make_unique<RawVolumeSource>(rawFilename, offset, layout);
+        };
+
+        for (auto encoding : encodings) {
+            GradientVolumeGenerator generator(GradientStencil::SOBEL, encoding);
+            std::vector<uint8_t> reference;
+            generator.GenerateReference(source.view, reference);
+            auto cacheFilename = dir.GetFile("volume_gradient" + std::to_string(static_cast<int>(encoding)) + ".cache");
+
+            numLoaded = 0;
+            auto generated = generator.LoadGradientData(cacheFilename, 42, source.view.size, loadRawData);
+            FWLIB_CHECK(numLoaded == 1 && generated == reference);
+            auto cached = generator.LoadGradientData(cacheFilename, 42, source.view.size, loadRawData);
+            FWLIB_CHECK(numLoaded == 1 && cached == reference);
+
+            // other data or another stencil do not use the cache and overwrite it.
+            FWLIB_CHECK(generator.LoadGradientData(cacheFilename, 43, source.view.size, loadRawData) == reference && numLoaded == 2);
+            FWLIB_CHECK(generator.LoadGradientData(cacheFilename, 42, source.view.size, loadRawData) == reference && numLoaded == 3);
+            GradientVolumeGenerator centralGenerator(GradientStencil::CENTRAL_DIFFERENCE, encoding);
+            std::vector<uint8_t> centralReference;
+            centralGenerator.GenerateReference(source.view, centralReference);
+            FWLIB_CHECK(centralGenerator.LoadGradientData(cacheFilename, 42, source.view.size, loadRawData) == centralReference && numLoaded == 4);
+            FWLIB_CHECK(centralGenerator.LoadGradientData(cacheFilename, 42, source.view.size, loadRawData) == centralReference && numLoaded == 4);
+
+            // a truncated cache is generated again.
+            boost::filesystem::resize_file(cacheFilename, boost::filesystem::file_size(cacheFilename) - 5);
+            FWLIB_CHECK(centralGenerator.LoadGradientData(cacheFilename, 42, source.view.size, loadRawData) == centralReference && numLoaded == 5);
+            FWLIB_CHECK(centralGenerator.LoadGradientData(cacheFilename, 42, source.view.size, loadRawData) == centralReference && numLoaded == 5);
+        }
+    }
+}
+
+int main(int, char**)
+{
+    TestAgainstReference(GL_UNSIGNED_BYTE, 1);
+    TestAgainstReference(GL_UNSIGNED_SHORT, 16);
+    TestAgainstReference(GL_FLOAT, 1);
+    TestRamp();
+    test::TemporaryDirectory dir;
+    TestCache(dir);
+    return test::Finish("GradientVolumeGeneratorTest");
+}
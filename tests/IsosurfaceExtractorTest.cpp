@@ -0,0 +1,265 @@
+/**
+ * @file   IsosurfaceExtractorTest.cpp
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Tests the isosurface extractor on analytic fields (spheres and tori).
+ */
+
+#include "TestHelper.h"
+#include "VolumeDataReference.h"
+#include "gfx/volumes/IsosurfaceExtractor.h"
+#include <cmath>
+#include <map>
+
+using namespace cgu;
+
+namespace {
+
+    const glm::uvec3 volumeSize(32, 30, 34);
+    const glm::vec3 center(15.3f, 14.6f, 16.7f);
+
+    /** A field decreasing with the distance to the center, the sphere of radius r is the isosurface 1 - r / 16. */
+    float SphereField(const glm::vec3& p) { return 1.0f - glm::length(p - center) / 16.0f; }
+
+    /** A field decreasing with the distance to a ring of radius 9 around the z axis through the center. */
+    float TorusField(const glm::vec3& p)
+    {
+        auto d = p - center;
+        auto ringDistance = std::sqrt(d.x * d.x + d.y * d.y) - 9.0f;
+        return 1.0f - std::sqrt(ringDistance * ringDistance + d.z * d.z) / 16.0f;
+    }
+
+    /** Returns the slice function sampling a field at the voxel positions. */
+    IsosurfaceExtractor::SliceFunction SampleField(float(*field)(const glm::vec3&), const glm::uvec3& size)
+    {
+        return [field, size](unsigned int firstSlice, unsigned int numSlices, float* data)
+        {
+            for (auto z = firstSlice; z < firstSlice + numSlices; ++z) for (auto y = 0U; y < size.y; ++y) for (auto x = 0U; x < size.x; ++x) {
+                *data++ = field(glm::vec3(x, y, z));
+            }
+        };
+    }
+
+    /** The edges of a triangle mesh. */
+    struct EdgeStatistics
+    {
+        /** Holds the number of undirected edges. */
+        std::size_t numEdges = 0;
+        /** Holds the number of edges used by a single triangle. */
+        std::size_t numBoundary = 0;
+        /** Holds the number of edges used by more than two triangles. */
+        std::size_t numNonManifold = 0;
+        /** Holds the number of edges used twice in the same direction. */
+        std::size_t numInconsistent = 0;
+    };
+
+    EdgeStatistics CountEdges(const std::vector<unsigned int>& indices)
+    {
+        std::map<std::pair<unsigned int, unsigned int>, glm::uvec2> edges;
+        for (std::size_t i = 0; i < indices.size(); i += 3) {
+            for (auto j = 0U; j < 3; ++j) {
+                auto v0 = indices[i + j], v1 = indices[i + (j + 1) % 3];
+                auto& uses = edges[std::make_pair(glm::min(v0, v1), glm::max(v0, v1))];
+                uses[v0 < v1 ? 0 : 1] += 1;
+            }
+        }
+
+        EdgeStatistics result;
+        result.numEdges = edges.size();
+        for (const auto& edge : edges) {
+            auto uses = edge.second.x + edge.second.y;
+            if (uses == 1) ++result.numBoundary;
+            if (uses > 2) ++result.numNonManifold;
+            if (edge.second.x > 1 || edge.second.y > 1) ++result.numInconsistent;
+        }
+        return result;
+    }
+
+    /** Returns the volume enclosed by a closed, consistently oriented mesh (divergence theorem). */
+    float EnclosedVolume(const IsosurfaceGeometry& geometry)
+    {
+        auto volume = 0.0;
+        for (std::size_t i = 0; i < geometry.indices.size(); i += 3) {
+            auto p0 = geometry.positions[geometry.indices[i]] - center, p1 = geometry.positions[geometry.indices[i + 1]] - center;
+            auto p2 = geometry.positions[geometry.indices[i + 2]] - center;
+            volume += glm::dot(p0, glm::cross(p1, p2)) / 6.0f;
+        }
+        return static_cast<float>(volume);
+    }
+
+    /** Checks that a mesh is closed, manifold, consistently oriented and has the given Euler characteristic. */
+    void CheckClosedSurface(const IsosurfaceGeometry& geometry, int eulerCharacteristic)
+    {
+        FWLIB_CHECK(!geometry.indices.empty() && geometry.indices.size() % 3 == 0);
+        FWLIB_CHECK(geometry.normals.size() == geometry.positions.size());
+        auto edges = CountEdges(geometry.indices);
+        FWLIB_CHECK(edges.numBoundary == 0 && edges.numNonManifold == 0 && edges.numInconsistent == 0);
+
+        auto numVertices = static_cast<int>(geometry.positions.size());
+        auto numTriangles = static_cast<int>(geometry.indices.size() / 3);
+        FWLIB_CHECK(numVertices - static_cast<int>(edges.numEdges) + numTriangles == eulerCharacteristic);
+
+        // the triangles are oriented like the vertex normals.
+        auto numFlipped = 0U;
+        for (std::size_t i = 0; i < geometry.indices.size(); i += 3) {
+            auto p0 = geometry.positions[geometry.indices[i]], p1 = geometry.positions[geometry.indices[i + 1]];
+            auto p2 = geometry.positions[geometry.indices[i + 2]];
+            auto normalSum = geometry.normals[geometry.indices[i]] + geometry.normals[geometry.indices[i + 1]] + geometry.normals[geometry.indices[i + 2]];
+            if (glm::dot(glm::cross(p1 - p0, p2 - p0), normalSum) < 0.0f) ++numFlipped;
+        }
+        FWLIB_CHECK(numFlipped == 0);
+    }
+
+    void TestSphere()
+    {
+        const auto radius = 10.0f;
+        IsosurfaceExtractor extractor(volumeSize, SampleField(SphereField, volumeSize), glm::vec3(1.0f), 8, 4, 3);
+        IsosurfaceGeometry geometry;
+        extractor.Extract(SphereField(center + glm::vec3(radius, 0.0f, 0.0f)), geometry);
+        CheckClosedSurface(geometry, 2);
+
+        // vertices lie on the sphere (up to the interpolation error along the edges), normals point outwards.
+        auto maxRadiusError = 0.0f, minNormalDot = 1.0f;
+        for (std::size_t i = 0; i < geometry.positions.size(); ++i) {
+            auto direction = geometry.positions[i] - center;
+            maxRadiusError = glm::max(maxRadiusError, glm::abs(glm::length(direction) - radius));
+            minNormalDot = glm::min(minNormalDot, glm::dot(geometry.normals[i], glm::normalize(direction)));
+            FWLIB_CHECK(glm::abs(glm::length(geometry.normals[i]) - 1.0f) < 1e-5f);
+        }
+        FWLIB_CHECK(maxRadiusError < 0.05f);
+        FWLIB_CHECK(minNormalDot > 0.99f);
+
+        auto sphereVolume = 4.0f / 3.0f * glm::pi<float>() * radius * radius * radius;
+        FWLIB_CHECK(glm::abs(EnclosedVolume(geometry) - sphereVolume) < 0.01f * sphereVolume);
+    }
+
+    void TestTorus()
+    {
+        const auto tubeRadius = 4.0f;
+        IsosurfaceExtractor extractor(volumeSize, SampleField(TorusField, volumeSize), glm::vec3(1.0f), 16, 8, 2);
+        IsosurfaceGeometry geometry;
+        extractor.Extract(1.0f - tubeRadius / 16.0f, geometry);
+        CheckClosedSurface(geometry, 0);
+
+        auto maxTubeError = 0.0f;
+        for (const auto& position : geometry.positions) {
+            auto d = position - center;
+            auto ringDistance = std::sqrt(d.x * d.x + d.y * d.y) - 9.0f;
+            maxTubeError = glm::max(maxTubeError, glm::abs(std::sqrt(ringDistance * ringDistance + d.z * d.z) - tubeRadius));
+        }
+        FWLIB_CHECK(maxTubeError < 0.1f);
+
+        auto torusVolume = 2.0f * glm::pi<float>() * glm::pi<float>() * 9.0f * tubeRadius * tubeRadius;
+        FWLIB_CHECK(glm::abs(EnclosedVolume(geometry) - torusVolume) < 0.02f * torusVolume);
+    }
+
+    void TestInvariance()
+    {
+        // the result does not depend on the threads or the slab size, the block size only changes the vertex order.
+        auto isovalue = 1.0f - 4.0f / 16.0f;
+        IsosurfaceGeometry reference;
+        IsosurfaceExtractor(volumeSize, SampleField(TorusField, volumeSize), glm::vec3(1.0f), 64, 8, 1).Extract(isovalue, reference);
+        for (auto numThreads : { 2u, 5u }) {
+            for (auto slabSize : { 8u, 24u, 1000u }) {
+                IsosurfaceGeometry geometry;
+                IsosurfaceExtractor(volumeSize, SampleField(TorusField, volumeSize), glm::vec3(1.0f), slabSize, 8, numThreads).Extract(isovalue, geometry);
+                FWLIB_CHECK(geometry.positions == reference.positions && geometry.normals == reference.normals && geometry.indices == reference.indices);
+            }
+        }
+        for (auto blockSize : { 1u, 5u, 64u }) {
+            IsosurfaceGeometry geometry;
+            IsosurfaceExtractor(volumeSize, SampleField(TorusField, volumeSize), glm::vec3(1.0f), 16, blockSize, 3).Extract(isovalue, geometry);
+            FWLIB_CHECK(geometry.positions.size() == reference.positions.size() && geometry.indices.size() == reference.indices.size());
+            CheckClosedSurface(geometry, 0);
+        }
+
+        // voxel scaling scales the positions.
+        const glm::vec3 scale(0.5f, 1.0f, 2.0f);
+        IsosurfaceGeometry scaled;
+        IsosurfaceExtractor(volumeSize, SampleField(TorusField, volumeSize), scale, 64, 8, 1).Extract(isovalue, scaled);
+        FWLIB_CHECK(scaled.indices == reference.indices);
+        auto maxScaleError = 0.0f;
+        for (std::size_t i = 0; i < scaled.positions.size(); ++i) {
+            maxScaleError = glm::max(maxScaleError, glm::length(scaled.positions[i] - reference.positions[i] * scale));
+        }
+        FWLIB_CHECK(maxScaleError < 1e-5f);
+    }
+
+    void TestBlockSkipping()
+    {
+        // a small sphere at the bottom of a tall volume: only the first slab contains the surface.
+        const glm::uvec3 size(20, 20, 100);
+        unsigned int numSlicesLoaded = 0;
+        auto sampleSphere = SampleField(SphereField, size);
+        IsosurfaceExtractor extractor(size, [&numSlicesLoaded, sampleSphere](unsigned int firstSlice, unsigned int numSlices, float* data)
+        {
+            numSlicesLoaded += numSlices;
+            sampleSphere(firstSlice, numSlices, data);
+        }, glm::vec3(1.0f), 32, 8, 2);
+        FWLIB_CHECK(extractor.GetNumBlocks() == glm::uvec3(3, 3, 13));
+
+        IsosurfaceGeometry geometry;
+        extractor.Extract(SphereField(center + glm::vec3(3.0f, 0.0f, 0.0f)), geometry);
+        CheckClosedSurface(geometry, 2);
+        FWLIB_CHECK(extractor.GetStatistics().numBlocks == 3 * 3 * 13);
+        FWLIB_CHECK(extractor.GetStatistics().numSlabsLoaded == 4 && extractor.GetStatistics().numSlabsSkipped == 0);
+        FWLIB_CHECK(extractor.GetStatistics().numActiveBlocks > 0 && extractor.GetStatistics().numActiveBlocks < 3 * 3 * 4);
+
+        // the block ranges are kept: slabs without the isosurface are not loaded again.
+        numSlicesLoaded = 0;
+        IsosurfaceGeometry second;
+        extractor.Extract(SphereField(center + glm::vec3(3.0f, 0.0f, 0.0f)), second);
+        FWLIB_CHECK(second.positions == geometry.positions && second.indices == geometry.indices);
+        FWLIB_CHECK(extractor.GetStatistics().numSlabsLoaded == 1 && extractor.GetStatistics().numSlabsSkipped == 3);
+        FWLIB_CHECK(numSlicesLoaded == 34);
+
+        // isovalues outside of the value range skip all slabs.
+        numSlicesLoaded = 0;
+        extractor.Extract(2.0f, second);
+        FWLIB_CHECK(second.positions.empty() && second.indices.empty() && numSlicesLoaded == 0);
+        FWLIB_CHECK(extractor.GetStatistics().numActiveBlocks == 0 && extractor.GetStatistics().numSlabsSkipped == 4);
+    }
+
+    void TestRawData()
+    {
+        // raw data is normalized by its maximum like volume textures.
+        const glm::uvec3 size(24, 22, 23);
+        test::VolumeTestData volume(size, GL_UNSIGNED_SHORT, 1);
+        auto values = reinterpret_cast<uint16_t*>(volume.data.data());
+        for (auto z = 0U; z < size.z; ++z) for (auto y = 0U; y < size.y; ++y) for (auto x = 0U; x < size.x; ++x) {
+            *values++ = static_cast<uint16_t>(glm::clamp(SphereField(glm::vec3(x, y, z) + glm::vec3(4.0f)), 0.0f, 1.0f) * 40000.0f);
+        }
+        auto normalized = test::ConvertToNormalizedFloatReference(volume.view);
+        auto sliceVoxels = static_cast<std::size_t>(size.x) * size.y;
+
+        IsosurfaceGeometry geometry, reference;
+        IsosurfaceExtractor(volume.view, glm::vec3(1.0f), 8, 4, 3).Extract(0.5f, geometry);
+        IsosurfaceExtractor(size, [&normalized, sliceVoxels](unsigned int firstSlice, unsigned int numSlices, float* data)
+        {
+            std::copy(normalized.begin() + firstSlice * sliceVoxels, normalized.begin() + (firstSlice + numSlices) * sliceVoxels, data);
+        }, glm::vec3(1.0f), 8, 4, 1).Extract(0.5f, reference);
+        FWLIB_CHECK(geometry.positions == reference.positions && geometry.indices == reference.indices);
+        CheckClosedSurface(geometry, 2);
+
+        // surfaces touching the volume border are open, volumes without cells are empty.
+        IsosurfaceExtractor(volume.view, glm::vec3(1.0f), 8, 4, 2).Extract(0.05f, geometry);
+        FWLIB_CHECK(!geometry.indices.empty() && CountEdges(geometry.indices).numBoundary > 0);
+        IsosurfaceExtractor flat(glm::uvec3(5, 5, 1), SampleField(SphereField, glm::uvec3(5, 5, 1)));
+        flat.Extract(0.5f, geometry);
+        FWLIB_CHECK(flat.GetNumBlocks() == glm::uvec3(0) && geometry.indices.empty());
+
+        test::VolumeTestData twoComponents(size, GL_UNSIGNED_BYTE, 2);
+        FWLIB_CHECK_THROWS(IsosurfaceExtractor(twoComponents.view), std::runtime_error);
+    }
+}
+
+int main(int, char**)
+{
+    TestSphere();
+    TestTorus();
+    TestInvariance();
+    TestBlockSkipping();
+    TestRawData();
+    return test::Finish("IsosurfaceExtractorTest");
+}
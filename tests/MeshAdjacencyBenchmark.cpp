@@ -0,0 +1,78 @@
+/**
+ * @file   MeshAdjacencyBenchmark.cpp
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Measures how creating the vertex adjacencies scales with the mesh size and the threads, and picking vertices
+ *         and growing rings around them.
+ */
+
+#include "TestHelper.h"
+#include "MeshAdjacencyReference.h"
+#include "gfx/mesh/MeshAdjacency.h"
+#include "core/parallel_helper.h"
+#include <random>
+
+using namespace cgu;
+
+int main(int argc, char** argv)
+{
+    // tori of up to maxGridSize x maxGridSize quads, each size doubling the number of triangles.
+    auto maxGridSize = argc > 1 ? static_cast<unsigned int>(std::stoul(argv[1])) : 1024u;
+    std::cout << "Vertex to triangle adjacency (lists per vertex / compressed rows on 1 and " << parallel::GetNumThreads() << " threads):" << std::endl;
+    for (auto gridSize = 64U; gridSize <= maxGridSize; gridSize *= 2) {
+        auto mesh = test::CreateGrid(gridSize, gridSize, true, true);
+        auto numTriangles = static_cast<double>(mesh.triangles.size());
+
+        std::vector<std::vector<unsigned int>> reference;
+        auto referenceTime = test::MeasureSeconds([&]() { reference = test::VertexTrianglesReference(mesh); });
+        std::cout << mesh.triangles.size() << " triangles: lists " << referenceTime * 1000.0 << "ms ("
+            << referenceTime * 1e9 / numTriangles << "ns per triangle)";
+
+        for (auto numThreads : { 1u, parallel::GetNumThreads() }) {
+            std::vector<unsigned int> offsets, vertexTriangles;
+            auto time = test::MeasureSeconds([&]() { meshAdjacency::CreateVertexTriangles(mesh.triangles, mesh.numVertices, offsets, vertexTriangles, numThreads); });
+            auto numDifferent = 0U;
+            for (std::size_t v = 0; v < reference.size(); ++v) {
+                if (reference[v].size() != offsets[v + 1] - offsets[v]
+                    || !std::equal(reference[v].begin(), reference[v].end(), vertexTriangles.begin() + offsets[v])) ++numDifferent;
+            }
+            std::cout << ", rows " << time * 1000.0 << "ms (" << time * 1e9 / numTriangles << "ns per triangle)"
+                << (numDifferent == 0 ? "" : " (results differ!)");
+        }
+        std::cout << std::endl;
+    }
+
+    // pick-and-grow: random picks querying the adjacent vertices and expanding the 3-ring with a reused buffer.
+    auto mesh = test::CreateGrid(maxGridSize / 2, maxGridSize / 2, true, true);
+    auto referenceTriangles = test::VertexTrianglesReference(mesh);
+    std::vector<unsigned int> vertexTriangleOffsets, vertexTriangles, oneRingOffsets, oneRings;
+    meshAdjacency::CreateVertexTriangles(mesh.triangles, mesh.numVertices, vertexTriangleOffsets, vertexTriangles);
+    auto oneRingTime = test::MeasureSeconds([&]() { meshAdjacency::CreateOneRings(mesh.triangles, vertexTriangleOffsets, vertexTriangles, oneRingOffsets, oneRings); });
+    std::cout << "One-rings of " << mesh.numVertices << " vertices: " << oneRingTime * 1000.0 << "ms" << std::endl;
+
+    const unsigned int numPicks = 100000, k = 3;
+    std::vector<unsigned int> picks(numPicks);
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<unsigned int> vertex(0, static_cast<unsigned int>(mesh.numVertices - 1));
+    for (auto& pick : picks) pick = vertex(rng);
+
+    std::size_t referenceSum = 0, oneRingSum = 0, ringSum = 0;
+    auto referenceTime = test::MeasureSeconds([&]() {
+        for (auto pick : picks) for (auto adjVtx : test::AdjacentVerticesReference(mesh, referenceTriangles, pick)) referenceSum += adjVtx;
+    });
+    auto oneRingQueryTime = test::MeasureSeconds([&]() {
+        for (auto pick : picks) for (auto j = oneRingOffsets[pick]; j < oneRingOffsets[pick + 1]; ++j) oneRingSum += oneRings[j];
+    });
+    MeshConnectRingBuffer rings;
+    auto ringTime = test::MeasureSeconds([&]() {
+        for (auto pick : picks) {
+            meshAdjacency::ExpandRings(oneRingOffsets, oneRings, &pick, 1, k, rings);
+            ringSum += rings.vertices_.size();
+        }
+    });
+    std::cout << numPicks << " picks: old adjacent vertices " << referenceTime * 1e6 / numPicks << "us, one-ring "
+        << oneRingQueryTime * 1e6 / numPicks << "us, " << k << "-ring " << ringTime * 1e6 / numPicks << "us per pick ("
+        << ringSum / numPicks << " vertices per " << k << "-ring)" << (referenceSum == oneRingSum ? "" : " (results differ!)") << std::endl;
+    return 0;
+}
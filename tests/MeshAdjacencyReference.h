@@ -0,0 +1,196 @@
+/**
+ * @file   MeshAdjacencyReference.h
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Contains generated connectivity meshes and the serial reference adjacencies used by the mesh tests.
+ */
+
+#ifndef MESHADJACENCYREFERENCE_H
+#define MESHADJACENCYREFERENCE_H
+
+#include "gfx/mesh/ConnectivityMesh.h"
+#include <algorithm>
+#include <map>
+#include <random>
+#include <vector>
+
+namespace cgu {
+
+    namespace test {
+
+        /** Triangles with the location only vertex of each vertex. */
+        struct MeshTestData
+        {
+            /** Holds the number of vertices. */
+            std::size_t numVertices = 0;
+            /** Holds the location only vertex of each vertex. */
+            std::vector<unsigned int> locOnlyVertices;
+            /** Holds the triangles. */
+            std::vector<MeshConnectTriangle> triangles;
+
+            /** Adds a vertex and returns its index. */
+            unsigned int AddVertex(unsigned int locOnlyVertex)
+            {
+                locOnlyVertices.push_back(locOnlyVertex);
+                return static_cast<unsigned int>(numVertices++);
+            }
+            /** Adds a vertex at its own location and returns its index. */
+            unsigned int AddVertex() { return AddVertex(static_cast<unsigned int>(numVertices)); }
+            /** Adds a triangle of three vertices. */
+            void AddTriangle(unsigned int v0, unsigned int v1, unsigned int v2)
+            {
+                std::array<unsigned int, 3> vertices = { { v0, v1, v2 } };
+                std::array<unsigned int, 3> locOnly = { { locOnlyVertices[v0], locOnlyVertices[v1], locOnlyVertices[v2] } };
+                triangles.emplace_back(vertices, locOnly);
+            }
+        };
+
+        /**
+         *  Creates a grid of nx x ny quads split into two triangles each. Wrapped directions get an extra column or
+         *  row of vertices at the location of the first one (like texture seams), so wrapping in both directions
+         *  gives a torus.
+         *  @param nx the number of quads in x direction.
+         *  @param ny the number of quads in y direction.
+         *  @param wrapX whether the grid is closed in x direction.
+         *  @param wrapY whether the grid is closed in y direction.
+         */
+        inline MeshTestData CreateGrid(unsigned int nx, unsigned int ny, bool wrapX, bool wrapY)
+        {
+            MeshTestData mesh;
+            for (auto y = 0U; y <= ny; ++y) {
+                for (auto x = 0U; x <= nx; ++x) {
+                    auto locX = wrapX && x == nx ? 0 : x;
+                    auto locY = wrapY && y == ny ? 0 : y;
+                    mesh.AddVertex(locY * (nx + 1) + locX);
+                }
+            }
+            for (auto y = 0U; y < ny; ++y) {
+                for (auto x = 0U; x < nx; ++x) {
+                    auto i0 = y * (nx + 1) + x, i1 = i0 + 1, i2 = i0 + nx + 1, i3 = i2 + 1;
+                    mesh.AddTriangle(i0, i1, i3);
+                    mesh.AddTriangle(i0, i3, i2);
+                }
+            }
+            return mesh;
+        }
+
+        /**
+         *  Creates random triangles on random vertices, some of them sharing a location or being degenerate.
+         *  @param numVertices the number of vertices.
+         *  @param numTriangles the number of triangles.
+         *  @param seed the random seed.
+         */
+        inline MeshTestData CreateRandomTriangles(unsigned int numVertices, unsigned int numTriangles, unsigned int seed)
+        {
+            std::mt19937 rng(seed);
+            MeshTestData mesh;
+            for (auto v = 0U; v < numVertices; ++v) {
+                // about every fourth vertex shares the location of a lower one.
+                mesh.AddVertex(v > 0 && rng() % 4 == 0 ? mesh.locOnlyVertices[rng() % v] : v);
+            }
+            std::uniform_int_distribution<unsigned int> vertex(0, numVertices - 1);
+            for (auto t = 0U; t < numTriangles; ++t) {
+                auto v0 = vertex(rng), v1 = vertex(rng), v2 = t % 17 == 0 ? v0 : vertex(rng);
+                mesh.AddTriangle(v0, v1, v2);
+            }
+            return mesh;
+        }
+
+        /**
+         *  Returns the triangles of each vertex the way they were collected before the compressed rows: every
+         *  triangle is appended to the list of its vertices and location only vertices if it is not in there yet.
+         *  @param mesh the mesh.
+         */
+        inline std::vector<std::vector<unsigned int>> VertexTrianglesReference(const MeshTestData& mesh)
+        {
+            std::vector<std::vector<unsigned int>> vertexTriangles(mesh.numVertices);
+            for (unsigned int i = 0; i < mesh.triangles.size(); ++i) {
+                const auto& tri = mesh.triangles[i];
+                for (auto j = 0; j < 3; ++j) {
+                    auto& vl = vertexTriangles[tri.locOnlyVtxIds_[j]];
+                    if (std::find(vl.begin(), vl.end(), i) == vl.end()) vl.push_back(i);
+
+                    auto& vg = vertexTriangles[tri.vertex_[j]];
+                    if (std::find(vg.begin(), vg.end(), i) == vg.end()) vg.push_back(i);
+                }
+            }
+            return vertexTriangles;
+        }
+
+        /**
+         *  Returns the half-edges of each undirected edge between location only vertices by a brute force grouping.
+         *  @param mesh the mesh.
+         */
+        inline std::map<std::pair<unsigned int, unsigned int>, std::vector<unsigned int>> EdgesReference(const MeshTestData& mesh)
+        {
+            std::map<std::pair<unsigned int, unsigned int>, std::vector<unsigned int>> edges;
+            for (unsigned int he = 0; he < 3 * mesh.triangles.size(); ++he) {
+                auto v0 = mesh.triangles[he / 3].locOnlyVtxIds_[(he + 1) % 3];
+                auto v1 = mesh.triangles[he / 3].locOnlyVtxIds_[(he + 2) % 3];
+                edges[std::make_pair(std::min(v0, v1), std::max(v0, v1))].push_back(he);
+            }
+            return edges;
+        }
+
+        /**
+         *  Returns the vertices sharing a triangle with a vertex the way GetAdjacentVertices collected them before
+         *  the one-rings were precomputed: in the order of their first occurrence, deduplicated by a linear scan.
+         *  @param mesh the mesh.
+         *  @param vertexTriangles the triangles of each vertex (see VertexTrianglesReference).
+         *  @param vtxId the vertex index.
+         */
+        inline std::vector<size_t> AdjacentVerticesReference(const MeshTestData& mesh, const std::vector<std::vector<unsigned int>>& vertexTriangles, size_t vtxId)
+        {
+            std::vector<size_t> connectedIndices;
+
+            for (auto tIdx : vertexTriangles[vtxId]) {
+                for (auto tVIdx : mesh.triangles[tIdx].vertex_) {
+                    if (tVIdx == vtxId) continue;
+
+                    auto insert = true;
+                    for (auto i = 0U; i < connectedIndices.size(); ++i) {
+                        if (connectedIndices[i] == tVIdx) insert = false;
+                    }
+
+                    if (insert) connectedIndices.push_back(tVIdx);
+                }
+            }
+
+            return connectedIndices;
+        }
+
+        /**
+         *  Returns the k-rings around seed vertices by a breadth first search storing the distance of every vertex.
+         *  @param mesh the mesh.
+         *  @param vertexTriangles the triangles of each vertex (see VertexTrianglesReference).
+         *  @param seeds the seed vertices.
+         *  @param k the number of rings.
+         */
+        inline std::vector<std::vector<unsigned int>> RingsReference(const MeshTestData& mesh, const std::vector<std::vector<unsigned int>>& vertexTriangles,
+            const std::vector<unsigned int>& seeds, unsigned int k)
+        {
+            std::vector<unsigned int> distances(mesh.numVertices, k + 1);
+            std::vector<unsigned int> queue;
+            for (auto seed : seeds) {
+                if (distances[seed] == 0) continue;
+                distances[seed] = 0;
+                queue.push_back(seed);
+            }
+            for (std::size_t i = 0; i < queue.size(); ++i) {
+                if (distances[queue[i]] == k) continue;
+                for (auto adjVtx : AdjacentVerticesReference(mesh, vertexTriangles, queue[i])) {
+                    if (distances[adjVtx] <= k) continue;
+                    distances[adjVtx] = distances[queue[i]] + 1;
+                    queue.push_back(static_cast<unsigned int>(adjVtx));
+                }
+            }
+
+            std::vector<std::vector<unsigned int>> rings(k + 1);
+            for (unsigned int v = 0; v < mesh.numVertices; ++v) if (distances[v] <= k) rings[distances[v]].push_back(v);
+            return rings;
+        }
+    }
+}
+
+#endif // MESHADJACENCYREFERENCE_H
@@ -0,0 +1,261 @@
+/**
+ * @file   MeshAdjacencyTest.cpp
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Tests the adjacencies of connectivity meshes against serial references.
+ */
+
+#include "TestHelper.h"
+#include "MeshAdjacencyReference.h"
+#include "gfx/mesh/MeshAdjacency.h"
+#include <set>
+
+using namespace cgu;
+
+namespace {
+
+    /** Returns whether the compressed rows hold the same triangles as the reference lists. */
+    bool IsEqualToReference(const std::vector<unsigned int>& offsets, const std::vector<unsigned int>& rows,
+        const std::vector<std::vector<unsigned int>>& reference)
+    {
+        if (offsets.size() != reference.size() + 1 || offsets.back() != rows.size()) return false;
+        for (std::size_t v = 0; v < reference.size(); ++v) {
+            // the reference lists are collected in triangle order, so they are ascending as well.
+            if (!std::equal(reference[v].begin(), reference[v].end(), rows.begin() + offsets[v], rows.begin() + offsets[v + 1])) return false;
+            if (reference[v].size() != offsets[v + 1] - offsets[v]) return false;
+        }
+        return true;
+    }
+
+    /** The edges of a mesh and the numbers of each kind of edge. */
+    struct EdgeTestData
+    {
+        /** Creates the edges of a mesh. */
+        EdgeTestData(test::MeshTestData& mesh, unsigned int numThreads = 0)
+        {
+            meshAdjacency::CreateEdges(mesh.triangles, mesh.numVertices, edges, edgeHalfEdges, triangleEdges, numThreads);
+            for (const auto& edge : edges) {
+                if (edge.IsBoundary()) ++numBoundary;
+                if (edge.IsManifold()) ++numManifold;
+                if (edge.IsNonManifold()) ++numNonManifold;
+            }
+        }
+
+        /** Holds the edges. */
+        std::vector<MeshConnectEdge> edges;
+        /** Holds the half-edges of all edges. */
+        std::vector<unsigned int> edgeHalfEdges;
+        /** Holds the edges of each triangle. */
+        std::vector<std::array<unsigned int, 3>> triangleEdges;
+        /** Holds the number of boundary edges. */
+        unsigned int numBoundary = 0;
+        /** Holds the number of manifold edges. */
+        unsigned int numManifold = 0;
+        /** Holds the number of non-manifold edges. */
+        unsigned int numNonManifold = 0;
+    };
+
+    /** Returns whether the edges match the brute force grouping and the triangles are linked along manifold edges. */
+    bool IsEqualToReference(const test::MeshTestData& mesh, const EdgeTestData& data)
+    {
+        auto reference = test::EdgesReference(mesh);
+        if (data.edges.size() != reference.size() || data.edgeHalfEdges.size() != 3 * mesh.triangles.size()) return false;
+        auto edgeIdx = 0U;
+        for (const auto& refEdge : reference) {
+            const auto& edge = data.edges[edgeIdx];
+            if (edge.vertex_[0] != refEdge.first.first || edge.vertex_[1] != refEdge.first.second) return false;
+            if (!std::equal(refEdge.second.begin(), refEdge.second.end(), data.edgeHalfEdges.begin() + edge.firstHalfEdge_)) return false;
+            if (edge.numHalfEdges_ != refEdge.second.size()) return false;
+            // exactly one of the kinds, edges of degenerate triangles are non-manifold.
+            auto degenerate = edge.vertex_[0] == edge.vertex_[1];
+            for (std::size_t i = 1; i < refEdge.second.size(); ++i) degenerate = degenerate || refEdge.second[i] / 3 == refEdge.second[i - 1] / 3;
+            if (edge.IsBoundary() + edge.IsManifold() + edge.IsNonManifold() != 1 || edge.IsNonManifold() != (degenerate || edge.numHalfEdges_ > 2)) return false;
+
+            for (auto he : refEdge.second) {
+                if (data.triangleEdges[he / 3][he % 3] != edgeIdx) return false;
+                auto otherTriangle = edge.IsManifold() ? static_cast<int>((refEdge.second[0] == he ? refEdge.second[1] : refEdge.second[0]) / 3) : -1;
+                if (mesh.triangles[he / 3].neighbors_[he % 3] != otherTriangle) return false;
+            }
+            ++edgeIdx;
+        }
+        return true;
+    }
+
+    void TestVertexTriangles()
+    {
+        test::MeshTestData meshes[] = { test::CreateGrid(20, 20, false, false), test::CreateGrid(20, 20, true, true),
+            test::CreateGrid(7, 3, true, false), test::CreateRandomTriangles(500, 2000, 1), test::MeshTestData() };
+        for (const auto& mesh : meshes) {
+            auto reference = test::VertexTrianglesReference(mesh);
+            for (auto numThreads : { 1u, 3u, 8u }) {
+                std::vector<unsigned int> offsets, vertexTriangles;
+                meshAdjacency::CreateVertexTriangles(mesh.triangles, mesh.numVertices, offsets, vertexTriangles, numThreads);
+                FWLIB_CHECK(IsEqualToReference(offsets, vertexTriangles, reference));
+            }
+        }
+
+        // a vertex welded to another one shares its triangles, a degenerate triangle is listed once per vertex.
+        test::MeshTestData mesh;
+        auto v0 = mesh.AddVertex(), v1 = mesh.AddVertex(), v2 = mesh.AddVertex(), v3 = mesh.AddVertex(v0), v4 = mesh.AddVertex();
+        mesh.AddTriangle(v0, v1, v2);
+        mesh.AddTriangle(v3, v2, v4);
+        mesh.AddTriangle(v1, v1, v4);
+        std::vector<unsigned int> offsets, vertexTriangles;
+        meshAdjacency::CreateVertexTriangles(mesh.triangles, mesh.numVertices, offsets, vertexTriangles);
+        FWLIB_CHECK(offsets == std::vector<unsigned int>({ 0, 2, 4, 6, 7, 9 }));
+        FWLIB_CHECK(vertexTriangles == std::vector<unsigned int>({ 0, 1, 0, 2, 0, 1, 1, 1, 2 }));
+    }
+
+    void TestLargeInput()
+    {
+        // several chunks: the rows do not depend on the threads.
+        auto mesh = test::CreateRandomTriangles(100000, 150000, 2);
+        auto reference = test::VertexTrianglesReference(mesh);
+        for (auto numThreads : { 1u, 4u, 16u }) {
+            std::vector<unsigned int> offsets, vertexTriangles;
+            meshAdjacency::CreateVertexTriangles(mesh.triangles, mesh.numVertices, offsets, vertexTriangles, numThreads);
+            FWLIB_CHECK(IsEqualToReference(offsets, vertexTriangles, reference));
+        }
+    }
+
+    void TestEdgeFixtures()
+    {
+        // a closed torus: 3 edges per quad, all manifold.
+        auto torus = test::CreateGrid(20, 20, true, true);
+        EdgeTestData torusEdges(torus);
+        FWLIB_CHECK(torusEdges.edges.size() == 1200 && torusEdges.numBoundary == 0 && torusEdges.numManifold == 1200 && torusEdges.numNonManifold == 0);
+        FWLIB_CHECK(IsEqualToReference(torus, torusEdges));
+
+        // an open grid: the border is the boundary.
+        auto grid = test::CreateGrid(20, 20, false, false);
+        EdgeTestData gridEdges(grid);
+        FWLIB_CHECK(gridEdges.edges.size() == 1240 && gridEdges.numBoundary == 80 && gridEdges.numManifold == 1160 && gridEdges.numNonManifold == 0);
+        FWLIB_CHECK(IsEqualToReference(grid, gridEdges));
+
+        // a fan of three triangles around one edge.
+        test::MeshTestData fan;
+        for (auto i = 0; i < 5; ++i) fan.AddVertex();
+        for (auto apex : { 2u, 3u, 4u }) fan.AddTriangle(0, 1, apex);
+        EdgeTestData fanEdges(fan);
+        FWLIB_CHECK(fanEdges.edges.size() == 7 && fanEdges.numBoundary == 6 && fanEdges.numManifold == 0 && fanEdges.numNonManifold == 1);
+        FWLIB_CHECK(fanEdges.edges[0].vertex_[0] == 0 && fanEdges.edges[0].vertex_[1] == 1 && fanEdges.edges[0].numHalfEdges_ == 3);
+        FWLIB_CHECK(IsEqualToReference(fan, fanEdges));
+
+        // two triangles and a degenerate one: its edge used twice and its loop are non-manifold.
+        test::MeshTestData degenerate;
+        for (auto i = 0; i < 5; ++i) degenerate.AddVertex();
+        auto welded = degenerate.AddVertex(3);
+        degenerate.AddTriangle(0, 1, 2);
+        degenerate.AddTriangle(2, 1, 3);
+        degenerate.AddTriangle(3, welded, 4);
+        EdgeTestData degenerateEdges(degenerate);
+        FWLIB_CHECK(degenerateEdges.edges.size() == 7 && degenerateEdges.numBoundary == 4 && degenerateEdges.numManifold == 1 && degenerateEdges.numNonManifold == 2);
+        std::array<std::array<int, 3>, 3> neighbors = { { { { 1, -1, -1 } }, { { -1, -1, 0 } }, { { -1, -1, -1 } } } };
+        for (auto t = 0; t < 3; ++t) FWLIB_CHECK(degenerate.triangles[t].neighbors_ == neighbors[t]);
+        FWLIB_CHECK(IsEqualToReference(degenerate, degenerateEdges));
+    }
+
+    void TestEdgesAgainstReference()
+    {
+        auto mesh = test::CreateRandomTriangles(300, 1500, 3);
+        for (auto numThreads : { 1u, 3u, 8u }) FWLIB_CHECK(IsEqualToReference(mesh, EdgeTestData(mesh, numThreads)));
+
+        // several chunks: the edges do not depend on the threads.
+        auto largeMesh = test::CreateRandomTriangles(100000, 150000, 4);
+        for (auto numThreads : { 1u, 4u, 16u }) FWLIB_CHECK(IsEqualToReference(largeMesh, EdgeTestData(largeMesh, numThreads)));
+
+        test::MeshTestData empty;
+        EdgeTestData emptyEdges(empty);
+        FWLIB_CHECK(emptyEdges.edges.empty() && emptyEdges.edgeHalfEdges.empty());
+    }
+
+    /** Creates the vertex triangles and the one-rings of a mesh. */
+    void CreateOneRings(const test::MeshTestData& mesh, std::vector<unsigned int>& offsets, std::vector<unsigned int>& oneRings, unsigned int numThreads = 0)
+    {
+        std::vector<unsigned int> vertexTriangleOffsets, vertexTriangles;
+        meshAdjacency::CreateVertexTriangles(mesh.triangles, mesh.numVertices, vertexTriangleOffsets, vertexTriangles, numThreads);
+        meshAdjacency::CreateOneRings(mesh.triangles, vertexTriangleOffsets, vertexTriangles, offsets, oneRings, numThreads);
+    }
+
+    void TestOneRings()
+    {
+        // the one-rings hold the vertices of the old GetAdjacentVertices, ascending instead of by first occurrence.
+        test::MeshTestData meshes[] = { test::CreateGrid(30, 20, true, false), test::CreateGrid(20, 20, true, true),
+            test::CreateRandomTriangles(500, 2000, 5), test::CreateRandomTriangles(100000, 150000, 6) };
+        for (const auto& mesh : meshes) {
+            auto vertexTriangles = test::VertexTrianglesReference(mesh);
+            std::vector<std::vector<unsigned int>> reference(mesh.numVertices);
+            auto numDifferentLocOnly = 0U;
+            for (std::size_t v = 0; v < mesh.numVertices; ++v) {
+                auto adjacentVertices = test::AdjacentVerticesReference(mesh, vertexTriangles, v);
+                reference[v].assign(adjacentVertices.begin(), adjacentVertices.end());
+                std::sort(reference[v].begin(), reference[v].end());
+
+                // the location only vertices PickHandler collects from the one-ring are those of the triangles.
+                std::set<unsigned int> triangleLocOnly, oneRingLocOnly;
+                auto locOnlyIdx = mesh.locOnlyVertices[v];
+                for (auto tIdx : vertexTriangles[v]) {
+                    for (auto idx : mesh.triangles[tIdx].locOnlyVtxIds_) if (idx != v && idx != locOnlyIdx) triangleLocOnly.insert(idx);
+                }
+                for (auto adjVtx : reference[v]) {
+                    auto idx = mesh.locOnlyVertices[adjVtx];
+                    if (idx != v && idx != locOnlyIdx) oneRingLocOnly.insert(idx);
+                }
+                if (triangleLocOnly != oneRingLocOnly) ++numDifferentLocOnly;
+            }
+            FWLIB_CHECK(numDifferentLocOnly == 0);
+
+            for (auto numThreads : { 1u, 4u, 16u }) {
+                std::vector<unsigned int> offsets, oneRings;
+                CreateOneRings(mesh, offsets, oneRings, numThreads);
+                FWLIB_CHECK(IsEqualToReference(offsets, oneRings, reference));
+            }
+        }
+
+    }
+
+    void TestExpandRings()
+    {
+        auto mesh = test::CreateGrid(40, 30, true, false);
+        auto vertexTriangles = test::VertexTrianglesReference(mesh);
+        std::vector<unsigned int> offsets, oneRings;
+        CreateOneRings(mesh, offsets, oneRings);
+
+        std::vector<std::vector<unsigned int>> seedSets = { { 0 }, { 40 }, { 615 }, { 615, 617, 615, 3 }, { 1270 }, {} };
+        MeshConnectRingBuffer rings;
+        for (const auto& seeds : seedSets) {
+            for (auto k : { 0u, 1u, 3u, 5u }) {
+                auto reference = test::RingsReference(mesh, vertexTriangles, seeds, k);
+                meshAdjacency::ExpandRings(offsets, oneRings, seeds.data(), seeds.size(), k, rings);
+                FWLIB_CHECK(rings.GetNumRings() == k + 1);
+                for (auto ring = 0U; ring <= k; ++ring) {
+                    auto result = rings.GetRing(ring);
+                    FWLIB_CHECK(std::vector<unsigned int>(result.begin(), result.end()) == reference[ring]);
+                }
+            }
+        }
+
+        // a reused buffer does not allocate again, wrapping the visit stamp clears the visited vertices.
+        auto seed = 615U;
+        meshAdjacency::ExpandRings(offsets, oneRings, &seed, 1, 5, rings);
+        auto capacity = rings.vertices_.capacity();
+        auto data = rings.vertices_.data();
+        for (auto i = 0U; i < 100; ++i) meshAdjacency::ExpandRings(offsets, oneRings, &seed, 1, 5, rings);
+        FWLIB_CHECK(rings.vertices_.capacity() == capacity && rings.vertices_.data() == data);
+        rings.visitStamp_ = std::numeric_limits<unsigned int>::max();
+        meshAdjacency::ExpandRings(offsets, oneRings, &seed, 1, 5, rings);
+        FWLIB_CHECK(rings.visitStamp_ == 1 && rings.GetRing(5).size() == test::RingsReference(mesh, vertexTriangles, { seed }, 5)[5].size());
+    }
+}
+
+int main(int, char**)
+{
+    TestVertexTriangles();
+    TestLargeInput();
+    TestEdgeFixtures();
+    TestEdgesAgainstReference();
+    TestOneRings();
+    TestExpandRings();
+    return test::Finish("MeshAdjacencyTest");
+}
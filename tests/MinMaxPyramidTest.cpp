@@ -0,0 +1,196 @@
+/**
+ * @file   MinMaxPyramidTest.cpp
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Tests the levels and step sizes of average and min/max pyramids on small volumes with known values.
+ */
+
+#include "TestHelper.h"
+#include "gfx/volumes/MinMaxPyramid.h"
+#include <fstream>
+
+using namespace cgu;
+
+namespace {
+
+    /** Returns the values of a level stored in the format S. */
+    template<typename S> std::vector<float> LoadLevel(const std::vector<uint8_t>& data)
+    {
+        auto values = reinterpret_cast<const typename S::Type*>(data.data());
+        std::vector<float> result(data.size() / sizeof(typename S::Type));
+        for (std::size_t i = 0; i < result.size(); ++i) result[i] = S::Load(values[i]);
+        return result;
+    }
+
+    /** Returns whether two floats are equal up to the precision of float sums. */
+    bool IsClose(float a, float b) { return glm::abs(a - b) <= 1e-6f; }
+
+    /** Returns whether two pyramids have the same levels and step sizes. */
+    bool IsEqual(const MinMaxPyramid& a, const MinMaxPyramid& b)
+    {
+        if (a.GetFormat() != b.GetFormat() || a.GetNumLevels() != b.GetNumLevels() || a.GetNumMinMaxLevels() != b.GetNumMinMaxLevels()) return false;
+        for (unsigned int lvl = 0; lvl < a.GetNumLevels(); ++lvl) {
+            if (a.GetLevelSize(lvl) != b.GetLevelSize(lvl) || a.GetLevelData(lvl) != b.GetLevelData(lvl)) return false;
+        }
+        for (unsigned int lvl = 0; lvl < a.GetNumMinMaxLevels(); ++lvl) {
+            if (a.GetMinMaxLevelSize(lvl) != b.GetMinMaxLevelSize(lvl) || a.GetMinMaxLevelData(lvl) != b.GetMinMaxLevelData(lvl)) return false;
+        }
+        return a.GetStepSizes() == b.GetStepSizes();
+    }
+
+    /** A constant volume has the same value in all levels, for each storage format. */
+    template<typename S> void TestConstantVolume(VolumeStorageFormat format)
+    {
+        const glm::uvec3 size(4, 4, 4);
+        auto value = S::Load(S::Store(0.25f));
+        std::vector<typename S::Type> level0(64, S::Store(value));
+        MinMaxPyramid pyramid(level0.data(), size, format, MinMaxPyramid::CalcNumLevels(size));
+
+        FWLIB_CHECK(pyramid.GetFormat() == format);
+        FWLIB_CHECK(pyramid.GetNumLevels() == 3);
+        FWLIB_CHECK(pyramid.GetLevelSize(1) == glm::uvec3(2) && pyramid.GetLevelSize(2) == glm::uvec3(1));
+        FWLIB_CHECK(pyramid.GetLevelData(0).empty());
+        for (unsigned int lvl = 1; lvl < pyramid.GetNumLevels(); ++lvl) {
+            auto values = LoadLevel<S>(pyramid.GetLevelData(lvl));
+            FWLIB_CHECK(values.size() == static_cast<std::size_t>(8 >> (3 * (lvl - 1))));
+            for (auto levelValue : values) FWLIB_CHECK(levelValue == value);
+        }
+
+        FWLIB_CHECK(pyramid.GetNumMinMaxLevels() == 1 && pyramid.GetMinMaxLevelSize(0) == glm::uvec3(1));
+        auto minMax = LoadLevel<S>(pyramid.GetMinMaxLevelData(0));
+        FWLIB_CHECK(minMax.size() == 2 && minMax[0] == value && minMax[1] == value);
+
+        // half a voxel of the largest dimension, doubled on each level.
+        const auto& stepSizes = pyramid.GetStepSizes();
+        FWLIB_CHECK(stepSizes.size() == 3 && stepSizes[0] == 0.125f && stepSizes[1] == 0.25f && stepSizes[2] == 0.5f);
+    }
+
+    /** The levels of a non power of two size only read the 2x2x2 neighborhoods the shaders read. */
+    void TestNonPowerOfTwoVolume()
+    {
+        const glm::uvec3 size(3, 1, 1);
+        float level0[] = { 0.0f, 0.3f, 0.9f };
+        MinMaxPyramid pyramid(level0, size, VolumeStorageFormat::FLOAT, MinMaxPyramid::CalcNumLevels(size));
+
+        FWLIB_CHECK(pyramid.GetNumLevels() == 2 && pyramid.GetLevelSize(1) == glm::uvec3(1));
+        // voxels 0 and 1, each read four times (y and z are clamped), voxel 2 is not read.
+        auto level1 = LoadLevel<volumeStorage::Float>(pyramid.GetLevelData(1));
+        FWLIB_CHECK(level1.size() == 1 && IsClose(level1[0], 0.15f));
+
+        // the min/max level reads all voxels of its block.
+        FWLIB_CHECK(pyramid.GetNumMinMaxLevels() == 1 && pyramid.GetMinMaxLevelSize(0) == glm::uvec3(1));
+        auto minMax = LoadLevel<volumeStorage::Float>(pyramid.GetMinMaxLevelData(0));
+        FWLIB_CHECK(minMax.size() == 2 && minMax[0] == 0.0f && minMax[1] == 0.9f);
+
+        const auto& stepSizes = pyramid.GetStepSizes();
+        FWLIB_CHECK(stepSizes.size() == 2 && IsClose(stepSizes[0], 1.0f / 6.0f) && IsClose(stepSizes[1], 1.0f / 3.0f));
+    }
+
+    /** Odd sizes: the read positions are scaled by the ratio of the level sizes and rounded down. */
+    void TestOddVolume()
+    {
+        const glm::uvec3 size(5, 3, 1);
+        std::vector<uint8_t> level0;
+        for (unsigned int y = 0; y < size.y; ++y) for (unsigned int x = 0; x < size.x; ++x) level0.push_back(static_cast<uint8_t>(10 * x + 50 * y));
+        MinMaxPyramid pyramid(level0.data(), size, VolumeStorageFormat::UNORM8, MinMaxPyramid::CalcNumLevels(size));
+
+        FWLIB_CHECK(pyramid.GetNumLevels() == 3);
+        FWLIB_CHECK(pyramid.GetLevelSize(1) == glm::uvec3(2, 1, 1) && pyramid.GetLevelSize(2) == glm::uvec3(1));
+        // level 1 reads x in {0, 1} and {2, 3} (2 * 2.5 rounded down), y in {0, 1}: (0 + 10 + 50 + 60) / 4 and (20 + 30 + 70 + 80) / 4.
+        std::vector<uint8_t> level1 = { 30, 50 };
+        FWLIB_CHECK(pyramid.GetLevelData(1) == level1);
+        std::vector<uint8_t> level2 = { 40 };
+        FWLIB_CHECK(pyramid.GetLevelData(2) == level2);
+
+        // a single min/max voxel covering the whole volume.
+        FWLIB_CHECK(pyramid.GetNumMinMaxLevels() == 1 && pyramid.GetMinMaxLevelSize(0) == glm::uvec3(1));
+        std::vector<uint8_t> minMax = { 0, 140 };
+        FWLIB_CHECK(pyramid.GetMinMaxLevelData(0) == minMax);
+
+        const auto& stepSizes = pyramid.GetStepSizes();
+        FWLIB_CHECK(stepSizes.size() == 3 && IsClose(stepSizes[0], 0.1f) && IsClose(stepSizes[1], 0.2f) && IsClose(stepSizes[2], 0.4f));
+
+        // fewer levels than possible.
+        MinMaxPyramid twoLevels(level0.data(), size, VolumeStorageFormat::UNORM8, 2);
+        FWLIB_CHECK(twoLevels.GetNumLevels() == 2 && twoLevels.GetLevelData(1) == level1 && twoLevels.GetStepSizes().size() == 2);
+    }
+
+    /** Several min/max levels: each voxel of the first one holds the range of a 4x4x4 block. */
+    void TestMinMaxLevels()
+    {
+        const glm::uvec3 size(8, 8, 8);
+        std::vector<uint16_t> level0;
+        for (unsigned int z = 0; z < size.z; ++z) for (unsigned int y = 0; y < size.y; ++y) for (unsigned int x = 0; x < size.x; ++x) {
+            level0.push_back(static_cast<uint16_t>(2 * x + 16 * y + 128 * z));
+        }
+
+        for (auto numThreads : { 1u, 3u, 0u }) {
+            MinMaxPyramid pyramid(level0.data(), size, VolumeStorageFormat::UNORM16, MinMaxPyramid::CalcNumLevels(size), numThreads);
+            FWLIB_CHECK(pyramid.GetNumLevels() == 4);
+
+            // the average of a 2x2x2 block is the value of its first voxel plus (2 + 16 + 128) / 2.
+            auto level1 = reinterpret_cast<const uint16_t*>(pyramid.GetLevelData(1).data());
+            auto numWrong = 0U;
+            for (unsigned int z = 0; z < 4; ++z) for (unsigned int y = 0; y < 4; ++y) for (unsigned int x = 0; x < 4; ++x) {
+                if (level1[(z * 4 + y) * 4 + x] != 4 * x + 32 * y + 256 * z + 73) ++numWrong;
+            }
+            FWLIB_CHECK(numWrong == 0);
+            auto level3 = reinterpret_cast<const uint16_t*>(pyramid.GetLevelData(3).data());
+            FWLIB_CHECK(level3[0] == 511);
+
+            FWLIB_CHECK(pyramid.GetNumMinMaxLevels() == 2);
+            FWLIB_CHECK(pyramid.GetMinMaxLevelSize(0) == glm::uvec3(2) && pyramid.GetMinMaxLevelSize(1) == glm::uvec3(1));
+            auto minMax0 = reinterpret_cast<const uint16_t*>(pyramid.GetMinMaxLevelData(0).data());
+            numWrong = 0;
+            for (unsigned int z = 0; z < 2; ++z) for (unsigned int y = 0; y < 2; ++y) for (unsigned int x = 0; x < 2; ++x) {
+                auto idx = (z * 2 + y) * 2 + x;
+                auto minimum = 8 * x + 64 * y + 512 * z;
+                if (minMax0[2 * idx] != minimum || minMax0[2 * idx + 1] != minimum + 6 + 48 + 384) ++numWrong;
+            }
+            FWLIB_CHECK(numWrong == 0);
+            auto minMax1 = reinterpret_cast<const uint16_t*>(pyramid.GetMinMaxLevelData(1).data());
+            FWLIB_CHECK(minMax1[0] == 0 && minMax1[1] == 1022);
+        }
+    }
+
+    void TestCacheRoundTrip(const test::TemporaryDirectory& dir)
+    {
+        const glm::uvec3 size(7, 5, 3);
+        std::vector<uint16_t> level0;
+        for (unsigned int i = 0; i < size.x * size.y * size.z; ++i) level0.push_back(volumeStorage::Half::Store(static_cast<float>((i * 37) % 101) / 100.0f));
+        MinMaxPyramid pyramid(level0.data(), size, VolumeStorageFormat::HALF, MinMaxPyramid::CalcNumLevels(size));
+
+        auto cacheFilename = dir.GetFile("pyramid_minmax.cache");
+        VolumeCacheKey key(3, 5);
+        pyramid.SaveToCache(cacheFilename, key);
+
+        MinMaxPyramid cached;
+        FWLIB_CHECK(cached.LoadFromCache(cacheFilename, key));
+        FWLIB_CHECK(IsEqual(cached, pyramid));
+        FWLIB_CHECK(!cached.LoadFromCache(cacheFilename, VolumeCacheKey(3, 6)));
+        FWLIB_CHECK(!cached.LoadFromCache(cacheFilename, VolumeCacheKey(4, 5)));
+        FWLIB_CHECK(!cached.LoadFromCache(dir.GetFile("missing_minmax.cache"), key));
+
+        // a truncated file is not loaded and leaves an empty pyramid.
+        auto fileSize = boost::filesystem::file_size(cacheFilename);
+        boost::filesystem::resize_file(cacheFilename, fileSize - 7);
+        FWLIB_CHECK(!cached.LoadFromCache(cacheFilename, key));
+        FWLIB_CHECK(cached.GetNumLevels() == 0 && cached.GetNumMinMaxLevels() == 0 && cached.GetStepSizes().empty());
+    }
+}
+
+int main(int, char**)
+{
+    TestConstantVolume<volumeStorage::Unorm8>(VolumeStorageFormat::UNORM8);
+    TestConstantVolume<volumeStorage::Unorm16>(VolumeStorageFormat::UNORM16);
+    TestConstantVolume<volumeStorage::Half>(VolumeStorageFormat::HALF);
+    TestConstantVolume<volumeStorage::Float>(VolumeStorageFormat::FLOAT);
+    TestNonPowerOfTwoVolume();
+    TestOddVolume();
+    TestMinMaxLevels();
+
+    test::TemporaryDirectory dir;
+    TestCacheRoundTrip(dir);
+    return test::Finish("MinMaxPyramidTest");
+}
@@ -0,0 +1,171 @@
+/**
+ * @file   OccupancyGridTest.cpp
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Tests the classification of the occupancy grid and the cost of incremental updates.
+ */
+
+#include "TestHelper.h"
+#include "gfx/volumes/OccupancyGrid.h"
+#include <algorithm>
+#include <random>
+
+using namespace cgu;
+
+namespace {
+
+    const glm::uvec3 volumeSize(37, 29, 23);
+    const glm::uvec3 cellSize(8, 4, 6);
+    const unsigned int tableSize = 64;
+
+    /** A volume of two blobs on a zero background, so many cells are empty under windowed tables. */
+    std::vector<uint8_t> CreateVolume()
+    {
+        std::vector<uint8_t> data(static_cast<std::size_t>(volumeSize.x) * volumeSize.y * volumeSize.z);
+        std::mt19937 rng(7);
+        for (unsigned int z = 0; z < volumeSize.z; ++z) for (unsigned int y = 0; y < volumeSize.y; ++y) for (unsigned int x = 0; x < volumeSize.x; ++x) {
+            auto p = glm::vec3(x, y, z);
+            auto blob0 = glm::max(0.0f, 1.0f - glm::length(p - glm::vec3(9, 8, 6)) / 7.0f);
+            auto blob1 = glm::max(0.0f, 1.0f - glm::length(p - glm::vec3(28, 20, 16)) / 6.0f) * 0.5f;
+            auto noise = static_cast<float>(rng() % 3) / 255.0f;
+            data[(static_cast<std::size_t>(z) * volumeSize.y + y) * volumeSize.x + x] = static_cast<uint8_t>(glm::min(255.0f, (blob0 + blob1 + noise) * 255.0f));
+        }
+        return data;
+    }
+
+    std::vector<float> CreateTable(float start, float end)
+    {
+        std::vector<float> table(tableSize, 0.0f);
+        for (unsigned int i = 0; i < tableSize; ++i) {
+            auto value = (static_cast<float>(i) + 0.5f) / static_cast<float>(tableSize);
+            if (value >= start && value <= end) table[i] = 0.5f;
+        }
+        return table;
+    }
+
+    /** Returns the opacity of a value like a linearly filtered 1D texture with clamp to edge. */
+    float LookupOpacity(const std::vector<float>& table, float value)
+    {
+        auto coord = value * static_cast<float>(table.size()) - 0.5f;
+        auto base = glm::floor(coord);
+        auto i0 = glm::clamp(static_cast<int>(base), 0, static_cast<int>(table.size()) - 1);
+        auto i1 = glm::clamp(static_cast<int>(base) + 1, 0, static_cast<int>(table.size()) - 1);
+        return glm::mix(table[i0], table[i1], coord - base);
+    }
+
+    /** Checks each cell of level 0 voxel by voxel and each coarser cell against its children. */
+    void CheckClassification(const OccupancyGrid& grid, const std::vector<uint8_t>& data, const std::vector<float>& table)
+    {
+        auto numWrong = 0, numMissed = 0;
+        const auto& levelSize = grid.GetLevelSize(0);
+        for (unsigned int cz = 0; cz < levelSize.z; ++cz) for (unsigned int cy = 0; cy < levelSize.y; ++cy) for (unsigned int cx = 0; cx < levelSize.x; ++cx) {
+            glm::uvec3 cell(cx, cy, cz);
+            auto first = glm::max(glm::ivec3(cell * cellSize) - glm::ivec3(1), glm::ivec3(0));
+            auto last = glm::min(glm::ivec3((cell + glm::uvec3(1)) * cellSize), glm::ivec3(volumeSize) - glm::ivec3(1));
+
+            // a cell is occupied exactly if any table entry the voxel value range can be filtered from is visible.
+            glm::vec2 range(1.0f, 0.0f);
+            for (auto z = first.z; z <= last.z; ++z) for (auto y = first.y; y <= last.y; ++y) for (auto x = first.x; x <= last.x; ++x) {
+                auto value = static_cast<float>(data[(static_cast<std::size_t>(z) * volumeSize.y + y) * volumeSize.x + x]) / 255.0f;
+                range = glm::vec2(glm::min(range.x, value), glm::max(range.y, value));
+            }
+            auto visible = false;
+            for (unsigned int i = 0; i < tableSize && !visible; ++i) {
+                auto entryStart = (static_cast<float>(i) - 0.5f) / static_cast<float>(tableSize);
+                auto entryEnd = (static_cast<float>(i) + 1.5f) / static_cast<float>(tableSize);
+                auto overlaps = (i == 0 || range.y >= entryStart) && (i == tableSize - 1 || range.x < entryEnd);
+                visible = overlaps && table[i] > 0.0f;
+            }
+            if (visible != grid.IsOccupied(0, cell)) ++numWrong;
+
+            // every sample interpolated inside the cell with a non-zero opacity has to lie in an occupied cell.
+            if (!grid.IsOccupied(0, cell)) {
+                for (float value = range.x; value <= range.y; value += 1.0f / 1024.0f) {
+                    if (LookupOpacity(table, value) > 0.0f) ++numMissed;
+                }
+            }
+        }
+        FWLIB_CHECK(numWrong == 0);
+        FWLIB_CHECK(numMissed == 0);
+
+        auto numWrongParents = 0;
+        for (unsigned int lvl = 1; lvl < grid.GetNumLevels(); ++lvl) {
+            const auto& size = grid.GetLevelSize(lvl);
+            const auto& childSize = grid.GetLevelSize(lvl - 1);
+            for (unsigned int z = 0; z < size.z; ++z) for (unsigned int y = 0; y < size.y; ++y) for (unsigned int x = 0; x < size.x; ++x) {
+                auto childOccupied = false;
+                auto childEnd = glm::min(2U * glm::uvec3(x, y, z) + glm::uvec3(2), childSize);
+                for (auto cz = 2 * z; cz < childEnd.z; ++cz) for (auto cy = 2 * y; cy < childEnd.y; ++cy) for (auto cx = 2 * x; cx < childEnd.x; ++cx) {
+                    childOccupied = childOccupied || grid.IsOccupied(lvl - 1, glm::uvec3(cx, cy, cz));
+                }
+                if (childOccupied != grid.IsOccupied(lvl, glm::uvec3(x, y, z))) ++numWrongParents;
+            }
+        }
+        FWLIB_CHECK(numWrongParents == 0);
+    }
+
+    uint64_t GetNumCells(const OccupancyGrid& grid)
+    {
+        uint64_t numCells = 0;
+        for (unsigned int lvl = 0; lvl < grid.GetNumLevels(); ++lvl) numCells += grid.GetOccupancy(lvl).size();
+        return numCells;
+    }
+
+    void TestClassification(unsigned int numThreads)
+    {
+        auto data = CreateVolume();
+        OccupancyGrid grid(data.data(), volumeSize, VolumeStorageFormat::UNORM8, cellSize, numThreads);
+        FWLIB_CHECK(grid.GetLevelSize(0) == (volumeSize + cellSize - glm::uvec3(1)) / cellSize);
+        FWLIB_CHECK(grid.GetLevelSize(grid.GetNumLevels() - 1) == glm::uvec3(1));
+        FWLIB_CHECK(grid.IsOccupied(0, glm::uvec3(0)));
+
+        for (auto window : { glm::vec2(0.3f, 0.6f), glm::vec2(0.9f, 1.0f), glm::vec2(0.0f, 0.02f), glm::vec2(2.0f, 3.0f) }) {
+            auto table = CreateTable(window.x, window.y);
+            grid.SetOpacityTable(table);
+            CheckClassification(grid, data, table);
+        }
+
+        grid.SetOpacityTable(CreateTable(0.3f, 0.6f));
+        const auto& occupancy = grid.GetOccupancy(0);
+        auto numOccupied = std::count(occupancy.begin(), occupancy.end(), static_cast<uint8_t>(255));
+        FWLIB_CHECK(numOccupied > 0 && numOccupied < static_cast<std::ptrdiff_t>(occupancy.size()));
+    }
+
+    void TestIncrementalUpdate()
+    {
+        auto data = CreateVolume();
+        OccupancyGrid grid(data.data(), volumeSize, VolumeStorageFormat::UNORM8, cellSize, 1);
+        auto table = CreateTable(0.2f, 0.4f);
+        FWLIB_CHECK(grid.SetOpacityTable(table));
+        FWLIB_CHECK(grid.GetLastUpdateCount() == GetNumCells(grid));
+
+        // an unchanged visibility does not visit any cells.
+        auto sameVisibility = table;
+        for (auto& opacity : sameVisibility) if (opacity > 0.0f) opacity = 0.9f;
+        FWLIB_CHECK(!grid.SetOpacityTable(sameVisibility));
+        FWLIB_CHECK(grid.GetLastUpdateCount() == 0);
+
+        // moving the window end only visits cells whose ranges overlap the changed entries.
+        table = CreateTable(0.2f, 0.45f);
+        FWLIB_CHECK(grid.SetOpacityTable(table));
+        FWLIB_CHECK(grid.GetLastUpdateCount() > 0 && grid.GetLastUpdateCount() < GetNumCells(grid));
+        CheckClassification(grid, data, table);
+
+        OccupancyGrid rebuilt(data.data(), volumeSize, VolumeStorageFormat::UNORM8, cellSize, 1);
+        rebuilt.SetOpacityTable(table);
+        for (unsigned int lvl = 0; lvl < grid.GetNumLevels(); ++lvl) FWLIB_CHECK(grid.GetOccupancy(lvl) == rebuilt.GetOccupancy(lvl));
+
+        // a different table size is a full update.
+        FWLIB_CHECK(grid.SetOpacityTable(std::vector<float>(tableSize / 2, 1.0f)));
+        FWLIB_CHECK(grid.GetLastUpdateCount() == GetNumCells(grid));
+    }
+}
+
+int main(int, char**)
+{
+    TestClassification(1);
+    TestClassification(3);
+    TestIncrementalUpdate();
+    return test::Finish("OccupancyGridTest");
+}
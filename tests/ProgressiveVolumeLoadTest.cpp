@@ -0,0 +1,175 @@
+/**
+ * @file   ProgressiveVolumeLoadTest.cpp
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Tests the level order, the slab wise upload and the cancellation of progressive volume loads.
+ */
+
+#include "TestHelper.h"
+#include "gfx/volumes/ProgressiveVolumeLoad.h"
+#include <condition_variable>
+#include <thread>
+
+using namespace cgu;
+
+namespace {
+
+    const glm::uvec3 volumeSize(32, 16, 24);
+
+    /** Creates the data of a level with every voxel set to the stride. */
+    VolumeTextureData CreateLevel(unsigned int stride)
+    {
+        VolumeTextureData data;
+        data.size = (volumeSize + glm::uvec3(stride - 1)) / glm::uvec3(stride);
+        data.data.resize(static_cast<std::size_t>(data.size.x) * data.size.y * data.size.z, static_cast<uint8_t>(stride));
+        return data;
+    }
+
+    /** Lets the level function finish one level at a time. */
+    struct LevelGate
+    {
+        void WaitForRelease(unsigned int stride)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this, stride]() { return releasedStride <= stride; });
+        }
+        void Release(unsigned int stride) { { std::lock_guard<std::mutex> lock(mutex); releasedStride = stride; } condition.notify_all(); }
+
+        std::mutex mutex;
+        std::condition_variable condition;
+        unsigned int releasedStride = std::numeric_limits<unsigned int>::max();
+    };
+
+    /** Records the uploads of each level. */
+    class TestSink final : public VolumeUploadSink
+    {
+    public:
+        void BeginUpload(const VolumeTextureData& data) override { beganStrides.push_back(data.data[0]); numSlices = 0; }
+        void UploadSlices(const VolumeTextureData& data, unsigned int firstSlice, unsigned int count) override
+        {
+            if (firstSlice != numSlices || data.data[0] != beganStrides.back()) inOrder = false;
+            numSlices += count;
+        }
+        void EndUpload() override { endedStrides.push_back(beganStrides.back()); }
+
+        std::vector<unsigned int> beganStrides;
+        std::vector<unsigned int> endedStrides;
+        unsigned int numSlices = 0;
+        bool inOrder = true;
+    };
+
+    template<typename F> bool WaitUntil(F condition)
+    {
+        for (auto i = 0; i < 5000; ++i) {
+            if (condition()) return true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return false;
+    }
+
+    void TestLevels()
+    {
+        FWLIB_CHECK(ProgressiveVolumeLoad::CalcCoarseStride(volumeSize, 4) == 8);
+        FWLIB_CHECK(ProgressiveVolumeLoad::CalcCoarseStride(volumeSize, 64) == 1);
+
+        std::vector<unsigned int> callbackStrides;
+        ProgressiveVolumeLoad load(8, [](unsigned int stride, const AsyncVolumeLoad::ProgressFunction&) { return CreateLevel(stride); });
+        load.SetLevelCallback([&callbackStrides](const ProgressiveVolumeLevel& level) { callbackStrides.push_back(level.stride); });
+        FWLIB_CHECK(load.GetNumLevels() == 4);
+        FWLIB_CHECK(load.GetStride(0) == 8 && load.GetStride(3) == 1);
+
+        TestSink sink;
+        FWLIB_CHECK(load.Wait(sink) == VolumeLoadState::FINISHED);
+        FWLIB_CHECK(load.IsFinalLevelLoaded() && load.GetUploadedVersion() == 4);
+        FWLIB_CHECK(sink.endedStrides == std::vector<unsigned int>({ 1 }) && sink.numSlices == volumeSize.z && sink.inOrder);
+        FWLIB_CHECK(callbackStrides == std::vector<unsigned int>({ 1 }));
+        FWLIB_CHECK(load.GetLatestLevel()->data.size == volumeSize);
+        FWLIB_CHECK(!load.Update(sink));
+    }
+
+    void TestSlabUpload()
+    {
+        LevelGate gate;
+        gate.Release(4);
+        std::vector<unsigned int> callbackStrides;
+        auto sliceSize = static_cast<uint64_t>(volumeSize.x) * volumeSize.y / 16;
+        ProgressiveVolumeLoad load(4, [&gate](unsigned int stride, const AsyncVolumeLoad::ProgressFunction&)
+        {
+            gate.WaitForRelease(stride);
+            return CreateLevel(stride);
+        }, sliceSize * 2);
+        load.SetLevelCallback([&callbackStrides](const ProgressiveVolumeLevel& level) { callbackStrides.push_back(level.stride); });
+
+        // without time budget each update uploads a single slab of two slices of the 4x coarser level.
+        TestSink sink;
+        FWLIB_CHECK(WaitUntil([&load]() { return load.GetVersion() == 1; }));
+        auto numUpdates = 0;
+        while (!load.Update(sink, std::chrono::microseconds(0))) ++numUpdates;
+        FWLIB_CHECK(numUpdates == 2 && sink.numSlices == 6 && sink.inOrder);
+        FWLIB_CHECK(callbackStrides == std::vector<unsigned int>({ 4 }) && load.GetUploadedVersion() == 1);
+
+        // a level finished during the upload of another one replaces it, the replaced level is never completed.
+        gate.Release(2);
+        FWLIB_CHECK(WaitUntil([&load]() { return load.GetVersion() == 2; }));
+        FWLIB_CHECK(!load.Update(sink, std::chrono::microseconds(0)));
+        gate.Release(1);
+        FWLIB_CHECK(WaitUntil([&load]() { return load.GetVersion() == 3; }));
+        FWLIB_CHECK(!load.Update(sink, std::chrono::microseconds(0)));
+        FWLIB_CHECK(sink.beganStrides == std::vector<unsigned int>({ 4, 2, 1 }));
+        FWLIB_CHECK(load.Update(sink, std::chrono::seconds(10)));
+        FWLIB_CHECK(sink.endedStrides == std::vector<unsigned int>({ 4, 1 }) && sink.numSlices == volumeSize.z && sink.inOrder);
+        FWLIB_CHECK(callbackStrides == std::vector<unsigned int>({ 4, 1 }));
+        FWLIB_CHECK(load.Wait(sink) == VolumeLoadState::FINISHED);
+    }
+
+    void TestCancelAndFailure()
+    {
+        // canceling from another thread stops the level function at its next progress report.
+        std::atomic<bool> started(false);
+        ProgressiveVolumeLoad canceled(8, [&started](unsigned int stride, const AsyncVolumeLoad::ProgressFunction& reportProgress)
+        {
+            if (stride < 8) {
+                started = true;
+                while (reportProgress(0.5f)) std::this_thread::sleep_for(std::chrono::microseconds(100));
+                return VolumeTextureData();
+            }
+            return CreateLevel(stride);
+        });
+        TestSink sink;
+        FWLIB_CHECK(WaitUntil([&started]() { return started.load(); }));
+        std::thread([&canceled]() { canceled.Cancel(); }).join();
+        FWLIB_CHECK(canceled.Wait(sink) == VolumeLoadState::CANCELED);
+        FWLIB_CHECK(canceled.GetUploadedVersion() == 1 && sink.endedStrides == std::vector<unsigned int>({ 8 }));
+
+        ProgressiveVolumeLoad failed(2, [](unsigned int stride, const AsyncVolumeLoad::ProgressFunction&)
+        {
+            if (stride == 1) throw std::runtime_error("test failure");
+            return CreateLevel(stride);
+        });
+        FWLIB_CHECK(failed.Wait(sink) == VolumeLoadState::FAILED);
+        FWLIB_CHECK(failed.GetError() == "test failure" && failed.GetVersion() == 1);
+    }
+
+    void TestConcurrentUpdates()
+    {
+        // updates run on this thread while levels are finished on the background thread.
+        for (auto i = 0; i < 20; ++i) {
+            ProgressiveVolumeLoad load(16, [](unsigned int stride, const AsyncVolumeLoad::ProgressFunction&) { return CreateLevel(stride); },
+                static_cast<uint64_t>(volumeSize.x) * volumeSize.y);
+            TestSink sink;
+            while (load.GetState() == VolumeLoadState::LOADING) load.Update(sink, std::chrono::microseconds(0));
+            FWLIB_CHECK(load.Wait(sink) == VolumeLoadState::FINISHED);
+            FWLIB_CHECK(sink.endedStrides.back() == 1 && sink.numSlices == volumeSize.z && sink.inOrder);
+        }
+    }
+}
+
+int main(int, char**)
+{
+    TestLevels();
+    TestSlabUpload();
+    TestCancelAndFailure();
+    TestConcurrentUpdates();
+    return test::Finish("ProgressiveVolumeLoadTest");
+}
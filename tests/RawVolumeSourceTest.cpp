@@ -0,0 +1,107 @@
+/**
+ * @file   RawVolumeSourceTest.cpp
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Tests memory mapping raw volume files including sparse files larger than 4GB.
+ */
+
+#include "TestHelper.h"
+#include "gfx/volumes/RawVolumeSource.h"
+#include <fstream>
+
+using namespace cgu;
+
+namespace {
+
+    VolumeDataView CreateLayout(const glm::uvec3& size, unsigned int bytesPerVoxel, uint64_t voxelStride)
+    {
+        VolumeDataView layout;
+        layout.size = size;
+        layout.bytesPerVoxel = bytesPerVoxel;
+        layout.voxelStride = voxelStride;
+        return layout;
+    }
+
+    void WriteFile(const std::string& filename, const std::vector<uint8_t>& data)
+    {
+        std::ofstream ofs(filename, std::ios::binary | std::ios::trunc);
+        ofs.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    }
+
+    void TestOffsetAndStride(const test::TemporaryDirectory& dir)
+    {
+        const uint64_t offset = 7;
+        std::vector<uint8_t> data(offset + 2 * 3 * 4 * 2);
+        for (std::size_t i = 0; i < data.size(); ++i) data[i] = static_cast<uint8_t>(i);
+        auto filename = dir.GetFile("strided.raw");
+        WriteFile(filename, data);
+
+        RawVolumeSource packed(filename, offset, CreateLayout(glm::uvec3(2, 3, 4), 2, 0));
+        const auto& packedView = packed.GetView();
+        FWLIB_CHECK(packedView.voxelStride == 2);
+        FWLIB_CHECK(packed.GetFileSize() == data.size());
+        FWLIB_CHECK(packedView.GetVoxel(glm::uvec3(1, 2, 3))[0] == data[offset + 2 * packedView.GetIndex(glm::uvec3(1, 2, 3))]);
+
+        // every second 2 byte voxel: a volume of 12 voxels spans 11 * 4 + 2 bytes.
+        RawVolumeSource strided(filename, offset, CreateLayout(glm::uvec3(2, 3, 2), 2, 4));
+        const auto& stridedView = strided.GetView();
+        FWLIB_CHECK(stridedView.GetNumBytes() == 11 * 4 + 2);
+        FWLIB_CHECK(stridedView.GetVoxel(glm::uvec3(1, 1, 1))[1] == data[offset + 4 * 9 + 1]);
+    }
+
+    void TestErrors(const test::TemporaryDirectory& dir)
+    {
+        auto filename = dir.GetFile("small.raw");
+        WriteFile(filename, std::vector<uint8_t>(63));
+        FWLIB_CHECK_THROWS(RawVolumeSource(filename, 0, CreateLayout(glm::uvec3(4), 1, 0)), std::runtime_error);
+        FWLIB_CHECK_THROWS(RawVolumeSource(filename, 10, CreateLayout(glm::uvec3(3), 2, 0)), std::runtime_error);
+        FWLIB_CHECK_THROWS(RawVolumeSource(dir.GetFile("missing.raw"), 0, CreateLayout(glm::uvec3(1), 1, 0)), std::runtime_error);
+    }
+
+    void TestSparseLargeFile(const test::TemporaryDirectory& dir)
+    {
+        if (sizeof(void*) < 8) {
+            std::cout << "Skipping files larger than 4GB on a 32 bit system." << std::endl;
+            return;
+        }
+
+        // 1024 x 1024 x 4100 voxels are a little more than 4GB, only the first bytes are written.
+        const glm::uvec3 size(1024, 1024, 4100);
+        const uint64_t offset = 16;
+        auto fileSize = offset + static_cast<uint64_t>(size.x) * size.y * size.z;
+        auto filename = dir.GetFile("sparse.raw");
+        std::vector<uint8_t> header(offset + 4);
+        header[offset] = 42;
+        header[offset + 3] = 17;
+        WriteFile(filename, header);
+
+        boost::system::error_code ec;
+        boost::filesystem::resize_file(filename, fileSize, ec);
+        if (ec) {
+            std::cout << "Skipping sparse file test, could not create a " << fileSize << " byte file." << std::endl;
+            return;
+        }
+
+        RawVolumeSource source(filename, offset, CreateLayout(size, 1, 0));
+        const auto& view = source.GetView();
+        FWLIB_CHECK(source.GetFileSize() == fileSize);
+        FWLIB_CHECK(view.GetNumBytes() > (uint64_t(1) << 32));
+        FWLIB_CHECK(view.GetVoxel(glm::uvec3(0))[0] == 42);
+        FWLIB_CHECK(view.GetVoxel(glm::uvec3(3, 0, 0))[0] == 17);
+        FWLIB_CHECK(view.GetVoxel(size - glm::uvec3(1))[0] == 0);
+        FWLIB_CHECK(view.GetVoxel(size - glm::uvec3(1)) - view.data == static_cast<std::ptrdiff_t>(fileSize - offset - 1));
+
+        // one voxel more than the file holds.
+        FWLIB_CHECK_THROWS(RawVolumeSource(filename, offset + 1, CreateLayout(size, 1, 0)), std::runtime_error);
+    }
+}
+
+int main(int, char**)
+{
+    test::TemporaryDirectory dir;
+    TestOffsetAndStride(dir);
+    TestErrors(dir);
+    TestSparseLargeFile(dir);
+    return test::Finish("RawVolumeSourceTest");
+}
@@ -0,0 +1,220 @@
+/**
+ * @file   SPHCoefficientsTest.cpp
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Tests the CPU spherical harmonics projection against a literal port of genSPHMap.cp.
+ */
+
+#include "TestHelper.h"
+#include "gfx/volumes/SPHCoefficients.h"
+#include "gfx/volumes/MinMaxPyramid.h"
+#include <fstream>
+#include <random>
+
+using namespace cgu;
+
+namespace {
+
+    /** Creates a smooth field with noise, stored in the format S. */
+    template<typename S> std::vector<uint8_t> CreateVolume(const glm::uvec3& size)
+    {
+        std::vector<uint8_t> data(static_cast<std::size_t>(size.x) * size.y * size.z * sizeof(typename S::Type));
+        auto values = reinterpret_cast<typename S::Type*>(data.data());
+        std::mt19937 rng(11);
+        std::uniform_real_distribution<float> noise(0.0f, 0.2f);
+        for (unsigned int z = 0; z < size.z; ++z) for (unsigned int y = 0; y < size.y; ++y) for (unsigned int x = 0; x < size.x; ++x) {
+            auto p = glm::vec3(x, y, z) / glm::vec3(size);
+            auto value = 0.4f * std::sin(p.x * 9.0f) * std::cos(p.y * 5.0f + p.z * 3.0f) + 0.4f + noise(rng);
+            values[(static_cast<std::size_t>(z) * size.y + y) * size.x + x] = S::Store(value);
+        }
+        return data;
+    }
+
+    /** Projects a single voxel of a level the way the shader does, one invocation at a time. */
+    template<typename S> std::array<glm::vec4, 2> ProjectVoxelReference(const typename S::Type* values, const glm::uvec3& size,
+        const glm::uvec3& sphSize, const glm::ivec3& storePos)
+    {
+        auto origSize = glm::ivec3(size);
+        auto baseReadSize = glm::ivec3(glm::floor(glm::vec3(origSize) / glm::vec3(sphSize)));
+        auto baseReadPos = storePos * baseReadSize;
+        auto relMidPos = 0.5f * glm::vec3(baseReadSize);
+        auto halfVoxelRadius = static_cast<float>(baseReadSize.x) * 0.5f;
+        auto halfVoxelRadSq = halfVoxelRadius * halfVoxelRadius;
+
+        glm::vec4 shell0(0.0f), shell1(0.0f);
+        auto numShell0 = 0.0f, numShell1 = 0.0f;
+        for (auto ix = 0; ix < baseReadSize.x; ++ix) {
+            for (auto iy = 0; iy < baseReadSize.y; ++iy) {
+                for (auto iz = 0; iz < baseReadSize.z; ++iz) {
+                    auto readPos = glm::clamp(baseReadPos + glm::ivec3(ix, iy, iz), glm::ivec3(0), origSize - glm::ivec3(1));
+                    auto value = S::Load(values[(static_cast<std::size_t>(readPos.z) * size.y + readPos.y) * size.x + readPos.x]);
+
+                    auto relPos = glm::vec3(ix, iy, iz) - relMidPos;
+                    auto distSq = glm::dot(relPos, relPos);
+                    // the shader normalizes the zero vector, the CPU version defines it as zero.
+                    relPos = distSq > 0.0f ? glm::normalize(relPos) : glm::vec3(0.0f);
+                    auto basis = glm::vec4(1.0f, relPos.y, relPos.z, relPos.x);
+                    if (distSq > halfVoxelRadSq) {
+                        numShell1 += 1.0f;
+                        shell1 += value * basis;
+                    } else {
+                        numShell0 += 1.0f;
+                        shell0 += value * basis;
+                    }
+                }
+            }
+        }
+        if (numShell0 > 0.0f) shell0 /= numShell0;
+        if (numShell1 > 0.0f) shell1 /= numShell1;
+        return { { (shell0 + glm::vec4(1.0f)) * 0.5f, (shell1 + glm::vec4(1.0f)) * 0.5f } };
+    }
+
+    template<typename S> void TestAgainstReference(VolumeStorageFormat format, const glm::uvec3& size)
+    {
+        auto data = CreateVolume<S>(size);
+        auto values = reinterpret_cast<const typename S::Type*>(data.data());
+        SPHCoefficients coefficients(data.data(), size, format, 1);
+        FWLIB_CHECK(coefficients.GetFormat() == format);
+        FWLIB_CHECK(coefficients.GetNumLevels() == SPHCoefficients::CalcNumLevels(size));
+        FWLIB_CHECK(coefficients.GetLevelSize(0) == SPHCoefficients::CalcBaseSize(size));
+
+        auto numMismatches = 0;
+        for (unsigned int lvl = 0; lvl < coefficients.GetNumLevels(); ++lvl) {
+            const auto& levelSize = coefficients.GetLevelSize(lvl);
+            FWLIB_CHECK(levelSize == MinMaxPyramid::CalcLevelSize(SPHCoefficients::CalcBaseSize(size), lvl));
+            for (unsigned int s = 0; s < SPHCoefficients::NUM_SHELLS; ++s) {
+                FWLIB_CHECK(coefficients.GetLevelData(s, lvl).size() == static_cast<std::size_t>(levelSize.x) * levelSize.y * levelSize.z * 4 * sizeof(typename S::Type));
+            }
+            for (unsigned int z = 0; z < levelSize.z; ++z) for (unsigned int y = 0; y < levelSize.y; ++y) for (unsigned int x = 0; x < levelSize.x; ++x) {
+                auto reference = ProjectVoxelReference<S>(values, size, levelSize, glm::ivec3(x, y, z));
+                auto idx = ((static_cast<std::size_t>(z) * levelSize.y + y) * levelSize.x + x) * 4;
+                for (unsigned int s = 0; s < SPHCoefficients::NUM_SHELLS; ++s) {
+                    auto result = reinterpret_cast<const typename S::Type*>(coefficients.GetLevelData(s, lvl).data()) + idx;
+                    for (int c = 0; c < 4; ++c) if (result[c] != S::Store(reference[s][c])) ++numMismatches;
+                }
+            }
+        }
+        FWLIB_CHECK(numMismatches == 0);
+
+        // rows are independent, so the result does not depend on the number of threads.
+        SPHCoefficients multiThreaded(data.data(), size, format, 3);
+        for (unsigned int lvl = 0; lvl < coefficients.GetNumLevels(); ++lvl) {
+            for (unsigned int s = 0; s < SPHCoefficients::NUM_SHELLS; ++s) {
+                FWLIB_CHECK(multiThreaded.GetLevelData(s, lvl) == coefficients.GetLevelData(s, lvl));
+            }
+        }
+    }
+
+    void TestConstantVolume()
+    {
+        // the constant band holds the value and all blocks project to the same coefficients.
+        const glm::uvec3 size(16, 16, 16);
+        std::vector<float> data(static_cast<std::size_t>(size.x) * size.y * size.z, 0.5f);
+        SPHCoefficients coefficients(data.data(), size, VolumeStorageFormat::FLOAT, 1);
+        FWLIB_CHECK(coefficients.GetNumLevels() == 1);
+        auto numMismatches = 0;
+        for (unsigned int s = 0; s < SPHCoefficients::NUM_SHELLS; ++s) {
+            auto values = reinterpret_cast<const float*>(coefficients.GetLevelData(s, 0).data());
+            if (glm::abs(values[0] - 0.75f) > 1e-6f) ++numMismatches;
+            for (std::size_t i = 4; i < coefficients.GetLevelData(s, 0).size() / sizeof(float); ++i) {
+                if (values[i] != values[i % 4]) ++numMismatches;
+            }
+        }
+        FWLIB_CHECK(numMismatches == 0);
+    }
+
+    void TestSmallVolumes()
+    {
+        // small volumes have a single level instead of an underflowing level count.
+        FWLIB_CHECK(SPHCoefficients::CalcNumLevels(glm::uvec3(2, 3, 1)) == 1);
+        FWLIB_CHECK(SPHCoefficients::CalcBaseSize(glm::uvec3(2, 3, 1)) == glm::uvec3(1));
+        std::vector<uint8_t> data(6, 255);
+        SPHCoefficients coefficients(data.data(), glm::uvec3(2, 3, 1), VolumeStorageFormat::UNORM8, 1);
+        FWLIB_CHECK(coefficients.GetNumLevels() == 1 && coefficients.GetLevelData(0, 0).size() == 4);
+        FWLIB_CHECK(coefficients.GetLevelData(0, 0)[0] == 255);
+    }
+
+    void TestCache(const test::TemporaryDirectory& dir)
+    {
+        const glm::uvec3 size(128, 20, 36);
+        auto data = CreateVolume<volumeStorage::Unorm16>(size);
+        SPHCoefficients coefficients(data.data(), size, VolumeStorageFormat::UNORM16);
+        auto filename = dir.GetFile("volume_sph.cache");
+        VolumeCacheKey key(3, volumeCache::HashString("sph,test"));
+        coefficients.SaveToCache(filename, key);
+
+        SPHCoefficients cached;
+        FWLIB_CHECK(!cached.LoadFromCache(filename, VolumeCacheKey(4, key.parameterHash)));
+        FWLIB_CHECK(!cached.LoadFromCache(filename, VolumeCacheKey(3, volumeCache::HashString("sph,other"))));
+        FWLIB_CHECK(cached.LoadFromCache(filename, key));
+        FWLIB_CHECK(cached.GetFormat() == coefficients.GetFormat() && cached.GetNumLevels() == coefficients.GetNumLevels());
+        for (unsigned int lvl = 0; lvl < coefficients.GetNumLevels(); ++lvl) {
+            FWLIB_CHECK(cached.GetLevelSize(lvl) == coefficients.GetLevelSize(lvl));
+            for (unsigned int s = 0; s < SPHCoefficients::NUM_SHELLS; ++s) FWLIB_CHECK(cached.GetLevelData(s, lvl) == coefficients.GetLevelData(s, lvl));
+        }
+
+        // a truncated cache file is rejected.
+        std::ifstream ifs(filename, std::ios::binary);
+        std::vector<char> contents((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+        ifs.close();
+        std::ofstream(filename, std::ios::binary | std::ios::trunc).write(contents.data(), contents.size() / 2);
+        SPHCoefficients truncated;
+        FWLIB_CHECK(!truncated.LoadFromCache(filename, key));
+        FWLIB_CHECK(truncated.GetNumLevels() == 0);
+    }
+
+    /** Returns the content key of a raw file the way Volume::GetContentHash computes it. */
+    uint64_t HashRawFile(const std::string& rawFilename, const std::string& memoFilename)
+    {
+        return volumeCache::HashFileContent(rawFilename, memoFilename, volumeCache::HashString("layout"), [&rawFilename]()
+        {
+            std::ifstream ifs(rawFilename, std::ios::binary);
+            std::vector<char> contents((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+            return volumeCache::HashData(reinterpret_cast<const uint8_t*>(contents.data()), contents.size());
+        });
+    }
+
+    void TestPrecomputedCache(const test::TemporaryDirectory& dir)
+    {
+        // the cache is computed next to a volume in one directory and shipped with the volume to another one.
+        const glm::uvec3 size(64, 16, 8);
+        auto data = CreateVolume<volumeStorage::Unorm8>(size);
+        auto buildDir = dir.GetFile("build"), targetDir = dir.GetFile("target");
+        boost::filesystem::create_directories(buildDir);
+        boost::filesystem::create_directories(targetDir);
+        std::ofstream(buildDir + "/volume.raw", std::ios::binary).write(reinterpret_cast<const char*>(data.data()), data.size());
+        boost::filesystem::last_write_time(buildDir + "/volume.raw", boost::filesystem::last_write_time(buildDir + "/volume.raw") - 100);
+
+        VolumeCacheKey key(HashRawFile(buildDir + "/volume.raw", buildDir + "/volume_content.cache"), volumeCache::HashString("sph,test"));
+        SPHCoefficients coefficients(data.data(), size, VolumeStorageFormat::UNORM8);
+        coefficients.SaveToCache(buildDir + "/volume_sph.cache", key);
+
+        for (auto file : { "volume.raw", "volume_content.cache", "volume_sph.cache" }) {
+            boost::filesystem::copy_file(buildDir + "/" + file, targetDir + "/" + file);
+        }
+        boost::filesystem::last_write_time(targetDir + "/volume.raw", boost::filesystem::last_write_time(buildDir + "/volume.raw") + 10);
+        FWLIB_CHECK(volumeCache::HashFileStamp(targetDir + "/volume.raw") != volumeCache::HashFileStamp(buildDir + "/volume.raw"));
+
+        VolumeCacheKey targetKey(HashRawFile(targetDir + "/volume.raw", targetDir + "/volume_content.cache"), key.parameterHash);
+        FWLIB_CHECK(targetKey == key);
+        SPHCoefficients shipped;
+        FWLIB_CHECK(shipped.LoadFromCache(targetDir + "/volume_sph.cache", targetKey));
+        FWLIB_CHECK(shipped.GetNumLevels() == coefficients.GetNumLevels() && shipped.GetLevelData(0, 0) == coefficients.GetLevelData(0, 0));
+    }
+}
+
+int main(int, char**)
+{
+    // 128 voxels in x give two levels with blocks of 4x4x4 and 8x8x9 voxels.
+    TestAgainstReference<volumeStorage::Unorm8>(VolumeStorageFormat::UNORM8, glm::uvec3(128, 40, 36));
+    TestAgainstReference<volumeStorage::Unorm16>(VolumeStorageFormat::UNORM16, glm::uvec3(130, 21, 17));
+    TestAgainstReference<volumeStorage::Half>(VolumeStorageFormat::HALF, glm::uvec3(33, 47, 9));
+    TestAgainstReference<volumeStorage::Float>(VolumeStorageFormat::FLOAT, glm::uvec3(128, 40, 36));
+    TestConstantVolume();
+    TestSmallVolumes();
+    test::TemporaryDirectory dir;
+    TestCache(dir);
+    TestPrecomputedCache(dir);
+    return test::Finish("SPHCoefficientsTest");
+}
@@ -0,0 +1,116 @@
+/**
+ * @file   SyntheticVolumeGeneratorTest.cpp
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Tests the synthetic volume patterns voxel for voxel against reference volumes.
+ */
+
+#include "TestHelper.h"
+#include "gfx/volumes/SyntheticVolumeGenerator.h"
+#include "core/parallel_helper.h"
+#include <fstream>
+
+using namespace cgu;
+
+namespace {
+
+    /**
+     *  The reference volumes in data/synthetic were computed independently of the generator by evaluating the
+     *  synth*.cp shaders per voxel and converting the values like OpenGL does. The sphere parameters are powers of two
+     *  so all distances are exact.
+     */
+    const std::string referenceDirectory = std::string(FWLIB_TEST_DATA_DIR) + "/synthetic/";
+    const glm::uvec3 checkerSize(2, 3, 1);
+    const unsigned int stripeSize = 2;
+    const glm::vec3 sphereCenter(2.0f, 1.5f, 1.0f);
+    const glm::vec3 sphereScale(0.25f, 0.125f, 0.5f);
+
+    /** A type of the volumes and the suffix of its reference files. */
+    struct VolumeType
+    {
+        GLenum type;
+        std::string suffix;
+    };
+    const VolumeType types[] = { { GL_UNSIGNED_BYTE, "uchar" }, { GL_UNSIGNED_SHORT, "ushort" }, { GL_UNSIGNED_INT, "uint" }, { GL_FLOAT, "float" } };
+
+    std::vector<uint8_t> ReadFile(const std::string& filename)
+    {
+        std::ifstream ifs(filename, std::ios::binary);
+        return std::vector<uint8_t>((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    }
+
+    /** Reads the lines of a text file independent of its line endings. */
+    std::vector<std::string> ReadLines(const std::string& filename)
+    {
+        std::ifstream ifs(filename);
+        std::vector<std::string> lines;
+        std::string line;
+        while (std::getline(ifs, line)) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            lines.push_back(line);
+        }
+        return lines;
+    }
+
+    /**
+     *  Compares a pattern generated in memory and written to a file with its reference volumes of all types.
+     *  @param dir the directory to write the volumes to.
+     *  @param name the name of the pattern (the reference files are <name>_<type>.dat/raw).
+     *  @param size the size of the reference volumes.
+     *  @param generate the function generating the pattern in memory.
+     *  @param write the function writing the pattern to a dat file.
+     */
+    void TestPattern(const test::TemporaryDirectory& dir, const std::string& name, const glm::uvec3& size,
+        const std::function<void(const SyntheticVolumeGenerator&, std::vector<uint8_t>&)>& generate,
+        const std::function<void(const SyntheticVolumeGenerator&, const std::string&)>& write)
+    {
+        for (const auto& type : types) {
+            auto baseName = name + "_" + type.suffix;
+            auto reference = ReadFile(referenceDirectory + baseName + ".raw");
+
+            SyntheticVolumeGenerator generator(size, type.type);
+            FWLIB_CHECK(reference.size() == static_cast<std::size_t>(size.x) * size.y * size.z * generator.GetBytesPerVoxel());
+            for (auto numThreads : { 1u, parallel::GetNumThreads() }) {
+                generator.SetNumThreads(numThreads);
+                std::vector<uint8_t> data;
+                generate(generator, data);
+                FWLIB_CHECK(data == reference);
+            }
+
+            write(generator, dir.GetFile(baseName + ".dat"));
+            FWLIB_CHECK(ReadFile(dir.GetFile(baseName + ".raw")) == reference);
+            FWLIB_CHECK(ReadLines(dir.GetFile(baseName + ".dat")) == ReadLines(referenceDirectory + baseName + ".dat"));
+        }
+    }
+
+    void TestValues()
+    {
+        // the checker cells alternate along x, rows of cells are shifted by one along y and z.
+        FWLIB_CHECK(SyntheticVolumeGenerator::CheckerValue(glm::uvec3(0, 0, 0), checkerSize) == 0.0f);
+        FWLIB_CHECK(SyntheticVolumeGenerator::CheckerValue(glm::uvec3(2, 0, 0), checkerSize) == 1.0f);
+        FWLIB_CHECK(SyntheticVolumeGenerator::CheckerValue(glm::uvec3(0, 3, 0), checkerSize) == 1.0f);
+        FWLIB_CHECK(SyntheticVolumeGenerator::CheckerValue(glm::uvec3(0, 0, 1), checkerSize) == 1.0f);
+        FWLIB_CHECK(SyntheticVolumeGenerator::CheckerValue(glm::uvec3(0, 3, 1), checkerSize) == 0.0f);
+        FWLIB_CHECK(SyntheticVolumeGenerator::StripesValue(glm::uvec3(1, 4, 7), stripeSize) == 0.0f);
+        FWLIB_CHECK(SyntheticVolumeGenerator::StripesValue(glm::uvec3(3, 0, 0), stripeSize) == 1.0f);
+        FWLIB_CHECK(SyntheticVolumeGenerator::SphericalValue(glm::uvec3(2, 1, 1), sphereCenter, sphereScale) == 0.0625f);
+        FWLIB_CHECK(SyntheticVolumeGenerator::SphericalValue(glm::uvec3(6, 1, 1), sphereCenter, sphereScale) == glm::sqrt(1.00390625f));
+    }
+}
+
+int main(int, char**)
+{
+    TestValues();
+    test::TemporaryDirectory dir;
+    TestPattern(dir, "checker", glm::uvec3(7, 5, 3),
+        [](const SyntheticVolumeGenerator& generator, std::vector<uint8_t>& data) { generator.GenerateChecker(data, checkerSize); },
+        [](const SyntheticVolumeGenerator& generator, const std::string& datFilename) { generator.WriteChecker(datFilename, checkerSize); });
+    TestPattern(dir, "stripes", glm::uvec3(9, 4, 2),
+        [](const SyntheticVolumeGenerator& generator, std::vector<uint8_t>& data) { generator.GenerateStripes(data, stripeSize); },
+        [](const SyntheticVolumeGenerator& generator, const std::string& datFilename) { generator.WriteStripes(datFilename, stripeSize); });
+    TestPattern(dir, "spherical", glm::uvec3(6, 5, 4),
+        [](const SyntheticVolumeGenerator& generator, std::vector<uint8_t>& data) { generator.GenerateSpherical(data, sphereCenter, sphereScale); },
+        [](const SyntheticVolumeGenerator& generator, const std::string& datFilename) { generator.WriteSpherical(datFilename, sphereCenter, sphereScale); });
+    return test::Finish("SyntheticVolumeGeneratorTest");
+}
@@ -0,0 +1,89 @@
+/**
+ * @file   TestHelper.h
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Contains minimal helpers for the CPU side tests and benchmarks.
+ */
+
+#ifndef TESTHELPER_H
+#define TESTHELPER_H
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <boost/filesystem.hpp>
+
+namespace cgu {
+
+    namespace test {
+
+        /** Returns the number of failed checks. */
+        inline unsigned int& GetNumFailures()
+        {
+            static unsigned int numFailures = 0;
+            return numFailures;
+        }
+
+        /** Records the result of a check and reports failures. */
+        inline void Check(bool result, const char* expression, const char* file, int line)
+        {
+            if (result) return;
+            ++GetNumFailures();
+            std::cerr << file << "(" << line << "): check failed: " << expression << std::endl;
+        }
+
+        /** Returns the exit code of a test and reports the number of failed checks. */
+        inline int Finish(const char* testName)
+        {
+            if (GetNumFailures() == 0) std::cout << testName << ": all checks passed." << std::endl;
+            else std::cerr << testName << ": " << GetNumFailures() << " checks failed." << std::endl;
+            return GetNumFailures() == 0 ? 0 : 1;
+        }
+
+        /** Returns the time a function takes in seconds. */
+        template<class Fn> double MeasureSeconds(Fn fn)
+        {
+            auto start = std::chrono::high_resolution_clock::now();
+            fn();
+            return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+        }
+
+        /** A temporary directory that is removed with all its content when the object is destroyed. */
+        class TemporaryDirectory
+        {
+        public:
+            TemporaryDirectory() : path_(boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("fwlib_test_%%%%-%%%%-%%%%"))
+            {
+                boost::filesystem::create_directories(path_);
+            }
+            TemporaryDirectory(const TemporaryDirectory&) = delete;
+            TemporaryDirectory& operator=(const TemporaryDirectory&) = delete;
+            ~TemporaryDirectory()
+            {
+                boost::system::error_code ec;
+                boost::filesystem::remove_all(path_, ec);
+            }
+
+            /** Returns the path of a file in the directory. */
+            std::string GetFile(const std::string& filename) const { return (path_ / filename).string(); }
+
+        private:
+            /** Holds the path of the directory. */
+            boost::filesystem::path path_;
+        };
+    }
+}
+
+/** Checks a condition and counts a failure if it does not hold. */
+#define FWLIB_CHECK(expression) ::cgu::test::Check((expression), #expression, __FILE__, __LINE__)
+
+/** Checks that an expression throws an exception of the given type. */
+#define FWLIB_CHECK_THROWS(expression, exceptionType) \
+    do { \
+        auto fwlibThrown = false; \
+        try { expression; } catch (const exceptionType&) { fwlibThrown = true; } \
+        ::cgu::test::Check(fwlibThrown, #expression " throws " #exceptionType, __FILE__, __LINE__); \
+    } while (false)
+
+#endif // TESTHELPER_H
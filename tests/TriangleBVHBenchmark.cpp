@@ -0,0 +1,117 @@
+/**
+ * @file   TriangleBVHBenchmark.cpp
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Measures building the triangle hierarchy on one and all threads, tracing single rays and packets and finding
+ *         closest points.
+ */
+
+#include "TestHelper.h"
+#include "gfx/mesh/TriangleBVH.h"
+#include "core/parallel_helper.h"
+#include <random>
+
+using namespace cgu;
+
+int main(int argc, char** argv)
+{
+    // a sphere tessellated into gridSize x gridSize quads.
+    auto gridSize = argc > 1 ? static_cast<unsigned int>(std::stoul(argv[1])) : 512u;
+    std::vector<glm::vec3> vertices;
+    std::vector<unsigned int> indices;
+    for (auto y = 0U; y <= gridSize; ++y) {
+        for (auto x = 0U; x <= gridSize; ++x) {
+            auto phi = 2.0f * glm::pi<float>() * static_cast<float>(x) / static_cast<float>(gridSize);
+            auto theta = glm::pi<float>() * static_cast<float>(y) / static_cast<float>(gridSize);
+            vertices.push_back(glm::vec3(std::sin(theta) * std::cos(phi), std::sin(theta) * std::sin(phi), std::cos(theta)));
+        }
+    }
+    for (auto y = 0U; y < gridSize; ++y) {
+        for (auto x = 0U; x < gridSize; ++x) {
+            auto i0 = y * (gridSize + 1) + x, i1 = i0 + 1, i2 = i0 + gridSize + 1, i3 = i2 + 1;
+            for (auto i : { i0, i1, i3, i0, i3, i2 }) indices.push_back(i);
+        }
+    }
+    auto numTriangles = static_cast<unsigned int>(indices.size() / 3);
+
+    std::cout << "Building the hierarchy of " << numTriangles << " triangles:";
+    std::unique_ptr<TriangleBVH> bvh;
+    for (auto numThreads : { 1u, parallel::GetNumThreads() }) {
+        auto time = test::MeasureSeconds([&]() { bvh = std::make_unique<TriangleBVH>(vertices, indices, numThreads); });
+        std::cout << " " << numThreads << " thread(s) " << time * 1000.0 << "ms";
+    }
+    std::cout << " (" << bvh->GetNumNodes() << " nodes, " << bvh->GetNumLeaves() << " leaves)" << std::endl;
+
+    // coherent camera rays of a 512x512 image in 8x1 packets and random incoherent rays.
+    const unsigned int imageSize = 512;
+    std::vector<BVHRay> cameraRays, randomRays;
+    for (auto y = 0U; y < imageSize; ++y) {
+        for (auto x = 0U; x < imageSize; ++x) {
+            auto target = glm::vec3(2.4f * (glm::vec2(x, y) + glm::vec2(0.5f)) / static_cast<float>(imageSize) - glm::vec2(1.2f), 0.0f);
+            cameraRays.push_back(BVHRay(glm::vec3(0.0f, 0.0f, 3.0f), target - glm::vec3(0.0f, 0.0f, 3.0f)));
+        }
+    }
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> distribution(-1.5f, 1.5f);
+    for (std::size_t i = 0; i < cameraRays.size(); ++i) {
+        glm::vec3 origin(distribution(rng), distribution(rng), distribution(rng));
+        randomRays.push_back(BVHRay(origin, glm::vec3(distribution(rng), distribution(rng), distribution(rng)) - origin));
+    }
+
+    const char* rayNames[] = { "camera", "random" };
+    const std::vector<BVHRay>* raySets[] = { &cameraRays, &randomRays };
+    for (auto s = 0; s < 2; ++s) {
+        const auto& rays = *raySets[s];
+        std::vector<BVHHit> hits(rays.size()), packetHits;
+        auto singleTime = test::MeasureSeconds([&]() { for (std::size_t i = 0; i < rays.size(); ++i) bvh->Intersect(rays[i], hits[i]); });
+        auto packetTime = test::MeasureSeconds([&]() { bvh->IntersectRays(rays, packetHits, 1); });
+        auto parallelTime = test::MeasureSeconds([&]() { bvh->IntersectRays(rays, packetHits); });
+        std::vector<uint8_t> occluded;
+        auto occludedTime = test::MeasureSeconds([&]() { bvh->OccludedRays(rays, occluded, 1); });
+
+        auto numDifferent = 0U;
+        for (std::size_t i = 0; i < rays.size(); ++i) if (hits[i].triangle != packetHits[i].triangle) ++numDifferent;
+        std::cout << rays.size() << " " << rayNames[s] << " rays: single " << singleTime * 1000.0 << "ms, packets " << packetTime * 1000.0
+            << "ms, packets on all threads " << parallelTime * 1000.0 << "ms, occlusion packets " << occludedTime * 1000.0 << "ms"
+            << (numDifferent == 0 ? "" : " (results differ!)") << std::endl;
+    }
+
+    // closest points of points near the surface (e.g. picking or projecting vertices) and of random points.
+    std::vector<glm::vec3> surfacePoints, randomPoints;
+    std::uniform_real_distribution<float> radius(0.9f, 1.1f);
+    for (std::size_t i = 0; i < cameraRays.size(); ++i) {
+        glm::vec3 direction;
+        do direction = glm::vec3(distribution(rng), distribution(rng), distribution(rng)); while (glm::dot(direction, direction) < 1e-4f);
+        surfacePoints.push_back(glm::normalize(direction) * radius(rng));
+        randomPoints.push_back(glm::vec3(distribution(rng), distribution(rng), distribution(rng)));
+    }
+
+    const char* pointNames[] = { "near surface", "random" };
+    const std::vector<glm::vec3>* pointSets[] = { &surfacePoints, &randomPoints };
+    for (auto s = 0; s < 2; ++s) {
+        const auto& points = *pointSets[s];
+        std::vector<BVHClosestPoint> closestPoints(points.size()), batchClosestPoints;
+        auto singleTime = test::MeasureSeconds([&]() { for (std::size_t i = 0; i < points.size(); ++i) bvh->FindClosestPoint(points[i], closestPoints[i]); });
+        auto batchTime = test::MeasureSeconds([&]() { bvh->FindClosestPoints(points, batchClosestPoints, std::numeric_limits<float>::infinity(), 1); });
+        auto parallelTime = test::MeasureSeconds([&]() { bvh->FindClosestPoints(points, batchClosestPoints); });
+
+        auto numDifferent = 0U;
+        for (std::size_t i = 0; i < points.size(); ++i) if (closestPoints[i].triangle != batchClosestPoints[i].triangle) ++numDifferent;
+        std::cout << points.size() << " " << pointNames[s] << " closest points: single " << singleTime * 1000.0 << "ms, batch "
+            << batchTime * 1000.0 << "ms, batch on all threads " << parallelTime * 1000.0 << "ms ("
+            << singleTime * 1e9 / static_cast<double>(points.size()) << "ns per point)" << (numDifferent == 0 ? "" : " (results differ!)") << std::endl;
+    }
+
+    // the brute force reference for a few rays and points.
+    const std::size_t numBruteForceQueries = 64;
+    BVHHit hit;
+    auto bruteForceTime = test::MeasureSeconds([&]() { for (std::size_t i = 0; i < numBruteForceQueries; ++i) bvh->IntersectBruteForce(randomRays[i], hit); });
+    BVHClosestPoint closestPoint;
+    auto bruteForcePointTime = test::MeasureSeconds([&]() {
+        for (std::size_t i = 0; i < numBruteForceQueries; ++i) bvh->FindClosestPointBruteForce(randomPoints[i], closestPoint);
+    });
+    std::cout << "brute force: " << bruteForceTime * 1000.0 / numBruteForceQueries << "ms per ray, "
+        << bruteForcePointTime * 1000.0 / numBruteForceQueries << "ms per closest point" << std::endl;
+    return 0;
+}
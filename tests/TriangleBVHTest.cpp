@@ -0,0 +1,313 @@
+/**
+ * @file   TriangleBVHTest.cpp
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Tests the ray and closest point queries of the triangle hierarchy against the brute force versions.
+ */
+
+#include "TestHelper.h"
+#include "gfx/mesh/TriangleBVH.h"
+#include <random>
+
+using namespace cgu;
+
+namespace {
+
+    /** Triangles as vertices and indices. */
+    struct TriangleSoup
+    {
+        /** Holds the vertices. */
+        std::vector<glm::vec3> vertices;
+        /** Holds three indices per triangle. */
+        std::vector<unsigned int> indices;
+
+        void AddTriangle(const glm::vec3& v0, const glm::vec3& v1, const glm::vec3& v2)
+        {
+            for (const auto& v : { v0, v1, v2 }) {
+                indices.push_back(static_cast<unsigned int>(vertices.size()));
+                vertices.push_back(v);
+            }
+        }
+    };
+
+    /** Small random triangles in the unit cube. */
+    TriangleSoup RandomTriangles(unsigned int numTriangles, float triangleSize, unsigned int seed)
+    {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> position(0.0f, 1.0f), offset(-triangleSize, triangleSize);
+        TriangleSoup soup;
+        for (auto i = 0U; i < numTriangles; ++i) {
+            glm::vec3 v0(position(rng), position(rng), position(rng));
+            soup.AddTriangle(v0, v0 + glm::vec3(offset(rng), offset(rng), offset(rng)), v0 + glm::vec3(offset(rng), offset(rng), offset(rng)));
+        }
+        return soup;
+    }
+
+    /** An axis aligned grid of quads in the z = 0.5 plane, rays hitting shared edges hit several triangles at once. */
+    TriangleSoup GridTriangles(unsigned int gridSize)
+    {
+        TriangleSoup soup;
+        auto cellSize = 1.0f / static_cast<float>(gridSize);
+        for (auto y = 0U; y < gridSize; ++y) {
+            for (auto x = 0U; x < gridSize; ++x) {
+                glm::vec3 p0(x * cellSize, y * cellSize, 0.5f), p1((x + 1) * cellSize, y * cellSize, 0.5f);
+                glm::vec3 p2(x * cellSize, (y + 1) * cellSize, 0.5f), p3((x + 1) * cellSize, (y + 1) * cellSize, 0.5f);
+                soup.AddTriangle(p0, p1, p3);
+                soup.AddTriangle(p0, p3, p2);
+            }
+        }
+        return soup;
+    }
+
+    /** Random rays from around the unit cube towards points in it, every fourth one along an axis. */
+    std::vector<BVHRay> RandomRays(unsigned int numRays, unsigned int seed)
+    {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> position(-0.5f, 1.5f), target(0.0f, 1.0f), distance(0.2f, 2.0f);
+        std::vector<BVHRay> rays(numRays);
+        for (auto i = 0U; i < numRays; ++i) {
+            glm::vec3 origin(position(rng), position(rng), position(rng));
+            auto direction = glm::vec3(target(rng), target(rng), target(rng)) - origin;
+            if (i % 4 == 3) {
+                auto axis = i % 3;
+                direction = glm::vec3(0.0f);
+                direction[axis] = origin[axis] < 0.5f ? 1.0f : -1.0f;
+            }
+            // some rays are limited, some start inside the scene.
+            rays[i] = BVHRay(origin, direction, i % 5 == 0 ? 0.5f : 0.0f, i % 2 == 0 ? distance(rng) : std::numeric_limits<float>::infinity());
+        }
+        return rays;
+    }
+
+    bool IsSameHit(const BVHHit& a, const BVHHit& b) { return a.triangle == b.triangle && a.t == b.t && a.u == b.u && a.v == b.v; }
+
+    /** Compares all ray queries with their brute force versions. */
+    void CompareWithBruteForce(const TriangleBVH& bvh, const std::vector<BVHRay>& rays)
+    {
+        std::vector<BVHHit> referenceHits(rays.size());
+        std::vector<uint8_t> referenceOccluded(rays.size());
+        auto numHits = 0U, numMismatches = 0U;
+        for (std::size_t i = 0; i < rays.size(); ++i) {
+            auto hitFound = bvh.IntersectBruteForce(rays[i], referenceHits[i]);
+            referenceOccluded[i] = bvh.OccludedBruteForce(rays[i]) ? 1 : 0;
+            FWLIB_CHECK(hitFound == (referenceOccluded[i] != 0));
+            if (hitFound) ++numHits;
+
+            BVHHit hit;
+            FWLIB_CHECK(bvh.Intersect(rays[i], hit) == hitFound);
+            if (!IsSameHit(hit, referenceHits[i])) ++numMismatches;
+            if (bvh.Occluded(rays[i]) != (referenceOccluded[i] != 0)) ++numMismatches;
+        }
+        FWLIB_CHECK(numMismatches == 0);
+        FWLIB_CHECK(numHits > rays.size() / 10);
+
+        // packets of all sizes, including partial ones at the end of the chunks.
+        for (auto numThreads : { 1u, 3u }) {
+            std::vector<BVHHit> hits;
+            std::vector<uint8_t> occluded;
+            bvh.IntersectRays(rays, hits, numThreads);
+            bvh.OccludedRays(rays, occluded, numThreads);
+            numMismatches = 0;
+            for (std::size_t i = 0; i < rays.size(); ++i) if (!IsSameHit(hits[i], referenceHits[i]) || occluded[i] != referenceOccluded[i]) ++numMismatches;
+            FWLIB_CHECK(numMismatches == 0);
+        }
+        for (auto numRays = 1U; numRays <= TriangleBVH::MAX_PACKET_SIZE; ++numRays) {
+            BVHHit hits[TriangleBVH::MAX_PACKET_SIZE];
+            uint8_t occluded[TriangleBVH::MAX_PACKET_SIZE];
+            bvh.IntersectPacket(&rays[numRays], hits, numRays);
+            bvh.OccludedPacket(&rays[numRays], occluded, numRays);
+            for (auto r = 0U; r < numRays; ++r) FWLIB_CHECK(IsSameHit(hits[r], referenceHits[numRays + r]) && occluded[r] == referenceOccluded[numRays + r]);
+        }
+    }
+
+    void TestRandomTriangles()
+    {
+        auto soup = RandomTriangles(3000, 0.05f, 1);
+        TriangleBVH bvh(soup.vertices, soup.indices, 2);
+        FWLIB_CHECK(bvh.GetNumTriangles() == 3000);
+        FWLIB_CHECK(bvh.GetNumLeaves() >= 3000 / 4 && bvh.GetNumNodes() > 0);
+        FWLIB_CHECK(glm::all(glm::lessThanEqual(bvh.GetBoundingBox().minmax[0], glm::vec3(0.0f))));
+        CompareWithBruteForce(bvh, RandomRays(4000, 2));
+
+        // the triangle function constructor builds the same hierarchy.
+        TriangleBVH fromFunction(3000, [&soup](unsigned int i)
+        {
+            cguMath::Tri3<float> tri;
+            for (auto j = 0; j < 3; ++j) tri[j] = soup.vertices[soup.indices[3 * i + j]];
+            return tri;
+        }, 1);
+        FWLIB_CHECK(fromFunction.GetNumNodes() == bvh.GetNumNodes() && fromFunction.GetNumLeaves() == bvh.GetNumLeaves());
+        for (const auto& ray : RandomRays(500, 3)) {
+            BVHHit hit, reference;
+            bvh.Intersect(ray, reference);
+            fromFunction.Intersect(ray, hit);
+            FWLIB_CHECK(IsSameHit(hit, reference));
+        }
+    }
+
+    void TestTies()
+    {
+        // rays through the shared edges and vertices of the grid hit several triangles at the same distance.
+        auto grid = GridTriangles(16);
+        TriangleBVH bvh(grid.vertices, grid.indices);
+        std::vector<BVHRay> rays;
+        for (auto y = 0U; y <= 32; ++y) {
+            for (auto x = 0U; x <= 32; ++x) {
+                auto target = glm::vec3(x / 32.0f, y / 32.0f, 0.5f);
+                rays.push_back(BVHRay(glm::vec3(0.5f, 0.5f, -1.0f), target - glm::vec3(0.5f, 0.5f, -1.0f)));
+                rays.push_back(BVHRay(target + glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, 0.0f, -1.0f)));
+            }
+        }
+        CompareWithBruteForce(bvh, rays);
+
+        // identical triangles cannot be separated and are split at the median, the lowest index wins.
+        TriangleSoup stacked;
+        for (auto i = 0; i < 5000; ++i) stacked.AddTriangle(glm::vec3(0.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        TriangleBVH stackedBVH(stacked.vertices, stacked.indices);
+        BVHHit hit;
+        FWLIB_CHECK(stackedBVH.Intersect(BVHRay(glm::vec3(0.25f, 0.25f, 1.0f), glm::vec3(0.0f, 0.0f, -1.0f)), hit));
+        FWLIB_CHECK(hit.triangle == 0 && hit.t == 1.0f && hit.u == 0.25f && hit.v == 0.25f);
+        FWLIB_CHECK(stackedBVH.Occluded(BVHRay(glm::vec3(0.25f, 0.25f, -1.0f), glm::vec3(0.0f, 0.0f, 1.0f))));
+        FWLIB_CHECK(!stackedBVH.Occluded(BVHRay(glm::vec3(0.25f, 0.25f, -1.0f), glm::vec3(0.0f, 0.0f, 1.0f), 0.0f, 0.5f)));
+    }
+
+    void TestThreadInvariance()
+    {
+        // enough triangles for building subtrees as tasks, their number depends on the threads.
+        auto soup = RandomTriangles(70000, 0.01f, 4);
+        TriangleBVH reference(soup.vertices, soup.indices, 1);
+        auto rays = RandomRays(300, 5);
+        for (auto numThreads : { 2u, 7u }) {
+            TriangleBVH bvh(soup.vertices, soup.indices, numThreads);
+            FWLIB_CHECK(bvh.GetNumNodes() == reference.GetNumNodes() && bvh.GetNumLeaves() == reference.GetNumLeaves());
+            auto numMismatches = 0U;
+            for (const auto& ray : rays) {
+                BVHHit hit, referenceHit;
+                bvh.Intersect(ray, hit);
+                reference.Intersect(ray, referenceHit);
+                if (!IsSameHit(hit, referenceHit)) ++numMismatches;
+            }
+            FWLIB_CHECK(numMismatches == 0);
+        }
+        CompareWithBruteForce(reference, rays);
+    }
+
+    void TestInvalidRays()
+    {
+        auto soup = RandomTriangles(500, 0.1f, 6);
+        TriangleBVH bvh(soup.vertices, soup.indices);
+        auto nan = std::numeric_limits<float>::quiet_NaN();
+        auto inf = std::numeric_limits<float>::infinity();
+        const BVHRay invalidRays[] = {
+            BVHRay(glm::vec3(nan, 0.5f, 0.5f), glm::vec3(1.0f, 0.0f, 0.0f)),
+            BVHRay(glm::vec3(-1.0f, 0.5f, 0.5f), glm::vec3(1.0f, nan, 0.0f)),
+            BVHRay(glm::vec3(-1.0f, 0.5f, 0.5f), glm::vec3(1.0f, 0.0f, 0.0f), nan),
+            BVHRay(glm::vec3(-1.0f, 0.5f, 0.5f), glm::vec3(1.0f, 0.0f, 0.0f), 0.0f, nan),
+            BVHRay(glm::vec3(-inf, 0.5f, 0.5f), glm::vec3(1.0f, 0.0f, 0.0f)),
+            BVHRay(glm::vec3(-1.0f, 0.5f, 0.5f), glm::vec3(inf, 0.0f, 0.0f)) };
+        for (const auto& ray : invalidRays) {
+            BVHHit hit;
+            FWLIB_CHECK(!bvh.Intersect(ray, hit) && hit.triangle == TriangleBVH::NO_HIT);
+            FWLIB_CHECK(!bvh.Occluded(ray));
+            FWLIB_CHECK(!bvh.IntersectBruteForce(ray, hit) && !bvh.OccludedBruteForce(ray));
+        }
+
+        // invalid rays in a packet do not affect the others.
+        BVHRay rays[TriangleBVH::MAX_PACKET_SIZE];
+        for (auto r = 0U; r < TriangleBVH::MAX_PACKET_SIZE; ++r) {
+            rays[r] = r % 2 == 0 ? invalidRays[r / 2] : BVHRay(glm::vec3(-1.0f, 0.1f * r, 0.5f), glm::vec3(1.0f, 0.0f, 0.01f * r));
+        }
+        BVHHit hits[TriangleBVH::MAX_PACKET_SIZE];
+        uint8_t occluded[TriangleBVH::MAX_PACKET_SIZE];
+        bvh.IntersectPacket(rays, hits, TriangleBVH::MAX_PACKET_SIZE);
+        bvh.OccludedPacket(rays, occluded, TriangleBVH::MAX_PACKET_SIZE);
+        for (auto r = 0U; r < TriangleBVH::MAX_PACKET_SIZE; ++r) {
+            BVHHit reference;
+            auto hitFound = bvh.IntersectBruteForce(rays[r], reference);
+            if (r % 2 == 0) FWLIB_CHECK(!hitFound && hits[r].triangle == TriangleBVH::NO_HIT && occluded[r] == 0);
+            else FWLIB_CHECK(IsSameHit(hits[r], reference) && occluded[r] == (hitFound ? 1 : 0));
+        }
+
+        // an empty hierarchy hits nothing.
+        TriangleBVH empty{ std::vector<glm::vec3>(), std::vector<unsigned int>() };
+        BVHHit hit;
+        FWLIB_CHECK(empty.GetNumTriangles() == 0 && !empty.Intersect(BVHRay(), hit) && !empty.Occluded(BVHRay()));
+        bvh.IntersectPacket(rays, hits, 0);
+    }
+
+    bool IsSameClosestPoint(const BVHClosestPoint& a, const BVHClosestPoint& b)
+    {
+        return a.triangle == b.triangle && a.distance == b.distance && a.u == b.u && a.v == b.v && a.point == b.point;
+    }
+
+    void TestClosestPoints()
+    {
+        auto soup = RandomTriangles(3000, 0.05f, 7);
+        TriangleBVH bvh(soup.vertices, soup.indices);
+        std::mt19937 rng(8);
+        std::uniform_real_distribution<float> position(-0.5f, 1.5f);
+        std::vector<glm::vec3> points(2000);
+        for (auto& point : points) point = glm::vec3(position(rng), position(rng), position(rng));
+
+        for (auto maxDistance : { std::numeric_limits<float>::infinity(), 0.05f }) {
+            std::vector<BVHClosestPoint> references(points.size()), results;
+            auto numFound = 0U, numMismatches = 0U;
+            for (std::size_t i = 0; i < points.size(); ++i) {
+                auto found = bvh.FindClosestPointBruteForce(points[i], references[i], maxDistance);
+                if (found) ++numFound;
+                BVHClosestPoint result;
+                if (bvh.FindClosestPoint(points[i], result, maxDistance) != found || !IsSameClosestPoint(result, references[i])) ++numMismatches;
+            }
+            FWLIB_CHECK(numMismatches == 0);
+            FWLIB_CHECK(numFound > 0);
+            if (maxDistance > 1.0f) FWLIB_CHECK(numFound == points.size());
+
+            bvh.FindClosestPoints(points, results, maxDistance, 3);
+            numMismatches = 0;
+            for (std::size_t i = 0; i < points.size(); ++i) if (!IsSameClosestPoint(results[i], references[i])) ++numMismatches;
+            FWLIB_CHECK(numMismatches == 0);
+        }
+
+        // every triangle is in the hierarchy: its centroid lies on it.
+        auto maxCentroidDistance = 0.0f;
+        for (std::size_t i = 0; i < soup.indices.size(); i += 3) {
+            auto centroid = (soup.vertices[soup.indices[i]] + soup.vertices[soup.indices[i + 1]] + soup.vertices[soup.indices[i + 2]]) / 3.0f;
+            BVHClosestPoint result;
+            bvh.FindClosestPoint(centroid, result);
+            maxCentroidDistance = glm::max(maxCentroidDistance, result.distance);
+        }
+        FWLIB_CHECK(maxCentroidDistance < 1e-5f);
+
+        // nodes with unused children (five triangles give a root with two leaves), queries far away from them.
+        auto small = RandomTriangles(5, 0.1f, 9);
+        TriangleBVH smallBVH(small.vertices, small.indices);
+        FWLIB_CHECK(smallBVH.GetNumNodes() == 1 && smallBVH.GetNumLeaves() < 4);
+        for (const auto& point : { glm::vec3(0.5f), glm::vec3(1e30f, 0.0f, 0.0f), glm::vec3(-3e38f) }) {
+            BVHClosestPoint result, reference;
+            FWLIB_CHECK(smallBVH.FindClosestPoint(point, result) == smallBVH.FindClosestPointBruteForce(point, reference));
+            FWLIB_CHECK(IsSameClosestPoint(result, reference));
+        }
+
+        // NaN or infinite query points find nothing.
+        auto nan = std::numeric_limits<float>::quiet_NaN();
+        auto inf = std::numeric_limits<float>::infinity();
+        for (const auto& point : { glm::vec3(nan, 0.5f, 0.5f), glm::vec3(0.5f, inf, 0.5f), glm::vec3(0.5f, 0.5f, -inf) }) {
+            BVHClosestPoint result;
+            FWLIB_CHECK(!bvh.FindClosestPoint(point, result) && result.triangle == TriangleBVH::NO_HIT);
+            FWLIB_CHECK(!bvh.FindClosestPointBruteForce(point, result) && result.triangle == TriangleBVH::NO_HIT);
+        }
+        BVHClosestPoint result;
+        FWLIB_CHECK(!bvh.FindClosestPoint(glm::vec3(0.5f), result, nan));
+    }
+}
+
+int main(int, char**)
+{
+    TestRandomTriangles();
+    TestTies();
+    TestThreadInvariance();
+    TestInvalidRays();
+    TestClosestPoints();
+    return test::Finish("TriangleBVHTest");
+}
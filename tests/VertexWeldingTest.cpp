@@ -0,0 +1,135 @@
+/**
+ * @file   VertexWeldingTest.cpp
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Tests welding vertices against a brute force transitive closure.
+ */
+
+#include "TestHelper.h"
+#include "gfx/mesh/VertexWelding.h"
+#include <random>
+
+using namespace cgu;
+
+namespace {
+
+    /** Returns the lowest index of the group of each vertex by joining all pairs within the tolerance. */
+    std::vector<unsigned int> WeldReference(const std::vector<glm::vec3>& vertices, float tolerance)
+    {
+        std::vector<unsigned int> representatives(vertices.size());
+        for (std::size_t i = 0; i < vertices.size(); ++i) representatives[i] = static_cast<unsigned int>(i);
+        for (auto changed = true; changed;) {
+            changed = false;
+            for (std::size_t i = 0; i < vertices.size(); ++i) {
+                for (std::size_t j = 0; j < vertices.size(); ++j) {
+                    auto diff = vertices[i] - vertices[j];
+                    if (glm::dot(diff, diff) > tolerance * tolerance || representatives[j] >= representatives[i]) continue;
+                    representatives[i] = representatives[j];
+                    changed = true;
+                }
+            }
+        }
+        return representatives;
+    }
+
+    /** Random clusters of vertices within the tolerance and chains of vertices only welded transitively. */
+    std::vector<glm::vec3> CreateVertices(unsigned int numClusters, float tolerance, unsigned int seed)
+    {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> position(0.0f, 1.0f), jitter(-0.25f * tolerance, 0.25f * tolerance);
+        std::uniform_int_distribution<int> clusterSize(1, 4);
+        std::vector<glm::vec3> vertices;
+        for (auto c = 0U; c < numClusters; ++c) {
+            glm::vec3 center(position(rng), position(rng), position(rng));
+            if (c % 7 == 0) {
+                for (auto i = 0; i < 6; ++i) vertices.push_back(center + glm::vec3(0.9f * tolerance * i, 0.0f, 0.0f));
+            } else {
+                for (auto i = clusterSize(rng); i > 0; --i) vertices.push_back(center + glm::vec3(jitter(rng), jitter(rng), jitter(rng)));
+            }
+        }
+        std::shuffle(vertices.begin(), vertices.end(), rng);
+        return vertices;
+    }
+
+    void TestAgainstReference()
+    {
+        const auto tolerance = 0.01f;
+        auto vertices = CreateVertices(600, tolerance, 1);
+        auto reference = WeldReference(vertices, tolerance);
+        for (auto numThreads : { 1u, 3u, 8u }) {
+            std::vector<unsigned int> representatives;
+            vertexWelding::FindRepresentatives(vertices, VertexWeldingParameters(tolerance, false), representatives, numThreads);
+            FWLIB_CHECK(representatives == reference);
+        }
+
+        // relative tolerances are scaled by the diagonal of the bounding box.
+        auto diagonal = vertexWelding::GetAbsoluteTolerance(vertices, VertexWeldingParameters(1.0f, true));
+        std::vector<unsigned int> relative;
+        vertexWelding::FindRepresentatives(vertices, VertexWeldingParameters(tolerance / diagonal, true), relative);
+        FWLIB_CHECK(relative == WeldReference(vertices, vertexWelding::GetAbsoluteTolerance(vertices, VertexWeldingParameters(tolerance / diagonal, true))));
+
+        // welded vertices are the representatives in index order.
+        std::vector<glm::vec3> weldedVertices;
+        std::vector<unsigned int> weldedIndices;
+        auto numWelded = vertexWelding::WeldVertices(vertices, VertexWeldingParameters(tolerance, false), weldedVertices, weldedIndices, 2);
+        auto numReference = 0U;
+        for (std::size_t i = 0; i < reference.size(); ++i) {
+            if (reference[i] == i) FWLIB_CHECK(weldedIndices[i] == numReference++ && weldedVertices[weldedIndices[i]] == vertices[i]);
+            else FWLIB_CHECK(weldedIndices[i] == weldedIndices[reference[i]]);
+        }
+        FWLIB_CHECK(numWelded == numReference && weldedVertices.size() == numReference);
+    }
+
+    void TestLargeInput()
+    {
+        // several chunks and hash buckets: the result does not depend on the threads.
+        const auto tolerance = 0.002f;
+        auto vertices = CreateVertices(60000, tolerance, 2);
+        FWLIB_CHECK(vertices.size() > 2 * (1 << 16));
+        std::vector<unsigned int> reference;
+        vertexWelding::FindRepresentatives(vertices, VertexWeldingParameters(tolerance, false), reference, 1);
+        for (auto numThreads : { 4u, 16u }) {
+            std::vector<unsigned int> representatives;
+            vertexWelding::FindRepresentatives(vertices, VertexWeldingParameters(tolerance, false), representatives, numThreads);
+            FWLIB_CHECK(representatives == reference);
+        }
+
+        // every vertex is joined to a lower one within the tolerance of its group, or is the lowest of its group.
+        auto numInvalid = 0U;
+        for (std::size_t i = 0; i < reference.size(); ++i) if (reference[i] > i || reference[reference[i]] != reference[i]) ++numInvalid;
+        FWLIB_CHECK(numInvalid == 0);
+
+        // a long chain is joined in a single pass, all vertices are welded to the first one.
+        std::vector<glm::vec3> chain(50000);
+        for (std::size_t i = 0; i < chain.size(); ++i) chain[i] = glm::vec3(0.9f * tolerance * static_cast<float>(chain.size() - i), 0.5f, 0.5f);
+        std::vector<unsigned int> chainRepresentatives;
+        vertexWelding::FindRepresentatives(chain, VertexWeldingParameters(tolerance, false), chainRepresentatives, 4);
+        FWLIB_CHECK(chainRepresentatives == std::vector<unsigned int>(chain.size(), 0));
+    }
+
+    void TestExact()
+    {
+        auto nan = std::numeric_limits<float>::quiet_NaN();
+        std::vector<glm::vec3> vertices = { glm::vec3(1.0f, 2.0f, 3.0f), glm::vec3(0.0f), glm::vec3(1.0f, 2.0f, 3.0f),
+            glm::vec3(-0.0f, 0.0f, -0.0f), glm::vec3(nan), glm::vec3(nan), glm::vec3(1.0f, 2.0f, 3.0000002f) };
+        std::vector<unsigned int> representatives;
+        vertexWelding::FindRepresentatives(vertices, VertexWeldingParameters(), representatives);
+        FWLIB_CHECK(representatives == std::vector<unsigned int>({ 0, 1, 0, 1, 4, 5, 6 }));
+
+        // non-finite vertices are not welded with a tolerance either.
+        vertexWelding::FindRepresentatives(vertices, VertexWeldingParameters(0.001f, false), representatives);
+        FWLIB_CHECK(representatives == std::vector<unsigned int>({ 0, 1, 0, 1, 4, 5, 0 }));
+
+        FWLIB_CHECK_THROWS(vertexWelding::FindRepresentatives(vertices, VertexWeldingParameters(-1.0f, false), representatives), std::runtime_error);
+        FWLIB_CHECK_THROWS(vertexWelding::FindRepresentatives(vertices, VertexWeldingParameters(nan, false), representatives), std::runtime_error);
+    }
+}
+
+int main(int, char**)
+{
+    TestAgainstReference();
+    TestLargeInput();
+    TestExact();
+    return test::Finish("VertexWeldingTest");
+}
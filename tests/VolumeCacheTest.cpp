@@ -0,0 +1,121 @@
+/**
+ * @file   VolumeCacheTest.cpp
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Tests the cache keys of volume files, memoizing content hashes and caching the min/max pyramid with its level 0.
+ */
+
+#include "TestHelper.h"
+#include "gfx/volumes/MinMaxPyramid.h"
+#include "gfx/volumes/VolumeCache.h"
+#include <fstream>
+
+using namespace cgu;
+
+namespace {
+
+    void WriteFile(const std::string& filename, const std::string& content)
+    {
+        std::ofstream ofs(filename, std::ios::binary | std::ios::trunc);
+        ofs << content;
+    }
+
+    void TestFileStamp(const test::TemporaryDirectory& dir)
+    {
+        auto filename = dir.GetFile("volume.raw");
+        WriteFile(filename, "0123456789");
+        auto stamp = volumeCache::HashFileStamp(filename);
+        FWLIB_CHECK(stamp == volumeCache::HashFileStamp(filename));
+
+        // the same size but a different modification time.
+        boost::filesystem::last_write_time(filename, boost::filesystem::last_write_time(filename) - 10);
+        auto olderStamp = volumeCache::HashFileStamp(filename);
+        FWLIB_CHECK(olderStamp != stamp);
+
+        // a different size with the same modification time.
+        auto time = boost::filesystem::last_write_time(filename);
+        WriteFile(filename, "01234567890");
+        boost::filesystem::last_write_time(filename, time);
+        FWLIB_CHECK(volumeCache::HashFileStamp(filename) != olderStamp);
+
+        auto otherFilename = dir.GetFile("other.raw");
+        WriteFile(otherFilename, "01234567890");
+        boost::filesystem::last_write_time(otherFilename, time);
+        FWLIB_CHECK(volumeCache::HashFileStamp(otherFilename) != volumeCache::HashFileStamp(filename));
+
+        FWLIB_CHECK_THROWS(volumeCache::HashFileStamp(dir.GetFile("missing.raw")), boost::filesystem::filesystem_error);
+    }
+
+    void TestFileContentHash(const test::TemporaryDirectory& dir)
+    {
+        auto filename = dir.GetFile("content.raw");
+        auto memoFilename = dir.GetFile("content_content.cache");
+        WriteFile(filename, "0123456789");
+        auto fileTime = boost::filesystem::last_write_time(filename) - 100;
+        boost::filesystem::last_write_time(filename, fileTime);
+
+        auto numHashed = 0U;
+        auto hashContent = [&numHashed, &filename]()
+        {
+            ++numHashed;
+            std::ifstream ifs(filename, std::ios::binary);
+            std::string content((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+            return volumeCache::HashData(reinterpret_cast<const uint8_t*>(content.data()), content.size());
+        };
+
+        auto hash = volumeCache::HashFileContent(filename, memoFilename, 1, hashContent);
+        FWLIB_CHECK(numHashed == 1 && hash == volumeCache::HashData(reinterpret_cast<const uint8_t*>("0123456789"), 10));
+        // the memo is used as long as the stamp and the parameters are the same.
+        FWLIB_CHECK(volumeCache::HashFileContent(filename, memoFilename, 1, hashContent) == hash && numHashed == 1);
+        FWLIB_CHECK(volumeCache::HashFileContent(filename, memoFilename, 2, hashContent) == hash && numHashed == 2);
+
+        // rewritten with the same size and modification time, but after the memo was written.
+        WriteFile(filename, "9876543210");
+        boost::filesystem::last_write_time(filename, fileTime);
+        boost::filesystem::last_write_time(memoFilename, fileTime);
+        auto rewrittenHash = volumeCache::HashFileContent(filename, memoFilename, 2, hashContent);
+        FWLIB_CHECK(numHashed == 3 && rewrittenHash != hash);
+
+        // a new modification time changes the stamp.
+        boost::filesystem::last_write_time(filename, fileTime + 10);
+        FWLIB_CHECK(volumeCache::HashFileContent(filename, memoFilename, 2, hashContent) == rewrittenHash && numHashed == 4);
+    }
+
+    void TestPyramidLevel0Cache(const test::TemporaryDirectory& dir)
+    {
+        const glm::uvec3 size(9, 8, 5);
+        std::vector<uint8_t> level0(size.x * size.y * size.z);
+        for (std::size_t i = 0; i < level0.size(); ++i) level0[i] = static_cast<uint8_t>(i * 13);
+
+        auto numLevels = MinMaxPyramid::CalcNumLevels(size);
+        MinMaxPyramid pyramid(level0.data(), size, VolumeStorageFormat::UNORM8, numLevels);
+        FWLIB_CHECK(pyramid.GetLevelData(0).empty());
+        pyramid.SetLevel0Data(std::vector<uint8_t>(level0));
+
+        auto cacheFilename = dir.GetFile("volume_minmax.cache");
+        VolumeCacheKey key(17, 23);
+        pyramid.SaveToCache(cacheFilename, key);
+
+        MinMaxPyramid cached;
+        FWLIB_CHECK(!cached.LoadFromCache(cacheFilename, VolumeCacheKey(17, 24)));
+        FWLIB_CHECK(cached.LoadFromCache(cacheFilename, key));
+        FWLIB_CHECK(cached.GetNumLevels() == pyramid.GetNumLevels());
+        FWLIB_CHECK(cached.GetLevelData(0) == level0);
+        FWLIB_CHECK(cached.GetLevelData(1) == pyramid.GetLevelData(1));
+        FWLIB_CHECK(cached.GetMinMaxLevelData(0) == pyramid.GetMinMaxLevelData(0));
+
+        auto released = cached.ReleaseLevel0Data();
+        FWLIB_CHECK(released == level0);
+        FWLIB_CHECK(cached.GetLevelData(0).empty());
+    }
+}
+
+int main(int, char**)
+{
+    test::TemporaryDirectory dir;
+    TestFileStamp(dir);
+    TestFileContentHash(dir);
+    TestPyramidLevel0Cache(dir);
+    return test::Finish("VolumeCacheTest");
+}
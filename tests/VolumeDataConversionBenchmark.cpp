@@ -0,0 +1,36 @@
+/**
+ * @file   VolumeDataConversionBenchmark.cpp
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Compares the chunked volume data conversion with the per value conversion used before.
+ */
+
+#include "TestHelper.h"
+#include "VolumeDataReference.h"
+#include "core/parallel_helper.h"
+#include "gfx/volumes/VolumeDataConversion.h"
+
+using namespace cgu;
+
+int main(int argc, char** argv)
+{
+    auto edge = argc > 1 ? static_cast<unsigned int>(std::stoul(argv[1])) : 256u;
+    const GLenum types[] = { GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT, GL_UNSIGNED_INT, GL_FLOAT };
+    const char* typeNames[] = { "UCHAR", "USHORT", "UINT", "FLOAT" };
+
+    std::cout << "Converting " << edge << "^3 voxels with " << parallel::GetNumThreads() << " threads." << std::endl;
+    for (auto t = 0; t < 4; ++t) {
+        for (auto numComponents : { 1u, 4u }) {
+            test::VolumeTestData volume(glm::uvec3(edge), types[t], numComponents);
+            std::vector<float> reference, result(static_cast<std::size_t>(volume.view.GetNumVoxels() * numComponents));
+            auto referenceTime = test::MeasureSeconds([&]() { reference = test::ConvertToNormalizedFloatReference(volume.view); });
+            auto singleTime = test::MeasureSeconds([&]() { volumeConversion::ConvertToNormalizedFloat(volume.view, result.data(), 1); });
+            auto parallelTime = test::MeasureSeconds([&]() { volumeConversion::ConvertToNormalizedFloat(volume.view, result.data()); });
+            std::cout << typeNames[t] << " x" << numComponents << ": per value " << referenceTime * 1000.0 << "ms, chunked (1 thread) "
+                << singleTime * 1000.0 << "ms, chunked " << parallelTime * 1000.0 << "ms, speedup "
+                << referenceTime / parallelTime << (test::IsBitExact(result, reference) ? "" : " (results differ!)") << std::endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,145 @@
+/**
+ * @file   VolumeDataConversionTest.cpp
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Tests the chunked volume data conversion against a per value reference conversion.
+ */
+
+#include "TestHelper.h"
+#include "VolumeDataReference.h"
+#include "gfx/volumes/VolumeDataConversion.h"
+#include <algorithm>
+#include <glm/gtc/packing.hpp>
+
+using namespace cgu;
+
+namespace {
+
+    void TestFloatConversion(GLenum type, unsigned int numComponents, unsigned int scaleValue, bool strided, unsigned int numThreads)
+    {
+        // an odd size so the last chunk is a partial one.
+        test::VolumeTestData volume(glm::uvec3(67, 41, 29), type, numComponents, scaleValue, strided ? 4 : 0);
+        auto reference = test::ConvertToNormalizedFloatReference(volume.view);
+
+        std::vector<float> result(reference.size());
+        auto maxValue = volumeConversion::ConvertToNormalizedFloat(volume.view, result.data(), numThreads);
+        FWLIB_CHECK(maxValue == test::FindMaximumReference(volume.view));
+        FWLIB_CHECK(test::IsBitExact(result, reference));
+
+        std::vector<float> runResult(reference.size());
+        auto numVoxels = volume.view.GetNumVoxels();
+        volumeConversion::ConvertVoxelsToNormalizedFloat(volume.view, volume.view.GetVoxel(uint64_t(5)), numVoxels - 5, maxValue,
+            runResult.data() + 5 * numComponents);
+        FWLIB_CHECK(std::equal(runResult.begin() + 5 * numComponents, runResult.end(), reference.begin() + 5 * numComponents,
+            [](float a, float b) { return test::IsBitExact(a, b); }));
+    }
+
+    void TestHalfConversion(GLenum type, unsigned int numComponents)
+    {
+        test::VolumeTestData volume(glm::uvec3(33, 17, 9), type, numComponents, 1, 4);
+        auto reference = test::ConvertToNormalizedFloatReference(volume.view);
+
+        std::vector<uint16_t> result(reference.size());
+        volumeConversion::ConvertToNormalizedHalf(volume.view, result.data(), 2);
+        auto numMismatches = 0;
+        for (std::size_t i = 0; i < reference.size(); ++i) if (result[i] != glm::packHalf1x16(reference[i])) ++numMismatches;
+        FWLIB_CHECK(numMismatches == 0);
+    }
+
+    template<typename T>
+    void TestNativeConversion(GLenum type, unsigned int numComponents, unsigned int scaleValue)
+    {
+        test::VolumeTestData volume(glm::uvec3(33, 17, 9), type, numComponents, scaleValue);
+        auto reference = test::ConvertToNormalizedFloatReference(volume.view);
+        auto maxValue = volumeConversion::FindMaximumValue(volume.view);
+        FWLIB_CHECK(volumeConversion::HasNativeFormat(volume.view));
+        FWLIB_CHECK(!volumeConversion::IsNativeNormalized(volume.view, maxValue));
+
+        std::vector<T> result(reference.size());
+        volumeConversion::ConvertToNormalizedNative(volume.view, maxValue, result.data(), 2);
+        auto maxError = 0.0f;
+        auto typeMax = static_cast<float>(std::numeric_limits<T>::max());
+        for (std::size_t i = 0; i < reference.size(); ++i) maxError = glm::max(maxError, glm::abs(result[i] / typeMax - reference[i]));
+        FWLIB_CHECK(maxError <= 0.5f / typeMax + 1e-6f);
+        FWLIB_CHECK(*std::max_element(result.begin(), result.end()) == std::numeric_limits<T>::max());
+    }
+
+    void TestZeroVolume(GLenum type)
+    {
+        test::VolumeTestData volume(glm::uvec3(9, 5, 3), type, 2);
+        std::fill(volume.data.begin(), volume.data.end(), uint8_t(0));
+        auto numValues = static_cast<std::size_t>(volume.view.GetNumVoxels() * 2);
+
+        std::vector<float> floats(numValues, 1.0f);
+        FWLIB_CHECK(volumeConversion::ConvertToNormalizedFloat(volume.view, floats.data()) == 0.0f);
+        FWLIB_CHECK(std::all_of(floats.begin(), floats.end(), [](float v) { return v == 0.0f; }));
+
+        std::vector<uint16_t> halfs(numValues, 1);
+        volumeConversion::ConvertToNormalizedHalf(volume.view, halfs.data());
+        FWLIB_CHECK(std::all_of(halfs.begin(), halfs.end(), [](uint16_t v) { return v == 0; }));
+
+        if (volumeConversion::HasNativeFormat(volume.view)) {
+            std::vector<uint8_t> native(static_cast<std::size_t>(volume.view.GetNumBytes()), 1);
+            volumeConversion::ConvertToNormalizedNative(volume.view, 0.0f, native.data());
+            FWLIB_CHECK(std::all_of(native.begin(), native.end(), [](uint8_t v) { return v == 0; }));
+        }
+    }
+
+    void TestSlabConversion(GLenum type, unsigned int numComponents, bool strided)
+    {
+        // converting slabs with the maximum of the whole volume is the same as converting the whole volume.
+        test::VolumeTestData volume(glm::uvec3(13, 7, 11), type, numComponents, 1, strided ? 4 : 0);
+        auto numElements = static_cast<std::size_t>(volume.view.GetNumVoxels()) * numComponents;
+        auto sliceElements = static_cast<std::size_t>(volume.view.size.x) * volume.view.size.y * numComponents;
+        std::vector<float> whole(numElements), slabs(numElements);
+        std::vector<uint16_t> wholeHalf(numElements), slabsHalf(numElements);
+        auto maxValue = volumeConversion::ConvertToNormalizedFloat(volume.view, whole.data());
+        volumeConversion::ConvertToNormalizedHalf(volume.view, wholeHalf.data());
+
+        auto slabMax = 0.0f;
+        for (unsigned int z0 = 0; z0 < volume.view.size.z; z0 += 4) {
+            auto z1 = glm::min(z0 + 4, volume.view.size.z);
+            auto slab = volume.view.GetSlices(z0, z1);
+            FWLIB_CHECK(slab.size.z == z1 - z0 && slab.data == volume.view.GetVoxel(glm::uvec3(0, 0, z0)));
+            slabMax = glm::max(slabMax, volumeConversion::FindMaximumValue(slab));
+        }
+        FWLIB_CHECK(test::IsBitExact(slabMax, maxValue));
+
+        for (unsigned int z0 = 0; z0 < volume.view.size.z; z0 += 4) {
+            auto slab = volume.view.GetSlices(z0, glm::min(z0 + 4, volume.view.size.z));
+            volumeConversion::ConvertToNormalizedFloat(slab, slabMax, slabs.data() + z0 * sliceElements, 2);
+            volumeConversion::ConvertToNormalizedHalf(slab, slabMax, slabsHalf.data() + z0 * sliceElements, 2);
+        }
+        FWLIB_CHECK(test::IsBitExact(slabs, whole));
+        FWLIB_CHECK(slabsHalf == wholeHalf);
+    }
+}
+
+int main(int, char**)
+{
+    const GLenum types[] = { GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT, GL_UNSIGNED_INT, GL_FLOAT };
+    for (auto type : types) {
+        for (unsigned int numComponents = 1; numComponents <= 4; ++numComponents) {
+            for (auto strided : { false, true }) {
+                for (auto numThreads : { 1u, 3u }) TestFloatConversion(type, numComponents, 1, strided, numThreads);
+            }
+        }
+    }
+    // 12 bit data stored in 16 bit.
+    for (unsigned int numComponents = 1; numComponents <= 4; ++numComponents) TestFloatConversion(GL_UNSIGNED_SHORT, numComponents, 16, false, 2);
+
+    for (auto type : types) {
+        TestHalfConversion(type, 1);
+        TestHalfConversion(type, 3);
+        TestZeroVolume(type);
+        TestSlabConversion(type, 1, false);
+        TestSlabConversion(type, 2, true);
+    }
+    TestNativeConversion<uint8_t>(GL_UNSIGNED_BYTE, 1, 1);
+    TestNativeConversion<uint8_t>(GL_UNSIGNED_BYTE, 4, 1);
+    TestNativeConversion<uint16_t>(GL_UNSIGNED_SHORT, 2, 1);
+    TestNativeConversion<uint16_t>(GL_UNSIGNED_SHORT, 1, 16);
+
+    return test::Finish("VolumeDataConversionTest");
+}
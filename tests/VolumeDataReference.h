@@ -0,0 +1,168 @@
+/**
+ * @file   VolumeDataReference.h
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Contains generated volume data and the per value reference conversion used by the volume tests.
+ */
+
+#ifndef VOLUMEDATAREFERENCE_H
+#define VOLUMEDATAREFERENCE_H
+
+#include "gfx/volumes/RawVolumeSource.h"
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace cgu {
+
+    namespace test {
+
+        /** Returns the size of a single component of an OpenGL type. */
+        inline unsigned int GetTypeSize(GLenum type)
+        {
+            switch (type) {
+            case GL_UNSIGNED_BYTE: return 1;
+            case GL_UNSIGNED_SHORT: return 2;
+            default: return 4;
+            }
+        }
+
+        /** Volume data with random values and a view on it. */
+        struct VolumeTestData
+        {
+            /**
+             *  Creates random volume data.
+             *  @param size the size of the volume.
+             *  @param type the type of each component.
+             *  @param numComponents the number of components per voxel.
+             *  @param scaleValue the scale value (16 creates 12 bit data).
+             *  @param paddingBytes the number of unused bytes after each voxel.
+             *  @param seed the seed of the random values.
+             */
+            VolumeTestData(const glm::uvec3& size, GLenum type, unsigned int numComponents, unsigned int scaleValue = 1,
+                unsigned int paddingBytes = 0, unsigned int seed = 42)
+            {
+                view.size = size;
+                view.type = type;
+                view.numComponents = numComponents;
+                view.scaleValue = scaleValue;
+                view.bytesPerVoxel = GetTypeSize(type) * numComponents;
+                view.voxelStride = view.bytesPerVoxel + paddingBytes;
+                data.resize(static_cast<std::size_t>(view.GetNumBytes()));
+
+                std::mt19937 rng(seed);
+                for (uint64_t v = 0; v < view.GetNumVoxels(); ++v) {
+                    auto voxel = data.data() + v * view.voxelStride;
+                    for (unsigned int c = 0; c < numComponents; ++c) {
+                        auto component = voxel + c * GetTypeSize(type);
+                        if (type == GL_UNSIGNED_BYTE) *component = static_cast<uint8_t>(rng() % 251);
+                        else if (type == GL_UNSIGNED_SHORT) {
+                            auto value = static_cast<uint16_t>(rng() % (65536 / scaleValue - 7));
+                            std::memcpy(component, &value, sizeof(value));
+                        } else if (type == GL_UNSIGNED_INT) {
+                            auto value = static_cast<uint32_t>(rng() >> 1);
+                            std::memcpy(component, &value, sizeof(value));
+                        } else {
+                            auto value = std::uniform_real_distribution<float>(-0.5f, 13.0f)(rng);
+                            std::memcpy(component, &value, sizeof(value));
+                        }
+                    }
+                }
+                view.data = data.data();
+            }
+
+            /** Holds the raw data. */
+            std::vector<uint8_t> data;
+            /** Holds the view on the raw data. */
+            VolumeDataView view;
+        };
+
+        /** Copies the voxels of a view to a tightly packed buffer. */
+        inline std::vector<uint8_t> GatherVoxels(const VolumeDataView& view)
+        {
+            std::vector<uint8_t> packed(static_cast<std::size_t>(view.GetNumVoxels() * view.bytesPerVoxel));
+            for (uint64_t v = 0; v < view.GetNumVoxels(); ++v) std::memcpy(packed.data() + v * view.bytesPerVoxel, view.GetVoxel(v), view.bytesPerVoxel);
+            return packed;
+        }
+
+        /** Applies a function to each value of a buffer like the original volume loading code did. */
+        template<typename O, typename I>
+        std::vector<O> ReadModifyReference(const std::vector<uint8_t>& raw, std::function<O(const I&)> modify)
+        {
+            auto numElements = raw.size() / sizeof(I);
+            std::vector<O> result(numElements);
+            for (std::size_t i = 0; i < numElements; ++i) {
+                I value;
+                std::memcpy(&value, raw.data() + i * sizeof(I), sizeof(I));
+                result[i] = modify(value);
+            }
+            return result;
+        }
+
+        /** Converts all values to float in [0, 1] per value, as the volume loading code did before the conversion was chunked. */
+        inline std::vector<float> ConvertToFloatReference(const VolumeDataView& view, float& maxValue)
+        {
+            auto raw = GatherVoxels(view);
+            auto scaleValue = view.scaleValue;
+            maxValue = 0.0f;
+            if (view.type == GL_UNSIGNED_BYTE) {
+                return ReadModifyReference<float, uint8_t>(raw, [&maxValue](const uint8_t& val)
+                {
+                    auto value = static_cast<float>(val) / static_cast<float>(std::numeric_limits<uint8_t>::max());
+                    maxValue = glm::max(maxValue, value);
+                    return value;
+                });
+            } else if (view.type == GL_UNSIGNED_SHORT) {
+                return ReadModifyReference<float, uint16_t>(raw, [scaleValue, &maxValue](const uint16_t& val)
+                {
+                    auto value = static_cast<float>(val * scaleValue) / static_cast<float>(std::numeric_limits<uint16_t>::max());
+                    maxValue = glm::max(maxValue, value);
+                    return value;
+                });
+            } else if (view.type == GL_UNSIGNED_INT) {
+                return ReadModifyReference<float, uint32_t>(raw, [&maxValue](const uint32_t& val)
+                {
+                    auto value = static_cast<float>(val) / static_cast<float>(std::numeric_limits<uint32_t>::max());
+                    maxValue = glm::max(maxValue, value);
+                    return value;
+                });
+            }
+            return ReadModifyReference<float, float>(raw, [&maxValue](const float& val)
+            {
+                maxValue = glm::max(maxValue, val);
+                return val;
+            });
+        }
+
+        /** Returns the maximum converted value (at least 0) computed per value. */
+        inline float FindMaximumReference(const VolumeDataView& view)
+        {
+            auto maxValue = 0.0f;
+            ConvertToFloatReference(view, maxValue);
+            return maxValue;
+        }
+
+        /** Converts and normalizes all values in two passes, as the volume loading code did before the conversion was chunked. */
+        inline std::vector<float> ConvertToNormalizedFloatReference(const VolumeDataView& view)
+        {
+            auto maxValue = 0.0f;
+            auto data = ConvertToFloatReference(view, maxValue);
+            for (auto& value : data) value = value / maxValue;
+            return data;
+        }
+
+        /** Checks if two floats have the same bit pattern. */
+        inline bool IsBitExact(float a, float b) { return std::memcmp(&a, &b, sizeof(float)) == 0; }
+
+        /** Checks if two float buffers have the same bit patterns. */
+        inline bool IsBitExact(const std::vector<float>& a, const std::vector<float>& b)
+        {
+            return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(float)) == 0;
+        }
+    }
+}
+
+#endif // VOLUMEDATAREFERENCE_H
@@ -0,0 +1,35 @@
+/**
+ * @file   VolumeDownsamplerBenchmark.cpp
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Compares the separable slab wise downsampler with the voxel by voxel reference.
+ */
+
+#include "TestHelper.h"
+#include "VolumeDataReference.h"
+#include "core/parallel_helper.h"
+#include "gfx/volumes/VolumeDownsampler.h"
+
+using namespace cgu;
+
+int main(int argc, char** argv)
+{
+    auto edge = argc > 1 ? static_cast<unsigned int>(std::stoul(argv[1])) : 128u;
+    const DownsampleFilter filters[] = { DownsampleFilter::BOX, DownsampleFilter::MIN, DownsampleFilter::MAX, DownsampleFilter::LANCZOS };
+    const char* filterNames[] = { "BOX", "MIN", "MAX", "LANCZOS" };
+
+    std::cout << "Downsampling " << edge << "^3 voxels with " << parallel::GetNumThreads() << " threads." << std::endl;
+    test::VolumeTestData volume(glm::uvec3(edge), GL_UNSIGNED_SHORT, 1);
+    auto targetSize = glm::max(glm::uvec3(edge / 2), glm::uvec3(1));
+    for (auto f = 0; f < 4; ++f) {
+        std::vector<uint8_t> reference, single, result;
+        auto referenceTime = test::MeasureSeconds([&]() { VolumeDownsampler(filters[f], 1).DownsampleReference(volume.view, targetSize, reference); });
+        auto singleTime = test::MeasureSeconds([&]() { VolumeDownsampler(filters[f], 1).Downsample(volume.view, targetSize, single); });
+        auto parallelTime = test::MeasureSeconds([&]() { VolumeDownsampler(filters[f]).Downsample(volume.view, targetSize, result); });
+        std::cout << filterNames[f] << ": reference " << referenceTime * 1000.0 << "ms, separable (1 thread) " << singleTime * 1000.0
+            << "ms, separable " << parallelTime * 1000.0 << "ms, speedup " << referenceTime / parallelTime
+            << (result == reference && single == reference ? "" : " (results differ!)") << std::endl;
+    }
+    return 0;
+}
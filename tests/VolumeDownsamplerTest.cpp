@@ -0,0 +1,93 @@
+/**
+ * @file   VolumeDownsamplerTest.cpp
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Tests the separable downsampler against its voxel by voxel reference.
+ */
+
+#include "TestHelper.h"
+#include "VolumeDataReference.h"
+#include "gfx/volumes/VolumeDownsampler.h"
+#include <fstream>
+
+using namespace cgu;
+
+namespace {
+
+    void TestAgainstReference(DownsampleFilter filter, GLenum type, unsigned int numComponents, const glm::uvec3& size,
+        const glm::uvec3& targetSize, bool strided)
+    {
+        test::VolumeTestData volume(size, type, numComponents, 1, strided ? 4 : 0);
+        std::vector<uint8_t> reference;
+        VolumeDownsampler(filter, 1).DownsampleReference(volume.view, targetSize, reference);
+        for (auto numThreads : { 1u, 3u }) {
+            std::vector<uint8_t> result;
+            VolumeDownsampler(filter, numThreads).Downsample(volume.view, targetSize, result);
+            FWLIB_CHECK(result == reference);
+        }
+    }
+
+    void TestFilterValues()
+    {
+        // a 4x1x1 volume halved: box averages, min and max pick the extremes of each pair.
+        test::VolumeTestData volume(glm::uvec3(4, 1, 1), GL_UNSIGNED_BYTE, 1);
+        volume.data = { 10, 30, 200, 100 };
+        volume.view.data = volume.data.data();
+
+        std::vector<uint8_t> result;
+        VolumeDownsampler(DownsampleFilter::BOX).Downsample(volume.view, glm::uvec3(2, 1, 1), result);
+        FWLIB_CHECK(result == std::vector<uint8_t>({ 20, 150 }));
+        VolumeDownsampler(DownsampleFilter::MIN).Downsample(volume.view, glm::uvec3(2, 1, 1), result);
+        FWLIB_CHECK(result == std::vector<uint8_t>({ 10, 100 }));
+        VolumeDownsampler(DownsampleFilter::MAX).Downsample(volume.view, glm::uvec3(2, 1, 1), result);
+        FWLIB_CHECK(result == std::vector<uint8_t>({ 30, 200 }));
+
+        // Lanczos preserves constant volumes.
+        test::VolumeTestData constant(glm::uvec3(9, 7, 5), GL_FLOAT, 1);
+        auto values = reinterpret_cast<float*>(constant.data.data());
+        std::fill(values, values + constant.view.GetNumVoxels(), 3.0f);
+        VolumeDownsampler(DownsampleFilter::LANCZOS).Downsample(constant.view, glm::uvec3(4, 3, 2), result);
+        auto resultValues = reinterpret_cast<const float*>(result.data());
+        auto maxError = 0.0f;
+        for (std::size_t i = 0; i < result.size() / sizeof(float); ++i) maxError = glm::max(maxError, glm::abs(resultValues[i] - 3.0f));
+        FWLIB_CHECK(maxError < 1e-5f);
+    }
+
+    void TestLODChain(const test::TemporaryDirectory& dir)
+    {
+        test::VolumeTestData volume(glm::uvec3(13, 6, 3), GL_UNSIGNED_SHORT, 2);
+        VolumeDownsampler downsampler(DownsampleFilter::BOX, 2);
+        FWLIB_CHECK(VolumeDownsampler::GetNumLODLevels(volume.view.size) == 3);
+
+        auto levels = downsampler.CreateLODChain(volume.view);
+        FWLIB_CHECK(levels.size() == 3);
+        FWLIB_CHECK(levels[0].size == glm::uvec3(6, 3, 1) && levels[1].size == glm::uvec3(3, 1, 1) && levels[2].size == glm::uvec3(1));
+
+        auto datFilenames = downsampler.WriteLODChain(volume.view, glm::vec3(1.0f), dir.GetFile("chain"));
+        FWLIB_CHECK(datFilenames.size() == levels.size());
+        for (std::size_t i = 0; i < levels.size(); ++i) {
+            std::ifstream raw(dir.GetFile("chain_" + std::to_string(i + 1) + ".raw"), std::ios::binary);
+            std::vector<uint8_t> rawData((std::istreambuf_iterator<char>(raw)), std::istreambuf_iterator<char>());
+            FWLIB_CHECK(rawData == levels[i].data);
+        }
+    }
+}
+
+int main(int, char**)
+{
+    const DownsampleFilter filters[] = { DownsampleFilter::BOX, DownsampleFilter::MIN, DownsampleFilter::MAX, DownsampleFilter::LANCZOS };
+    for (auto filter : filters) {
+        for (auto type : { GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT, GL_UNSIGNED_INT, GL_FLOAT }) {
+            TestAgainstReference(filter, type, 1, glm::uvec3(17, 11, 13), glm::uvec3(8, 5, 6), false);
+            TestAgainstReference(filter, type, 3, glm::uvec3(9, 10, 7), glm::uvec3(4, 7, 3), true);
+        }
+        // non-integer ratios and more output slices than fit into one slab.
+        TestAgainstReference(filter, GL_UNSIGNED_BYTE, 2, glm::uvec3(7, 5, 97), glm::uvec3(3, 5, 41), false);
+        TestAgainstReference(filter, GL_FLOAT, 1, glm::uvec3(5, 4, 70), glm::uvec3(5, 1, 70), false);
+    }
+    TestFilterValues();
+    test::TemporaryDirectory dir;
+    TestLODChain(dir);
+    return test::Finish("VolumeDownsamplerTest");
+}
@@ -0,0 +1,69 @@
+/**
+ * @file   VolumeSamplerBenchmark.cpp
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Compares batched trilinear sampling of the sampler layouts with the scalar reference along the three axes.
+ */
+
+#include "TestHelper.h"
+#include "gfx/volumes/VolumeSampler.h"
+#include <random>
+
+using namespace cgu;
+
+int main(int argc, char** argv)
+{
+    auto edge = argc > 1 ? static_cast<unsigned int>(std::stoul(argv[1])) : 256u;
+    const glm::uvec3 size(edge);
+    const unsigned int numRays = 4096, numSamples = edge;
+    const char* layoutNames[] = { "linear", "tiled", "Morton" };
+    const char* axisNames[] = { "x", "y", "z" };
+
+    std::vector<float> values(static_cast<std::size_t>(size.x) * size.y * size.z);
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+    for (auto& value : values) value = distribution(rng);
+
+    // rays start at random positions and march through the volume along one axis.
+    std::array<std::vector<glm::vec3>, 3> rayStarts;
+    for (auto& starts : rayStarts) {
+        starts.resize(numRays);
+        for (auto& start : starts) start = glm::vec3(distribution(rng), distribution(rng), distribution(rng));
+    }
+    std::vector<glm::vec3> positions(numSamples);
+    std::vector<float> results(numSamples);
+
+    std::cout << "Sampling " << numRays << " rays of " << numSamples << " trilinear samples in " << edge << "^3 voxels (single thread)." << std::endl;
+    for (int axis = 0; axis < 3; ++axis) {
+        auto sum = 0.0f;
+        auto referenceTime = test::MeasureSeconds([&]() {
+            for (const auto& start : rayStarts[axis]) {
+                for (unsigned int i = 0; i < numSamples; ++i) {
+                    auto position = start;
+                    position[axis] = (static_cast<float>(i) + 0.5f) / static_cast<float>(numSamples);
+                    sum += VolumeSampler::SampleTrilinearReference(values.data(), size, position);
+                }
+            }
+        });
+        std::cout << "along " << axisNames[axis] << ": reference " << referenceTime * 1000.0 << "ms";
+
+        for (auto l = 0; l < 3; ++l) {
+            VolumeSampler sampler(values.data(), size, static_cast<VolumeLayout>(l));
+            auto batchedSum = 0.0f;
+            auto time = test::MeasureSeconds([&]() {
+                for (const auto& start : rayStarts[axis]) {
+                    for (unsigned int i = 0; i < numSamples; ++i) {
+                        positions[i] = start;
+                        positions[i][axis] = (static_cast<float>(i) + 0.5f) / static_cast<float>(numSamples);
+                    }
+                    sampler.SampleTrilinear(positions.data(), results.data(), numSamples);
+                    for (auto result : results) batchedSum += result;
+                }
+            });
+            std::cout << ", " << layoutNames[l] << " " << time * 1000.0 << "ms" << (batchedSum == sum ? "" : " (results differ!)");
+        }
+        std::cout << std::endl;
+    }
+    return 0;
+}
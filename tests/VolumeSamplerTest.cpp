@@ -0,0 +1,106 @@
+/**
+ * @file   VolumeSamplerTest.cpp
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Tests the layouts and the batched sampling of the CPU volume sampler against the reference functions.
+ */
+
+#include "TestHelper.h"
+#include "VolumeDataReference.h"
+#include "gfx/volumes/VolumeSampler.h"
+#include <random>
+
+using namespace cgu;
+
+namespace {
+
+    std::vector<float> CreateValues(const glm::uvec3& size)
+    {
+        std::vector<float> values(static_cast<std::size_t>(size.x) * size.y * size.z);
+        std::mt19937 rng(5);
+        std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+        for (auto& value : values) value = distribution(rng);
+        return values;
+    }
+
+    void TestLayout(VolumeLayout layout, const glm::uvec3& size)
+    {
+        auto values = CreateValues(size);
+        VolumeSampler sampler(values.data(), size, layout, 3);
+        FWLIB_CHECK(sampler.GetSize() == size && sampler.GetLayout() == layout);
+
+        // every voxel has its own address and keeps its value.
+        std::vector<bool> used(static_cast<std::size_t>(sampler.GetStorageSize() / sizeof(float)), false);
+        auto numWrong = 0;
+        for (unsigned int z = 0; z < size.z; ++z) for (unsigned int y = 0; y < size.y; ++y) for (unsigned int x = 0; x < size.x; ++x) {
+            auto address = sampler.GetAddress(glm::uvec3(x, y, z));
+            if (address >= used.size() || used[address]) ++numWrong;
+            else used[address] = true;
+            if (sampler.GetVoxel(glm::uvec3(x, y, z)) != values[(static_cast<std::size_t>(z) * size.y + y) * size.x + x]) ++numWrong;
+        }
+        FWLIB_CHECK(numWrong == 0);
+
+        // random positions including positions outside the volume, counts that are no multiple of the batch size.
+        std::mt19937 rng(9);
+        std::uniform_real_distribution<float> distribution(-0.3f, 1.3f);
+        std::vector<glm::vec3> positions(1001);
+        for (auto& position : positions) position = glm::vec3(distribution(rng), distribution(rng), distribution(rng));
+        positions[0] = glm::vec3(0.0f);
+        positions[1] = glm::vec3(1.0f);
+        auto centerVoxel = glm::min(glm::uvec3(3), size - glm::uvec3(1));
+        positions[2] = (glm::vec3(centerVoxel) + glm::vec3(0.5f)) / glm::vec3(size);
+
+        for (auto count : { std::size_t(1), std::size_t(3), std::size_t(17), positions.size() }) {
+            std::vector<float> nearest(count), trilinear(count);
+            std::vector<glm::vec3> gradients(count);
+            sampler.SampleNearest(positions.data(), nearest.data(), count);
+            sampler.SampleTrilinear(positions.data(), trilinear.data(), count);
+            sampler.SampleGradient(positions.data(), gradients.data(), count);
+            auto numMismatches = 0;
+            for (std::size_t i = 0; i < count; ++i) {
+                if (nearest[i] != VolumeSampler::SampleNearestReference(values.data(), size, positions[i])) ++numMismatches;
+                if (trilinear[i] != VolumeSampler::SampleTrilinearReference(values.data(), size, positions[i])) ++numMismatches;
+                if (gradients[i] != VolumeSampler::SampleGradientReference(values.data(), size, positions[i])) ++numMismatches;
+                if (sampler.SampleTrilinear(positions[i]) != trilinear[i] || sampler.SampleNearest(positions[i]) != nearest[i]) ++numMismatches;
+            }
+            FWLIB_CHECK(numMismatches == 0);
+        }
+
+        // voxel centers return the voxel values.
+        FWLIB_CHECK(sampler.SampleTrilinear(positions[2]) == sampler.GetVoxel(centerVoxel));
+    }
+
+    void TestMortonPadding()
+    {
+        // each axis is padded to a power of two on its own, so sizes just above a power of two need up to 8x the memory.
+        std::vector<float> values(static_cast<std::size_t>(17) * 5 * 2, 0.5f);
+        VolumeSampler morton(values.data(), glm::uvec3(17, 5, 2), VolumeLayout::MORTON, 1);
+        FWLIB_CHECK(morton.GetStorageSize() == 32 * 8 * 2 * sizeof(float));
+        VolumeSampler linear(values.data(), glm::uvec3(17, 5, 2), VolumeLayout::LINEAR, 1);
+        FWLIB_CHECK(linear.GetStorageSize() == values.size() * sizeof(float));
+    }
+
+    void TestRawData()
+    {
+        test::VolumeTestData volume(glm::uvec3(9, 6, 5), GL_UNSIGNED_SHORT, 1, 1, 4);
+        VolumeSampler sampler(volume.view, VolumeLayout::TILED, 2);
+        auto reference = test::ConvertToNormalizedFloatReference(volume.view);
+        FWLIB_CHECK(sampler.GetVoxel(glm::uvec3(4, 2, 3)) == reference[(3 * 6 + 2) * 9 + 4]);
+
+        test::VolumeTestData rgb(glm::uvec3(4), GL_UNSIGNED_BYTE, 3);
+        FWLIB_CHECK_THROWS(VolumeSampler(rgb.view, VolumeLayout::LINEAR), std::runtime_error);
+    }
+}
+
+int main(int, char**)
+{
+    for (auto layout : { VolumeLayout::LINEAR, VolumeLayout::TILED, VolumeLayout::MORTON }) {
+        TestLayout(layout, glm::uvec3(16, 16, 16));
+        TestLayout(layout, glm::uvec3(19, 7, 33));
+        TestLayout(layout, glm::uvec3(1, 3, 2));
+    }
+    TestMortonPadding();
+    TestRawData();
+    return test::Finish("VolumeSamplerTest");
+}
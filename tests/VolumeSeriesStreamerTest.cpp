@@ -0,0 +1,185 @@
+/**
+ * @file   VolumeSeriesStreamerTest.cpp
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Tests prefetching, failure handling and double buffered playback of volume series.
+ */
+
+#include "TestHelper.h"
+#include "gfx/volumes/VolumeSeriesStreamer.h"
+#include <condition_variable>
+#include <map>
+#include <thread>
+
+using namespace cgu;
+
+namespace {
+
+    const glm::uvec3 stepSize(4, 3, 8);
+
+    /** Loads steps filled with their step number, steps can be held back and made to fail. */
+    struct TestLoader
+    {
+        VolumeTextureData Load(unsigned int step, const AsyncVolumeLoad::ProgressFunction&)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            ++numLoads[step];
+            condition.wait(lock, [this, step]() { return heldStep != step; });
+            if (failuresLeft[step] > 0) {
+                --failuresLeft[step];
+                throw std::runtime_error("test failure");
+            }
+            VolumeTextureData data;
+            data.size = stepSize;
+            data.data.resize(static_cast<std::size_t>(stepSize.x) * stepSize.y * stepSize.z, static_cast<uint8_t>(step));
+            return data;
+        }
+
+        void Hold(unsigned int step) { std::lock_guard<std::mutex> lock(mutex); heldStep = step; }
+        void Release() { { std::lock_guard<std::mutex> lock(mutex); heldStep = std::numeric_limits<unsigned int>::max(); } condition.notify_all(); }
+        void SetFailures(unsigned int step, unsigned int failures) { std::lock_guard<std::mutex> lock(mutex); failuresLeft[step] = failures; }
+        unsigned int GetNumLoads(unsigned int step) { std::lock_guard<std::mutex> lock(mutex); return numLoads[step]; }
+
+        VolumeSeriesStreamer::LoadFunction GetFunction() { return [this](unsigned int step, const AsyncVolumeLoad::ProgressFunction& progress) { return Load(step, progress); }; }
+
+        std::mutex mutex;
+        std::condition_variable condition;
+        unsigned int heldStep = std::numeric_limits<unsigned int>::max();
+        std::map<unsigned int, unsigned int> failuresLeft;
+        std::map<unsigned int, unsigned int> numLoads;
+    };
+
+    /** Records the uploaded slices of a step. */
+    class TestSink final : public VolumeUploadSink
+    {
+    public:
+        void BeginUpload(const VolumeTextureData& data) override { step = data.data[0]; uploadedSlices.clear(); complete = false; }
+        void UploadSlices(const VolumeTextureData&, unsigned int firstSlice, unsigned int numSlices) override
+        {
+            for (auto z = firstSlice; z < firstSlice + numSlices; ++z) uploadedSlices.push_back(z);
+            ++numUploadCalls;
+        }
+        void EndUpload() override { complete = true; }
+
+        unsigned int step = 0;
+        std::vector<unsigned int> uploadedSlices;
+        unsigned int numUploadCalls = 0;
+        bool complete = false;
+    };
+
+    /** Waits until a condition holds, returns false after a few seconds. */
+    template<typename F> bool WaitUntil(F condition)
+    {
+        for (auto i = 0; i < 5000; ++i) {
+            if (condition()) return true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return false;
+    }
+
+    void TestPrefetching()
+    {
+        TestLoader loader;
+        VolumeSeriesStreamer streamer(10, loader.GetFunction(), 3, 2);
+        FWLIB_CHECK(streamer.GetPrefetchCount() == 3);
+
+        auto data = streamer.WaitForStep(0);
+        FWLIB_CHECK(data && data->size == stepSize && data->data[0] == 0);
+        FWLIB_CHECK(WaitUntil([&streamer]() { return streamer.IsStepReady(1) && streamer.IsStepReady(2) && streamer.IsStepReady(3); }));
+        FWLIB_CHECK(!streamer.IsStepReady(4));
+
+        // the prefetched steps are served without waiting and are loaded once until they leave the window.
+        for (unsigned int step = 1; step < 10; ++step) {
+            FWLIB_CHECK(WaitUntil([&streamer, step]() { return streamer.IsStepReady(step); }));
+            data = streamer.RequestStep(step);
+            FWLIB_CHECK(data && data->data[0] == step);
+            FWLIB_CHECK(loader.GetNumLoads(step) == 1);
+        }
+        auto stats = streamer.GetStatistics();
+        FWLIB_CHECK(stats.stepRequests == 10 && stats.prefetchHits == 9 && stats.loadsFailed == 0);
+        FWLIB_CHECK(stats.bytesLoaded >= 10 * data->data.size());
+
+        // looping prefetches the first steps, without looping they are not loaded.
+        FWLIB_CHECK(WaitUntil([&streamer]() { return streamer.IsStepReady(0) && streamer.IsStepReady(2); }));
+        streamer.SetLooping(false);
+        streamer.RequestStep(5);
+        streamer.RequestStep(9);
+        FWLIB_CHECK(WaitUntil([&streamer]() { return streamer.IsStepReady(9); }));
+        FWLIB_CHECK(!streamer.IsStepReady(0));
+    }
+
+    void TestFailures()
+    {
+        TestLoader loader;
+        loader.SetFailures(2, 2);
+        loader.SetFailures(4, 100);
+        VolumeSeriesStreamer streamer(6, loader.GetFunction(), 1, 1);
+        streamer.SetLooping(false);
+
+        // a step failing fewer times than the retries is loaded.
+        FWLIB_CHECK(streamer.WaitForStep(2)->data[0] == 2);
+        FWLIB_CHECK(loader.GetNumLoads(2) == 3 && streamer.GetStatistics().loadsFailed == 2);
+
+        // a step that keeps failing is reported once the retries are used up.
+        auto thrown = false;
+        try { streamer.WaitForStep(4); }
+        catch (const std::runtime_error&) { thrown = true; }
+        FWLIB_CHECK(thrown);
+        FWLIB_CHECK(loader.GetNumLoads(4) == 3);
+        FWLIB_CHECK(streamer.RequestStep(4) == nullptr);
+        FWLIB_CHECK(loader.GetNumLoads(4) == 3);
+
+        // requesting the step anew retries it, the buffer of a failed step that left the window is reused.
+        loader.SetFailures(4, 0);
+        FWLIB_CHECK(streamer.WaitForStep(3)->data[0] == 3);
+        FWLIB_CHECK(streamer.WaitForStep(4)->data[0] == 4);
+        FWLIB_CHECK(loader.GetNumLoads(4) == 4);
+        FWLIB_CHECK(streamer.WaitForStep(0)->data[0] == 0);
+        FWLIB_CHECK(streamer.WaitForStep(1)->data[0] == 1);
+    }
+
+    void TestPlayback()
+    {
+        TestLoader loader;
+        VolumeSeriesStreamer streamer(4, loader.GetFunction(), 2, 1);
+        TestSink sink0, sink1;
+        auto sliceSize = static_cast<uint64_t>(stepSize.x) * stepSize.y;
+        VolumeSeriesPlayer player(&streamer, &sink0, &sink1, sliceSize * 3);
+        FWLIB_CHECK(!player.HasDisplayedStep());
+
+        // without time budget each update uploads a single slab of 3 slices to the back sink.
+        streamer.WaitForStep(0);
+        auto frontIndex = player.GetFrontIndex();
+        FWLIB_CHECK(!player.Update(0, std::chrono::microseconds(0)));
+        FWLIB_CHECK(!player.Update(0, std::chrono::microseconds(0)));
+        FWLIB_CHECK(player.Update(0, std::chrono::microseconds(0)));
+        FWLIB_CHECK(player.HasDisplayedStep() && player.GetDisplayedStep() == 0 && player.GetFrontIndex() != frontIndex);
+        auto front = static_cast<TestSink*>(player.GetFrontSink());
+        FWLIB_CHECK(front->complete && front->step == 0 && front->numUploadCalls == 3);
+        FWLIB_CHECK(front->uploadedSlices == std::vector<unsigned int>({ 0, 1, 2, 3, 4, 5, 6, 7 }));
+        FWLIB_CHECK(player.Update(0, std::chrono::microseconds(0)));
+
+        // a step that is not loaded yet keeps the previous one on display.
+        loader.Hold(3);
+        streamer.WaitForStep(2);
+        FWLIB_CHECK(!player.Update(3, std::chrono::microseconds(0)));
+        FWLIB_CHECK(player.GetDisplayedStep() == 0 && player.GetFrontSink() == front && front->complete);
+
+        // with a large budget the whole step is uploaded at once and the sinks are swapped.
+        loader.Release();
+        FWLIB_CHECK(WaitUntil([&player]() { return player.Update(3, std::chrono::seconds(10)); }));
+        FWLIB_CHECK(player.GetDisplayedStep() == 3 && player.GetFrontSink() != front);
+        auto back = static_cast<TestSink*>(player.GetFrontSink());
+        FWLIB_CHECK(back->complete && back->step == 3 && back->uploadedSlices.size() == stepSize.z);
+        FWLIB_CHECK(front->step == 0);
+    }
+}
+
+int main(int, char**)
+{
+    TestPrefetching();
+    TestFailures();
+    TestPlayback();
+    return test::Finish("VolumeSeriesStreamerTest");
+}
@@ -0,0 +1,166 @@
+/**
+ * @file   VolumeStatisticsTest.cpp
+ * @author Sebastian Maisch <sebastian.maisch@uni-ulm.de>
+ * @date   2026.10.16
+ *
+ * @brief  Tests the volume statistics against a brute force reference and on synthetic distributions.
+ */
+
+#include "TestHelper.h"
+#include "VolumeDataReference.h"
+#include "gfx/volumes/VolumeStatistics.h"
+#include <algorithm>
+
+using namespace cgu;
+
+namespace {
+
+    const float maxGradientLength = 0.8660254f;
+
+    /** Computes the statistics voxel by voxel. */
+    struct StatisticsReference
+    {
+        StatisticsReference(const VolumeDataView& view, unsigned int numBins, unsigned int numGradientBins, const glm::uvec3& brickSize) :
+            histogram(numBins, 0),
+            gradientHistogram(static_cast<std::size_t>(numGradientBins) * numGradientBins, 0)
+        {
+            auto values = test::ConvertToNormalizedFloatReference(view);
+            const auto& size = view.size;
+            auto value = [&values, &size](int x, int y, int z) {
+                auto p = glm::clamp(glm::ivec3(x, y, z), glm::ivec3(0), glm::ivec3(size) - glm::ivec3(1));
+                return values[(static_cast<std::size_t>(p.z) * size.y + p.y) * size.x + p.x];
+            };
+
+            auto numBricks = (size + brickSize - glm::uvec3(1)) / brickSize;
+            brickMin.resize(static_cast<std::size_t>(numBricks.x) * numBricks.y * numBricks.z, std::numeric_limits<float>::max());
+            brickMax.resize(brickMin.size(), std::numeric_limits<float>::lowest());
+            brickMean.resize(brickMin.size(), 0.0);
+            std::vector<uint64_t> brickCount(brickMin.size(), 0);
+
+            auto numBinsF = static_cast<float>(numBins);
+            auto numGradientBinsF = static_cast<float>(numGradientBins);
+            double sum = 0.0;
+            for (auto z = 0; z < static_cast<int>(size.z); ++z) for (auto y = 0; y < static_cast<int>(size.y); ++y) for (auto x = 0; x < static_cast<int>(size.x); ++x) {
+                auto v = value(x, y, z);
+                auto gx = (value(x + 1, y, z) - value(x - 1, y, z)) * 0.5f;
+                auto gy = (value(x, y + 1, z) - value(x, y - 1, z)) * 0.5f;
+                auto gz = (value(x, y, z + 1) - value(x, y, z - 1)) * 0.5f;
+                auto gradient = glm::sqrt(gx * gx + gy * gy + gz * gz);
+                ++histogram[static_cast<unsigned int>(glm::clamp(v * numBinsF, 0.0f, numBinsF - 1.0f))];
+                auto valueBin2D = static_cast<unsigned int>(glm::clamp(v * numGradientBinsF, 0.0f, numGradientBinsF - 1.0f));
+                auto gradientBin = static_cast<unsigned int>(glm::clamp(gradient / maxGradientLength * numGradientBinsF, 0.0f, numGradientBinsF - 1.0f));
+                ++gradientHistogram[gradientBin * numGradientBins + valueBin2D];
+
+                auto brick = glm::uvec3(x, y, z) / brickSize;
+                auto brickIdx = (static_cast<std::size_t>(brick.z) * numBricks.y + brick.y) * numBricks.x + brick.x;
+                brickMin[brickIdx] = glm::min(brickMin[brickIdx], v);
+                brickMax[brickIdx] = glm::max(brickMax[brickIdx], v);
+                brickMean[brickIdx] += v;
+                ++brickCount[brickIdx];
+                sum += v;
+            }
+            for (std::size_t i = 0; i < brickMean.size(); ++i) brickMean[i] /= static_cast<double>(brickCount[i]);
+
+            mean = sum / static_cast<double>(values.size());
+            for (auto v : values) variance += (v - mean) * (v - mean);
+            variance /= static_cast<double>(values.size());
+        }
+
+        std::vector<uint64_t> histogram;
+        std::vector<uint64_t> gradientHistogram;
+        std::vector<float> brickMin;
+        std::vector<float> brickMax;
+        std::vector<double> brickMean;
+        double mean = 0.0;
+        double variance = 0.0;
+    };
+
+    bool IsClose(double a, double b) { return glm::abs(a - b) <= 1e-6 * glm::max(1.0, glm::abs(b)); }
+
+    void TestAgainstReference(GLenum type, const glm::uvec3& size, const glm::uvec3& brickSize)
+    {
+        test::VolumeTestData volume(size, type, 1);
+        const unsigned int numBins = 64, numGradientBins = 16;
+        StatisticsReference reference(volume.view, numBins, numGradientBins, brickSize);
+
+        VolumeStatistics singleThreaded(volume.view, numBins, numGradientBins, brickSize, 1);
+        for (auto numThreads : { 1u, 2u, 3u }) {
+            VolumeStatistics statistics(volume.view, numBins, numGradientBins, brickSize, numThreads);
+            FWLIB_CHECK(statistics.GetNumVoxels() == volume.view.GetNumVoxels());
+            FWLIB_CHECK(statistics.GetHistogram() == reference.histogram);
+            FWLIB_CHECK(statistics.GetGradientHistogram() == reference.gradientHistogram);
+            FWLIB_CHECK(IsClose(statistics.GetMean(), reference.mean));
+            FWLIB_CHECK(IsClose(statistics.GetVariance(), reference.variance));
+            // moments are merged in a fixed order, so they are bit exact for any number of threads.
+            FWLIB_CHECK(statistics.GetMean() == singleThreaded.GetMean() && statistics.GetVariance() == singleThreaded.GetVariance());
+
+            const auto& bricks = statistics.GetBrickSummaries();
+            FWLIB_CHECK(bricks.size() == reference.brickMin.size());
+            auto numBrickMismatches = 0;
+            for (std::size_t i = 0; i < bricks.size(); ++i) {
+                if (bricks[i].minValue != reference.brickMin[i] || bricks[i].maxValue != reference.brickMax[i]
+                    || !IsClose(bricks[i].meanValue, reference.brickMean[i])) ++numBrickMismatches;
+            }
+            FWLIB_CHECK(numBrickMismatches == 0);
+        }
+    }
+
+    void TestUniformDistribution()
+    {
+        // every 8 bit value occurs 4 times.
+        test::VolumeTestData volume(glm::uvec3(256, 2, 2), GL_UNSIGNED_BYTE, 1);
+        for (std::size_t i = 0; i < volume.data.size(); ++i) volume.data[i] = static_cast<uint8_t>(i % 256);
+
+        VolumeStatistics statistics(volume.view);
+        FWLIB_CHECK(statistics.GetHistogram().size() == 256);
+        FWLIB_CHECK(std::all_of(statistics.GetHistogram().begin(), statistics.GetHistogram().end(), [](uint64_t count) { return count == 4; }));
+        FWLIB_CHECK(statistics.GetMinValue() == 0.0f && statistics.GetMaxValue() == 1.0f);
+        FWLIB_CHECK(IsClose(statistics.GetMean(), 0.5));
+        FWLIB_CHECK(glm::abs(statistics.GetPercentile(0.5f) - 0.5f) < 1e-6f);
+        FWLIB_CHECK(glm::abs(statistics.GetPercentile(0.25f) - 0.25f) < 1e-6f);
+        auto window = statistics.GetWindow(0.1f, 0.9f);
+        FWLIB_CHECK(glm::abs(window.x - 0.1f) < 1e-6f && glm::abs(window.y - 0.9f) < 1e-6f);
+    }
+
+    void TestConstantVolume()
+    {
+        test::VolumeTestData volume(glm::uvec3(5, 6, 7), GL_UNSIGNED_SHORT, 1);
+        std::fill(volume.data.begin(), volume.data.end(), static_cast<uint8_t>(0));
+
+        VolumeStatistics statistics(volume.view, 16, 8);
+        FWLIB_CHECK(statistics.GetHistogram()[0] == volume.view.GetNumVoxels());
+        FWLIB_CHECK(statistics.GetVariance() == 0.0 && statistics.GetMean() == 0.0);
+        auto window = statistics.GetWindow();
+        FWLIB_CHECK(window.x < window.y && window.y <= 1.0f / 16.0f);
+    }
+
+    void TestCache(const test::TemporaryDirectory& dir)
+    {
+        test::VolumeTestData volume(glm::uvec3(9, 10, 11), GL_FLOAT, 1);
+        VolumeStatistics statistics(volume.view, 32, 8, glm::uvec3(4));
+        auto filename = dir.GetFile("volume_statistics.cache");
+        VolumeCacheKey key(1, volumeCache::HashString(VolumeStatistics::GetParameterString(32, 8, glm::uvec3(4))));
+        statistics.SaveToCache(filename, key);
+
+        VolumeStatistics cached;
+        FWLIB_CHECK(!cached.LoadFromCache(filename, VolumeCacheKey(2, key.parameterHash)));
+        FWLIB_CHECK(cached.LoadFromCache(filename, key));
+        FWLIB_CHECK(cached.GetHistogram() == statistics.GetHistogram() && cached.GetGradientHistogram() == statistics.GetGradientHistogram());
+        FWLIB_CHECK(cached.GetMean() == statistics.GetMean() && cached.GetVariance() == statistics.GetVariance());
+        FWLIB_CHECK(cached.GetNumBricks() == statistics.GetNumBricks() && cached.GetBrickSummaries().size() == statistics.GetBrickSummaries().size());
+    }
+}
+
+int main(int, char**)
+{
+    for (auto type : { GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT, GL_FLOAT }) {
+        TestAgainstReference(type, glm::uvec3(17, 13, 11), glm::uvec3(4, 5, 3));
+        TestAgainstReference(type, glm::uvec3(8, 8, 8), glm::uvec3(8));
+    }
+    TestAgainstReference(GL_UNSIGNED_BYTE, glm::uvec3(3, 1, 2), glm::uvec3(2));
+    TestUniformDistribution();
+    TestConstantVolume();
+    test::TemporaryDirectory dir;
+    TestCache(dir);
+    return test::Finish("VolumeStatisticsTest");
+}